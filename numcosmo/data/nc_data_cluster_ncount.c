@@ -1347,7 +1347,7 @@ _nc_data_cluster_ncount_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
     _Evald2N evald2n = {cad, ncount, clusterz, clusterm, cosmo};
     g_assert (ncount->z_true);
     g_assert (ncount->lnM_true);
-    ncm_func_eval_threaded_loop_full (&_eval_intp_d2n, 0, ncount->np, &evald2n);
+    ncm_func_eval_threaded_loop_ws (&_eval_intp_d2n, 0, ncount->np, &evald2n, 1);
   }
   else
   {
@@ -1357,26 +1357,26 @@ _nc_data_cluster_ncount_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
     if (z_p && lnM_p)
     {
       _Evald2N evald2n = {cad, ncount, clusterz, clusterm, cosmo};
-      ncm_func_eval_threaded_loop_full (&_eval_z_p_lnM_p_d2n, 0, ncount->np, &evald2n);
+      ncm_func_eval_threaded_loop_ws (&_eval_z_p_lnM_p_d2n, 0, ncount->np, &evald2n, 1);
     }
     else if (z_p && !lnM_p)
     {
       g_assert (ncount->lnM_true);
       _Evald2N evald2n = {cad, ncount, clusterz, clusterm, cosmo};
-      ncm_func_eval_threaded_loop_full (&_eval_z_p_d2n, 0, ncount->np, &evald2n);
+      ncm_func_eval_threaded_loop_ws (&_eval_z_p_d2n, 0, ncount->np, &evald2n, 1);
     }
     else if (!z_p && lnM_p)
     {
       g_assert (ncount->z_true);
       _Evald2N evald2n = {cad, ncount, clusterz, clusterm, cosmo};
-      ncm_func_eval_threaded_loop_full (&_eval_lnM_p_d2n, 0, ncount->np, &evald2n);
+      ncm_func_eval_threaded_loop_ws (&_eval_lnM_p_d2n, 0, ncount->np, &evald2n, 1);
     }
     else
     {
       g_assert (ncount->z_true);
       g_assert (ncount->lnM_true);
       _Evald2N evald2n = {cad, ncount, clusterz, clusterm, cosmo};
-      ncm_func_eval_threaded_loop_full (&_eval_d2n, 0, ncount->np, &evald2n);
+      ncm_func_eval_threaded_loop_ws (&_eval_d2n, 0, ncount->np, &evald2n, 1);
 
     }
   }
@@ -49,6 +49,7 @@
 #include "math/ncm_util.h"
 #include "math/integral.h"
 #include "math/ncm_memory_pool.h"
+#include "math/ncm_func_eval.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #ifdef HAVE_HDF5
@@ -68,6 +69,14 @@ struct _NcDataReducedShearClusterMassPrivate
 	gdouble z_cluster;
 	gdouble ra_cluster;
 	gdouble dec_cluster;
+	guint z_grid_len;
+	NcmVector *z_grid;
+	NcmVector *beta_s_grid;
+	GArray *pz_weights;
+	GArray *gal_row;
+	GArray *row_band;
+	gboolean pz_weights_up;
+	NcmVector *lnP_gal;
 };
 
 enum
@@ -81,6 +90,7 @@ enum
   PROP_Z_CLUSTER, 
   PROP_RA_CLUSTER, 
   PROP_DEC_CLUSTER, 
+  PROP_Z_GRID_LEN, 
   PROP_SIZE,
 };
 
@@ -98,6 +108,14 @@ nc_data_reduced_shear_cluster_mass_init (NcDataReducedShearClusterMass *drs)
   self->dec_cluster  = 0.0;
 	self->has_rh       = FALSE;
 	self->psf_size     = 0.0;
+	self->z_grid_len   = 0;
+	self->z_grid       = NULL;
+	self->beta_s_grid  = NULL;
+	self->pz_weights   = g_array_new (FALSE, TRUE, sizeof (gdouble));
+	self->gal_row      = g_array_new (FALSE, FALSE, sizeof (guint));
+	self->row_band     = g_array_new (FALSE, FALSE, sizeof (guint));
+	self->pz_weights_up = FALSE;
+	self->lnP_gal      = NULL;
 }
 
 static void
@@ -117,7 +135,8 @@ nc_data_reduced_shear_cluster_mass_set_property (GObject *object, guint prop_id,
 			NcmObjArray *photoz_array = g_value_get_boxed (value);
 			
 			g_clear_pointer (&self->photoz_array, ncm_obj_array_unref);
-			self->photoz_array = ncm_obj_array_ref (photoz_array);
+			self->photoz_array  = ncm_obj_array_ref (photoz_array);
+			self->pz_weights_up = FALSE;
 
 			if (self->gal_obs != NULL)
 			{
@@ -155,6 +174,9 @@ nc_data_reduced_shear_cluster_mass_set_property (GObject *object, guint prop_id,
     case PROP_DEC_CLUSTER:
       self->dec_cluster = g_value_get_double (value);
       break;
+    case PROP_Z_GRID_LEN:
+      nc_data_reduced_shear_cluster_mass_set_z_grid_len (drs, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -194,6 +216,9 @@ nc_data_reduced_shear_cluster_mass_get_property (GObject *object, guint prop_id,
     case PROP_DEC_CLUSTER:
       g_value_set_double (value, self->dec_cluster);
       break;
+    case PROP_Z_GRID_LEN:
+      g_value_set_uint (value, self->z_grid_len);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -209,6 +234,10 @@ nc_data_reduced_shear_cluster_mass_dispose (GObject *object)
   ncm_matrix_clear (&self->gal_obs);
 	ncm_obj_array_clear (&self->photoz_array);
 	nc_distance_clear (&self->dist);
+
+	ncm_vector_clear (&self->z_grid);
+	ncm_vector_clear (&self->beta_s_grid);
+	ncm_vector_clear (&self->lnP_gal);
 	
   /* Chain up : end */
   G_OBJECT_CLASS (nc_data_reduced_shear_cluster_mass_parent_class)->dispose (object);
@@ -217,7 +246,12 @@ nc_data_reduced_shear_cluster_mass_dispose (GObject *object)
 static void
 nc_data_reduced_shear_cluster_mass_finalize (GObject *object)
 {
-  /*NcDataReducedShearClusterMass *drs = NC_DATA_REDUCED_SHEAR_CLUSTER_MASS (object);*/
+  NcDataReducedShearClusterMass *drs = NC_DATA_REDUCED_SHEAR_CLUSTER_MASS (object);
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+
+	g_clear_pointer (&self->pz_weights, g_array_unref);
+	g_clear_pointer (&self->gal_row, g_array_unref);
+	g_clear_pointer (&self->row_band, g_array_unref);
 
   /* Chain up : end */
   G_OBJECT_CLASS (nc_data_reduced_shear_cluster_mass_parent_class)->finalize (object);
@@ -295,6 +329,13 @@ nc_data_reduced_shear_cluster_mass_class_init (NcDataReducedShearClusterMassClas
                                                          "Cluster (halo) DEC",
                                                          -360.0, 360.0, 0.0,
                                                          G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+	g_object_class_install_property (object_class,
+                                   PROP_Z_GRID_LEN,
+                                   g_param_spec_uint ("z-grid-len",
+                                                      NULL,
+                                                      "Number of knots of the common redshift grid (0 for adaptive integration)",
+                                                      0, G_MAXUINT32, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
  
   data_class->m2lnL_val  = &_nc_data_reduced_shear_cluster_mass_m2lnL_val;
   data_class->get_length = &_nc_data_reduced_shear_cluster_mass_get_len;
@@ -355,71 +396,61 @@ _nc_data_reduced_shear_cluster_mass_PgalPz_calib (gdouble z_gal, NcDataReducedSh
 	return Pgal * Pz;
 }
 
-static void
-_nc_data_reduced_shear_cluster_mass_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
+typedef struct _NcDataReducedShearClusterMassEval
 {
-  NcDataReducedShearClusterMass *drs = NC_DATA_REDUCED_SHEAR_CLUSTER_MASS (data);
-	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
-  NcHICosmo *cosmo              = NC_HICOSMO (ncm_mset_peek (mset, nc_hicosmo_id ()));
-  NcWLSurfaceMassDensity *smd   = NC_WL_SURFACE_MASS_DENSITY (ncm_mset_peek (mset, nc_wl_surface_mass_density_id ()));
-  NcDensityProfile *dp          = NC_DENSITY_PROFILE (ncm_mset_peek (mset, nc_density_profile_id ()));
-	NcReducedShearClusterMass *rs = NC_REDUCED_SHEAR_CLUSTER_MASS (ncm_mset_peek (mset, nc_reduced_shear_cluster_mass_id ()));
-	NcReducedShearCalib *rs_calib = NC_REDUCED_SHEAR_CALIB (ncm_mset_peek (mset, nc_reduced_shear_calib_id ()));
-	const guint ngal              = self->photoz_array->len;
-	const gdouble RH              = nc_hicosmo_RH_Mpc (cosmo);
-	const gdouble dA              = nc_distance_angular_diameter (self->dist, cosmo, self->z_cluster) * RH;
-	const gdouble dt              = nc_distance_transverse (self->dist, cosmo, self->z_cluster);
-	gsl_integration_workspace **w = ncm_integral_get_workspace ();
-  	
-	NcDataReducedShearClusterMassInteg integ_data;
-	gint i;
-
+	NcDataReducedShearClusterMass *drs;
+	NcDataReducedShearClusterMassInteg integ;
+	gdouble dA;
 	gdouble (*Pgal) (gdouble z_gal, NcDataReducedShearClusterMassInteg *integ);
-  gdouble (*PgalPz) (gdouble z_gal, NcDataReducedShearClusterMassInteg *integ);
-	
-  g_assert (cosmo != NULL);
-  g_assert (smd != NULL);
-  g_assert (dp != NULL);
-  g_assert (rs != NULL);
-
-	integ_data.rs         = rs;
-	integ_data.rs_calib   = rs_calib;
-	integ_data.dist       = self->dist;
-	integ_data.cosmo      = cosmo;
-	integ_data.smd        = smd;
-	integ_data.dp         = dp;
-	integ_data.z_cluster  = self->z_cluster;
-	integ_data.dt_cluster = dt;
-  integ_data.psf_size   = self->psf_size;
-	
-	m2lnL[0] = 0.0;
+	gdouble (*PgalPz) (gdouble z_gal, NcDataReducedShearClusterMassInteg *integ);
+} NcDataReducedShearClusterMassEval;
 
-	if (self->has_rh == TRUE)
-	{
-		Pgal   = &_nc_data_reduced_shear_cluster_mass_Pgal_calib;
-		PgalPz = &_nc_data_reduced_shear_cluster_mass_PgalPz_calib;		
-		g_assert (rs_calib != NULL);
-	}
-	else
+static gdouble
+_nc_data_reduced_shear_cluster_mass_P_grid (NcDataReducedShearClusterMass *drs, NcDataReducedShearClusterMassInteg *integ, const guint row, const gdouble kappa_inf, const gdouble gamma_inf)
+{
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+	const guint offset = g_array_index (self->row_band, guint, 3 * row + 0);
+	const guint n_i    = g_array_index (self->row_band, guint, 3 * row + 1);
+	const guint n_f    = g_array_index (self->row_band, guint, 3 * row + 2);
+	const gdouble *w   = &g_array_index (self->pz_weights, gdouble, offset);
+	gdouble P = 0.0;
+	guint n;
+
+	for (n = n_i; n < n_f; n++)
 	{
-		Pgal   = &_nc_data_reduced_shear_cluster_mass_Pgal;
-		PgalPz = &_nc_data_reduced_shear_cluster_mass_PgalPz;
+		const gdouble z_n    = ncm_vector_get (self->z_grid, n);
+		const gdouble beta_n = ncm_vector_get (self->beta_s_grid, n);
+		const gdouble g_th   = beta_n * gamma_inf / (1.0 - beta_n * kappa_inf);
+		const gdouble g_th_c = self->has_rh ? nc_reduced_shear_calib_eval (integ->rs_calib, g_th, integ->psf_size, integ->rh) : g_th;
+
+		P += w[n - n_i] * nc_reduced_shear_cluster_mass_P_z_gth_gobs (integ->rs, integ->cosmo, z_n, g_th_c, integ->g_obs);
 	}
-		
-	for (i = 0; i < ngal; i++)
-	{
-		NcGalaxyRedshift *gz      = NC_GALAXY_REDSHIFT (ncm_obj_array_peek (self->photoz_array, i));
-		const gdouble r_arcmin    = ncm_matrix_get (self->gal_obs, i, 0);
-		const gdouble g_obs       = ncm_matrix_get (self->gal_obs, i, 1);
-		const gdouble rh          = self->has_rh ? ncm_matrix_get (self->gal_obs, i, 2) : 0.0;
-		const gdouble R_Mpc       = (r_arcmin / 60.0) * (M_PI / 180.0) * dA;
 
+	return P;
+}
+
+static void
+_nc_data_reduced_shear_cluster_mass_lnP_gal (glong i, glong f, gpointer userdata)
+{
+	NcDataReducedShearClusterMassEval *eval = (NcDataReducedShearClusterMassEval *) userdata;
+	NcDataReducedShearClusterMassPrivate * const self = eval->drs->priv;
+	NcDataReducedShearClusterMassInteg integ_data = eval->integ;
+	gsl_integration_workspace **w = ncm_integral_get_workspace ();
+	glong k;
+
+	for (k = i; k < f; k++)
+	{
+		NcGalaxyRedshift *gz      = NC_GALAXY_REDSHIFT (ncm_obj_array_peek (self->photoz_array, k));
+		const gdouble r_arcmin    = ncm_matrix_get (self->gal_obs, k, 0);
+		const gdouble g_obs       = ncm_matrix_get (self->gal_obs, k, 1);
+		const gdouble rh          = self->has_rh ? ncm_matrix_get (self->gal_obs, k, 2) : 0.0;
+		const gdouble R_Mpc       = (r_arcmin / 60.0) * (M_PI / 180.0) * eval->dA;
 		const gdouble z_gal       = nc_galaxy_redshift_mode (gz);
+		gdouble lnP_k             = 0.0;
 
 		if (R_Mpc < 0.75 || R_Mpc > 3.0 || z_gal < self->z_cluster + 0.1 || z_gal > 1.25)
 		{
-			//printf ("r_arcmin = %.5g R_Mpc = %.5g\n", r_arcmin, R_Mpc);
-			//printf ("z_gal = %.5g\n", z_gal);
+			ncm_vector_set (self->lnP_gal, k, 0.0);
 			continue;
 		}
 
@@ -430,10 +461,23 @@ _nc_data_reduced_shear_cluster_mass_m2lnL_val (NcmData *data, NcmMSet *mset, gdo
 		
 		if (!nc_galaxy_redshift_has_dist (gz))
 		{
-			//const gdouble z_gal = nc_galaxy_redshift_mode (gz);
-			const gdouble P_i   = Pgal (z_gal, &integ_data);
-			//printf ("zgal = %.5g\n", z_gal);
-			m2lnL[0] += log (P_i);
+			const gdouble P_i = eval->Pgal (z_gal, &integ_data);
+			lnP_k = log (P_i);
+		}
+		else if (self->z_grid_len > 0)
+		{
+			/* Only the source redshift dependence, through beta_s, changes inside the integral. */
+			const gdouble kappa_inf = nc_wl_surface_mass_density_convergence_infinity (integ_data.smd, integ_data.dp, integ_data.cosmo, R_Mpc, self->z_cluster, self->z_cluster);
+			const gdouble gamma_inf = nc_wl_surface_mass_density_shear_infinity (integ_data.smd, integ_data.dp, integ_data.cosmo, R_Mpc, self->z_cluster, self->z_cluster);
+			const guint row0        = g_array_index (self->gal_row, guint, k);
+			const guint ndists      = nc_galaxy_redshift_nintervals (gz);
+			guint j;
+
+			for (j = 0; j < ndists; j++)
+			{
+				const gdouble P_ij = _nc_data_reduced_shear_cluster_mass_P_grid (eval->drs, &integ_data, row0 + j, kappa_inf, gamma_inf);
+				lnP_k += log (P_ij);
+			}
 		}
 		else
 		{
@@ -447,22 +491,89 @@ _nc_data_reduced_shear_cluster_mass_m2lnL_val (NcmData *data, NcmMSet *mset, gdo
 				
 				nc_galaxy_redshift_pdf_limits (gz, j, &z_gal_lower, &z_gal_upper);
 
-				//printf ("zgal_l = %.5g zgal_u = %.5g\n", z_gal_lower, z_gal_upper);
 				integ_data.interval_index = j;
 
 				F.params   = &integ_data;
-				F.function = (gdouble (*)(gdouble,gpointer)) PgalPz;
+				F.function = (gdouble (*)(gdouble,gpointer)) eval->PgalPz;
 				
 				gsl_integration_qag (&F, z_gal_lower, z_gal_upper, 0.0, 1.0e-5, NCM_INTEGRAL_PARTITION, 1, *w, &P_ij, &abserr);
 
-				m2lnL[0] += log (P_ij);
+				lnP_k += log (P_ij);
 			}
 		}
+
+		ncm_vector_set (self->lnP_gal, k, lnP_k);
 	}
 
-	m2lnL[0] = -2.0 * m2lnL[0];
-	
 	ncm_memory_pool_return (w);
+}
+
+static void
+_nc_data_reduced_shear_cluster_mass_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
+{
+  NcDataReducedShearClusterMass *drs = NC_DATA_REDUCED_SHEAR_CLUSTER_MASS (data);
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+  NcHICosmo *cosmo              = NC_HICOSMO (ncm_mset_peek (mset, nc_hicosmo_id ()));
+  NcWLSurfaceMassDensity *smd   = NC_WL_SURFACE_MASS_DENSITY (ncm_mset_peek (mset, nc_wl_surface_mass_density_id ()));
+  NcDensityProfile *dp          = NC_DENSITY_PROFILE (ncm_mset_peek (mset, nc_density_profile_id ()));
+	NcReducedShearClusterMass *rs = NC_REDUCED_SHEAR_CLUSTER_MASS (ncm_mset_peek (mset, nc_reduced_shear_cluster_mass_id ()));
+	NcReducedShearCalib *rs_calib = NC_REDUCED_SHEAR_CALIB (ncm_mset_peek (mset, nc_reduced_shear_calib_id ()));
+	const guint ngal              = self->photoz_array->len;
+	const gdouble RH              = nc_hicosmo_RH_Mpc (cosmo);
+	const gdouble dA              = nc_distance_angular_diameter (self->dist, cosmo, self->z_cluster) * RH;
+	const gdouble dt              = nc_distance_transverse (self->dist, cosmo, self->z_cluster);
+	NcDataReducedShearClusterMassEval eval;
+	
+  g_assert (cosmo != NULL);
+  g_assert (smd != NULL);
+  g_assert (dp != NULL);
+  g_assert (rs != NULL);
+
+	eval.drs              = drs;
+	eval.dA               = dA;
+	eval.integ.rs         = rs;
+	eval.integ.rs_calib   = rs_calib;
+	eval.integ.dist       = self->dist;
+	eval.integ.cosmo      = cosmo;
+	eval.integ.smd        = smd;
+	eval.integ.dp         = dp;
+	eval.integ.z_cluster  = self->z_cluster;
+	eval.integ.dt_cluster = dt;
+  eval.integ.psf_size   = self->psf_size;
+	
+	if (self->has_rh == TRUE)
+	{
+		eval.Pgal   = &_nc_data_reduced_shear_cluster_mass_Pgal_calib;
+		eval.PgalPz = &_nc_data_reduced_shear_cluster_mass_PgalPz_calib;		
+		g_assert (rs_calib != NULL);
+	}
+	else
+	{
+		eval.Pgal   = &_nc_data_reduced_shear_cluster_mass_Pgal;
+		eval.PgalPz = &_nc_data_reduced_shear_cluster_mass_PgalPz;
+	}
+
+	if (ngal == 0)
+	{
+		m2lnL[0] = 0.0;
+		return;
+	}
+
+	if ((self->lnP_gal == NULL) || (ncm_vector_len (self->lnP_gal) != ngal))
+	{
+		ncm_vector_clear (&self->lnP_gal);
+		self->lnP_gal = ncm_vector_new (ngal);
+	}
+
+	/* 
+	 * Each galaxy writes only its own entry of lnP_gal. The cost per galaxy
+	 * varies with its number of photo-z intervals and with the cuts, so the
+	 * galaxies are distributed in small chunks.
+	 */
+	ncm_func_eval_threaded_loop_ws (&_nc_data_reduced_shear_cluster_mass_lnP_gal, 0, ngal, &eval, 0);
+
+	m2lnL[0] = -2.0 * ncm_vector_sum_cpts (self->lnP_gal);
+	
   return;
 }
 
@@ -475,6 +586,131 @@ _nc_data_reduced_shear_cluster_mass_get_len (NcmData *data)
 	return (self->photoz_array != NULL) ? self->photoz_array->len : 0; 
 }
 
+static void
+_nc_data_reduced_shear_cluster_mass_pz_weights_add (NcDataReducedShearClusterMass *drs, NcGalaxyRedshift *gz, const guint di, gdouble *w_row, const guint n_i, const gdouble z, const gdouble c)
+{
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+	const guint nknots = ncm_vector_len (self->z_grid);
+	const gdouble z_lo = ncm_vector_get (self->z_grid, 0);
+	const gdouble dz   = ncm_vector_get (self->z_grid, 1) - z_lo;
+	const gdouble w    = c * nc_galaxy_redshift_pdf (gz, di, z);
+	const guint n      = GSL_MIN ((guint) floor ((z - z_lo) / dz), nknots - 2);
+	const gdouble t    = (z - ncm_vector_get (self->z_grid, n)) / dz;
+
+	/* The integrand outside the knots is linearly interpolated from its values at the knots. */
+	w_row[n - n_i + 0] += w * (1.0 - t);
+	w_row[n - n_i + 1] += w * t;
+}
+
+static void
+_nc_data_reduced_shear_cluster_mass_build_pz_weights (NcDataReducedShearClusterMass *drs)
+{
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+	const guint ngal   = self->photoz_array->len;
+	const guint nknots = self->z_grid_len;
+	gdouble z_lo       = GSL_POSINF;
+	gdouble z_hi       = GSL_NEGINF;
+	guint nrows        = 0;
+	guint i;
+
+	g_array_set_size (self->gal_row, ngal);
+	g_array_set_size (self->row_band, 0);
+
+	for (i = 0; i < ngal; i++)
+	{
+		NcGalaxyRedshift *gz = NC_GALAXY_REDSHIFT (ncm_obj_array_peek (self->photoz_array, i));
+
+		g_array_index (self->gal_row, guint, i) = nrows;
+
+		if (nc_galaxy_redshift_has_dist (gz))
+		{
+			const guint ndists = nc_galaxy_redshift_nintervals (gz);
+			guint j;
+
+			for (j = 0; j < ndists; j++)
+			{
+				gdouble z_gal_lower, z_gal_upper;
+
+				nc_galaxy_redshift_pdf_limits (gz, j, &z_gal_lower, &z_gal_upper);
+				z_lo = GSL_MIN (z_lo, z_gal_lower);
+				z_hi = GSL_MAX (z_hi, z_gal_upper);
+			}
+			nrows += ndists;
+		}
+	}
+
+	ncm_vector_clear (&self->z_grid);
+	ncm_vector_clear (&self->beta_s_grid);
+	g_array_set_size (self->pz_weights, 0);
+
+	if (nrows == 0)
+	{
+		self->pz_weights_up = TRUE;
+		return;
+	}
+
+	self->z_grid      = ncm_vector_new (nknots);
+	self->beta_s_grid = ncm_vector_new (nknots);
+
+	for (i = 0; i < nknots; i++)
+		ncm_vector_set (self->z_grid, i, z_lo + (z_hi - z_lo) * i / (nknots - 1.0));
+
+	/*
+	 * Trapezoidal rule over the interval limits and the knots inside it,
+	 * every row is a linear functional of the integrand at the knots.
+	 * Only the knots in [n_i, n_f) have non-zero weights, each row stores
+	 * its offset in pz_weights followed by n_i and n_f in row_band, and
+	 * its n_f - n_i weights contiguously in pz_weights.
+	 */
+	for (i = 0; i < ngal; i++)
+	{
+		NcGalaxyRedshift *gz = NC_GALAXY_REDSHIFT (ncm_obj_array_peek (self->photoz_array, i));
+
+		if (nc_galaxy_redshift_has_dist (gz))
+		{
+			const guint ndists = nc_galaxy_redshift_nintervals (gz);
+			const gdouble dz   = ncm_vector_get (self->z_grid, 1) - z_lo;
+			guint j;
+
+			for (j = 0; j < ndists; j++)
+			{
+				const guint offset = self->pz_weights->len;
+				gdouble z_gal_lower, z_gal_upper, z_prev;
+				guint n_i, n_f, n;
+				gdouble *w_row;
+
+				nc_galaxy_redshift_pdf_limits (gz, j, &z_gal_lower, &z_gal_upper);
+
+				n_i    = GSL_MIN ((guint) floor ((z_gal_lower - z_lo) / dz), nknots - 2);
+				n_f    = GSL_MIN ((guint) floor ((z_gal_upper - z_lo) / dz), nknots - 2) + 2;
+				z_prev = z_gal_lower;
+
+				/* The array clears the new elements. */
+				g_array_set_size (self->pz_weights, offset + n_f - n_i);
+				w_row = &g_array_index (self->pz_weights, gdouble, offset);
+
+				for (n = n_i + 1; n < n_f; n++)
+				{
+					const gdouble z_n = GSL_MIN (ncm_vector_get (self->z_grid, n), z_gal_upper);
+
+					if (z_n > z_prev)
+					{
+						_nc_data_reduced_shear_cluster_mass_pz_weights_add (drs, gz, j, w_row, n_i, z_prev, 0.5 * (z_n - z_prev));
+						_nc_data_reduced_shear_cluster_mass_pz_weights_add (drs, gz, j, w_row, n_i, z_n,    0.5 * (z_n - z_prev));
+						z_prev = z_n;
+					}
+				}
+
+				g_array_append_val (self->row_band, offset);
+				g_array_append_val (self->row_band, n_i);
+				g_array_append_val (self->row_band, n_f);
+			}
+		}
+	}
+
+	self->pz_weights_up = TRUE;
+}
+
 static void 
 _nc_data_reduced_shear_cluster_mass_prepare (NcmData *data, NcmMSet *mset)
 {
@@ -488,8 +724,39 @@ _nc_data_reduced_shear_cluster_mass_prepare (NcmData *data, NcmMSet *mset)
   g_assert ((cosmo != NULL) && (smd != NULL) && (dp != NULL) && (rs != NULL));
 
   nc_distance_prepare_if_needed (self->dist, cosmo);
-}
+	if (smd->dist != self->dist)
+		nc_distance_prepare_if_needed (smd->dist, cosmo);
+
+	if (self->z_grid_len > 0)
+	{
+		if (!self->pz_weights_up)
+			_nc_data_reduced_shear_cluster_mass_build_pz_weights (drs);
+
+		if (self->z_grid != NULL)
+		{
+			/* Sigma_crit(z_s) enters only through beta_s = Sigma_crit(infinity) / Sigma_crit(z_s). */
+			const gdouble Dinf    = nc_distance_transverse_z_to_infinity (smd->dist, cosmo, 0.0);
+			const gdouble betainf = nc_distance_transverse_z_to_infinity (smd->dist, cosmo, self->z_cluster) / Dinf;
+			const gdouble dt_l    = nc_distance_transverse (smd->dist, cosmo, self->z_cluster);
+			guint n;
+
+			for (n = 0; n < self->z_grid_len; n++)
+			{
+				const gdouble zs = ncm_vector_get (self->z_grid, n);
 
+				if (zs > self->z_cluster)
+				{
+					const gdouble Ds  = nc_distance_angular_diameter (smd->dist, cosmo, zs);
+					const gdouble Dls = (nc_distance_transverse (smd->dist, cosmo, zs) - dt_l) / (1.0 + zs);
+
+					ncm_vector_set (self->beta_s_grid, n, Dls / (Ds * betainf));
+				}
+				else
+					ncm_vector_set (self->beta_s_grid, n, 0.0);
+			}
+		}
+	}
+}
 
 /**
  * nc_data_reduced_shear_cluster_mass_new:
@@ -584,6 +851,58 @@ nc_data_reduced_shear_cluster_mass_set_dist (NcDataReducedShearClusterMass *drs,
   self->dist = nc_distance_ref (dist);
 }
 
+/**
+ * nc_data_reduced_shear_cluster_mass_set_z_grid_len:
+ * @drs: a NcDataReducedShearClusterMass
+ * @z_grid_len: number of knots
+ * 
+ * Sets the number of knots of the common redshift grid. When @z_grid_len is
+ * zero (default) the photo-z distribution of each galaxy is integrated
+ * adaptively. Otherwise, $\Sigma_\mathrm{crit}(z_s)$ is tabulated on a
+ * uniform grid covering all photo-z intervals once per parameter point,
+ * and the integral over each interval is computed as a dot product between
+ * a precomputed row of trapezoidal weights times the photo-z distribution
+ * and the galaxy likelihood evaluated at the knots.
+ * 
+ * Sources in front of the cluster have $\beta_s = 0$ in this mode, i.e., they
+ * do not contribute to the shear, while the adaptive integration uses the
+ * (negative) $\beta_s$ obtained by extrapolating the distance ratio. The two
+ * modes therefore differ when the photo-z intervals extend below the cluster
+ * redshift.
+ * 
+ * Each row of weights stores only the knots inside its photo-z interval,
+ * the memory footprint is proportional to the total number of knots covered
+ * by the intervals.
+ * 
+ */
+void 
+nc_data_reduced_shear_cluster_mass_set_z_grid_len (NcDataReducedShearClusterMass *drs, const guint z_grid_len)
+{
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+
+	g_assert ((z_grid_len == 0) || (z_grid_len > 2));
+	
+  if (z_grid_len != self->z_grid_len)
+	{
+		self->z_grid_len    = z_grid_len;
+		self->pz_weights_up = FALSE;
+	}
+}
+
+/**
+ * nc_data_reduced_shear_cluster_mass_get_z_grid_len:
+ * @drs: a NcDataReducedShearClusterMass
+ * 
+ * Returns: the number of knots of the common redshift grid, zero means adaptive integration.
+ */
+guint 
+nc_data_reduced_shear_cluster_mass_get_z_grid_len (NcDataReducedShearClusterMass *drs)
+{
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+	
+	return self->z_grid_len;
+}
+
 #ifdef HAVE_HDF5
 typedef struct _NcmHDF5Table
 {
@@ -1191,6 +1510,7 @@ nc_data_reduced_shear_cluster_mass_load_hdf5 (NcDataReducedShearClusterMass *drs
 	
 	g_assert_cmpuint (self->photoz_array->len, ==, ncm_matrix_nrows (self->gal_obs));
 
+	self->pz_weights_up = FALSE;
 	ncm_data_set_init (NCM_DATA (drs), TRUE);
 	
 	ncm_hdf5_table_free (gal_table);
@@ -84,6 +84,8 @@ void nc_data_reduced_shear_cluster_mass_free (NcDataReducedShearClusterMass *drs
 void nc_data_reduced_shear_cluster_mass_clear (NcDataReducedShearClusterMass **drs);
 
 void nc_data_reduced_shear_cluster_mass_set_dist (NcDataReducedShearClusterMass *drs, NcDistance *dist);
+void nc_data_reduced_shear_cluster_mass_set_z_grid_len (NcDataReducedShearClusterMass *drs, const guint z_grid_len);
+guint nc_data_reduced_shear_cluster_mass_get_z_grid_len (NcDataReducedShearClusterMass *drs);
 
 void nc_data_reduced_shear_cluster_mass_load_hdf5 (NcDataReducedShearClusterMass *drs, const gchar *hdf5_file, const gchar ftype, const gdouble z_cluster, const gdouble ra_cluster, const gdouble dec_cluster);
 
@@ -68,6 +68,7 @@ enum
   PROP_ABSMAG_SET, 
   PROP_COV_FULL,
   PROP_HAS_COMPLETE_COV,
+  PROP_COV_PCG,
   PROP_SIZE,
 };
 
@@ -120,6 +121,15 @@ nc_data_snia_cov_init (NcDataSNIACov *snia_cov)
   snia_cov->cosmo_resample_ctrl = ncm_model_ctrl_new (NULL);
   snia_cov->dcov_resample_ctrl  = ncm_model_ctrl_new (NULL);
   snia_cov->dcov_cov_full_ctrl  = ncm_model_ctrl_new (NULL);
+
+  snia_cov->cov_params          = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  snia_cov->cov_params_try      = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  snia_cov->cov_pcg             = FALSE;
+  snia_cov->cov_pcg_C           = NULL;
+  snia_cov->pcg_r               = NULL;
+  snia_cov->pcg_z               = NULL;
+  snia_cov->pcg_p               = NULL;
+  snia_cov->pcg_Ap              = NULL;
 }
 
 static void
@@ -170,6 +180,9 @@ nc_data_snia_cov_set_property (GObject *object, guint prop_id, const GValue *val
     case PROP_HAS_COMPLETE_COV:
       snia_cov->has_complete_cov = g_value_get_boolean (value);
       break;
+    case PROP_COV_PCG:
+      nc_data_snia_cov_set_cov_pcg (snia_cov, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -217,6 +230,9 @@ nc_data_snia_cov_get_property (GObject *object, guint prop_id, GValue *value, GP
     case PROP_HAS_COMPLETE_COV:
       g_value_set_boolean (value, snia_cov->has_complete_cov);
       break;
+    case PROP_COV_PCG:
+      g_value_set_boolean (value, nc_data_snia_cov_get_cov_pcg (snia_cov));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -247,6 +263,12 @@ nc_data_snia_cov_dispose (GObject *object)
   ncm_model_ctrl_clear (&snia_cov->cosmo_resample_ctrl);
   ncm_model_ctrl_clear (&snia_cov->dcov_resample_ctrl);
   ncm_model_ctrl_clear (&snia_cov->dcov_cov_full_ctrl);
+
+  ncm_matrix_clear (&snia_cov->cov_pcg_C);
+  ncm_vector_clear (&snia_cov->pcg_r);
+  ncm_vector_clear (&snia_cov->pcg_z);
+  ncm_vector_clear (&snia_cov->pcg_p);
+  ncm_vector_clear (&snia_cov->pcg_Ap);
     
   /* Chain up : end */
   G_OBJECT_CLASS (nc_data_snia_cov_parent_class)->dispose (object);
@@ -255,13 +277,17 @@ nc_data_snia_cov_dispose (GObject *object)
 static void
 nc_data_snia_cov_finalize (GObject *object)
 {
-  /* NcDataSNIACov *snia_cov = NC_DATA_SNIA_COV (object); */
+  NcDataSNIACov *snia_cov = NC_DATA_SNIA_COV (object);
+
+  g_array_unref (snia_cov->cov_params);
+  g_array_unref (snia_cov->cov_params_try);
   
   /* Chain up : end */
   G_OBJECT_CLASS (nc_data_snia_cov_parent_class)->finalize (object);
 }
 
 static void _nc_data_snia_cov_prepare (NcmData *data, NcmMSet *mset);
+static void _nc_data_snia_cov_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL);
 static void _nc_data_snia_cov_resample (NcmData *data, NcmMSet *mset, NcmRNG *rng);
 static void _nc_data_snia_cov_mean_func (NcmDataGaussCov *gauss, NcmMSet *mset, NcmVector *vp);
 static gboolean _nc_data_snia_cov_func (NcmDataGaussCov *gauss, NcmMSet *mset, NcmMatrix *cov);
@@ -360,8 +386,17 @@ nc_data_snia_cov_class_init (NcDataSNIACovClass *klass)
                                                          FALSE,
                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 
+  g_object_class_install_property (object_class,
+                                   PROP_COV_PCG,
+                                   g_param_spec_boolean ("cov-pcg",
+                                                         NULL,
+                                                         "Whether to compute the chi-squared through preconditioned conjugate gradients (ignored when use-norma is set)",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
   data_class->resample   = &_nc_data_snia_cov_resample;
   data_class->prepare    = &_nc_data_snia_cov_prepare;
+  data_class->m2lnL_val  = &_nc_data_snia_cov_m2lnL_val;
 
   gauss_class->mean_func = &_nc_data_snia_cov_mean_func;
   gauss_class->cov_func  = &_nc_data_snia_cov_func;
@@ -389,16 +424,185 @@ _nc_data_snia_cov_mean_func (NcmDataGaussCov *gauss, NcmMSet *mset, NcmVector *v
   nc_snia_dist_cov_mean (dcov, cosmo, snia_cov, vp);
 }
 
+static gboolean
+_nc_data_snia_cov_params_equal (GArray *a, GArray *b)
+{
+  guint i;
+
+  if (a->len != b->len)
+    return FALSE;
+
+  for (i = 0; i < a->len; i++)
+  {
+    if (g_array_index (a, gdouble, i) != g_array_index (b, gdouble, i))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
 static gboolean 
 _nc_data_snia_cov_func (NcmDataGaussCov *gauss, NcmMSet *mset, NcmMatrix *cov)
 {
   NcDataSNIACov *snia_cov = NC_DATA_SNIA_COV (gauss);
   NcSNIADistCov *dcov = NC_SNIA_DIST_COV (ncm_mset_peek (mset, nc_snia_dist_cov_id ()));
+
+  /*
+   * The covariance depends only on the values in cov_params, when they
+   * did not change since the last decomposition both gauss->cov and 
+   * gauss->LLT are still exact and can be reused.
+   */
+  nc_snia_dist_cov_get_cov_params (dcov, snia_cov->cov_params_try);
+  if ((cov == gauss->cov) && gauss->prepared_LLT && 
+      _nc_data_snia_cov_params_equal (snia_cov->cov_params, snia_cov->cov_params_try))
+    return FALSE;
+
   nc_snia_dist_cov_calc (dcov, snia_cov, cov);
+
+  if (cov == gauss->cov)
+  {
+    GArray *tmp = snia_cov->cov_params;
+    snia_cov->cov_params     = snia_cov->cov_params_try;
+    snia_cov->cov_params_try = tmp;
+  }
   
   return TRUE;
 }
 
+#define NC_DATA_SNIA_COV_PCG_MAXITER (50)
+#define NC_DATA_SNIA_COV_PCG_RELTOL  (1.0e-14)
+
+/*
+ * Solves C x = v, C = snia_cov->cov_pcg_C, through preconditioned conjugate
+ * gradients using the Cholesky decomposition of a previous covariance 
+ * (gauss->LLT) as preconditioner. On success returns TRUE and sets chi2 
+ * to v^T C^{-1} v. The iteration stops when ||r||_2 / ||v||_2 is smaller 
+ * than NC_DATA_SNIA_COV_PCG_RELTOL, the relative error in chi2 is then 
+ * bounded by the condition number of C times this tolerance. It returns 
+ * FALSE when NC_DATA_SNIA_COV_PCG_MAXITER iterations are not enough, the
+ * caller must then fall back to the Cholesky decomposition.
+ */
+static gboolean
+_nc_data_snia_cov_pcg_chi2 (NcDataSNIACov *snia_cov, NcmVector *v, gdouble *chi2)
+{
+  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (snia_cov);
+  NcmVector *r  = snia_cov->pcg_r;
+  NcmVector *z  = snia_cov->pcg_z;
+  NcmVector *p  = snia_cov->pcg_p;
+  NcmVector *Ap = snia_cov->pcg_Ap;
+  const gdouble v_norm = ncm_vector_dnrm2 (v);
+  gdouble rz, x_v = 0.0;
+  guint iter;
+  gint ret;
+
+  if (v_norm == 0.0)
+  {
+    *chi2 = 0.0;
+    return TRUE;
+  }
+
+  /* x_0 = 0 => r_0 = v, z_0 = M^{-1} r_0, p_0 = z_0. */
+  ncm_vector_memcpy (r, v);
+  ncm_vector_memcpy (z, v);
+  ret = ncm_matrix_cholesky_solve2 (gauss->LLT, z, 'U');
+  if (ret != 0)
+    return FALSE;
+  ncm_vector_memcpy (p, z);
+  rz = ncm_vector_dot (r, z);
+
+  for (iter = 0; iter < NC_DATA_SNIA_COV_PCG_MAXITER; iter++)
+  {
+    gdouble pAp, alpha_k, rz_new;
+
+    ret = gsl_blas_dsymv (CblasUpper, 1.0, ncm_matrix_gsl (snia_cov->cov_pcg_C), ncm_vector_gsl (p), 0.0, ncm_vector_gsl (Ap));
+    NCM_TEST_GSL_RESULT ("_nc_data_snia_cov_pcg_chi2", ret);
+
+    pAp = ncm_vector_dot (p, Ap);
+    if (!(pAp > 0.0))
+      return FALSE;
+
+    alpha_k = rz / pAp;
+
+    /* Only x^T v is needed, x_{k+1} = x_k + alpha_k p_k. */
+    x_v += alpha_k * ncm_vector_dot (p, v);
+
+    ret = gsl_blas_daxpy (-alpha_k, ncm_vector_gsl (Ap), ncm_vector_gsl (r));
+    NCM_TEST_GSL_RESULT ("_nc_data_snia_cov_pcg_chi2", ret);
+
+    if (ncm_vector_dnrm2 (r) <= NC_DATA_SNIA_COV_PCG_RELTOL * v_norm)
+    {
+      *chi2 = x_v;
+      return TRUE;
+    }
+
+    ncm_vector_memcpy (z, r);
+    ret = ncm_matrix_cholesky_solve2 (gauss->LLT, z, 'U');
+    if (ret != 0)
+      return FALSE;
+
+    rz_new = ncm_vector_dot (r, z);
+
+    ncm_vector_scale (p, rz_new / rz);
+    ncm_vector_add (p, z);
+    rz = rz_new;
+  }
+
+  return FALSE;
+}
+
+static void
+_nc_data_snia_cov_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
+{
+  NcDataSNIACov *snia_cov = NC_DATA_SNIA_COV (data);
+  NcmDataGaussCov *gauss  = NCM_DATA_GAUSS_COV (data);
+
+  /*
+   * The PCG path only applies when the chi-squared is the full answer, the
+   * log-determinant required by use_norma still demands a decomposition
+   * whenever the covariance parameters change. It also needs a previous
+   * decomposition to work as preconditioner.
+   */
+  if (snia_cov->cov_pcg && !gauss->use_norma && !ncm_data_bootstrap_enabled (data) &&
+      gauss->prepared_LLT && (snia_cov->cov_params->len > 0))
+  {
+    NcSNIADistCov *dcov = NC_SNIA_DIST_COV (ncm_mset_peek (mset, nc_snia_dist_cov_id ()));
+
+    nc_snia_dist_cov_get_cov_params (dcov, snia_cov->cov_params_try);
+
+    if (!_nc_data_snia_cov_params_equal (snia_cov->cov_params, snia_cov->cov_params_try))
+    {
+      const guint mu_len = snia_cov->mu_len;
+
+      if (snia_cov->cov_pcg_C == NULL)
+      {
+        snia_cov->cov_pcg_C = ncm_matrix_new (mu_len, mu_len);
+        snia_cov->pcg_r     = ncm_vector_new (mu_len);
+        snia_cov->pcg_z     = ncm_vector_new (mu_len);
+        snia_cov->pcg_p     = ncm_vector_new (mu_len);
+        snia_cov->pcg_Ap    = ncm_vector_new (mu_len);
+      }
+
+      NCM_DATA_GAUSS_COV_GET_CLASS (gauss)->mean_func (gauss, mset, gauss->v);
+      ncm_vector_sub (gauss->v, gauss->y);
+
+      nc_snia_dist_cov_calc (dcov, snia_cov, snia_cov->cov_pcg_C);
+
+      if (_nc_data_snia_cov_pcg_chi2 (snia_cov, gauss->v, m2lnL))
+        return;
+      
+      /* 
+       * No convergence, the preconditioner is too far from the current
+       * covariance. Chaining up below computes the Cholesky decomposition 
+       * of the current covariance, which also refreshes the preconditioner
+       * and cov_params.
+       */
+    }
+  }
+
+  /* Chain up : end */
+  NCM_DATA_CLASS (nc_data_snia_cov_parent_class)->m2lnL_val (data, mset, m2lnL);
+}
+
 /* EXPERIMENTAL CODE : NOT USED! */
 static void 
 _nc_data_snia_cov_lnNorma2 (NcmDataGaussCov *gauss, NcmMSet *mset, gdouble *m2lnL)
@@ -559,6 +763,47 @@ nc_data_snia_cov_sigma_int_len (NcDataSNIACov *snia_cov)
   return snia_cov->dataset_len;
 }
 
+/**
+ * nc_data_snia_cov_set_cov_pcg:
+ * @snia_cov: a #NcDataSNIACov
+ * @enable: whether to use the PCG chi-squared
+ * 
+ * When @enable is TRUE and the likelihood does not include the 
+ * normalization (see #NcmDataGaussCov:use-norma), changes in the 
+ * covariance parameters ($\alpha$, $\beta$, $\sigma_\mathrm{int}$, etc)
+ * do not trigger a new Cholesky decomposition. Instead, the 
+ * chi-squared is computed through preconditioned conjugate gradients
+ * using the last decomposition as preconditioner. The decomposition is
+ * refreshed only when the iteration fails to converge.
+ * 
+ * This option has no effect when #NcmDataGaussCov:use-norma is TRUE. The
+ * normalization requires $\ln\det C$ of the current covariance, which is
+ * not available from the iteration and costs as much as the Cholesky
+ * decomposition itself, therefore every change in the covariance 
+ * parameters is evaluated through a new decomposition.
+ * 
+ * In both modes the decomposition is reused when only parameters that do
+ * not enter the covariance change (cosmology, absolute magnitudes).
+ * 
+ */
+void
+nc_data_snia_cov_set_cov_pcg (NcDataSNIACov *snia_cov, gboolean enable)
+{
+  snia_cov->cov_pcg = enable;
+}
+
+/**
+ * nc_data_snia_cov_get_cov_pcg:
+ * @snia_cov: a #NcDataSNIACov
+ * 
+ * Returns: whether the PCG chi-squared is enabled, see nc_data_snia_cov_set_cov_pcg().
+ */
+gboolean
+nc_data_snia_cov_get_cov_pcg (NcDataSNIACov *snia_cov)
+{
+  return snia_cov->cov_pcg;
+}
+
 static void 
 _nc_data_snia_cov_set_size (NcmDataGaussCov *gauss, guint mu_len)
 {
@@ -590,6 +835,14 @@ _nc_data_snia_cov_set_size (NcmDataGaussCov *gauss, guint mu_len)
 
       ncm_matrix_clear (&snia_cov->inv_cov_mm_LU);
       ncm_matrix_clear (&snia_cov->inv_cov_mm);
+
+      ncm_matrix_clear (&snia_cov->cov_pcg_C);
+      ncm_vector_clear (&snia_cov->pcg_r);
+      ncm_vector_clear (&snia_cov->pcg_z);
+      ncm_vector_clear (&snia_cov->pcg_p);
+      ncm_vector_clear (&snia_cov->pcg_Ap);
+
+      g_array_set_size (snia_cov->cov_params, 0);
       
       if (snia_cov->dataset != NULL)
       {
@@ -657,6 +910,9 @@ static void _nc_data_snia_cov_save_cov_lowertri (NcDataSNIACov *snia_cov);
 static void 
 _nc_data_snia_cov_set_data_init (NcDataSNIACov *snia_cov, gint data_bw)
 {
+  /* Any data change invalidates the covariance parameters cache. */
+  g_array_set_size (snia_cov->cov_params, 0);
+
   snia_cov->data_init = snia_cov->data_init | data_bw;
   if ((snia_cov->data_init & NC_DATA_SNIA_COV_INIT_ALL) == snia_cov->data_init)
     ncm_data_set_init (NCM_DATA (snia_cov), TRUE);
@@ -244,6 +244,14 @@ struct _NcDataSNIACov
   NcmModelCtrl *cosmo_resample_ctrl;
   NcmModelCtrl *dcov_resample_ctrl;
   NcmModelCtrl *dcov_cov_full_ctrl;
+  GArray *cov_params;
+  GArray *cov_params_try;
+  gboolean cov_pcg;
+  NcmMatrix *cov_pcg_C;
+  NcmVector *pcg_r;
+  NcmVector *pcg_z;
+  NcmVector *pcg_p;
+  NcmVector *pcg_Ap;
 };
 
 GType nc_data_snia_cov_get_type (void) G_GNUC_CONST;
@@ -253,6 +261,9 @@ NcmData *nc_data_snia_cov_new_full (gchar *filename, gboolean use_norma);
 
 guint nc_data_snia_cov_sigma_int_len (NcDataSNIACov *snia_cov);
 
+void nc_data_snia_cov_set_cov_pcg (NcDataSNIACov *snia_cov, gboolean enable);
+gboolean nc_data_snia_cov_get_cov_pcg (NcDataSNIACov *snia_cov);
+
 NcmVector *nc_data_snia_cov_peek_z_cmb (NcDataSNIACov *snia_cov);
 NcmVector *nc_data_snia_cov_peek_z_he (NcDataSNIACov *snia_cov);
 NcmVector *nc_data_snia_cov_peek_sigma_z (NcDataSNIACov *snia_cov);
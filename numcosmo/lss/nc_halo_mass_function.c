@@ -646,6 +646,8 @@ nc_halo_mass_function_set_eval_limits (NcHaloMassFunction *mfp, NcHICosmo *cosmo
 void
 nc_halo_mass_function_prepare (NcHaloMassFunction *mfp, NcHICosmo *cosmo)
 {
+  const gdouble VH = gsl_pow_3 (nc_hicosmo_RH_Mpc (cosmo));
+  NcmVector *E2, *Dc;
   guint i, j;
 
   nc_distance_prepare_if_needed (mfp->dist, cosmo);
@@ -658,10 +660,17 @@ nc_halo_mass_function_prepare (NcHaloMassFunction *mfp, NcHICosmo *cosmo)
 #define D2NDZDLNM_LNM(cad) ((cad)->d2NdzdlnM->xv)
 #define D2NDZDLNM_VAL(cad) ((cad)->d2NdzdlnM->zm)
 
+  /* Background quantities for all redshift knots at once, see nc_halo_mass_function_dv_dzdomega(). */
+  E2 = ncm_vector_new (ncm_vector_len (D2NDZDLNM_Z (mfp)));
+  Dc = ncm_vector_new (ncm_vector_len (D2NDZDLNM_Z (mfp)));
+
+  nc_hicosmo_E2_vec (cosmo, D2NDZDLNM_Z (mfp), E2);
+  nc_distance_comoving_vector (mfp->dist, cosmo, D2NDZDLNM_Z (mfp), Dc);
+
   for (i = 0; i < ncm_vector_len (D2NDZDLNM_Z (mfp)); i++)
   {
     const gdouble z = ncm_vector_get (D2NDZDLNM_Z (mfp), i);
-    const gdouble dVdz = mfp->area_survey * nc_halo_mass_function_dv_dzdomega (mfp, cosmo, z);
+    const gdouble dVdz = mfp->area_survey * VH * gsl_pow_2 (ncm_vector_get (Dc, i)) / sqrt (ncm_vector_get (E2, i));
 
     for (j = 0; j < ncm_vector_len (D2NDZDLNM_LNM (mfp)); j++)
     {
@@ -670,6 +679,10 @@ nc_halo_mass_function_prepare (NcHaloMassFunction *mfp, NcHICosmo *cosmo)
       ncm_matrix_set (D2NDZDLNM_VAL (mfp), i, j, d2NdzdlnM_ij);
     }
   }
+
+  ncm_vector_free (E2);
+  ncm_vector_free (Dc);
+
   ncm_spline2d_prepare (mfp->d2NdzdlnM);
 
   ncm_model_ctrl_update (mfp->ctrl_cosmo, NCM_MODEL (cosmo));
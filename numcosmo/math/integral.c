@@ -60,6 +60,23 @@ _integral_ws_free (gpointer p)
   gsl_integration_workspace_free ((gsl_integration_workspace *)p);
 }
 
+static NcmMemoryPool *
+_ncm_integral_get_pool (void)
+{
+  G_LOCK_DEFINE_STATIC (create_lock);
+  static NcmMemoryPool *mp = NULL;
+
+  G_LOCK (create_lock);
+  if (mp == NULL)
+  {
+    mp = ncm_memory_pool_new (_integral_ws_alloc, NULL, _integral_ws_free);
+    ncm_memory_pool_set_thread_cache (mp, TRUE);
+  }
+  G_UNLOCK (create_lock);
+
+  return mp;
+}
+
 /**
  * ncm_integral_get_workspace: (skip)
  *
@@ -68,21 +85,52 @@ _integral_ws_free (gpointer p)
  * new one if the function is called and the pool is empty. It is designed
  * to be used in a multithread enviroment. The workspace must be unlocked
  * in order to return to the pool. This must be done using the #ncm_memory_pool_return.
+ * 
+ * Each thread keeps one workspace cached, which is obtained and returned 
+ * without locking the pool. The shared pool is used only when a thread
+ * needs more than one workspace at the same time, e.g., in nested integrals.
  *
  * Returns: a pointer to #gsl_integration_workspace structure.
 */
 gsl_integration_workspace **
 ncm_integral_get_workspace ()
 {
-  G_LOCK_DEFINE_STATIC (create_lock);
-  static NcmMemoryPool *mp = NULL;
+  return ncm_memory_pool_get (_ncm_integral_get_pool ());
+}
 
-  G_LOCK (create_lock);
-  if (mp == NULL)
-    mp = ncm_memory_pool_new (_integral_ws_alloc, NULL, _integral_ws_free);
-  G_UNLOCK (create_lock);
+/**
+ * ncm_integral_get_workspace_stats:
+ * @n_fast: (out): number of workspaces obtained from the thread cache
+ * @n_locked: (out): number of workspaces obtained from the shared pool
+ * @n_contended: (out): number of times the shared pool was locked by another thread
+ *
+ * Gets the usage statistics of the workspace pool used by
+ * ncm_integral_get_workspace(), see ncm_memory_pool_get_stats().
+ *
+ */
+void
+ncm_integral_get_workspace_stats (gulong *n_fast, gulong *n_locked, gulong *n_contended)
+{
+  ncm_memory_pool_get_stats (_ncm_integral_get_pool (), n_fast, n_locked, n_contended);
+}
+
+/**
+ * ncm_integral_log_workspace_stats:
+ *
+ * Logs the usage statistics of the workspace pool used by
+ * ncm_integral_get_workspace().
+ *
+ */
+void
+ncm_integral_log_workspace_stats (void)
+{
+  gulong n_fast, n_locked, n_contended;
+
+  ncm_integral_get_workspace_stats (&n_fast, &n_locked, &n_contended);
 
-  return ncm_memory_pool_get (mp);
+  g_message ("# NcmIntegral:Workspace thread cache: %lu\n", n_fast);
+  g_message ("# NcmIntegral:Workspace shared pool:  %lu\n", n_locked);
+  g_message ("# NcmIntegral:Workspace contended:    %lu\n", n_contended);
 }
 
 /**
@@ -37,6 +37,8 @@
 G_BEGIN_DECLS
 
 gsl_integration_workspace **ncm_integral_get_workspace (void);
+void ncm_integral_get_workspace_stats (gulong *n_fast, gulong *n_locked, gulong *n_contended);
+void ncm_integral_log_workspace_stats (void);
 
 typedef struct _NcmIntegrand2dim NcmIntegrand2dim;
 typedef gdouble (*_NcmIntegrand2dimFunc) (gdouble x, gdouble y, gpointer userdata);
@@ -39,6 +39,7 @@
 #include "math/ncm_cfg.h"
 #include "math/ncm_rng.h"
 #include "math/ncm_memory_pool.h"
+#include "math/ncm_func_eval.h"
 #include "math/ncm_mpi_job.h"
 #include "math/ncm_mpi_job_test.h"
 #include "math/ncm_mpi_job_fit.h"
@@ -307,6 +308,8 @@ ncm_cfg_mpi_kill_all_slaves (void)
 static void
 _ncm_cfg_exit (void)
 {
+  ncm_func_eval_pool_free ();
+
 #ifdef HAVE_MPI
 	NCM_MPI_JOB_DEBUG_PRINT ("#[%3d %3d] Dying [%d]!\n", _mpi_ctrl.size, _mpi_ctrl.rank, _mpi_ctrl.initialized);
 	if (_mpi_ctrl.initialized)
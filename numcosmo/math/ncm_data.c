@@ -54,6 +54,7 @@ enum
   PROP_LONG_DESC,
   PROP_INIT,
   PROP_BSTRAP,
+  PROP_PROFILE,
   PROP_SIZE,
 };
 
@@ -67,6 +68,12 @@ ncm_data_init (NcmData *data)
   data->init      = FALSE;
   data->begin     = FALSE;
   data->diff      = ncm_diff_new ();
+
+  data->profile        = FALSE;
+  data->prepare_ncalls = 0;
+  data->m2lnL_ncalls   = 0;
+  data->prepare_time   = 0;
+  data->m2lnL_time     = 0;
 }
 
 static void
@@ -93,6 +100,9 @@ _ncm_data_set_property (GObject *object, guint prop_id, const GValue *value, GPa
       ncm_data_bootstrap_set (data, bstrap);
       break;
     }
+    case PROP_PROFILE:
+      ncm_data_set_profile (data, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -126,6 +136,9 @@ _ncm_data_get_property (GObject *object, guint prop_id, GValue *value, GParamSpe
       g_value_set_object (value, data->bstrap);
       break;
     }
+    case PROP_PROFILE:
+      g_value_set_boolean (value, data->profile);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -237,6 +250,20 @@ ncm_data_class_init (NcmDataClass *klass)
                                                         "Data bootstrap object",
                                                         NCM_TYPE_BOOTSTRAP,
                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+  /**
+   * NcmData:profile:
+   *
+   * Whether to profile the #NcmData, see ncm_data_set_profile().
+   * 
+   */  
+  g_object_class_install_property (object_class,
+                                   PROP_PROFILE,
+                                   g_param_spec_boolean ("profile",
+                                                         NULL,
+                                                         "Data profiling",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   data_class->name             = NULL;
   data_class->get_length       = NULL;
   data_class->begin            = NULL;
@@ -517,7 +544,17 @@ _ncm_data_prepare (NcmData *data, NcmMSet *mset)
   }
 
   if (NCM_DATA_GET_CLASS (data)->prepare != NULL)
-    NCM_DATA_GET_CLASS (data)->prepare (data, mset);
+  {
+    if (G_UNLIKELY (data->profile))
+    {
+      const gint64 t0 = g_get_monotonic_time ();
+      NCM_DATA_GET_CLASS (data)->prepare (data, mset);
+      data->prepare_time += g_get_monotonic_time () - t0;
+      data->prepare_ncalls++;
+    }
+    else
+      NCM_DATA_GET_CLASS (data)->prepare (data, mset);
+  }
 }
 
 
@@ -665,6 +702,92 @@ ncm_data_bootstrap_enabled (NcmData *data)
     return FALSE;
 }
 
+/**
+ * ncm_data_set_profile:
+ * @data: a #NcmData
+ * @enable: whether to profile @data
+ *
+ * Enables or disables the profiling of @data. When enabled, the number
+ * of calls and the time spent (monotonic clock) in the #NcmDataClass.prepare
+ * and #NcmDataClass.m2lnL_val methods are accumulated, see
+ * ncm_data_profile_get(). When disabled the only overhead is a branch
+ * per call.
+ * 
+ */
+void
+ncm_data_set_profile (NcmData *data, gboolean enable)
+{
+  data->profile = enable;
+}
+
+/**
+ * ncm_data_get_profile:
+ * @data: a #NcmData
+ *
+ * Returns: whether profiling is enabled in @data.
+ */
+gboolean
+ncm_data_get_profile (NcmData *data)
+{
+  return data->profile;
+}
+
+/**
+ * ncm_data_profile_reset:
+ * @data: a #NcmData
+ *
+ * Sets to zero all profiling counters and timers of @data.
+ * 
+ */
+void
+ncm_data_profile_reset (NcmData *data)
+{
+  data->prepare_ncalls = 0;
+  data->m2lnL_ncalls   = 0;
+  data->prepare_time   = 0;
+  data->m2lnL_time     = 0;
+}
+
+/**
+ * ncm_data_profile_add:
+ * @data: a #NcmData
+ * @data_src: a #NcmData
+ *
+ * Adds the profiling counters and timers of @data_src to the ones
+ * of @data. This is used to gather the profiling of the copies of
+ * @data used by the threads of a parallel run.
+ * 
+ */
+void
+ncm_data_profile_add (NcmData *data, NcmData *data_src)
+{
+  data->prepare_ncalls += data_src->prepare_ncalls;
+  data->m2lnL_ncalls   += data_src->m2lnL_ncalls;
+  data->prepare_time   += data_src->prepare_time;
+  data->m2lnL_time     += data_src->m2lnL_time;
+}
+
+/**
+ * ncm_data_profile_get:
+ * @data: a #NcmData
+ * @prepare_ncalls: (out): number of calls to prepare
+ * @prepare_time: (out): total time spent in prepare (seconds)
+ * @m2lnL_ncalls: (out): number of calls to m2lnL_val
+ * @m2lnL_time: (out): total time spent in m2lnL_val (seconds)
+ *
+ * Gets the profiling information accumulated since the last call
+ * to ncm_data_profile_reset().
+ * 
+ */
+void
+ncm_data_profile_get (NcmData *data, gulong *prepare_ncalls, gdouble *prepare_time, gulong *m2lnL_ncalls, gdouble *m2lnL_time)
+{
+  *prepare_ncalls = data->prepare_ncalls;
+  *prepare_time   = data->prepare_time * 1.0e-6;
+  *m2lnL_ncalls   = data->m2lnL_ncalls;
+  *m2lnL_time     = data->m2lnL_time * 1.0e-6;
+}
+
 /**
  * ncm_data_leastsquares_f: (virtual leastsquares_f)
  * @data: a #NcmData.
@@ -752,7 +875,15 @@ ncm_data_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
     g_error ("ncm_data_m2lnL_val: The data (%s) does not implement m2lnL_val.", 
              ncm_data_get_desc (data));
 
-  NCM_DATA_GET_CLASS (data)->m2lnL_val (data, mset, m2lnL);
+  if (G_UNLIKELY (data->profile))
+  {
+    const gint64 t0 = g_get_monotonic_time ();
+    NCM_DATA_GET_CLASS (data)->m2lnL_val (data, mset, m2lnL);
+    data->m2lnL_time += g_get_monotonic_time () - t0;
+    data->m2lnL_ncalls++;
+  }
+  else
+    NCM_DATA_GET_CLASS (data)->m2lnL_val (data, mset, m2lnL);
 }
 
 /**
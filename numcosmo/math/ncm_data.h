@@ -120,6 +120,11 @@ struct _NcmData
   gboolean begin;
   NcmBootstrap *bstrap;
   NcmDiff *diff;
+  gboolean profile;
+  gulong prepare_ncalls;
+  gulong m2lnL_ncalls;
+  gint64 prepare_time;
+  gint64 m2lnL_time;
 };
 
 GType ncm_data_get_type (void) G_GNUC_CONST;
@@ -149,6 +154,12 @@ void ncm_data_bootstrap_set (NcmData *data, NcmBootstrap *bstrap);
 void ncm_data_bootstrap_resample (NcmData *data, NcmRNG *rng);
 gboolean ncm_data_bootstrap_enabled (NcmData *data);
 
+void ncm_data_set_profile (NcmData *data, gboolean enable);
+gboolean ncm_data_get_profile (NcmData *data);
+void ncm_data_profile_reset (NcmData *data);
+void ncm_data_profile_add (NcmData *data, NcmData *data_src);
+void ncm_data_profile_get (NcmData *data, gulong *prepare_ncalls, gdouble *prepare_time, gulong *m2lnL_ncalls, gdouble *m2lnL_time);
+
 void ncm_data_leastsquares_f (NcmData *data, NcmMSet *mset, NcmVector *f);
 void ncm_data_leastsquares_J (NcmData *data, NcmMSet *mset, NcmMatrix *J);
 void ncm_data_leastsquares_f_J (NcmData *data, NcmMSet *mset, NcmVector *f, NcmMatrix *J);
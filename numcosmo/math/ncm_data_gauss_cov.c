@@ -521,3 +521,118 @@ ncm_data_gauss_cov_use_norma (NcmDataGaussCov *gauss, gboolean use_norma)
 {
   gauss->use_norma = use_norma;
 }
+
+/**
+ * ncm_data_gauss_cov_has_resample_batch:
+ * @gauss: a #NcmDataGaussCov
+ *
+ * Checks whether @gauss resamples through the default Gaussian 
+ * resampling of #NcmDataGaussCov. Only in this case 
+ * ncm_data_gauss_cov_resample_batch() produces realizations equivalent
+ * to ncm_data_resample().
+ *
+ * Returns: whether @gauss supports batch resampling.
+ */
+gboolean
+ncm_data_gauss_cov_has_resample_batch (NcmDataGaussCov *gauss)
+{
+  return (NCM_DATA_GET_CLASS (gauss)->resample == &_ncm_data_gauss_cov_resample);
+}
+
+/**
+ * ncm_data_gauss_cov_resample_batch:
+ * @gauss: a #NcmDataGaussCov
+ * @mset: a #NcmMSet
+ * @rng: a #NcmRNG
+ * @y_batch: a #NcmMatrix
+ *
+ * Generates ncm_matrix_nrows (@y_batch) realizations of @gauss at once, 
+ * each row of @y_batch receives one realization. The mean and the 
+ * Cholesky decomposition of the covariance are computed once and the 
+ * whole block is obtained through a single triangular matrix-matrix 
+ * product. The random numbers are drawn in the same order as repeated
+ * calls to ncm_data_resample(), the data vector of @gauss is not 
+ * changed, see ncm_data_gauss_cov_set_realization().
+ *
+ */
+void
+ncm_data_gauss_cov_resample_batch (NcmDataGaussCov *gauss, NcmMSet *mset, NcmRNG *rng, NcmMatrix *y_batch)
+{
+  NcmData *data = NCM_DATA (gauss);
+  NcmDataGaussCovClass *gauss_cov_class = NCM_DATA_GAUSS_COV_GET_CLASS (gauss);
+  const guint nreal = ncm_matrix_nrows (y_batch);
+  gboolean cov_update = FALSE;
+  gint ret;
+  guint i, k;
+
+  g_assert (ncm_data_gauss_cov_has_resample_batch (gauss));
+  g_assert_cmpuint (ncm_matrix_ncols (y_batch), ==, gauss->np);
+
+  /* As in ncm_data_resample(), the data may not be initialized yet. */
+  if (NCM_DATA_GET_CLASS (data)->prepare != NULL)
+    NCM_DATA_GET_CLASS (data)->prepare (data, mset);
+
+  if (gauss_cov_class->cov_func != NULL)
+    cov_update = gauss_cov_class->cov_func (gauss, mset, gauss->cov);
+
+  if (cov_update || !gauss->prepared_LLT)
+    _ncm_data_gauss_cov_prepare_LLT (data);
+
+  ncm_rng_lock (rng);
+  for (k = 0; k < nreal; k++)
+  {
+    for (i = 0; i < gauss->np; i++)
+    {
+      const gdouble u_i = gsl_ran_ugaussian (rng->r);
+      ncm_matrix_set (y_batch, k, i, u_i);
+    }
+  }
+  ncm_rng_unlock (rng);
+
+  /* Each row u^T becomes u^T U = (L u)^T, see _ncm_data_gauss_cov_resample. */
+  ret = gsl_blas_dtrmm (CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit,
+                        1.0, ncm_matrix_gsl (gauss->LLT), ncm_matrix_gsl (y_batch));
+  NCM_TEST_GSL_RESULT ("ncm_data_gauss_cov_resample_batch", ret);
+
+  gauss_cov_class->mean_func (gauss, mset, gauss->v);
+
+  for (k = 0; k < nreal; k++)
+  {
+    NcmVector *y_k = ncm_matrix_get_row (y_batch, k);
+
+    ncm_vector_scale (y_k, -1.0);
+    ncm_vector_add (y_k, gauss->v);
+
+    ncm_vector_free (y_k);
+  }
+}
+
+/**
+ * ncm_data_gauss_cov_set_realization:
+ * @gauss: a #NcmDataGaussCov
+ * @y_batch: a #NcmMatrix
+ * @k: row index
+ *
+ * Sets the data vector of @gauss to the @k-th realization in @y_batch, 
+ * previously computed by ncm_data_gauss_cov_resample_batch(). After this
+ * call @gauss is in the same state as after a ncm_data_resample().
+ *
+ */
+void
+ncm_data_gauss_cov_set_realization (NcmDataGaussCov *gauss, NcmMatrix *y_batch, guint k)
+{
+  NcmData *data = NCM_DATA (gauss);
+  NcmVector *y_k = ncm_matrix_get_row (y_batch, k);
+
+  ncm_vector_memcpy (gauss->y, y_k);
+  ncm_vector_free (y_k);
+
+  data->begin = FALSE;
+  if (NCM_DATA_GET_CLASS (data)->begin != NULL)
+  {
+    NCM_DATA_GET_CLASS (data)->begin (data);
+    data->begin = TRUE;
+  }
+
+  ncm_data_set_init (data, TRUE);
+}
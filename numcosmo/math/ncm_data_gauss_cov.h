@@ -76,6 +76,10 @@ guint ncm_data_gauss_cov_get_size (NcmDataGaussCov *gauss);
 
 void ncm_data_gauss_cov_use_norma (NcmDataGaussCov *gauss, gboolean use_norma);
 
+gboolean ncm_data_gauss_cov_has_resample_batch (NcmDataGaussCov *gauss);
+void ncm_data_gauss_cov_resample_batch (NcmDataGaussCov *gauss, NcmMSet *mset, NcmRNG *rng, NcmMatrix *y_batch);
+void ncm_data_gauss_cov_set_realization (NcmDataGaussCov *gauss, NcmMatrix *y_batch, guint k);
+
 G_END_DECLS
 
 #endif /* _NCM_DATA_GAUSS_COV_H_ */
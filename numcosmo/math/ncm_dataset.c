@@ -46,6 +46,7 @@ enum
   PROP_0,
   PROP_BSTYPE,
   PROP_OA,
+  PROP_PROFILE,
   PROP_SIZE,
 };
 
@@ -60,6 +61,7 @@ ncm_dataset_init (NcmDataset *dset)
   dset->oa        = ncm_obj_array_sized_new (_NCM_DATASET_INITIAL_ALLOC);
   dset->data_prob = g_array_sized_new (FALSE, FALSE, sizeof (gdouble), _NCM_DATASET_INITIAL_ALLOC);
   dset->bstrap    = g_array_sized_new (FALSE, FALSE, sizeof (guint), _NCM_DATASET_INITIAL_ALLOC);
+  dset->profile   = FALSE;
 }
 
 static void
@@ -76,6 +78,9 @@ ncm_dataset_set_property (GObject *object, guint prop_id, const GValue *value, G
     case PROP_OA:
       ncm_dataset_set_data_array (dset, (NcmObjArray *) g_value_get_boxed (value));
       break;
+    case PROP_PROFILE:
+      ncm_dataset_set_profile (dset, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -96,6 +101,9 @@ ncm_dataset_get_property (GObject *object, guint prop_id, GValue *value, GParamS
     case PROP_OA:
       g_value_set_boxed (value, ncm_dataset_peek_data_array (dset));
       break;
+    case PROP_PROFILE:
+      g_value_set_boolean (value, dset->profile);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -168,6 +176,19 @@ ncm_dataset_class_init (NcmDatasetClass *klass)
                                                        "NcmData array",
                                                        NCM_TYPE_OBJ_ARRAY,
                                                        G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  /**
+   * NcmDataset:profile:
+   *
+   * Whether to profile the data in the #NcmDataset, see ncm_dataset_set_profile().
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_PROFILE,
+                                   g_param_spec_boolean ("profile",
+                                                         NULL,
+                                                         "Dataset profiling",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 /**
@@ -305,6 +326,9 @@ ncm_dataset_append_data (NcmDataset *dset, NcmData *data)
   g_assert (NCM_IS_DATA (data));
   ncm_obj_array_add (dset->oa, G_OBJECT (data));
 
+  if (dset->profile)
+    ncm_data_set_profile (data, TRUE);
+
   if (enable)
     ncm_data_bootstrap_create (data);
   else
@@ -466,6 +490,9 @@ ncm_dataset_set_data_array (NcmDataset *dset, NcmObjArray *oa)
       ncm_data_bootstrap_remove (data);
     else
       ncm_data_bootstrap_create (data);
+
+    if (dset->profile)
+      ncm_data_set_profile (data, TRUE);
   }
 
   _ncm_dataset_update_bstrap (dset);
@@ -652,6 +679,154 @@ ncm_dataset_log_info (NcmDataset *dset)
   return;
 }
 
+/**
+ * ncm_dataset_set_profile:
+ * @dset: a #NcmDataset
+ * @enable: whether to profile the data in @dset
+ *
+ * Enables or disables profiling in every #NcmData contained in @dset,
+ * see ncm_data_set_profile(). Data added later to @dset inherit
+ * this setting.
+ * 
+ */
+void
+ncm_dataset_set_profile (NcmDataset *dset, gboolean enable)
+{
+  guint i;
+
+  dset->profile = enable;
+  
+  for (i = 0; i < dset->oa->len; i++)
+  {
+    NcmData *data = ncm_dataset_peek_data (dset, i);
+    ncm_data_set_profile (data, enable);
+  }
+}
+
+/**
+ * ncm_dataset_get_profile:
+ * @dset: a #NcmDataset
+ *
+ * Returns: whether profiling is enabled in @dset.
+ */
+gboolean
+ncm_dataset_get_profile (NcmDataset *dset)
+{
+  return dset->profile;
+}
+
+/**
+ * ncm_dataset_profile_reset:
+ * @dset: a #NcmDataset
+ *
+ * Resets the profiling counters of every #NcmData in @dset.
+ * 
+ */
+void
+ncm_dataset_profile_reset (NcmDataset *dset)
+{
+  guint i;
+
+  for (i = 0; i < dset->oa->len; i++)
+  {
+    NcmData *data = ncm_dataset_peek_data (dset, i);
+    ncm_data_profile_reset (data);
+  }
+}
+
+/**
+ * ncm_dataset_profile_add:
+ * @dset: a #NcmDataset
+ * @dset_src: a #NcmDataset
+ *
+ * Adds the profiling counters of every #NcmData in @dset_src to the
+ * corresponding #NcmData in @dset, see ncm_data_profile_add(). Both
+ * datasets must contain the same data, e.g., @dset_src is a copy of
+ * @dset used by a thread.
+ * 
+ */
+void
+ncm_dataset_profile_add (NcmDataset *dset, NcmDataset *dset_src)
+{
+  guint i;
+
+  g_assert_cmpuint (dset->oa->len, ==, dset_src->oa->len);
+
+  for (i = 0; i < dset->oa->len; i++)
+  {
+    NcmData *data     = ncm_dataset_peek_data (dset, i);
+    NcmData *data_src = ncm_dataset_peek_data (dset_src, i);
+
+    ncm_data_profile_add (data, data_src);
+  }
+}
+
+/**
+ * ncm_dataset_profile_total:
+ * @dset: a #NcmDataset
+ *
+ * Returns: the total time (seconds) spent in prepare and m2lnL_val by all data in @dset.
+ */
+gdouble
+ncm_dataset_profile_total (NcmDataset *dset)
+{
+  gdouble total = 0.0;
+  guint i;
+
+  for (i = 0; i < dset->oa->len; i++)
+  {
+    NcmData *data = ncm_dataset_peek_data (dset, i);
+    gulong prepare_ncalls, m2lnL_ncalls;
+    gdouble prepare_time, m2lnL_time;
+    
+    ncm_data_profile_get (data, &prepare_ncalls, &prepare_time, &m2lnL_ncalls, &m2lnL_time);
+    total += prepare_time + m2lnL_time;
+  }
+
+  return total;
+}
+
+/**
+ * ncm_dataset_log_profile:
+ * @dset: a #NcmDataset
+ *
+ * Prints the profiling information of every #NcmData in @dset: number
+ * of calls, total and mean time of the prepare and m2lnL_val steps and the
+ * fraction of the total time spent in each data.
+ * 
+ */
+void
+ncm_dataset_log_profile (NcmDataset *dset)
+{
+  const gdouble total = ncm_dataset_profile_total (dset);
+  guint i;
+
+  ncm_cfg_msg_sepa ();
+  g_message ("# Data profile:\n");
+  for (i = 0; i < dset->oa->len; i++)
+  {
+    NcmData *data = ncm_dataset_peek_data (dset, i);
+    gulong prepare_ncalls, m2lnL_ncalls;
+    gdouble prepare_time, m2lnL_time;
+
+    ncm_data_profile_get (data, &prepare_ncalls, &prepare_time, &m2lnL_ncalls, &m2lnL_time);
+
+    ncm_message_ww (ncm_data_peek_desc (data),
+                    "#   - ",
+                    "#       ",
+                    80);
+    g_message ("#       prepare:   %10lu calls, total % 12.6e s, mean % 12.6e s\n",
+               prepare_ncalls, prepare_time, (prepare_ncalls > 0) ? prepare_time / prepare_ncalls : 0.0);
+    g_message ("#       m2lnL_val: %10lu calls, total % 12.6e s, mean % 12.6e s\n",
+               m2lnL_ncalls, m2lnL_time, (m2lnL_ncalls > 0) ? m2lnL_time / m2lnL_ncalls : 0.0);
+    g_message ("#       fraction:  % 6.2f%%\n",
+               (total > 0.0) ? 100.0 * (prepare_time + m2lnL_time) / total : 0.0);
+  }
+  g_message ("# Data total time: % 12.6e s\n", total);
+
+  return;
+}
+
 /**
  * ncm_dataset_get_info:
  * @dset: a #NcmDataset
@@ -971,8 +1146,7 @@ ncm_dataset_m2lnL_val (NcmDataset *dset, NcmMSet *mset, gdouble *m2lnL)
     else
     {
       gdouble m2lnL_i;
-      ncm_data_prepare (data, mset);
-      NCM_DATA_GET_CLASS (data)->m2lnL_val (data, mset, &m2lnL_i);
+      ncm_data_m2lnL_val (data, mset, &m2lnL_i);
       *m2lnL += m2lnL_i;
     }
   }
@@ -1005,8 +1179,7 @@ ncm_dataset_m2lnL_vec (NcmDataset *dset, NcmMSet *mset, NcmVector *m2lnL_v)
     else
     {
       gdouble m2lnL_i;
-      ncm_data_prepare (data, mset);
-      NCM_DATA_GET_CLASS (data)->m2lnL_val (data, mset, &m2lnL_i);
+      ncm_data_m2lnL_val (data, mset, &m2lnL_i);
       ncm_vector_set (m2lnL_v, i, m2lnL_i);
     }
   }
@@ -1116,8 +1289,7 @@ ncm_dataset_m2lnL_i_val (NcmDataset *dset, NcmMSet *mset, guint i, gdouble *m2ln
       g_error ("ncm_dataset_m2lnL_val: %s dont implement m2lnL", G_OBJECT_TYPE_NAME (data));
     else
     {
-      ncm_data_prepare (data, mset);
-      NCM_DATA_GET_CLASS (data)->m2lnL_val (data, mset, m2lnL_i);
+      ncm_data_m2lnL_val (data, mset, m2lnL_i);
     }
   }
 
@@ -79,6 +79,7 @@ struct _NcmDataset
   NcmDatasetBStrapType bstype;
   GArray *data_prob;
   GArray *bstrap;
+  gboolean profile;
 };
 
 GType ncm_dataset_get_type (void) G_GNUC_CONST;
@@ -110,6 +111,13 @@ void ncm_dataset_bootstrap_resample (NcmDataset *dset, NcmRNG *rng);
 void ncm_dataset_log_info (NcmDataset *dset);
 gchar *ncm_dataset_get_info (NcmDataset *dset);
 
+void ncm_dataset_set_profile (NcmDataset *dset, gboolean enable);
+gboolean ncm_dataset_get_profile (NcmDataset *dset);
+void ncm_dataset_profile_reset (NcmDataset *dset);
+void ncm_dataset_profile_add (NcmDataset *dset, NcmDataset *dset_src);
+gdouble ncm_dataset_profile_total (NcmDataset *dset);
+void ncm_dataset_log_profile (NcmDataset *dset);
+
 gboolean ncm_dataset_has_leastsquares_f (NcmDataset *dset);
 gboolean ncm_dataset_has_leastsquares_J (NcmDataset *dset);
 gboolean ncm_dataset_has_leastsquares_f_J (NcmDataset *dset);
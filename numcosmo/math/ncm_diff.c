@@ -39,6 +39,7 @@
 #include "build_cfg.h"
 
 #include "math/ncm_diff.h"
+#include "math/ncm_func_eval.h"
 
 struct _NcmDiffPrivate
 {
@@ -46,6 +47,7 @@ struct _NcmDiffPrivate
   gdouble rs;
   gdouble roff_pad;
 	gdouble ini_h;
+  guint nthreads;
   GPtrArray *central_tables;
   GPtrArray *forward_tables;
   GPtrArray *backward_tables;
@@ -68,6 +70,7 @@ enum
   PROP_RS,
   PROP_ROFF_PAD,
 	PROP_INI_H,
+  PROP_NTHREADS,
   PROP_SIZE,
 };
 
@@ -81,6 +84,7 @@ ncm_diff_init (NcmDiff *diff)
   diff->priv->rs       = 0.0;
   diff->priv->roff_pad = 0.0;
 	diff->priv->ini_h    = 0.0;
+  diff->priv->nthreads = 0;
 
   diff->priv->central_tables  = g_ptr_array_new ();
   diff->priv->forward_tables  = g_ptr_array_new ();
@@ -111,6 +115,9 @@ _ncm_diff_set_property (GObject *object, guint prop_id, const GValue *value, GPa
     case PROP_INI_H:
       ncm_diff_set_ini_h (diff, g_value_get_double (value));
       break;
+    case PROP_NTHREADS:
+      ncm_diff_set_nthreads (diff, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -137,6 +144,9 @@ _ncm_diff_get_property (GObject *object, guint prop_id, GValue *value, GParamSpe
     case PROP_INI_H:
       g_value_set_double (value, ncm_diff_get_ini_h (diff));
       break;
+    case PROP_NTHREADS:
+      g_value_set_uint (value, ncm_diff_get_nthreads (diff));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -217,6 +227,13 @@ ncm_diff_class_init (NcmDiffClass *klass)
 	                                                      "Initial h",
 	                                                      GSL_DBL_EPSILON, G_MAXDOUBLE, pow (GSL_DBL_EPSILON, 1.0 / 8.0),
 	                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_NTHREADS,
+                                   g_param_spec_uint ("nthreads",
+                                                      NULL,
+                                                      "Number of threads used to evaluate the stencil points",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 NcmDiffTable *
@@ -458,6 +475,20 @@ ncm_diff_get_ini_h (NcmDiff *diff)
   return diff->priv->ini_h;
 }
 
+/**
+ * ncm_diff_get_nthreads:
+ * @diff: a #NcmDiff
+ *
+ * Gets the number of threads used to evaluate the stencil points.
+ * 
+ * Returns: the number of threads.
+ */
+guint 
+ncm_diff_get_nthreads (NcmDiff *diff)
+{
+  return diff->priv->nthreads;
+}
+
 /**
  * ncm_diff_set_max_order:
  * @diff: a #NcmDiff
@@ -534,6 +565,24 @@ ncm_diff_set_ini_h (NcmDiff *diff, const gdouble ini_h)
   diff->priv->ini_h = ini_h;
 }
 
+/**
+ * ncm_diff_set_nthreads:
+ * @diff: a #NcmDiff
+ * @nthreads: number of threads
+ *
+ * Sets the number of threads used to evaluate the stencil points
+ * of a given Richardson step. When @nthreads is larger than one
+ * the single point functions passed to @diff are called
+ * concurrently and, therefore, must be thread safe. The batched
+ * variants, e.g. ncm_diff_rf_d1_N_to_M_batch(), are not affected.
+ * 
+ */
+void 
+ncm_diff_set_nthreads (NcmDiff *diff, const guint nthreads)
+{
+  diff->priv->nthreads = nthreads;
+}
+
 /**
  * ncm_diff_log_central_tables:
  * @diff: a #NcmDiff
@@ -600,20 +649,24 @@ ncm_diff_log_backward_tables (NcmDiff *diff)
   }
 }
 
-typedef void (*NcmDiffStepAlgo) (NcmDiff *diff, NcmDiffFuncNtoM f, gpointer user_data, const guint a, const gdouble x, const gdouble h, NcmVector *x_v, NcmVector *f_v, NcmVector *yh1_v, NcmVector *yh2_v, NcmVector *df, NcmVector *roff);
-typedef void (*NcmDiffHessianStepAlgo) (NcmDiff *diff, NcmDiffFuncNto1 f, gpointer user_data, const guint a, const gdouble x, const gdouble hx, const guint b, const gdouble y, const gdouble hy, NcmVector *x_v, const gdouble fval, gdouble *df, gdouble *roff);
+typedef void (*NcmDiffStepAlgo) (const gdouble h, NcmVector *f_v, NcmVector *yp_v, NcmVector *ym_v, NcmVector *df, NcmVector *roff);
 
-static void
-_ncm_diff_rf_d1_step (NcmDiff *diff, NcmDiffFuncNtoM f, gpointer user_data, const guint a, const gdouble x, const gdouble h, NcmVector *x_v, NcmVector *f_v, NcmVector *yh1_v, NcmVector *yh2_v, NcmVector *df, NcmVector *roff)
+typedef struct _NcmDiffStep
 {
-  /*ncm_vector_log_vals (x_v,  "x_v  ", "% 22.15g", TRUE);*/
-  ncm_vector_addto (x_v, a, h);
+  NcmDiffStepAlgo step_algo;
+  guint npoints;
+} NcmDiffStep;
 
-  /*ncm_vector_log_vals (x_v,  "xh_v ", "% 22.15g", TRUE);*/
-  /*ncm_vector_log_vals (f_v,  "f_v  ", "% 22.15g", TRUE);*/
-  f (x_v, df, user_data);
+/*
+ * The step algorithms receive the function evaluated at x + h (yp_v) and,
+ * for the central methods, at x - h (ym_v).
+ *
+ */
 
-  /*ncm_vector_log_vals (yh_v, "yh_v ", "% 22.15g", TRUE);*/
+static void
+_ncm_diff_rf_d1_step (const gdouble h, NcmVector *f_v, NcmVector *yp_v, NcmVector *ym_v, NcmVector *df, NcmVector *roff)
+{
+  ncm_vector_memcpy (df, yp_v);
 
   ncm_vector_memcpy (roff, df);
   ncm_vector_sub_round_off (roff, f_v);
@@ -623,50 +676,31 @@ _ncm_diff_rf_d1_step (NcmDiff *diff, NcmDiffFuncNtoM f, gpointer user_data, cons
 
   ncm_vector_mul (roff, df);
 
-  NCM_UNUSED (yh1_v);
-  NCM_UNUSED (yh2_v);
-
-  /*
-   printf ("# t = %u\n", t);
-   ncm_vector_log_vals (df,   "df   ", "% 22.15g", TRUE);
-   ncm_vector_log_vals (roff, "roff ", "% 22.15g", TRUE);
-   */
+  NCM_UNUSED (ym_v);
 }
 
 static void
-_ncm_diff_rc_d1_step (NcmDiff *diff, NcmDiffFuncNtoM f, gpointer user_data, const guint a, const gdouble x, const gdouble h, NcmVector *x_v, NcmVector *f_v, NcmVector *yh1_v, NcmVector *yh2_v, NcmVector *df, NcmVector *roff)
+_ncm_diff_rc_d1_step (const gdouble h, NcmVector *f_v, NcmVector *yp_v, NcmVector *ym_v, NcmVector *df, NcmVector *roff)
 {
-  ncm_vector_addto (x_v, a, h);
-
-  f (x_v, df, user_data);
+  ncm_vector_memcpy (df, yp_v);
 
-  ncm_vector_set (x_v, a, x - h);
-
-  f (x_v, yh1_v, user_data);
-  
   ncm_vector_memcpy (roff, df);
-  ncm_vector_sub_round_off (roff, yh1_v);
+  ncm_vector_sub_round_off (roff, ym_v);
 
-  ncm_vector_sub   (df, yh1_v);
+  ncm_vector_sub   (df, ym_v);
   ncm_vector_scale (df, 0.5 / h);
 
   ncm_vector_mul (roff, df);
 
-  NCM_UNUSED (yh2_v);
+  NCM_UNUSED (f_v);
 }
 
 static void
-_ncm_diff_rc_d2_step (NcmDiff *diff, NcmDiffFuncNtoM f, gpointer user_data, const guint a, const gdouble x, const gdouble h, NcmVector *x_v, NcmVector *f_v, NcmVector *yh1_v, NcmVector *yh2_v, NcmVector *df, NcmVector *roff)
+_ncm_diff_rc_d2_step (const gdouble h, NcmVector *f_v, NcmVector *yp_v, NcmVector *ym_v, NcmVector *df, NcmVector *roff)
 {
-  ncm_vector_addto (x_v, a, h);
+  ncm_vector_memcpy (df, yp_v);
 
-  f (x_v, df, user_data);
-
-  ncm_vector_set (x_v, a, x - h);
-
-  f (x_v, yh1_v, user_data);
-
-  ncm_vector_add (df, yh1_v);
+  ncm_vector_add (df, ym_v);
   ncm_vector_scale (df, 0.5);
   
   ncm_vector_memcpy (roff, df);
@@ -676,80 +710,127 @@ _ncm_diff_rc_d2_step (NcmDiff *diff, NcmDiffFuncNtoM f, gpointer user_data, cons
   ncm_vector_scale (df, 2.0 / (h * h));
 
   ncm_vector_mul (roff, df);
-
-  NCM_UNUSED (yh2_v);
 }
 
-void 
-_ncm_diff_rf_Hessian_step (NcmDiff *diff, NcmDiffFuncNto1 f, gpointer user_data, const guint a, const gdouble x, const gdouble hx, const guint b, const gdouble y, const gdouble hy, NcmVector *x_v, const gdouble fval, gdouble *df, gdouble *roff)
+static const NcmDiffStep _ncm_diff_rf_d1 = {&_ncm_diff_rf_d1_step, 1};
+static const NcmDiffStep _ncm_diff_rc_d1 = {&_ncm_diff_rc_d1_step, 2};
+static const NcmDiffStep _ncm_diff_rc_d2 = {&_ncm_diff_rc_d2_step, 2};
+
+typedef struct _NcmDiffEval
 {
-  gdouble f_hx, f_hy, f_hxhy;
-    
-  ncm_vector_addto (x_v, a, hx);
-  f_hx = f (x_v, user_data);
+  NcmDiffFuncNtoM f;
+  NcmDiffFuncNtoMBatch fb;
+  gpointer user_data;
+  NcmMatrix *X;
+  NcmMatrix *Y;
+} NcmDiffEval;
 
-  ncm_vector_set (x_v, a, x);
-  ncm_vector_addto (x_v, b, hy);
-  f_hy = f (x_v, user_data);
+static void
+_ncm_diff_eval_points (glong i, glong f, gpointer data)
+{
+  NcmDiffEval *ev = (NcmDiffEval *) data;
+  glong k;
 
-  ncm_vector_addto (x_v, a, hx);
-  f_hxhy = f (x_v, user_data);
+  for (k = i; k < f; k++)
+  {
+    NcmVector *x_k = ncm_matrix_get_row (ev->X, k);
+    NcmVector *y_k = ncm_matrix_get_row (ev->Y, k);
 
-  df[0] = ((fval + f_hxhy) - (f_hx + f_hy)) / (hx * hy);
+    ev->f (x_k, y_k, ev->user_data);
 
-  {
-    const gdouble s1 = fval + f_hxhy;
-    const gdouble s2 = f_hx + f_hy;
+    ncm_vector_free (x_k);
+    ncm_vector_free (y_k);
+  }
+}
 
-    const gdouble d1 = s1 - s2;
+/*
+ * Evaluates the function at every row of X, writing the results in the
+ * rows of Y, using the batched callback when available, otherwise the
+ * single point function, in threads when nthreads > 1.
+ *
+ */
+static void
+_ncm_diff_eval (NcmDiff *diff, NcmDiffEval *ev, NcmMatrix *X, NcmMatrix *Y)
+{
+  const guint np = ncm_matrix_nrows (X);
 
-    if (G_UNLIKELY (d1 == 0.0))
-      roff[0] = 1.0;
-    else
-    {
-      const gdouble abs_s1  = fabs (s1);
-      const gdouble abs_s2  = fabs (s2);
-      const gdouble max_s12 = GSL_MAX (abs_s1, abs_s2);
-      roff[0] = fabs (max_s12 * GSL_DBL_EPSILON / d1);
-    }
+  ev->X = X;
+  ev->Y = Y;
+
+  if (ev->fb != NULL)
+    ev->fb (X, Y, ev->user_data);
+  else if ((diff->priv->nthreads > 1) && (np > 1))
+    ncm_func_eval_threaded_loop_ws_nw (&_ncm_diff_eval_points, 0, np, ev, GSL_MIN (diff->priv->nthreads, np), 1);
+  else
+    _ncm_diff_eval_points (0, np, ev);
+
+  ev->X = NULL;
+  ev->Y = NULL;
+}
+
+static void
+_ncm_diff_eval_center (NcmDiff *diff, NcmDiffEval *ev, NcmVector *x_v, NcmVector *f_v)
+{
+  NcmMatrix *X = ncm_matrix_new (1, ncm_vector_len (x_v));
+  NcmMatrix *Y = ncm_matrix_new (1, ncm_vector_len (f_v));
+
+  ncm_matrix_set_row (X, 0, x_v);
+  _ncm_diff_eval (diff, ev, X, Y);
+  {
+    NcmVector *y_0 = ncm_matrix_get_row (Y, 0);
+    ncm_vector_memcpy (f_v, y_0);
+    ncm_vector_free (y_0);
   }
+
+  ncm_matrix_free (X);
+  ncm_matrix_free (Y);
 }
 
+typedef struct _NcmDiffRState
+{
+  GPtrArray *dfs;
+  GPtrArray *roffs;
+  NcmVector *dfb;
+  NcmVector *dfr;
+  NcmVector *roffb;
+  NcmVector *roffr;
+  NcmVector *ferr;
+  NcmVector *df_best;
+  GArray *not_conv;
+  gboolean started;
+  gboolean active;
+} NcmDiffRState;
+
+/*
+ * All variables are advanced together through the Richardson
+ * extrapolation orders. At each order the stencil points of all
+ * variables still improving are collected and evaluated in a single
+ * batch; the extrapolation of each variable follows exactly the same
+ * sequence of steps as if the variables were treated one at a time.
+ *
+ */
 static GArray *
-ncm_diff_by_step_algo (NcmDiff *diff, NcmDiffStepAlgo step_algo, guint po, GArray *x_a, const guint dim, NcmDiffFuncNtoM f, gpointer user_data, GArray **Eerr)
-{
-  GPtrArray *tables  = NULL;
-  GPtrArray *dfs     = g_ptr_array_new ();
-  GPtrArray *roffs   = g_ptr_array_new ();
-  GArray *f_a        = g_array_new (FALSE, FALSE, sizeof (gdouble));
-  GArray *yh_a       = g_array_new (FALSE, FALSE, sizeof (gdouble));
-  NcmVector *x_v     = NULL;
-  NcmVector *f_v     = NULL; 
-  NcmVector *yh1_v   = NULL;
-  NcmVector *yh2_v   = NULL;
-  NcmVector *dfb     = NULL;
-  NcmVector *dfr     = NULL;
-  NcmVector *roffb   = NULL;
-  NcmVector *roffr   = NULL;
-  NcmVector *err     = NULL;
-  NcmVector *err_err = NULL;
-  NcmVector *ferr    = NULL;
-  NcmVector *df_best = NULL;
-  GArray *df         = g_array_new (FALSE, FALSE, sizeof (gdouble));
-  GArray *not_conv   = g_array_new (FALSE, FALSE, sizeof (guchar));
-  const guint nvar   = x_a->len;
-  NcmMatrix *Eerr_m  = NULL;
+_ncm_diff_by_step_algo_eval (NcmDiff *diff, const NcmDiffStep *step, guint po, GArray *x_a, const guint dim, NcmDiffEval *ev, GArray **Eerr)
+{
+  GPtrArray *tables     = (po == 0) ? diff->priv->forward_tables : diff->priv->central_tables;
+  const guint nvar      = x_a->len;
+  const guint ntry_conv = 3;
+  NcmDiffRState *rs     = g_new0 (NcmDiffRState, nvar);
+  GArray *df            = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  NcmVector *x_v        = ncm_vector_new_array (x_a);
+  NcmVector *f_v        = ncm_vector_new (dim);
+  NcmVector *err        = ncm_vector_new (dim);
+  NcmVector *err_err    = ncm_vector_new (dim);
+  NcmMatrix *Eerr_m     = NULL;
+  guint nactive         = nvar;
+  guint t               = 0;
   NcmMatrix *df_m;
+  guint order_index;
   guint a;
 
   g_array_set_size (df, dim * nvar);
   df_m = ncm_matrix_new_array (df, dim);
 
-  if (po == 0)
-    tables = diff->priv->forward_tables;
-  else
-    tables = diff->priv->central_tables;
-
   if (Eerr != NULL)
   {
     *Eerr = g_array_new (FALSE, FALSE, sizeof (gdouble));
@@ -757,125 +838,146 @@ ncm_diff_by_step_algo (NcmDiff *diff, NcmDiffStepAlgo step_algo, guint po, GArra
     Eerr_m = ncm_matrix_new_array (*Eerr, dim);
   }
 
-  g_ptr_array_set_free_func (dfs,   (GDestroyNotify) ncm_vector_free);
-  g_ptr_array_set_free_func (roffs, (GDestroyNotify) ncm_vector_free);
-  
-  g_array_set_size (f_a,      dim);
-  g_array_set_size (yh_a,     dim);
-  g_array_set_size (not_conv, dim);
-
-  x_v   = ncm_vector_new_array (x_a);
-  f_v   = ncm_vector_new_array (f_a);
-  yh1_v = ncm_vector_new_array (yh_a);
-  yh2_v = ncm_vector_new_array (yh_a);
-
-  dfb     = ncm_vector_new (dim);
-  dfr     = ncm_vector_new (dim);
-
-  roffb   = ncm_vector_new (dim);
-  roffr   = ncm_vector_new (dim);
+  for (a = 0; a < nvar; a++)
+  {
+    rs[a].dfs      = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_vector_free);
+    rs[a].roffs    = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_vector_free);
+    rs[a].dfb      = ncm_vector_new (dim);
+    rs[a].dfr      = ncm_vector_new (dim);
+    rs[a].roffb    = ncm_vector_new (dim);
+    rs[a].roffr    = ncm_vector_new (dim);
+    rs[a].ferr     = ncm_vector_new (dim);
+    rs[a].df_best  = ncm_vector_new (dim);
+    rs[a].not_conv = g_array_new (FALSE, FALSE, sizeof (guchar));
+    rs[a].started  = FALSE;
+    rs[a].active   = TRUE;
+
+    ncm_vector_set_all (rs[a].ferr, GSL_POSINF);
+    g_array_set_size (rs[a].not_conv, dim);
+    memset (rs[a].not_conv->data, ntry_conv, rs[a].not_conv->len);
+  }
 
-  err     = ncm_vector_new (dim);
-  err_err = ncm_vector_new (dim);
-  ferr    = ncm_vector_new (dim);
-  df_best = ncm_vector_new (dim);
-  
-  g_array_unref (f_a);
-  g_array_unref (yh_a);
+  _ncm_diff_eval_center (diff, ev, x_v, f_v);
 
-  f (x_v, f_v, user_data);
-  
-  for (a = 0; a < x_a->len; a++)
+  for (order_index = 0; (order_index < diff->priv->maxorder) && (nactive > 0); order_index++)
   {
-    const gdouble x       = g_array_index (x_a, gdouble, a);
-    const gdouble scale   = (x == 0.0) ? 1.0 : fabs (x);
-    const gdouble h0      = diff->priv->ini_h * scale;
-    const guint ntry_conv = 3;
-    NcmDiffTable *ldtable = NULL;
-    guint order_index;
-    guint t = 0;
-
-    ncm_vector_set_all (ferr, GSL_POSINF);
-    g_ptr_array_set_size (dfs, 0);
-    g_ptr_array_set_size (roffs, 0);
-
-    memset (not_conv->data, ntry_conv, not_conv->len);
-        
-    for (order_index = 0; order_index < diff->priv->maxorder; order_index++)
+    const guint nt       = order_index + 2;
+    const guint nsteps   = nt - t;
+    NcmDiffTable *dtable = g_ptr_array_index (tables, order_index);
+    NcmMatrix *X         = ncm_matrix_new (nactive * nsteps * step->npoints, nvar);
+    NcmMatrix *Y         = ncm_matrix_new (nactive * nsteps * step->npoints, dim);
+    NcmMatrix *h_m       = ncm_matrix_new (nvar, nsteps);
+    guint k              = 0;
+
+    for (a = 0; a < nvar; a++)
     {
-      const guint nt       = order_index + 2;
-      NcmDiffTable *dtable = g_ptr_array_index (tables, order_index);
-      guint i;
+      const gdouble x     = g_array_index (x_a, gdouble, a);
+      const gdouble scale = (x == 0.0) ? 1.0 : fabs (x);
+      const gdouble h0    = diff->priv->ini_h * scale;
+      guint s;
 
-      for (; t < nt; t++)
+      if (!rs[a].active)
+        continue;
+
+      for (s = 0; s < nsteps; s++)
       {
-        const gdouble ho      = h0 * ((po == 0) ? ncm_vector_get (dtable->h, t) : sqrt (ncm_vector_get (dtable->h, t)));
+        const gdouble ho      = h0 * ((po == 0) ? ncm_vector_get (dtable->h, t + s) : sqrt (ncm_vector_get (dtable->h, t + s)));
         volatile gdouble temp = x + ho;
         const gdouble h       = temp - x;
+        guint p;
+
+        ncm_matrix_set (h_m, a, s, h);
+
+        for (p = 0; p < step->npoints; p++)
+        {
+          ncm_matrix_set_row (X, k, x_v);
+          ncm_matrix_set (X, k, a, (p == 0) ? x + h : x - h);
+          k++;
+        }
+      }
+    }
+
+    _ncm_diff_eval (diff, ev, X, Y);
+
+    k = 0;
+    for (a = 0; a < nvar; a++)
+    {
+      NcmDiffRState *rs_a = &rs[a];
+      guint s, i;
+
+      if (!rs_a->active)
+        continue;
 
+      for (s = 0; s < nsteps; s++)
+      {
         NcmVector *df_t   = ncm_vector_new (dim);
         NcmVector *roff_t = ncm_vector_new (dim);
+        NcmVector *yp_v   = ncm_matrix_get_row (Y, k);
+        NcmVector *ym_v   = (step->npoints > 1) ? ncm_matrix_get_row (Y, k + 1) : NULL;
 
-        step_algo (diff, f, user_data, a, x, h, x_v, f_v, yh1_v, yh2_v, df_t, roff_t);
+        step->step_algo (ncm_matrix_get (h_m, a, s), f_v, yp_v, ym_v, df_t, roff_t);
 
-        g_ptr_array_add (dfs,   df_t);
-        g_ptr_array_add (roffs, roff_t);
-        
-        ncm_vector_set (x_v, a, x);
+        g_ptr_array_add (rs_a->dfs,   df_t);
+        g_ptr_array_add (rs_a->roffs, roff_t);
+
+        ncm_vector_free (yp_v);
+        ncm_vector_clear (&ym_v);
+
+        k += step->npoints;
       }
 
-      if (ldtable == NULL)
+      if (!rs_a->started)
       {
-        ncm_vector_memcpy (dfb, g_ptr_array_index (dfs, 0));
-        ncm_vector_memcpy (dfr, g_ptr_array_index (dfs, 0));
+        ncm_vector_memcpy (rs_a->dfb, g_ptr_array_index (rs_a->dfs, 0));
+        ncm_vector_memcpy (rs_a->dfr, g_ptr_array_index (rs_a->dfs, 0));
 
-        ncm_vector_memcpy (roffb, g_ptr_array_index (roffs, 0));
-        ncm_vector_memcpy (roffr, g_ptr_array_index (roffs, 0));
+        ncm_vector_memcpy (rs_a->roffb, g_ptr_array_index (rs_a->roffs, 0));
+        ncm_vector_memcpy (rs_a->roffr, g_ptr_array_index (rs_a->roffs, 0));
         
-        ncm_vector_memcpy (df_best, dfb);
+        ncm_vector_memcpy (rs_a->df_best, rs_a->dfb);
         
-        ncm_vector_scale (dfr, ncm_vector_get (dtable->lambda, 0));
-        ncm_vector_axpy  (dfr, ncm_vector_get (dtable->lambda, 1), g_ptr_array_index (dfs, 1));
+        ncm_vector_scale (rs_a->dfr, ncm_vector_get (dtable->lambda, 0));
+        ncm_vector_axpy  (rs_a->dfr, ncm_vector_get (dtable->lambda, 1), g_ptr_array_index (rs_a->dfs, 1));
 
-        ncm_vector_scale (roffr, ncm_vector_get (dtable->lambda, 0));
-        ncm_vector_axpy  (roffr, ncm_vector_get (dtable->lambda, 1), g_ptr_array_index (roffs, 1));
+        ncm_vector_scale (rs_a->roffr, ncm_vector_get (dtable->lambda, 0));
+        ncm_vector_axpy  (rs_a->roffr, ncm_vector_get (dtable->lambda, 1), g_ptr_array_index (rs_a->roffs, 1));
       }
       else
       {
-        ncm_vector_memcpy (dfr, g_ptr_array_index (dfs, 0));
-        ncm_vector_scale (dfr, ncm_vector_get (dtable->lambda, 0));
+        ncm_vector_memcpy (rs_a->dfr, g_ptr_array_index (rs_a->dfs, 0));
+        ncm_vector_scale (rs_a->dfr, ncm_vector_get (dtable->lambda, 0));
 
-        ncm_vector_memcpy (roffr, g_ptr_array_index (roffs, 0));
-        ncm_vector_scale (roffr, ncm_vector_get (dtable->lambda, 0));
+        ncm_vector_memcpy (rs_a->roffr, g_ptr_array_index (rs_a->roffs, 0));
+        ncm_vector_scale (rs_a->roffr, ncm_vector_get (dtable->lambda, 0));
 
         for (i = 1; i < nt; i++)
         {
-          ncm_vector_axpy (dfr,   ncm_vector_get (dtable->lambda,  i), g_ptr_array_index (dfs, i));
-          ncm_vector_axpy (roffr, ncm_vector_get (dtable->lambda,  i), g_ptr_array_index (roffs, i));
+          ncm_vector_axpy (rs_a->dfr,   ncm_vector_get (dtable->lambda,  i), g_ptr_array_index (rs_a->dfs, i));
+          ncm_vector_axpy (rs_a->roffr, ncm_vector_get (dtable->lambda,  i), g_ptr_array_index (rs_a->roffs, i));
         }
       }
       
-      ncm_vector_memcpy (err, dfr);
-      ncm_vector_memcpy (err_err, dfr);
+      ncm_vector_memcpy (err, rs_a->dfr);
+      ncm_vector_memcpy (err_err, rs_a->dfr);
 
-      ncm_vector_sub (err, dfb);
-      ncm_vector_cmp (err_err, dfb);
+      ncm_vector_sub (err, rs_a->dfb);
+      ncm_vector_cmp (err_err, rs_a->dfb);
       {
         gboolean improve = FALSE;
         for (i = 0; i < dim; i++)
         {
           const gdouble err_i     = fabs (ncm_vector_get (err, i));
-          const gdouble ferr_i    = ncm_vector_get (ferr, i);
-          const gdouble roffb_i   = fabs (ncm_vector_get (roffb, i)) * diff->priv->roff_pad;
-          const gdouble roffr_i   = fabs (ncm_vector_get (roffr, i)) * diff->priv->roff_pad;
+          const gdouble ferr_i    = ncm_vector_get (rs_a->ferr, i);
+          const gdouble roffb_i   = fabs (ncm_vector_get (rs_a->roffb, i)) * diff->priv->roff_pad;
+          const gdouble roffr_i   = fabs (ncm_vector_get (rs_a->roffr, i)) * diff->priv->roff_pad;
           
           const gdouble terr_i    = GSL_MAX (err_i, GSL_MAX (roffb_i, roffr_i));
           const gdouble err_err_i = ncm_vector_get (err_err, i);
 
-          gdouble df_best_i = ncm_vector_get (df_best, i);
+          gdouble df_best_i = ncm_vector_get (rs_a->df_best, i);
           gdouble cerr_i    = ferr_i;
 
-#define NOT_CONV (g_array_index (not_conv, guchar, i))
+#define NOT_CONV (g_array_index (rs_a->not_conv, guchar, i))
 
           if (NOT_CONV && (err_err_i < 1.0e-3))
             NOT_CONV--;
@@ -885,15 +987,15 @@ ncm_diff_by_step_algo (NcmDiff *diff, NcmDiffStepAlgo step_algo, guint po, GArra
             {
               NOT_CONV = ntry_conv;
               if (err_err_i > 1.0)
-                ncm_vector_set (ferr, i, GSL_POSINF);
+                ncm_vector_set (rs_a->ferr, i, GSL_POSINF);
             }
           }
           
           if ((terr_i < ferr_i) && !NOT_CONV)
           {
-            df_best_i = ncm_vector_get (dfr, i);
-            ncm_vector_set (df_best, i, df_best_i);
-            ncm_vector_set (ferr, i, terr_i);
+            df_best_i = ncm_vector_get (rs_a->dfr, i);
+            ncm_vector_set (rs_a->df_best, i, df_best_i);
+            ncm_vector_set (rs_a->ferr, i, terr_i);
             cerr_i = terr_i;
 
             improve = TRUE;
@@ -901,101 +1003,111 @@ ncm_diff_by_step_algo (NcmDiff *diff, NcmDiffStepAlgo step_algo, guint po, GArra
 
           if (NOT_CONV || (roffr_i < cerr_i))
             improve = TRUE;
-/*          
-          printf ("[%3u, %3u, %3u] !conv %u % 22.15g % 22.15g % 22.15g % 22.15g % 22.15g improve: %s\n", 
-                  nt, i, a, NOT_CONV, ferr_i, err_i, roffb_i, roffr_i,
-                  err_err_i, improve ? "T" : "F");
-*/
+#undef NOT_CONV
         }
 
         if (!improve)
-          break;
+        {
+          rs_a->active = FALSE;
+          nactive--;
+          continue;
+        }
       }
-/*
-      ncm_vector_log_vals (dfb,     "dfb  ", "% 22.15g", TRUE);
-      ncm_vector_log_vals (dfr,     "dfr  ", "% 22.15g", TRUE);
-      ncm_vector_log_vals (err,     "err  ", "% 22.15e", TRUE);
 
-      ncm_vector_log_vals (df_best, "df   ", "% 22.15g", TRUE);
-      ncm_vector_log_vals (ferr,    "ferr ", "% 22.15e", TRUE);
-*/
-
-      ncm_vector_memcpy (dfb, dfr);
-      ncm_vector_memcpy (roffb, roffr);
-      ldtable = dtable;
+      ncm_vector_memcpy (rs_a->dfb, rs_a->dfr);
+      ncm_vector_memcpy (rs_a->roffb, rs_a->roffr);
+      rs_a->started = TRUE;
     }
 
-    {
-      NcmVector *df_a = ncm_matrix_get_row (df_m, a);
-      ncm_vector_memcpy (df_a, df_best);
-      ncm_vector_free (df_a);
+    t = nt;
 
-      if (Eerr_m != NULL)
-      {
-        NcmVector *Eerr_a = ncm_matrix_get_row (Eerr_m, a);
-        ncm_vector_memcpy (Eerr_a, ferr);
-        ncm_vector_free (Eerr_a);
-      }
-    }
+    ncm_matrix_free (X);
+    ncm_matrix_free (Y);
+    ncm_matrix_free (h_m);
   }
 
-  if (Eerr_m != NULL)
+  for (a = 0; a < nvar; a++)
   {
-    ncm_matrix_scale (Eerr_m, NCM_DIFF_ERR_PAD);
+    ncm_matrix_set_row (df_m, a, rs[a].df_best);
+
+    if (Eerr_m != NULL)
+      ncm_matrix_set_row (Eerr_m, a, rs[a].ferr);
+
+    g_ptr_array_unref (rs[a].dfs);
+    g_ptr_array_unref (rs[a].roffs);
+    ncm_vector_free (rs[a].dfb);
+    ncm_vector_free (rs[a].dfr);
+    ncm_vector_free (rs[a].roffb);
+    ncm_vector_free (rs[a].roffr);
+    ncm_vector_free (rs[a].ferr);
+    ncm_vector_free (rs[a].df_best);
+    g_array_unref (rs[a].not_conv);
   }
 
+  if (Eerr_m != NULL)
   {
-    g_array_unref (not_conv);
-    
-    g_ptr_array_unref (dfs);
-    g_ptr_array_unref (roffs);
-
-    ncm_vector_clear (&x_v);
-    ncm_vector_clear (&f_v);
-    ncm_vector_clear (&yh1_v);
-    ncm_vector_clear (&yh2_v);
-
-    ncm_vector_clear (&dfb);
-    ncm_vector_clear (&dfr);
+    ncm_matrix_scale (Eerr_m, NCM_DIFF_ERR_PAD);
+  }
 
-    ncm_vector_clear (&roffb);
-    ncm_vector_clear (&roffr);
+  g_free (rs);
 
-    ncm_vector_clear (&err);
-    ncm_vector_clear (&err_err);
-    
-    ncm_vector_clear (&ferr);
-    ncm_vector_clear (&df_best);
+  ncm_vector_clear (&x_v);
+  ncm_vector_clear (&f_v);
+  ncm_vector_clear (&err);
+  ncm_vector_clear (&err_err);
 
-    ncm_matrix_clear (&df_m);
-    ncm_matrix_clear (&Eerr_m);
+  ncm_matrix_clear (&df_m);
+  ncm_matrix_clear (&Eerr_m);
 
-    return df;
-  }
+  return df;
 }
 
+typedef struct _NcmDiffHState
+{
+  guint a;
+  guint b;
+  GArray *dfs;
+  GArray *roffs;
+  gdouble ferr;
+  gdouble df_best;
+  gdouble dfb;
+  gdouble dfr;
+  gdouble roffb;
+  gdouble roffr;
+  guint not_converging;
+  gboolean started;
+  gboolean active;
+} NcmDiffHState;
+
+/*
+ * Same strategy as _ncm_diff_by_step_algo_eval(), each pair (a, b), a < b, is
+ * advanced through the extrapolation orders and its three stencil
+ * points per step, (x + hx), (y + hy) and (x + hx, y + hy), are
+ * evaluated together with the other pairs.
+ *
+ */
 static GArray *
-ncm_diff_Hessian_by_step_algo (NcmDiff *diff, NcmDiffHessianStepAlgo Hstep_algo, guint po, GArray *x_a, NcmDiffFuncNto1 f, gpointer user_data, GArray **Eerr)
-{
-  GPtrArray *tables = NULL;
-  GArray *dfs       = g_array_new (FALSE, FALSE, sizeof (gdouble));
-  GArray *roffs     = g_array_new (FALSE, FALSE, sizeof (gdouble));
-  NcmVector *x_v    = NULL;
-  GArray *df        = g_array_new (FALSE, FALSE, sizeof (gdouble));
-  const guint nvar  = x_a->len;
-  gdouble fval      = 0.0;
-  NcmMatrix *Eerr_m = NULL;
+_ncm_diff_Hessian_by_step_algo_eval (NcmDiff *diff, guint po, GArray *x_a, NcmDiffEval *ev, GArray **Eerr)
+{
+  GPtrArray *tables     = (po == 0) ? diff->priv->forward_tables : diff->priv->central_tables;
+  const guint nvar      = x_a->len;
+  const guint npairs    = nvar * (nvar - 1) / 2;
+  const guint ntry_conv = 3;
+  NcmDiffHState *hs     = g_new0 (NcmDiffHState, npairs);
+  GArray *df            = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  NcmVector *x_v        = ncm_vector_new_array (x_a);
+  NcmVector *f_v        = ncm_vector_new (1);
+  NcmMatrix *Eerr_m     = NULL;
+  guint nactive         = npairs;
+  guint t               = 0;
+  gdouble fval          = 0.0;
   NcmMatrix *df_m;
-  guint a;
+  guint order_index;
+  guint n;
 
   g_array_set_size (df, nvar * nvar);
   df_m = ncm_matrix_new_array (df, nvar); 
 
-  if (po == 0)
-    tables = diff->priv->forward_tables;
-  else
-    tables = diff->priv->central_tables;
-
   if (Eerr != NULL)
   {
     *Eerr = g_array_new (FALSE, FALSE, sizeof (gdouble));
@@ -1003,175 +1115,256 @@ ncm_diff_Hessian_by_step_algo (NcmDiff *diff, NcmDiffHessianStepAlgo Hstep_algo,
     Eerr_m = ncm_matrix_new_array (*Eerr, nvar);
   }
 
-  x_v  = ncm_vector_new_array (x_a);
+  {
+    guint a, b;
+
+    n = 0;
+    for (a = 0; a < nvar; a++)
+    {
+      for (b = a + 1; b < nvar; b++)
+      {
+        hs[n].a              = a;
+        hs[n].b              = b;
+        hs[n].dfs            = g_array_new (FALSE, FALSE, sizeof (gdouble));
+        hs[n].roffs          = g_array_new (FALSE, FALSE, sizeof (gdouble));
+        hs[n].ferr           = GSL_POSINF;
+        hs[n].df_best        = 0.0;
+        hs[n].dfb            = 0.0;
+        hs[n].dfr            = 0.0;
+        hs[n].roffb          = 0.0;
+        hs[n].roffr          = 0.0;
+        hs[n].not_converging = ntry_conv;
+        hs[n].started        = FALSE;
+        hs[n].active         = TRUE;
+        n++;
+      }
+    }
+  }
 
-  fval = f (x_v, user_data);
+  _ncm_diff_eval_center (diff, ev, x_v, f_v);
+  fval = ncm_vector_get (f_v, 0);
 
-  for (a = 0; a < x_a->len; a++)
+  for (order_index = 0; (order_index < diff->priv->maxorder) && (nactive > 0); order_index++)
   {
-    guint b;
-    for (b = a + 1; b < x_a->len; b++)
+    const guint nt       = order_index + 2;
+    const guint nsteps   = nt - t;
+    NcmDiffTable *dtable = g_ptr_array_index (tables, order_index);
+    NcmMatrix *X         = ncm_matrix_new (nactive * nsteps * 3, nvar);
+    NcmMatrix *Y         = ncm_matrix_new (nactive * nsteps * 3, 1);
+    NcmMatrix *hx_m      = ncm_matrix_new (npairs, nsteps);
+    NcmMatrix *hy_m      = ncm_matrix_new (npairs, nsteps);
+    guint k              = 0;
+
+    for (n = 0; n < npairs; n++)
     {
-      const guint ntry_conv = 3;
+      const guint a         = hs[n].a;
+      const guint b         = hs[n].b;
       const gdouble x       = g_array_index (x_a, gdouble, a);
       const gdouble y       = g_array_index (x_a, gdouble, b);
       const gdouble scale_x = (x == 0.0) ? 1.0 : fabs (x);
       const gdouble scale_y = (y == 0.0) ? 1.0 : fabs (y);
       const gdouble hx0     = diff->priv->ini_h * scale_x;
       const gdouble hy0     = diff->priv->ini_h * scale_y;
-      NcmDiffTable *ldtable = NULL;
-      gdouble ferr          = GSL_POSINF;
-      gdouble err           = 0.0;
-      gdouble err_err       = 0.0;
-      gdouble df_best       = 0.0;
-      gdouble dfb           = 0.0;
-      gdouble dfr           = 0.0;
-      gdouble roffb         = 0.0;
-      gdouble roffr         = 0.0;        
-      guint t               = 0;
-      guint not_converging  = ntry_conv;
-      guint order_index;
-
-      g_array_set_size (dfs, 0);
-      g_array_set_size (roffs, 0);
-      
-      for (order_index = 0; order_index < diff->priv->maxorder; order_index++)
-      {
-        const guint nt        = order_index + 2;
-        NcmDiffTable *dtable  = g_ptr_array_index (tables, order_index);
-        guint i;
+      guint s;
 
-        for (; t < nt; t++)
-        {
-          const gdouble hxo    = hx0 * ((po == 0) ? ncm_vector_get (dtable->h, t) : sqrt (ncm_vector_get (dtable->h, t)));
-          const gdouble hyo    = hy0 * ((po == 0) ? ncm_vector_get (dtable->h, t) : sqrt (ncm_vector_get (dtable->h, t)));
-          volatile gdouble t_x = x + hxo;
-          const gdouble hx     = t_x - x;
-          volatile gdouble t_y = y + hyo;
-          const gdouble hy     = t_y - y;
-
-          gdouble df_t   = 0.0;
-          gdouble roff_t = 0.0;
+      if (!hs[n].active)
+        continue;
 
-          Hstep_algo (diff, f, user_data, a, x, hx, b, y, hy, x_v, fval, &df_t, &roff_t);
+      for (s = 0; s < nsteps; s++)
+      {
+        const gdouble hxo    = hx0 * ((po == 0) ? ncm_vector_get (dtable->h, t + s) : sqrt (ncm_vector_get (dtable->h, t + s)));
+        const gdouble hyo    = hy0 * ((po == 0) ? ncm_vector_get (dtable->h, t + s) : sqrt (ncm_vector_get (dtable->h, t + s)));
+        volatile gdouble t_x = x + hxo;
+        const gdouble hx     = t_x - x;
+        volatile gdouble t_y = y + hyo;
+        const gdouble hy     = t_y - y;
+
+        ncm_matrix_set (hx_m, n, s, hx);
+        ncm_matrix_set (hy_m, n, s, hy);
+
+        ncm_matrix_set_row (X, k, x_v);
+        ncm_matrix_set (X, k, a, x + hx);
+        k++;
+
+        ncm_matrix_set_row (X, k, x_v);
+        ncm_matrix_set (X, k, b, y + hy);
+        k++;
+
+        ncm_matrix_set_row (X, k, x_v);
+        ncm_matrix_set (X, k, a, x + hx);
+        ncm_matrix_set (X, k, b, y + hy);
+        k++;
+      }
+    }
 
-          g_array_append_val (dfs,   df_t);
-          g_array_append_val (roffs, roff_t);
+    _ncm_diff_eval (diff, ev, X, Y);
 
-          ncm_vector_set (x_v, a, x);
-          ncm_vector_set (x_v, b, y);
-        }
+    k = 0;
+    for (n = 0; n < npairs; n++)
+    {
+      NcmDiffHState *hs_n = &hs[n];
+      guint s, i;
 
-        if (ldtable == NULL)
-        {
-          const gdouble lambda0 = ncm_vector_get (dtable->lambda, 0);
-          const gdouble lambda1 = ncm_vector_get (dtable->lambda, 1);
-          
-          dfb   = g_array_index (dfs, gdouble, 0);
-          dfr   = dfb * lambda0 + g_array_index (dfs, gdouble, 1) * lambda1;
+      if (!hs_n->active)
+        continue;
 
-          roffb = g_array_index (roffs, gdouble, 0);
-          roffr = roffb * lambda0 + g_array_index (roffs, gdouble, 1) * lambda1;
+      for (s = 0; s < nsteps; s++)
+      {
+        const gdouble hx     = ncm_matrix_get (hx_m, n, s);
+        const gdouble hy     = ncm_matrix_get (hy_m, n, s);
+        const gdouble f_hx   = ncm_matrix_get (Y, k + 0, 0);
+        const gdouble f_hy   = ncm_matrix_get (Y, k + 1, 0);
+        const gdouble f_hxhy = ncm_matrix_get (Y, k + 2, 0);
+        const gdouble df_t   = ((fval + f_hxhy) - (f_hx + f_hy)) / (hx * hy);
+        gdouble roff_t;
 
-          df_best = dfb;
-        }
-        else
         {
-          dfr   = 0.0;
-          roffr = 0.0;
+          const gdouble s1 = fval + f_hxhy;
+          const gdouble s2 = f_hx + f_hy;
 
-          for (i = 0; i < nt; i++)
+          const gdouble d1 = s1 - s2;
+
+          if (G_UNLIKELY (d1 == 0.0))
+            roff_t = 1.0;
+          else
           {
-            const gdouble lambda_i = ncm_vector_get (dtable->lambda,  i);
-            const gdouble df_i     = g_array_index (dfs, gdouble, i);
-            const gdouble roff_i   = g_array_index (roffs, gdouble, i);
-            
-            dfr   += lambda_i * df_i;
-            roffr += lambda_i * roff_i;
+            const gdouble abs_s1  = fabs (s1);
+            const gdouble abs_s2  = fabs (s2);
+            const gdouble max_s12 = GSL_MAX (abs_s1, abs_s2);
+            roff_t = fabs (max_s12 * GSL_DBL_EPSILON / d1);
           }
         }
 
-        err     = fabs (dfr - dfb);
-        err_err = (dfr == 0.0) ? ((dfb == 0.0) ? 0.0 : fabs (dfb)) : ((dfb == 0.0) ? fabs (dfr) : fabs ((dfr - dfb) / GSL_MIN (fabs (dfr), fabs (dfb))));
+        g_array_append_val (hs_n->dfs,   df_t);
+        g_array_append_val (hs_n->roffs, roff_t);
 
-        {
-          gboolean improve = FALSE;
+        k += 3;
+      }
 
-          const gdouble Eroffb = fabs (roffb) * diff->priv->roff_pad;
-          const gdouble Eroffr = fabs (roffr) * diff->priv->roff_pad;
-          const gdouble terr   = GSL_MAX (err, GSL_MAX (Eroffb, Eroffr));
-          gdouble cerr         = ferr;
+      if (!hs_n->started)
+      {
+        const gdouble lambda0 = ncm_vector_get (dtable->lambda, 0);
+        const gdouble lambda1 = ncm_vector_get (dtable->lambda, 1);
+        
+        hs_n->dfb   = g_array_index (hs_n->dfs, gdouble, 0);
+        hs_n->dfr   = hs_n->dfb * lambda0 + g_array_index (hs_n->dfs, gdouble, 1) * lambda1;
 
-          if (not_converging && (err_err < 1.0e-3))
-            not_converging--;
-          else 
-          {
-            if (err_err > 1.0e-3)
-            {
-              not_converging = ntry_conv;
-              if (err_err > 1.0)
-                ferr = GSL_POSINF;
-            }
-          }
+        hs_n->roffb = g_array_index (hs_n->roffs, gdouble, 0);
+        hs_n->roffr = hs_n->roffb * lambda0 + g_array_index (hs_n->roffs, gdouble, 1) * lambda1;
+
+        hs_n->df_best = hs_n->dfb;
+      }
+      else
+      {
+        hs_n->dfr   = 0.0;
+        hs_n->roffr = 0.0;
+
+        for (i = 0; i < nt; i++)
+        {
+          const gdouble lambda_i = ncm_vector_get (dtable->lambda,  i);
+          const gdouble df_i     = g_array_index (hs_n->dfs, gdouble, i);
+          const gdouble roff_i   = g_array_index (hs_n->roffs, gdouble, i);
           
-/*          
-          printf ("[%3u, %3u, %3u] !conv %u % 22.15g % 22.15g % 22.15g % 22.15g % 22.15g % 22.15g", 
-                  nt, a, b, not_converging, ferr, err, Eroffb, Eroffr, terr, err_err);
-*/
-          if ((terr < ferr) && !not_converging)
-          {
-            df_best = dfr;
-            ferr    = terr;
-            cerr    = terr;
-            improve = TRUE;
+          hs_n->dfr   += lambda_i * df_i;
+          hs_n->roffr += lambda_i * roff_i;
+        }
+      }
 
-            /*printf (" -UP-");*/
+      {
+        const gdouble dfr     = hs_n->dfr;
+        const gdouble dfb     = hs_n->dfb;
+        const gdouble err     = fabs (dfr - dfb);
+        const gdouble err_err = (dfr == 0.0) ? ((dfb == 0.0) ? 0.0 : fabs (dfb)) : ((dfb == 0.0) ? fabs (dfr) : fabs ((dfr - dfb) / GSL_MIN (fabs (dfr), fabs (dfb))));
+        const gdouble Eroffb  = fabs (hs_n->roffb) * diff->priv->roff_pad;
+        const gdouble Eroffr  = fabs (hs_n->roffr) * diff->priv->roff_pad;
+        const gdouble terr    = GSL_MAX (err, GSL_MAX (Eroffb, Eroffr));
+        gboolean improve      = FALSE;
+        gdouble cerr          = hs_n->ferr;
+
+        if (hs_n->not_converging && (err_err < 1.0e-3))
+          hs_n->not_converging--;
+        else 
+        {
+          if (err_err > 1.0e-3)
+          {
+            hs_n->not_converging = ntry_conv;
+            if (err_err > 1.0)
+              hs_n->ferr = GSL_POSINF;
           }
-/*
-          else
-            printf ("     ");
-*/
-          if (not_converging || (Eroffr < cerr))
-            improve = TRUE;
+        }
+
+        if ((terr < hs_n->ferr) && !hs_n->not_converging)
+        {
+          hs_n->df_best = dfr;
+          hs_n->ferr    = terr;
+          cerr          = terr;
+          improve       = TRUE;
+        }
 
-          /*printf (" improve: %s\n", improve ? "T" : "F");*/
+        if (hs_n->not_converging || (Eroffr < cerr))
+          improve = TRUE;
 
-          if (!improve)
-            break;
+        if (!improve)
+        {
+          hs_n->active = FALSE;
+          nactive--;
+          continue;
         }
-        
-        dfb     = dfr;
-        roffb   = roffr;
-        ldtable = dtable;
       }
+      
+      hs_n->dfb     = hs_n->dfr;
+      hs_n->roffb   = hs_n->roffr;
+      hs_n->started = TRUE;
+    }
+
+    t = nt;
+
+    ncm_matrix_free (X);
+    ncm_matrix_free (Y);
+    ncm_matrix_free (hx_m);
+    ncm_matrix_free (hy_m);
+  }
 
-      ncm_matrix_set (df_m, a, b, df_best);
-      ncm_matrix_set (df_m, b, a, df_best);
+  for (n = 0; n < npairs; n++)
+  {
+    const guint a = hs[n].a;
+    const guint b = hs[n].b;
+
+    ncm_matrix_set (df_m, a, b, hs[n].df_best);
+    ncm_matrix_set (df_m, b, a, hs[n].df_best);
       
-      if (Eerr_m != NULL)
-      {
-        ncm_matrix_set (Eerr_m, a, b, ferr);
-        ncm_matrix_set (Eerr_m, b, a, ferr);
-      }
+    if (Eerr_m != NULL)
+    {
+      ncm_matrix_set (Eerr_m, a, b, hs[n].ferr);
+      ncm_matrix_set (Eerr_m, b, a, hs[n].ferr);
     }
+
+    g_array_unref (hs[n].dfs);
+    g_array_unref (hs[n].roffs);
   }
 
   if (Eerr_m != NULL)
   {
     ncm_matrix_scale (Eerr_m, NCM_DIFF_ERR_PAD);
   }
-  
-  {
-    g_array_unref (dfs);
-    g_array_unref (roffs);
 
-    ncm_vector_clear (&x_v);
+  g_free (hs);
 
-    ncm_matrix_clear (&df_m);
-    ncm_matrix_clear (&Eerr_m);
+  ncm_vector_clear (&x_v);
+  ncm_vector_clear (&f_v);
 
-    return df;
-  }
+  ncm_matrix_clear (&df_m);
+  ncm_matrix_clear (&Eerr_m);
+
+  return df;
+}
+
+static GArray *
+ncm_diff_by_step_algo (NcmDiff *diff, const NcmDiffStep *step, guint po, GArray *x_a, const guint dim, NcmDiffFuncNtoM f, gpointer user_data, GArray **Eerr)
+{
+  NcmDiffEval ev = {f, NULL, user_data, NULL, NULL};
+
+  return _ncm_diff_by_step_algo_eval (diff, step, po, x_a, dim, &ev, Eerr);
 }
 
 /**
@@ -1192,7 +1385,7 @@ ncm_diff_Hessian_by_step_algo (NcmDiff *diff, NcmDiffHessianStepAlgo Hstep_algo,
 GArray *
 ncm_diff_rf_d1_N_to_M (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncNtoM f, gpointer user_data, GArray **Eerr)
 {
-  return ncm_diff_by_step_algo (diff, _ncm_diff_rf_d1_step, 0, x_a, dim, f, user_data, Eerr);
+  return ncm_diff_by_step_algo (diff, &_ncm_diff_rf_d1, 0, x_a, dim, f, user_data, Eerr);
 }
 
 /**
@@ -1213,7 +1406,7 @@ ncm_diff_rf_d1_N_to_M (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncN
 GArray *
 ncm_diff_rc_d1_N_to_M (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncNtoM f, gpointer user_data, GArray **Eerr)
 {
-  return ncm_diff_by_step_algo (diff, _ncm_diff_rc_d1_step, 1, x_a, dim, f, user_data, Eerr);
+  return ncm_diff_by_step_algo (diff, &_ncm_diff_rc_d1, 1, x_a, dim, f, user_data, Eerr);
 }
 
 /**
@@ -1234,7 +1427,7 @@ ncm_diff_rc_d1_N_to_M (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncN
 GArray *
 ncm_diff_rc_d2_N_to_M (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncNtoM f, gpointer user_data, GArray **Eerr)
 {
-  return ncm_diff_by_step_algo (diff, _ncm_diff_rc_d2_step, 1, x_a, dim, f, user_data, Eerr);
+  return ncm_diff_by_step_algo (diff, &_ncm_diff_rc_d2, 1, x_a, dim, f, user_data, Eerr);
 }
 
 typedef struct _NcmDiffFuncParams
@@ -1291,7 +1484,7 @@ ncm_diff_rf_d1_1_to_M (NcmDiff *diff, const gdouble x, const guint dim, NcmDiffF
   g_array_set_size (x_a, 1);
   g_array_index (x_a, gdouble, 0) = x;
   
-  df_a =  ncm_diff_by_step_algo (diff, _ncm_diff_rf_d1_step, 0, x_a, dim, &_ncm_diff_trans_1_to_M, &fp, Eerr);
+  df_a =  ncm_diff_by_step_algo (diff, &_ncm_diff_rf_d1, 0, x_a, dim, &_ncm_diff_trans_1_to_M, &fp, Eerr);
 
   g_array_unref (x_a);
 
@@ -1323,7 +1516,7 @@ ncm_diff_rc_d1_1_to_M (NcmDiff *diff, const gdouble x, const guint dim, NcmDiffF
   g_array_set_size (x_a, 1);
   g_array_index (x_a, gdouble, 0) = x;
 
-  df_a = ncm_diff_by_step_algo (diff, _ncm_diff_rc_d1_step, 1, x_a, dim, &_ncm_diff_trans_1_to_M, &fp, Eerr);
+  df_a = ncm_diff_by_step_algo (diff, &_ncm_diff_rc_d1, 1, x_a, dim, &_ncm_diff_trans_1_to_M, &fp, Eerr);
   g_array_unref (x_a);
 
   return df_a;
@@ -1354,7 +1547,7 @@ ncm_diff_rc_d2_1_to_M (NcmDiff *diff, const gdouble x, const guint dim, NcmDiffF
   g_array_set_size (x_a, 1);
   g_array_index (x_a, gdouble, 0) = x;
   
-  df_a = ncm_diff_by_step_algo (diff, _ncm_diff_rc_d2_step, 1, x_a, dim, &_ncm_diff_trans_1_to_M, &fp, Eerr);
+  df_a = ncm_diff_by_step_algo (diff, &_ncm_diff_rc_d2, 1, x_a, dim, &_ncm_diff_trans_1_to_M, &fp, Eerr);
   g_array_unref (x_a);
 
   return df_a;
@@ -1379,7 +1572,7 @@ ncm_diff_rf_d1_N_to_1 (NcmDiff *diff, GArray *x_a, NcmDiffFuncNto1 f, gpointer u
 {
   NcmDiffFuncParams fp = {NULL, f, NULL, user_data};
   
-  return ncm_diff_by_step_algo (diff, _ncm_diff_rf_d1_step, 0, x_a, 1, &_ncm_diff_trans_N_to_1, &fp, Eerr);
+  return ncm_diff_by_step_algo (diff, &_ncm_diff_rf_d1, 0, x_a, 1, &_ncm_diff_trans_N_to_1, &fp, Eerr);
 }
 
 /**
@@ -1401,7 +1594,7 @@ ncm_diff_rc_d1_N_to_1 (NcmDiff *diff, GArray *x_a, NcmDiffFuncNto1 f, gpointer u
 {
   NcmDiffFuncParams fp = {NULL, f, NULL, user_data};
 
-  return ncm_diff_by_step_algo (diff, _ncm_diff_rc_d1_step, 1, x_a, 1, &_ncm_diff_trans_N_to_1, &fp, Eerr);
+  return ncm_diff_by_step_algo (diff, &_ncm_diff_rc_d1, 1, x_a, 1, &_ncm_diff_trans_N_to_1, &fp, Eerr);
 }
 
 /**
@@ -1423,31 +1616,15 @@ ncm_diff_rc_d2_N_to_1 (NcmDiff *diff, GArray *x_a, NcmDiffFuncNto1 f, gpointer u
 {
   NcmDiffFuncParams fp = {NULL, f, NULL, user_data};
   
-  return ncm_diff_by_step_algo (diff, _ncm_diff_rc_d2_step, 1, x_a, 1, &_ncm_diff_trans_N_to_1, &fp, Eerr);
+  return ncm_diff_by_step_algo (diff, &_ncm_diff_rc_d2, 1, x_a, 1, &_ncm_diff_trans_N_to_1, &fp, Eerr);
 }
 
-/**
- * ncm_diff_rf_Hessian_N_to_1:
- * @diff: a #NcmDiff
- * @x_a: (array) (element-type double) (in): function argument
- * @f: (scope call): function to differentiate
- * @user_data: (nullable): function user data
- * @Eerr: (array) (element-type double) (out) (transfer full): estimated errors
- * 
- * Calculates the Hessian of @f $\partial_i\partial_j f$ using the forward method plus 
- * Richardson extrapolation. The function $f$ is considered as a $f:\mathbb{R}^N \to \mathbb{R}$,
- * where $N = $ length of @x_a.
- * 
- * Returns: (transfer full) (array) (element-type double): The Hessian of @f at @x_a.
- */
-GArray *
-ncm_diff_rf_Hessian_N_to_1 (NcmDiff *diff, GArray *x_a, NcmDiffFuncNto1 f, gpointer user_data, GArray **Eerr)
+static GArray *
+_ncm_diff_Hessian_eval (NcmDiff *diff, GArray *x_a, NcmDiffEval *ev, GArray **Eerr)
 {
-  NcmDiffFuncParams fp = {NULL, f, NULL, user_data};
   GArray *dEerr = NULL;
-
-  GArray *diag = ncm_diff_by_step_algo (diff, _ncm_diff_rc_d2_step, 1, x_a, 1, &_ncm_diff_trans_N_to_1, &fp, &dEerr);
-  GArray *res  = ncm_diff_Hessian_by_step_algo (diff, _ncm_diff_rf_Hessian_step, 0, x_a, f, user_data, Eerr);
+  GArray *diag  = _ncm_diff_by_step_algo_eval (diff, &_ncm_diff_rc_d2, 1, x_a, 1, ev, &dEerr);
+  GArray *res   = _ncm_diff_Hessian_by_step_algo_eval (diff, 0, x_a, ev, Eerr);
 
   guint i;
 
@@ -1468,6 +1645,29 @@ ncm_diff_rf_Hessian_N_to_1 (NcmDiff *diff, GArray *x_a, NcmDiffFuncNto1 f, gpoin
   return res;
 }
 
+/**
+ * ncm_diff_rf_Hessian_N_to_1:
+ * @diff: a #NcmDiff
+ * @x_a: (array) (element-type double) (in): function argument
+ * @f: (scope call): function to differentiate
+ * @user_data: (nullable): function user data
+ * @Eerr: (array) (element-type double) (out) (transfer full): estimated errors
+ * 
+ * Calculates the Hessian of @f $\partial_i\partial_j f$ using the forward method plus 
+ * Richardson extrapolation. The function $f$ is considered as a $f:\mathbb{R}^N \to \mathbb{R}$,
+ * where $N = $ length of @x_a.
+ * 
+ * Returns: (transfer full) (array) (element-type double): The Hessian of @f at @x_a.
+ */
+GArray *
+ncm_diff_rf_Hessian_N_to_1 (NcmDiff *diff, GArray *x_a, NcmDiffFuncNto1 f, gpointer user_data, GArray **Eerr)
+{
+  NcmDiffFuncParams fp = {NULL, f, NULL, user_data};
+  NcmDiffEval ev       = {&_ncm_diff_trans_N_to_1, NULL, &fp, NULL, NULL};
+
+  return _ncm_diff_Hessian_eval (diff, x_a, &ev, Eerr);
+}
+
 /**
  * ncm_diff_rf_d1_1_to_1:
  * @diff: a #NcmDiff
@@ -1493,7 +1693,7 @@ ncm_diff_rf_d1_1_to_1 (NcmDiff *diff, const gdouble x, NcmDiffFunc1to1 f, gpoint
   g_array_set_size (x_a, 1);
   g_array_index (x_a, gdouble, 0) = x;
   
-  df_a = ncm_diff_by_step_algo (diff, _ncm_diff_rf_d1_step, 0, x_a, 1, &_ncm_diff_trans_1_to_1, &fp, &Eerr);
+  df_a = ncm_diff_by_step_algo (diff, &_ncm_diff_rf_d1, 0, x_a, 1, &_ncm_diff_trans_1_to_1, &fp, &Eerr);
 
   df = g_array_index (df_a, gdouble, 0);
 
@@ -1532,7 +1732,7 @@ ncm_diff_rc_d1_1_to_1 (NcmDiff *diff, const gdouble x, NcmDiffFunc1to1 f, gpoint
   g_array_set_size (x_a, 1);
   g_array_index (x_a, gdouble, 0) = x;
   
-  df_a = ncm_diff_by_step_algo (diff, _ncm_diff_rc_d1_step, 1, x_a, 1, &_ncm_diff_trans_1_to_1, &fp, &Eerr);
+  df_a = ncm_diff_by_step_algo (diff, &_ncm_diff_rc_d1, 1, x_a, 1, &_ncm_diff_trans_1_to_1, &fp, &Eerr);
 
   df = g_array_index (df_a, gdouble, 0);
 
@@ -1571,7 +1771,7 @@ ncm_diff_rc_d2_1_to_1 (NcmDiff *diff, const gdouble x, NcmDiffFunc1to1 f, gpoint
   g_array_set_size (x_a, 1);
   g_array_index (x_a, gdouble, 0) = x;
   
-  df_a = ncm_diff_by_step_algo (diff, _ncm_diff_rc_d2_step, 1, x_a, 1, &_ncm_diff_trans_1_to_1, &fp, &Eerr);
+  df_a = ncm_diff_by_step_algo (diff, &_ncm_diff_rc_d2, 1, x_a, 1, &_ncm_diff_trans_1_to_1, &fp, &Eerr);
 
   df = g_array_index (df_a, gdouble, 0);
 
@@ -1584,3 +1784,94 @@ ncm_diff_rc_d2_1_to_1 (NcmDiff *diff, const gdouble x, NcmDiffFunc1to1 f, gpoint
 
   return df;
 }
+
+/**
+ * ncm_diff_rf_d1_N_to_M_batch:
+ * @diff: a #NcmDiff
+ * @x_a: (array) (element-type double) (in): function argument
+ * @dim: dimension of @fb
+ * @fb: (scope call): batched function to differentiate
+ * @user_data: (nullable): function user data
+ * @Eerr: (array) (element-type double) (out) (transfer full): estimated errors
+ * 
+ * Same as ncm_diff_rf_d1_N_to_M() but all stencil points of a given
+ * Richardson step, for all variables still being extrapolated, are passed
+ * to @fb in a single call.
+ * 
+ * Returns: (transfer full) (array) (element-type double): The derivative of @fb at @x_a.
+ */
+GArray *
+ncm_diff_rf_d1_N_to_M_batch (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncNtoMBatch fb, gpointer user_data, GArray **Eerr)
+{
+  NcmDiffEval ev = {NULL, fb, user_data, NULL, NULL};
+
+  return _ncm_diff_by_step_algo_eval (diff, &_ncm_diff_rf_d1, 0, x_a, dim, &ev, Eerr);
+}
+
+/**
+ * ncm_diff_rc_d1_N_to_M_batch:
+ * @diff: a #NcmDiff
+ * @x_a: (array) (element-type double) (in): function argument
+ * @dim: dimension of @fb
+ * @fb: (scope call): batched function to differentiate
+ * @user_data: (nullable): function user data
+ * @Eerr: (array) (element-type double) (out) (transfer full): estimated errors
+ * 
+ * Same as ncm_diff_rc_d1_N_to_M() but all stencil points of a given
+ * Richardson step, for all variables still being extrapolated, are passed
+ * to @fb in a single call.
+ * 
+ * Returns: (transfer full) (array) (element-type double): The derivative of @fb at @x_a.
+ */
+GArray *
+ncm_diff_rc_d1_N_to_M_batch (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncNtoMBatch fb, gpointer user_data, GArray **Eerr)
+{
+  NcmDiffEval ev = {NULL, fb, user_data, NULL, NULL};
+
+  return _ncm_diff_by_step_algo_eval (diff, &_ncm_diff_rc_d1, 1, x_a, dim, &ev, Eerr);
+}
+
+/**
+ * ncm_diff_rc_d2_N_to_M_batch:
+ * @diff: a #NcmDiff
+ * @x_a: (array) (element-type double) (in): function argument
+ * @dim: dimension of @fb
+ * @fb: (scope call): batched function to differentiate
+ * @user_data: (nullable): function user data
+ * @Eerr: (array) (element-type double) (out) (transfer full): estimated errors
+ * 
+ * Same as ncm_diff_rc_d2_N_to_M() but all stencil points of a given
+ * Richardson step, for all variables still being extrapolated, are passed
+ * to @fb in a single call.
+ * 
+ * Returns: (transfer full) (array) (element-type double): The derivative of @fb at @x_a.
+ */
+GArray *
+ncm_diff_rc_d2_N_to_M_batch (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncNtoMBatch fb, gpointer user_data, GArray **Eerr)
+{
+  NcmDiffEval ev = {NULL, fb, user_data, NULL, NULL};
+
+  return _ncm_diff_by_step_algo_eval (diff, &_ncm_diff_rc_d2, 1, x_a, dim, &ev, Eerr);
+}
+
+/**
+ * ncm_diff_rf_Hessian_N_to_1_batch:
+ * @diff: a #NcmDiff
+ * @x_a: (array) (element-type double) (in): function argument
+ * @fb: (scope call): batched function to differentiate
+ * @user_data: (nullable): function user data
+ * @Eerr: (array) (element-type double) (out) (transfer full): estimated errors
+ * 
+ * Same as ncm_diff_rf_Hessian_N_to_1() but the stencil points of each
+ * Richardson step are passed to @fb in a single call. The output matrix
+ * passed to @fb has only one column.
+ * 
+ * Returns: (transfer full) (array) (element-type double): The Hessian of @fb at @x_a.
+ */
+GArray *
+ncm_diff_rf_Hessian_N_to_1_batch (NcmDiff *diff, GArray *x_a, NcmDiffFuncNtoMBatch fb, gpointer user_data, GArray **Eerr)
+{
+  NcmDiffEval ev = {NULL, fb, user_data, NULL, NULL};
+
+  return _ncm_diff_Hessian_eval (diff, x_a, &ev, Eerr);
+}
@@ -73,6 +73,18 @@ typedef void (*NcmDiffFunc1toM) (const gdouble x, NcmVector *y, gpointer user_da
 typedef gdouble (*NcmDiffFuncNto1) (NcmVector *x, gpointer user_data);
 typedef gdouble (*NcmDiffFunc1to1) (const gdouble x, gpointer user_data);
 
+/**
+ * NcmDiffFuncNtoMBatch:
+ * @x: points where to evaluate the function, one per row
+ * @y: function values, one per row
+ * @user_data: (nullable): user data
+ * 
+ * Batched function $f(x)$ call back, it must fill the row $i$ of @y
+ * with $f$ evaluated at the row $i$ of @x.
+ * 
+ */
+typedef void (*NcmDiffFuncNtoMBatch) (NcmMatrix *x, NcmMatrix *y, gpointer user_data);
+
 GType ncm_diff_get_type (void) G_GNUC_CONST;
 
 NcmDiff *ncm_diff_new (void);
@@ -85,11 +97,13 @@ guint ncm_diff_get_max_order (NcmDiff *diff);
 gdouble ncm_diff_get_richardson_step (NcmDiff *diff);
 gdouble ncm_diff_get_round_off_pad (NcmDiff *diff);
 gdouble ncm_diff_get_ini_h (NcmDiff *diff);
+guint ncm_diff_get_nthreads (NcmDiff *diff);
 
 void ncm_diff_set_max_order (NcmDiff *diff, const guint maxorder);
 void ncm_diff_set_richardson_step (NcmDiff *diff, const gdouble rs);
 void ncm_diff_set_round_off_pad (NcmDiff *diff, const gdouble roff_pad);
 void ncm_diff_set_ini_h (NcmDiff *diff, const gdouble ini_h);
+void ncm_diff_set_nthreads (NcmDiff *diff, const guint nthreads);
 
 void ncm_diff_log_central_tables (NcmDiff *diff);
 void ncm_diff_log_forward_tables (NcmDiff *diff);
@@ -113,6 +127,12 @@ gdouble ncm_diff_rf_d1_1_to_1 (NcmDiff *diff, const gdouble x, NcmDiffFunc1to1 f
 gdouble ncm_diff_rc_d1_1_to_1 (NcmDiff *diff, const gdouble x, NcmDiffFunc1to1 f, gpointer user_data, gdouble *err);
 gdouble ncm_diff_rc_d2_1_to_1 (NcmDiff *diff, const gdouble x, NcmDiffFunc1to1 f, gpointer user_data, gdouble *err);
 
+GArray *ncm_diff_rf_d1_N_to_M_batch (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncNtoMBatch fb, gpointer user_data, GArray **Eerr);
+GArray *ncm_diff_rc_d1_N_to_M_batch (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncNtoMBatch fb, gpointer user_data, GArray **Eerr);
+GArray *ncm_diff_rc_d2_N_to_M_batch (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncNtoMBatch fb, gpointer user_data, GArray **Eerr);
+
+GArray *ncm_diff_rf_Hessian_N_to_1_batch (NcmDiff *diff, GArray *x_a, NcmDiffFuncNtoMBatch fb, gpointer user_data, GArray **Eerr);
+
 #define NCM_DIFF_ERR_PAD (1.0e4)
 
 G_END_DECLS
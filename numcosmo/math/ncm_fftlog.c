@@ -104,6 +104,7 @@
 #include "math/ncm_cfg.h"
 #include "math/ncm_util.h"
 #include "math/ncm_spline_cubic_notaknot.h"
+#include "math/ncm_func_eval.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #ifdef NUMCOSMO_HAVE_FFTW3 
@@ -126,6 +127,7 @@ enum
   PROP_N,
   PROP_PAD,
   PROP_NORING,
+  PROP_NTHREADS,
   PROP_NAME,
 };
 
@@ -148,6 +150,7 @@ ncm_fftlog_init (NcmFftlog *fftlog)
   fftlog->noring    = FALSE;
   fftlog->prepared  = FALSE;
   fftlog->evaluated = FALSE;
+  fftlog->nthreads  = 0;
 
   fftlog->lnr_vec = NULL;
   fftlog->Gr_vec  = g_ptr_array_new ();
@@ -164,6 +167,14 @@ ncm_fftlog_init (NcmFftlog *fftlog)
   fftlog->CmYm      = NULL;
   fftlog->p_Fk2Cm   = NULL;
   fftlog->p_CmYm2Gr = NULL;
+
+  fftlog->nbatch      = 0;
+  fftlog->Fk_b        = NULL;
+  fftlog->Cm_b        = NULL;
+  fftlog->Gr_b        = NULL;
+  fftlog->CmYm_b      = NULL;
+  fftlog->p_b_Fk2Cm   = NULL;
+  fftlog->p_b_CmYm2Gr = NULL;
   g_ptr_array_set_free_func (fftlog->Ym, (GDestroyNotify)fftw_free);
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 }
@@ -199,6 +210,9 @@ _ncm_fftlog_set_property (GObject *object, guint prop_id, const GValue *value, G
     case PROP_NORING:
       ncm_fftlog_set_noring (fftlog, g_value_get_boolean (value));
       break;
+    case PROP_NTHREADS:
+      ncm_fftlog_set_nthreads (fftlog, g_value_get_uint (value));
+      break;
     case PROP_NAME:
       g_assert_not_reached ();
       break;
@@ -238,6 +252,9 @@ _ncm_fftlog_get_property (GObject *object, guint prop_id, GValue *value, GParamS
     case PROP_NORING:
       g_value_set_boolean (value, ncm_fftlog_get_noring (fftlog));
       break;
+    case PROP_NTHREADS:
+      g_value_set_uint (value, ncm_fftlog_get_nthreads (fftlog));
+      break;
     case PROP_NAME:
       g_value_set_string (value, NCM_FFTLOG_GET_CLASS (fftlog)->name);
       break;
@@ -248,9 +265,25 @@ _ncm_fftlog_get_property (GObject *object, guint prop_id, GValue *value, GParamS
 }
 
 #ifdef NUMCOSMO_HAVE_FFTW3
+static void
+_ncm_fftlog_free_batch (NcmFftlog *fftlog)
+{
+  g_clear_pointer (&fftlog->Fk_b, fftw_free);
+  g_clear_pointer (&fftlog->Cm_b, fftw_free);
+  g_clear_pointer (&fftlog->Gr_b, fftw_free);
+  g_clear_pointer (&fftlog->CmYm_b, fftw_free);
+
+  g_clear_pointer (&fftlog->p_b_Fk2Cm, fftw_destroy_plan);
+  g_clear_pointer (&fftlog->p_b_CmYm2Gr, fftw_destroy_plan);
+
+  fftlog->nbatch = 0;
+}
+
 static void
 _ncm_fftlog_free_all (NcmFftlog *fftlog)
 {
+  _ncm_fftlog_free_batch (fftlog);
+
   g_clear_pointer (&fftlog->Fk, fftw_free);
   g_clear_pointer (&fftlog->Cm, fftw_free);
   g_clear_pointer (&fftlog->CmYm, fftw_free);
@@ -342,6 +375,13 @@ ncm_fftlog_class_init (NcmFftlogClass *klass)
                                                          "No ringing",
                                                          TRUE,
                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_NTHREADS,
+                                   g_param_spec_uint ("nthreads",
+                                                      NULL,
+                                                      "Number of threads used in batched transforms",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   g_object_class_install_property (object_class,
                                    PROP_NAME,
                                    g_param_spec_string ("name",
@@ -689,15 +729,42 @@ ncm_fftlog_set_length (NcmFftlog *fftlog, gdouble Lk)
   }
 }
 
+/**
+ * ncm_fftlog_set_nthreads:
+ * @fftlog: a #NcmFftlog
+ * @nthreads: number of threads
+ * 
+ * Sets the number of threads used by ncm_fftlog_eval_by_matrix(). When 
+ * @nthreads is smaller than two the whole batch is transformed at once 
+ * using a single FFTW many-transforms plan, otherwise the rows are 
+ * distributed among @nthreads threads.
+ * 
+ */
+void
+ncm_fftlog_set_nthreads (NcmFftlog *fftlog, guint nthreads)
+{
+  fftlog->nthreads = nthreads;
+}
+
+/**
+ * ncm_fftlog_get_nthreads:
+ * @fftlog: a #NcmFftlog
+ * 
+ * Returns: the number of threads used by ncm_fftlog_eval_by_matrix().
+ */
+guint
+ncm_fftlog_get_nthreads (NcmFftlog *fftlog)
+{
+  return fftlog->nthreads;
+}
+
 #ifdef NUMCOSMO_HAVE_FFTW3
 static void
-_ncm_fftlog_eval (NcmFftlog *fftlog)
+_ncm_fftlog_prepare_Ym (NcmFftlog *fftlog)
 {
   guint nd;
   gint i;
 
-  fftw_execute (fftlog->p_Fk2Cm);
-  
   if (!fftlog->prepared)
   {
     const gdouble Lt       = ncm_fftlog_get_full_length (fftlog);
@@ -761,6 +828,17 @@ _ncm_fftlog_eval (NcmFftlog *fftlog)
     
     ncm_vector_set (fftlog->lnr_vec, i, lnr);
   }
+}
+
+static void
+_ncm_fftlog_eval (NcmFftlog *fftlog)
+{
+  guint nd;
+  gint i;
+
+  fftw_execute (fftlog->p_Fk2Cm);
+
+  _ncm_fftlog_prepare_Ym (fftlog);
   
   for (nd = 0; nd <= fftlog->nderivs; nd++)
   {
@@ -899,6 +977,204 @@ ncm_fftlog_eval_by_function (NcmFftlog *fftlog, NcmFftlogFunc Fk, gpointer user_
   ncm_fftlog_eval_by_gsl_function (fftlog, &F);
 }
 
+#ifdef NUMCOSMO_HAVE_FFTW3
+typedef struct _NcmFftlogBatch
+{
+  NcmFftlog *fftlog;
+  NcmMatrix *Fk;
+  GPtrArray *Gr;
+} NcmFftlogBatch;
+
+static void
+_ncm_fftlog_batch_alloc (NcmFftlog *fftlog, const guint nbatch, const gboolean plan_many)
+{
+  const gboolean has_plans = (fftlog->p_b_Fk2Cm != NULL);
+
+  if ((nbatch != fftlog->nbatch) || (plan_many && !has_plans))
+  {
+    const gint Nf = fftlog->Nf;
+    
+    _ncm_fftlog_free_batch (fftlog);
+
+    fftlog->nbatch = nbatch;
+    fftlog->Fk_b   = fftw_alloc_complex (Nf * nbatch);
+    fftlog->Cm_b   = fftw_alloc_complex (Nf * nbatch);
+    fftlog->Gr_b   = fftw_alloc_complex (Nf * nbatch);
+    fftlog->CmYm_b = fftw_alloc_complex (Nf * nbatch);
+
+    if (plan_many)
+    {
+      ncm_cfg_load_fftw_wisdom ("ncm_fftlog_%s", NCM_FFTLOG_GET_CLASS (fftlog)->name);
+      ncm_cfg_lock_plan_fftw ();
+
+      fftlog->p_b_Fk2Cm   = fftw_plan_many_dft (1, &Nf, nbatch, 
+                                                fftlog->Fk_b, NULL, 1, Nf, 
+                                                fftlog->Cm_b, NULL, 1, Nf, 
+                                                FFTW_FORWARD, fftw_default_flags | FFTW_DESTROY_INPUT);
+      fftlog->p_b_CmYm2Gr = fftw_plan_many_dft (1, &Nf, nbatch, 
+                                                fftlog->CmYm_b, NULL, 1, Nf, 
+                                                fftlog->Gr_b, NULL, 1, Nf, 
+                                                FFTW_FORWARD, fftw_default_flags | FFTW_DESTROY_INPUT);
+      
+      ncm_cfg_unlock_plan_fftw ();
+      ncm_cfg_save_fftw_wisdom ("ncm_fftlog_%s", NCM_FFTLOG_GET_CLASS (fftlog)->name);
+    }
+  }
+}
+
+static void
+_ncm_fftlog_batch_load_row (NcmFftlog *fftlog, NcmMatrix *Fk, const guint b)
+{
+  fftw_complex *Fk_b = &fftlog->Fk_b[b * fftlog->Nf];
+  gint i;
+
+  memset (Fk_b, 0, sizeof (complex double) * fftlog->Nf);
+
+  for (i = 0; i < fftlog->N; i++)
+    Fk_b[fftlog->pad + i] = ncm_matrix_get (Fk, b, i);
+}
+
+static void
+_ncm_fftlog_batch_CmYm_row (NcmFftlog *fftlog, const guint b, const guint nd)
+{
+  fftw_complex *Ym_nd  = g_ptr_array_index (fftlog->Ym, nd);
+  fftw_complex *Cm_b   = &fftlog->Cm_b[b * fftlog->Nf];
+  fftw_complex *CmYm_b = &fftlog->CmYm_b[b * fftlog->Nf];
+  gint i;
+  
+  for (i = 0; i < fftlog->Nf; i++)
+    CmYm_b[i] = Cm_b[i] * Ym_nd[i];
+
+  CmYm_b[fftlog->Nf_2]     = creal (CmYm_b[fftlog->Nf_2]);
+  CmYm_b[fftlog->Nf_2 + 1] = creal (CmYm_b[fftlog->Nf_2 + 1]);
+}
+
+static void
+_ncm_fftlog_batch_store_row (NcmFftlog *fftlog, NcmMatrix *Gr_nd, const guint b)
+{
+  const gdouble norma = ncm_fftlog_get_norma (fftlog);
+  fftw_complex *Gr_b  = &fftlog->Gr_b[b * fftlog->Nf];
+  gint i;
+
+  for (i = 0; i < fftlog->N; i++)
+  {
+    const gdouble lnr = ncm_vector_get (fftlog->lnr_vec, i);
+    const gdouble rm1 = exp (-lnr);
+
+    ncm_matrix_set (Gr_nd, b, i, creal (Gr_b[i + fftlog->pad]) * rm1 / norma);
+  }
+}
+
+static void
+_ncm_fftlog_batch_rows (glong i, glong f, gpointer data)
+{
+  NcmFftlogBatch *batch = (NcmFftlogBatch *) data;
+  NcmFftlog *fftlog     = batch->fftlog;
+  glong b;
+
+  for (b = i; b < f; b++)
+  {
+    const glong offset = b * fftlog->Nf;
+    guint nd;
+
+    _ncm_fftlog_batch_load_row (fftlog, batch->Fk, b);
+    fftw_execute_dft (fftlog->p_Fk2Cm, &fftlog->Fk_b[offset], &fftlog->Cm_b[offset]);
+
+    for (nd = 0; nd <= fftlog->nderivs; nd++)
+    {
+      NcmMatrix *Gr_nd = g_ptr_array_index (batch->Gr, nd);
+
+      if (Gr_nd == NULL)
+        continue;
+
+      _ncm_fftlog_batch_CmYm_row (fftlog, b, nd);
+      fftw_execute_dft (fftlog->p_CmYm2Gr, &fftlog->CmYm_b[offset], &fftlog->Gr_b[offset]);
+      _ncm_fftlog_batch_store_row (fftlog, Gr_nd, b);
+    }
+  }
+}
+#endif /* NUMCOSMO_HAVE_FFTW3 */
+
+/**
+ * ncm_fftlog_eval_by_matrix:
+ * @fftlog: a #NcmFftlog
+ * @Fk: a #NcmMatrix
+ * @Gr: (element-type NcmMatrix): a #GPtrArray of #NcmMatrix
+ * 
+ * Computes a batch of transforms at once. Each row of @Fk contains the values
+ * of one function at the knots $\ln k_m$, see ncm_fftlog_get_lnk_vector(). 
+ * The transform of the $b$-th row and its @nd-th derivative with respect 
+ * to $\ln r$ are written in the $b$-th row of the @nd-th matrix in @Gr. 
+ * The array @Gr must contain ncm_fftlog_get_nderivs() + 1 elements, NULL 
+ * elements are skipped. All matrices must have the same number of rows and 
+ * ncm_fftlog_get_size() columns. The $\ln r$ knots can be obtained with
+ * ncm_fftlog_get_vector_lnr() after this call.
+ * 
+ * The kernel $Y_m$ is computed only once for the whole batch. The internal 
+ * single-function outputs (ncm_fftlog_get_vector_Gr(), ncm_fftlog_peek_spline_Gr())
+ * are not modified. See ncm_fftlog_set_nthreads().
+ * 
+ */
+void 
+ncm_fftlog_eval_by_matrix (NcmFftlog *fftlog, NcmMatrix *Fk, GPtrArray *Gr)
+{
+#ifdef NUMCOSMO_HAVE_FFTW3
+  const guint nbatch      = ncm_matrix_nrows (Fk);
+  const gboolean threaded = (fftlog->nthreads > 1) && (nbatch > 1);
+  NcmFftlogBatch batch    = {fftlog, Fk, Gr};
+  guint nd;
+
+  g_assert_cmpuint (ncm_matrix_ncols (Fk), ==, fftlog->N);
+  g_assert_cmpuint (Gr->len, ==, fftlog->nderivs + 1);
+
+  for (nd = 0; nd <= fftlog->nderivs; nd++)
+  {
+    NcmMatrix *Gr_nd = g_ptr_array_index (Gr, nd);
+    if (Gr_nd != NULL)
+    {
+      g_assert_cmpuint (ncm_matrix_nrows (Gr_nd), ==, nbatch);
+      g_assert_cmpuint (ncm_matrix_ncols (Gr_nd), ==, fftlog->N);
+    }
+  }
+
+  if (nbatch == 0)
+    return;
+
+  _ncm_fftlog_batch_alloc (fftlog, nbatch, !threaded);
+  _ncm_fftlog_prepare_Ym (fftlog);
+
+  if (threaded)
+  {
+    ncm_func_eval_threaded_loop_ws_nw (&_ncm_fftlog_batch_rows, 0, nbatch, &batch, fftlog->nthreads, 1);
+  }
+  else
+  {
+    guint b;
+
+    for (b = 0; b < nbatch; b++)
+      _ncm_fftlog_batch_load_row (fftlog, Fk, b);
+
+    fftw_execute (fftlog->p_b_Fk2Cm);
+
+    for (nd = 0; nd <= fftlog->nderivs; nd++)
+    {
+      NcmMatrix *Gr_nd = g_ptr_array_index (Gr, nd);
+
+      if (Gr_nd == NULL)
+        continue;
+
+      for (b = 0; b < nbatch; b++)
+        _ncm_fftlog_batch_CmYm_row (fftlog, b, nd);
+
+      fftw_execute (fftlog->p_b_CmYm2Gr);
+
+      for (b = 0; b < nbatch; b++)
+        _ncm_fftlog_batch_store_row (fftlog, Gr_nd, b);
+    }
+  }
+#endif /* NUMCOSMO_HAVE_FFTW3 */
+}
+
 /**
  * ncm_fftlog_prepare_splines:
  * @fftlog: a #NcmFftlog
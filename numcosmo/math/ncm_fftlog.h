@@ -31,6 +31,7 @@
 #include <numcosmo/build_cfg.h>
 #include <numcosmo/math/ncm_vector.h>
 #include <numcosmo/math/ncm_spline.h>
+#include <numcosmo/math/ncm_matrix.h>
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <gsl/gsl_math.h>
@@ -81,6 +82,7 @@ struct _NcmFftlog
   gboolean noring;
   gboolean prepared;
   gboolean evaluated;
+  guint nthreads;
   NcmVector *lnr_vec;
   GPtrArray *Gr_vec;
   GPtrArray *Gr_s;
@@ -92,6 +94,13 @@ struct _NcmFftlog
   GPtrArray *Ym;
   fftw_plan p_Fk2Cm;
   fftw_plan p_CmYm2Gr;
+  guint nbatch;
+  fftw_complex *Fk_b;
+  fftw_complex *Cm_b;
+  fftw_complex *Gr_b;
+  fftw_complex *CmYm_b;
+  fftw_plan p_b_Fk2Cm;
+  fftw_plan p_b_CmYm2Gr;
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 };
 
@@ -123,10 +132,14 @@ gboolean ncm_fftlog_get_noring (NcmFftlog *fftlog);
 
 void ncm_fftlog_set_length (NcmFftlog *fftlog, gdouble Lk);
 
+void ncm_fftlog_set_nthreads (NcmFftlog *fftlog, guint nthreads);
+guint ncm_fftlog_get_nthreads (NcmFftlog *fftlog);
+
 void ncm_fftlog_get_lnk_vector (NcmFftlog *fftlog, NcmVector *lnk);
 void ncm_fftlog_eval_by_vector (NcmFftlog *fftlog, NcmVector *Fk);
 void ncm_fftlog_eval_by_function (NcmFftlog *fftlog, NcmFftlogFunc Fk, gpointer user_data);
 void ncm_fftlog_eval_by_gsl_function (NcmFftlog *fftlog, gsl_function *Fk);
+void ncm_fftlog_eval_by_matrix (NcmFftlog *fftlog, NcmMatrix *Fk, GPtrArray *Gr);
 
 void ncm_fftlog_prepare_splines (NcmFftlog *fftlog);
 
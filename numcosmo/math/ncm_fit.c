@@ -42,6 +42,7 @@
 #include "math/ncm_util.h"
 #include "math/integral.h"
 #include "math/ncm_memory_pool.h"
+#include "math/ncm_func_eval.h"
 #include "math/ncm_fit_gsl_ls.h"
 #include "math/ncm_fit_gsl_mm.h"
 #include "math/ncm_fit_gsl_mms.h"
@@ -76,6 +77,7 @@ enum
   PROP_INEQC,
   PROP_INEQC_TOT,
   PROP_SUBFIT,
+  PROP_NTHREADS,
   PROP_SIZE,
 };
 
@@ -96,8 +98,10 @@ ncm_fit_init (NcmFit *fit)
   fit->equality_constraints_tot   = g_array_new (FALSE, FALSE, sizeof (gdouble));
   fit->inequality_constraints_tot = g_array_new (FALSE, FALSE, sizeof (gdouble));
 
-  fit->sub_fit = NULL;
-  fit->diff    = ncm_diff_new ();
+  fit->sub_fit  = NULL;
+  fit->diff     = ncm_diff_new ();
+  fit->nthreads = 0;
+  fit->mp_eval  = NULL;
 }
 
 static void
@@ -169,6 +173,9 @@ _ncm_fit_set_property (GObject *object, guint prop_id, const GValue *value, GPar
     case PROP_SUBFIT:
       ncm_fit_set_sub_fit (fit, g_value_get_object (value));
       break;
+    case PROP_NTHREADS:
+      ncm_fit_set_nthreads (fit, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -228,6 +235,9 @@ _ncm_fit_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec
     case PROP_SUBFIT:
       g_value_set_object (value, fit->sub_fit);
       break;
+    case PROP_NTHREADS:
+      g_value_set_uint (value, ncm_fit_get_nthreads (fit));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -295,6 +305,12 @@ ncm_fit_dispose (GObject *object)
 
   ncm_diff_clear (&fit->diff);
 
+  if (fit->mp_eval != NULL)
+  {
+    ncm_memory_pool_free (fit->mp_eval, TRUE);
+    fit->mp_eval = NULL;
+  }
+
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_fit_parent_class)->dispose (object);
 }
@@ -419,6 +435,13 @@ ncm_fit_class_init (NcmFitClass *klass)
                                                         "Subsidiary fit",
                                                         NCM_TYPE_FIT,
                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_NTHREADS,
+                                   g_param_spec_uint ("nthreads",
+                                                      NULL,
+                                                      "Number of threads used in the numerical derivatives",
+                                                      0, G_MAXUINT32, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 static void
@@ -679,6 +702,228 @@ ncm_fit_set_grad_type (NcmFit *fit, NcmFitGradType gtype)
   }
 }
 
+typedef struct _NcmFitWorker
+{
+  NcmLikelihood *lh;
+  NcmMSet *mset;
+} NcmFitWorker;
+
+static gpointer
+_ncm_fit_worker_dup (gpointer userdata)
+{
+  G_LOCK_DEFINE_STATIC (dup_thread);
+  NcmFit *fit      = NCM_FIT (userdata);
+  NcmFitWorker *fw = g_new (NcmFitWorker, 1);
+
+  G_LOCK (dup_thread);
+  {
+    NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+
+    fw->mset = ncm_mset_dup (fit->mset, ser);
+    fw->lh   = ncm_likelihood_dup (fit->lh, ser);
+
+    ncm_serialize_free (ser);
+  }
+  G_UNLOCK (dup_thread);
+
+  return fw;
+}
+
+static void
+_ncm_fit_worker_free (gpointer userdata)
+{
+  NcmFitWorker *fw = (NcmFitWorker *) userdata;
+
+  ncm_likelihood_clear (&fw->lh);
+  ncm_mset_clear (&fw->mset);
+
+  g_free (fw);
+}
+
+static void
+_ncm_fit_worker_profile_gather (gpointer userdata, gpointer fit_ptr)
+{
+  NcmFitWorker *fw = (NcmFitWorker *) userdata;
+  NcmFit *fit      = NCM_FIT (fit_ptr);
+
+  ncm_likelihood_profile_add (fit->lh, fw->lh);
+  ncm_likelihood_profile_reset (fw->lh);
+}
+
+static void
+_ncm_fit_eval_pool_clear (NcmFit *fit)
+{
+  if (fit->mp_eval != NULL)
+  {
+    ncm_memory_pool_free (fit->mp_eval, TRUE);
+    fit->mp_eval = NULL;
+  }
+}
+
+/**
+ * ncm_fit_set_nthreads:
+ * @fit: a #NcmFit
+ * @nthreads: number of simultaneous likelihood evaluations
+ *
+ * Sets the number of threads used to evaluate the displaced points
+ * of the numerical derivatives (forward and central gradients and
+ * least squares Jacobians). When @nthreads is larger than one, each
+ * thread uses its own copy of the #NcmMSet and #NcmLikelihood of
+ * @fit, created through serialization. The copies are discarded
+ * when this function or ncm_fit_reset() is called, the latter must
+ * be used after changing the free parameters of the #NcmMSet. The
+ * same copies are used by ncm_fit_fisher() to compute the Fisher
+ * matrix of each #NcmData of the #NcmDataset in parallel. The
+ * threaded evaluation gives the same results as the serial one; it
+ * is not used when @fit has a subsidiary fit.
+ *
+ */
+void
+ncm_fit_set_nthreads (NcmFit *fit, guint nthreads)
+{
+  fit->nthreads = nthreads;
+  _ncm_fit_eval_pool_clear (fit);
+}
+
+/**
+ * ncm_fit_get_nthreads:
+ * @fit: a #NcmFit
+ *
+ * Returns: the number of threads used in the numerical derivatives.
+ */
+guint
+ncm_fit_get_nthreads (NcmFit *fit)
+{
+  return fit->nthreads;
+}
+
+typedef struct _NcmFitNDEval
+{
+  NcmFit *fit;
+  NcmMatrix *X;
+  NcmMatrix *F;
+  gboolean ls;
+} NcmFitNDEval;
+
+static void
+_ncm_fit_nd_eval_mt (glong i, glong f, gpointer data)
+{
+  NcmFitNDEval *nde     = (NcmFitNDEval *) data;
+  NcmFitWorker **fw_ptr = ncm_memory_pool_get (nde->fit->mp_eval);
+  NcmFitWorker *fw      = fw_ptr[0];
+  glong k;
+
+  for (k = i; k < f; k++)
+  {
+    NcmVector *x_k = ncm_matrix_get_row (nde->X, k);
+
+    g_assert_cmpuint (ncm_mset_fparam_len (fw->mset), ==, ncm_vector_len (x_k));
+
+    ncm_mset_param_set_mset (fw->mset, nde->fit->mset);
+    ncm_mset_fparams_set_vector (fw->mset, x_k);
+
+    if (nde->ls)
+    {
+      NcmVector *f_k = ncm_matrix_get_row (nde->F, k);
+
+      ncm_likelihood_leastsquares_f (fw->lh, fw->mset, f_k);
+      ncm_vector_free (f_k);
+    }
+    else
+      ncm_likelihood_m2lnL_val (fw->lh, fw->mset, ncm_matrix_ptr (nde->F, k, 0));
+
+    ncm_vector_free (x_k);
+  }
+
+  ncm_memory_pool_return (fw_ptr);
+}
+
+static gboolean
+_ncm_fit_nd_use_threads (NcmFit *fit)
+{
+  return (fit->nthreads > 1) && (fit->sub_fit == NULL);
+}
+
+/*
+ * Evaluates m2lnL (or the least squares f when ls is TRUE) at each row
+ * of X, which contains the free parameters, writing the results in the
+ * corresponding rows of F. The other parameters are taken from fit->mset.
+ *
+ */
+static void
+_ncm_fit_nd_eval (NcmFit *fit, NcmMatrix *X, NcmMatrix *F, gboolean ls)
+{
+  NcmFitNDEval nde = {fit, X, F, ls};
+  const guint np   = ncm_matrix_nrows (X);
+
+  g_assert_cmpuint (ncm_matrix_nrows (F), ==, np);
+
+  if (fit->mp_eval == NULL)
+    fit->mp_eval = ncm_memory_pool_new (&_ncm_fit_worker_dup, fit, &_ncm_fit_worker_free);
+
+  ncm_func_eval_threaded_loop_ws_nw (&_ncm_fit_nd_eval_mt, 0, np, &nde, MIN (fit->nthreads, np), 1);
+
+  /* The workers are copies of fit->lh, their profiling is moved back to it. */
+  if (ncm_likelihood_get_profile (fit->lh))
+    ncm_memory_pool_foreach (fit->mp_eval, &_ncm_fit_worker_profile_gather, fit);
+}
+
+typedef struct _NcmFitFisherEval
+{
+  NcmFit *fit;
+  NcmMatrix **IM;
+} NcmFitFisherEval;
+
+static void
+_ncm_fit_fisher_eval_mt (glong i, glong f, gpointer data)
+{
+  NcmFitFisherEval *fe  = (NcmFitFisherEval *) data;
+  NcmFitWorker **fw_ptr = ncm_memory_pool_get (fe->fit->mp_eval);
+  NcmFitWorker *fw      = fw_ptr[0];
+  glong k;
+
+  ncm_mset_param_set_mset (fw->mset, fe->fit->mset);
+
+  for (k = i; k < f; k++)
+    ncm_data_fisher_matrix (ncm_dataset_peek_data (fw->lh->dset, k), fw->mset, &fe->IM[k]);
+
+  ncm_memory_pool_return (fw_ptr);
+}
+
+/*
+ * Same as ncm_dataset_fisher_matrix() but evaluating each NcmData 
+ * in a different worker. The partial matrices are summed in the
+ * dataset order, so the result is identical to the serial one.
+ *
+ */
+static void
+_ncm_fit_fisher_matrix_mt (NcmFit *fit, NcmMatrix **IM)
+{
+  const guint fparams_len = ncm_mset_fparams_len (fit->mset);
+  const guint ndata       = ncm_dataset_get_length (fit->lh->dset);
+  NcmFitFisherEval fe     = {fit, g_new0 (NcmMatrix *, ndata)};
+  guint k;
+
+  if (fit->mp_eval == NULL)
+    fit->mp_eval = ncm_memory_pool_new (&_ncm_fit_worker_dup, fit, &_ncm_fit_worker_free);
+
+  for (k = 0; k < ndata; k++)
+    fe.IM[k] = ncm_matrix_new (fparams_len, fparams_len);
+
+  ncm_func_eval_threaded_loop_ws_nw (&_ncm_fit_fisher_eval_mt, 0, ndata, &fe, MIN (fit->nthreads, ndata), 1);
+
+  *IM = ncm_matrix_new (fparams_len, fparams_len);
+  ncm_matrix_set_zero (*IM);
+
+  for (k = 0; k < ndata; k++)
+  {
+    ncm_matrix_add (*IM, fe.IM[k]);
+    ncm_matrix_free (fe.IM[k]);
+  }
+
+  g_free (fe.IM);
+}
+
 /**
  * ncm_fit_set_maxiter:
  * @fit: a #NcmFit
@@ -1145,6 +1390,7 @@ _ncm_fit_run_empty (NcmFit *fit, NcmFitRunMsgs mtype)
 void
 ncm_fit_reset (NcmFit *fit)
 {
+  _ncm_fit_eval_pool_clear (fit);
   NCM_FIT_GET_CLASS (fit)->reset (fit);
 }
 
@@ -1588,6 +1834,8 @@ ncm_fit_fishermatrix_print (NcmFit *fit, FILE *out, gchar *header)
 
 static gdouble _ncm_fit_numdiff_m2lnL_val (NcmVector *x, gpointer user_data);
 static void _ncm_fit_numdiff_ls_f (NcmVector *x, NcmVector *y, gpointer user_data);
+static void _ncm_fit_numdiff_m2lnL_val_batch (NcmMatrix *X, NcmMatrix *Y, gpointer user_data);
+static void _ncm_fit_numdiff_ls_f_batch (NcmMatrix *X, NcmMatrix *Y, gpointer user_data);
 
 /**
  * ncm_fit_m2lnL_grad_an:
@@ -1634,6 +1882,51 @@ ncm_fit_m2lnL_grad_nd_ce (NcmFit *fit, NcmVector *grad)
   guint i;
   guint fparam_len = ncm_mset_fparam_len (fit->mset);
 
+  if (_ncm_fit_nd_use_threads (fit) && (fparam_len > 0))
+  {
+    NcmMatrix *X        = ncm_matrix_new (2 * fparam_len, fparam_len);
+    NcmMatrix *F        = ncm_matrix_new (2 * fparam_len, 1);
+    NcmVector *one_2h_v = ncm_vector_new (fparam_len);
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble p = ncm_mset_fparam_get (fit->mset, i);
+      const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (fit->mset, i));
+      const gdouble h = p_scale * GSL_ROOT3_DBL_EPSILON;
+      const gdouble pph = p + h;
+      const gdouble pmh = p - h;
+      const gdouble twoh = pph - pmh;
+      NcmVector *x_pph = ncm_matrix_get_row (X, 2 * i);
+      NcmVector *x_pmh = ncm_matrix_get_row (X, 2 * i + 1);
+
+      ncm_mset_fparams_get_vector (fit->mset, x_pph);
+      ncm_vector_memcpy (x_pmh, x_pph);
+      ncm_vector_set (x_pph, i, pph);
+      ncm_vector_set (x_pmh, i, pmh);
+      ncm_vector_set (one_2h_v, i, 1.0 / twoh);
+
+      ncm_vector_free (x_pph);
+      ncm_vector_free (x_pmh);
+    }
+
+    _ncm_fit_nd_eval (fit, X, F, FALSE);
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble m2lnL_pph = ncm_matrix_get (F, 2 * i, 0);
+      const gdouble m2lnL_pmh = ncm_matrix_get (F, 2 * i + 1, 0);
+
+      ncm_vector_set (grad, i, (m2lnL_pph - m2lnL_pmh) * ncm_vector_get (one_2h_v, i));
+    }
+
+    ncm_matrix_free (X);
+    ncm_matrix_free (F);
+    ncm_vector_free (one_2h_v);
+
+    fit->fstate->grad_eval++;
+    return;
+  }
+
   for (i = 0; i < fparam_len; i++)
   {
     const gdouble p = ncm_mset_fparam_get (fit->mset, i);
@@ -1724,7 +2017,10 @@ ncm_fit_m2lnL_grad_nd_ac (NcmFit *fit, NcmVector *grad)
   x = ncm_vector_new_array (x_a);
 
   ncm_mset_fparams_get_vector (fit->mset, x);
-  grad_a = ncm_diff_rf_d1_N_to_1 (fit->diff, x_a, _ncm_fit_numdiff_m2lnL_val, fit, NULL);
+  if (_ncm_fit_nd_use_threads (fit) && (free_params_len > 0))
+    grad_a = ncm_diff_rf_d1_N_to_M_batch (fit->diff, x_a, 1, _ncm_fit_numdiff_m2lnL_val_batch, fit, NULL);
+  else
+    grad_a = ncm_diff_rf_d1_N_to_1 (fit->diff, x_a, _ncm_fit_numdiff_m2lnL_val, fit, NULL);
 
   ncm_vector_set_array (grad, grad_a);
   ncm_mset_fparams_set_vector (fit->mset, x);
@@ -1778,6 +2074,42 @@ ncm_fit_m2lnL_val_grad_nd_fo (NcmFit *fit, gdouble *m2lnL, NcmVector *grad)
 
   ncm_fit_m2lnL_val (fit, m2lnL);
 
+  if (_ncm_fit_nd_use_threads (fit) && (fparam_len > 0))
+  {
+    NcmMatrix *X       = ncm_matrix_new (fparam_len, fparam_len);
+    NcmMatrix *F       = ncm_matrix_new (fparam_len, 1);
+    NcmVector *one_h_v = ncm_vector_new (fparam_len);
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble p = ncm_mset_fparam_get (fit->mset, i);
+      const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (fit->mset, i));
+      const gdouble htilde = GSL_SQRT_DBL_EPSILON * p_scale;
+      const gdouble pph = p + htilde;
+      const gdouble h = pph - p;
+      NcmVector *x_pph = ncm_matrix_get_row (X, i);
+
+      ncm_mset_fparams_get_vector (fit->mset, x_pph);
+      ncm_vector_set (x_pph, i, pph);
+      ncm_vector_set (one_h_v, i, 1.0 / h);
+
+      ncm_vector_free (x_pph);
+    }
+
+    _ncm_fit_nd_eval (fit, X, F, FALSE);
+
+    for (i = 0; i < fparam_len; i++)
+      ncm_vector_set (grad, i, (ncm_matrix_get (F, i, 0) - *m2lnL) * ncm_vector_get (one_h_v, i));
+
+    ncm_matrix_free (X);
+    ncm_matrix_free (F);
+    ncm_vector_free (one_h_v);
+
+    fit->fstate->func_eval += fparam_len + 1;
+    fit->fstate->grad_eval++;
+    return;
+  }
+
   for (i = 0; i < fparam_len; i++)
   {
     const gdouble p = ncm_mset_fparam_get (fit->mset, i);
@@ -1866,6 +2198,48 @@ ncm_fit_ls_J_nd_fo (NcmFit *fit, NcmMatrix *J)
 
   ncm_fit_ls_f (fit, fit->fstate->ls_f);
 
+  if (_ncm_fit_nd_use_threads (fit) && (fparam_len > 0))
+  {
+    const guint data_len = ncm_vector_len (fit->fstate->ls_f);
+    NcmMatrix *X         = ncm_matrix_new (fparam_len, fparam_len);
+    NcmMatrix *F         = ncm_matrix_new (fparam_len, data_len);
+    NcmVector *one_h_v   = ncm_vector_new (fparam_len);
+    guint k;
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble p = ncm_mset_fparam_get (fit->mset, i);
+      const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (fit->mset, i));
+      const gdouble htilde = p_scale * GSL_SQRT_DBL_EPSILON;
+      const gdouble pph = p + htilde;
+      const gdouble h = pph - p;
+      NcmVector *x_pph = ncm_matrix_get_row (X, i);
+
+      ncm_mset_fparams_get_vector (fit->mset, x_pph);
+      ncm_vector_set (x_pph, i, pph);
+      ncm_vector_set (one_h_v, i, 1.0 / h);
+
+      ncm_vector_free (x_pph);
+    }
+
+    _ncm_fit_nd_eval (fit, X, F, TRUE);
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble one_h = ncm_vector_get (one_h_v, i);
+      for (k = 0; k < data_len; k++)
+        ncm_matrix_set (J, k, i, (ncm_matrix_get (F, i, k) - ncm_vector_get (fit->fstate->ls_f, k)) * one_h);
+    }
+
+    ncm_matrix_free (X);
+    ncm_matrix_free (F);
+    ncm_vector_free (one_h_v);
+
+    fit->fstate->func_eval += fparam_len;
+    fit->fstate->grad_eval++;
+    return;
+  }
+
   for (i = 0; i < fparam_len; i++)
   {
     NcmVector *J_col_i = ncm_matrix_get_col (J, i);
@@ -1903,6 +2277,60 @@ ncm_fit_ls_J_nd_ce (NcmFit *fit, NcmMatrix *J)
   guint fparam_len = ncm_mset_fparam_len (fit->mset);
   guint i;
 
+  if (_ncm_fit_nd_use_threads (fit) && (fparam_len > 0))
+  {
+    const guint data_len = ncm_vector_len (fit->fstate->ls_f);
+    NcmMatrix *X         = ncm_matrix_new (2 * fparam_len, fparam_len);
+    NcmMatrix *F         = ncm_matrix_new (2 * fparam_len, data_len);
+    NcmVector *one_2h_v  = ncm_vector_new (fparam_len);
+    guint k;
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble p = ncm_mset_fparam_get (fit->mset, i);
+      const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (fit->mset, i));
+      const gdouble h = p_scale * GSL_ROOT3_DBL_EPSILON;
+      const gdouble pph = p + h;
+      const gdouble pmh = p - h;
+      const gdouble twoh = pph - pmh;
+      NcmVector *x_pph = ncm_matrix_get_row (X, 2 * i);
+      NcmVector *x_pmh = ncm_matrix_get_row (X, 2 * i + 1);
+
+      ncm_mset_fparams_get_vector (fit->mset, x_pph);
+      ncm_vector_memcpy (x_pmh, x_pph);
+      ncm_vector_set (x_pph, i, pph);
+      ncm_vector_set (x_pmh, i, pmh);
+      ncm_vector_set (one_2h_v, i, 1.0 / twoh);
+
+      ncm_vector_free (x_pph);
+      ncm_vector_free (x_pmh);
+    }
+
+    _ncm_fit_nd_eval (fit, X, F, TRUE);
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble one_2h = ncm_vector_get (one_2h_v, i);
+      for (k = 0; k < data_len; k++)
+        ncm_matrix_set (J, k, i, (ncm_matrix_get (F, 2 * i, k) - ncm_matrix_get (F, 2 * i + 1, k)) * one_2h);
+    }
+
+    /* The serial path leaves the last evaluation in ls_f */
+    {
+      NcmVector *f_last = ncm_matrix_get_row (F, 2 * fparam_len - 1);
+      ncm_vector_memcpy (fit->fstate->ls_f, f_last);
+      ncm_vector_free (f_last);
+    }
+
+    ncm_matrix_free (X);
+    ncm_matrix_free (F);
+    ncm_vector_free (one_2h_v);
+
+    fit->fstate->func_eval += 2 * fparam_len;
+    fit->fstate->grad_eval++;
+    return;
+  }
+
   for (i = 0; i < fparam_len; i++)
   {
     NcmVector *J_col_i = ncm_matrix_get_col (J, i);
@@ -1953,7 +2381,10 @@ ncm_fit_ls_J_nd_ac (NcmFit *fit, NcmMatrix *J)
   x = ncm_vector_new_array (x_a);
 
   ncm_mset_fparams_get_vector (fit->mset, x);
-  J_a = ncm_diff_rf_d1_N_to_M (fit->diff, x_a, data_len, _ncm_fit_numdiff_ls_f, fit, NULL);
+  if (_ncm_fit_nd_use_threads (fit) && (fparam_len > 0))
+    J_a = ncm_diff_rf_d1_N_to_M_batch (fit->diff, x_a, data_len, _ncm_fit_numdiff_ls_f_batch, fit, NULL);
+  else
+    J_a = ncm_diff_rf_d1_N_to_M (fit->diff, x_a, data_len, _ncm_fit_numdiff_ls_f, fit, NULL);
 
   ncm_matrix_set_from_array (J, J_a);
   ncm_mset_fparams_set_vector (fit->mset, x);
@@ -2059,6 +2490,23 @@ _ncm_fit_numdiff_ls_f (NcmVector *x, NcmVector *y, gpointer user_data)
   ncm_fit_ls_f (fit, y);
 }
 
+static void
+_ncm_fit_numdiff_m2lnL_val_batch (NcmMatrix *X, NcmMatrix *Y, gpointer user_data)
+{
+  NcmFit *fit = NCM_FIT (user_data);
+
+  _ncm_fit_nd_eval (fit, X, Y, FALSE);
+}
+
+static void
+_ncm_fit_numdiff_ls_f_batch (NcmMatrix *X, NcmMatrix *Y, gpointer user_data)
+{
+  NcmFit *fit = NCM_FIT (user_data);
+
+  _ncm_fit_nd_eval (fit, X, Y, TRUE);
+  fit->fstate->func_eval += ncm_matrix_nrows (X);
+}
+
 /**
  * ncm_fit_numdiff_m2lnL_hessian:
  * @fit: a #NcmFit
@@ -2080,7 +2528,10 @@ ncm_fit_numdiff_m2lnL_hessian (NcmFit *fit, NcmMatrix *H, gdouble reltol)
   x = ncm_vector_new_array (x_a);
 
   ncm_mset_fparams_get_vector (fit->mset, x);
-  H_a = ncm_diff_rf_Hessian_N_to_1 (fit->diff, x_a, _ncm_fit_numdiff_m2lnL_val, fit, NULL);
+  if (_ncm_fit_nd_use_threads (fit) && (free_params_len > 0))
+    H_a = ncm_diff_rf_Hessian_N_to_1_batch (fit->diff, x_a, _ncm_fit_numdiff_m2lnL_val_batch, fit, NULL);
+  else
+    H_a = ncm_diff_rf_Hessian_N_to_1 (fit->diff, x_a, _ncm_fit_numdiff_m2lnL_val, fit, NULL);
 
   ncm_matrix_set_from_array (H, H_a);
   ncm_mset_fparams_set_vector (fit->mset, x);
@@ -2162,7 +2613,9 @@ ncm_fit_obs_fisher (NcmFit *fit)
  * @fit: a #NcmFit
  *
  * Calculates the covariance from the Fisher matrix, see 
- * ncm_dataset_fisher_matrix().
+ * ncm_dataset_fisher_matrix(). When more than one thread is set
+ * (see ncm_fit_set_nthreads()) the Fisher matrices of the #NcmData
+ * are computed in parallel.
  * 
  */
 void
@@ -2172,7 +2625,10 @@ ncm_fit_fisher (NcmFit *fit)
   if ((ncm_likelihood_priors_length_f (fit->lh) > 0) || (ncm_likelihood_priors_length_m2lnL (fit->lh) > 0))
     g_warning ("ncm_fit_fisher: the analysis contains priors which are ignored in the Fisher matrix calculation.");
 
-  ncm_dataset_fisher_matrix (fit->lh->dset, fit->mset, &IM);
+  if (_ncm_fit_nd_use_threads (fit) && (ncm_dataset_get_length (fit->lh->dset) > 1))
+    _ncm_fit_fisher_matrix_mt (fit, &IM);
+  else
+    ncm_dataset_fisher_matrix (fit->lh->dset, fit->mset, &IM);
   ncm_fit_fisher_to_covar (fit, IM);
 
   ncm_matrix_clear (&IM);
@@ -37,6 +37,7 @@
 #include <numcosmo/math/ncm_mset_func.h>
 #include <numcosmo/math/ncm_likelihood.h>
 #include <numcosmo/math/ncm_fit_state.h>
+#include <numcosmo/math/ncm_memory_pool.h>
 
 #ifndef NUMCOSMO_GIR_SCAN
 #ifdef HAVE_NLOPT_2_2
@@ -162,6 +163,8 @@ struct _NcmFit
 	GArray *inequality_constraints_tot;
   NcmFit *sub_fit;
   NcmDiff *diff;
+  guint nthreads;
+  NcmMemoryPool *mp_eval;
 };
 
 GType ncm_fit_get_type (void) G_GNUC_CONST;
@@ -178,6 +181,9 @@ NcmFit *ncm_fit_get_sub_fit (NcmFit *fit);
 
 void ncm_fit_set_grad_type (NcmFit *fit, NcmFitGradType gtype);
 
+void ncm_fit_set_nthreads (NcmFit *fit, guint nthreads);
+guint ncm_fit_get_nthreads (NcmFit *fit);
+
 void ncm_fit_set_maxiter (NcmFit *fit, guint maxiter);
 void ncm_fit_set_m2lnL_reltol (NcmFit *fit, gdouble tol);
 void ncm_fit_set_m2lnL_abstol (NcmFit *fit, gdouble tol);
@@ -49,6 +49,7 @@
 #ifndef NUMCOSMO_GIR_SCAN
 #include <gsl/gsl_statistics_double.h>
 #include <gsl/gsl_fit.h>
+#include <gsl/gsl_randist.h>
 #endif /* NUMCOSMO_GIR_SCAN */
 
 struct _NcmFitESMCMCPrivate
@@ -77,6 +78,11 @@ struct _NcmFitESMCMCPrivate
   GPtrArray *thetastar_in;
   GPtrArray *thetastar_out;
   NcmVector *jumps;
+  GArray *fast_fparams;
+  guint fast_steps;
+  NcmVector *fast_sd;
+  NcmMatrix *fast_rnd;
+  GPtrArray *walker_fits;
   GArray *accepted;
   GArray *offboard;
   NcmObjArray *func_oa;
@@ -121,12 +127,14 @@ enum
   PROP_USE_MPI,
   PROP_DATA_FILE,
   PROP_FUNC_ARRAY,
+  PROP_FAST_STEPS,
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (NcmFitESMCMC, ncm_fit_esmcmc, G_TYPE_OBJECT);
 
 static gpointer _ncm_fit_esmcmc_worker_dup (gpointer userdata);
 static void _ncm_fit_esmcmc_worker_free (gpointer p);
+static void _ncm_fit_esmcmc_walker_fits_clear (NcmFitESMCMC *esmcmc);
 
 static void
 ncm_fit_esmcmc_init (NcmFitESMCMC *esmcmc)
@@ -173,6 +181,11 @@ ncm_fit_esmcmc_init (NcmFitESMCMC *esmcmc)
   g_ptr_array_set_free_func (self->full_thetastar_inout, (GDestroyNotify) &ncm_vector_free);
 
   self->jumps           = NULL;
+  self->fast_fparams    = g_array_new (FALSE, FALSE, sizeof (guint));
+  self->fast_steps      = 0;
+  self->fast_sd         = NULL;
+  self->fast_rnd        = NULL;
+  self->walker_fits     = g_ptr_array_new ();
   self->accepted        = g_array_new (TRUE, TRUE, sizeof (gboolean));
   self->offboard        = g_array_new (TRUE, TRUE, sizeof (gboolean));
 
@@ -344,6 +357,9 @@ _ncm_fit_esmcmc_set_property (GObject *object, guint prop_id, const GValue *valu
     case PROP_DATA_FILE:
       ncm_fit_esmcmc_set_data_file (esmcmc, g_value_get_string (value));
       break;
+    case PROP_FAST_STEPS:
+      ncm_fit_esmcmc_set_fast_steps (esmcmc, g_value_get_uint (value));
+      break;
     case PROP_FUNC_ARRAY:
     {
 			ncm_obj_array_clear (&self->func_oa);
@@ -421,6 +437,9 @@ _ncm_fit_esmcmc_get_property (GObject *object, guint prop_id, GValue *value, GPa
     case PROP_FUNC_ARRAY:
       g_value_set_boxed (value, self->func_oa);
       break;
+    case PROP_FAST_STEPS:
+      g_value_set_uint (value, self->fast_steps);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -444,6 +463,8 @@ _ncm_fit_esmcmc_dispose (GObject *object)
   ncm_fit_esmcmc_walker_clear (&self->walker);
 
   ncm_vector_clear (&self->jumps);
+  ncm_vector_clear (&self->fast_sd);
+  ncm_matrix_clear (&self->fast_rnd);
 
   ncm_obj_array_clear (&self->func_oa);
 
@@ -459,6 +480,12 @@ _ncm_fit_esmcmc_dispose (GObject *object)
   g_clear_pointer (&self->full_thetastar, g_ptr_array_unref);
   g_clear_pointer (&self->full_thetastar_inout, g_ptr_array_unref);
 
+  g_clear_pointer (&self->fast_fparams, g_array_unref);
+  if (self->walker_fits != NULL)
+  {
+    _ncm_fit_esmcmc_walker_fits_clear (esmcmc);
+    g_clear_pointer (&self->walker_fits, g_ptr_array_unref);
+  }
   g_clear_pointer (&self->accepted, g_array_unref);
   g_clear_pointer (&self->offboard, g_array_unref);
 
@@ -605,6 +632,13 @@ ncm_fit_esmcmc_class_init (NcmFitESMCMCClass *klass)
                                                        "Functions array",
                                                        NCM_TYPE_OBJ_ARRAY,
                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_FAST_STEPS,
+                                   g_param_spec_uint ("fast-steps",
+                                                      NULL,
+                                                      "Number of fast parameters sub-steps per walker step",
+                                                      0, G_MAXUINT32, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 typedef struct _NcmFitESMCMCWorker
@@ -616,27 +650,28 @@ typedef struct _NcmFitESMCMCWorker
 static gpointer
 _ncm_fit_esmcmc_worker_dup (gpointer userdata)
 {
-  G_LOCK_DEFINE_STATIC (dup_thread);
   NcmFitESMCMC *esmcmc = NCM_FIT_ESMCMC (userdata);
 	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  NcmFitESMCMCWorker *fw = g_new (NcmFitESMCMCWorker, 1);
 
-  G_LOCK (dup_thread);
-  {
-    NcmFitESMCMCWorker *fw = g_new (NcmFitESMCMCWorker, 1);
+  /* 
+   * Only the shared serializer must be protected, the duplication itself
+   * is done directly through ncm_serialize_dup_obj().
+   */
+  g_mutex_lock (&self->dup_fit);
 
-    fw->fit = ncm_fit_dup (self->fit, self->ser);
-		
-    if (self->func_oa != NULL)
-      fw->funcs_array = ncm_obj_array_dup (self->func_oa, self->ser);    
-    else
-      fw->funcs_array = NULL;
+  fw->fit = ncm_fit_dup (self->fit, self->ser);
 
-    ncm_serialize_reset (self->ser, TRUE);
-    
-    G_UNLOCK (dup_thread);
+  if (self->func_oa != NULL)
+    fw->funcs_array = ncm_obj_array_dup (self->func_oa, self->ser);    
+  else
+    fw->funcs_array = NULL;
 
-    return fw;
-  }
+  ncm_serialize_reset (self->ser, TRUE);
+
+  g_mutex_unlock (&self->dup_fit);
+
+  return fw;
 }
 
 static void
@@ -650,6 +685,42 @@ _ncm_fit_esmcmc_worker_free (gpointer userdata)
   g_free (fw);
 }
 
+static void
+_ncm_fit_esmcmc_worker_profile_gather (gpointer userdata, gpointer lh_ptr)
+{
+  NcmFitESMCMCWorker *fw = (NcmFitESMCMCWorker *) userdata;
+  NcmLikelihood *lh      = NCM_LIKELIHOOD (lh_ptr);
+
+  ncm_likelihood_profile_add (lh, fw->fit->lh);
+  ncm_likelihood_profile_reset (fw->fit->lh);
+}
+
+static void
+_ncm_fit_esmcmc_walker_fits_clear (NcmFitESMCMC *esmcmc)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  guint k;
+
+  for (k = 0; k < self->walker_fits->len; k++)
+  {
+    NcmFit *fit_w = g_ptr_array_index (self->walker_fits, k);
+
+    if (fit_w != NULL)
+    {
+      /* The walker copies are also profiled, their profiling is moved back to the likelihood. */
+      if ((self->fit != NULL) && ncm_likelihood_get_profile (self->fit->lh))
+      {
+        ncm_likelihood_profile_add (self->fit->lh, fit_w->lh);
+        ncm_likelihood_profile_reset (fit_w->lh);
+      }
+
+      ncm_fit_free (fit_w);
+    }
+  }
+
+  g_ptr_array_set_size (self->walker_fits, 0);
+}
+
 static void 
 _ncm_fit_esmcmc_set_fit_obj (NcmFitESMCMC *esmcmc, NcmFit *fit)
 {
@@ -965,6 +1036,190 @@ ncm_fit_esmcmc_set_max_runs_time (NcmFitESMCMC *esmcmc, gdouble max_runs_time)
   self->max_runs_time = max_runs_time;
 }
 
+/**
+ * ncm_fit_esmcmc_set_fast_steps:
+ * @esmcmc: a #NcmFitESMCMC
+ * @fast_steps: number of sub-steps
+ * 
+ * Sets the number of Metropolis sub-steps performed on the fast parameters
+ * (see ncm_fit_esmcmc_add_fast_fparam()) after each ensemble step of a walker.
+ * Setting @fast_steps to zero disables the fast/slow blocking.
+ * 
+ * Each sub-step proposes a Gaussian displacement of the fast parameters only,
+ * with per-parameter widths computed from the complementary half of the ensemble,
+ * which is kept fixed while the current half is updated. The proposal is therefore
+ * symmetric and the sub-steps satisfy detailed balance. Only the parameters whose
+ * values actually change are set in the #NcmMSet, so models that depend only on
+ * slow parameters keep their #NcmModelCtrl state and are not recomputed.
+ * 
+ * Each walker keeps its own copy of the #NcmFit, holding the likelihood at the
+ * walker's current point. The ensemble proposal is evaluated in a scratch copy
+ * which is swapped with the walker's one when the proposal is accepted, hence a
+ * rejected proposal does not require the expensive part to be recomputed at
+ * the previous point. Each walker step then costs a single expensive evaluation,
+ * the same as a step without blocking, plus @fast_steps cheap evaluations.
+ * The price is one copy of the likelihood per walker, which are kept only
+ * during a run.
+ * 
+ * The sub-steps are performed only by the serial and threaded evaluators, they
+ * are ignored when the walkers are evaluated through MPI.
+ *
+ */
+void 
+ncm_fit_esmcmc_set_fast_steps (NcmFitESMCMC *esmcmc, guint fast_steps)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  self->fast_steps = fast_steps;
+}
+
+/**
+ * ncm_fit_esmcmc_get_fast_steps:
+ * @esmcmc: a #NcmFitESMCMC
+ * 
+ * Returns: the number of fast parameters sub-steps per walker step.
+ */
+guint 
+ncm_fit_esmcmc_get_fast_steps (NcmFitESMCMC *esmcmc)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  return self->fast_steps;
+}
+
+/**
+ * ncm_fit_esmcmc_add_fast_fparam:
+ * @esmcmc: a #NcmFitESMCMC
+ * @fpi: free parameter index
+ * 
+ * Marks the free parameter @fpi as fast, i.e., a parameter whose change
+ * is cheap to evaluate compared to the remaining ones, e.g., nuisance
+ * parameters of the data. Adding an already marked parameter does nothing.
+ *
+ */
+void 
+ncm_fit_esmcmc_add_fast_fparam (NcmFitESMCMC *esmcmc, guint fpi)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  guint j;
+
+  g_assert_cmpuint (fpi, <, self->fparam_len);
+
+  for (j = 0; j < self->fast_fparams->len; j++)
+  {
+    if (g_array_index (self->fast_fparams, guint, j) == fpi)
+      return;
+  }
+
+  g_array_append_val (self->fast_fparams, fpi);
+}
+
+/**
+ * ncm_fit_esmcmc_clear_fast_fparams:
+ * @esmcmc: a #NcmFitESMCMC
+ * 
+ * Unmarks all fast parameters.
+ *
+ */
+void 
+ncm_fit_esmcmc_clear_fast_fparams (NcmFitESMCMC *esmcmc)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  g_array_set_size (self->fast_fparams, 0);
+}
+
+/**
+ * ncm_fit_esmcmc_fast_fparams_len:
+ * @esmcmc: a #NcmFitESMCMC
+ * 
+ * Returns: the number of free parameters marked as fast.
+ */
+guint 
+ncm_fit_esmcmc_fast_fparams_len (NcmFitESMCMC *esmcmc)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  return self->fast_fparams->len;
+}
+
+/**
+ * ncm_fit_esmcmc_detect_fast_fparams:
+ * @esmcmc: a #NcmFitESMCMC
+ * @cost_ratio: maximum relative cost of a fast parameter
+ * 
+ * Measures the cost of the likelihood evaluation when a single free
+ * parameter changes and compares it to the cost when all of them change.
+ * Every parameter whose cost is smaller than @cost_ratio times the full
+ * cost is marked as fast, the previous marks are discarded. The savings
+ * come from the #NcmModelCtrl change tracking of the models and data,
+ * thus a parameter is found to be fast only when the expensive parts of
+ * the calculation ignore its changes.
+ * 
+ * The measurement is done around the current values of the #NcmMSet
+ * of the #NcmFit, which are restored at the end.
+ * 
+ * Returns: the number of parameters marked as fast.
+ */
+guint 
+ncm_fit_esmcmc_detect_fast_fparams (NcmFitESMCMC *esmcmc, const gdouble cost_ratio)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  NcmMSet *mset      = self->fit->mset;
+  NcmVector *theta0  = ncm_vector_new (self->fparam_len);
+  NcmVector *theta1  = ncm_vector_new (self->fparam_len);
+  GTimer *timer      = g_timer_new ();
+  const guint nreps  = 4;
+  gdouble t_full     = GSL_POSINF;
+  gdouble m2lnL;
+  guint i, r;
+
+  g_assert_cmpfloat (cost_ratio, >, 0.0);
+  g_assert_cmpfloat (cost_ratio, <, 1.0);
+
+  ncm_fit_esmcmc_clear_fast_fparams (esmcmc);
+  ncm_mset_fparams_get_vector (mset, theta0);
+
+  for (i = 0; i < self->fparam_len; i++)
+  {
+    const gdouble x_i  = ncm_vector_get (theta0, i);
+    const gdouble dx_i = 1.0e-3 * ncm_mset_fparam_get_scale (mset, i);
+    const gdouble ub_i = ncm_mset_fparam_get_upper_bound (mset, i);
+
+    ncm_vector_set (theta1, i, (x_i + dx_i <= ub_i) ? x_i + dx_i : x_i - dx_i);
+  }
+
+  /* 
+   * Alternates between the two points, nreps is even so that
+   * every loop ends at the original values.
+   */
+  for (r = 0; r < nreps; r++)
+  {
+    g_timer_start (timer);
+    ncm_mset_fparams_set_vector (mset, (r % 2 == 0) ? theta1 : theta0);
+    ncm_fit_m2lnL_val (self->fit, &m2lnL);
+    t_full = GSL_MIN (t_full, g_timer_elapsed (timer, NULL));
+  }
+
+  for (i = 0; i < self->fparam_len; i++)
+  {
+    gdouble t_i = GSL_POSINF;
+
+    for (r = 0; r < nreps; r++)
+    {
+      g_timer_start (timer);
+      ncm_mset_fparam_set (mset, i, ncm_vector_get ((r % 2 == 0) ? theta1 : theta0, i));
+      ncm_fit_m2lnL_val (self->fit, &m2lnL);
+      t_i = GSL_MIN (t_i, g_timer_elapsed (timer, NULL));
+    }
+
+    if (t_i < cost_ratio * t_full)
+      g_array_append_val (self->fast_fparams, i);
+  }
+
+  g_timer_destroy (timer);
+  ncm_vector_free (theta0);
+  ncm_vector_free (theta1);
+
+  return self->fast_fparams->len;
+}
+
 /**
  * ncm_fit_esmcmc_has_rng:
  * @esmcmc: a #NcmFitESMCMC
@@ -1189,7 +1444,7 @@ _ncm_fit_esmcmc_gen_init_points_mpi (NcmFitESMCMC *esmcmc, const glong i, const
 		g_ptr_array_add (thetastar_out_a, thetastar_out_k);
 	}
 
-	ncm_mpi_job_run_array (self->mj, thetastar_in_a, thetastar_out_a);
+	ncm_mpi_job_run_array_async (self->mj, thetastar_in_a, thetastar_out_a, NULL, NULL);
 
 	k = i;
   for (j = 0; j < thetastar_out_a->len; j++)
@@ -1312,6 +1567,9 @@ ncm_fit_esmcmc_start_run (NcmFitESMCMC *esmcmc)
   if (self->started)
     g_error ("ncm_fit_esmcmc_start_run: run already started, run ncm_fit_esmcmc_end_run() first.");
 
+  if (use_mpi && (self->fast_steps > 0) && (self->fast_fparams->len > 0))
+    g_warning ("ncm_fit_esmcmc_start_run: fast parameters sub-steps are not supported when using MPI, ignoring.");
+
   switch (self->mtype)
   {
     default:
@@ -1353,6 +1611,10 @@ ncm_fit_esmcmc_start_run (NcmFitESMCMC *esmcmc)
     ncm_rng_free (rng);
   }
 
+  /* One likelihood copy per walker, created on demand, see ncm_fit_esmcmc_set_fast_steps(). */
+  if ((self->fast_steps > 0) && (self->fast_fparams->len > 0) && !use_mpi)
+    g_ptr_array_set_size (self->walker_fits, self->nwalkers);
+
   self->started = TRUE;
 
   ncm_mset_catalog_set_sync_mode (self->mcat, NCM_MSET_CATALOG_SYNC_TIMED);
@@ -1496,6 +1758,12 @@ ncm_fit_esmcmc_end_run (NcmFitESMCMC *esmcmc)
   if (ncm_timer_task_is_running (self->nt))
     ncm_timer_task_end (self->nt);
 
+  /* The walkers use copies of the likelihood, their profiling is moved back to it. */
+  if (ncm_likelihood_get_profile (self->fit->lh))
+    ncm_memory_pool_foreach (self->walker_pool, &_ncm_fit_esmcmc_worker_profile_gather, self->fit->lh);
+
+  _ncm_fit_esmcmc_walker_fits_clear (esmcmc);
+
   ncm_mset_catalog_sync (self->mcat, TRUE);
   if (self->mtype > NCM_FIT_RUN_MSGS_NONE)
     ncm_mset_catalog_log_current_stats (self->mcat);
@@ -1648,7 +1916,7 @@ _ncm_fit_esmcmc_eval_mpi (NcmFitESMCMC *esmcmc, const glong i, const glong f)
 		}
 	}
 
-	ncm_mpi_job_run_array (self->mj, thetastar_in_a, thetastar_out_a);
+	ncm_mpi_job_run_array_async (self->mj, thetastar_in_a, thetastar_out_a, NULL, NULL);
 
   for (k = i; k < f; k++)
   {
@@ -1671,17 +1939,137 @@ _ncm_fit_esmcmc_eval_mpi (NcmFitESMCMC *esmcmc, const glong i, const glong f)
 	g_ptr_array_unref (thetastar_out_a);
 }
 
+static void
+_ncm_fit_esmcmc_eval_funcs (NcmFitESMCMCWorker *fw, NcmMSet *mset, NcmVector *full_thetastar)
+{
+  if (fw->funcs_array != NULL)
+  {
+    guint j;
+    for (j = 0; j < fw->funcs_array->len; j++)
+    {
+      NcmMSetFunc *func = NCM_MSET_FUNC (ncm_obj_array_peek (fw->funcs_array, j));
+      const gdouble a_j = ncm_mset_func_eval0 (func, mset);
+
+      ncm_vector_set (full_thetastar, j + 1, a_j);
+    }
+  }
+}
+
+static void
+_ncm_fit_esmcmc_fparams_sync (NcmMSet *mset, NcmVector *theta)
+{
+  const guint fparam_len = ncm_vector_len (theta);
+  guint i;
+
+  /* Only the changed parameters are set, leaving the other models untouched. */
+  for (i = 0; i < fparam_len; i++)
+  {
+    const gdouble x_i = ncm_vector_get (theta, i);
+    if (ncm_mset_fparam_get (mset, i) != x_i)
+      ncm_mset_fparam_set (mset, i, x_i);
+  }
+}
+
+static NcmFit *
+_ncm_fit_esmcmc_fit_dup (NcmFitESMCMC *esmcmc)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  NcmFit *fit;
+
+  g_mutex_lock (&self->dup_fit);
+  fit = ncm_fit_dup (self->fit, self->ser);
+  ncm_serialize_reset (self->ser, TRUE);
+  g_mutex_unlock (&self->dup_fit);
+
+  return fit;
+}
+
+/*
+ * Called after the ensemble proposal of walker k was evaluated in the
+ * worker fit. When it was accepted the worker fit holds the new point
+ * of the walker and is handed to it, the worker gets the old walker fit
+ * (or a new copy) as its scratch fit.
+ */
+static void
+_ncm_fit_esmcmc_walker_fit_accept (NcmFitESMCMC *esmcmc, NcmFitESMCMCWorker *fw, const guint k)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  NcmFit *fit_w = g_ptr_array_index (self->walker_fits, k);
+
+  g_ptr_array_index (self->walker_fits, k) = fw->fit;
+  fw->fit = (fit_w != NULL) ? fit_w : _ncm_fit_esmcmc_fit_dup (esmcmc);
+}
+
+static void
+_ncm_fit_esmcmc_fast_substeps (NcmFitESMCMC *esmcmc, NcmFitESMCMCWorker *fw, const guint k)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  NcmFit *fit_k             = g_ptr_array_index (self->walker_fits, k);
+  NcmVector *full_theta_k   = g_ptr_array_index (self->full_theta, k);
+  NcmVector *full_thetastar = g_ptr_array_index (self->full_thetastar, k);
+  NcmVector *theta_k        = g_ptr_array_index (self->theta, k);
+  NcmVector *thetastar      = g_ptr_array_index (self->thetastar, k);
+  const guint nfast         = self->fast_fparams->len;
+  guint s, j;
+
+  if (fit_k == NULL)
+  {
+    fit_k = _ncm_fit_esmcmc_fit_dup (esmcmc);
+    g_ptr_array_index (self->walker_fits, k) = fit_k;
+  }
+
+  /* 
+   * The walker fit is at the walker's point, up to the fast parameters
+   * of a rejected sub-step, unless it was just created.
+   */
+  _ncm_fit_esmcmc_fparams_sync (fit_k->mset, theta_k);
+  
+  for (s = 0; s < self->fast_steps; s++)
+  {
+    const gdouble m2lnL_cur = ncm_vector_get (full_theta_k, NCM_FIT_ESMCMC_M2LNL_ID);
+    const gdouble jump      = ncm_matrix_get (self->fast_rnd, k, s * (nfast + 1) + nfast);
+    gdouble m2lnL_star      = GSL_POSINF;
+    gdouble prob            = 0.0;
+
+    ncm_vector_memcpy (thetastar, theta_k);
+    for (j = 0; j < nfast; j++)
+    {
+      const guint fpi = g_array_index (self->fast_fparams, guint, j);
+      const gdouble dx = ncm_vector_get (self->fast_sd, j) * ncm_matrix_get (self->fast_rnd, k, s * (nfast + 1) + j);
+
+      ncm_vector_addto (thetastar, fpi, dx);
+    }
+
+    if (!ncm_mset_fparam_valid_bounds (fit_k->mset, thetastar))
+      continue;
+
+    _ncm_fit_esmcmc_fparams_sync (fit_k->mset, thetastar);
+    ncm_fit_m2lnL_val (fit_k, &m2lnL_star);
+
+    if (gsl_finite (m2lnL_star))
+      prob = GSL_MIN (exp (- 0.5 * (m2lnL_star - m2lnL_cur)), 1.0);
+
+    if (jump < prob)
+    {
+      ncm_vector_set (full_thetastar, NCM_FIT_ESMCMC_M2LNL_ID, m2lnL_star);
+      _ncm_fit_esmcmc_eval_funcs (fw, fit_k->mset, full_thetastar);
+      ncm_vector_memcpy (full_theta_k, full_thetastar);
+    }
+  }
+}
+
 static void 
 _ncm_fit_esmcmc_mt_eval (glong i, glong f, gpointer data)
 {
   NcmFitESMCMC *esmcmc        = NCM_FIT_ESMCMC (data);
 	NcmFitESMCMCPrivate * const self = esmcmc->priv;
   NcmFitESMCMCWorker **fk_ptr = ncm_memory_pool_get (self->walker_pool);
-  NcmFit *fit_k               = fk_ptr[0]->fit;
+  const gboolean fast         = (self->walker_fits->len > 0);
   guint k = i;
 
   while (k < f)
   {
+    NcmFit *fit_k             = fk_ptr[0]->fit;
     NcmVector *full_thetastar = g_ptr_array_index (self->full_thetastar, k);
     NcmVector *full_theta_k   = g_ptr_array_index (self->full_theta, k);
     NcmVector *thetastar      = g_ptr_array_index (self->thetastar, k);
@@ -1711,21 +2099,18 @@ _ncm_fit_esmcmc_mt_eval (glong i, glong f, gpointer data)
     
     if (jump < prob)
     {
-      if (fk_ptr[0]->funcs_array != NULL)
-      {
-        guint j;
-        for (j = 0; j < fk_ptr[0]->funcs_array->len; j++)
-        {
-          NcmMSetFunc *func = NCM_MSET_FUNC (ncm_obj_array_peek (fk_ptr[0]->funcs_array, j));
-          const gdouble a_j = ncm_mset_func_eval0 (func, fit_k->mset);
-
-          ncm_vector_set (full_thetastar, j + 1, a_j);
-        }
-      }
+      _ncm_fit_esmcmc_eval_funcs (fk_ptr[0], fit_k->mset, full_thetastar);
 
       ncm_vector_memcpy (full_theta_k, full_thetastar);
       g_array_index (self->accepted, gboolean, k) = TRUE;
+
+      if (fast)
+        _ncm_fit_esmcmc_walker_fit_accept (esmcmc, fk_ptr[0], k);
     }
+
+    if (fast)
+      _ncm_fit_esmcmc_fast_substeps (esmcmc, fk_ptr[0], k);
+
     k++;
   }
 
@@ -1744,17 +2129,91 @@ _ncm_fit_esmcmc_get_jumps (NcmFitESMCMC *esmcmc, guint ki, guint kf)
     const gdouble jump = gsl_rng_uniform (rng->r);
     ncm_vector_set (self->jumps, k, jump);
   }
+
+  if ((self->fast_steps > 0) && (self->fast_fparams->len > 0))
+  {
+    const guint nfast = self->fast_fparams->len;
+    const guint ncols = self->fast_steps * (nfast + 1);
+    guint s, j;
+
+    if ((self->fast_rnd == NULL) || (ncm_matrix_nrows (self->fast_rnd) != self->nwalkers) || (ncm_matrix_ncols (self->fast_rnd) != ncols))
+    {
+      ncm_matrix_clear (&self->fast_rnd);
+      self->fast_rnd = ncm_matrix_new (self->nwalkers, ncols);
+    }
+
+    for (k = ki; k < kf; k++)
+    {
+      for (s = 0; s < self->fast_steps; s++)
+      {
+        for (j = 0; j < nfast; j++)
+          ncm_matrix_set (self->fast_rnd, k, s * (nfast + 1) + j, gsl_ran_ugaussian (rng->r));
+        ncm_matrix_set (self->fast_rnd, k, s * (nfast + 1) + nfast, gsl_rng_uniform (rng->r));
+      }
+    }
+  }
+}
+
+static void
+_ncm_fit_esmcmc_fast_prepare (NcmFitESMCMC *esmcmc, const glong i, const glong f)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+  const guint nfast      = self->fast_fparams->len;
+  const guint nwalkers_2 = self->nwalkers / 2;
+
+  if ((self->fast_steps == 0) || (nfast == 0))
+    return;
+
+  /*
+   * The proposal widths are computed from the complementary half of the
+   * ensemble, which is fixed while the walkers in [i, f) are updated.
+   */
+  {
+    const guint ci      = (i < nwalkers_2) ? nwalkers_2 : 0;
+    const guint cf      = (i < nwalkers_2) ? self->nwalkers : nwalkers_2;
+    const gdouble scale = 2.38 / sqrt (nfast);
+    guint j, k;
+
+    if ((self->fast_sd == NULL) || (ncm_vector_len (self->fast_sd) != nfast))
+    {
+      ncm_vector_clear (&self->fast_sd);
+      self->fast_sd = ncm_vector_new (nfast);
+    }
+
+    for (j = 0; j < nfast; j++)
+    {
+      const guint fpi = g_array_index (self->fast_fparams, guint, j);
+      gdouble mean    = 0.0;
+      gdouble var     = 0.0;
+      gdouble sd;
+
+      for (k = ci; k < cf; k++)
+        mean += ncm_vector_get (g_ptr_array_index (self->theta, k), fpi);
+      mean = mean / (cf - ci);
+
+      for (k = ci; k < cf; k++)
+        var += gsl_pow_2 (ncm_vector_get (g_ptr_array_index (self->theta, k), fpi) - mean);
+      sd = sqrt (var / (cf - ci - 1.0));
+
+      if (!(sd > 0.0))
+        sd = ncm_mset_fparam_get_scale (self->fit->mset, fpi);
+
+      ncm_vector_set (self->fast_sd, j, scale * sd);
+    }
+  }
 }
 
 static void 
 _ncm_fit_esmcmc_run_serial (NcmFitESMCMC *esmcmc, const glong i, const glong f)
 {
+	_ncm_fit_esmcmc_fast_prepare (esmcmc, i, f);
 	_ncm_fit_esmcmc_mt_eval (i, f, esmcmc);
 }
 
 static void 
 _ncm_fit_esmcmc_run_mt (NcmFitESMCMC *esmcmc, const glong i, const glong f)
 {
+	_ncm_fit_esmcmc_fast_prepare (esmcmc, i, f);
 	ncm_func_eval_threaded_loop_full (&_ncm_fit_esmcmc_mt_eval, i, f, esmcmc);
 }
 
@@ -2114,7 +2573,7 @@ _ncm_fit_esmcmc_validate_mpi (NcmFitESMCMC *esmcmc, const glong i, const glong f
 		g_ptr_array_add (thetastar_out_a, thetastar_out_j);
 	}
 
-	ncm_mpi_job_run_array (self->mj, thetastar_in_a, thetastar_out_a);
+	ncm_mpi_job_run_array_async (self->mj, thetastar_in_a, thetastar_out_a, NULL, NULL);
 
 	k = i;
   for (j = 0; j < thetastar_out_a->len; j++)
@@ -89,6 +89,13 @@ void ncm_fit_esmcmc_set_auto_trim_type (NcmFitESMCMC *esmcmc, NcmMSetCatalogTrim
 void ncm_fit_esmcmc_set_min_runs (NcmFitESMCMC *esmcmc, guint min_runs);
 void ncm_fit_esmcmc_set_max_runs_time (NcmFitESMCMC *esmcmc, gdouble max_runs_time);
 
+void ncm_fit_esmcmc_set_fast_steps (NcmFitESMCMC *esmcmc, guint fast_steps);
+guint ncm_fit_esmcmc_get_fast_steps (NcmFitESMCMC *esmcmc);
+void ncm_fit_esmcmc_add_fast_fparam (NcmFitESMCMC *esmcmc, guint fpi);
+void ncm_fit_esmcmc_clear_fast_fparams (NcmFitESMCMC *esmcmc);
+guint ncm_fit_esmcmc_fast_fparams_len (NcmFitESMCMC *esmcmc);
+guint ncm_fit_esmcmc_detect_fast_fparams (NcmFitESMCMC *esmcmc, const gdouble cost_ratio);
+
 gboolean ncm_fit_esmcmc_has_rng (NcmFitESMCMC *esmcmc);
 
 gdouble ncm_fit_esmcmc_get_accept_ratio (NcmFitESMCMC *esmcmc);
@@ -40,6 +40,7 @@
 #include "math/ncm_fit_mc.h"
 #include "math/ncm_cfg.h"
 #include "math/ncm_func_eval.h"
+#include "math/ncm_data_gauss_cov.h"
 #include "ncm_enum_types.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
@@ -55,6 +56,8 @@ enum
   PROP_MTYPE,
   PROP_NTHREADS,
   PROP_KEEP_ORDER,
+  PROP_RESAMPLE_BATCH,
+  PROP_RNG_SUBSTREAMS,
   PROP_DATA_FILE,
 };
 
@@ -74,7 +77,12 @@ ncm_fit_mc_init (NcmFitMC *mc)
   mc->nthreads        = 0;
   mc->n               = 0;
   mc->keep_order      = FALSE;
+  mc->resample_batch  = 0;
+  mc->batch_pos       = 0;
+  mc->batch_y         = g_ptr_array_new ();
+  mc->rng_substreams  = FALSE;
   mc->mp              = NULL;
+  mc->mp_fiduc        = NULL;
   mc->cur_sample_id   = -1; /* Represents that no samples were calculated yet. */
   mc->write_index     = 0;
   mc->started         = FALSE;
@@ -112,6 +120,12 @@ ncm_fit_mc_set_property (GObject *object, guint prop_id, const GValue *value, GP
     case PROP_KEEP_ORDER:
       ncm_fit_mc_keep_order (mc, g_value_get_boolean (value));
       break;
+    case PROP_RESAMPLE_BATCH:
+      ncm_fit_mc_set_resample_batch (mc, g_value_get_uint (value));
+      break;
+    case PROP_RNG_SUBSTREAMS:
+      ncm_fit_mc_set_rng_substreams (mc, g_value_get_boolean (value));
+      break;
     case PROP_DATA_FILE:
       ncm_fit_mc_set_data_file (mc, g_value_get_string (value));
       break;    
@@ -147,6 +161,12 @@ ncm_fit_mc_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
     case PROP_KEEP_ORDER:
       g_value_set_boolean (value, mc->keep_order);
       break;
+    case PROP_RESAMPLE_BATCH:
+      g_value_set_uint (value, mc->resample_batch);
+      break;
+    case PROP_RNG_SUBSTREAMS:
+      g_value_set_boolean (value, mc->rng_substreams);
+      break;
     case PROP_DATA_FILE:
       g_value_set_string (value, ncm_mset_catalog_peek_filename (mc->mcat));
       break;
@@ -156,11 +176,15 @@ ncm_fit_mc_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
   }
 }
 
+static void _ncm_fit_mc_batch_clear (NcmFitMC *mc);
+
 static void
 ncm_fit_mc_dispose (GObject *object)
 {
   NcmFitMC *mc = NCM_FIT_MC (object);
 
+  _ncm_fit_mc_batch_clear (mc);
+
   ncm_fit_clear (&mc->fit);
   ncm_mset_clear (&mc->fiduc);
   ncm_vector_clear (&mc->bf);
@@ -174,6 +198,12 @@ ncm_fit_mc_dispose (GObject *object)
     mc->mp = NULL;
   }
 
+  if (mc->mp_fiduc != NULL)
+  {
+    ncm_memory_pool_free (mc->mp_fiduc, TRUE);
+    mc->mp_fiduc = NULL;
+  }
+
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_fit_mc_parent_class)->dispose (object);
 }
@@ -187,6 +217,7 @@ ncm_fit_mc_finalize (GObject *object)
   g_mutex_clear (&mc->resample_lock);
   g_mutex_clear (&mc->update_lock);
   g_cond_clear (&mc->write_cond);
+  g_ptr_array_unref (mc->batch_y);
   
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_fit_mc_parent_class)->finalize (object);
@@ -245,6 +276,20 @@ ncm_fit_mc_class_init (NcmFitMCClass *klass)
                                                       "Number of threads to run",
                                                       0, 100, 0,
                                                       G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_RESAMPLE_BATCH,
+                                   g_param_spec_uint ("resample-batch",
+                                                      NULL,
+                                                      "Number of realizations generated at once",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_RNG_SUBSTREAMS,
+                                   g_param_spec_boolean ("rng-substreams",
+                                                         NULL,
+                                                         "Whether to draw each realization from its own RNG substream",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 static void 
@@ -359,10 +404,98 @@ ncm_fit_mc_set_mtype (NcmFitMC *mc, NcmFitRunMsgs mtype)
 
 static void _ncm_fit_mc_resample_bstrap (NcmDataset *dset, NcmMSet *mset, NcmRNG *rng);
 
+static void
+_ncm_fit_mc_batch_clear (NcmFitMC *mc)
+{
+  guint i;
+
+  for (i = 0; i < mc->batch_y->len; i++)
+  {
+    NcmMatrix *y_batch = g_ptr_array_index (mc->batch_y, i);
+    if (y_batch != NULL)
+      ncm_matrix_free (y_batch);
+  }
+  g_ptr_array_set_size (mc->batch_y, 0);
+  mc->batch_pos = 0;
+}
+
+static void
+_ncm_fit_mc_resample_batch (NcmFitMC *mc, NcmFit *fit)
+{
+  NcmDataset *dset  = fit->lh->dset;
+  NcmRNG *rng       = ncm_mset_catalog_peek_rng (mc->mcat);
+  const guint ndata = ncm_dataset_get_length (dset);
+  guint i;
+
+  if (mc->batch_pos == 0)
+  {
+    if (mc->batch_y->len != ndata)
+    {
+      _ncm_fit_mc_batch_clear (mc);
+      g_ptr_array_set_size (mc->batch_y, ndata);
+    }
+
+    for (i = 0; i < ndata; i++)
+    {
+      NcmData *data      = ncm_dataset_peek_data (dset, i);
+      NcmMatrix *y_batch = g_ptr_array_index (mc->batch_y, i);
+
+      if (NCM_IS_DATA_GAUSS_COV (data) && ncm_data_gauss_cov_has_resample_batch (NCM_DATA_GAUSS_COV (data)))
+      {
+        NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (data);
+        const guint np         = ncm_data_gauss_cov_get_size (gauss);
+
+        if ((y_batch != NULL) && (ncm_matrix_ncols (y_batch) != np))
+          ncm_matrix_clear (&y_batch);
+        if (y_batch == NULL)
+          y_batch = ncm_matrix_new (mc->resample_batch, np);
+
+        ncm_data_gauss_cov_resample_batch (gauss, mc->fiduc, rng, y_batch);
+      }
+      else if (y_batch != NULL)
+        ncm_matrix_clear (&y_batch);
+
+      g_ptr_array_index (mc->batch_y, i) = y_batch;
+    }
+  }
+
+  for (i = 0; i < ndata; i++)
+  {
+    NcmData *data      = ncm_dataset_peek_data (dset, i);
+    NcmMatrix *y_batch = g_ptr_array_index (mc->batch_y, i);
+
+    if (y_batch != NULL)
+      ncm_data_gauss_cov_set_realization (NCM_DATA_GAUSS_COV (data), y_batch, mc->batch_pos);
+    else
+      ncm_data_resample (data, mc->fiduc, rng);
+  }
+
+  mc->batch_pos = (mc->batch_pos + 1) % mc->resample_batch;
+}
+
+static gboolean
+_ncm_fit_mc_use_substreams (NcmFitMC *mc)
+{
+  return mc->rng_substreams && !((mc->resample_batch > 0) && (mc->rtype == NCM_FIT_MC_RESAMPLE_FROM_MODEL));
+}
+
+static void
+_ncm_fit_mc_resample_substream (NcmFitMC *mc, NcmFit *fit, NcmMSet *fiduc, gint sample_index)
+{
+  NcmRNG *rng = ncm_rng_substream_new (ncm_mset_catalog_peek_rng (mc->mcat), sample_index);
+  mc->resample (fit->lh->dset, fiduc, rng);
+  ncm_rng_free (rng);
+}
+
 static gint
 _ncm_fit_mc_resample (NcmFitMC *mc, NcmFit *fit)
 {
-  mc->resample (fit->lh->dset, mc->fiduc, ncm_mset_catalog_peek_rng (mc->mcat));
+  if (_ncm_fit_mc_use_substreams (mc))
+    _ncm_fit_mc_resample_substream (mc, fit, mc->fiduc, mc->cur_sample_id + 1);
+  else if ((mc->resample_batch > 0) && (mc->rtype == NCM_FIT_MC_RESAMPLE_FROM_MODEL))
+    _ncm_fit_mc_resample_batch (mc, fit);
+  else
+    mc->resample (fit->lh->dset, mc->fiduc, ncm_mset_catalog_peek_rng (mc->mcat));
   mc->cur_sample_id++;
   return mc->cur_sample_id;
 }
@@ -384,6 +517,7 @@ ncm_fit_mc_set_rtype (NcmFitMC *mc, NcmFitMCResampleType rtype)
     g_error ("ncm_fit_mc_set_rtype: Cannot change resample type during a run, call ncm_fit_mc_end_run() first.");
 
   mc->rtype = rtype;
+  _ncm_fit_mc_batch_clear (mc);
 
   ncm_mset_catalog_set_run_type (mc->mcat, eval->value_nick);
   
@@ -435,6 +569,84 @@ ncm_fit_mc_keep_order (NcmFitMC *mc, gboolean keep_order)
   mc->keep_order = keep_order;
 }
 
+/**
+ * ncm_fit_mc_set_resample_batch:
+ * @mc: a #NcmFitMC
+ * @resample_batch: number of realizations per batch
+ *
+ * When @resample_batch is larger than zero and the resample type is
+ * #NCM_FIT_MC_RESAMPLE_FROM_MODEL, every #NcmDataGaussCov in the dataset
+ * supporting ncm_data_gauss_cov_resample_batch() has its realizations 
+ * generated in blocks of @resample_batch, reusing the same covariance
+ * decomposition. The other data are resampled one at a time as usual.
+ * Note that the realizations differ from the unbatched ones, since the
+ * random numbers are consumed in a different order. Realizations left 
+ * in a block at the end of a run are discarded.
+ *
+ */
+void
+ncm_fit_mc_set_resample_batch (NcmFitMC *mc, guint resample_batch)
+{
+  if (mc->started)
+    g_error ("ncm_fit_mc_set_resample_batch: Cannot change the batch size during a run, call ncm_fit_mc_end_run() first.");
+
+  mc->resample_batch = resample_batch;
+  _ncm_fit_mc_batch_clear (mc);
+}
+
+/**
+ * ncm_fit_mc_set_rng_substreams:
+ * @mc: a #NcmFitMC
+ * @enable: whether to use substreams
+ *
+ * When @enable is TRUE the $i$-th realization is drawn from the substream
+ * $i$ of the catalog #NcmRNG, see ncm_rng_substream_new(). The realizations
+ * are then determined by the catalog seed and their indexes alone, they
+ * do not depend on the number of threads, on the order they are 
+ * computed or on the realizations skipped when resuming a run. In a
+ * threaded run only the sample index is reserved under a lock, each
+ * thread then resamples its own copy of the dataset from its own copy of
+ * the fiducial model. This option is ignored when the realizations are 
+ * generated in batches, see ncm_fit_mc_set_resample_batch().
+ *
+ * The mode is recorded in the catalog when the run starts, see
+ * ncm_mset_catalog_set_rng_substreams(), hence a run cannot be resumed
+ * using a different mode.
+ *
+ */
+void
+ncm_fit_mc_set_rng_substreams (NcmFitMC *mc, gboolean enable)
+{
+  if (mc->started)
+    g_error ("ncm_fit_mc_set_rng_substreams: Cannot change the RNG mode during a run, call ncm_fit_mc_end_run() first.");
+
+  mc->rng_substreams = enable;
+}
+
+/**
+ * ncm_fit_mc_get_rng_substreams:
+ * @mc: a #NcmFitMC
+ *
+ * Returns: whether each realization uses its own RNG substream, see ncm_fit_mc_set_rng_substreams().
+ */
+gboolean
+ncm_fit_mc_get_rng_substreams (NcmFitMC *mc)
+{
+  return mc->rng_substreams;
+}
+
+/**
+ * ncm_fit_mc_get_resample_batch:
+ * @mc: a #NcmFitMC
+ *
+ * Returns: the number of realizations per batch, see ncm_fit_mc_set_resample_batch().
+ */
+guint
+ncm_fit_mc_get_resample_batch (NcmFitMC *mc)
+{
+  return mc->resample_batch;
+}
+
 /**
  * ncm_fit_mc_set_fiducial:
  * @mc: a #NcmFitMC
@@ -457,6 +669,7 @@ ncm_fit_mc_set_fiducial (NcmFitMC *mc, NcmMSet *fiduc)
     mc->fiduc = ncm_mset_ref (fiduc);
     g_assert (ncm_mset_cmp (mc->fit->mset, fiduc, FALSE));
   }
+  _ncm_fit_mc_batch_clear (mc);
 }
 
 /**
@@ -582,6 +795,9 @@ ncm_fit_mc_start_run (NcmFitMC *mc)
     ncm_rng_free (rng);
   }
 
+  /* Recorded in the catalog, resuming with a different mode is an error. */
+  ncm_mset_catalog_set_rng_substreams (mc->mcat, _ncm_fit_mc_use_substreams (mc));
+
   mc->started = TRUE;
 
   ncm_mset_catalog_set_sync_mode (mc->mcat, NCM_MSET_CATALOG_SYNC_TIMED);
@@ -618,7 +834,14 @@ ncm_fit_mc_end_run (NcmFitMC *mc)
     mc->mp = NULL;
   }
 
+  if (mc->mp_fiduc != NULL)
+  {
+    ncm_memory_pool_free (mc->mp_fiduc, TRUE);
+    mc->mp_fiduc = NULL;
+  }
+
   ncm_mset_catalog_sync (mc->mcat, TRUE);
+  _ncm_fit_mc_batch_clear (mc);
   
   mc->started = FALSE;
 }
@@ -785,6 +1008,51 @@ _ncm_fit_mc_dup_fit (gpointer userdata)
   }
 }
 
+static gpointer
+_ncm_fit_mc_dup_fiduc (gpointer userdata)
+{
+  NcmFitMC *mc = NCM_FIT_MC (userdata);
+  g_mutex_lock (&mc->dup_fit);
+  {
+    NcmMSet *fiduc = ncm_mset_dup (mc->fiduc, mc->ser);
+    ncm_serialize_reset (mc->ser, TRUE);
+    g_mutex_unlock (&mc->dup_fit);
+    return fiduc;
+  }
+}
+
+/*
+ * With substreams the realization depends only on its index, hence the
+ * lock is held just to reserve the index and the resampling itself runs
+ * concurrently using a thread local copy of the fiducial model.
+ */
+static gint
+_ncm_fit_mc_resample_mt (NcmFitMC *mc, NcmFit *fit)
+{
+  gint sample_index;
+
+  if (mc->mp_fiduc != NULL)
+  {
+    NcmMSet **fiduc_ptr;
+
+    g_mutex_lock (&mc->resample_lock);
+    sample_index = ++mc->cur_sample_id;
+    g_mutex_unlock (&mc->resample_lock);
+
+    fiduc_ptr = ncm_memory_pool_get (mc->mp_fiduc);
+    _ncm_fit_mc_resample_substream (mc, fit, *fiduc_ptr, sample_index);
+    ncm_memory_pool_return (fiduc_ptr);
+  }
+  else
+  {
+    g_mutex_lock (&mc->resample_lock);
+    sample_index = _ncm_fit_mc_resample (mc, fit);
+    g_mutex_unlock (&mc->resample_lock);
+  }
+
+  return sample_index;
+}
+
 static void 
 _ncm_fit_mc_mt_eval_keep_order (glong i, glong f, gpointer data)
 {
@@ -799,9 +1067,7 @@ _ncm_fit_mc_mt_eval_keep_order (glong i, glong f, gpointer data)
 
     ncm_mset_param_set_vector (fit->mset, mc->bf);
 
-    g_mutex_lock (&mc->resample_lock);
-    sample_index = _ncm_fit_mc_resample (mc, fit);
-    g_mutex_unlock (&mc->resample_lock);
+    sample_index = _ncm_fit_mc_resample_mt (mc, fit);
 
     ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
 
@@ -833,9 +1099,7 @@ _ncm_fit_mc_mt_eval (glong i, glong f, gpointer data)
   {
     ncm_mset_param_set_vector (fit->mset, mc->bf);
 
-    g_mutex_lock (&mc->resample_lock);
-    _ncm_fit_mc_resample (mc, fit);
-    g_mutex_unlock (&mc->resample_lock);
+    _ncm_fit_mc_resample_mt (mc, fit);
 
     ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
 
@@ -849,6 +1113,16 @@ _ncm_fit_mc_mt_eval (glong i, glong f, gpointer data)
 }
 
 
+static void
+_ncm_fit_mc_profile_gather (gpointer userdata, gpointer lh_ptr)
+{
+  NcmFit *fit       = NCM_FIT (userdata);
+  NcmLikelihood *lh = NCM_LIKELIHOOD (lh_ptr);
+
+  ncm_likelihood_profile_add (lh, fit->lh);
+  ncm_likelihood_profile_reset (fit->lh);
+}
+
 static void
 _ncm_fit_mc_run_mt (NcmFitMC *mc)
 {
@@ -865,6 +1139,14 @@ _ncm_fit_mc_run_mt (NcmFitMC *mc)
   mc->mp = ncm_memory_pool_new (&_ncm_fit_mc_dup_fit, mc, 
                                 (GDestroyNotify) &ncm_fit_free);
 
+  if (mc->mp_fiduc != NULL)
+    ncm_memory_pool_free (mc->mp_fiduc, TRUE);
+  if (_ncm_fit_mc_use_substreams (mc))
+    mc->mp_fiduc = ncm_memory_pool_new (&_ncm_fit_mc_dup_fiduc, mc, 
+                                        (GDestroyNotify) &ncm_mset_free);
+  else
+    mc->mp_fiduc = NULL;
+
   /*
    * The line below added de main fit object to the pool, but can cause
    * several race conditions as it is used to make the copies for the other
@@ -878,6 +1160,10 @@ _ncm_fit_mc_run_mt (NcmFitMC *mc)
     ncm_func_eval_threaded_loop_full (&_ncm_fit_mc_mt_eval_keep_order, 0, mc->n, mc);
   else
     ncm_func_eval_threaded_loop_full (&_ncm_fit_mc_mt_eval, 0, mc->n, mc);  
+
+  /* Each thread fits a copy of the likelihood, their profiling is moved back to it. */
+  if (ncm_likelihood_get_profile (mc->fit->lh))
+    ncm_memory_pool_foreach (mc->mp, &_ncm_fit_mc_profile_gather, mc->fit->lh);
 }
 
 /**
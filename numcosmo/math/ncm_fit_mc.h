@@ -95,7 +95,12 @@ struct _NcmFitMC
   guint nthreads;
   guint n;
   gboolean keep_order;
+  guint resample_batch;
+  guint batch_pos;
+  GPtrArray *batch_y;
+  gboolean rng_substreams;
   NcmMemoryPool *mp;
+  NcmMemoryPool *mp_fiduc;
   gint write_index;
   gint cur_sample_id;
   gint first_sample_id;
@@ -118,6 +123,10 @@ void ncm_fit_mc_set_mtype (NcmFitMC *mc, NcmFitRunMsgs mtype);
 void ncm_fit_mc_set_rtype (NcmFitMC *mc, NcmFitMCResampleType rtype);
 void ncm_fit_mc_set_nthreads (NcmFitMC *mc, guint nthreads);
 void ncm_fit_mc_keep_order (NcmFitMC *mc, gboolean keep_order);
+void ncm_fit_mc_set_resample_batch (NcmFitMC *mc, guint resample_batch);
+guint ncm_fit_mc_get_resample_batch (NcmFitMC *mc);
+void ncm_fit_mc_set_rng_substreams (NcmFitMC *mc, gboolean enable);
+gboolean ncm_fit_mc_get_rng_substreams (NcmFitMC *mc);
 void ncm_fit_mc_set_fiducial (NcmFitMC *mc, NcmMSet *fiduc);
 void ncm_fit_mc_set_rng (NcmFitMC *mc, NcmRNG *rng);
 
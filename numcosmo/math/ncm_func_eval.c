@@ -59,7 +59,42 @@ typedef struct _NcmFuncEvalLoopEval
   NcmFuncEvalCtrl *ctrl;
 } NcmFuncEvalLoopEval;
 
+typedef struct _NcmFuncEvalWSQueue
+{
+  GMutex lock;
+  glong next;
+  glong last;
+} NcmFuncEvalWSQueue;
+
+typedef struct _NcmFuncEvalWSLoop
+{
+  NcmFuncEvalLoop lfunc;
+  gpointer data;
+  glong i;
+  glong f;
+  glong grain;
+  guint nworkers;
+  NcmFuncEvalWSQueue *queues;
+  gulong *nchunks;
+  gulong *nstolen;
+  gint64 *busy;
+} NcmFuncEvalWSLoop;
+
+typedef struct _NcmFuncEvalWSStats
+{
+  gulong nloops;
+  gulong nchunks;
+  gulong nstolen;
+  gdouble idle;
+  gdouble wall;
+  GArray *last_nchunks;
+  GArray *last_nstolen;
+  GArray *last_idle;
+} NcmFuncEvalWSStats;
+
 static GThreadPool *_function_thread_pool = NULL;
+static NcmFuncEvalWSStats _ws_stats = {0, 0, 0, 0.0, 0.0, NULL, NULL, NULL};
+G_LOCK_DEFINE_STATIC (ws_stats);
 
 static void
 func (gpointer data, gpointer empty)
@@ -108,6 +143,30 @@ ncm_func_eval_get_pool (void)
   return _function_thread_pool;
 }
 
+/**
+ * ncm_func_eval_pool_free: (skip)
+ *
+ * Frees the internal GThreadPool pool, waiting for the queued tasks,
+ * and the work-stealing loop statistics. It is called when the library
+ * exits, any later use of the pool allocates it again.
+ *
+ */
+void
+ncm_func_eval_pool_free (void)
+{
+  if (_function_thread_pool != NULL)
+  {
+    g_thread_pool_free (_function_thread_pool, FALSE, TRUE);
+    _function_thread_pool = NULL;
+  }
+
+  G_LOCK (ws_stats);
+  g_clear_pointer (&_ws_stats.last_nchunks, g_array_unref);
+  g_clear_pointer (&_ws_stats.last_nstolen, g_array_unref);
+  g_clear_pointer (&_ws_stats.last_idle, g_array_unref);
+  G_UNLOCK (ws_stats);
+}
+
 /**
  * ncm_func_eval_set_max_threads:
  * @mt: new max threads to be used in the pool, -1 means unlimited
@@ -264,6 +323,276 @@ ncm_func_eval_threaded_loop_full (NcmFuncEvalLoop lfunc, glong i, glong f, gpoin
 }
 #endif
 
+static void
+_ncm_func_eval_ws_run_chunk (NcmFuncEvalWSLoop *wsl, guint w, glong c)
+{
+  const glong ci = wsl->i + c * wsl->grain;
+  const glong cf = MIN (ci + wsl->grain, wsl->f);
+  const gint64 t0 = g_get_monotonic_time ();
+
+  wsl->lfunc (ci, cf, wsl->data);
+
+  wsl->busy[w] += g_get_monotonic_time () - t0;
+  wsl->nchunks[w]++;
+}
+
+static gboolean
+_ncm_func_eval_ws_pop (NcmFuncEvalWSQueue *q, glong *c)
+{
+  gboolean found = FALSE;
+  g_mutex_lock (&q->lock);
+  if (q->next < q->last)
+  {
+    *c = q->next;
+    q->next++;
+    found = TRUE;
+  }
+  g_mutex_unlock (&q->lock);
+  return found;
+}
+
+static gboolean
+_ncm_func_eval_ws_steal (NcmFuncEvalWSQueue *q, glong *c)
+{
+  gboolean found = FALSE;
+  g_mutex_lock (&q->lock);
+  if (q->next < q->last)
+  {
+    q->last--;
+    *c = q->last;
+    found = TRUE;
+  }
+  g_mutex_unlock (&q->lock);
+  return found;
+}
+
+static void
+_ncm_func_eval_ws_worker (glong wi, glong wf, gpointer data)
+{
+  NcmFuncEvalWSLoop *wsl = (NcmFuncEvalWSLoop *) data;
+  const guint w = wi;
+  glong c;
+  NCM_UNUSED (wf);
+
+  /* Owner consumes its own queue from the front. */
+  while (_ncm_func_eval_ws_pop (&wsl->queues[w], &c))
+    _ncm_func_eval_ws_run_chunk (wsl, w, c);
+
+  /* Then steals from the back of the other queues until all are empty. */
+  {
+    gboolean stole;
+    do {
+      guint k;
+      stole = FALSE;
+      for (k = 1; k < wsl->nworkers; k++)
+      {
+        const guint v = (w + k) % wsl->nworkers;
+        while (_ncm_func_eval_ws_steal (&wsl->queues[v], &c))
+        {
+          _ncm_func_eval_ws_run_chunk (wsl, w, c);
+          wsl->nstolen[w]++;
+          stole = TRUE;
+        }
+      }
+    } while (stole);
+  }
+}
+
+static void
+_ncm_func_eval_ws_stats_update (NcmFuncEvalWSLoop *wsl, gint64 wall)
+{
+  guint w;
+  
+  G_LOCK (ws_stats);
+  if (_ws_stats.last_nchunks == NULL)
+  {
+    _ws_stats.last_nchunks = g_array_new (FALSE, TRUE, sizeof (gulong));
+    _ws_stats.last_nstolen = g_array_new (FALSE, TRUE, sizeof (gulong));
+    _ws_stats.last_idle    = g_array_new (FALSE, TRUE, sizeof (gdouble));
+  }
+
+  g_array_set_size (_ws_stats.last_nchunks, wsl->nworkers);
+  g_array_set_size (_ws_stats.last_nstolen, wsl->nworkers);
+  g_array_set_size (_ws_stats.last_idle,    wsl->nworkers);
+
+  _ws_stats.nloops++;
+  _ws_stats.wall += wall * 1.0e-6;
+
+  for (w = 0; w < wsl->nworkers; w++)
+  {
+    const gdouble idle = MAX (wall - wsl->busy[w], 0) * 1.0e-6;
+
+    g_array_index (_ws_stats.last_nchunks, gulong, w)  = wsl->nchunks[w];
+    g_array_index (_ws_stats.last_nstolen, gulong, w)  = wsl->nstolen[w];
+    g_array_index (_ws_stats.last_idle,    gdouble, w) = idle;
+
+    _ws_stats.nchunks += wsl->nchunks[w];
+    _ws_stats.nstolen += wsl->nstolen[w];
+    _ws_stats.idle    += idle;
+  }
+  G_UNLOCK (ws_stats);
+}
+
+/**
+ * ncm_func_eval_threaded_loop_ws_nw:
+ * @lfunc: (scope notified): #NcmFuncEvalLoop to be evaluated in threads
+ * @i: initial index
+ * @f: final index
+ * @data: pointer to be passed to @fl
+ * @nworkers: number of workers
+ * @grain: number of indexes per chunk, zero or negative means automatic
+ *
+ * Using the thread pool, evaluate @lfunc over [@i, @f) splitting the
+ * interval in chunks of @grain indexes. Each of the @nworkers workers
+ * starts with an equal share of chunks and, when its own share is
+ * exhausted, steals the remaining chunks from the other workers.
+ * This is the preferred method when the cost per index is uneven.
+ *
+ * The number of stolen chunks and the idle time per worker are
+ * accumulated and can be reported with ncm_func_eval_log_pool_stats().
+ *
+ */
+void
+ncm_func_eval_threaded_loop_ws_nw (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data, guint nworkers, glong grain)
+{
+  g_assert_cmpint (f, >, i);
+  g_assert_cmpuint (nworkers, >, 0);
+
+  if (grain <= 0)
+    grain = MAX ((f - i) / (8 * nworkers), 1);
+
+  {
+    const glong nchunks = (f - i + grain - 1) / grain;
+
+    nworkers = MIN (nworkers, nchunks);
+
+    if (nworkers == 1)
+    {
+      lfunc (i, f, data);
+      return;
+    }
+    else
+    {
+      NcmFuncEvalCtrl ctrl = {0, {NULL}, {NULL}, };
+      NcmFuncEvalWSLoop wsl;
+      GError *err = NULL;
+      gint64 t0;
+      guint w;
+
+      ncm_func_eval_get_pool ();
+
+      wsl.lfunc    = lfunc;
+      wsl.data     = data;
+      wsl.i        = i;
+      wsl.f        = f;
+      wsl.grain    = grain;
+      wsl.nworkers = nworkers;
+      wsl.queues   = g_new (NcmFuncEvalWSQueue, nworkers);
+      wsl.nchunks  = g_new0 (gulong, nworkers);
+      wsl.nstolen  = g_new0 (gulong, nworkers);
+      wsl.busy     = g_new0 (gint64, nworkers);
+
+      for (w = 0; w < nworkers; w++)
+      {
+        g_mutex_init (&wsl.queues[w].lock);
+        wsl.queues[w].next = (nchunks * w) / nworkers;
+        wsl.queues[w].last = (nchunks * (w + 1)) / nworkers;
+      }
+
+      g_mutex_init (&ctrl.update);
+      g_cond_init (&ctrl.finish);
+      ctrl.active_threads = nworkers;
+
+      t0 = g_get_monotonic_time ();
+      for (w = 0; w < nworkers; w++)
+      {
+        NcmFuncEvalLoopEval *arg = g_slice_new (NcmFuncEvalLoopEval);
+        arg->lfunc = &_ncm_func_eval_ws_worker;
+        arg->i     = w;
+        arg->f     = w + 1;
+        arg->data  = &wsl;
+        arg->ctrl  = &ctrl;
+        g_thread_pool_push (_function_thread_pool, arg, &err);
+        if (err != NULL)
+          g_error ("ncm_func_eval_threaded_loop_ws_nw: %s", err->message);
+      }
+
+      g_mutex_lock (&ctrl.update);
+      while (ctrl.active_threads != 0)
+        g_cond_wait (&ctrl.finish, &ctrl.update);
+      g_mutex_unlock (&ctrl.update);
+
+      _ncm_func_eval_ws_stats_update (&wsl, g_get_monotonic_time () - t0);
+
+      g_mutex_clear (&ctrl.update);
+      g_cond_clear (&ctrl.finish);
+
+      for (w = 0; w < nworkers; w++)
+        g_mutex_clear (&wsl.queues[w].lock);
+
+      g_free (wsl.queues);
+      g_free (wsl.nchunks);
+      g_free (wsl.nstolen);
+      g_free (wsl.busy);
+    }
+  }
+}
+
+/**
+ * ncm_func_eval_threaded_loop_ws:
+ * @lfunc: (scope notified): #NcmFuncEvalLoop to be evaluated in threads
+ * @i: initial index
+ * @f: final index
+ * @data: pointer to be passed to @fl
+ * @grain: number of indexes per chunk, zero or negative means automatic
+ *
+ * Same as ncm_func_eval_threaded_loop_ws_nw() using the maximum number
+ * of threads in the pool as the number of workers.
+ *
+ */
+void
+ncm_func_eval_threaded_loop_ws (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data, glong grain)
+{
+  ncm_func_eval_get_pool ();
+  {
+    gint nthreads = g_thread_pool_get_max_threads (_function_thread_pool);
+    ncm_func_eval_threaded_loop_ws_nw (lfunc, i, f, data, nthreads > 0 ? nthreads : NCM_THREAD_POOL_MAX, grain);
+  }
+}
+
+/**
+ * ncm_func_eval_reset_pool_stats:
+ *
+ * Resets the work-stealing loop statistics reported by
+ * ncm_func_eval_log_pool_stats().
+ *
+ */
+void
+ncm_func_eval_reset_pool_stats (void)
+{
+  G_LOCK (ws_stats);
+  _ws_stats.nloops  = 0;
+  _ws_stats.nchunks = 0;
+  _ws_stats.nstolen = 0;
+  _ws_stats.idle    = 0.0;
+  _ws_stats.wall    = 0.0;
+  if (_ws_stats.last_nchunks != NULL)
+  {
+    g_array_set_size (_ws_stats.last_nchunks, 0);
+    g_array_set_size (_ws_stats.last_nstolen, 0);
+    g_array_set_size (_ws_stats.last_idle, 0);
+  }
+  G_UNLOCK (ws_stats);
+}
+
+/**
+ * ncm_func_eval_log_pool_stats:
+ *
+ * Logs the thread pool status and the statistics accumulated by the
+ * work-stealing loops, i.e., the number of chunks executed and stolen
+ * and the idle time, both in total and per worker for the last loop.
+ *
+ */
 void 
 ncm_func_eval_log_pool_stats ()
 {
@@ -273,4 +602,23 @@ ncm_func_eval_log_pool_stats ()
   g_message  ("# NcmThreadPool:Running:     %d\n", g_thread_pool_get_num_threads (_function_thread_pool));
   g_message  ("# NcmThreadPool:Unprocessed: %d\n", g_thread_pool_unprocessed (_function_thread_pool));
   g_message  ("# NcmThreadPool:Unused:      %d\n", g_thread_pool_get_max_threads (_function_thread_pool));  
+
+  G_LOCK (ws_stats);
+  if (_ws_stats.nloops > 0)
+  {
+    guint w;
+    g_message ("# NcmThreadPool:WS Loops:     %lu\n", _ws_stats.nloops);
+    g_message ("# NcmThreadPool:WS Chunks:    %lu\n", _ws_stats.nchunks);
+    g_message ("# NcmThreadPool:WS Stolen:    %lu\n", _ws_stats.nstolen);
+    g_message ("# NcmThreadPool:WS Wall time: %.6e s\n", _ws_stats.wall);
+    g_message ("# NcmThreadPool:WS Idle time: %.6e s\n", _ws_stats.idle);
+    for (w = 0; w < _ws_stats.last_nchunks->len; w++)
+    {
+      g_message ("# NcmThreadPool:WS Last loop worker %3u: chunks %8lu stolen %8lu idle %.6e s\n", w,
+                 g_array_index (_ws_stats.last_nchunks, gulong, w),
+                 g_array_index (_ws_stats.last_nstolen, gulong, w),
+                 g_array_index (_ws_stats.last_idle, gdouble, w));
+    }
+  }
+  G_UNLOCK (ws_stats);
 }
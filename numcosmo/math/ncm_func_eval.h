@@ -34,10 +34,14 @@ G_BEGIN_DECLS
 typedef void (*NcmFuncEvalLoop) (glong i, glong f, gpointer data);
 
 void ncm_func_eval_set_max_threads (gint mt);
+void ncm_func_eval_pool_free (void);
 void ncm_func_eval_threaded_loop_nw (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data, guint nworkers);
 void ncm_func_eval_threaded_loop (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data);
 void ncm_func_eval_threaded_loop_full (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data);
+void ncm_func_eval_threaded_loop_ws_nw (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data, guint nworkers, glong grain);
+void ncm_func_eval_threaded_loop_ws (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data, glong grain);
 void ncm_func_eval_log_pool_stats (void);
+void ncm_func_eval_reset_pool_stats (void);
 
 G_END_DECLS
 
@@ -51,6 +51,7 @@ enum
   PROP_PRIORS_M2LNL,
   PROP_PRIORS_F,
   PROP_M2LNL_V,
+  PROP_PROFILE,
   PROP_SIZE,
 };
 
@@ -63,6 +64,10 @@ ncm_likelihood_init (NcmLikelihood *lh)
   lh->m2lnL_v      = NULL;
   lh->priors_f     = ncm_obj_array_sized_new (10);
   lh->priors_m2lnL = ncm_obj_array_sized_new (10);  
+  lh->profile      = FALSE;
+  lh->m2lnL_ncalls = 0;
+  lh->m2lnL_time   = 0;
+  lh->priors_time  = 0;
 }
 
 static void
@@ -103,6 +108,9 @@ _ncm_likelihood_set_property (GObject *object, guint prop_id, const GValue *valu
       }
       break;
     }
+    case PROP_PROFILE:
+      ncm_likelihood_set_profile (lh, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -129,6 +137,9 @@ _ncm_likelihood_get_property (GObject *object, guint prop_id, GValue *value, GPa
     case PROP_M2LNL_V:
       g_value_set_object (value, lh->m2lnL_v);
       break;
+    case PROP_PROFILE:
+      g_value_set_boolean (value, lh->profile);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -196,6 +207,13 @@ ncm_likelihood_class_init (NcmLikelihoodClass *klass)
                                                         "m2lnL vector",
                                                         NCM_TYPE_VECTOR,
                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_PROFILE,
+                                   g_param_spec_boolean ("profile",
+                                                         NULL,
+                                                         "Likelihood profiling",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 /**
@@ -708,6 +726,7 @@ ncm_likelihood_priors_m2lnL_vec (NcmLikelihood *lh, NcmMSet *mset, NcmVector *pr
 void
 ncm_likelihood_m2lnL_val (NcmLikelihood *lh, NcmMSet *mset, gdouble *m2lnL)
 {
+  const gint64 t0          = G_UNLIKELY (lh->profile) ? g_get_monotonic_time () : 0;
   const guint data_length  = ncm_dataset_get_length (lh->dset);
   const guint prior_length = lh->priors_f->len + lh->priors_m2lnL->len;
   const guint v_size       = prior_length + data_length;
@@ -725,20 +744,29 @@ ncm_likelihood_m2lnL_val (NcmLikelihood *lh, NcmMSet *mset, gdouble *m2lnL)
     lh->m2lnL_v = ncm_vector_new (v_size);
   }
 
+  ncm_dataset_m2lnL_vec (lh->dset, mset, lh->m2lnL_v);
+
   if (prior_length > 0)
   {
     NcmVector *priors_m2lnL_v = ncm_vector_get_subvector (lh->m2lnL_v, data_length, prior_length);
-    ncm_dataset_m2lnL_vec (lh->dset, mset, lh->m2lnL_v);
+    const gint64 t1           = G_UNLIKELY (lh->profile) ? g_get_monotonic_time () : 0;
+
     ncm_likelihood_priors_m2lnL_vec (lh, mset, priors_m2lnL_v);
+
+    if (G_UNLIKELY (lh->profile))
+      lh->priors_time += g_get_monotonic_time () - t1;
+
     ncm_vector_free (priors_m2lnL_v);
   }
-  else
-  {
-    ncm_dataset_m2lnL_vec (lh->dset, mset, lh->m2lnL_v);
-  }
 
   *m2lnL = ncm_vector_sum_cpts (lh->m2lnL_v);
 
+  if (G_UNLIKELY (lh->profile))
+  {
+    lh->m2lnL_time += g_get_monotonic_time () - t0;
+    lh->m2lnL_ncalls++;
+  }
+
   return;
 }
 
@@ -776,3 +804,106 @@ ncm_likelihood_m2lnL_val_grad (NcmLikelihood *lh, NcmMSet *mset, gdouble *m2lnL,
 
   ncm_dataset_m2lnL_val_grad (lh->dset, mset, m2lnL, grad);
 }
+
+/**
+ * ncm_likelihood_set_profile:
+ * @lh: a #NcmLikelihood
+ * @enable: whether to profile @lh
+ *
+ * Enables or disables profiling of ncm_likelihood_m2lnL_val(). This
+ * also enables the profiling of every #NcmData in the #NcmDataset, see
+ * ncm_dataset_set_profile(). The time spent in the priors and the total
+ * time of each call are accumulated in @lh.
+ *
+ * The setting is also a property, hence it is kept by the copies of @lh
+ * made through #NcmSerialize. The parallel runs gather the counters of
+ * their copies back into @lh, see ncm_likelihood_profile_add().
+ * 
+ */
+void
+ncm_likelihood_set_profile (NcmLikelihood *lh, gboolean enable)
+{
+  lh->profile = enable;
+
+  if (lh->dset != NULL)
+    ncm_dataset_set_profile (lh->dset, enable);
+}
+
+/**
+ * ncm_likelihood_get_profile:
+ * @lh: a #NcmLikelihood
+ *
+ * Returns: whether profiling is enabled in @lh.
+ */
+gboolean
+ncm_likelihood_get_profile (NcmLikelihood *lh)
+{
+  return lh->profile;
+}
+
+/**
+ * ncm_likelihood_profile_reset:
+ * @lh: a #NcmLikelihood
+ *
+ * Resets the profiling counters of @lh and of its #NcmDataset.
+ * 
+ */
+void
+ncm_likelihood_profile_reset (NcmLikelihood *lh)
+{
+  lh->m2lnL_ncalls = 0;
+  lh->m2lnL_time   = 0;
+  lh->priors_time  = 0;
+  ncm_dataset_profile_reset (lh->dset);
+}
+
+/**
+ * ncm_likelihood_profile_add:
+ * @lh: a #NcmLikelihood
+ * @lh_src: a #NcmLikelihood
+ *
+ * Adds the profiling counters of @lh_src, including the ones of its
+ * #NcmDataset, to @lh. The parallel runs (#NcmFit, #NcmFitESMCMC and
+ * #NcmFitMC) use this function to gather the counters of the copies
+ * of @lh used by each thread.
+ * 
+ */
+void
+ncm_likelihood_profile_add (NcmLikelihood *lh, NcmLikelihood *lh_src)
+{
+  lh->m2lnL_ncalls += lh_src->m2lnL_ncalls;
+  lh->m2lnL_time   += lh_src->m2lnL_time;
+  lh->priors_time  += lh_src->priors_time;
+  ncm_dataset_profile_add (lh->dset, lh_src->dset);
+}
+
+/**
+ * ncm_likelihood_log_profile:
+ * @lh: a #NcmLikelihood
+ *
+ * Prints the profiling information of @lh: the per-data report from
+ * ncm_dataset_log_profile(), the time spent in the priors and the
+ * remaining time of ncm_likelihood_m2lnL_val() not accounted by
+ * either (vector handling and the sum of the components).
+ * 
+ */
+void
+ncm_likelihood_log_profile (NcmLikelihood *lh)
+{
+  const gdouble total     = lh->m2lnL_time * 1.0e-6;
+  const gdouble priors    = lh->priors_time * 1.0e-6;
+  const gdouble data      = ncm_dataset_profile_total (lh->dset);
+  const gdouble remaining = MAX (total - priors - data, 0.0);
+
+  ncm_dataset_log_profile (lh->dset);
+
+  ncm_cfg_msg_sepa ();
+  g_message ("# Likelihood profile:\n");
+  g_message ("#   - m2lnL_val: %10lu calls, total % 12.6e s, mean % 12.6e s\n",
+             lh->m2lnL_ncalls, total, (lh->m2lnL_ncalls > 0) ? total / lh->m2lnL_ncalls : 0.0);
+  g_message ("#   - priors:    % 12.6e s (% 6.2f%%)\n", priors,    (total > 0.0) ? 100.0 * priors / total : 0.0);
+  g_message ("#   - data:      % 12.6e s (% 6.2f%%)\n", data,      (total > 0.0) ? 100.0 * data / total : 0.0);
+  g_message ("#   - remaining: % 12.6e s (% 6.2f%%)\n", remaining, (total > 0.0) ? 100.0 * remaining / total : 0.0);
+
+  return;
+}
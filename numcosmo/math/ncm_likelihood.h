@@ -59,6 +59,10 @@ struct _NcmLikelihood
   NcmObjArray *priors_f;
   NcmObjArray *priors_m2lnL;
   NcmVector *m2lnL_v;
+  gboolean profile;
+  gulong m2lnL_ncalls;
+  gint64 m2lnL_time;
+  gint64 priors_time;
 };
 
 GType ncm_likelihood_get_type (void) G_GNUC_CONST;
@@ -101,6 +105,12 @@ void ncm_likelihood_m2lnL_val (NcmLikelihood *lh, NcmMSet *mset, gdouble *m2lnL)
 void ncm_likelihood_m2lnL_grad (NcmLikelihood *lh, NcmMSet *mset, NcmVector *grad);
 void ncm_likelihood_m2lnL_val_grad (NcmLikelihood *lh, NcmMSet *mset, gdouble *m2lnL, NcmVector *grad);
 
+void ncm_likelihood_set_profile (NcmLikelihood *lh, gboolean enable);
+gboolean ncm_likelihood_get_profile (NcmLikelihood *lh);
+void ncm_likelihood_profile_reset (NcmLikelihood *lh);
+void ncm_likelihood_profile_add (NcmLikelihood *lh, NcmLikelihood *lh_src);
+void ncm_likelihood_log_profile (NcmLikelihood *lh);
+
 G_END_DECLS
 
 #endif /* _NCM_LIKELIHOOD_H_ */
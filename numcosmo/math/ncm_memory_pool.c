@@ -38,6 +38,74 @@
 
 #include "math/ncm_memory_pool.h"
 
+static void _ncm_memory_pool_tl_release (gpointer p);
+static GPrivate _ncm_memory_pool_tl = G_PRIVATE_INIT (_ncm_memory_pool_tl_release);
+
+/*
+ * Protects the back pointer of the slices reserved by the thread caches,
+ * a freed pool orphans them (slice->mp == NULL) and the slice structs are
+ * released by their threads on exit.
+ */
+G_LOCK_DEFINE_STATIC (tl_registry);
+
+static void
+_ncm_memory_pool_lock (NcmMemoryPool *mp)
+{
+  if (!g_mutex_trylock (&mp->update))
+  {
+    g_mutex_lock (&mp->update);
+    mp->n_contended++;
+  }
+}
+
+static void
+_ncm_memory_pool_tl_release (gpointer p)
+{
+  GPtrArray *tl_slices = (GPtrArray *) p;
+  guint i;
+
+  G_LOCK (tl_registry);
+  for (i = 0; i < tl_slices->len; i++)
+  {
+    NcmMemoryPoolSlice *slice = g_ptr_array_index (tl_slices, i);
+    NcmMemoryPool *mp         = slice->mp;
+
+    g_assert (!slice->tl_in_use);
+
+    if (mp == NULL)
+    {
+      /* Orphaned: the pool was freed while this thread held the slice. */
+      g_slice_free (NcmMemoryPoolSlice, slice);
+      continue;
+    }
+
+    g_mutex_lock (&mp->update);
+    mp->n_fast += slice->n_tl;
+    slice->tl     = FALSE;
+    slice->n_tl   = 0;
+    slice->in_use = FALSE;
+    g_mutex_unlock (&mp->update);
+  }
+  G_UNLOCK (tl_registry);
+
+  g_ptr_array_unref (tl_slices);
+}
+
+static NcmMemoryPoolSlice *
+_ncm_memory_pool_slice_new (NcmMemoryPool *mp, gpointer p)
+{
+  NcmMemoryPoolSlice *slice = g_slice_new (NcmMemoryPoolSlice);
+
+  slice->in_use    = FALSE;
+  slice->p         = p;
+  slice->mp        = mp;
+  slice->tl        = FALSE;
+  slice->tl_in_use = FALSE;
+  slice->n_tl      = 0;
+
+  return slice;
+}
+
 /**
  * ncm_memory_pool_new: (skip)
  * @mp_alloc: a #NcmMemoryPoolAlloc, function used to alloc memory.
@@ -64,6 +132,11 @@ ncm_memory_pool_new (NcmMemoryPoolAlloc mp_alloc, gpointer userdata, GDestroyNot
   mp->alloc         = mp_alloc;
   mp->free          = mp_free;
   mp->userdata      = userdata;
+  mp->thread_cache  = FALSE;
+  mp->tl_in_use     = 0;
+  mp->n_fast        = 0;
+  mp->n_locked      = 0;
+  mp->n_contended   = 0;
   return mp;
 }
 
@@ -76,27 +149,66 @@ ncm_memory_pool_new (NcmMemoryPoolAlloc mp_alloc, gpointer userdata, GDestroyNot
  * the slices if free_slices == TRUE and the
  * pool was built with a free function
  *
+ * If the thread cache is enabled, the slices reserved by the calling
+ * thread are released. The slices reserved by other threads must not be
+ * in use, their contents are freed and the slices are detached from the
+ * threads, which release them when they exit.
+ *
  */
 void
 ncm_memory_pool_free (NcmMemoryPool *mp, gboolean free_slices)
 {
+  GPtrArray *tl_slices = g_private_get (&_ncm_memory_pool_tl);
   guint i;
 
+  if (tl_slices != NULL)
+  {
+    i = 0;
+    while (i < tl_slices->len)
+    {
+      NcmMemoryPoolSlice *slice = g_ptr_array_index (tl_slices, i);
+      if (slice->mp == mp)
+      {
+        g_assert (!slice->tl_in_use);
+        slice->tl = FALSE;
+        g_ptr_array_remove_index_fast (tl_slices, i);
+      }
+      else
+        i++;
+    }
+  }
+
   g_mutex_lock (&mp->update);
   while (mp->slices_in_use != 0)
     g_cond_wait (&mp->finish, &mp->update);
-  
+  g_mutex_unlock (&mp->update);
+
+  /* Reserved slices are returned without locking the pool. */
+  while (g_atomic_int_get (&mp->tl_in_use) != 0)
+    g_thread_yield ();
+
+  G_LOCK (tl_registry);
+  g_mutex_lock (&mp->update);
   for (i = 0; i < mp->slices->len; i++)
   {
     NcmMemoryPoolSlice *slice = g_ptr_array_index (mp->slices, i);
     if (free_slices && mp->free)
       mp->free (slice->p);
-    g_slice_free (NcmMemoryPoolSlice, slice);
+
+    if (slice->tl)
+    {
+      /* Still referenced by another thread cache. */
+      slice->p    = NULL;
+      slice->mp   = NULL;
+    }
+    else
+      g_slice_free (NcmMemoryPoolSlice, slice);
   }
   g_ptr_array_free (mp->slices, TRUE);
   mp->slices = NULL;
 
   g_mutex_unlock (&mp->update);
+  G_UNLOCK (tl_registry);
 
   g_mutex_clear (&mp->update);
   g_cond_clear (&mp->finish);
@@ -119,10 +231,7 @@ ncm_memory_pool_set_min_size (NcmMemoryPool *mp, gsize n)
   g_mutex_lock (&mp->update);
   while (mp->slices->len < n)
   {
-    NcmMemoryPoolSlice *slice = g_slice_new (NcmMemoryPoolSlice);
-    slice->in_use = FALSE;
-    slice->p      = mp->alloc (mp->userdata);
-    slice->mp     = mp;
+    NcmMemoryPoolSlice *slice = _ncm_memory_pool_slice_new (mp, mp->alloc (mp->userdata));
     g_ptr_array_add (mp->slices, slice);
   }
   g_mutex_unlock (&mp->update);
@@ -142,15 +251,38 @@ ncm_memory_pool_add (NcmMemoryPool *mp, gpointer p)
 {
   g_mutex_lock (&mp->update);
   {
-    NcmMemoryPoolSlice *slice = g_slice_new (NcmMemoryPoolSlice);
-    slice->in_use = FALSE;
-    slice->p      = p;
-    slice->mp     = mp;
+    NcmMemoryPoolSlice *slice = _ncm_memory_pool_slice_new (mp, p);
     g_ptr_array_add (mp->slices, slice);
   }
   g_mutex_unlock (&mp->update);
 }
 
+static NcmMemoryPoolSlice *
+_ncm_memory_pool_get_unlocked (NcmMemoryPool *mp)
+{
+  NcmMemoryPoolSlice *slice = NULL;
+  guint i;
+
+  for (i = 0; i < mp->slices->len; i++)
+  {
+    NcmMemoryPoolSlice *lslice = (NcmMemoryPoolSlice *)g_ptr_array_index (mp->slices, i);
+    if (!lslice->in_use)
+    {
+      slice         = lslice;
+      slice->in_use = TRUE;
+      break;
+    }
+  }
+  if (slice == NULL)
+  {
+    slice         = _ncm_memory_pool_slice_new (mp, mp->alloc (mp->userdata));
+    slice->in_use = TRUE;
+    g_ptr_array_add (mp->slices, slice);
+  }
+
+  return slice;
+}
+
 /**
  * ncm_memory_pool_get:
  * @mp: a #NcmMemoryPool
@@ -160,34 +292,64 @@ ncm_memory_pool_add (NcmMemoryPool *mp, gpointer p)
  * allocate a new one add to the pool and
  * return it.
  *
+ * When the thread cache is enabled (see ncm_memory_pool_set_thread_cache()),
+ * the first slice requested by each thread is reserved to it and
+ * subsequent requests return it without locking the pool. Only when the
+ * thread needs more than one slice at the same time it falls back to
+ * the shared pool.
+ *
  * Returns: (transfer full): a pointer to an unused #NcmMemoryPoolSlice
  */
 gpointer
 ncm_memory_pool_get (NcmMemoryPool *mp)
 {
-  guint i;
   NcmMemoryPoolSlice *slice = NULL;
+  GPtrArray *tl_slices      = NULL;
 
-  g_mutex_lock (&mp->update);
-  for (i = 0; i < mp->slices->len; i++)
+  if (mp->thread_cache)
   {
-    NcmMemoryPoolSlice *lslice = (NcmMemoryPoolSlice *)g_ptr_array_index (mp->slices, i);
-    if (!lslice->in_use)
+    guint i;
+
+    tl_slices = g_private_get (&_ncm_memory_pool_tl);
+    if (tl_slices != NULL)
     {
-      slice         = lslice;
-      slice->in_use = TRUE;
-      break;
+      for (i = 0; i < tl_slices->len; i++)
+      {
+        NcmMemoryPoolSlice *lslice = g_ptr_array_index (tl_slices, i);
+        if (lslice->mp == mp)
+        {
+          if (!lslice->tl_in_use)
+          {
+            lslice->tl_in_use = TRUE;
+            lslice->n_tl++;
+            g_atomic_int_inc (&mp->tl_in_use);
+            return lslice;
+          }
+          tl_slices = NULL;
+          break;
+        }
+      }
+    }
+    else
+    {
+      tl_slices = g_ptr_array_new ();
+      g_private_set (&_ncm_memory_pool_tl, tl_slices);
     }
   }
-  if (slice == NULL)
+
+  _ncm_memory_pool_lock (mp);
+  slice = _ncm_memory_pool_get_unlocked (mp);
+  mp->n_locked++;
+  if (tl_slices != NULL)
   {
-    slice         = g_slice_new (NcmMemoryPoolSlice);
-    slice->in_use = TRUE;
-    slice->p      = mp->alloc (mp->userdata);
-    slice->mp     = mp;
-    g_ptr_array_add (mp->slices, slice);
+    /* First slice requested by this thread, reserve it. */
+    slice->tl        = TRUE;
+    slice->tl_in_use = TRUE;
+    g_atomic_int_inc (&mp->tl_in_use);
+    g_ptr_array_add (tl_slices, slice);
   }
-  mp->slices_in_use++;
+  else
+    mp->slices_in_use++;
   g_mutex_unlock (&mp->update);
 
   return slice;
@@ -204,7 +366,14 @@ ncm_memory_pool_return (gpointer p)
 {
   NcmMemoryPoolSlice *slice = (NcmMemoryPoolSlice *)p;
 
-  g_mutex_lock (&slice->mp->update);
+  if (slice->tl)
+  {
+    slice->tl_in_use = FALSE;
+    g_atomic_int_add (&slice->mp->tl_in_use, -1);
+    return;
+  }
+
+  _ncm_memory_pool_lock (slice->mp);
   slice->in_use = FALSE;
   slice->mp->slices_in_use--;
 
@@ -213,3 +382,83 @@ ncm_memory_pool_return (gpointer p)
 
   g_mutex_unlock (&slice->mp->update);
 }
+
+/**
+ * ncm_memory_pool_foreach: (skip)
+ * @mp: a #NcmMemoryPool
+ * @func: function called with the contents of each slice
+ * @userdata: userdata pointer for @func
+ *
+ * Calls @func for the contents of every slice allocated by @mp, in use
+ * or not. It is meant to gather information from the slices after the
+ * threads using them have finished, the slices must not be modified
+ * concurrently.
+ *
+ */
+void
+ncm_memory_pool_foreach (NcmMemoryPool *mp, GFunc func, gpointer userdata)
+{
+  guint i;
+
+  g_mutex_lock (&mp->update);
+  for (i = 0; i < mp->slices->len; i++)
+  {
+    NcmMemoryPoolSlice *slice = g_ptr_array_index (mp->slices, i);
+    func (slice->p, userdata);
+  }
+  g_mutex_unlock (&mp->update);
+}
+
+/**
+ * ncm_memory_pool_set_thread_cache:
+ * @mp: a #NcmMemoryPool
+ * @enable: whether to enable the thread cache
+ *
+ * Enables or disables the per-thread cache of @mp. When enabled, each
+ * thread reserves one slice and reuses it without locking the pool, see
+ * ncm_memory_pool_get(). A reserved slice must be returned by the same
+ * thread which requested it. The reserved slices are released when
+ * their threads exit. If the pool is freed before, the reserved slices
+ * are detached from their threads, see ncm_memory_pool_free().
+ *
+ * Disabling the cache does not release the slices already reserved.
+ *
+ */
+void
+ncm_memory_pool_set_thread_cache (NcmMemoryPool *mp, gboolean enable)
+{
+  g_mutex_lock (&mp->update);
+  mp->thread_cache = enable;
+  g_mutex_unlock (&mp->update);
+}
+
+/**
+ * ncm_memory_pool_get_stats:
+ * @mp: a #NcmMemoryPool
+ * @n_fast: (out): number of slices obtained from the thread cache
+ * @n_locked: (out): number of slices obtained locking the pool
+ * @n_contended: (out): number of times the pool lock was already taken
+ *
+ * Gets the usage statistics of @mp. The number of slices obtained from
+ * the thread cache is a snapshot, the counters of the threads currently
+ * running are read without synchronization.
+ *
+ */
+void
+ncm_memory_pool_get_stats (NcmMemoryPool *mp, gulong *n_fast, gulong *n_locked, gulong *n_contended)
+{
+  guint i;
+
+  g_mutex_lock (&mp->update);
+  *n_fast      = mp->n_fast;
+  *n_locked    = mp->n_locked;
+  *n_contended = mp->n_contended;
+
+  for (i = 0; i < mp->slices->len; i++)
+  {
+    NcmMemoryPoolSlice *slice = g_ptr_array_index (mp->slices, i);
+    if (slice->tl)
+      *n_fast += slice->n_tl;
+  }
+  g_mutex_unlock (&mp->update);
+}
@@ -51,6 +51,11 @@ struct _NcmMemoryPool
   NcmMemoryPoolAlloc alloc;
   GDestroyNotify free;
   gpointer userdata;
+  gboolean thread_cache;
+  gint tl_in_use;
+  gulong n_fast;
+  gulong n_locked;
+  gulong n_contended;
 };
 
 typedef struct _NcmMemoryPoolSlice NcmMemoryPoolSlice;
@@ -60,12 +65,18 @@ typedef struct _NcmMemoryPoolSlice NcmMemoryPoolSlice;
  * @p: Pointer to the actual slice.
  * @in_use: Boolean determining if the slice is in use.
  * @mp: A back pointer to the pool.
+ * @tl: Boolean determining if the slice is reserved to a thread.
+ * @tl_in_use: Boolean determining if the reserved slice is in use by its thread.
+ * @n_tl: Number of times the reserved slice was used by its thread.
  */
 struct _NcmMemoryPoolSlice
 {
   gpointer p;
   gboolean in_use;
   NcmMemoryPool *mp;
+  gboolean tl;
+  gboolean tl_in_use;
+  gulong n_tl;
 };
 
 NcmMemoryPool *ncm_memory_pool_new (NcmMemoryPoolAlloc mp_alloc, gpointer userdata, GDestroyNotify mp_free);
@@ -75,6 +86,10 @@ void ncm_memory_pool_set_min_size (NcmMemoryPool *mp, gsize n);
 void ncm_memory_pool_add (NcmMemoryPool *mp, gpointer p);
 gpointer ncm_memory_pool_get (NcmMemoryPool *mp);
 void ncm_memory_pool_return (gpointer p);
+void ncm_memory_pool_foreach (NcmMemoryPool *mp, GFunc func, gpointer userdata);
+
+void ncm_memory_pool_set_thread_cache (NcmMemoryPool *mp, gboolean enable);
+void ncm_memory_pool_get_stats (NcmMemoryPool *mp, gulong *n_fast, gulong *n_locked, gulong *n_contended);
 
 G_END_DECLS
 
@@ -76,6 +76,7 @@ ncm_model_init (NcmModel *model)
 
   model->pkey    = 1;
   model->skey    = 0;
+  model->okey    = 0;
   model->reparam = NULL;
   model->ptypes  = g_array_new (FALSE, TRUE, sizeof (NcmParamType));
 
@@ -1424,7 +1425,9 @@ ncm_model_check_impl_opts (NcmModel *model, gint opt1, ...)
  * ncm_model_state_mark_outdated:
  * @model: a #NcmModel
  *
- * FIXME
+ * Marks the model state as outdated without changing any parameter,
+ * this also invalidates every #NcmModelCtrl restricted to a subset
+ * of the parameters, see ncm_model_ctrl_add_param_dep().
  *
  */
 /**
@@ -98,6 +98,7 @@ struct _NcmModel
   guint total_len;
   guint64 pkey;
   guint64 skey;
+  guint64 okey;
 };
 
 typedef gdouble (*NcmModelFunc0) (NcmModel *model);
@@ -370,6 +371,7 @@ G_INLINE_FUNC void
 ncm_model_state_mark_outdated (NcmModel *model)
 {
   model->pkey++;
+  model->okey++;
 }
 
 G_INLINE_FUNC guint
@@ -29,6 +29,13 @@
  *
  * FIXME
  *
+ * By default any parameter change in the main model is reported as an
+ * update. A control object can be restricted to a subset of the main model
+ * parameters using ncm_model_ctrl_add_param_dep(), in this case
+ * ncm_model_ctrl_update() compares the current values of these parameters
+ * with the ones seen in the last update and reports no update when only
+ * other parameters moved. Submodels are always tracked as a whole.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -57,6 +64,10 @@ ncm_model_ctrl_init (NcmModelCtrl *ctrl)
   g_ptr_array_set_free_func (ctrl->submodel_ctrl, (GDestroyNotify) ncm_model_ctrl_free);
 
   ctrl->submodel_last_update = g_array_new (TRUE, TRUE, sizeof (gboolean));
+
+  ctrl->okey           = 0;
+  ctrl->param_deps     = g_array_new (FALSE, FALSE, sizeof (guint));
+  ctrl->param_deps_val = g_array_new (FALSE, FALSE, sizeof (gdouble));
 }
 
 static void
@@ -68,6 +79,8 @@ ncm_model_ctrl_dispose (GObject *object)
 
   g_clear_pointer (&ctrl->submodel_ctrl, g_ptr_array_unref);
   g_clear_pointer (&ctrl->submodel_last_update, g_array_unref);
+  g_clear_pointer (&ctrl->param_deps, g_array_unref);
+  g_clear_pointer (&ctrl->param_deps_val, g_array_unref);
 
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_model_ctrl_parent_class)->dispose (object);
@@ -209,6 +222,27 @@ ncm_model_ctrl_new (NcmModel *model)
  * Returns: TRUE if the submodel with @mid inside the ctrl model was updated.
  */
 
+static void
+_ncm_model_ctrl_param_deps_snapshot (NcmModelCtrl *ctrl, NcmModel *model)
+{
+  const guint len = ncm_model_len (model);
+  guint i;
+
+  ctrl->okey = model->okey;
+  g_array_set_size (ctrl->param_deps_val, ctrl->param_deps->len);
+
+  for (i = 0; i < ctrl->param_deps->len; i++)
+  {
+    const guint n = g_array_index (ctrl->param_deps, guint, i);
+
+    if (n >= len)
+      g_error ("ncm_model_ctrl: parameter dependency %u out of range, model `%s' has %u parameters.",
+               n, G_OBJECT_TYPE_NAME (model), len);
+
+    g_array_index (ctrl->param_deps_val, gdouble, i) = ncm_model_orig_param_get (model, n);
+  }
+}
+
 /**
  * ncm_model_ctrl_set_model:
  * @ctrl: a #NcmModelCtrl
@@ -229,6 +263,9 @@ ncm_model_ctrl_set_model (NcmModelCtrl *ctrl, NcmModel *model)
     g_weak_ref_set (&ctrl->model_wr, model);
     ctrl->pkey  = model->pkey;
     up          = TRUE;
+
+    if (ctrl->param_deps->len > 0)
+      _ncm_model_ctrl_param_deps_snapshot (ctrl, model);
   }
 
   {
@@ -295,6 +332,152 @@ ncm_model_ctrl_force_update (NcmModelCtrl *ctrl)
   return;
 }
 
+/**
+ * ncm_model_ctrl_add_param_dep:
+ * @ctrl: a #NcmModelCtrl
+ * @i: original parameter index
+ *
+ * Declares that the object controlled by @ctrl depends on the
+ * @i-th original parameter of the main model. Once at least one
+ * dependency is declared, ncm_model_ctrl_update() reports an update
+ * of the main model only when one of these parameters changed (or
+ * when the model was marked outdated by ncm_model_state_mark_outdated()).
+ * It also forces an update in the next call.
+ *
+ * The dependencies are not checked against the object computations, it
+ * is the caller's responsibility to declare every parameter the object
+ * depends on. Objects that expose this function through a wrapper also
+ * expose the dependencies as a property, see ncm_model_ctrl_get_param_deps(),
+ * so that they survive serialization and duplication.
+ *
+ */
+void
+ncm_model_ctrl_add_param_dep (NcmModelCtrl *ctrl, const guint i)
+{
+  guint j;
+
+  for (j = 0; j < ctrl->param_deps->len; j++)
+  {
+    if (g_array_index (ctrl->param_deps, guint, j) == i)
+      return;
+  }
+
+  g_array_append_val (ctrl->param_deps, i);
+  ncm_model_ctrl_force_update (ctrl);
+}
+
+/**
+ * ncm_model_ctrl_clear_param_deps:
+ * @ctrl: a #NcmModelCtrl
+ *
+ * Removes all parameter dependencies, after this call any parameter
+ * change is reported as an update. It also forces an update in the
+ * next call.
+ *
+ */
+void
+ncm_model_ctrl_clear_param_deps (NcmModelCtrl *ctrl)
+{
+  g_array_set_size (ctrl->param_deps, 0);
+  g_array_set_size (ctrl->param_deps_val, 0);
+  ncm_model_ctrl_force_update (ctrl);
+}
+
+/**
+ * ncm_model_ctrl_param_deps_len:
+ * @ctrl: a #NcmModelCtrl
+ *
+ * Returns: the number of parameter dependencies declared in @ctrl,
+ * zero means that @ctrl depends on all parameters.
+ */
+guint
+ncm_model_ctrl_param_deps_len (NcmModelCtrl *ctrl)
+{
+  return ctrl->param_deps->len;
+}
+
+/**
+ * ncm_model_ctrl_get_param_deps:
+ * @ctrl: a #NcmModelCtrl
+ *
+ * Gets the parameter dependencies of @ctrl as a #GVariant of type "au",
+ * an empty array means that @ctrl depends on all parameters.
+ *
+ * Returns: (transfer full): the parameter dependencies of @ctrl.
+ */
+GVariant *
+ncm_model_ctrl_get_param_deps (NcmModelCtrl *ctrl)
+{
+  return g_variant_ref_sink (g_variant_new_fixed_array (G_VARIANT_TYPE ("u"),
+                                                        ctrl->param_deps->data,
+                                                        ctrl->param_deps->len,
+                                                        sizeof (guint)));
+}
+
+/**
+ * ncm_model_ctrl_set_param_deps:
+ * @ctrl: a #NcmModelCtrl
+ * @deps: a #GVariant of type "au"
+ *
+ * Replaces the parameter dependencies of @ctrl by the indexes in @deps,
+ * see ncm_model_ctrl_add_param_dep().
+ *
+ */
+void
+ncm_model_ctrl_set_param_deps (NcmModelCtrl *ctrl, GVariant *deps)
+{
+  const guint n = g_variant_n_children (deps);
+  guint i;
+
+  g_assert (g_variant_is_of_type (deps, G_VARIANT_TYPE ("au")));
+
+  ncm_model_ctrl_clear_param_deps (ctrl);
+  for (i = 0; i < n; i++)
+  {
+    guint j = 0;
+    g_variant_get_child (deps, i, "u", &j);
+    ncm_model_ctrl_add_param_dep (ctrl, j);
+  }
+}
+
+/**
+ * ncm_model_ctrl_param_deps_changed:
+ * @ctrl: a #NcmModelCtrl
+ * @model: a #NcmModel
+ *
+ * Compares the parameters @ctrl depends on with the values seen in the
+ * last call and stores the current ones. This function is called by
+ * ncm_model_ctrl_update() whenever the main model parameters changed.
+ *
+ * Returns: whether any of the dependencies of @ctrl changed.
+ */
+gboolean
+ncm_model_ctrl_param_deps_changed (NcmModelCtrl *ctrl, NcmModel *model)
+{
+  gboolean changed = (ctrl->okey != model->okey) || (ctrl->param_deps_val->len != ctrl->param_deps->len);
+
+  if (!changed)
+  {
+    guint i;
+
+    for (i = 0; i < ctrl->param_deps->len; i++)
+    {
+      const guint n = g_array_index (ctrl->param_deps, guint, i);
+
+      if (n >= ncm_model_len (model) || ncm_model_orig_param_get (model, n) != g_array_index (ctrl->param_deps_val, gdouble, i))
+      {
+        changed = TRUE;
+        break;
+      }
+    }
+  }
+
+  if (changed)
+    _ncm_model_ctrl_param_deps_snapshot (ctrl, model);
+
+  return changed;
+}
+
 /**
  * ncm_model_ctrl_free:
  * @ctrl: a #NcmModelCtrl
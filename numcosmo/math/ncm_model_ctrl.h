@@ -55,9 +55,12 @@ struct _NcmModelCtrl
   GObject parent_instance;
   GWeakRef model_wr;
   gulong pkey;
+  guint64 okey;
   gboolean last_update;
   GPtrArray *submodel_ctrl;
   GArray *submodel_last_update;
+  GArray *param_deps;
+  GArray *param_deps_val;
 };
 
 GType ncm_model_ctrl_get_type (void) G_GNUC_CONST;
@@ -65,6 +68,12 @@ GType ncm_model_ctrl_get_type (void) G_GNUC_CONST;
 NcmModelCtrl *ncm_model_ctrl_new (NcmModel *model);
 gboolean ncm_model_ctrl_set_model (NcmModelCtrl *ctrl, NcmModel *model);
 void ncm_model_ctrl_force_update (NcmModelCtrl *ctrl);
+void ncm_model_ctrl_add_param_dep (NcmModelCtrl *ctrl, const guint i);
+void ncm_model_ctrl_clear_param_deps (NcmModelCtrl *ctrl);
+guint ncm_model_ctrl_param_deps_len (NcmModelCtrl *ctrl);
+GVariant *ncm_model_ctrl_get_param_deps (NcmModelCtrl *ctrl);
+void ncm_model_ctrl_set_param_deps (NcmModelCtrl *ctrl, GVariant *deps);
+gboolean ncm_model_ctrl_param_deps_changed (NcmModelCtrl *ctrl, NcmModel *model);
 void ncm_model_ctrl_free (NcmModelCtrl *ctrl);
 void ncm_model_ctrl_clear (NcmModelCtrl **ctrl);
 
@@ -107,7 +116,7 @@ ncm_model_ctrl_update (NcmModelCtrl *ctrl, NcmModel *model)
   else if (ctrl->pkey != model->pkey)
   {
     ctrl->pkey = model->pkey;
-    ctrl->last_update = TRUE;
+    ctrl->last_update = (ctrl->param_deps->len == 0) ? TRUE : ncm_model_ctrl_param_deps_changed (ctrl, model);
   }
   up = up || ctrl->last_update;
 
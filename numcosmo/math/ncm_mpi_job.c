@@ -40,6 +40,7 @@
 
 #include "math/ncm_mpi_job.h"
 #include "math/ncm_memory_pool.h"
+#include "math/ncm_cfg.h"
 
 #ifndef HAVE_MPI
 #define MPI_DATATYPE_NULL (0)
@@ -60,12 +61,24 @@ struct _NcmMPIJobPrivate
 	NcmMemoryPool *return_buf_pool;
 	GHashTable *input_buf_table;
 	GHashTable *return_buf_table;
+	guint max_inflight;
+	GArray *slave_stats;
 };
 
+typedef struct _NcmMPIJobSlaveStats
+{
+	guint njobs;
+	gint64 latency;
+	gint64 latency_max;
+	gint64 first_dispatch;
+	gint64 last_return;
+} NcmMPIJobSlaveStats;
+
 enum
 {
 	PROP_0,
 	PROP_PLACEHOLDER,
+	PROP_MAX_INFLIGHT,
 };
 
 extern NcmMPIJobCtrl _mpi_ctrl;
@@ -93,6 +106,8 @@ ncm_mpi_job_init (NcmMPIJob *mpi_job)
 	self->return_buf_pool  = ncm_memory_pool_new (_ncm_mpi_job_create_return_buffer, mpi_job, _ncm_mpi_job_destroy_buffer);
 	self->input_buf_table  = g_hash_table_new (g_direct_hash, g_direct_equal);
 	self->return_buf_table = g_hash_table_new (g_direct_hash, g_direct_equal);
+	self->max_inflight     = 0;
+	self->slave_stats      = g_array_new (FALSE, TRUE, sizeof (NcmMPIJobSlaveStats));
 }
 
 static gpointer 
@@ -131,6 +146,9 @@ _ncm_mpi_job_set_property (GObject *object, guint prop_id, const GValue *value,
 		case PROP_PLACEHOLDER:
 			self->placeholder = g_value_get_uint (value);
 			break;
+		case PROP_MAX_INFLIGHT:
+			ncm_mpi_job_set_max_inflight (mpi_job, g_value_get_uint (value));
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -149,6 +167,9 @@ _ncm_mpi_job_get_property (GObject *object, guint prop_id, GValue *value, GParam
 		case PROP_PLACEHOLDER:
 			g_value_set_uint (value, self->placeholder);
 			break;
+		case PROP_MAX_INFLIGHT:
+			g_value_set_uint (value, ncm_mpi_job_get_max_inflight (mpi_job));
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -177,6 +198,7 @@ _ncm_mpi_job_dispose (GObject *object)
 
 	g_clear_pointer (&self->input_buf_table, g_hash_table_unref);
 	g_clear_pointer (&self->return_buf_table, g_hash_table_unref);
+	g_clear_pointer (&self->slave_stats, g_array_unref);
 	
 	/* Chain up : end */
 	G_OBJECT_CLASS (ncm_mpi_job_parent_class)->dispose (object);
@@ -238,6 +260,13 @@ ncm_mpi_job_class_init (NcmMPIJobClass *klass)
 	                                                    "placeholder",
 	                                                    0, G_MAXUINT, 0,
 	                                                    G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+	g_object_class_install_property (object_class,
+	                                 PROP_MAX_INFLIGHT,
+	                                 g_param_spec_uint ("max-inflight",
+	                                                    NULL,
+	                                                    "Maximum number of jobs in flight per slave in the asynchronous queue",
+	                                                    1, G_MAXUINT, 2,
+	                                                    G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 
 	klass->work_init             = NULL;
 	klass->work_clear            = NULL;
@@ -353,6 +382,40 @@ ncm_mpi_job_clear (NcmMPIJob **mpi_job)
   g_clear_object (mpi_job);
 }
 
+/**
+ * ncm_mpi_job_set_max_inflight:
+ * @mpi_job: a #NcmMPIJob
+ * @max_inflight: maximum number of jobs in flight per slave
+ *
+ * Sets the maximum number of jobs sent to a single slave and not yet
+ * returned when using ncm_mpi_job_run_array_async(). Values larger
+ * than one keep the slaves busy while the master processes the
+ * returns.
+ *
+ */
+void
+ncm_mpi_job_set_max_inflight (NcmMPIJob *mpi_job, const guint max_inflight)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+
+	g_assert_cmpuint (max_inflight, >, 0);
+	self->max_inflight = max_inflight;
+}
+
+/**
+ * ncm_mpi_job_get_max_inflight:
+ * @mpi_job: a #NcmMPIJob
+ *
+ * Returns: the maximum number of jobs in flight per slave.
+ */
+guint
+ncm_mpi_job_get_max_inflight (NcmMPIJob *mpi_job)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+
+	return self->max_inflight;
+}
+
 /**
  * ncm_mpi_job_work_init: (virtual work_init)
  * @mpi_job: a #NcmMPIJob
@@ -828,11 +891,291 @@ ncm_mpi_job_run_array (NcmMPIJob *mpi_job, GPtrArray *input_array, GPtrArray *re
 #endif /* HAVE_MPI */
 }
 
+static NcmMPIJobSlaveStats *
+_ncm_mpi_job_peek_stats (NcmMPIJob *mpi_job, const gint slave_id)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+
+	if (self->slave_stats->len <= (guint) slave_id)
+		g_array_set_size (self->slave_stats, slave_id + 1);
+
+	return &g_array_index (self->slave_stats, NcmMPIJobSlaveStats, slave_id);
+}
+
+static void
+_ncm_mpi_job_stats_add (NcmMPIJob *mpi_job, const gint slave_id, const gint64 t_dispatch, const gint64 t_return)
+{
+	NcmMPIJobSlaveStats *stats = _ncm_mpi_job_peek_stats (mpi_job, slave_id);
+	const gint64 latency       = t_return - t_dispatch;
+
+	if (stats->njobs == 0)
+		stats->first_dispatch = t_dispatch;
+
+	stats->njobs++;
+	stats->latency     += latency;
+	stats->latency_max  = MAX (stats->latency_max, latency);
+	stats->last_return  = t_return;
+}
+
+#ifdef HAVE_MPI
+typedef struct _NcmMPIJobAsyncJob
+{
+	guint index;
+	gpointer buf;
+	gint64 t_dispatch;
+} NcmMPIJobAsyncJob;
+
+typedef struct _NcmMPIJobAsyncSend
+{
+	gpointer input;
+	gpointer buf;
+} NcmMPIJobAsyncSend;
+
+typedef struct _NcmMPIJobAsync
+{
+	GPtrArray *input_array;
+	GPtrArray *ret_array;
+	guint max_inflight;
+	MPI_Request *ret_req;
+	NcmMPIJobAsyncJob *jd;
+	GArray *send_req;
+	GArray *send_desc;
+	GPtrArray *cmd_array;
+} NcmMPIJobAsync;
+
+/*
+ * Sends the job number index to the slave owning the slot and posts the
+ * corresponding receive. Slot s belongs to the slave s / max_inflight + 1.
+ *
+ */
+static void
+_ncm_mpi_job_async_dispatch (NcmMPIJob *mpi_job, NcmMPIJobAsync *aq, const guint slot, const guint index)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+	const gint slave_id   = (slot / aq->max_inflight) + 1;
+	gpointer input        = g_ptr_array_index (aq->input_array, index);
+	gpointer ret          = g_ptr_array_index (aq->ret_array, index);
+	gint *cmd             = g_new (gint, 1);
+	NcmMPIJobAsyncJob *jd = &aq->jd[slot];
+	MPI_Request request;
+
+	*cmd = NCM_MPI_CTRL_SLAVE_WORK;
+	g_ptr_array_add (aq->cmd_array, cmd);
+
+	{
+		NcmMPIJobAsyncSend sd = {NULL, NULL};
+		MPI_Isend (cmd, 1, MPI_INT, slave_id, NCM_MPI_CTRL_TAG_CMD, MPI_COMM_WORLD, &request);
+		g_array_append_val (aq->send_req, request);
+		g_array_append_val (aq->send_desc, sd);
+	}
+
+	{
+		NcmMPIJobAsyncSend sd = {input, ncm_mpi_job_pack_input (mpi_job, input)};
+		MPI_Isend (sd.buf, self->input_len, self->input_dtype, slave_id, NCM_MPI_CTRL_TAG_WORK_INPUT, MPI_COMM_WORLD, &request);
+		g_array_append_val (aq->send_req, request);
+		g_array_append_val (aq->send_desc, sd);
+	}
+
+	jd->index      = index;
+	jd->buf        = ncm_mpi_job_get_return_buffer (mpi_job, ret);
+	jd->t_dispatch = g_get_monotonic_time ();
+
+	MPI_Irecv (jd->buf, self->return_len, self->return_dtype, slave_id, NCM_MPI_CTRL_TAG_WORK_RETURN, MPI_COMM_WORLD, &aq->ret_req[slot]);
+}
+
+/*
+ * Releases the input buffers of the completed sends, waiting for all
+ * of them when wait is TRUE.
+ *
+ */
+static void
+_ncm_mpi_job_async_test_sends (NcmMPIJob *mpi_job, NcmMPIJobAsync *aq, gboolean wait)
+{
+	gint j;
+
+	if (wait)
+		MPI_Waitall (aq->send_req->len, (MPI_Request *) aq->send_req->data, MPI_STATUSES_IGNORE);
+
+	for (j = aq->send_req->len - 1; j >= 0; j--)
+	{
+		gint done = 0;
+
+		if (wait)
+			done = 1;
+		else
+			MPI_Test (&g_array_index (aq->send_req, MPI_Request, j), &done, MPI_STATUS_IGNORE);
+
+		if (done)
+		{
+			NcmMPIJobAsyncSend sd = g_array_index (aq->send_desc, NcmMPIJobAsyncSend, j);
+
+			g_array_remove_index_fast (aq->send_req,  j);
+			g_array_remove_index_fast (aq->send_desc, j);
+
+			if (sd.buf != NULL)
+				ncm_mpi_job_destroy_input_buffer (mpi_job, sd.input, sd.buf);
+		}
+	}
+}
+#endif /* HAVE_MPI */
+
+/**
+ * ncm_mpi_job_run_array_async:
+ * @mpi_job: a #NcmMPIJob
+ * @input_array: (array) (element-type GObject): an array of input pointers
+ * @ret_array: (array) (element-type GObject): an array of (allocated) return pointers
+ * @cb: (scope call) (nullable): a #NcmMPIJobCallback
+ * @user_data: (nullable): user data passed to @cb
+ * 
+ * Same as ncm_mpi_job_run_array() but the jobs are distributed through a queue.
+ * Each slave keeps at most ncm_mpi_job_get_max_inflight() jobs in flight and
+ * receives a new one as soon as one of its jobs returns, so faster slaves
+ * process more jobs. The master only dispatches jobs and collects their
+ * returns, it never runs a job itself while slaves are available. When
+ * @cb is not NULL it is called, in the master, as soon as each job is
+ * finished.
+ * 
+ */
+void
+ncm_mpi_job_run_array_async (NcmMPIJob *mpi_job, GPtrArray *input_array, GPtrArray *ret_array, NcmMPIJobCallback cb, gpointer user_data)
+{
+#ifdef HAVE_MPI
+	g_assert_cmpint (_mpi_ctrl.rank, ==, NCM_MPI_CTRL_MASTER_ID);
+	g_assert_cmpuint (input_array->len, ==, ret_array->len);
+	if (_mpi_ctrl.size > 1)
+	{
+		NcmMPIJobPrivate * const self = mpi_job->priv;
+		const guint njobs         = input_array->len;
+		const guint max_inflight  = self->max_inflight;
+		const guint nslots        = _mpi_ctrl.nslaves * max_inflight;
+		NcmMPIJobAsync aq;
+		guint next                = 0;
+		guint finished            = 0;
+		guint i;
+
+		aq.input_array  = input_array;
+		aq.ret_array    = ret_array;
+		aq.max_inflight = max_inflight;
+		aq.ret_req      = g_new (MPI_Request, nslots);
+		aq.jd           = g_new0 (NcmMPIJobAsyncJob, nslots);
+		aq.send_req     = g_array_new (FALSE, TRUE, sizeof (MPI_Request));
+		aq.send_desc    = g_array_new (FALSE, TRUE, sizeof (NcmMPIJobAsyncSend));
+		aq.cmd_array    = g_ptr_array_new_with_free_func (g_free);
+
+		for (i = 0; i < nslots; i++)
+			aq.ret_req[i] = MPI_REQUEST_NULL;
+
+		/* Fill the queue of every slave */
+		for (i = 0; (i < nslots) && (next < njobs); i++)
+		{
+			_ncm_mpi_job_async_dispatch (mpi_job, &aq, i, next);
+			next++;
+		}
+
+		/*
+		 * The master is a pure dispatcher, running a job locally would
+		 * leave every slave that returns meanwhile idle until the local
+		 * job ends.
+		 */
+		while (finished < njobs)
+		{
+			gint slot = MPI_UNDEFINED;
+			NcmMPIJobAsyncJob *jd;
+			gpointer input, ret;
+			guint index;
+
+			MPI_Waitany (nslots, aq.ret_req, &slot, MPI_STATUS_IGNORE);
+			g_assert_cmpint (slot, !=, MPI_UNDEFINED);
+
+			jd    = &aq.jd[slot];
+			index = jd->index;
+			input = g_ptr_array_index (input_array, index);
+			ret   = g_ptr_array_index (ret_array, index);
+
+			_ncm_mpi_job_stats_add (mpi_job, (slot / max_inflight) + 1, jd->t_dispatch, g_get_monotonic_time ());
+
+			ncm_mpi_job_unpack_return (mpi_job, jd->buf, ret);
+			ncm_mpi_job_destroy_return_buffer (mpi_job, ret, jd->buf);
+			jd->buf = NULL;
+
+			if (cb != NULL)
+				cb (mpi_job, input, ret, index, user_data);
+
+			finished++;
+
+			if (next < njobs)
+			{
+				_ncm_mpi_job_async_dispatch (mpi_job, &aq, slot, next);
+				next++;
+			}
+
+			_ncm_mpi_job_async_test_sends (mpi_job, &aq, FALSE);
+		}
+
+		_ncm_mpi_job_async_test_sends (mpi_job, &aq, TRUE);
+
+		g_free (aq.ret_req);
+		g_free (aq.jd);
+		g_array_unref (aq.send_req);
+		g_array_unref (aq.send_desc);
+		g_ptr_array_unref (aq.cmd_array);
+
+		return;
+	}
+	else
+	{
+		const guint njobs = input_array->len;
+		guint i;
+
+		for (i = 0; i < njobs; i++)
+		{
+			gpointer input = g_ptr_array_index (input_array, i);
+			gpointer ret   = g_ptr_array_index (ret_array, i);
+			ncm_mpi_job_run (mpi_job, input, ret);
+
+			if (cb != NULL)
+				cb (mpi_job, input, ret, i, user_data);
+		}
+
+		return;
+	}
+#else
+	g_error ("ncm_mpi_job_run_array_async: MPI unsupported.");
+	return;
+#endif /* HAVE_MPI */
+}
+
+static void
+_ncm_mpi_job_log_slave_stats (NcmMPIJob *mpi_job)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+	guint i;
+
+	for (i = 0; i < self->slave_stats->len; i++)
+	{
+		NcmMPIJobSlaveStats *stats = &g_array_index (self->slave_stats, NcmMPIJobSlaveStats, i);
+
+		if (stats->njobs > 0)
+		{
+			const gdouble span = (stats->last_return - stats->first_dispatch) * 1.0e-6;
+			ncm_message ("# NcmMPIJob[%3u] jobs: %8u, throughput: % 12.5g jobs/s, mean latency: % 12.5g s, max latency: % 12.5g s.\n",
+			             i,
+			             stats->njobs,
+			             (span > 0.0) ? stats->njobs / span : 0.0,
+			             stats->latency * 1.0e-6 / stats->njobs,
+			             stats->latency_max * 1.0e-6);
+		}
+	}
+
+	g_array_set_size (self->slave_stats, 0);
+}
+
 /**
  * ncm_mpi_job_free_all_slaves:
  * @mpi_job: a #NcmMPIJob
  * 
- * Frees all available slaves used by @mpi_job.
+ * Frees all available slaves used by @mpi_job. The per-slave statistics
+ * collected by ncm_mpi_job_run_array_async() are logged and reset.
  * 
  */
 void 
@@ -853,6 +1196,8 @@ ncm_mpi_job_free_all_slaves (NcmMPIJob *mpi_job)
 
 		g_assert_cmpuint (self->owned_slaves, ==, _mpi_ctrl.nslaves);
 
+		_ncm_mpi_job_log_slave_stats (mpi_job);
+
 		for (i = 0; i < _mpi_ctrl.nslaves; i++)
 		{
 			gint slave_id = i + 1;
@@ -138,6 +138,19 @@ typedef enum _NcmMPIJobCtrlTag
 	NCM_MPI_CTRL_TAG_LEN, /*< skip >*/
 } NcmMPIJobCtrlTag;
 
+/**
+ * NcmMPIJobCallback:
+ * @mpi_job: a #NcmMPIJob
+ * @input: the job input
+ * @ret: the job return
+ * @index: the index of the job in the input array
+ * @user_data: (nullable): user data
+ * 
+ * Called by ncm_mpi_job_run_array_async() when a job is finished.
+ * 
+ */
+typedef void (*NcmMPIJobCallback) (NcmMPIJob *mpi_job, gpointer input, gpointer ret, const guint index, gpointer user_data);
+
 /**************************************************************************************/
 
 GType ncm_mpi_job_get_type (void) G_GNUC_CONST;
@@ -147,6 +160,9 @@ NcmMPIJob *ncm_mpi_job_ref (NcmMPIJob *mpi_job);
 void ncm_mpi_job_free (NcmMPIJob *mpi_job);
 void ncm_mpi_job_clear (NcmMPIJob **mpi_job);
 
+void ncm_mpi_job_set_max_inflight (NcmMPIJob *mpi_job, const guint max_inflight);
+guint ncm_mpi_job_get_max_inflight (NcmMPIJob *mpi_job);
+
 void ncm_mpi_job_work_init (NcmMPIJob *mpi_job);
 void ncm_mpi_job_work_clear (NcmMPIJob *mpi_job);
 
@@ -175,6 +191,7 @@ void ncm_mpi_job_run (NcmMPIJob *mpi_job, gpointer input, gpointer ret);
 
 void ncm_mpi_job_init_all_slaves (NcmMPIJob *mpi_job, NcmSerialize *ser);
 void ncm_mpi_job_run_array (NcmMPIJob *mpi_job, GPtrArray *input_array, GPtrArray *ret_array);
+void ncm_mpi_job_run_array_async (NcmMPIJob *mpi_job, GPtrArray *input_array, GPtrArray *ret_array, NcmMPIJobCallback cb, gpointer user_data);
 
 void ncm_mpi_job_free_all_slaves (NcmMPIJob *mpi_job);
 
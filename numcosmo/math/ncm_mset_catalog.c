@@ -29,7 +29,13 @@
  * @short_description: Ordered catalog of different NcmMSet parameter values.
  *
  * This class defines a catalog type object. This object can automatically synchronize
- * with a fits file (thought cfitsio).
+ * with a fits file (thought cfitsio) or with a binary columnar file. The format is
+ * chosen by the file extension, files ending with #NCM_MSET_CATALOG_BIN_EXT use the
+ * binary format and any other name uses fits (default). The binary format stores
+ * the data in append-only blocks of contiguous columns and it is memory mapped when
+ * read, which makes loading large catalogs much faster. It does not depend on
+ * cfitsio. A catalog can be converted between the two formats by loading it and
+ * calling ncm_mset_catalog_set_file() with a filename of the other format.
  *
  * For Mote Carlo studies, like resampling from a fiducial model or bootstrap, it is used
  * to save the best-fitting values of each realization. Since the order of the
@@ -67,11 +73,19 @@
 #include <gsl/gsl_vector_complex.h>
 #include <gsl/gsl_cdf.h>
 #include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <glib/gstdio.h>
 #ifdef NUMCOSMO_HAVE_CFITSIO
 #include <fitsio.h>
 #endif /* NUMCOSMO_HAVE_CFITSIO */
 #endif /* NUMCOSMO_GIR_SCAN */
 
+typedef struct _NcmMSetCatalogBin NcmMSetCatalogBin;
+typedef struct _NcmMSetCatalogBM NcmMSetCatalogBM;
+
 struct _NcmMSetCatalogPrivate
 {
   NcmMSet *mset;
@@ -89,6 +103,7 @@ struct _NcmMSetCatalogPrivate
   NcmMSetCatalogSync smode;
   gboolean readonly;
   NcmRNG *rng;
+  gboolean rng_substreams;
   gboolean weighted;
   gboolean first_flush;
   guint nchains;
@@ -105,6 +120,8 @@ struct _NcmMSetCatalogPrivate
   gsl_vector_complex *chain_sM_ev;
   NcmMSetCatalogTauMethod tau_method;
   NcmVector *tau;
+  NcmMSetCatalogBM *bm;
+  NcmMSetCatalogBM *e_bm;
   gchar *rng_inis;
   gchar *rng_stat;
   GTimer *sync_timer;
@@ -122,6 +139,7 @@ struct _NcmMSetCatalogPrivate
 #ifdef NUMCOSMO_HAVE_CFITSIO
   fitsfile *fptr;
 #endif /* NUMCOSMO_HAVE_CFITSIO */
+  NcmMSetCatalogBin *bin;
   NcmVector *params_max;
   NcmVector *params_min;
   glong pdf_i;
@@ -132,6 +150,148 @@ struct _NcmMSetCatalogPrivate
 
 G_DEFINE_TYPE_WITH_PRIVATE (NcmMSetCatalog, ncm_mset_catalog, G_TYPE_OBJECT);
 
+/*
+ * Online batch means: the samples are accumulated in batches of size
+ * bsize, when NCM_MSET_CATALOG_BM_NBATCHES batches are completed the
+ * adjacent pairs are merged and bsize is doubled. The number of complete
+ * batches stays between NCM_MSET_CATALOG_BM_NBATCHES / 2 and
+ * NCM_MSET_CATALOG_BM_NBATCHES, and each sample costs an amortized
+ * constant time per column.
+ *
+ */
+#define NCM_MSET_CATALOG_BM_NBATCHES 64
+
+struct _NcmMSetCatalogBM
+{
+  NcmMatrix *sums;
+  NcmVector *cur;
+  guint bsize;
+  guint nfull;
+  guint ncur;
+};
+
+static NcmMSetCatalogBM *
+_ncm_mset_catalog_bm_new (const guint len)
+{
+  NcmMSetCatalogBM *bm = g_new0 (NcmMSetCatalogBM, 1);
+
+  bm->sums  = ncm_matrix_new (NCM_MSET_CATALOG_BM_NBATCHES, len);
+  bm->cur   = ncm_vector_new (len);
+  bm->bsize = 1;
+  bm->nfull = 0;
+  bm->ncur  = 0;
+
+  ncm_vector_set_zero (bm->cur);
+
+  return bm;
+}
+
+static void
+_ncm_mset_catalog_bm_free (NcmMSetCatalogBM *bm)
+{
+  ncm_matrix_clear (&bm->sums);
+  ncm_vector_clear (&bm->cur);
+  g_free (bm);
+}
+
+static void
+_ncm_mset_catalog_bm_reset (NcmMSetCatalogBM *bm)
+{
+  bm->bsize = 1;
+  bm->nfull = 0;
+  bm->ncur  = 0;
+
+  ncm_vector_set_zero (bm->cur);
+}
+
+static void
+_ncm_mset_catalog_bm_append (NcmMSetCatalogBM *bm, NcmVector *x)
+{
+  const guint len = ncm_vector_len (bm->cur);
+  guint i;
+
+  for (i = 0; i < len; i++)
+    ncm_vector_addto (bm->cur, i, ncm_vector_get (x, i));
+
+  bm->ncur++;
+
+  if (bm->ncur == bm->bsize)
+  {
+    ncm_matrix_set_row (bm->sums, bm->nfull, bm->cur);
+    ncm_vector_set_zero (bm->cur);
+    bm->ncur = 0;
+    bm->nfull++;
+
+    if (bm->nfull == NCM_MSET_CATALOG_BM_NBATCHES)
+    {
+      guint k;
+
+      for (k = 0; k < NCM_MSET_CATALOG_BM_NBATCHES / 2; k++)
+      {
+        gdouble *row_k  = ncm_matrix_ptr (bm->sums, k, 0);
+        gdouble *row_2k = ncm_matrix_ptr (bm->sums, 2 * k, 0);
+        gdouble *row_2k1 = ncm_matrix_ptr (bm->sums, 2 * k + 1, 0);
+
+        for (i = 0; i < len; i++)
+          row_k[i] = row_2k[i] + row_2k1[i];
+      }
+
+      bm->nfull  = NCM_MSET_CATALOG_BM_NBATCHES / 2;
+      bm->bsize *= 2;
+    }
+  }
+}
+
+/*
+ * Rebuilds the batch means from the rows already in the catalog, used
+ * when the batch means method is selected after the rows were added.
+ *
+ */
+static void
+_ncm_mset_catalog_bm_refill (NcmMSetCatalogBM *bm, NcmStatsVec *svec)
+{
+  const guint nrows = ncm_stats_vec_nrows (svec);
+  guint i;
+
+  _ncm_mset_catalog_bm_reset (bm);
+
+  for (i = 0; i < nrows; i++)
+    _ncm_mset_catalog_bm_append (bm, ncm_stats_vec_peek_row (svec, i));
+}
+
+/*
+ * Returns bsize times the variance of the batch means of column p, i.e.,
+ * the estimate of the spectral density at zero frequency. It returns
+ * zero when there are less than two complete batches.
+ *
+ */
+static gdouble
+_ncm_mset_catalog_bm_spec0 (NcmMSetCatalogBM *bm, const guint p)
+{
+  if (bm->nfull < 2)
+  {
+    return 0.0;
+  }
+  else
+  {
+    const gdouble bsize = bm->bsize;
+    gdouble mean        = 0.0;
+    gdouble var         = 0.0;
+    guint k;
+
+    for (k = 0; k < bm->nfull; k++)
+    {
+      const gdouble bmean_k = ncm_matrix_get (bm->sums, k, p) / bsize;
+      const gdouble delta   = bmean_k - mean;
+
+      mean += delta / (k + 1.0);
+      var  += delta * (bmean_k - mean);
+    }
+
+    return bsize * var / (bm->nfull - 1.0);
+  }
+}
+
 enum
 {
   PROP_0,
@@ -184,6 +344,7 @@ ncm_mset_catalog_init (NcmMSetCatalog *mcat)
   self->smode          = NCM_MSET_CATALOG_SYNC_LEN;
   self->readonly       = FALSE;
   self->rng            = NULL;
+  self->rng_substreams = FALSE;
   self->weighted       = FALSE;
   self->first_flush    = FALSE;
   self->nchains        = 0;
@@ -201,6 +362,8 @@ ncm_mset_catalog_init (NcmMSetCatalog *mcat)
   self->chain_sM_ws    = NULL;
   self->chain_sM_ev    = NULL;
   self->tau            = NULL;
+  self->bm             = NULL;
+  self->e_bm           = NULL;
 
   self->rng_inis       = NULL;
   self->rng_stat       = NULL;
@@ -218,6 +381,7 @@ ncm_mset_catalog_init (NcmMSetCatalog *mcat)
 #ifdef NUMCOSMO_HAVE_CFITSIO
   self->fptr           = NULL;
 #endif /* NUMCOSMO_HAVE_CFITSIO */
+  self->bin            = NULL;
   self->pdf_i          = -1;
   self->h              = NULL;
   self->h_pdf          = NULL;
@@ -227,10 +391,8 @@ ncm_mset_catalog_init (NcmMSetCatalog *mcat)
   self->constructed    = FALSE;
 }
 
-#ifdef NUMCOSMO_HAVE_CFITSIO
 static void _ncm_mset_catalog_open_create_file (NcmMSetCatalog *mcat, gboolean load_from_cat);
 static void _ncm_mset_catalog_flush_file (NcmMSetCatalog *mcat);
-#endif /* NUMCOSMO_HAVE_CFITSIO */
 
 static void
 _ncm_mset_catalog_constructed_alloc_chains (NcmMSetCatalog *mcat)
@@ -267,6 +429,10 @@ _ncm_mset_catalog_constructed_alloc_chains (NcmMSetCatalog *mcat)
   }
   self->tau = ncm_vector_new (total);
   ncm_vector_set_all (self->tau, 1.0);
+
+  self->bm = _ncm_mset_catalog_bm_new (total);
+  if (self->nchains > 1)
+    self->e_bm = _ncm_mset_catalog_bm_new (total);
 }
 
 static void
@@ -294,7 +460,6 @@ _ncm_mset_catalog_constructed (GObject *object)
 
     if (self->mset == NULL)
     {
-#ifdef NUMCOSMO_HAVE_CFITSIO
       if (self->mset_file == NULL)
       {
         g_error ("_ncm_mset_catalog_constructed: cannot create catalog without mset.");
@@ -322,9 +487,6 @@ _ncm_mset_catalog_constructed (GObject *object)
       _ncm_mset_catalog_constructed_alloc_chains (mcat);
 
       ncm_mset_catalog_sync (mcat, TRUE);
-#else
-      g_error ("_ncm_mset_catalog_constructed: cannot create catalog without mset.");
-#endif /* NUMCOSMO_HAVE_CFITSIO */
     }
     else
     {
@@ -535,13 +697,14 @@ _ncm_mset_catalog_dispose (GObject *object)
   ncm_vector_clear (&self->tau);
   ncm_vector_clear (&self->quantile_ws);
 
+  g_clear_pointer (&self->bm, _ncm_mset_catalog_bm_free);
+  g_clear_pointer (&self->e_bm, _ncm_mset_catalog_bm_free);
+
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_mset_catalog_parent_class)->dispose (object);
 }
 
-#ifdef NUMCOSMO_HAVE_CFITSIO
 static void _ncm_mset_catalog_close_file (NcmMSetCatalog *mcat);
-#endif /* NUMCOSMO_HAVE_CFITSIO */
 
 static void
 _ncm_mset_catalog_finalize (GObject *object)
@@ -554,9 +717,7 @@ _ncm_mset_catalog_finalize (GObject *object)
   if (self->h_pdf != NULL)
     gsl_histogram_pdf_free (self->h_pdf);
 
-#ifdef NUMCOSMO_HAVE_CFITSIO
   _ncm_mset_catalog_close_file (mcat);
-#endif /* NUMCOSMO_HAVE_CFITSIO */
 
   g_clear_pointer (&self->rtype_str, g_free);
 
@@ -700,186 +861,1173 @@ ncm_mset_catalog_class_init (NcmMSetCatalogClass *klass)
                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
-/**
- * ncm_mset_catalog_new:
- * @mset: a #NcmMSet
- * @nadd_vals: number of additional values
- * @nchains: number of different chains in the catalog (>=1)
- * @weighted: set to TRUE whenever the catalog is weighted
- * @...: additional values name/symbol pairs
- *
- * Creates a new #NcmMSetCatalog based on the #NcmFit object @fit. The catalog assumes that
- * the @fit object will remain with the same set of free parameters during its whole lifetime.
- *
- * If @nchains is larger than one, the catalog will keep track of the statistics of each chain
- * separately.
+/*
+ * Catalog file header, read by the fits and binary backends and validated
+ * by the same code. The array asymbs has one entry per additional value,
+ * NULL when the file does not contain its symbol.
  *
- * Returns: (transfer full): a new #NcmMSetCatalog
  */
-NcmMSetCatalog *
-ncm_mset_catalog_new (NcmMSet *mset, guint nadd_vals, guint nchains, gboolean weighted, ...)
+typedef struct _NcmMSetCatalogFileHeader
 {
-  va_list ap;
-  gchar **names   = g_new (gchar *, nadd_vals + 1);
-  gchar **symbols = g_new (gchar *, nadd_vals + 1);
-  guint i;
-
-  va_start (ap, weighted);
-  for (i = 0; i < nadd_vals; i++)
-  {
-    gchar *name   = va_arg (ap, gchar *);
-    gchar *symbol = (name != NULL) ? va_arg (ap, gchar *) : NULL;
-
-    if (name == NULL || symbol == NULL)
-      g_error ("ncm_mset_catalog_new: missing %u-th name and or symbol.", i + 1);
+  gint first_id;
+  gboolean has_m2lnp_var;
+  gint m2lnp_var;
+  gchar *rtype_str;
+  gint nchains;
+  gint nadd_vals;
+  gboolean weighted;
+  glong nrows;
+  GPtrArray *colnames;
+  GPtrArray *asymbs;
+} NcmMSetCatalogFileHeader;
 
-    names[i]   = name;
-    symbols[i] = symbol;
-  }
-  va_end (ap);
+static NcmMSetCatalogFileHeader *
+_ncm_mset_catalog_file_header_new (void)
+{
+  NcmMSetCatalogFileHeader *fh = g_new0 (NcmMSetCatalogFileHeader, 1);
 
-  names[i]   = NULL;
-  symbols[i] = NULL;
-  
-  {
-    NcmMSetCatalog *mcat = g_object_new (NCM_TYPE_MSET_CATALOG,
-                                         "mset",             mset,
-                                         "nadd-vals",        nadd_vals,
-                                         "nchains",          nchains,
-                                         "weighted",         weighted,
-                                         "nadd-val-names",   names,
-                                         "nadd-val-symbols", symbols,
-                                         NULL);
+  fh->colnames = g_ptr_array_new_with_free_func (g_free);
+  fh->asymbs   = g_ptr_array_new_with_free_func (g_free);
 
-		g_free (names);
-		g_free (symbols);
-		return mcat;
-  }
+  return fh;
 }
 
-/**
- * ncm_mset_catalog_new_array:
- * @mset: a #NcmMSet
- * @nadd_vals: number of additional values
- * @nchains: number of different chains in the catalog (>=1)
- * @weighted: set to TRUE whenever the catalog is weighted
- * @names: (array zero-terminated=1): additional values name NULL-terminated array
- * @symbols: (array zero-terminated=1): additional values symbol NULL-terminated array
- * 
- * Creates a new #NcmMSetCatalog based on the #NcmFit object @fit. The catalog assumes that
- * the @fit object will remain with the same set of free parameters during its whole lifetime.
- * 
- * If @nchains is larger than one, the catalog will keep track of the statistics of each chain
- * separately.
- * 
- * Returns: (transfer full): a new #NcmMSetCatalog
- */
-NcmMSetCatalog *
-ncm_mset_catalog_new_array (NcmMSet *mset, guint nadd_vals, guint nchains, gboolean weighted, gchar **names, gchar **symbols)
+static void
+_ncm_mset_catalog_file_header_free (NcmMSetCatalogFileHeader *fh)
 {
-  NcmMSetCatalog *mcat = g_object_new (NCM_TYPE_MSET_CATALOG,
-                                       "mset",             mset,
-                                       "nadd-vals",        nadd_vals,
-                                       "nchains",          nchains,
-                                       "weighted",         weighted,
-                                       "nadd-val-names",   names,
-                                       "nadd-val-symbols", symbols,
-                                       NULL);
-
-  return mcat;  
+  g_clear_pointer (&fh->rtype_str, g_free);
+  g_ptr_array_unref (fh->colnames);
+  g_ptr_array_unref (fh->asymbs);
+  g_free (fh);
 }
 
-/**
- * ncm_mset_catalog_new_from_file:
- * @filename: filename of the catalog fits
- * @burnin: Burn-in size
- *
- * Creates a new #NcmMSetCatalog from the catalog in the file @file.
- * It will use also the mset file (same name but with .mset extension).
- *
- *
- * Returns: (transfer full): a new #NcmMSetCatalog
- */
-NcmMSetCatalog *
-ncm_mset_catalog_new_from_file (const gchar *filename, glong burnin)
+static gint
+_ncm_mset_catalog_file_header_get_colnum (NcmMSetCatalogFileHeader *fh, const gchar *colname)
 {
-  NcmMSetCatalog *mcat = g_object_new (NCM_TYPE_MSET_CATALOG,
-                                       "filename", filename,
-                                       "burnin", burnin,
-                                       NULL);
-  return mcat;
-}
+  guint i;
 
-/**
- * ncm_mset_catalog_new_from_file_ro:
- * @filename: filename of the catalog fits
- * @burnin: Burn-in size
- *
- * Creates a new #NcmMSetCatalog from the catalog in the file @file.
- * The @file is opened in a read-only fashion.
- * It will use also the mset file (same name but with .mset extension).
- *
- *
- * Returns: (transfer full): a new #NcmMSetCatalog
- */
-NcmMSetCatalog *
-ncm_mset_catalog_new_from_file_ro (const gchar *filename, glong burnin)
-{
-  NcmMSetCatalog *mcat = g_object_new (NCM_TYPE_MSET_CATALOG,
-                                       "filename", filename,
-                                       "read-only", TRUE,
-                                       "burnin", burnin,
-                                       NULL);
-  return mcat;
-}
+  for (i = 0; i < fh->colnames->len; i++)
+  {
+    if (strcmp (g_ptr_array_index (fh->colnames, i), colname) == 0)
+      return i + 1;
+  }
 
-/**
- * ncm_mset_catalog_ref:
- * @mcat: a #NcmMSetCatalog
- *
- * Increases the reference count of @mcat atomically.
- *
- * Returns: (transfer full): @mcat.
- */
-NcmMSetCatalog *
-ncm_mset_catalog_ref (NcmMSetCatalog *mcat)
-{
-  return g_object_ref (mcat);
+  return 0;
 }
 
-/**
- * ncm_mset_catalog_free:
- * @mcat: a #NcmMSetCatalog
- *
- * Decreases the reference count of @mcat atomically.
+/*
+ * Checks the header of an existing file against @mcat, or loads it into
+ * @mcat when load_from_cat is TRUE, and builds the column order porder.
  *
  */
-void
-ncm_mset_catalog_free (NcmMSetCatalog *mcat)
+static void
+_ncm_mset_catalog_file_header_apply (NcmMSetCatalog *mcat, NcmMSetCatalogFileHeader *fh, gboolean load_from_cat)
 {
-  ncm_mset_catalog_sync (mcat, TRUE);
-  g_object_unref (mcat);
-}
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  guint fparam_len            = ncm_mset_fparam_len (self->mset);
+  GPtrArray *remap_remove     = g_ptr_array_new_with_free_func (g_free);
+  gboolean remap              = FALSE;
+  glong nrows                 = fh->nrows;
+  guint i;
 
-/**
- * ncm_mset_catalog_clear:
- * @mcat: a #NcmMSetCatalog
- *
- * Decrese the reference count of *@mcat atomically and sets the pointer *@mcat to null.
- *
- */
-void
-ncm_mset_catalog_clear (NcmMSetCatalog **mcat)
-{
-  if (*mcat != NULL)
-    ncm_mset_catalog_sync (*mcat, TRUE);
-  g_clear_object (mcat);
-}
+  self->file_first_id = fh->first_id;
 
-#ifdef NUMCOSMO_HAVE_CFITSIO
+  if (fh->has_m2lnp_var)
+    self->m2lnp_var = fh->m2lnp_var;
+  else
+    g_warning ("_ncm_mset_catalog_open_create_file: catalog does not contain `%s' key, using original value `%d'.",
+               NCM_MSET_CATALOG_M2LNP_ID_LABEL,
+               self->m2lnp_var);
 
-static void
-_ncm_fits_update_key_str (fitsfile *fptr, gchar *keyname, gchar *value, gchar *comment, gboolean overwrite)
+  if (load_from_cat)
+  {
+    ncm_mset_catalog_set_run_type (mcat, fh->rtype_str);
+  }
+  else if (strcmp (self->rtype_str, fh->rtype_str) != 0)
+    g_error ("_ncm_mset_catalog_open_create_file: incompatible run type strings from catalog and file, catalog: `%s' file: `%s'.",
+             self->rtype_str, fh->rtype_str);
+
+  g_assert_cmpint (fh->nchains, >, 0);
+
+  if (load_from_cat)
+  {
+    self->nchains = fh->nchains;
+  }
+  else if (fh->nchains != self->nchains)
+    g_error ("_ncm_mset_catalog_open_create_file: catalog has %d chains and file contains %d.", self->nchains, fh->nchains);
+
+  if (load_from_cat)
+  {
+    self->nadd_vals = fh->nadd_vals;
+  }
+  else if (fh->nadd_vals != self->nadd_vals)
+    g_error ("_ncm_mset_catalog_open_create_file: catalog has %d additional values and file contains %d.", self->nadd_vals, fh->nadd_vals);
+
+  if (load_from_cat)
+  {
+    self->weighted = fh->weighted ? TRUE : FALSE;
+  }
+  else if ((fh->weighted && !self->weighted) || (!fh->weighted && self->weighted))
+    g_error ("_ncm_mset_catalog_open_create_file: catalog %s weighted and file %s.",
+             self->weighted ? "is" : "is not",
+             fh->weighted ? "is" : "is not");
+
+  if (nrows < self->burnin)
+  {
+    g_error ("_ncm_mset_catalog_open_create_file: burnin larger than the catalogue size %ld <=> %ld",
+             self->burnin, nrows);
+  }
+  else
+  {
+    nrows -= self->burnin;
+  }
+
+  if (self->file_first_id != self->first_id)
+  {
+    if (nrows == 0)
+    {
+      if (self->file_first_id != 0)
+        g_warning ("_ncm_mset_catalog_open_create_file: Empty data file with "NCM_MSET_CATALOG_FIRST_ID_LABEL" different from first_id: %d != %d. Setting to first_id.\n",
+                   self->file_first_id, self->first_id);
+      self->file_first_id = self->first_id;
+    }
+    else if (ncm_mset_catalog_is_empty (mcat))
+    {
+      if (self->first_id != 0)
+        g_warning ("_ncm_mset_catalog_open_create_file: Empty memory catalog with first_id different from "NCM_MSET_CATALOG_FIRST_ID_LABEL": %d != %d. Setting to "NCM_MSET_CATALOG_FIRST_ID_LABEL".\n",
+                   self->first_id, self->file_first_id);
+
+      self->first_id = self->file_first_id;
+      self->cur_id   = self->file_first_id - 1;
+    }
+  }
+  self->file_cur_id = self->file_first_id + nrows - 1;
+
+  if (load_from_cat)
+  {
+    g_array_set_size (self->porder, fparam_len + self->nadd_vals + (self->weighted ? 1 : 0));
+
+    for (i = 0; i < fh->colnames->len; i++)
+    {
+      const gchar *colname = g_ptr_array_index (fh->colnames, i);
+
+      if (i < self->nadd_vals)
+      {
+        const gchar *asymb = g_ptr_array_index (fh->asymbs, i);
+
+        g_ptr_array_add (self->add_vals_names, g_strdup (colname));
+        g_ptr_array_add (self->add_vals_symbs, g_strdup (asymb != NULL ? asymb : "no-symbol"));
+        g_array_index (self->porder, gint, i) = i + 1;
+      }
+      else
+      {
+        NcmMSetPIndex *pi = ncm_mset_param_get_by_full_name (self->mset, colname);
+        if (pi == NULL)
+        {
+          g_error ("_ncm_mset_catalog_open_create_file: cannot find parameter `%s' in mset file.", colname);
+        }
+        else
+        {
+          NcmParamType ftype = ncm_mset_param_get_ftype (self->mset, pi->mid, pi->pid);
+          if (ftype != NCM_PARAM_TYPE_FREE)
+          {
+            g_warning ("_ncm_mset_catalog_open_create_file: parameter `%s' found but not free on the catalog, setting it to NCM_PARAM_TYPE_FREE.",
+                       colname);
+            ncm_mset_param_set_ftype (self->mset, pi->mid, pi->pid, NCM_PARAM_TYPE_FREE);
+            remap = TRUE;
+          }
+          ncm_mset_pindex_free (pi);
+        }
+      }
+    }
+  }
+  else
+  {
+    for (i = 0; i < self->nadd_vals; i++)
+    {
+      const gchar *cname   = g_ptr_array_index (self->add_vals_names, i);
+      const gchar *csymbol = g_ptr_array_index (self->add_vals_symbs, i);
+      const gchar *asymb   = g_ptr_array_index (fh->asymbs, i);
+      const gint cindex    = _ncm_mset_catalog_file_header_get_colnum (fh, cname);
+
+      if (cindex == 0)
+        g_error ("_ncm_mset_catalog_open_create_file: Additional column %s not found, invalid file.", cname);
+
+      if (asymb == NULL)
+        g_error ("_ncm_mset_catalog_open_create_file: symbol %s%d not found", NCM_MSET_CATALOG_ASYMB_LABEL, i + 1);
+      else
+        g_assert_cmpstr (asymb, ==, csymbol);
+
+      if (cindex != i + 1)
+      {
+        g_error ("_ncm_mset_catalog_open_create_file: Additional column %s is not the %d-th column [%d], invalid file.",
+                 cname, i + 1, cindex);
+      }
+      g_array_index (self->porder, gint, i) = cindex;
+    }
+  }
+
+  if (remap)
+  {
+    ncm_mset_prepare_fparam_map (self->mset);
+
+    fparam_len = ncm_mset_fparam_len (self->mset);
+    g_array_set_size (self->porder, fparam_len + self->nadd_vals + (self->weighted ? 1 : 0));
+    remap = FALSE;
+  }
+
+  for (i = 0; i < fparam_len; i++)
+  {
+    const gchar *fparam_fullname = ncm_mset_fparam_full_name (self->mset, i);
+
+    if (_ncm_mset_catalog_file_header_get_colnum (fh, fparam_fullname) == 0)
+    {
+      g_warning ("_ncm_mset_catalog_open_create_file: Parameter `%s' set free in mset but not found on the file, setting it to NCM_PARAM_TYPE_FIXED.", fparam_fullname);
+      g_ptr_array_add (remap_remove, g_strdup (fparam_fullname));
+      remap = TRUE;
+    }
+  }
+
+  if (remap)
+  {
+    for (i = 0; i < remap_remove->len; i++)
+    {
+      NcmMSetPIndex *pi = ncm_mset_param_get_by_full_name (self->mset, g_ptr_array_index (remap_remove, i));
+      if (pi == NULL)
+      {
+        g_error ("_ncm_mset_catalog_open_create_file: unknown error should never happen! Cannot find parameter `%s' in mset file.", 
+                 (gchar *)g_ptr_array_index (remap_remove, i));
+      }
+      else
+      {
+        ncm_mset_param_set_ftype (self->mset, pi->mid, pi->pid, NCM_PARAM_TYPE_FIXED);
+        ncm_mset_pindex_free (pi);
+      }
+    }
+
+    ncm_mset_prepare_fparam_map (self->mset);
+
+    fparam_len = ncm_mset_fparam_len (self->mset);
+    g_array_set_size (self->porder, fparam_len + self->nadd_vals + (self->weighted ? 1 : 0));
+  }
+
+  for (i = 0; i < fparam_len; i++)
+  {
+    const gchar *fparam_fullname = ncm_mset_fparam_full_name (self->mset, i);
+    const gint cindex            = _ncm_mset_catalog_file_header_get_colnum (fh, fparam_fullname);
+
+    g_assert_cmpint (cindex, >, 0);
+    g_array_index (self->porder, gint, i + self->nadd_vals) = cindex;
+  }
+
+  g_ptr_array_unref (remap_remove);
+}
+
+/*
+ * Column names of a new file, the additional values followed by the free
+ * parameters, and the matching column order porder. The names are owned
+ * by @mcat.
+ *
+ */
+static GPtrArray *
+_ncm_mset_catalog_file_colnames (NcmMSetCatalog *mcat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  const guint fparam_len      = ncm_mset_fparam_len (self->mset);
+  GPtrArray *colnames         = g_ptr_array_sized_new (fparam_len + self->nadd_vals);
+  guint i;
+
+  for (i = 0; i < self->nadd_vals; i++)
+  {
+    g_ptr_array_add (colnames, g_ptr_array_index (self->add_vals_names, i));
+    g_array_index (self->porder, gint, i) = colnames->len;
+  }
+
+  for (i = 0; i < fparam_len; i++)
+  {
+    g_ptr_array_add (colnames, (gchar *) ncm_mset_fparam_full_name (self->mset, i));
+    g_array_index (self->porder, gint, i + self->nadd_vals) = colnames->len;
+  }
+
+  return colnames;
+}
+
+/*
+ * Binary columnar catalog format.
+ *
+ * The file starts with the 8 bytes magic NCM_MSET_CATALOG_BIN_MAGIC and
+ * is followed by a sequence of records. Each record has a 16 bytes header
+ * (guint32 type, guint32 reserved, guint64 payload size) followed by its
+ * payload padded to a multiple of 8 bytes, in the machine byte order:
+ *
+ * - NCM_MSET_CATALOG_BIN_REC_COLS: guint64 ncols followed by the
+ *   NUL-terminated column names (written once, right after the magic);
+ * - NCM_MSET_CATALOG_BIN_REC_KEY: NUL-terminated key and value, a key
+ *   written later supersedes the previous values, so header updates
+ *   are appended instead of rewritten;
+ * - NCM_MSET_CATALOG_BIN_REC_DATA: guint64 nrows followed by ncols
+ *   columns of nrows doubles each (column-major block).
+ *
+ * New rows are always appended as a new data block. The whole file is
+ * memory mapped for reading, so rows are gathered directly from the
+ * mapped columns without any per-row I/O. Only prepending rows or
+ * erasing the data requires a rewrite of the file.
+ */
+
+#define NCM_MSET_CATALOG_BIN_MAGIC "NCMCATB1"
+#define NCM_MSET_CATALOG_BIN_MAGIC_LEN 8
+#define NCM_MSET_CATALOG_BIN_REC_COLS 1
+#define NCM_MSET_CATALOG_BIN_REC_KEY  2
+#define NCM_MSET_CATALOG_BIN_REC_DATA 3
+#define NCM_MSET_CATALOG_BIN_ALIGN(s) ((((s) + 7) / 8) * 8)
+
+typedef struct _NcmMSetCatalogBinRecHeader
+{
+  guint32 type;
+  guint32 reserved;
+  guint64 size;
+} NcmMSetCatalogBinRecHeader;
+
+typedef struct _NcmMSetCatalogBinChunk
+{
+  gsize data_offset;
+  glong first_row;
+  glong nrows;
+} NcmMSetCatalogBinChunk;
+
+struct _NcmMSetCatalogBin
+{
+  gchar *filename;
+  gboolean readonly;
+  FILE *f;
+  GMappedFile *mfile;
+  gsize size;
+  GHashTable *keys;
+  GPtrArray *colnames;
+  GArray *chunks;
+  glong nrows;
+  guint last_chunk;
+};
+
+static gboolean
+_ncm_mset_catalog_file_is_bin (const gchar *filename)
+{
+  return g_str_has_suffix (filename, NCM_MSET_CATALOG_BIN_EXT);
+}
+
+static gchar *
+_ncm_mset_catalog_file_basename (const gchar *filename)
+{
+  if (_ncm_mset_catalog_file_is_bin (filename))
+    return g_strndup (filename, strlen (filename) - strlen (NCM_MSET_CATALOG_BIN_EXT));
+  else
+    return ncm_util_basename_fits (filename);
+}
+
+static void
+_ncm_mset_catalog_bin_write (NcmMSetCatalogBin *bin, FILE *f, const guint32 type, gconstpointer p1, const gsize s1, gconstpointer p2, const gsize s2)
+{
+  const gsize size                  = s1 + s2;
+  const gsize pad                   = NCM_MSET_CATALOG_BIN_ALIGN (size) - size;
+  const guint64 zero                = 0;
+  NcmMSetCatalogBinRecHeader header = {type, 0, size};
+
+  if ((fwrite (&header, sizeof (NcmMSetCatalogBinRecHeader), 1, f) != 1) ||
+      ((s1 > 0) && (fwrite (p1, 1, s1, f) != s1)) ||
+      ((s2 > 0) && (fwrite (p2, 1, s2, f) != s2)) ||
+      ((pad > 0) && (fwrite (&zero, 1, pad, f) != pad)))
+    g_error ("_ncm_mset_catalog_bin_write: error writing to file `%s': %s.", bin->filename, g_strerror (errno));
+}
+
+static void
+_ncm_mset_catalog_bin_write_key (NcmMSetCatalogBin *bin, FILE *f, const gchar *key, const gchar *value)
+{
+  _ncm_mset_catalog_bin_write (bin, f, NCM_MSET_CATALOG_BIN_REC_KEY, key, strlen (key) + 1, value, strlen (value) + 1);
+}
+
+static void
+_ncm_mset_catalog_bin_write_cols (NcmMSetCatalogBin *bin, FILE *f)
+{
+  GString *names      = g_string_new ("");
+  const guint64 ncols = bin->colnames->len;
+  guint i;
+
+  for (i = 0; i < bin->colnames->len; i++)
+    g_string_append_len (names, g_ptr_array_index (bin->colnames, i), strlen (g_ptr_array_index (bin->colnames, i)) + 1);
+
+  _ncm_mset_catalog_bin_write (bin, f, NCM_MSET_CATALOG_BIN_REC_COLS, &ncols, sizeof (guint64), names->str, names->len);
+
+  g_string_free (names, TRUE);
+}
+
+static void
+_ncm_mset_catalog_bin_map (NcmMSetCatalogBin *bin)
+{
+  GError *error = NULL;
+
+  g_clear_pointer (&bin->mfile, g_mapped_file_unref);
+
+  if (bin->f != NULL)
+    fflush (bin->f);
+
+  bin->mfile = g_mapped_file_new (bin->filename, FALSE, &error);
+  if (bin->mfile == NULL)
+    g_error ("_ncm_mset_catalog_bin_map: cannot map file `%s': %s.", bin->filename, error->message);
+}
+
+static gboolean
+_ncm_mset_catalog_bin_load (NcmMSetCatalogBin *bin, GError **error)
+{
+  const gchar *data;
+  gsize len, pos;
+
+  _ncm_mset_catalog_bin_map (bin);
+
+  data = g_mapped_file_get_contents (bin->mfile);
+  len  = g_mapped_file_get_length (bin->mfile);
+
+  if ((len < NCM_MSET_CATALOG_BIN_MAGIC_LEN) || (memcmp (data, NCM_MSET_CATALOG_BIN_MAGIC, NCM_MSET_CATALOG_BIN_MAGIC_LEN) != 0))
+    g_error ("_ncm_mset_catalog_bin_load: file `%s' is not a binary NcmMSetCatalog file.", bin->filename);
+
+  pos = NCM_MSET_CATALOG_BIN_MAGIC_LEN;
+  while (pos + sizeof (NcmMSetCatalogBinRecHeader) <= len)
+  {
+    NcmMSetCatalogBinRecHeader header;
+    const gchar *payload;
+
+    memcpy (&header, data + pos, sizeof (NcmMSetCatalogBinRecHeader));
+    if (pos + sizeof (NcmMSetCatalogBinRecHeader) + NCM_MSET_CATALOG_BIN_ALIGN (header.size) > len)
+      break;
+
+    payload = data + pos + sizeof (NcmMSetCatalogBinRecHeader);
+
+    switch (header.type)
+    {
+      case NCM_MSET_CATALOG_BIN_REC_COLS:
+      {
+        guint64 ncols;
+        const gchar *name;
+        guint i;
+
+        memcpy (&ncols, payload, sizeof (guint64));
+        name = payload + sizeof (guint64);
+
+        g_ptr_array_set_size (bin->colnames, 0);
+        for (i = 0; i < ncols; i++)
+        {
+          g_ptr_array_add (bin->colnames, g_strdup (name));
+          name += strlen (name) + 1;
+        }
+        break;
+      }
+      case NCM_MSET_CATALOG_BIN_REC_KEY:
+      {
+        const gchar *key   = payload;
+        const gchar *value = payload + strlen (key) + 1;
+
+        g_hash_table_replace (bin->keys, g_strdup (key), g_strdup (value));
+        break;
+      }
+      case NCM_MSET_CATALOG_BIN_REC_DATA:
+      {
+        NcmMSetCatalogBinChunk chunk;
+        guint64 nrows;
+
+        memcpy (&nrows, payload, sizeof (guint64));
+
+        chunk.data_offset = pos + sizeof (NcmMSetCatalogBinRecHeader) + sizeof (guint64);
+        chunk.first_row   = bin->nrows;
+        chunk.nrows       = nrows;
+
+        g_assert_cmpuint (header.size, ==, sizeof (guint64) + sizeof (gdouble) * nrows * bin->colnames->len);
+
+        g_array_append_val (bin->chunks, chunk);
+        bin->nrows += nrows;
+        break;
+      }
+      default:
+        g_error ("_ncm_mset_catalog_bin_load: invalid record type %u in file `%s'.", header.type, bin->filename);
+        break;
+    }
+
+    pos += sizeof (NcmMSetCatalogBinRecHeader) + NCM_MSET_CATALOG_BIN_ALIGN (header.size);
+  }
+
+  if (pos != len)
+  {
+    if (bin->readonly)
+    {
+      g_warning ("_ncm_mset_catalog_bin_load: ignoring truncated record at the end of file `%s'.", bin->filename);
+    }
+    else
+    {
+      g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+                   "_ncm_mset_catalog_bin_load: truncated record at the end of file `%s'.", bin->filename);
+      return FALSE;
+    }
+  }
+
+  bin->size = pos;
+
+  return TRUE;
+}
+
+static NcmMSetCatalogBin *
+_ncm_mset_catalog_bin_open (const gchar *filename, gboolean readonly)
+{
+  NcmMSetCatalogBin *bin = g_new0 (NcmMSetCatalogBin, 1);
+
+  bin->filename   = g_strdup (filename);
+  bin->readonly   = readonly;
+  bin->f          = NULL;
+  bin->mfile      = NULL;
+  bin->size       = 0;
+  bin->keys       = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  bin->colnames   = g_ptr_array_new_with_free_func (g_free);
+  bin->chunks     = g_array_new (FALSE, FALSE, sizeof (NcmMSetCatalogBinChunk));
+  bin->nrows      = 0;
+  bin->last_chunk = 0;
+
+  if (g_file_test (filename, G_FILE_TEST_EXISTS))
+  {
+    GError *error = NULL;
+
+    if (!_ncm_mset_catalog_bin_load (bin, &error))
+      g_error ("%s", error->message);
+
+    if (!readonly)
+    {
+      bin->f = g_fopen (filename, "ab");
+      if (bin->f == NULL)
+        g_error ("_ncm_mset_catalog_bin_open: cannot open file `%s': %s.", filename, g_strerror (errno));
+    }
+  }
+
+  return bin;
+}
+
+static void
+_ncm_mset_catalog_bin_create (NcmMSetCatalogBin *bin, GPtrArray *colnames)
+{
+  guint i;
+
+  g_assert (bin->f == NULL);
+
+  bin->f = g_fopen (bin->filename, "wb");
+  if (bin->f == NULL)
+    g_error ("_ncm_mset_catalog_bin_create: cannot create file `%s': %s.", bin->filename, g_strerror (errno));
+
+  if (fwrite (NCM_MSET_CATALOG_BIN_MAGIC, 1, NCM_MSET_CATALOG_BIN_MAGIC_LEN, bin->f) != NCM_MSET_CATALOG_BIN_MAGIC_LEN)
+    g_error ("_ncm_mset_catalog_bin_create: error writing to file `%s': %s.", bin->filename, g_strerror (errno));
+
+  g_ptr_array_set_size (bin->colnames, 0);
+  for (i = 0; i < colnames->len; i++)
+    g_ptr_array_add (bin->colnames, g_strdup (g_ptr_array_index (colnames, i)));
+
+  _ncm_mset_catalog_bin_write_cols (bin, bin->f);
+  bin->size = ftell (bin->f);
+}
+
+static void
+_ncm_mset_catalog_bin_free (NcmMSetCatalogBin *bin)
+{
+  if (bin->f != NULL)
+    fclose (bin->f);
+
+  g_clear_pointer (&bin->mfile, g_mapped_file_unref);
+  g_hash_table_unref (bin->keys);
+  g_ptr_array_unref (bin->colnames);
+  g_array_unref (bin->chunks);
+  g_free (bin->filename);
+  g_free (bin);
+}
+
+static const gchar *
+_ncm_mset_catalog_bin_get_key (NcmMSetCatalogBin *bin, const gchar *key)
+{
+  return g_hash_table_lookup (bin->keys, key);
+}
+
+static void
+_ncm_mset_catalog_bin_set_key (NcmMSetCatalogBin *bin, const gchar *key, const gchar *value)
+{
+  const gchar *cur_value = g_hash_table_lookup (bin->keys, key);
+
+  if ((cur_value != NULL) && (strcmp (cur_value, value) == 0))
+    return;
+
+  if (bin->f == NULL)
+    g_error ("_ncm_mset_catalog_bin_set_key: cannot update key `%s' in the read-only file `%s'.", key, bin->filename);
+
+  _ncm_mset_catalog_bin_write_key (bin, bin->f, key, value);
+  bin->size = ftell (bin->f);
+
+  g_hash_table_replace (bin->keys, g_strdup (key), g_strdup (value));
+}
+
+static void
+_ncm_mset_catalog_bin_set_key_int (NcmMSetCatalogBin *bin, const gchar *key, const gint64 value)
+{
+  gchar *value_str = g_strdup_printf ("%" G_GINT64_FORMAT, value);
+  _ncm_mset_catalog_bin_set_key (bin, key, value_str);
+  g_free (value_str);
+}
+
+static gdouble *
+_ncm_mset_catalog_bin_pack_rows (NcmMSetCatalogBin *bin, NcmStatsVec *pstats, const guint offset, const guint nrows, GArray *porder)
+{
+  gdouble *cols = g_new0 (gdouble, nrows * bin->colnames->len);
+  guint i, r;
+
+  for (r = 0; r < nrows; r++)
+  {
+    NcmVector *row = ncm_stats_vec_peek_row (pstats, offset + r);
+    for (i = 0; i < ncm_vector_len (row); i++)
+    {
+      const gint col = g_array_index (porder, gint, i) - 1;
+      cols[col * nrows + r] = ncm_vector_get (row, i);
+    }
+  }
+
+  return cols;
+}
+
+static void
+_ncm_mset_catalog_bin_append_rows (NcmMSetCatalogBin *bin, NcmStatsVec *pstats, const guint offset, const guint nrows, GArray *porder)
+{
+  const guint64 nrows64 = nrows;
+  gdouble *cols;
+  NcmMSetCatalogBinChunk chunk;
+
+  if (nrows == 0)
+    return;
+
+  if (bin->f == NULL)
+    g_error ("_ncm_mset_catalog_bin_append_rows: cannot append rows to the read-only file `%s'.", bin->filename);
+
+  cols = _ncm_mset_catalog_bin_pack_rows (bin, pstats, offset, nrows, porder);
+  _ncm_mset_catalog_bin_write (bin, bin->f, NCM_MSET_CATALOG_BIN_REC_DATA, &nrows64, sizeof (guint64), cols, sizeof (gdouble) * nrows * bin->colnames->len);
+  g_free (cols);
+
+  chunk.data_offset = bin->size + sizeof (NcmMSetCatalogBinRecHeader) + sizeof (guint64);
+  chunk.first_row   = bin->nrows;
+  chunk.nrows       = nrows;
+  g_array_append_val (bin->chunks, chunk);
+
+  bin->nrows += nrows;
+  bin->size   = ftell (bin->f);
+}
+
+/*
+ * Rewrites the file with the same columns and keys, prepending nrows
+ * rows of pstats (starting at zero) and keeping the old data when
+ * keep_data is TRUE. Used for the only non-append operations.
+ * On failure the original file and bin are left untouched, unless
+ * the error happens after the new file replaced the old one.
+ */
+static gboolean
+_ncm_mset_catalog_bin_rewrite (NcmMSetCatalogBin *bin, NcmStatsVec *pstats, const guint nrows, GArray *porder, gboolean keep_data, GError **error)
+{
+  gchar *tmp_filename;
+  FILE *f;
+  GHashTableIter iter;
+  gpointer key, value;
+  guint i;
+
+  if (bin->f == NULL)
+  {
+    g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_PERM,
+                 "_ncm_mset_catalog_bin_rewrite: cannot rewrite the read-only file `%s'.", bin->filename);
+    return FALSE;
+  }
+
+  tmp_filename = g_strdup_printf ("%s.tmp", bin->filename);
+  f            = g_fopen (tmp_filename, "wb");
+
+  if (f == NULL)
+  {
+    const gint errsv = errno;
+
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
+                 "_ncm_mset_catalog_bin_rewrite: cannot create file `%s': %s.", tmp_filename, g_strerror (errsv));
+    g_free (tmp_filename);
+    return FALSE;
+  }
+
+  if (fwrite (NCM_MSET_CATALOG_BIN_MAGIC, 1, NCM_MSET_CATALOG_BIN_MAGIC_LEN, f) != NCM_MSET_CATALOG_BIN_MAGIC_LEN)
+    g_error ("_ncm_mset_catalog_bin_rewrite: error writing to file `%s': %s.", tmp_filename, g_strerror (errno));
+
+  _ncm_mset_catalog_bin_write_cols (bin, f);
+
+  g_hash_table_iter_init (&iter, bin->keys);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    _ncm_mset_catalog_bin_write_key (bin, f, key, value);
+
+  if (nrows > 0)
+  {
+    const guint64 nrows64 = nrows;
+    gdouble *cols         = _ncm_mset_catalog_bin_pack_rows (bin, pstats, 0, nrows, porder);
+
+    _ncm_mset_catalog_bin_write (bin, f, NCM_MSET_CATALOG_BIN_REC_DATA, &nrows64, sizeof (guint64), cols, sizeof (gdouble) * nrows * bin->colnames->len);
+    g_free (cols);
+  }
+
+  if (keep_data && (bin->chunks->len > 0))
+  {
+    const gchar *data;
+
+    gsize len;
+
+    _ncm_mset_catalog_bin_map (bin);
+    data = g_mapped_file_get_contents (bin->mfile);
+    len  = g_mapped_file_get_length (bin->mfile);
+
+    for (i = 0; i < bin->chunks->len; i++)
+    {
+      const NcmMSetCatalogBinChunk *chunk = &g_array_index (bin->chunks, NcmMSetCatalogBinChunk, i);
+      const guint64 nrows64               = chunk->nrows;
+      const gsize chunk_size              = sizeof (gdouble) * chunk->nrows * bin->colnames->len;
+
+      if (chunk->data_offset + chunk_size > len)
+      {
+        fclose (f);
+        g_unlink (tmp_filename);
+
+        g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+                     "_ncm_mset_catalog_bin_rewrite: truncated data record %u in file `%s'.", i, bin->filename);
+        g_free (tmp_filename);
+        return FALSE;
+      }
+
+      _ncm_mset_catalog_bin_write (bin, f, NCM_MSET_CATALOG_BIN_REC_DATA, &nrows64, sizeof (guint64),
+                                   data + chunk->data_offset, chunk_size);
+    }
+  }
+
+  fclose (f);
+  fclose (bin->f);
+  bin->f = NULL;
+  g_clear_pointer (&bin->mfile, g_mapped_file_unref);
+
+  if (g_rename (tmp_filename, bin->filename) != 0)
+  {
+    const gint errsv = errno;
+
+    g_unlink (tmp_filename);
+    bin->f = g_fopen (bin->filename, "ab");
+
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
+                 "_ncm_mset_catalog_bin_rewrite: cannot rename `%s' to `%s': %s.", tmp_filename, bin->filename, g_strerror (errsv));
+    g_free (tmp_filename);
+    return FALSE;
+  }
+
+  g_free (tmp_filename);
+
+  g_hash_table_remove_all (bin->keys);
+  g_array_set_size (bin->chunks, 0);
+  bin->nrows      = 0;
+  bin->last_chunk = 0;
+
+  if (!_ncm_mset_catalog_bin_load (bin, error))
+    return FALSE;
+
+  bin->f = g_fopen (bin->filename, "ab");
+  if (bin->f == NULL)
+  {
+    const gint errsv = errno;
+
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
+                 "_ncm_mset_catalog_bin_rewrite: cannot open file `%s': %s.", bin->filename, g_strerror (errsv));
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+_ncm_mset_catalog_bin_read_row (NcmMSetCatalogBin *bin, NcmVector *row, const glong row_index, GArray *porder)
+{
+  const NcmMSetCatalogBinChunk *chunk;
+  const gdouble *cols;
+  guint i;
+
+  g_assert_cmpint (row_index, <, bin->nrows);
+
+  if ((bin->mfile == NULL) || (g_mapped_file_get_length (bin->mfile) < bin->size))
+    _ncm_mset_catalog_bin_map (bin);
+
+  chunk = &g_array_index (bin->chunks, NcmMSetCatalogBinChunk, bin->last_chunk);
+  if ((row_index < chunk->first_row) || (row_index >= chunk->first_row + chunk->nrows))
+  {
+    guint lo = 0;
+    guint hi = bin->chunks->len - 1;
+
+    while (lo < hi)
+    {
+      const guint mid = (lo + hi + 1) / 2;
+      if (g_array_index (bin->chunks, NcmMSetCatalogBinChunk, mid).first_row <= row_index)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+
+    bin->last_chunk = lo;
+    chunk = &g_array_index (bin->chunks, NcmMSetCatalogBinChunk, lo);
+  }
+
+  cols = (const gdouble *) (g_mapped_file_get_contents (bin->mfile) + chunk->data_offset);
+
+  for (i = 0; i < ncm_vector_len (row); i++)
+  {
+    const gint col = g_array_index (porder, gint, i) - 1;
+    ncm_vector_set (row, i, cols[col * chunk->nrows + row_index - chunk->first_row]);
+  }
+}
+
+static void
+_ncm_mset_catalog_bin_flush (NcmMSetCatalogBin *bin)
+{
+  if ((bin->f != NULL) && (fflush (bin->f) != 0))
+    g_error ("_ncm_mset_catalog_bin_flush: error writing to file `%s': %s.", bin->filename, g_strerror (errno));
+}
+
+static void
+_ncm_mset_catalog_bin_sync_rng (NcmMSetCatalog *mcat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  const gchar *algo           = _ncm_mset_catalog_bin_get_key (self->bin, NCM_MSET_CATALOG_RNG_ALGO_LABEL);
+
+  if (algo != NULL)
+  {
+    const gchar *inis = _ncm_mset_catalog_bin_get_key (self->bin, NCM_MSET_CATALOG_RNG_INIS_LABEL);
+    const gchar *seed = _ncm_mset_catalog_bin_get_key (self->bin, NCM_MSET_CATALOG_RNG_SEED_LABEL);
+    const gchar *subs = _ncm_mset_catalog_bin_get_key (self->bin, NCM_MSET_CATALOG_RNG_SUBS_LABEL);
+
+    if (inis == NULL)
+      g_error ("_ncm_mset_catalog_bin_sync_rng: key `%s' not found in `%s'.", NCM_MSET_CATALOG_RNG_INIS_LABEL, self->file);
+
+    /* Older catalogs do not have the substreams key. */
+    self->rng_substreams = (subs != NULL) && (atoi (subs) != 0);
+
+    if (self->rng != NULL)
+    {
+      const gchar *cat_algo = ncm_rng_get_algo (self->rng);
+      g_assert_cmpstr (cat_algo, ==, algo);
+      g_assert_cmpstr (inis, ==, self->rng_inis);
+    }
+    else
+    {
+      NcmRNG *rng = ncm_rng_new (algo);
+
+      /* The substreams are derived from the seed, restore it before the state. */
+      if (seed != NULL)
+        ncm_rng_set_seed (rng, g_ascii_strtoull (seed, NULL, 10));
+      ncm_rng_set_state (rng, inis);
+      ncm_mset_catalog_set_rng (mcat, rng);
+      ncm_rng_free (rng);
+    }
+  }
+  else if ((self->rng != NULL) && !self->readonly)
+  {
+    _ncm_mset_catalog_bin_set_key (self->bin, NCM_MSET_CATALOG_RNG_ALGO_LABEL, ncm_rng_get_algo (self->rng));
+    _ncm_mset_catalog_bin_set_key (self->bin, NCM_MSET_CATALOG_RNG_INIS_LABEL, self->rng_inis);
+    _ncm_mset_catalog_bin_set_key_int (self->bin, NCM_MSET_CATALOG_RNG_SEED_LABEL, ncm_rng_get_seed (self->rng));
+    _ncm_mset_catalog_bin_set_key_int (self->bin, NCM_MSET_CATALOG_RNG_SUBS_LABEL, self->rng_substreams ? 1 : 0);
+  }
+}
+
+static gint
+_ncm_mset_catalog_bin_get_key_int (NcmMSetCatalog *mcat, const gchar *key)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  const gchar *value          = _ncm_mset_catalog_bin_get_key (self->bin, key);
+
+  if (value == NULL)
+    g_error ("_ncm_mset_catalog_bin_get_key_int: key `%s' not found in `%s'.", key, self->file);
+
+  return atoi (value);
+}
+
+static NcmMSetCatalogFileHeader *
+_ncm_mset_catalog_bin_read_header (NcmMSetCatalog *mcat)
+{
+  NcmMSetCatalogPrivate *self  = mcat->priv;
+  NcmMSetCatalogFileHeader *fh = _ncm_mset_catalog_file_header_new ();
+  const gchar *rtype_str       = _ncm_mset_catalog_bin_get_key (self->bin, NCM_MSET_CATALOG_RTYPE_LABEL);
+  guint i;
+
+  if (rtype_str == NULL)
+    g_error ("_ncm_mset_catalog_bin_read_header: key `%s' not found in `%s'.", NCM_MSET_CATALOG_RTYPE_LABEL, self->file);
+
+  fh->first_id      = _ncm_mset_catalog_bin_get_key_int (mcat, NCM_MSET_CATALOG_FIRST_ID_LABEL);
+  fh->has_m2lnp_var = (_ncm_mset_catalog_bin_get_key (self->bin, NCM_MSET_CATALOG_M2LNP_ID_LABEL) != NULL);
+  fh->m2lnp_var     = fh->has_m2lnp_var ? _ncm_mset_catalog_bin_get_key_int (mcat, NCM_MSET_CATALOG_M2LNP_ID_LABEL) : 0;
+  fh->rtype_str     = g_strdup (rtype_str);
+  fh->nchains       = _ncm_mset_catalog_bin_get_key_int (mcat, NCM_MSET_CATALOG_NCHAINS_LABEL);
+  fh->nadd_vals     = _ncm_mset_catalog_bin_get_key_int (mcat, NCM_MSET_CATALOG_NADDVAL_LABEL);
+  fh->weighted      = _ncm_mset_catalog_bin_get_key_int (mcat, NCM_MSET_CATALOG_WEIGHTED_LABEL) ? TRUE : FALSE;
+  fh->nrows         = self->bin->nrows;
+
+  for (i = 0; i < self->bin->colnames->len; i++)
+    g_ptr_array_add (fh->colnames, g_strdup (g_ptr_array_index (self->bin->colnames, i)));
+
+  for (i = 0; i < fh->nadd_vals; i++)
+  {
+    gchar *asymbi = g_strdup_printf ("%s%d", NCM_MSET_CATALOG_ASYMB_LABEL, i + 1);
+
+    g_ptr_array_add (fh->asymbs, g_strdup (_ncm_mset_catalog_bin_get_key (self->bin, asymbi)));
+    g_free (asymbi);
+  }
+
+  return fh;
+}
+
+static void
+_ncm_mset_catalog_bin_open_create_file (NcmMSetCatalog *mcat, gboolean load_from_cat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  guint i;
+
+  g_assert (self->file != NULL);
+  g_assert (self->bin == NULL);
+
+  self->bin = _ncm_mset_catalog_bin_open (self->file, self->readonly);
+
+  if (self->bin->colnames->len > 0)
+  {
+    NcmMSetCatalogFileHeader *fh = _ncm_mset_catalog_bin_read_header (mcat);
+
+    _ncm_mset_catalog_file_header_apply (mcat, fh, load_from_cat);
+    _ncm_mset_catalog_file_header_free (fh);
+  }
+  else
+  {
+    const guint fparam_len = ncm_mset_fparam_len (self->mset);
+    GPtrArray *colnames    = _ncm_mset_catalog_file_colnames (mcat);
+
+    _ncm_mset_catalog_bin_create (self->bin, colnames);
+    g_ptr_array_unref (colnames);
+
+    _ncm_mset_catalog_bin_set_key (self->bin, NCM_MSET_CATALOG_RTYPE_LABEL, self->rtype_str);
+    _ncm_mset_catalog_bin_set_key_int (self->bin, NCM_MSET_CATALOG_NCHAINS_LABEL, self->nchains);
+    _ncm_mset_catalog_bin_set_key_int (self->bin, NCM_MSET_CATALOG_NADDVAL_LABEL, self->nadd_vals);
+    _ncm_mset_catalog_bin_set_key_int (self->bin, NCM_MSET_CATALOG_WEIGHTED_LABEL, self->weighted ? 1 : 0);
+
+    for (i = 0; i < self->nadd_vals; i++)
+    {
+      gchar *asymbi = g_strdup_printf ("%s%d", NCM_MSET_CATALOG_ASYMB_LABEL, i + 1);
+      _ncm_mset_catalog_bin_set_key (self->bin, asymbi, g_ptr_array_index (self->add_vals_symbs, i));
+      g_free (asymbi);
+    }
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      gchar *fsymbi = g_strdup_printf ("%s%d", NCM_MSET_CATALOG_FSYMB_LABEL, i + 1);
+      _ncm_mset_catalog_bin_set_key (self->bin, fsymbi, ncm_mset_fparam_symbol (self->mset, i));
+      g_free (fsymbi);
+    }
+
+    self->file_first_id = self->first_id;
+    self->file_cur_id   = self->first_id - 1;
+  }
+
+  _ncm_mset_catalog_bin_sync_rng (mcat);
+
+  if (!self->readonly)
+  {
+    _ncm_mset_catalog_bin_set_key_int (self->bin, NCM_MSET_CATALOG_FIRST_ID_LABEL, self->file_first_id);
+    _ncm_mset_catalog_bin_set_key_int (self->bin, NCM_MSET_CATALOG_M2LNP_ID_LABEL, self->m2lnp_var);
+    _ncm_mset_catalog_bin_flush (self->bin);
+  }
+
+  {
+    NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_NONE);
+    ncm_mset_save (self->mset, ser, self->mset_file, TRUE);
+    ncm_serialize_free (ser);
+  }
+}
+
+/**
+ * ncm_mset_catalog_new:
+ * @mset: a #NcmMSet
+ * @nadd_vals: number of additional values
+ * @nchains: number of different chains in the catalog (>=1)
+ * @weighted: set to TRUE whenever the catalog is weighted
+ * @...: additional values name/symbol pairs
+ *
+ * Creates a new #NcmMSetCatalog based on the #NcmFit object @fit. The catalog assumes that
+ * the @fit object will remain with the same set of free parameters during its whole lifetime.
+ *
+ * If @nchains is larger than one, the catalog will keep track of the statistics of each chain
+ * separately.
+ *
+ * Returns: (transfer full): a new #NcmMSetCatalog
+ */
+NcmMSetCatalog *
+ncm_mset_catalog_new (NcmMSet *mset, guint nadd_vals, guint nchains, gboolean weighted, ...)
+{
+  va_list ap;
+  gchar **names   = g_new (gchar *, nadd_vals + 1);
+  gchar **symbols = g_new (gchar *, nadd_vals + 1);
+  guint i;
+
+  va_start (ap, weighted);
+  for (i = 0; i < nadd_vals; i++)
+  {
+    gchar *name   = va_arg (ap, gchar *);
+    gchar *symbol = (name != NULL) ? va_arg (ap, gchar *) : NULL;
+
+    if (name == NULL || symbol == NULL)
+      g_error ("ncm_mset_catalog_new: missing %u-th name and or symbol.", i + 1);
+
+    names[i]   = name;
+    symbols[i] = symbol;
+  }
+  va_end (ap);
+
+  names[i]   = NULL;
+  symbols[i] = NULL;
+  
+  {
+    NcmMSetCatalog *mcat = g_object_new (NCM_TYPE_MSET_CATALOG,
+                                         "mset",             mset,
+                                         "nadd-vals",        nadd_vals,
+                                         "nchains",          nchains,
+                                         "weighted",         weighted,
+                                         "nadd-val-names",   names,
+                                         "nadd-val-symbols", symbols,
+                                         NULL);
+
+		g_free (names);
+		g_free (symbols);
+		return mcat;
+  }
+}
+
+/**
+ * ncm_mset_catalog_new_array:
+ * @mset: a #NcmMSet
+ * @nadd_vals: number of additional values
+ * @nchains: number of different chains in the catalog (>=1)
+ * @weighted: set to TRUE whenever the catalog is weighted
+ * @names: (array zero-terminated=1): additional values name NULL-terminated array
+ * @symbols: (array zero-terminated=1): additional values symbol NULL-terminated array
+ * 
+ * Creates a new #NcmMSetCatalog based on the #NcmFit object @fit. The catalog assumes that
+ * the @fit object will remain with the same set of free parameters during its whole lifetime.
+ * 
+ * If @nchains is larger than one, the catalog will keep track of the statistics of each chain
+ * separately.
+ * 
+ * Returns: (transfer full): a new #NcmMSetCatalog
+ */
+NcmMSetCatalog *
+ncm_mset_catalog_new_array (NcmMSet *mset, guint nadd_vals, guint nchains, gboolean weighted, gchar **names, gchar **symbols)
+{
+  NcmMSetCatalog *mcat = g_object_new (NCM_TYPE_MSET_CATALOG,
+                                       "mset",             mset,
+                                       "nadd-vals",        nadd_vals,
+                                       "nchains",          nchains,
+                                       "weighted",         weighted,
+                                       "nadd-val-names",   names,
+                                       "nadd-val-symbols", symbols,
+                                       NULL);
+
+  return mcat;  
+}
+
+/**
+ * ncm_mset_catalog_new_from_file:
+ * @filename: filename of the catalog fits
+ * @burnin: Burn-in size
+ *
+ * Creates a new #NcmMSetCatalog from the catalog in the file @file.
+ * It will use also the mset file (same name but with .mset extension).
+ *
+ *
+ * Returns: (transfer full): a new #NcmMSetCatalog
+ */
+NcmMSetCatalog *
+ncm_mset_catalog_new_from_file (const gchar *filename, glong burnin)
+{
+  NcmMSetCatalog *mcat = g_object_new (NCM_TYPE_MSET_CATALOG,
+                                       "filename", filename,
+                                       "burnin", burnin,
+                                       NULL);
+  return mcat;
+}
+
+/**
+ * ncm_mset_catalog_new_from_file_ro:
+ * @filename: filename of the catalog fits
+ * @burnin: Burn-in size
+ *
+ * Creates a new #NcmMSetCatalog from the catalog in the file @file.
+ * The @file is opened in a read-only fashion.
+ * It will use also the mset file (same name but with .mset extension).
+ *
+ *
+ * Returns: (transfer full): a new #NcmMSetCatalog
+ */
+NcmMSetCatalog *
+ncm_mset_catalog_new_from_file_ro (const gchar *filename, glong burnin)
+{
+  NcmMSetCatalog *mcat = g_object_new (NCM_TYPE_MSET_CATALOG,
+                                       "filename", filename,
+                                       "read-only", TRUE,
+                                       "burnin", burnin,
+                                       NULL);
+  return mcat;
+}
+
+/**
+ * ncm_mset_catalog_ref:
+ * @mcat: a #NcmMSetCatalog
+ *
+ * Increases the reference count of @mcat atomically.
+ *
+ * Returns: (transfer full): @mcat.
+ */
+NcmMSetCatalog *
+ncm_mset_catalog_ref (NcmMSetCatalog *mcat)
+{
+  return g_object_ref (mcat);
+}
+
+/**
+ * ncm_mset_catalog_free:
+ * @mcat: a #NcmMSetCatalog
+ *
+ * Decreases the reference count of @mcat atomically.
+ *
+ */
+void
+ncm_mset_catalog_free (NcmMSetCatalog *mcat)
+{
+  ncm_mset_catalog_sync (mcat, TRUE);
+  g_object_unref (mcat);
+}
+
+/**
+ * ncm_mset_catalog_clear:
+ * @mcat: a #NcmMSetCatalog
+ *
+ * Decrese the reference count of *@mcat atomically and sets the pointer *@mcat to null.
+ *
+ */
+void
+ncm_mset_catalog_clear (NcmMSetCatalog **mcat)
+{
+  if (*mcat != NULL)
+    ncm_mset_catalog_sync (*mcat, TRUE);
+  g_clear_object (mcat);
+}
+
+#ifdef NUMCOSMO_HAVE_CFITSIO
+
+static void
+_ncm_fits_update_key_str (fitsfile *fptr, gchar *keyname, gchar *value, gchar *comment, gboolean overwrite)
 {
   gint status = 0;
   if (overwrite)
@@ -1030,6 +2178,7 @@ _ncm_mset_catalog_sync_rng (NcmMSetCatalog *mcat)
   if (status == 0)
   {
     glong seed = 0;
+    gint subs  = 0;
     gchar *inis = NULL;
     fits_read_key_lng (self->fptr, NCM_MSET_CATALOG_RNG_SEED_LABEL,
                    &seed, NULL, &status);
@@ -1038,6 +2187,16 @@ _ncm_mset_catalog_sync_rng (NcmMSetCatalog *mcat)
     fits_read_key_longstr (self->fptr, NCM_MSET_CATALOG_RNG_INIS_LABEL, &inis, NULL, &status);
     NCM_FITS_ERROR (status);
 
+    /* Older catalogs do not have the substreams key. */
+    fits_read_key (self->fptr, TINT, NCM_MSET_CATALOG_RNG_SUBS_LABEL, &subs, NULL, &status);
+    if (status == KEY_NO_EXIST)
+    {
+      status = 0;
+      subs   = 0;
+    }
+    NCM_FITS_ERROR (status);
+    self->rng_substreams = (subs != 0);
+
     if (self->rng != NULL)
     {
       const gchar *cat_algo = ncm_rng_get_algo (self->rng);
@@ -1047,6 +2206,9 @@ _ncm_mset_catalog_sync_rng (NcmMSetCatalog *mcat)
     else
     {
       NcmRNG *rng = ncm_rng_new (key_text);
+
+      /* The substreams are derived from the seed, restore it before the state. */
+      ncm_rng_set_seed (rng, (gulong) seed);
       ncm_rng_set_state (rng, inis);
       ncm_mset_catalog_set_rng (mcat, rng);
       ncm_rng_free (rng);
@@ -1065,343 +2227,137 @@ _ncm_mset_catalog_sync_rng (NcmMSetCatalog *mcat)
       _ncm_fits_update_key_str (self->fptr, NCM_MSET_CATALOG_RNG_ALGO_LABEL, (gchar *)ncm_rng_get_algo (self->rng), "RNG Algorithm name.", FALSE);
       _ncm_fits_update_key_longstr (self->fptr, NCM_MSET_CATALOG_RNG_INIS_LABEL, self->rng_inis, NULL, FALSE);
       _ncm_fits_update_key_ulong (self->fptr, NCM_MSET_CATALOG_RNG_SEED_LABEL, seed, "RNG Algorithm seed.", FALSE);
+      _ncm_fits_update_key_int (self->fptr, NCM_MSET_CATALOG_RNG_SUBS_LABEL, self->rng_substreams ? 1 : 0, "Whether each realization uses its own RNG substream.", FALSE);
     }
   }
   else
     NCM_FITS_ERROR (status);
 }
 
-static void
-_ncm_mset_catalog_open_create_file (NcmMSetCatalog *mcat, gboolean load_from_cat)
+static NcmMSetCatalogFileHeader *
+_ncm_mset_catalog_fits_read_header (NcmMSetCatalog *mcat)
 {
-  NcmMSetCatalogPrivate *self = mcat->priv;
-  guint fparam_len = ncm_mset_fparam_len (self->mset);
+  NcmMSetCatalogPrivate *self  = mcat->priv;
+  NcmMSetCatalogFileHeader *fh = _ncm_mset_catalog_file_header_new ();
   gchar key_text[FLEN_VALUE];
+  gchar colname[FLEN_VALUE];
+  gint cindex = 0;
   gint status = 0;
   guint i;
 
-  g_assert (self->file != NULL);
-  g_assert (self->fptr == NULL);
+  fits_read_key (self->fptr, TINT, NCM_MSET_CATALOG_FIRST_ID_LABEL,
+                 &fh->first_id, NULL, &status);
+  NCM_FITS_ERROR (status);
 
-  if (g_file_test (self->file, G_FILE_TEST_EXISTS))
+  fits_read_key (self->fptr, TINT, NCM_MSET_CATALOG_M2LNP_ID_LABEL,
+                 &fh->m2lnp_var, NULL, &status);
+  if (status == KEY_NO_EXIST)
+  {
+    fh->has_m2lnp_var = FALSE;
+    status            = 0;
+  }
+  else
   {
-    gboolean weighted       = FALSE;
-    gint nchains            = 0;
-    gint nadd_vals          = 0;
-    gboolean remap          = FALSE;
-    GPtrArray *remap_remove = g_ptr_array_new ();
-    glong nrows;
-
-    g_ptr_array_set_free_func (remap_remove, g_free);
-
-    if (self->readonly)
-    {
-      fits_open_file (&self->fptr, self->file, READONLY, &status);
-      NCM_FITS_ERROR (status);      
-    }
-    else
-    {
-      fits_open_file (&self->fptr, self->file, READWRITE, &status);
-      NCM_FITS_ERROR (status);
-    }
-
-    fits_movnam_hdu (self->fptr, BINARY_TBL, NCM_MSET_CATALOG_EXTNAME, 0, &status);
-    NCM_FITS_ERROR (status);
-
-    fits_read_key (self->fptr, TINT, NCM_MSET_CATALOG_FIRST_ID_LABEL,
-                   &self->file_first_id, NULL, &status);
-    NCM_FITS_ERROR (status);
-
-    {
-      const gint m2lnp_var = self->m2lnp_var;
-      
-      fits_read_key (self->fptr, TINT, NCM_MSET_CATALOG_M2LNP_ID_LABEL,
-                     &self->m2lnp_var, NULL, &status);
-      if (status == KEY_NO_EXIST)
-      {
-        g_warning ("_ncm_mset_catalog_open_create_file: catalog does not contain `%s' key, using original value `%d'.",
-                   NCM_MSET_CATALOG_M2LNP_ID_LABEL,
-                   m2lnp_var);
-        self->m2lnp_var = m2lnp_var;
-      }
-      else
-      {
-        NCM_FITS_ERROR (status);
-      }
-      status = 0;
-    }
-    
-    fits_read_key (self->fptr, TSTRING, NCM_MSET_CATALOG_RTYPE_LABEL,
-                   key_text, NULL, &status);
     NCM_FITS_ERROR (status);
+    fh->has_m2lnp_var = TRUE;
+  }
 
-    if (load_from_cat)
-    {
-      ncm_mset_catalog_set_run_type (mcat, key_text);
-    }
-    else if (strcmp (self->rtype_str, key_text) != 0)
-      g_error ("_ncm_mset_catalog_open_create_file: incompatible run type strings from catalog and file, catalog: `%s' file: `%s'.",
-               self->rtype_str, key_text);
+  fits_read_key (self->fptr, TSTRING, NCM_MSET_CATALOG_RTYPE_LABEL,
+                 key_text, NULL, &status);
+  NCM_FITS_ERROR (status);
+  fh->rtype_str = g_strdup (key_text);
 
-    fits_read_key (self->fptr, TINT, NCM_MSET_CATALOG_NCHAINS_LABEL,
-                   &nchains, NULL, &status);
-    NCM_FITS_ERROR (status);
-    g_assert_cmpint (nchains, >, 0);
+  fits_read_key (self->fptr, TINT, NCM_MSET_CATALOG_NCHAINS_LABEL,
+                 &fh->nchains, NULL, &status);
+  NCM_FITS_ERROR (status);
 
-    if (load_from_cat)
-    {
-      self->nchains = nchains;
-    }
-    else if (nchains != self->nchains)
-      g_error ("_ncm_mset_catalog_open_create_file: catalog has %d chains and file contains %d.", self->nchains, nchains);
+  fits_read_key (self->fptr, TINT, NCM_MSET_CATALOG_NADDVAL_LABEL,
+                 &fh->nadd_vals, NULL, &status);
+  NCM_FITS_ERROR (status);
 
-    fits_read_key (self->fptr, TINT, NCM_MSET_CATALOG_NADDVAL_LABEL,
-                   &nadd_vals, NULL, &status);
-    NCM_FITS_ERROR (status);
+  fits_read_key (self->fptr, TLOGICAL, NCM_MSET_CATALOG_WEIGHTED_LABEL,
+                 &fh->weighted, NULL, &status);
+  NCM_FITS_ERROR (status);
 
-    if (load_from_cat)
-    {
-      self->nadd_vals = nadd_vals;
-    }
-    else if (nadd_vals != self->nadd_vals)
-      g_error ("_ncm_mset_catalog_open_create_file: catalog has %d additional values and file contains %d.", self->nadd_vals, nadd_vals);
+  fits_get_num_rows (self->fptr, &fh->nrows, &status);
+  NCM_FITS_ERROR (status);
 
-    fits_read_key (self->fptr, TLOGICAL, NCM_MSET_CATALOG_WEIGHTED_LABEL,
-                   &weighted, NULL, &status);
-    NCM_FITS_ERROR (status);
+  i = 0;
+  while (fits_get_colname (self->fptr, CASESEN, "*", colname, &cindex, &status) == COL_NOT_UNIQUE)
+  {
+    g_assert_cmpint (i + 1, ==, cindex);
+    g_ptr_array_add (fh->colnames, g_strdup (colname));
 
-    if (load_from_cat)
-    {
-      self->weighted = weighted ? TRUE : FALSE;
-    }
-    else if ((weighted && !self->weighted) || (!weighted && self->weighted))
-      g_error ("_ncm_mset_catalog_open_create_file: catalog %s weighted and file %s.",
-               self->weighted ? "is" : "is not",
-               weighted ? "is" : "is not");
+    status = COL_NOT_UNIQUE;
+    i++;
+  }
+  status = 0;
 
-    fits_get_num_rows (self->fptr, &nrows, &status);
-    NCM_FITS_ERROR (status);
+  for (i = 0; i < fh->nadd_vals; i++)
+  {
+    gchar *asymbi = g_strdup_printf ("%s%d", NCM_MSET_CATALOG_ASYMB_LABEL, i + 1);
 
-    if (nrows < self->burnin)
+    fits_read_key (self->fptr, TSTRING, asymbi, key_text, NULL, &status);
+    if (status == KEY_NO_EXIST)
     {
-      g_error ("_ncm_mset_catalog_open_create_file: burnin larger than the catalogue size %ld <=> %ld",
-               self->burnin, nrows);
+      g_ptr_array_add (fh->asymbs, NULL);
+      status = 0;
     }
     else
     {
-      nrows -= self->burnin;
-    }
-
-    if (self->file_first_id != self->first_id)
-    {
-      if (nrows == 0)
-      {
-        if (self->file_first_id != 0)
-          g_warning ("_ncm_mset_catalog_open_create_file: Empty data file with "NCM_MSET_CATALOG_FIRST_ID_LABEL" different from first_id: %d != %d. Setting to first_id.\n",
-                     self->file_first_id, self->first_id);
-        self->file_first_id = self->first_id;
-      }
-      else if (ncm_mset_catalog_is_empty (mcat))
-      {
-        if (self->first_id != 0)
-          g_warning ("_ncm_mset_catalog_open_create_file: Empty memory catalog with first_id different from "NCM_MSET_CATALOG_FIRST_ID_LABEL": %d != %d. Setting to "NCM_MSET_CATALOG_FIRST_ID_LABEL".\n",
-                     self->first_id, self->file_first_id);
-
-        self->first_id = self->file_first_id;
-        self->cur_id   = self->file_first_id - 1;
-      }
+      NCM_FITS_ERROR (status);
+      g_ptr_array_add (fh->asymbs, g_strdup (key_text));
     }
-    self->file_cur_id = self->file_first_id + nrows - 1;
-
-    if (load_from_cat)
-    {
-      gchar colname[FLEN_VALUE];
-      gint cindex = 0;
-      guint total = fparam_len + self->nadd_vals + (self->weighted ? 1 : 0);
-
-      g_array_set_size (self->porder, total);
 
-      i = 0;
-      while (fits_get_colname (self->fptr, CASESEN, "*", colname, &cindex, &status) == COL_NOT_UNIQUE)
-      {
-        gchar *d_colname = g_strdup (colname);
-        g_assert_cmpint (i + 1, ==, cindex);
+    g_free (asymbi);
+  }
 
-        status = 0;
+  return fh;
+}
 
-        if (i < self->nadd_vals)
-        {
-          g_ptr_array_add (self->add_vals_names, d_colname);
-          g_array_index (self->porder, gint, i) = cindex;
+static void
+_ncm_mset_catalog_fits_open_create_file (NcmMSetCatalog *mcat, gboolean load_from_cat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  gint status = 0;
+  guint i;
 
-          {
-            gchar symbol_s[FLEN_VALUE];
-            gchar *symbol;
-            gchar *asymbi = g_strdup_printf ("%s%d", NCM_MSET_CATALOG_ASYMB_LABEL, i + 1);
-
-            fits_read_key (self->fptr, TSTRING, asymbi, &symbol_s, NULL, &status);
-            if (status == KEY_NO_EXIST)
-            {
-              symbol = g_strdup ("no-symbol");
-              status = 0;
-            }
-            else
-            {
-              symbol = g_strdup (symbol_s);
-              NCM_FITS_ERROR (status);
-            }
-
-            g_ptr_array_add (self->add_vals_symbs, symbol);
-
-            g_free (asymbi);
-          }  
-        }
-        else
-        {
-          NcmMSetPIndex *pi = ncm_mset_param_get_by_full_name (self->mset, d_colname);
-          if (pi == NULL)
-          {
-            g_error ("_ncm_mset_catalog_open_create_file: cannot find parameter `%s' in mset file.", d_colname);
-          }
-          else
-          {
-            NcmParamType ftype = ncm_mset_param_get_ftype (self->mset, pi->mid, pi->pid);
-            if (ftype != NCM_PARAM_TYPE_FREE)
-            {
-              g_warning ("_ncm_mset_catalog_open_create_file: parameter `%s' found but not free on the catalog, setting it to NCM_PARAM_TYPE_FREE.",
-                         d_colname);
-              ncm_mset_param_set_ftype (self->mset, pi->mid, pi->pid, NCM_PARAM_TYPE_FREE);
-              remap = TRUE;
-            }
-            ncm_mset_pindex_free (pi);
-          }
-          g_free (d_colname);
-        }
+  g_assert (self->file != NULL);
+  g_assert (self->fptr == NULL);
 
-        status = COL_NOT_UNIQUE;
-        i++;
-      }
-      status = 0;
-    }
-    else
-    {
-      for (i = 0; i < self->nadd_vals; i++)
-      {
-        const gchar *cname   = g_ptr_array_index (self->add_vals_names, i);
-        const gchar *csymbol = g_ptr_array_index (self->add_vals_symbs, i);
-        gchar *asymbi        = g_strdup_printf ("%s%d", NCM_MSET_CATALOG_ASYMB_LABEL, i + 1);
-        gchar symbol_s[FLEN_VALUE];
-        gint cindex = 0;
-        
-        if (fits_get_colnum (self->fptr, CASESEN, (gchar *)cname, &cindex, &status))
-          g_error ("_ncm_mset_catalog_open_create_file: Additional column %s not found, invalid fits file.", cname);
-
-        fits_read_key (self->fptr, TSTRING, asymbi, &symbol_s, NULL, &status);
-        if (status == KEY_NO_EXIST)
-        {
-          g_error ("_ncm_mset_catalog_open_create_file: symbol %s not found", asymbi);
-        }
-        else
-        {
-          g_assert_cmpstr (symbol_s, ==, csymbol);
-        }
-        
-        if (cindex != i + 1)
-        {
-          g_error ("_ncm_mset_catalog_open_create_file: Additional column %s is not the %d-th column [%d], invalid fits file.",
-                   cname, i + 1, cindex);
-        }
-        g_array_index (self->porder, gint, i) = cindex;
-      }
-    }
+  if (g_file_test (self->file, G_FILE_TEST_EXISTS))
+  {
+    NcmMSetCatalogFileHeader *fh;
 
-    if (remap)
+    if (self->readonly)
     {
-      guint total;
-
-      ncm_mset_prepare_fparam_map (self->mset);
-      
-      fparam_len = ncm_mset_fparam_len (self->mset);
-      total      = fparam_len + self->nadd_vals + (self->weighted ? 1 : 0);
-
-      g_array_set_size (self->porder, total);
-      remap = FALSE;
+      fits_open_file (&self->fptr, self->file, READONLY, &status);
+      NCM_FITS_ERROR (status);      
     }
-
-    for (i = 0; i < fparam_len; i++)
+    else
     {
-      const gchar *fparam_fullname = ncm_mset_fparam_full_name (self->mset, i);
-      if (fits_get_colnum (self->fptr, CASESEN, (gchar *)fparam_fullname, &g_array_index (self->porder, gint, i + self->nadd_vals), &status))
-      {                /* I don't like this too ^^^^^^^^^  */
-        g_warning ("_ncm_mset_catalog_open_create_file: Parameter `%s' set free in mset but not found on the fits file, setting it to NCM_PARAM_TYPE_FIXED.", fparam_fullname);
-        g_ptr_array_add (remap_remove, (gpointer) g_strdup (fparam_fullname));
-        remap  = TRUE;
-        status = 0;
-      }
+      fits_open_file (&self->fptr, self->file, READWRITE, &status);
+      NCM_FITS_ERROR (status);
     }
 
-    if (remap)
-    {
-      guint total;
-      for (i = 0; i < remap_remove->len; i++)
-      {
-        NcmMSetPIndex *pi = ncm_mset_param_get_by_full_name (self->mset, g_ptr_array_index (remap_remove, i));
-        if (pi == NULL)
-        {
-          g_error ("_ncm_mset_catalog_open_create_file: unknown error should never happen! Cannot find parameter `%s' in mset file.", 
-                   (gchar *)g_ptr_array_index (remap_remove, i));
-        }
-        else
-        {
-          ncm_mset_param_set_ftype (self->mset, pi->mid, pi->pid, NCM_PARAM_TYPE_FIXED);
-          ncm_mset_pindex_free (pi);
-        }
-      }
-
-      ncm_mset_prepare_fparam_map (self->mset);
-      
-      fparam_len = ncm_mset_fparam_len (self->mset);
-      total      = fparam_len + self->nadd_vals + (self->weighted ? 1 : 0);
-
-      g_array_set_size (self->porder, total);
-
-      for (i = 0; i < fparam_len; i++)
-      {
-        const gchar *fparam_fullname = ncm_mset_fparam_full_name (self->mset, i);
-        if (fits_get_colnum (self->fptr, CASESEN, (gchar *)fparam_fullname, &g_array_index (self->porder, gint, i + self->nadd_vals), &status))
-        {                /* I don't like this too ^^^^^^^^^  */
-          g_error ("_ncm_mset_catalog_open_create_file: Parameter `%s' set free in mset but not found on the fits file, this should never happen!", fparam_fullname);
-        }
-      }
-
-      remap = FALSE;      
-    }
+    fits_movnam_hdu (self->fptr, BINARY_TBL, NCM_MSET_CATALOG_EXTNAME, 0, &status);
+    NCM_FITS_ERROR (status);
 
-    g_ptr_array_unref (remap_remove);
+    fh = _ncm_mset_catalog_fits_read_header (mcat);
+    _ncm_mset_catalog_file_header_apply (mcat, fh, load_from_cat);
+    _ncm_mset_catalog_file_header_free (fh);
   }
   else
   {
-    GPtrArray *ttype_array = g_ptr_array_sized_new (10);
-    GPtrArray *tform_array = g_ptr_array_sized_new (10);
+    const guint fparam_len = ncm_mset_fparam_len (self->mset);
+    GPtrArray *ttype_array = _ncm_mset_catalog_file_colnames (mcat);
+    GPtrArray *tform_array = g_ptr_array_sized_new (ttype_array->len);
+
     fits_create_file (&self->fptr, self->file, &status);
     NCM_FITS_ERROR (status);
 
-    for (i = 0; i < self->nadd_vals; i++)
-    {
-      const gchar *cname = g_ptr_array_index (self->add_vals_names, i);
-      g_ptr_array_add (ttype_array, (gchar *)cname);
-      g_ptr_array_add (tform_array, "1D");
-      g_array_index (self->porder, gint, i) = tform_array->len;
-    }
-
-    for (i = 0; i < fparam_len; i++)
-    {
-      const gchar *fparam_fullname = ncm_mset_fparam_full_name (self->mset, i);
-      g_ptr_array_add (ttype_array, (gchar *)fparam_fullname);
-      /* I don't like this too ^^^^^^^^^  */
+    for (i = 0; i < ttype_array->len; i++)
       g_ptr_array_add (tform_array, "1D");
-      g_array_index (self->porder, gint, i + self->nadd_vals) = tform_array->len;
-    }
 
     /* append a new empty binary table onto the FITS file */
     fits_create_tbl (self->fptr, BINARY_TBL, 0, fparam_len + self->nadd_vals, (gchar **)ttype_array->pdata, (gchar **)tform_array->pdata,
@@ -1471,14 +2427,33 @@ _ncm_mset_catalog_open_create_file (NcmMSetCatalog *mcat, gboolean load_from_cat
   }
 
   {
-    NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_NONE);
-    ncm_mset_save (self->mset, ser, self->mset_file, TRUE);
-    ncm_serialize_free (ser);
+    NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_NONE);
+    ncm_mset_save (self->mset, ser, self->mset_file, TRUE);
+    ncm_serialize_free (ser);
+  }
+}
+
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+
+static void
+_ncm_mset_catalog_open_create_file (NcmMSetCatalog *mcat, gboolean load_from_cat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+  if (_ncm_mset_catalog_file_is_bin (self->file))
+  {
+    _ncm_mset_catalog_bin_open_create_file (mcat, load_from_cat);
+  }
+  else
+  {
+#ifdef NUMCOSMO_HAVE_CFITSIO
+    _ncm_mset_catalog_fits_open_create_file (mcat, load_from_cat);
+#else
+    g_error ("_ncm_mset_catalog_open_create_file: cannot open fits file `%s' without cfitsio.", self->file);
+#endif /* NUMCOSMO_HAVE_CFITSIO */
   }
 }
 
-#endif /* NUMCOSMO_HAVE_CFITSIO */
-
 static void
 _ncm_mset_catalog_set_add_val_name_array (NcmMSetCatalog *mcat, gchar **names)
 {
@@ -1532,7 +2507,6 @@ _ncm_mset_catalog_set_add_val_symbol_array (NcmMSetCatalog *mcat, gchar **symbol
 void
 ncm_mset_catalog_set_file (NcmMSetCatalog *mcat, const gchar *filename)
 {
-#ifdef NUMCOSMO_HAVE_CFITSIO
   NcmMSetCatalogPrivate *self = mcat->priv;
   if (!self->constructed)
   {
@@ -1552,9 +2526,14 @@ ncm_mset_catalog_set_file (NcmMSetCatalog *mcat, const gchar *filename)
   if (filename == NULL)
     return;
 
+#ifndef NUMCOSMO_HAVE_CFITSIO
+  if (!_ncm_mset_catalog_file_is_bin (filename))
+    g_error ("ncm_mset_catalog_set_file: cannot set fits file without cfitsio, use the binary format (`%s' extension).", NCM_MSET_CATALOG_BIN_EXT);
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+
   self->file = g_strdup (filename);
   {
-    gchar *base_name = ncm_util_basename_fits (self->file);
+    gchar *base_name = _ncm_mset_catalog_file_basename (self->file);
     self->mset_file  = g_strdup_printf ("%s.mset", base_name);
     g_free (base_name);
   }
@@ -1564,9 +2543,6 @@ ncm_mset_catalog_set_file (NcmMSetCatalog *mcat, const gchar *filename)
     _ncm_mset_catalog_open_create_file (mcat, FALSE);
     ncm_mset_catalog_sync (mcat, TRUE);
   }
-#else
-  g_error ("ncm_mset_catalog_set_file: cannot set file without cfitsio.");
-#endif /* NUMCOSMO_HAVE_CFITSIO */
 
   self->first_flush = TRUE;
 }
@@ -1628,6 +2604,12 @@ ncm_mset_catalog_set_first_id (NcmMSetCatalog *mcat, gint first_id)
 
   self->file_first_id = first_id;
   self->file_cur_id   = first_id - 1;
+  if (self->bin != NULL)
+  {
+    if (!self->readonly)
+      _ncm_mset_catalog_bin_set_key_int (self->bin, NCM_MSET_CATALOG_FIRST_ID_LABEL, self->file_first_id);
+    ncm_mset_catalog_sync (mcat, TRUE);
+  }
 #ifdef NUMCOSMO_HAVE_CFITSIO
   if (self->fptr != NULL)
   {
@@ -1668,6 +2650,10 @@ ncm_mset_catalog_set_run_type (NcmMSetCatalog *mcat, const gchar *rtype_str)
   }
 
   self->rtype_str = g_strdup (rtype_str);
+  if ((self->bin != NULL) && !self->readonly)
+  {
+    _ncm_mset_catalog_bin_set_key (self->bin, NCM_MSET_CATALOG_RTYPE_LABEL, self->rtype_str);
+  }
 #ifdef NUMCOSMO_HAVE_CFITSIO
   if (self->fptr != NULL)
   {
@@ -1699,6 +2685,11 @@ ncm_mset_catalog_set_rng (NcmMSetCatalog *mcat, NcmRNG *rng)
   
   self->rng_inis = ncm_rng_get_state (rng);
   self->rng_stat = g_strdup (self->rng_inis);
+  if (self->bin != NULL)
+  {
+    _ncm_mset_catalog_bin_sync_rng (mcat);
+    _ncm_mset_catalog_bin_flush (self->bin);
+  }
 #ifdef NUMCOSMO_HAVE_CFITSIO
   if (self->fptr != NULL)
   {
@@ -1714,9 +2705,47 @@ ncm_mset_catalog_set_rng (NcmMSetCatalog *mcat, NcmRNG *rng)
 #endif /* NUMCOSMO_HAVE_CFITSIO */
 }
 
+/**
+ * ncm_mset_catalog_set_rng_substreams:
+ * @mcat: a #NcmMSetCatalog
+ * @enable: whether the rows were generated using RNG substreams
+ *
+ * Records whether each row was generated using its own substream of the
+ * catalog #NcmRNG (see ncm_rng_substream_new()) instead of the catalog 
+ * #NcmRNG itself. Together with the RNG seed this determines how to 
+ * reproduce the rows, so it cannot change in a non-empty catalog.
+ *
+ */
+void
+ncm_mset_catalog_set_rng_substreams (NcmMSetCatalog *mcat, gboolean enable)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+  enable = enable ? TRUE : FALSE;
+  if (enable == self->rng_substreams)
+    return;
+
+  if (!ncm_mset_catalog_is_empty (mcat))
+    g_error ("ncm_mset_catalog_set_rng_substreams: cannot change the RNG substreams mode in a non-empty catalog, actual: %s new: %s.",
+             self->rng_substreams ? "TRUE" : "FALSE", enable ? "TRUE" : "FALSE");
+
+  self->rng_substreams = enable;
+
+  if ((self->bin != NULL) && !self->readonly)
+  {
+    _ncm_mset_catalog_bin_set_key_int (self->bin, NCM_MSET_CATALOG_RNG_SUBS_LABEL, self->rng_substreams ? 1 : 0);
+  }
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  if ((self->fptr != NULL) && !self->readonly)
+  {
+    _ncm_fits_update_key_int (self->fptr, NCM_MSET_CATALOG_RNG_SUBS_LABEL, self->rng_substreams ? 1 : 0, "Whether each realization uses its own RNG substream.", TRUE);
+  }
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+}
+
 #ifdef NUMCOSMO_HAVE_CFITSIO
 static void
-_ncm_mset_catalog_flush_file (NcmMSetCatalog *mcat)
+_ncm_mset_catalog_fits_flush_file (NcmMSetCatalog *mcat)
 {
   NcmMSetCatalogPrivate *self = mcat->priv;
   gint status = 0;
@@ -1740,23 +2769,7 @@ _ncm_mset_catalog_flush_file (NcmMSetCatalog *mcat)
 }
 
 static void
-_ncm_mset_catalog_close_file (NcmMSetCatalog *mcat)
-{
-  NcmMSetCatalogPrivate *self = mcat->priv;
-  gint status = 0;
-  if (self->fptr != NULL)
-  {
-    ncm_mset_catalog_sync (mcat, FALSE);
-    fits_close_file (self->fptr, &status);
-    NCM_FITS_ERROR (status);
-    self->fptr = NULL;
-    
-    g_clear_pointer (&self->file, g_free);
-  }
-}
-
-static void
-_ncm_mset_catalog_write_row (NcmMSetCatalog *mcat, NcmVector *row, guint row_index)
+_ncm_mset_catalog_fits_write_row (NcmMSetCatalog *mcat, NcmVector *row, guint row_index)
 {
   NcmMSetCatalogPrivate *self = mcat->priv;
   gint status = 0;
@@ -1774,7 +2787,7 @@ _ncm_mset_catalog_write_row (NcmMSetCatalog *mcat, NcmVector *row, guint row_ind
 }
 
 static void
-_ncm_mset_catalog_read_row (NcmMSetCatalog *mcat, NcmVector *row, guint row_index)
+_ncm_mset_catalog_fits_read_row (NcmMSetCatalog *mcat, NcmVector *row, guint row_index)
 {
   NcmMSetCatalogPrivate *self = mcat->priv;
   guint i;
@@ -1793,6 +2806,168 @@ _ncm_mset_catalog_read_row (NcmMSetCatalog *mcat, NcmVector *row, guint row_inde
 }
 #endif /* NUMCOSMO_HAVE_CFITSIO */
 
+static void
+_ncm_mset_catalog_flush_file (NcmMSetCatalog *mcat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+  if (self->bin != NULL)
+    _ncm_mset_catalog_bin_flush (self->bin);
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  else
+    _ncm_mset_catalog_fits_flush_file (mcat);
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+}
+
+static void
+_ncm_mset_catalog_close_file (NcmMSetCatalog *mcat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+  if (self->bin != NULL)
+  {
+    ncm_mset_catalog_sync (mcat, FALSE);
+    g_clear_pointer (&self->bin, _ncm_mset_catalog_bin_free);
+
+    g_clear_pointer (&self->file, g_free);
+  }
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  if (self->fptr != NULL)
+  {
+    gint status = 0;
+
+    ncm_mset_catalog_sync (mcat, FALSE);
+    fits_close_file (self->fptr, &status);
+    NCM_FITS_ERROR (status);
+    self->fptr = NULL;
+    
+    g_clear_pointer (&self->file, g_free);
+  }
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+}
+
+static gboolean
+_ncm_mset_catalog_file_is_open (NcmMSetCatalog *mcat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  if (self->fptr != NULL)
+    return TRUE;
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+
+  return (self->bin != NULL);
+}
+
+/*
+ * Reads the row_index-th row (one-based, as in fits) of the file.
+ */
+static void
+_ncm_mset_catalog_read_row (NcmMSetCatalog *mcat, NcmVector *row, guint row_index)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+  if (self->bin != NULL)
+    _ncm_mset_catalog_bin_read_row (self->bin, row, row_index - 1 + self->burnin, self->porder);
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  else
+    _ncm_mset_catalog_fits_read_row (mcat, row, row_index);
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+}
+
+/*
+ * Inserts nrows rows from pstats, starting at the row offset, 
+ * after the offset-th row of the file. Returns FALSE and sets
+ * error when the binary file could not be rewritten.
+ */
+static gboolean
+_ncm_mset_catalog_insert_rows (NcmMSetCatalog *mcat, guint offset, guint nrows, GError **error)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+  if (self->bin != NULL)
+  {
+    if (offset + self->burnin == self->bin->nrows)
+      _ncm_mset_catalog_bin_append_rows (self->bin, self->pstats, offset, nrows, self->porder);
+    else if (offset == 0)
+      return _ncm_mset_catalog_bin_rewrite (self->bin, self->pstats, nrows, self->porder, TRUE, error);
+    else
+      g_error ("_ncm_mset_catalog_insert_rows: cannot insert rows in the middle of the binary file `%s'.", self->file);
+  }
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  else
+  {
+    gint status = 0;
+    guint i;
+
+    fits_insert_rows (self->fptr, offset, nrows, &status);
+    NCM_FITS_ERROR (status);
+
+    for (i = 0; i < nrows; i++)
+    {
+      NcmVector *row = ncm_stats_vec_peek_row (self->pstats, offset + i);
+      _ncm_mset_catalog_fits_write_row (mcat, row, offset + i + 1);
+    }
+  }
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+
+  return TRUE;
+}
+
+static void
+_ncm_mset_catalog_update_key_longstr (NcmMSetCatalog *mcat, const gchar *label, const gchar *value)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+  if (self->bin != NULL)
+    _ncm_mset_catalog_bin_set_key (self->bin, label, value);
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  else
+  {
+    gint status = 0;
+    fits_update_key_longstr (self->fptr, (gchar *) label, (gchar *) value, NULL, &status);
+    NCM_FITS_ERROR (status);
+  }
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+}
+
+static gchar *
+_ncm_mset_catalog_read_key_longstr (NcmMSetCatalog *mcat, const gchar *label)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+  if (self->bin != NULL)
+  {
+    const gchar *value = _ncm_mset_catalog_bin_get_key (self->bin, label);
+
+    if (value == NULL)
+      g_error ("_ncm_mset_catalog_read_key_longstr: key `%s' not found in `%s'.", label, self->file);
+
+    return g_strdup (value);
+  }
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  else
+  {
+    gchar *value = NULL;
+    gchar *res;
+    gint status = 0;
+
+    fits_read_key_longstr (self->fptr, (gchar *) label, &value, NULL, &status);
+    NCM_FITS_ERROR (status);
+
+    res = g_strdup (value);
+
+    fits_free_memory (value, &status);
+    NCM_FITS_ERROR (status);
+
+    return res;
+  }
+#else
+  g_assert_not_reached ();
+  return NULL;
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+}
+
 static void _ncm_mset_catalog_post_update (NcmMSetCatalog *mcat, NcmVector *x);
 
 /**
@@ -1806,9 +2981,7 @@ static void _ncm_mset_catalog_post_update (NcmMSetCatalog *mcat, NcmVector *x);
 void
 ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check)
 {
-#ifdef NUMCOSMO_HAVE_CFITSIO
   NcmMSetCatalogPrivate *self = mcat->priv;
-  gint status = 0;
   guint i;
   gboolean need_flush = FALSE;
 
@@ -1817,17 +2990,27 @@ ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check)
   if (self->file == NULL)
     return;
 
-  g_assert (self->fptr != NULL);
+  g_assert (_ncm_mset_catalog_file_is_open (mcat));
 
   /*printf ("# Sync: check %d\n", check);*/
   if (check)
   {
-    gchar fptr_filename[FLEN_FILENAME];
+    if (self->bin != NULL)
+    {
+      g_assert_cmpstr (self->bin->filename, ==, self->file);
+    }
+#ifdef NUMCOSMO_HAVE_CFITSIO
+    else
+    {
+      gchar fptr_filename[FLEN_FILENAME];
+      gint status = 0;
 
-    fits_file_name (self->fptr, fptr_filename, &status);
-    NCM_FITS_ERROR (status);
+      fits_file_name (self->fptr, fptr_filename, &status);
+      NCM_FITS_ERROR (status);
 
-    g_assert_cmpstr (fptr_filename, ==, self->file);
+      g_assert_cmpstr (fptr_filename, ==, self->file);
+    }
+#endif /* NUMCOSMO_HAVE_CFITSIO */
 
     if ((self->file_cur_id < self->first_id - 1) || (self->cur_id < self->file_first_id - 1))
       g_error ("ncm_mset_catalog_sync: file data & catalog mismatch, they do not intersect each other: file data [%d, %d] catalog [%d, %d]",
@@ -1841,27 +3024,36 @@ ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check)
     if (self->file_first_id > self->first_id)
     {
       guint rows_to_add = self->file_first_id - self->first_id;
-      fits_insert_rows (self->fptr, 0, rows_to_add, &status);
-      NCM_FITS_ERROR (status);
+      GError *error     = NULL;
 
-      for (i = 0; i < rows_to_add; i++)
+      if (!_ncm_mset_catalog_insert_rows (mcat, 0, rows_to_add, &error))
       {
-        NcmVector *row = ncm_stats_vec_peek_row (self->pstats, i);
-        _ncm_mset_catalog_write_row (mcat, row, i + 1);
+        g_warning ("ncm_mset_catalog_sync: %s", error->message);
+        g_error_free (error);
+        return;
       }
       self->file_first_id = self->first_id;
 
       if (self->rng != NULL)
+        _ncm_mset_catalog_update_key_longstr (mcat, NCM_MSET_CATALOG_RNG_INIS_LABEL, self->rng_inis);
+
+      if (self->bin != NULL)
       {
-        fits_update_key_longstr (self->fptr, NCM_MSET_CATALOG_RNG_INIS_LABEL, self->rng_inis, NULL, &status);
-        NCM_FITS_ERROR (status);
+        _ncm_mset_catalog_bin_set_key_int (self->bin, NCM_MSET_CATALOG_FIRST_ID_LABEL, self->file_first_id);
+        _ncm_mset_catalog_bin_set_key_int (self->bin, NCM_MSET_CATALOG_M2LNP_ID_LABEL, self->m2lnp_var);
       }
+#ifdef NUMCOSMO_HAVE_CFITSIO
+      else
+      {
+        gint status = 0;
 
-      fits_update_key (self->fptr, TINT, NCM_MSET_CATALOG_FIRST_ID_LABEL, &self->file_first_id, "Id of the first element.", &status);
-      NCM_FITS_ERROR (status);
+        fits_update_key (self->fptr, TINT, NCM_MSET_CATALOG_FIRST_ID_LABEL, &self->file_first_id, "Id of the first element.", &status);
+        NCM_FITS_ERROR (status);
 
-      fits_update_key (self->fptr, TINT, NCM_MSET_CATALOG_M2LNP_ID_LABEL, &self->m2lnp_var,     "Id of the m2lnp variable.", &status);
-      NCM_FITS_ERROR (status);
+        fits_update_key (self->fptr, TINT, NCM_MSET_CATALOG_M2LNP_ID_LABEL, &self->m2lnp_var,     "Id of the m2lnp variable.", &status);
+        NCM_FITS_ERROR (status);
+      }
+#endif /* NUMCOSMO_HAVE_CFITSIO */
 
       need_flush = TRUE;
     }
@@ -1869,7 +3061,6 @@ ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check)
     {
       guint rows_to_add = self->first_id - self->file_first_id;
       GPtrArray *rows = g_ptr_array_new ();
-      gchar *inis = NULL;
 
       g_ptr_array_set_size (rows, rows_to_add);
       for (i = 0; i < rows_to_add; i++)
@@ -1895,14 +3086,8 @@ ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check)
 
       if (self->rng != NULL)
       {
-        fits_read_key_longstr (self->fptr, NCM_MSET_CATALOG_RNG_INIS_LABEL, &inis, NULL, &status);
-        NCM_FITS_ERROR (status);
-
         g_clear_pointer (&self->rng_inis, g_free);
-        self->rng_inis = g_strdup (inis);
-
-        fits_free_memory (inis, &status);
-        NCM_FITS_ERROR (status);
+        self->rng_inis = _ncm_mset_catalog_read_key_longstr (mcat, NCM_MSET_CATALOG_RNG_INIS_LABEL);
       }
     }
     g_assert_cmpint (self->file_first_id, ==, self->first_id);
@@ -1915,15 +3100,14 @@ ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check)
     {
       guint rows_to_add = self->cur_id - self->file_cur_id;
       guint offset = self->file_cur_id + 1 - self->file_first_id;
+      GError *error = NULL;
 
       /*printf ("Adding %u rows after %u\n", rows_to_add, offset);*/
-      fits_insert_rows (self->fptr, offset, rows_to_add, &status);
-      NCM_FITS_ERROR (status);
-
-      for (i = 0; i < rows_to_add; i++)
+      if (!_ncm_mset_catalog_insert_rows (mcat, offset, rows_to_add, &error))
       {
-        NcmVector *row = ncm_stats_vec_peek_row (self->pstats, offset + i);
-        _ncm_mset_catalog_write_row (mcat, row, offset + i + 1);
+        g_warning ("ncm_mset_catalog_sync: %s", error->message);
+        g_error_free (error);
+        return;
       }
       self->file_cur_id = self->cur_id;
 
@@ -1932,8 +3116,7 @@ ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check)
         g_clear_pointer (&self->rng_stat, g_free);
         self->rng_stat = ncm_rng_get_state (self->rng);
 
-        fits_update_key_longstr (self->fptr, NCM_MSET_CATALOG_RNG_STAT_LABEL, self->rng_stat, NULL, &status);
-        NCM_FITS_ERROR (status);
+        _ncm_mset_catalog_update_key_longstr (mcat, NCM_MSET_CATALOG_RNG_STAT_LABEL, self->rng_stat);
       }
       need_flush = TRUE;
     }
@@ -1941,7 +3124,6 @@ ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check)
     {
       guint rows_to_add = self->file_cur_id - self->cur_id;
       guint offset = self->cur_id + 1 - self->first_id;
-      gchar *stat = NULL;
       NcmMSetCatalogSync smode = self->smode;
 
       self->smode = NCM_MSET_CATALOG_SYNC_DISABLE;
@@ -1958,14 +3140,8 @@ ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check)
 
       if (self->rng != NULL)
       {
-        fits_read_key_longstr (self->fptr, NCM_MSET_CATALOG_RNG_STAT_LABEL, &stat, NULL, &status);
-        NCM_FITS_ERROR (status);
-
         g_clear_pointer (&self->rng_stat, g_free);
-        self->rng_stat = g_strdup (stat);
-
-        fits_free_memory (stat, &status);
-        NCM_FITS_ERROR (status);
+        self->rng_stat = _ncm_mset_catalog_read_key_longstr (mcat, NCM_MSET_CATALOG_RNG_STAT_LABEL);
 
         ncm_rng_set_state (self->rng, self->rng_stat);
       }
@@ -1976,7 +3152,6 @@ ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check)
   /*printf ("# Sync: need flush %d\n", need_flush);*/
   if (need_flush)
     _ncm_mset_catalog_flush_file (mcat);
-#endif /* NUMCOSMO_HAVE_CFITSIO */
 }
 
 /**
@@ -2024,7 +3199,9 @@ ncm_mset_catalog_reset_stats (NcmMSetCatalog *mcat)
     ncm_stats_vec_reset (self->mean_pstats, FALSE);
     ncm_stats_vec_reset (self->e_stats, FALSE);
     ncm_stats_vec_reset (self->e_mean_stats, FALSE);
+    _ncm_mset_catalog_bm_reset (self->e_bm);
   }
+  _ncm_mset_catalog_bm_reset (self->bm);
 	
   ncm_vector_set_all (self->params_max, GSL_NEGINF);
   ncm_vector_set_all (self->params_min, GSL_POSINF);
@@ -2065,7 +3242,9 @@ ncm_mset_catalog_reset (NcmMSetCatalog *mcat)
     ncm_stats_vec_reset (self->mean_pstats, TRUE);
     ncm_stats_vec_reset (self->e_stats, TRUE);
     ncm_stats_vec_reset (self->e_mean_stats, TRUE);
+    _ncm_mset_catalog_bm_reset (self->e_bm);
   }
+  _ncm_mset_catalog_bm_reset (self->bm);
 
   ncm_vector_set_all (self->params_max, GSL_NEGINF);
   ncm_vector_set_all (self->params_min, GSL_POSINF);
@@ -2080,25 +3259,41 @@ ncm_mset_catalog_reset (NcmMSetCatalog *mcat)
   self->order_cat_sort = FALSE;
   
   self->cur_id    = self->first_id - 1;
-#ifdef NUMCOSMO_HAVE_CFITSIO
   self->file_cur_id = self->file_first_id - 1;
   _ncm_mset_catalog_close_file (mcat);
-#endif /* NUMCOSMO_HAVE_CFITSIO */
 }
 
 /**
  * ncm_mset_catalog_erase_data:
  * @mcat: a #NcmMSetCatalog
  *
- * Erases all data from the fits file associated with the
+ * Erases all data from the file associated with the
  * catalog.
  *
  */
 void
 ncm_mset_catalog_erase_data (NcmMSetCatalog *mcat)
 {
-#ifdef NUMCOSMO_HAVE_CFITSIO
   NcmMSetCatalogPrivate *self = mcat->priv;
+
+  if (self->bin != NULL)
+  {
+    if (self->file_cur_id - self->file_first_id + 1 > 0)
+    {
+      GError *error = NULL;
+
+      if (!_ncm_mset_catalog_bin_rewrite (self->bin, NULL, 0, self->porder, FALSE, &error))
+      {
+        g_warning ("ncm_mset_catalog_erase_data: %s", error->message);
+        g_error_free (error);
+        return;
+      }
+
+      self->file_cur_id = self->file_first_id - 1;
+      _ncm_mset_catalog_flush_file (mcat);
+    }
+  }
+#ifdef NUMCOSMO_HAVE_CFITSIO
   if (self->fptr != NULL)
   {
     gint status = 0;
@@ -2197,6 +3392,19 @@ ncm_mset_catalog_peek_rng (NcmMSetCatalog *mcat)
   return self->rng;
 }
 
+/**
+ * ncm_mset_catalog_get_rng_substreams:
+ * @mcat: a #NcmMSetCatalog
+ *
+ * Returns: whether the rows were generated using RNG substreams, see ncm_mset_catalog_set_rng_substreams().
+ */
+gboolean
+ncm_mset_catalog_get_rng_substreams (NcmMSetCatalog *mcat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  return self->rng_substreams;
+}
+
 /**
  * ncm_mset_catalog_is_empty:
  * @mcat: a #NcmMSetCatalog
@@ -2528,7 +3736,7 @@ void
 ncm_mset_catalog_set_burnin (NcmMSetCatalog *mcat, glong burnin)
 {
   NcmMSetCatalogPrivate *self = mcat->priv;
-  if (self->fptr != NULL)
+  if (_ncm_mset_catalog_file_is_open (mcat))
     g_error ("ncm_mset_catalog_set_burnin: cannot set burnin with an already loaded catalog");
   self->burnin = burnin;
 }
@@ -2553,13 +3761,25 @@ ncm_mset_catalog_get_burnin (NcmMSetCatalog *mcat)
  * @mcat: a #NcmMSetCatalog
  * @tau_method: a #NcmMSetCatalogTauMethod
  * 
- * Sets the autocorrelation time method to @tau_method.
+ * Sets the autocorrelation time method to @tau_method. The batch means
+ * are only accumulated while #NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS is
+ * selected, switching to it rebuilds them from the rows already in @mcat.
  *
  */
 void 
 ncm_mset_catalog_set_tau_method (NcmMSetCatalog *mcat, NcmMSetCatalogTauMethod tau_method)
 {
   NcmMSetCatalogPrivate *self = mcat->priv;
+
+  if ((tau_method == NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS) && 
+      (self->tau_method != tau_method) && 
+      (self->bm != NULL))
+  {
+    _ncm_mset_catalog_bm_refill (self->bm, self->pstats);
+    if (self->nchains > 1)
+      _ncm_mset_catalog_bm_refill (self->e_bm, self->e_mean_stats);
+  }
+
   self->tau_method = tau_method;
 }
 
@@ -2619,6 +3839,9 @@ _ncm_mset_catalog_post_update (NcmMSetCatalog *mcat, NcmVector *x)
     ncm_stats_vec_append (self->pstats, x, FALSE);
   }
 
+  if (self->tau_method == NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS)
+    _ncm_mset_catalog_bm_append (self->bm, x);
+
   self->cur_id++;
   if (self->nchains > 1)
   {
@@ -2636,6 +3859,8 @@ _ncm_mset_catalog_post_update (NcmMSetCatalog *mcat, NcmVector *x)
 
       ncm_stats_vec_append (self->e_mean_stats, e_mean, TRUE);
       g_ptr_array_add (self->e_var_array, e_var);
+      if (self->tau_method == NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS)
+        _ncm_mset_catalog_bm_append (self->e_bm, e_mean);
 
       ncm_stats_vec_reset (self->e_stats, FALSE);
     }
@@ -3660,6 +4885,10 @@ ncm_mset_catalog_log_full_covar (NcmMSetCatalog *mcat)
  * @force_single_chain: whether to force the catalog to be treated as a single chain
  *
  * Updates the internal estimates of the integrate autocorrelation time.
+ * The method is chosen by ncm_mset_catalog_set_tau_method(). When using
+ * #NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS the estimates come from the
+ * batch means accumulated as the rows are added, so the cost of this call
+ * does not depend on the catalog size.
  *
  */
 void
@@ -3689,6 +4918,14 @@ ncm_mset_catalog_estimate_autocorrelation_tau (NcmMSetCatalog *mcat, gboolean fo
           ncm_vector_set (self->tau, p, self->pstats->nitens / ess);
         }
         break;
+      case NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS:
+        for (p = 0; p < total; p++)
+        {
+          const gdouble spec0 = _ncm_mset_catalog_bm_spec0 (self->bm, p);
+          const gdouble var   = ncm_stats_vec_get_var (self->pstats, p);
+          ncm_vector_set (self->tau, p, (spec0 > 0.0 && var > 0.0) ? spec0 / var : 1.0);
+        }
+        break;
       default:
         g_assert_not_reached ();
         break;
@@ -3714,6 +4951,14 @@ ncm_mset_catalog_estimate_autocorrelation_tau (NcmMSetCatalog *mcat, gboolean fo
           ncm_vector_set (self->tau, p, self->pstats->nitens / (ess * self->nchains));
         }
         break;
+      case NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS:
+        for (p = 0; p < total; p++)
+        {
+          const gdouble spec0 = _ncm_mset_catalog_bm_spec0 (self->e_bm, p);
+          const gdouble var   = (self->e_mean_stats->nitens > 1) ? ncm_stats_vec_get_var (self->e_mean_stats, p) : 0.0;
+          ncm_vector_set (self->tau, p, (spec0 > 0.0 && var > 0.0) ? spec0 / var : 1.0);
+        }
+        break;
       default:
         g_assert_not_reached ();
         break;
@@ -110,6 +110,7 @@ typedef enum _NcmMSetCatalogPostNormMethod
  * NcmMSetCatalogTauMethod:
  * @NCM_MSET_CATALOG_TAU_METHOD_ACOR: uses the autocorrelation to estimate $\tau$.
  * @NCM_MSET_CATALOG_TAU_METHOD_AR_MODEL: uses an autoregressive model fitting to estimate $\tau$.
+ * @NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS: uses online batch means to estimate $\tau$, updated in constant time per sample.
  * 
  * Method used to estimate the autocorrelation time $\tau$.
  * 
@@ -118,6 +119,7 @@ typedef enum _NcmMSetCatalogTauMethod
 {
   NCM_MSET_CATALOG_TAU_METHOD_ACOR = 0,
   NCM_MSET_CATALOG_TAU_METHOD_AR_MODEL, 
+  NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS,
   /* < private > */
   NCM_MSET_CATALOG_TAU_METHOD_LEN, /*< skip >*/
 } NcmMSetCatalogTauMethod;
@@ -146,6 +148,7 @@ void ncm_mset_catalog_set_sync_interval (NcmMSetCatalog *mcat, gdouble interval)
 void ncm_mset_catalog_set_first_id (NcmMSetCatalog *mcat, gint first_id);
 void ncm_mset_catalog_set_run_type (NcmMSetCatalog *mcat, const gchar *rtype_str);
 void ncm_mset_catalog_set_rng (NcmMSetCatalog *mcat, NcmRNG *rng);
+void ncm_mset_catalog_set_rng_substreams (NcmMSetCatalog *mcat, gboolean enable);
 void ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check);
 void ncm_mset_catalog_timed_sync (NcmMSetCatalog *mcat, gboolean check);
 void ncm_mset_catalog_reset_stats (NcmMSetCatalog *mcat);
@@ -158,6 +161,7 @@ gint ncm_mset_catalog_get_m2lnp_var (NcmMSetCatalog *mcat);
 const gchar *ncm_mset_catalog_peek_filename (NcmMSetCatalog *mcat);
 NcmRNG *ncm_mset_catalog_get_rng (NcmMSetCatalog *mcat);
 NcmRNG *ncm_mset_catalog_peek_rng (NcmMSetCatalog *mcat);
+gboolean ncm_mset_catalog_get_rng_substreams (NcmMSetCatalog *mcat);
 
 gboolean ncm_mset_catalog_is_empty (NcmMSetCatalog *mcat);
 gdouble ncm_mset_catalog_largest_error (NcmMSetCatalog *mcat);
@@ -253,6 +257,7 @@ guint ncm_mset_catalog_heidel_diag_by_chain (NcmMSetCatalog *mcat, const guint n
 #define NCM_MSET_CATALOG_RNG_SEED_LABEL "RNG_SEED"
 #define NCM_MSET_CATALOG_RNG_STAT_LABEL "RNG_STAT"
 #define NCM_MSET_CATALOG_RNG_INIS_LABEL "RNG_INIS"
+#define NCM_MSET_CATALOG_RNG_SUBS_LABEL "RNG_SUBS"
 #define NCM_MSET_CATALOG_NROWS_LABEL "NAXIS2"
 #define NCM_MSET_CATALOG_RTYPE_LABEL "RTYPE"
 #define NCM_MSET_CATALOG_NCHAINS_LABEL "NCHAINS"
@@ -262,6 +267,7 @@ guint ncm_mset_catalog_heidel_diag_by_chain (NcmMSetCatalog *mcat, const guint n
 #define NCM_MSET_CATALOG_RTYPE_UNDEFINED "undefined-run"
 #define NCM_MSET_CATALOG_FSYMB_LABEL "FSYMB"
 #define NCM_MSET_CATALOG_ASYMB_LABEL "ASYMB"
+#define NCM_MSET_CATALOG_BIN_EXT ".mcat"
 #define NCM_MSET_CATALOG_DIST_EST_SD_SCALE (1.0e-3)
 
 G_END_DECLS
@@ -180,16 +180,24 @@ ncm_obj_array_ser (NcmObjArray *oa, NcmSerialize *ser)
  * @oa: a #NcmObjArray.
  * @ser: a #NcmSerialize.
  * 
- * FIXME
+ * Duplicates each object in @oa using ncm_serialize_dup_obj().
  *
- * Returns: (transfer full): FIXME
+ * Returns: (transfer full): a new #NcmObjArray containing the duplicates.
  */
 NcmObjArray *
 ncm_obj_array_dup (NcmObjArray *oa, NcmSerialize *ser)
 {
-  GVariant *var    = ncm_obj_array_ser (oa, ser);
-  NcmObjArray *dup = ncm_obj_array_new_from_variant (ser, var);
-  g_variant_unref (var);
+  NcmObjArray *dup = ncm_obj_array_sized_new (oa->len);
+  guint i;
+
+  for (i = 0; i < oa->len; i++)
+  {
+    GObject *obj_dup = ncm_serialize_dup_obj (ser, ncm_obj_array_peek (oa, i));
+
+    ncm_obj_array_add (dup, obj_dup);
+    g_object_unref (obj_dup);
+  }
+
   return dup;
 }
 
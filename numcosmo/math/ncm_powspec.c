@@ -200,6 +200,9 @@ ncm_powspec_class_init (NcmPowspecClass *klass)
   klass->prepare  = &_ncm_powspec_prepare;
   klass->eval     = &_ncm_powspec_eval;
   klass->eval_vec = &_ncm_powspec_eval_vec;
+
+  /* Only implemented by power spectra of the form $P(k, z) = D^2(z) P(k, 0)$. */
+  klass->eval_growth2 = NULL;
 }
 
 static void 
@@ -457,6 +460,46 @@ ncm_powspec_get_nknots (NcmPowspec *powspec, guint *Nz, guint *Nk)
   NCM_POWSPEC_GET_CLASS (powspec)->get_nknots (powspec, Nz, Nk);
 }
 
+/**
+ * ncm_powspec_is_growth_separable:
+ * @powspec: a #NcmPowspec
+ * 
+ * Checks whether the redshift dependence of @powspec is a pure growth
+ * rescaling, i.e., $P(k, z) = D^2(z) P(k, 0)$. This is the case when the 
+ * implementation provides the eval_growth2 virtual method, 
+ * see ncm_powspec_eval_growth2().
+ * 
+ * Returns: whether @powspec is growth separable.
+ */
+gboolean
+ncm_powspec_is_growth_separable (NcmPowspec *powspec)
+{
+  return (NCM_POWSPEC_GET_CLASS (powspec)->eval_growth2 != NULL);
+}
+
+/**
+ * ncm_powspec_eval_growth2:
+ * @powspec: a #NcmPowspec
+ * @model: a #NcmModel
+ * @z: time $z$
+ * 
+ * Evaluates the squared growth factor $D^2(z) = P(k, z) / P(k, 0)$ of a 
+ * growth separable power spectrum, see ncm_powspec_is_growth_separable().
+ * The object @powspec must be already prepared.
+ * 
+ * Returns: $D^2(z)$.
+ */
+gdouble
+ncm_powspec_eval_growth2 (NcmPowspec *powspec, NcmModel *model, const gdouble z)
+{
+  NcmPowspecClass *powspec_class = NCM_POWSPEC_GET_CLASS (powspec);
+
+  if (powspec_class->eval_growth2 == NULL)
+    g_error ("ncm_powspec_eval_growth2: `%s' is not growth separable.", G_OBJECT_TYPE_NAME (powspec));
+
+  return powspec_class->eval_growth2 (powspec, model, z);
+}
+
 /**
  * ncm_powspec_prepare:
  * @powspec: a #NcmPowspec
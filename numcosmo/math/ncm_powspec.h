@@ -51,6 +51,7 @@ struct _NcmPowspecClass
   gdouble (*eval) (NcmPowspec *powspec, NcmModel *model, const gdouble z, const gdouble k);
   void (*eval_vec) (NcmPowspec *powspec, NcmModel *model, const gdouble z, NcmVector *k, NcmVector *Pk);
   void (*get_nknots) (NcmPowspec *powspec, guint *Nz, guint *Nk);
+  gdouble (*eval_growth2) (NcmPowspec *powspec, NcmModel *model, const gdouble z);
 };
 
 struct _NcmPowspec
@@ -88,6 +89,9 @@ gdouble ncm_powspec_get_kmax (NcmPowspec *powspec);
 
 void ncm_powspec_get_nknots (NcmPowspec *powspec, guint *Nz, guint *Nk);
 
+gboolean ncm_powspec_is_growth_separable (NcmPowspec *powspec);
+gdouble ncm_powspec_eval_growth2 (NcmPowspec *powspec, NcmModel *model, const gdouble z);
+
 G_INLINE_FUNC void ncm_powspec_prepare (NcmPowspec *powspec, NcmModel *model);
 G_INLINE_FUNC void ncm_powspec_prepare_if_needed (NcmPowspec *powspec, NcmModel *model);
 G_INLINE_FUNC gdouble ncm_powspec_eval (NcmPowspec *powspec, NcmModel *model, const gdouble z, const gdouble k);
@@ -74,6 +74,7 @@ ncm_powspec_corr3d_init (NcmPowspecCorr3d *psc)
   psc->zf          = 0.0;
   psc->reltol      = 0.0;
   psc->fftlog      = NULL;
+  psc->nthreads    = 0;
   psc->calibrated  = FALSE;
   psc->xi          = ncm_spline2d_bicubic_notaknot_new ();
   psc->ctrl        = ncm_model_ctrl_new (NULL);
@@ -165,6 +166,7 @@ _ncm_powspec_corr3d_constructed (GObject *object)
     
     ncm_fftlog_set_padding (psc->fftlog, 1.0);
     ncm_fftlog_set_nderivs (psc->fftlog, 0);
+    ncm_fftlog_set_nthreads (psc->fftlog, psc->nthreads);
 
     ncm_powspec_corr3d_set_best_lnr0 (psc);
     
@@ -344,6 +346,40 @@ _ncm_powspec_corr3d_dummy_z (gdouble z, gpointer userdata)
   return ncm_vector_get (ncm_fftlog_peek_output_vector (arg->psc->fftlog, 0), 0);
 }
 
+static void
+_ncm_powspec_corr3d_eval_batch (NcmPowspecCorr3d *psc, NcmModel *model, NcmVector *z_vec, NcmMatrix *xi)
+{
+  const guint N_z = ncm_vector_len (z_vec);
+  const guint N_k = ncm_fftlog_get_size (psc->fftlog);
+  NcmVector *lnk  = ncm_vector_new (N_k);
+  NcmMatrix *Fk   = ncm_matrix_new (N_z, N_k);
+  GPtrArray *Gr   = g_ptr_array_new ();
+  guint i, j;
+
+  ncm_fftlog_get_lnk_vector (psc->fftlog, lnk);
+
+  for (i = 0; i < N_z; i++)
+  {
+    const gdouble z = ncm_vector_get (z_vec, i);
+
+    for (j = 0; j < N_k; j++)
+    {
+      const gdouble k  = exp (ncm_vector_get (lnk, j));
+      const gdouble Pk = ncm_powspec_eval (psc->ps, model, z, k);
+
+      ncm_matrix_set (Fk, i, j, Pk * k * k / ncm_c_2_pi_2 ());
+    }
+  }
+
+  g_ptr_array_add (Gr, xi);
+
+  ncm_fftlog_eval_by_matrix (psc->fftlog, Fk, Gr);
+
+  g_ptr_array_unref (Gr);
+  ncm_matrix_free (Fk);
+  ncm_vector_free (lnk);
+}
+
 /**
  * ncm_powspec_corr3d_prepare:
  * @psc: a #NcmPowspecCorr3d
@@ -387,7 +423,6 @@ ncm_powspec_corr3d_prepare (NcmPowspecCorr3d *psc, NcmModel *model)
     NcmMatrix *xi;
     NcmVector *z_vec, *lnr_vec;
     guint N_k = 0, N_z = 0;
-    guint i;
 
     ncm_powspec_get_nknots (psc->ps, &N_z, &N_k);
     
@@ -419,19 +454,9 @@ ncm_powspec_corr3d_prepare (NcmPowspecCorr3d *psc, NcmModel *model)
             N_z, N_k);
 */    
     xi      = ncm_matrix_new (N_z, N_k);
-    lnr_vec = ncm_fftlog_get_vector_lnr (psc->fftlog);
-        
-    for (i = 0; i < N_z; i++)
-    {
-      NcmVector *xi_z  = ncm_matrix_get_row (xi, i);
 
-      arg.z = ncm_vector_get (z_vec, i);
-      ncm_fftlog_eval_by_gsl_function (psc->fftlog, &F);
-
-      ncm_vector_memcpy (xi_z, ncm_fftlog_peek_output_vector (psc->fftlog, 0));
-
-      ncm_vector_free (xi_z);
-    }
+    _ncm_powspec_corr3d_eval_batch (psc, model, z_vec, xi);
+    lnr_vec = ncm_fftlog_get_vector_lnr (psc->fftlog);
 
     ncm_spline2d_set (psc->xi, lnr_vec, z_vec, xi, TRUE);
 
@@ -443,20 +468,8 @@ ncm_powspec_corr3d_prepare (NcmPowspecCorr3d *psc, NcmModel *model)
   }
   else
   {
-    NcmMatrix *xi = psc->xi->zm;
-    
-    guint N_z = ncm_matrix_nrows (xi);
-    guint i;
-
-    for (i = 0; i < N_z; i++)
-    {
-      NcmVector *xi_z  = ncm_matrix_get_row (xi, i);
-
-      arg.z = ncm_vector_get (psc->xi->yv, i);
-      ncm_fftlog_eval_by_gsl_function (psc->fftlog, &F);
-
-      ncm_vector_memcpy (xi_z, ncm_fftlog_peek_output_vector (psc->fftlog, 0));
-    }
+    /* Transforms all redshifts at once writing directly in the spline knots. */
+    _ncm_powspec_corr3d_eval_batch (psc, model, psc->xi->yv, psc->xi->zm);
 
     ncm_spline2d_prepare (psc->xi);
   }
@@ -573,6 +586,36 @@ ncm_powspec_corr3d_set_zf (NcmPowspecCorr3d *psc, gdouble zf)
   }
 }
 
+/**
+ * ncm_powspec_corr3d_set_nthreads:
+ * @psc: a #NcmPowspecCorr3d
+ * @nthreads: number of threads
+ * 
+ * Sets the number of threads used to compute the FFTLog transforms
+ * of all redshift knots, see ncm_fftlog_set_nthreads().
+ * 
+ */
+void 
+ncm_powspec_corr3d_set_nthreads (NcmPowspecCorr3d *psc, guint nthreads)
+{
+  psc->nthreads = nthreads;
+
+  if (psc->fftlog != NULL)
+    ncm_fftlog_set_nthreads (psc->fftlog, nthreads);
+}
+
+/**
+ * ncm_powspec_corr3d_get_nthreads:
+ * @psc: a #NcmPowspecCorr3d
+ * 
+ * Returns: the number of threads used to compute the FFTLog transforms.
+ */
+guint 
+ncm_powspec_corr3d_get_nthreads (NcmPowspecCorr3d *psc)
+{
+  return psc->nthreads;
+}
+
 /**
  * ncm_powspec_corr3d_get_r_min:
  * @psc: a #NcmPowspecCorr3d
@@ -67,6 +67,7 @@ struct _NcmPowspecCorr3d
   gdouble reltol_z;
   NcmSpline2d *xi;
   NcmModelCtrl *ctrl;
+  guint nthreads;
   gboolean constructed;
 };
 
@@ -86,6 +87,9 @@ void ncm_powspec_corr3d_set_best_lnr0 (NcmPowspecCorr3d *psc);
 void ncm_powspec_corr3d_set_zi (NcmPowspecCorr3d *psc, gdouble zi);
 void ncm_powspec_corr3d_set_zf (NcmPowspecCorr3d *psc, gdouble zf);
 
+void ncm_powspec_corr3d_set_nthreads (NcmPowspecCorr3d *psc, guint nthreads);
+guint ncm_powspec_corr3d_get_nthreads (NcmPowspecCorr3d *psc);
+
 gdouble ncm_powspec_corr3d_get_r_min (NcmPowspecCorr3d *psc);
 gdouble ncm_powspec_corr3d_get_r_max (NcmPowspecCorr3d *psc);
 
@@ -49,6 +49,9 @@
  * \sigma^2(r, z) = \frac{1}{2\pi^2} \int_0^\infty k^2 \ P(k, z) \vert W(k,r) \vert^2 \ \mathrm{d}k, 
  * \end{equation}
  * where $P(k, z)$ is the power spectrum at mode $k$ and redshift $z$ and $W(k, r)$ is the filter (or window function).
+ * 
+ * When the power spectrum is growth separable, $P(k, z) = D^2(z) P(k, 0)$ (see ncm_powspec_is_growth_separable()), 
+ * the transform is computed only once and $\sigma^2(r, z)$ is obtained rescaling it by $D^2(z)$.
  *  
  */
 
@@ -75,6 +78,7 @@ enum
   PROP_RELTOL,
   PROP_RELTOL_Z,
   PROP_POWERSPECTRUM,
+  PROP_MODEL_PARAM_DEPS,
 	PROP_SIZE,
 };
 
@@ -92,6 +96,7 @@ ncm_powspec_filter_init (NcmPowspecFilter *psf)
   psf->reltol      = 0.0;
   psf->type        = NCM_POWSPEC_FILTER_TYPE_LEN;
   psf->fftlog      = NULL;
+  psf->nthreads    = 0;
   psf->calibrated  = FALSE;
   psf->var         = ncm_spline2d_bicubic_notaknot_new ();
   psf->dvar        = ncm_spline2d_bicubic_notaknot_new ();
@@ -130,6 +135,10 @@ _ncm_powspec_filter_set_property (GObject *object, guint prop_id, const GValue *
       psf->zi = ncm_powspec_get_zi (psf->ps);
       psf->zf = ncm_powspec_get_zf (psf->ps);
       break;
+    case PROP_MODEL_PARAM_DEPS:
+      if (g_value_get_variant (value) != NULL)
+        ncm_model_ctrl_set_param_deps (psf->ctrl, g_value_get_variant (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -165,6 +174,9 @@ _ncm_powspec_filter_get_property (GObject *object, guint prop_id, GValue *value,
     case PROP_POWERSPECTRUM:
       g_value_set_object (value, psf->ps);
       break;
+    case PROP_MODEL_PARAM_DEPS:
+      g_value_take_variant (value, ncm_model_ctrl_get_param_deps (psf->ctrl));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -272,6 +284,13 @@ ncm_powspec_filter_class_init (NcmPowspecFilterClass *klass)
                                                         "NcmPowspec object",
                                                         NCM_TYPE_POWSPEC,
                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_MODEL_PARAM_DEPS,
+                                   g_param_spec_variant ("model-param-deps",
+                                                         NULL,
+                                                         "Model parameters dependencies",
+                                                         G_VARIANT_TYPE ("au"), NULL,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 /**
@@ -376,6 +395,7 @@ ncm_powspec_filter_set_type (NcmPowspecFilter *psf, NcmPowspecFilterType type)
 
     ncm_fftlog_set_padding (psf->fftlog, 1.0);
     ncm_fftlog_set_nderivs (psf->fftlog, 1);
+    ncm_fftlog_set_nthreads (psf->fftlog, psf->nthreads);
 
     ncm_powspec_filter_set_best_lnr0 (psf);
     
@@ -417,6 +437,96 @@ _ncm_powspec_filter_dummy_z (gdouble z, gpointer userdata)
   return ncm_vector_get (ncm_fftlog_peek_output_vector (arg->psf->fftlog, 0), 0);
 }
 
+static gdouble 
+_ncm_powspec_filter_growth2_z (gdouble z, gpointer userdata)
+{
+  NcmPowspecFilterArg *arg = (NcmPowspecFilterArg *) userdata;
+
+  return ncm_powspec_eval_growth2 (arg->psf->ps, arg->model, z);
+}
+
+static void
+_ncm_powspec_filter_eval_growth (NcmPowspecFilter *psf, NcmModel *model, NcmVector *z_vec, NcmMatrix *lnvar, NcmMatrix *dlnvar)
+{
+  const guint N_z          = ncm_vector_len (z_vec);
+  NcmPowspecFilterArg arg  = {psf, model, ncm_vector_get (z_vec, 0)};
+  const gdouble growth2_0  = ncm_powspec_eval_growth2 (psf->ps, model, arg.z);
+  NcmVector *var_0, *dvar_0;
+  gsl_function F;
+  guint i;
+
+  F.function = &_ncm_powspec_filter_k2Pk;
+  F.params   = &arg;
+
+  ncm_fftlog_eval_by_gsl_function (psf->fftlog, &F);
+
+  var_0  = ncm_fftlog_peek_output_vector (psf->fftlog, 0);
+  dvar_0 = ncm_fftlog_peek_output_vector (psf->fftlog, 1);
+
+  for (i = 0; i < N_z; i++)
+  {
+    const gdouble z        = ncm_vector_get (z_vec, i);
+    const gdouble growth2  = ncm_powspec_eval_growth2 (psf->ps, model, z) / growth2_0;
+    NcmVector *var_z       = ncm_matrix_get_row (lnvar, i);
+    NcmVector *dvar_z      = ncm_matrix_get_row (dlnvar, i);
+
+    ncm_vector_memcpy (var_z, var_0);
+    ncm_vector_memcpy (dvar_z, dvar_0);
+
+    ncm_vector_scale (var_z, growth2);
+    ncm_vector_scale (dvar_z, growth2);
+
+    ncm_vector_free (var_z);
+    ncm_vector_free (dvar_z);
+  }
+}
+
+static void
+_ncm_powspec_filter_eval_batch (NcmPowspecFilter *psf, NcmModel *model, NcmVector *z_vec, NcmMatrix *lnvar, NcmMatrix *dlnvar)
+{
+  /*
+   * For $P(k, z) = D^2(z) P(k, 0)$ a single transform is enough, the
+   * variance and its derivatives are simply rescaled by $D^2(z)$.
+   */
+  if (ncm_powspec_is_growth_separable (psf->ps))
+  {
+    _ncm_powspec_filter_eval_growth (psf, model, z_vec, lnvar, dlnvar);
+  }
+  else
+  {
+    const guint N_z = ncm_vector_len (z_vec);
+    const guint N_k = ncm_fftlog_get_size (psf->fftlog);
+    NcmVector *lnk  = ncm_vector_new (N_k);
+    NcmMatrix *Fk   = ncm_matrix_new (N_z, N_k);
+    GPtrArray *Gr   = g_ptr_array_new ();
+    guint i, j;
+
+    ncm_fftlog_get_lnk_vector (psf->fftlog, lnk);
+
+    for (i = 0; i < N_z; i++)
+    {
+      const gdouble z = ncm_vector_get (z_vec, i);
+
+      for (j = 0; j < N_k; j++)
+      {
+        const gdouble k  = exp (ncm_vector_get (lnk, j));
+        const gdouble Pk = ncm_powspec_eval (psf->ps, model, z, k);
+
+        ncm_matrix_set (Fk, i, j, Pk * k * k / ncm_c_2_pi_2 ());
+      }
+    }
+
+    g_ptr_array_add (Gr, lnvar);
+    g_ptr_array_add (Gr, dlnvar);
+
+    ncm_fftlog_eval_by_matrix (psf->fftlog, Fk, Gr);
+
+    g_ptr_array_unref (Gr);
+    ncm_matrix_free (Fk);
+    ncm_vector_free (lnk);
+  }
+}
+
 /**
  * ncm_powspec_filter_prepare:
  * @psf: a #NcmPowspecFilter
@@ -460,7 +570,6 @@ ncm_powspec_filter_prepare (NcmPowspecFilter *psf, NcmModel *model)
     NcmMatrix *lnvar, *dlnvar;
     NcmVector *z_vec, *lnr_vec;
     guint N_k = 0, N_z = 0;
-    guint i;
 
     ncm_powspec_get_nknots (psf->ps, &N_z, &N_k);
     
@@ -471,7 +580,10 @@ ncm_powspec_filter_prepare (NcmPowspecFilter *psf, NcmModel *model)
       NcmSpline *dummy_z = ncm_spline_cubic_notaknot_new ();
       gsl_function Fdummy_z;
 
-      Fdummy_z.function = &_ncm_powspec_filter_dummy_z;
+      if (ncm_powspec_is_growth_separable (psf->ps))
+        Fdummy_z.function = &_ncm_powspec_filter_growth2_z;
+      else
+        Fdummy_z.function = &_ncm_powspec_filter_dummy_z;
       Fdummy_z.params   = &arg;
 
       ncm_spline_set_func (dummy_z, NCM_SPLINE_FUNCTION_SPLINE, &Fdummy_z, psf->zi, psf->zf, 0, psf->reltol_z);
@@ -493,24 +605,9 @@ ncm_powspec_filter_prepare (NcmPowspecFilter *psf, NcmModel *model)
 */    
     lnvar   = ncm_matrix_new (N_z, N_k);
     dlnvar  = ncm_matrix_new (N_z, N_k);
-    lnr_vec = ncm_fftlog_get_vector_lnr (psf->fftlog);
-        
-    for (i = 0; i < N_z; i++)
-    {
-      NcmVector *var_z  = ncm_matrix_get_row (lnvar, i);
-      NcmVector *dvar_z = ncm_matrix_get_row (dlnvar, i);
-
-      arg.z = ncm_vector_get (z_vec, i);
-      ncm_fftlog_eval_by_gsl_function (psf->fftlog, &F);
-
-      ncm_vector_memcpy (var_z, ncm_fftlog_peek_output_vector (psf->fftlog, 0));
-      ncm_vector_memcpy (dvar_z, ncm_fftlog_peek_output_vector (psf->fftlog, 1));
 
-      /*ncm_vector_log_vals (var_z, "NADA: ", "% 11.5e", TRUE);*/
-
-      ncm_vector_free (var_z);
-      ncm_vector_free (dvar_z);
-    }
+    _ncm_powspec_filter_eval_batch (psf, model, z_vec, lnvar, dlnvar);
+    lnr_vec = ncm_fftlog_get_vector_lnr (psf->fftlog);
 
     ncm_spline2d_set (psf->var, lnr_vec, z_vec, lnvar, TRUE);
     ncm_spline2d_set (psf->dvar, lnr_vec, z_vec, dlnvar, TRUE);
@@ -524,23 +621,8 @@ ncm_powspec_filter_prepare (NcmPowspecFilter *psf, NcmModel *model)
   }
   else
   {
-    NcmMatrix *lnvar  = psf->var->zm;
-    NcmMatrix *dlnvar = psf->dvar->zm;
-    
-    guint N_z = ncm_matrix_nrows (lnvar);
-    guint i;
-
-    for (i = 0; i < N_z; i++)
-    {
-      NcmVector *var_z  = ncm_matrix_get_row (lnvar, i);
-      NcmVector *dvar_z = ncm_matrix_get_row (dlnvar, i);
-
-      arg.z = ncm_vector_get (psf->var->yv, i);
-      ncm_fftlog_eval_by_gsl_function (psf->fftlog, &F);
-
-      ncm_vector_memcpy (var_z, ncm_fftlog_peek_output_vector (psf->fftlog, 0));
-      ncm_vector_memcpy (dvar_z, ncm_fftlog_peek_output_vector (psf->fftlog, 1));
-    }
+    /* Transforms all redshifts at once writing directly in the spline knots. */
+    _ncm_powspec_filter_eval_batch (psf, model, psf->var->yv, psf->var->zm, psf->dvar->zm);
 
     ncm_spline2d_prepare (psf->var);
     ncm_spline2d_prepare (psf->dvar);
@@ -564,6 +646,35 @@ ncm_powspec_filter_prepare_if_needed (NcmPowspecFilter *psf, NcmModel *model)
     ncm_powspec_filter_prepare (psf, model);
 }
 
+/**
+ * ncm_powspec_filter_add_model_param_dep:
+ * @psf: a #NcmPowspecFilter
+ * @i: original parameter index
+ *
+ * Adds the @i-th original parameter of the #NcmModel passed to
+ * ncm_powspec_filter_prepare_if_needed() to the dependencies of @psf,
+ * see ncm_model_ctrl_add_param_dep().
+ *
+ */
+void
+ncm_powspec_filter_add_model_param_dep (NcmPowspecFilter *psf, const guint i)
+{
+  ncm_model_ctrl_add_param_dep (psf->ctrl, i);
+}
+
+/**
+ * ncm_powspec_filter_clear_model_param_deps:
+ * @psf: a #NcmPowspecFilter
+ *
+ * Removes all dependencies of @psf, see ncm_model_ctrl_clear_param_deps().
+ *
+ */
+void
+ncm_powspec_filter_clear_model_param_deps (NcmPowspecFilter *psf)
+{
+  ncm_model_ctrl_clear_param_deps (psf->ctrl);
+}
+
 /**
  * ncm_powspec_filter_set_lnr0:
  * @psf: a #NcmPowspecFilter
@@ -658,6 +769,36 @@ ncm_powspec_filter_set_zf (NcmPowspecFilter *psf, gdouble zf)
   }
 }
 
+/**
+ * ncm_powspec_filter_set_nthreads:
+ * @psf: a #NcmPowspecFilter
+ * @nthreads: number of threads
+ * 
+ * Sets the number of threads used to compute the FFTLog transforms
+ * of all redshift knots, see ncm_fftlog_set_nthreads().
+ * 
+ */
+void 
+ncm_powspec_filter_set_nthreads (NcmPowspecFilter *psf, guint nthreads)
+{
+  psf->nthreads = nthreads;
+
+  if (psf->fftlog != NULL)
+    ncm_fftlog_set_nthreads (psf->fftlog, nthreads);
+}
+
+/**
+ * ncm_powspec_filter_get_nthreads:
+ * @psf: a #NcmPowspecFilter
+ * 
+ * Returns: the number of threads used to compute the FFTLog transforms.
+ */
+guint 
+ncm_powspec_filter_get_nthreads (NcmPowspecFilter *psf)
+{
+  return psf->nthreads;
+}
+
 /**
  * ncm_powspec_filter_get_r_min:
  * @psf: a #NcmPowspecFilter
@@ -86,6 +86,7 @@ struct _NcmPowspecFilter
   NcmSpline2d *var;
   NcmSpline2d *dvar;
   NcmModelCtrl *ctrl;
+  guint nthreads;
   gboolean constructed;
 };
 
@@ -98,6 +99,8 @@ void ncm_powspec_filter_clear (NcmPowspecFilter **psf);
 
 void ncm_powspec_filter_prepare (NcmPowspecFilter *psf, NcmModel *model);
 void ncm_powspec_filter_prepare_if_needed (NcmPowspecFilter *psf, NcmModel *model);
+void ncm_powspec_filter_add_model_param_dep (NcmPowspecFilter *psf, const guint i);
+void ncm_powspec_filter_clear_model_param_deps (NcmPowspecFilter *psf);
 
 void ncm_powspec_filter_set_type (NcmPowspecFilter *psf, NcmPowspecFilterType type);
 void ncm_powspec_filter_set_lnr0 (NcmPowspecFilter *psf, gdouble lnr0);
@@ -106,6 +109,9 @@ void ncm_powspec_filter_set_best_lnr0 (NcmPowspecFilter *psf);
 void ncm_powspec_filter_set_zi (NcmPowspecFilter *psf, gdouble zi);
 void ncm_powspec_filter_set_zf (NcmPowspecFilter *psf, gdouble zf);
 
+void ncm_powspec_filter_set_nthreads (NcmPowspecFilter *psf, guint nthreads);
+guint ncm_powspec_filter_get_nthreads (NcmPowspecFilter *psf);
+
 gdouble ncm_powspec_filter_get_r_min (NcmPowspecFilter *psf);
 gdouble ncm_powspec_filter_get_r_max (NcmPowspecFilter *psf);
 
@@ -50,6 +50,7 @@ enum
 };
 
 G_DEFINE_TYPE (NcmRNG, ncm_rng, G_TYPE_OBJECT);
+G_LOCK_DEFINE_STATIC (seed_hash_lock);
 
 static void
 ncm_rng_init (NcmRNG *rng)
@@ -60,6 +61,8 @@ ncm_rng_init (NcmRNG *rng)
   g_mutex_init (&rng->lock);
 }
 
+static void _ncm_rng_set_seed (NcmRNG *rng, gulong seed, gboolean track);
+
 static void
 _ncm_rng_constructed (GObject *object)
 {
@@ -67,8 +70,9 @@ _ncm_rng_constructed (GObject *object)
   G_OBJECT_CLASS (ncm_rng_parent_class)->constructed (object);
   {
     NcmRNG *rng = NCM_RNG (object);
+    /* The default seed is shared by every unseeded RNG, there is no point in tracking it. */
     if (!rng->seed_set)
-      ncm_rng_set_seed (rng, gsl_rng_default_seed);
+      _ncm_rng_set_seed (rng, gsl_rng_default_seed, FALSE);
   }
 }
 
@@ -390,7 +394,12 @@ ncm_rng_check_seed (NcmRNG *rng, gulong seed)
 {
   NcmRNGClass *rng_class = NCM_RNG_GET_CLASS (rng);
   gint seed_int = seed;
-  gpointer b = g_hash_table_lookup (rng_class->seed_hash, GINT_TO_POINTER (seed_int));
+  gpointer b;
+
+  G_LOCK (seed_hash_lock);
+  b = g_hash_table_lookup (rng_class->seed_hash, GINT_TO_POINTER (seed_int));
+  G_UNLOCK (seed_hash_lock);
+
   return GPOINTER_TO_INT (b) == 0;
 }
 
@@ -404,14 +413,27 @@ ncm_rng_check_seed (NcmRNG *rng, gulong seed)
  */
 void 
 ncm_rng_set_seed (NcmRNG *rng, gulong seed)
+{
+  _ncm_rng_set_seed (rng, seed, TRUE);
+}
+
+static void
+_ncm_rng_set_seed (NcmRNG *rng, gulong seed, gboolean track)
 {
   rng->seed_val = seed;
   if (rng->r != NULL)
   {
-    NcmRNGClass *rng_class = NCM_RNG_GET_CLASS (rng);    
-    gint seed_int = seed;
     gsl_rng_set (rng->r, seed);
-    g_hash_table_insert (rng_class->seed_hash, GINT_TO_POINTER (seed_int), GINT_TO_POINTER (1));
+
+    if (track)
+    {
+      NcmRNGClass *rng_class = NCM_RNG_GET_CLASS (rng);    
+      gint seed_int = seed;
+
+      G_LOCK (seed_hash_lock);
+      g_hash_table_insert (rng_class->seed_hash, GINT_TO_POINTER (seed_int), GINT_TO_POINTER (1));
+      G_UNLOCK (seed_hash_lock);
+    }
     rng->seed_set = TRUE;
   }
 }
@@ -450,6 +472,87 @@ ncm_rng_set_random_seed (NcmRNG *rng, gboolean allow_colisions)
   ncm_rng_set_seed (rng, seed);
 }
 
+/*
+ * Murmur3 32 bits finalizer, a bijection of the 32 bits integers with 
+ * good avalanche properties.
+ */
+static guint32
+_ncm_rng_fmix32 (guint32 h)
+{
+  h ^= h >> 16;
+  h *= 0x85ebca6bU;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35U;
+  h ^= h >> 16;
+
+  return h;
+}
+
+/**
+ * ncm_rng_substream_seed:
+ * @rng: a #NcmRNG
+ * @stream: substream index
+ * 
+ * Computes the seed of the substream @stream derived from the seed of @rng,
+ * see ncm_rng_substream_new(). For a fixed @rng seed, different values of 
+ * @stream always result in different seeds.
+ * 
+ * Returns: the seed of the substream @stream.
+ */
+gulong
+ncm_rng_substream_seed (NcmRNG *rng, guint32 stream)
+{
+  const guint64 seed = rng->seed_val;
+  const guint32 base = _ncm_rng_fmix32 (((guint32) seed) ^ _ncm_rng_fmix32 ((guint32) (seed >> 32)));
+
+  /* 
+   * The sum is a bijection in stream for a fixed base, the outer mixing
+   * scatters consecutive substreams over the seed space. Most GSL 
+   * algorithms use only the 32 lower bits of the seed.
+   */
+  return _ncm_rng_fmix32 (base + stream);
+}
+
+/**
+ * ncm_rng_substream_new:
+ * @rng: a #NcmRNG
+ * @stream: substream index
+ * 
+ * Creates a new #NcmRNG, using the same algorithm as @rng, to be used as
+ * an independent stream by a single consumer (a thread, a walker, a 
+ * realization, etc). Since the returned object is not shared, it can be
+ * used without locking.
+ * 
+ * The substream depends only on the seed of @rng and on @stream, and not
+ * on the current state of @rng. Therefore, indexing the substreams by the
+ * work item, instead of by the thread, makes the results independent of 
+ * the number of threads and reproducible from the master seed saved with
+ * @rng alone.
+ * 
+ * GSL algorithms do not provide skip-ahead, so the substreams are seeded 
+ * through ncm_rng_substream_seed() and their independence relies on the
+ * seeding of the underlying algorithm. The substream seeds are not 
+ * registered as used seeds (see ncm_rng_check_seed()), creating a 
+ * substream does not touch any global state.
+ * 
+ * Currently only #NcmFitMC draws from substreams (see 
+ * ncm_fit_mc_set_rng_substreams()), the other threaded consumers, e.g.,
+ * #NcmFitESMCMC, the #NcmDataGaussCov resampling and the #NcmStatsDistNd
+ * sampling, still share a locked #NcmRNG and their results depend on the
+ * number of threads.
+ * 
+ * Returns: (transfer full): a new #NcmRNG.
+ */
+NcmRNG *
+ncm_rng_substream_new (NcmRNG *rng, guint32 stream)
+{
+  NcmRNG *sub = ncm_rng_new (ncm_rng_get_algo (rng));
+
+  _ncm_rng_set_seed (sub, ncm_rng_substream_seed (rng, stream), FALSE);
+
+  return sub;
+}
+
 static GHashTable *rng_table = NULL;
 
 /**
@@ -84,6 +84,9 @@ void ncm_rng_set_seed (NcmRNG *rng, gulong seed);
 gulong ncm_rng_get_seed (NcmRNG *rng);
 void ncm_rng_set_random_seed (NcmRNG *rng, gboolean allow_colisions);
 
+gulong ncm_rng_substream_seed (NcmRNG *rng, guint32 stream);
+NcmRNG *ncm_rng_substream_new (NcmRNG *rng, guint32 stream);
+
 NcmRNG *ncm_rng_pool_get (const gchar *name);
 
 G_INLINE_FUNC gdouble ncm_rng_uniform_gen (NcmRNG *rng, const gdouble xl, const gdouble xu); 
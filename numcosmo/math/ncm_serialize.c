@@ -68,6 +68,8 @@ ncm_serialize_init (NcmSerialize *ser)
                                                &g_free);
   ser->saved_name_ser = g_hash_table_new_full (&g_str_hash, &g_str_equal, &g_free,
                                                (GDestroyNotify)&g_variant_unref);
+  ser->dup_ptr        = g_hash_table_new_full (&g_direct_hash, &g_direct_equal, &g_object_unref,
+                                               &g_object_unref);
   
   ser->is_named_regex  = g_regex_new ("^\\s*([A-Za-z][A-Za-z0-9\\+\\_]+)\\s*\\[([A-Za-z0-9\\:]+)\\]\\s*$", 0, 0, &error);
   ser->parse_obj_regex = g_regex_new ("^\\s*([A-Za-z][A-Za-z0-9\\+\\_]+\\s*(?:\\[[A-Za-z0-9\\:]+\\])?)\\s*([\\{]?.*[\\}]?)\\s*$", 0, 0, &error);
@@ -118,12 +120,14 @@ _ncm_serialize_finalize (GObject *object)
 
   g_hash_table_remove_all (ser->saved_ptr_name);
   g_hash_table_remove_all (ser->saved_name_ser);
+  g_hash_table_remove_all (ser->dup_ptr);
 
   g_hash_table_unref (ser->name_ptr);
   g_hash_table_unref (ser->ptr_name);
 
   g_hash_table_unref (ser->saved_ptr_name);
   g_hash_table_unref (ser->saved_name_ser);
+  g_hash_table_unref (ser->dup_ptr);
 
   g_regex_unref (ser->is_named_regex);
   g_regex_unref (ser->parse_obj_regex);
@@ -270,6 +274,9 @@ ncm_serialize_reset (NcmSerialize *ser, gboolean autosave_only)
     g_hash_table_remove_all (ser->saved_name_ser);
   }
 
+  /* Duplicates are always autosaved objects. */
+  g_hash_table_remove_all (ser->dup_ptr);
+
   ser->autosave_count = 0;
 }
 
@@ -1435,17 +1442,181 @@ ncm_serialize_to_binfile (NcmSerialize *ser, GObject *obj, const gchar *filename
   g_variant_unref (obj_ser);
 }
 
+static gboolean
+_ncm_serialize_dup_gvalue (NcmSerialize *ser, const GValue *val, GValue *dup_val)
+{
+  GType t      = G_VALUE_TYPE (val);
+  GType fund_t = G_TYPE_FUNDAMENTAL (t);
+
+  g_value_init (dup_val, t);
+
+  switch (fund_t)
+  {
+    case G_TYPE_OBJECT:
+    {
+      GObject *nest_obj = g_value_get_object (val);
+
+      if (nest_obj == NULL)
+        return FALSE;
+
+      g_value_take_object (dup_val, ncm_serialize_dup_obj (ser, nest_obj));
+      break;
+    }
+    case G_TYPE_BOXED:
+    {
+      if (g_value_get_boxed (val) == NULL)
+        return FALSE;
+
+      if (g_type_is_a (t, NCM_TYPE_OBJ_ARRAY))
+        g_value_take_boxed (dup_val, ncm_obj_array_dup (g_value_get_boxed (val), ser));
+      else if (g_type_is_a (t, G_TYPE_STRV))
+        g_value_copy (val, dup_val);
+      else
+        g_error ("Cannot convert GValue '%s' to GVariant.", g_type_name (t));
+      break;
+    }
+    case G_TYPE_VARIANT:
+      if (g_value_get_variant (val) == NULL)
+        return FALSE;
+
+      g_value_copy (val, dup_val);
+      break;
+    case G_TYPE_STRING:
+    {
+      const gchar *str = g_value_get_string (val);
+
+      /* The GVariant round trip turns NULL strings into empty ones. */
+      g_value_set_string (dup_val, (str != NULL) ? str : "");
+      break;
+    }
+    case G_TYPE_ENUM:
+    case G_TYPE_FLAGS:
+      g_value_copy (val, dup_val);
+      break;
+    default:
+      if (_ncm_serialize_gtype_to_gvariant_type (fund_t) == NULL)
+        g_error ("Cannot convert GValue '%s' to GVariant.", g_type_name (t));
+
+      g_value_copy (val, dup_val);
+      break;
+  }
+
+  return TRUE;
+}
+
 /**
  * ncm_serialize_dup_obj:
  * @ser: a #NcmSerialize.
  * @obj: a #GObject.
  *
- * Duplicates @obj by serializing and deserializing a new object.
+ * Duplicates @obj creating a new object with a copy of each of its
+ * read-write properties. The result is the same object obtained by
+ * serializing and deserializing @obj, see ncm_serialize_dup_obj_variant(),
+ * but the properties are copied directly from #GValue to #GValue and no
+ * intermediary #GVariant is created. Vectors and matrices are copied with
+ * ncm_vector_dup() and ncm_matrix_dup().
+ *
+ * Instances saved in @ser, see ncm_serialize_set(), are not duplicated
+ * and the same instance is shared by the original and the duplicate.
+ * When @ser has the option #NCM_SERIALIZE_OPT_CLEAN_DUP, an object
+ * which appears more than once in @obj is duplicated only once, and the
+ * duplicate is kept in @ser until ncm_serialize_reset() is called.
  *
  * Returns: (transfer full): A duplicate of @obj.
  */
 GObject *
 ncm_serialize_dup_obj (NcmSerialize *ser, GObject *obj)
+{
+  const gboolean share_dup = ((ser->opts & NCM_SERIALIZE_OPT_CLEAN_DUP) == NCM_SERIALIZE_OPT_CLEAN_DUP);
+  GObject *dup             = NULL;
+
+  if (ncm_serialize_contain_instance (ser, obj))
+    return g_object_ref (obj);
+
+  if (share_dup && ((dup = g_hash_table_lookup (ser->dup_ptr, obj)) != NULL))
+    return g_object_ref (dup);
+
+  if (NCM_IS_VECTOR (obj))
+  {
+    dup = G_OBJECT (ncm_vector_dup (NCM_VECTOR (obj)));
+  }
+  else if (NCM_IS_MATRIX (obj))
+  {
+    dup = G_OBJECT (ncm_matrix_dup (NCM_MATRIX (obj)));
+  }
+  else
+  {
+    GObjectClass *klass = G_OBJECT_GET_CLASS (obj);
+    guint n_properties  = 0;
+    GParamSpec **prop   = g_object_class_list_properties (klass, &n_properties);
+    const gchar **names = g_new (const gchar *, n_properties);
+    GValue *values      = g_new0 (GValue, n_properties);
+    guint nprop         = 0;
+    guint i;
+
+    for (i = 0; i < n_properties; i++)
+    {
+      GValue val = G_VALUE_INIT;
+
+      if ((prop[i]->flags & G_PARAM_READWRITE) != G_PARAM_READWRITE)
+        continue;
+
+      g_value_init (&val, prop[i]->value_type);
+      g_object_get_property (obj, prop[i]->name, &val);
+
+      if (_ncm_serialize_dup_gvalue (ser, &val, &values[nprop]))
+      {
+        names[nprop] = prop[i]->name;
+        nprop++;
+      }
+      else
+        g_value_unset (&values[nprop]);
+
+      g_value_unset (&val);
+    }
+
+#if GLIB_CHECK_VERSION(2,54,0)
+    dup = g_object_new_with_properties (G_OBJECT_TYPE (obj), nprop, names, values);
+#else
+    {
+      GParameter *gprop = g_new (GParameter, nprop);
+
+      for (i = 0; i < nprop; i++)
+      {
+        gprop[i].name  = names[i];
+        gprop[i].value = values[i];
+      }
+
+      dup = g_object_newv (G_OBJECT_TYPE (obj), nprop, gprop);
+      g_free (gprop);
+    }
+#endif /* GLIB_CHECK_VERSION(2,54,0) */
+
+    for (i = 0; i < nprop; i++)
+      g_value_unset (&values[i]);
+
+    g_free (names);
+    g_free (values);
+    g_free (prop);
+  }
+
+  if (share_dup)
+    g_hash_table_insert (ser->dup_ptr, g_object_ref (obj), g_object_ref (dup));
+
+  return dup;
+}
+
+/**
+ * ncm_serialize_dup_obj_variant:
+ * @ser: a #NcmSerialize.
+ * @obj: a #GObject.
+ *
+ * Duplicates @obj by serializing and deserializing a new object.
+ *
+ * Returns: (transfer full): A duplicate of @obj.
+ */
+GObject *
+ncm_serialize_dup_obj_variant (NcmSerialize *ser, GObject *obj)
 {
   GVariant *var = ncm_serialize_to_variant (ser, obj);
   GObject *dup  = ncm_serialize_from_variant (ser, var);
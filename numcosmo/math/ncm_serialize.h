@@ -75,6 +75,7 @@ struct _NcmSerialize
   GHashTable *ptr_name;
   GHashTable *saved_ptr_name;
   GHashTable *saved_name_ser;
+  GHashTable *dup_ptr;
   GRegex *is_named_regex;
   GRegex *parse_obj_regex;
   NcmSerializeOpt opts;
@@ -120,6 +121,7 @@ gchar *ncm_serialize_to_string (NcmSerialize *ser, GObject *obj, gboolean valid_
 void ncm_serialize_to_file (NcmSerialize *ser, GObject *obj, const gchar *filename);
 void ncm_serialize_to_binfile (NcmSerialize *ser, GObject *obj, const gchar *filename);
 GObject *ncm_serialize_dup_obj (NcmSerialize *ser, GObject *obj);
+GObject *ncm_serialize_dup_obj_variant (NcmSerialize *ser, GObject *obj);
 
 /* Global NcmSerialize object */
 
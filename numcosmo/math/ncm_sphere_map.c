@@ -47,6 +47,7 @@
 #include "math/ncm_timer.h"
 #include "math/ncm_spline_func.h"
 #include "math/ncm_spline_cubic_notaknot.h"
+#include "math/ncm_func_eval.h"
 #include "ncm_enum_types.h"
 
 #undef HAVE_FFTW3F
@@ -106,6 +107,14 @@
 #include <gsl/gsl_sf_trig.h>
 #endif /* NUMCOSMO_GIR_SCAN */
 
+/*
+ * The Legendre recursion runs over blocks of NC antipodal ring pairs.
+ * The NCT = 2 NC values of each step are stored contiguously (see
+ * NCM_SF_SPHERICAL_HARMONICS_ARRAY_INDEX), so the inner loops over
+ * rings have unit stride and a fixed length. No intrinsics are used,
+ * whether these loops are vectorized is left to the compiler and its
+ * flags.
+ */
 #ifndef NCM_SPHERE_MAP_BLOCK_NC 
 #define NCM_SPHERE_MAP_BLOCK_NC 2
 #define NCM_SPHERE_MAP_BLOCK_STEP 8
@@ -139,6 +148,7 @@ struct _NcmSphereMapPrivate
   gint64 nrings_middle;
   gint64 block_ring_size;
   gint64 last_sing_ring;
+  guint nthreads;
   NcmSphereMapOrder order;
   NcmSphereMapCoordSys coordsys;
   gpointer pvec;
@@ -174,6 +184,7 @@ enum
   PROP_ORDER,
   PROP_COORDSYS,
   PROP_LMAX,
+  PROP_NTHREADS,
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (NcmSphereMap, ncm_sphere_map, G_TYPE_OBJECT);
@@ -193,6 +204,7 @@ ncm_sphere_map_init (NcmSphereMap *smap)
   self->nrings_middle     = 0;
   self->block_ring_size   = 0;
   self->last_sing_ring    = 0;
+  self->nthreads          = 0;
   self->order             = NCM_SPHERE_MAP_ORDER_RING;
   self->coordsys          = NCM_SPHERE_MAP_COORD_SYS_LEN;
   self->pvec              = NULL;
@@ -242,6 +254,9 @@ _ncm_sphere_map_set_property (GObject *object, guint prop_id, const GValue *valu
     case PROP_LMAX:
       ncm_sphere_map_set_lmax (smap, g_value_get_uint (value));    
       break;
+    case PROP_NTHREADS:
+      ncm_sphere_map_set_nthreads (smap, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -269,6 +284,9 @@ _ncm_sphere_map_get_property (GObject *object, guint prop_id, GValue *value, GPa
     case PROP_LMAX:
       g_value_set_uint (value, ncm_sphere_map_get_lmax (smap));
       break;
+    case PROP_NTHREADS:
+      g_value_set_uint (value, ncm_sphere_map_get_nthreads (smap));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -351,6 +369,13 @@ ncm_sphere_map_class_init (NcmSphereMapClass *klass)
                                                       "max ell",
                                                       0, G_MAXUINT32, 0,
                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_NTHREADS,
+                                   g_param_spec_uint ("nthreads",
+                                                      NULL,
+                                                      "Number of threads used in the transforms",
+                                                      0, G_MAXUINT32, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 /**
@@ -827,6 +852,39 @@ ncm_sphere_map_get_lmax (NcmSphereMap *smap)
   return self->lmax;
 }
 
+/**
+ * ncm_sphere_map_set_nthreads:
+ * @smap: a #NcmSphereMap
+ * @nthreads: number of threads
+ * 
+ * Sets the number of threads used by ncm_sphere_map_prepare_alm() and
+ * ncm_sphere_map_alm2map(). When @nthreads is smaller than two the
+ * transforms run serially. The ring FFTs and the rings synthesis
+ * give the same result for any number of threads, the $a_{\ell{}m}$
+ * analysis sums the contribution of each thread in a fixed order and
+ * it is reproducible for a given @nthreads.
+ * 
+ */
+void 
+ncm_sphere_map_set_nthreads (NcmSphereMap *smap, guint nthreads)
+{
+  NcmSphereMapPrivate * const self = smap->priv;
+  self->nthreads = nthreads;
+}
+
+/**
+ * ncm_sphere_map_get_nthreads:
+ * @smap: a #NcmSphereMap
+ * 
+ * Returns: the number of threads used in the transforms.
+ */
+guint 
+ncm_sphere_map_get_nthreads (NcmSphereMap *smap)
+{
+  NcmSphereMapPrivate * const self = smap->priv;
+  return self->nthreads;
+}
+
 /**
  * ncm_sphere_map_clear_pixels:
  * @smap: a #NcmSphereMap
@@ -1984,6 +2042,38 @@ _ncm_sphere_map_prepare_fft (NcmSphereMap *smap)
 }
 
 #ifdef NUMCOSMO_HAVE_FFTW3
+static void
+_ncm_sphere_map_exec_r2c_mt (glong i, glong f, gpointer data)
+{
+  NcmSphereMapPrivate * const self = NCM_SPHERE_MAP (data)->priv;
+  glong n;
+
+  for (n = i; n < f; n++)
+  {
+#  ifdef HAVE_FFTW3F
+    fftwf_execute (g_ptr_array_index (self->fft_plan_r2c, n));    
+#  else
+    fftw_execute (g_ptr_array_index (self->fft_plan_r2c, n));
+#endif
+  }
+}
+
+static void
+_ncm_sphere_map_exec_c2r_mt (glong i, glong f, gpointer data)
+{
+  NcmSphereMapPrivate * const self = NCM_SPHERE_MAP (data)->priv;
+  glong n;
+
+  for (n = i; n < f; n++)
+  {
+#  ifdef HAVE_FFTW3F
+    fftwf_execute (g_ptr_array_index (self->fft_plan_c2r, n));    
+#  else
+    fftw_execute (g_ptr_array_index (self->fft_plan_c2r, n));
+#endif
+  }
+}
+
 #include "ncm_sphere_map_block.c"
 #endif
 
@@ -2038,7 +2128,6 @@ ncm_sphere_map_prepare_alm (NcmSphereMap *smap)
 {
 #ifdef NUMCOSMO_HAVE_FFTW3
   NcmSphereMapPrivate * const self = smap->priv;
-  gint i;  
 
   if (self->lmax == 0)
   {
@@ -2062,14 +2151,11 @@ ncm_sphere_map_prepare_alm (NcmSphereMap *smap)
   ncm_timer_start (self->t);
 #endif /* _NCM_SPHERE_MAP_MEASURE */	
     
-  for (i = 0; i < self->fft_plan_r2c->len; i++)
-  {
-#  ifdef HAVE_FFTW3F
-    fftwf_execute (g_ptr_array_index (self->fft_plan_r2c, i));    
-#  else
-    fftw_execute (g_ptr_array_index (self->fft_plan_r2c, i));
-#endif
-  }
+  /* Each plan acts on its own rings, so they can be executed concurrently. */
+  if (self->nthreads > 1)
+    ncm_func_eval_threaded_loop_ws_nw (&_ncm_sphere_map_exec_r2c_mt, 0, self->fft_plan_r2c->len, smap, self->nthreads, 1);
+  else
+    _ncm_sphere_map_exec_r2c_mt (0, self->fft_plan_r2c->len, smap);
   
 #ifdef _NCM_SPHERE_MAP_MEASURE
   printf ("# Peforming ffts, elapsed % 22.15g\n", ncm_timer_elapsed (self->t));
@@ -2258,7 +2344,6 @@ ncm_sphere_map_alm2map (NcmSphereMap *smap)
 {
 #ifdef NUMCOSMO_HAVE_FFTW3
   NcmSphereMapPrivate * const self = smap->priv;
-  guint i;
 
   /*gfloat *temp_pix = _fft_vec_alloc (self->npix);*/
   /*gfloat *pixels   = self->pvec;*/
@@ -2299,14 +2384,10 @@ ncm_sphere_map_alm2map (NcmSphereMap *smap)
   ncm_timer_start (self->t);
 #endif /* _NCM_SPHERE_MAP_MEASURE */	
 
-	for (i = 0; i < self->fft_plan_c2r->len; i++)
-  {
-#  ifdef HAVE_FFTW3F
-    fftwf_execute (g_ptr_array_index (self->fft_plan_c2r, i));    
-#  else
-    fftw_execute (g_ptr_array_index (self->fft_plan_c2r, i));
-#endif
-  } 
+  if (self->nthreads > 1)
+    ncm_func_eval_threaded_loop_ws_nw (&_ncm_sphere_map_exec_c2r_mt, 0, self->fft_plan_c2r->len, smap, self->nthreads, 1);
+  else
+    _ncm_sphere_map_exec_c2r_mt (0, self->fft_plan_c2r->len, smap);
 #ifdef _NCM_SPHERE_MAP_MEASURE
   printf ("# Peforming ffts, elapsed % 22.15g\n", ncm_timer_elapsed (self->t));
 #endif /* _NCM_SPHERE_MAP_MEASURE */	
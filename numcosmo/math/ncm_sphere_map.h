@@ -127,6 +127,9 @@ NcmSphereMapCoordSys ncm_sphere_map_get_coordsys (NcmSphereMap *smap);
 void ncm_sphere_map_set_lmax (NcmSphereMap *smap, guint lmax);
 guint ncm_sphere_map_get_lmax (NcmSphereMap *smap);
 
+void ncm_sphere_map_set_nthreads (NcmSphereMap *smap, guint nthreads);
+guint ncm_sphere_map_get_nthreads (NcmSphereMap *smap);
+
 void ncm_sphere_map_clear_smapels (NcmSphereMap *smap);
 
 gint64 ncm_sphere_map_nest2ring (NcmSphereMap *smap, const gint64 nest_index);
@@ -326,6 +326,43 @@ NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_get_alm_from_circle) (NcmSphereMap *pi
   }
 }
 
+typedef struct _NcmSphereMapMap2almMT
+{
+  NcmSphereMap *pix;
+  complex double **buf;
+  gboolean *c;
+  gint64 nblocks;
+  gint64 nparts;
+  gint64 chunk;
+  gint64 mmax;
+} NcmSphereMapMap2almMT;
+
+static void 
+NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_map2alm_blocks_mt) (glong i, glong f, gpointer data)
+{
+  NcmSphereMapMap2almMT *arg       = (NcmSphereMapMap2almMT *) data;
+  NcmSphereMapPrivate * const self = arg->pix->priv;
+  const gint64 nrings              = ncm_sphere_map_get_nrings (arg->pix);
+  glong p;
+
+  for (p = i; p < f; p++)
+  {
+    gboolean c_all = FALSE;
+    gint64 b;
+
+    memset (arg->buf[p], 0, sizeof (complex double) * arg->chunk);
+
+    for (b = p; b < arg->nblocks; b += arg->nparts)
+    {
+      NcmSFSphericalHarmonicsYArray *sphaYa = g_ptr_array_index (self->sphaYa_array, b);
+      const gboolean c                      = NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_get_alm_from_apcircles) (arg->pix, sphaYa, NCM_COMPLEX (arg->buf[p]), b * NCM_SPHERE_MAP_BLOCK_NC, nrings, arg->mmax);
+      c_all = c_all || c;
+    }
+
+    arg->c[p] = c_all;
+  }
+}
+
 static void 
 NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_map2alm_run) (NcmSphereMap *pix)
 {
@@ -335,6 +372,9 @@ NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_map2alm_run) (NcmSphereMap *pix)
   const gint64 nrings              = ncm_sphere_map_get_nrings (pix);
   const gint64 lr_i                = self->block_ring_size;
   const gint64 nrleft              = self->last_sing_ring;
+  const gint64 nblocks             = lr_i / NCM_SPHERE_MAP_BLOCK_NC;
+  const gint64 nparts              = MIN (self->nthreads, nblocks);
+  NcmSphereMapMap2almMT arg        = {pix, NULL, NULL, nblocks, nparts, 0, 0};
   gint64 r_i, m, offset;
   
   memset (alm, 0, sizeof (NcmComplex) * self->alm_len);
@@ -346,6 +386,26 @@ NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_map2alm_run) (NcmSphereMap *pix)
     ncm_sf_spherical_harmonics_Y_array_reset (sphaYa, NCM_SPHERE_MAP_BLOCK_NCT);
   }
 
+  /*
+   * When running in parallel the ring blocks are dealt to nparts sets
+   * in a round-robin, each one accumulating on its own buffer. Blocks
+   * near the poles leave the m loop earlier, so interleaving them keeps
+   * the sets balanced. The buffers are then added in a fixed order, so
+   * the result depends only on the number of threads and not on the
+   * scheduling.
+   */
+  if (nparts > 1)
+  {
+    const gint64 max_chunk = 1024 * NCM_SPHERE_MAP_BLOCK_CM + self->lmax + 1;
+    gint64 p;
+
+    arg.buf = g_new (complex double *, nparts);
+    arg.c   = g_new (gboolean, nparts);
+
+    for (p = 0; p < nparts; p++)
+      arg.buf[p] = g_new (complex double, max_chunk);
+  }
+
   m      = 0;
   offset = 0;
   
@@ -360,12 +420,33 @@ NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_map2alm_run) (NcmSphereMap *pix)
     
     /*printf ("# mmax %ld lmax %u chunk %ld offset %ld\n", m - 1, self->lmax, chunk, offset);*/
 
-    for (r_i = 0; r_i < lr_i; r_i += NCM_SPHERE_MAP_BLOCK_NC)
+    if (nparts > 1)
     {
-      const gint64 i                        = r_i / NCM_SPHERE_MAP_BLOCK_NC;
-      NcmSFSphericalHarmonicsYArray *sphaYa = g_ptr_array_index (self->sphaYa_array, i);
-      const gboolean c                      = NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_get_alm_from_apcircles) (pix, sphaYa, alm + offset, r_i, nrings, m - 1);
-      c_all = c_all || c; 
+      complex double *alm_chunk = (complex double *) (alm + offset);
+      gint64 p, j;
+
+      arg.chunk = chunk;
+      arg.mmax  = m - 1;
+
+      ncm_func_eval_threaded_loop_nw (&NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_map2alm_blocks_mt), 0, nparts, &arg, nparts);
+
+      for (p = 0; p < nparts; p++)
+      {
+        for (j = 0; j < chunk; j++)
+          alm_chunk[j] += arg.buf[p][j];
+
+        c_all = c_all || arg.c[p];
+      }
+    }
+    else
+    {
+      for (r_i = 0; r_i < lr_i; r_i += NCM_SPHERE_MAP_BLOCK_NC)
+      {
+        const gint64 i                        = r_i / NCM_SPHERE_MAP_BLOCK_NC;
+        NcmSFSphericalHarmonicsYArray *sphaYa = g_ptr_array_index (self->sphaYa_array, i);
+        const gboolean c                      = NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_get_alm_from_apcircles) (pix, sphaYa, alm + offset, r_i, nrings, m - 1);
+        c_all = c_all || c; 
+      }
     }
     
     if (!c_all)
@@ -374,10 +455,23 @@ NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_map2alm_run) (NcmSphereMap *pix)
     offset += chunk;
   }
 
-  for (; r_i < nrleft; r_i++)
+  if (nparts > 1)
+  {
+    gint64 p;
+
+    for (p = 0; p < nparts; p++)
+      g_free (arg.buf[p]);
+
+    g_free (arg.buf);
+    g_free (arg.c);
+  }
+
+  for (r_i = lr_i; r_i < nrleft; r_i++)
   {
     NCM_SPHERE_MAP_BLOCK_DEC (_ncm_sphere_map_get_alm_from_circle) (pix, sphaY, alm, r_i);
   }
+
+  ncm_sf_spherical_harmonics_Y_free (sphaY);
 }
 
 static void
@@ -651,13 +745,46 @@ NCM_SPHERE_MAP_BLOCK_INV_DEC (_ncm_sphere_map_get_apcircles_from_alm) (NcmSphere
   ncm_sf_spherical_harmonics_Y_array_free (sphaYa);
 }
 
+static void 
+NCM_SPHERE_MAP_BLOCK_INV_DEC (_ncm_sphere_map_alm2map_rings_mt) (glong i, glong f, gpointer data)
+{
+  NcmSphereMap *pix     = NCM_SPHERE_MAP (data);
+  const gint64 nrings   = ncm_sphere_map_get_nrings (pix);
+  const gint64 nrings_2 = nrings / 2;
+  const gint64 nblocks  = (nrings_2 - 1) / NCM_SPHERE_MAP_BLOCK_INV_NC;
+  glong n;
+
+  /* Tasks [0, nblocks) are antipodal ring blocks, the remaining ones are single rings. */
+  for (n = i; n < f; n++)
+  {
+    if (n < nblocks)
+      NCM_SPHERE_MAP_BLOCK_INV_DEC (_ncm_sphere_map_get_apcircles_from_alm) (pix, n * NCM_SPHERE_MAP_BLOCK_INV_NC, nrings);
+    else
+      NCM_SPHERE_MAP_BLOCK_INV_DEC (_ncm_sphere_map_get_circle_from_alm) (pix, nblocks * NCM_SPHERE_MAP_BLOCK_INV_NC + (n - nblocks));
+  }
+}
+
 static void 
 NCM_SPHERE_MAP_BLOCK_INV_DEC (_ncm_sphere_map_alm2map_run) (NcmSphereMap *pix)
 {
+  NcmSphereMapPrivate * const self = pix->priv;
   const gint64 nrings   = ncm_sphere_map_get_nrings (pix);
   const gint64 nrings_2 = nrings / 2;
   gint64 r_i, nrleft;
 
+  if (self->nthreads > 1)
+  {
+    /*
+     * Each task writes only to its own rings, hence the result is
+     * identical to the serial one.
+     */
+    const gint64 nblocks = (nrings_2 - 1) / NCM_SPHERE_MAP_BLOCK_INV_NC;
+    const gint64 ntasks  = nblocks + (nrings - 2 * nblocks * NCM_SPHERE_MAP_BLOCK_INV_NC);
+
+    ncm_func_eval_threaded_loop_ws_nw (&NCM_SPHERE_MAP_BLOCK_INV_DEC (_ncm_sphere_map_alm2map_rings_mt), 0, ntasks, pix, self->nthreads, 1);
+    return;
+  }
+
   r_i = 0;
   while (TRUE)
   {
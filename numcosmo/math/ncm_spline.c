@@ -164,6 +164,16 @@ _ncm_spline_finalize (GObject *object)
   G_OBJECT_CLASS (ncm_spline_parent_class)->finalize (object);
 }
 
+static void
+_ncm_spline_eval_vec (const NcmSpline *s, const NcmVector *x, NcmVector *y)
+{
+  const guint n = ncm_vector_len (x);
+  guint k;
+
+  for (k = 0; k < n; k++)
+    ncm_vector_set (y, k, ncm_spline_eval (s, ncm_vector_get (x, k)));
+}
+
 static void
 ncm_spline_class_init (NcmSplineClass *klass)
 {
@@ -208,6 +218,7 @@ ncm_spline_class_init (NcmSplineClass *klass)
   klass->deriv        = NULL;
   klass->deriv2       = NULL;
   klass->integ        = NULL;  
+  klass->eval_vec     = &_ncm_spline_eval_vec;
 }
 
 /**
@@ -610,6 +621,26 @@ ncm_spline_get_bounds (NcmSpline *s, gdouble *lb, gdouble *ub)
   *ub = ncm_vector_get (s->xv, s->len - 1);
 }
 
+/**
+ * ncm_spline_eval_vec:
+ * @s: a constant #NcmSpline
+ * @x: a #NcmVector of x-coordinate values
+ * @y: a #NcmVector to store the results
+ *
+ * Evaluates the spline @s at every element of @x and stores the
+ * results in @y, which must have the same length of @x. The
+ * implementations can take advantage of the ordering of @x, for
+ * them an increasing @x is evaluated in a single sweep through the
+ * knots without any search. Unordered @x are also supported.
+ *
+ */
+void
+ncm_spline_eval_vec (const NcmSpline *s, const NcmVector *x, NcmVector *y)
+{
+  g_assert_cmpuint (ncm_vector_len (x), ==, ncm_vector_len (y));
+  NCM_SPLINE_GET_CLASS (s)->eval_vec (s, x, y);
+}
+
 /**
  * ncm_spline_prepare:
  * @s: a #NcmSpline
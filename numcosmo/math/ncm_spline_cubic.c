@@ -78,6 +78,7 @@ static gdouble _ncm_spline_cubic_deriv (const NcmSpline *s, const gdouble x);
 static gdouble _ncm_spline_cubic_deriv2 (const NcmSpline *s, const gdouble x);
 static gdouble _ncm_spline_cubic_deriv_nmax (const NcmSpline *s, const gdouble x);
 static gdouble _ncm_spline_cubic_integ (const NcmSpline *s, const gdouble x0, const gdouble x1);
+static void _ncm_spline_cubic_eval_vec (const NcmSpline *s, const NcmVector *x, NcmVector *y);
 
 static void
 ncm_spline_cubic_class_init (NcmSplineCubicClass *klass)
@@ -93,6 +94,7 @@ ncm_spline_cubic_class_init (NcmSplineCubicClass *klass)
 	s_class->deriv2       = &_ncm_spline_cubic_deriv2;
   s_class->deriv_nmax   = &_ncm_spline_cubic_deriv_nmax;
 	s_class->integ        = &_ncm_spline_cubic_integ;
+  s_class->eval_vec     = &_ncm_spline_cubic_eval_vec;
 }
 
 static void
@@ -164,6 +166,85 @@ _ncm_spline_cubic_eval (const NcmSpline *s, const gdouble x)
 	}
 }
 
+#define _NCM_SPLINE_CUBIC_MAX_WALK 8
+
+static void
+_ncm_spline_cubic_eval_vec (const NcmSpline *s, const NcmVector *x, NcmVector *y)
+{
+	const NcmSplineCubic *sc = NCM_SPLINE_CUBIC (s);
+  const guint n            = ncm_vector_len (x);
+  const gsize last         = s->len - 2;
+  gsize *idx               = g_new (gsize, n);
+  gsize i                  = 0;
+  guint k;
+
+  /* 
+   * First pass: find the intervals. Increasing abscissas are found walking
+   * forward from the last interval, a binary search is used only when the 
+   * abscissas decrease or jump over many knots.
+   */
+  for (k = 0; k < n; k++)
+  {
+    const gdouble x_k = ncm_vector_get (x, k);
+
+    if (x_k < ncm_vector_get (s->xv, i))
+    {
+      gsize lo = 0, hi = i;
+      while (hi > lo + 1)
+      {
+        const gsize m = (lo + hi) / 2;
+        if (ncm_vector_get (s->xv, m) > x_k)
+          hi = m;
+        else
+          lo = m;
+      }
+      i = lo;
+    }
+    else
+    {
+      guint nwalk = 0;
+      while ((i < last) && (x_k >= ncm_vector_get (s->xv, i + 1)) && (nwalk < _NCM_SPLINE_CUBIC_MAX_WALK))
+      {
+        i++;
+        nwalk++;
+      }
+      if ((i < last) && (x_k >= ncm_vector_get (s->xv, i + 1)))
+      {
+        gsize lo = i, hi = s->len - 1;
+        while (hi > lo + 1)
+        {
+          const gsize m = (lo + hi) / 2;
+          if (ncm_vector_get (s->xv, m) > x_k)
+            hi = m;
+          else
+            lo = m;
+        }
+        i = lo;
+      }
+    }
+
+    idx[k] = i;
+  }
+
+  /* Second pass: evaluate the polynomials, free of branches. */
+  for (k = 0; k < n; k++)
+  {
+    const gsize i_k    = idx[k];
+		const gdouble delx = ncm_vector_get (x, k) - ncm_vector_get (s->xv, i_k);
+    const gdouble a_i  = ncm_vector_get (s->yv, i_k);
+		const gdouble b_i  = ncm_vector_fast_get (sc->b, i_k);
+		const gdouble c_i  = ncm_vector_fast_get (sc->c, i_k);
+		const gdouble d_i  = ncm_vector_fast_get (sc->d, i_k);
+#ifdef HAVE_FMA
+    ncm_vector_set (y, k, fma (fma (fma (d_i, delx, c_i), delx, b_i), delx, a_i));
+#else
+    ncm_vector_set (y, k, a_i + delx * (b_i + delx * (c_i + delx * d_i)));
+#endif /* HAVE_FMA */
+  }
+
+  g_free (idx);
+}
+
 static gdouble
 _ncm_spline_cubic_deriv (const NcmSpline *s, const gdouble x)
 {
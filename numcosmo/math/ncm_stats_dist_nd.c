@@ -120,6 +120,8 @@ _ncm_stats_dist_nd_finalize (GObject *object)
   G_OBJECT_CLASS (ncm_stats_dist_nd_parent_class)->finalize (object);
 }
 
+static void _ncm_stats_dist_nd_eval_batch (NcmStatsDistNd *dnd, NcmMatrix *x, NcmVector *res);
+
 static void
 ncm_stats_dist_nd_class_init (NcmStatsDistNdClass *klass)
 {
@@ -147,6 +149,22 @@ ncm_stats_dist_nd_class_init (NcmStatsDistNdClass *klass)
   klass->kernel_sample     = NULL;
   klass->kernel_eval_m2lnp = NULL;
   klass->reset             = NULL;
+  klass->eval_batch        = &_ncm_stats_dist_nd_eval_batch;
+}
+
+static void 
+_ncm_stats_dist_nd_eval_batch (NcmStatsDistNd *dnd, NcmMatrix *x, NcmVector *res)
+{
+  NcmStatsDistNdClass *dnd_class = NCM_STATS_DIST_ND_GET_CLASS (dnd);
+  const guint m = ncm_matrix_nrows (x);
+  guint i;
+
+  for (i = 0; i < m; i++)
+  {
+    NcmVector *x_i = ncm_matrix_get_row (x, i);
+    ncm_vector_set (res, i, dnd_class->eval (dnd, x_i));
+    ncm_vector_free (x_i);
+  }
 }
 
 /**
@@ -277,6 +295,31 @@ ncm_stats_dist_nd_eval_m2lnp (NcmStatsDistNd *dnd, NcmVector *x)
   return dnd_class->eval_m2lnp (dnd, x);
 }
 
+/**
+ * ncm_stats_dist_nd_eval_batch: (virtual eval_batch)
+ * @dnd: a #NcmStatsDistNd
+ * @x: a #NcmMatrix
+ * @res: a #NcmVector
+ *
+ * Evaluate the distribution at each row of @x and store the results
+ * in @res, i.e., $\mathrm{res}_i = P(\vec{x}_i)$ where $\vec{x}_i$ is
+ * the $i$-th row of @x. The matrix @x must have ncm_stats_dist_nd_get_dim()
+ * columns and @res the same length as the number of rows of @x. 
+ * The default implementation calls ncm_stats_dist_nd_eval() for each
+ * row, subclasses can override it with a more efficient version.
+ * 
+ */
+void 
+ncm_stats_dist_nd_eval_batch (NcmStatsDistNd *dnd, NcmMatrix *x, NcmVector *res)
+{
+  NcmStatsDistNdClass *dnd_class = NCM_STATS_DIST_ND_GET_CLASS (dnd); 
+
+  g_assert_cmpuint (ncm_matrix_ncols (x), ==, dnd->priv->dim);
+  g_assert_cmpuint (ncm_matrix_nrows (x), ==, ncm_vector_len (res));
+
+  dnd_class->eval_batch (dnd, x, res);
+}
+
 /**
  * ncm_stats_dist_nd_sample: (virtual sample)
  * @dnd: a #NcmStatsDistNd
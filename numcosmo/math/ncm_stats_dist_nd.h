@@ -32,6 +32,7 @@
 #include <numcosmo/build_cfg.h>
 #include <numcosmo/math/ncm_rng.h>
 #include <numcosmo/math/ncm_vector.h>
+#include <numcosmo/math/ncm_matrix.h>
 
 G_BEGIN_DECLS
 
@@ -59,6 +60,7 @@ struct _NcmStatsDistNdClass
   void (*kernel_sample) (NcmStatsDistNd *dnd, NcmVector *x, NcmVector *mu, const gdouble scale, NcmRNG *rng);
   gdouble (*kernel_eval_m2lnp) (NcmStatsDistNd *dnd, NcmVector *x, NcmVector *y, const gdouble scale);
   void (*reset) (NcmStatsDistNd *dnd);
+  void (*eval_batch) (NcmStatsDistNd *dnd, NcmMatrix *x, NcmVector *res);
 };
 
 struct _NcmStatsDistNd
@@ -80,6 +82,7 @@ void ncm_stats_dist_nd_prepare (NcmStatsDistNd *dnd);
 void ncm_stats_dist_nd_prepare_interp (NcmStatsDistNd *dnd, NcmVector *m2lnp);
 gdouble ncm_stats_dist_nd_eval (NcmStatsDistNd *dnd, NcmVector *x);
 gdouble ncm_stats_dist_nd_eval_m2lnp (NcmStatsDistNd *dnd, NcmVector *x);
+void ncm_stats_dist_nd_eval_batch (NcmStatsDistNd *dnd, NcmMatrix *x, NcmVector *res);
 void ncm_stats_dist_nd_sample (NcmStatsDistNd *dnd, NcmVector *x, NcmRNG *rng);
 
 void ncm_stats_dist_nd_kernel_sample (NcmStatsDistNd *dnd, NcmVector *x, NcmVector *mu, const gdouble scale, NcmRNG *rng);
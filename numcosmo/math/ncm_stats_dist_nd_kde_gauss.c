@@ -42,6 +42,7 @@
 #include "math/ncm_stats_vec.h"
 #include "math/ncm_c.h"
 #include "math/ncm_lapack.h"
+#include "math/ncm_memory_pool.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include "gslextras/cqp/gsl_cqp.h"
@@ -56,7 +57,8 @@ struct _NcmStatsDistNdKDEGaussPrivate
   NcmMatrix *cov_decomp;
   NcmMatrix *log_cov;
   NcmMatrix *sample_matrix;
-  GPtrArray *smatrix_rows;
+  NcmVector *sample_norm2;
+  NcmVector *sample_center;
   NcmVector *weights;
   NcmVector *v;
   gdouble over_smooth;
@@ -82,8 +84,36 @@ struct _NcmStatsDistNdKDEGaussPrivate
   NcmVector *zeta;
   NcmLapackWS *lapack_ws;
   GArray *ipiv;
+  gdouble cut_off;
+  GArray *kd_perm;
+  GArray *kd_nodes;
+  GArray *kd_bbox;
+  NcmMemoryPool *kd_scratch;
 };
 
+/*
+ * Per-call work space of the kernel sums, the object may be evaluated
+ * concurrently by several threads.
+ */
+typedef struct _NcmStatsDistNdKDEGaussKDScratch
+{
+  GArray *stack;
+  GArray *nb_index;
+  GArray *nb_dist2;
+  GArray *v;
+} NcmStatsDistNdKDEGaussKDScratch;
+
+typedef struct _NcmStatsDistNdKDEGaussKDNode
+{
+  guint lo;
+  guint hi;
+  guint left;
+  guint right;
+} NcmStatsDistNdKDEGaussKDNode;
+
+#define NCM_STATS_DIST_ND_KDE_GAUSS_KD_LEAF_SIZE 16
+#define NCM_STATS_DIST_ND_KDE_GAUSS_BATCH_BLOCK 64
+
 enum
 {
   PROP_0,
@@ -91,10 +121,37 @@ enum
   PROP_OVER_SMOOTH,
   PROP_NEARPD_MAXITER,
   PROP_LOOCV,
+  PROP_CUT_OFF,
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (NcmStatsDistNdKDEGauss, ncm_stats_dist_nd_kde_gauss, NCM_TYPE_STATS_DIST_ND);
 
+static gpointer
+_ncm_stats_dist_nd_kde_gauss_kd_scratch_new (gpointer userdata)
+{
+  NcmStatsDistNdKDEGaussKDScratch *scratch = g_new (NcmStatsDistNdKDEGaussKDScratch, 1);
+
+  scratch->stack    = g_array_new (FALSE, FALSE, sizeof (guint));
+  scratch->nb_index = g_array_new (FALSE, FALSE, sizeof (guint));
+  scratch->nb_dist2 = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  scratch->v        = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+  return scratch;
+}
+
+static void
+_ncm_stats_dist_nd_kde_gauss_kd_scratch_free (gpointer p)
+{
+  NcmStatsDistNdKDEGaussKDScratch *scratch = (NcmStatsDistNdKDEGaussKDScratch *) p;
+
+  g_array_unref (scratch->stack);
+  g_array_unref (scratch->nb_index);
+  g_array_unref (scratch->nb_dist2);
+  g_array_unref (scratch->v);
+
+  g_free (scratch);
+}
+
 static void
 ncm_stats_dist_nd_kde_gauss_init (NcmStatsDistNdKDEGauss *dndg)
 {
@@ -104,7 +161,8 @@ ncm_stats_dist_nd_kde_gauss_init (NcmStatsDistNdKDEGauss *dndg)
   self->cov_decomp       = NULL;
   self->log_cov          = NULL;
   self->sample_matrix    = NULL;
-  self->smatrix_rows     = g_ptr_array_new ();
+  self->sample_norm2     = NULL;
+  self->sample_center    = NULL;
   self->weights          = NULL;
   self->v                = NULL;
   self->over_smooth      = 0.0;
@@ -130,8 +188,12 @@ ncm_stats_dist_nd_kde_gauss_init (NcmStatsDistNdKDEGauss *dndg)
   self->zeta             = NULL;
   self->lapack_ws        = ncm_lapack_ws_new ();
   self->ipiv             = g_array_new (FALSE, FALSE, sizeof (guint));
-
-  g_ptr_array_set_free_func (self->smatrix_rows, (GDestroyNotify) ncm_vector_free);
+  self->cut_off          = 0.0;
+  self->kd_perm          = g_array_new (FALSE, FALSE, sizeof (guint));
+  self->kd_nodes         = g_array_new (FALSE, FALSE, sizeof (NcmStatsDistNdKDEGaussKDNode));
+  self->kd_bbox          = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  self->kd_scratch       = ncm_memory_pool_new (&_ncm_stats_dist_nd_kde_gauss_kd_scratch_new, NULL,
+                                                 (GDestroyNotify) &_ncm_stats_dist_nd_kde_gauss_kd_scratch_free);
 }
 
 static void
@@ -156,6 +218,9 @@ _ncm_stats_dist_nd_kde_gauss_set_property (GObject *object, guint prop_id, const
     case PROP_LOOCV:
       ncm_stats_dist_nd_kde_gauss_set_LOOCV_bandwidth_adj (dndg, g_value_get_boolean (value));
       break;
+    case PROP_CUT_OFF:
+      ncm_stats_dist_nd_kde_gauss_set_cut_off (dndg, g_value_get_double (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -184,6 +249,9 @@ _ncm_stats_dist_nd_kde_gauss_get_property (GObject *object, guint prop_id, GValu
     case PROP_LOOCV:
       g_value_set_boolean (value, ncm_stats_dist_nd_kde_gauss_get_LOOCV_bandwidth_adj (dndg));
       break;
+    case PROP_CUT_OFF:
+      g_value_set_double (value, ncm_stats_dist_nd_kde_gauss_get_cut_off (dndg));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -200,11 +268,12 @@ _ncm_stats_dist_nd_kde_gauss_dispose (GObject *object)
   ncm_matrix_clear (&self->cov_decomp);
   ncm_matrix_clear (&self->log_cov);
   ncm_matrix_clear (&self->sample_matrix);
+  ncm_vector_clear (&self->sample_norm2);
+  ncm_vector_clear (&self->sample_center);
   ncm_vector_clear (&self->weights);
   ncm_vector_clear (&self->v);
 
   g_clear_pointer (&self->sampling, g_array_unref);
-  g_clear_pointer (&self->smatrix_rows, g_ptr_array_unref);
 
   ncm_matrix_clear (&self->A);
   ncm_matrix_clear (&self->IM);
@@ -218,6 +287,16 @@ _ncm_stats_dist_nd_kde_gauss_dispose (GObject *object)
   ncm_lapack_ws_clear (&self->lapack_ws);
   g_clear_pointer (&self->ipiv, g_array_unref);
 
+  g_clear_pointer (&self->kd_perm, g_array_unref);
+  g_clear_pointer (&self->kd_nodes, g_array_unref);
+  g_clear_pointer (&self->kd_bbox, g_array_unref);
+
+  if (self->kd_scratch != NULL)
+  {
+    ncm_memory_pool_free (self->kd_scratch, TRUE);
+    self->kd_scratch = NULL;
+  }
+
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_stats_dist_nd_kde_gauss_parent_class)->dispose (object);
 }
@@ -239,6 +318,7 @@ static void _ncm_stats_dist_nd_kde_gauss_sample (NcmStatsDistNd *dnd, NcmVector
 void _ncm_stats_dist_nd_kde_gauss_kernel_sample (NcmStatsDistNd *dnd, NcmVector *y, NcmVector *mu, gdouble scale, NcmRNG *rng);
 gdouble _ncm_stats_dist_nd_kde_gauss_kernel_eval_m2lnp (NcmStatsDistNd *dnd, NcmVector *x, NcmVector *y, gdouble scale);
 static void _ncm_stats_dist_nd_kde_gauss_reset (NcmStatsDistNd *dnd);
+static void _ncm_stats_dist_nd_kde_gauss_eval_batch (NcmStatsDistNd *dnd, NcmMatrix *x, NcmVector *res);
 
 static void
 ncm_stats_dist_nd_kde_gauss_class_init (NcmStatsDistNdKDEGaussClass *klass)
@@ -282,6 +362,14 @@ ncm_stats_dist_nd_kde_gauss_class_init (NcmStatsDistNdKDEGaussClass *klass)
                                                       "Maximum number of iterations in the nearPD call",
                                                       1, G_MAXUINT, 200,
                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+  g_object_class_install_property (object_class,
+                                   PROP_CUT_OFF,
+                                   g_param_spec_double ("cut-off",
+                                                        NULL,
+                                                        "Kernel truncation radius in units of the bandwidth (zero means no truncation)",
+                                                        0.0, G_MAXDOUBLE, 0.0,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   
   dnd_class->set_dim           = &_ncm_stats_dist_nd_kde_gauss_set_dim;
   dnd_class->prepare           = &_ncm_stats_dist_nd_kde_gauss_prepare;
@@ -292,6 +380,7 @@ ncm_stats_dist_nd_kde_gauss_class_init (NcmStatsDistNdKDEGaussClass *klass)
   dnd_class->kernel_sample     = &_ncm_stats_dist_nd_kde_gauss_kernel_sample;
   dnd_class->kernel_eval_m2lnp = &_ncm_stats_dist_nd_kde_gauss_kernel_eval_m2lnp;
   dnd_class->reset             = &_ncm_stats_dist_nd_kde_gauss_reset;
+  dnd_class->eval_batch        = &_ncm_stats_dist_nd_kde_gauss_eval_batch;
 }
 
 static void 
@@ -305,6 +394,8 @@ _ncm_stats_dist_nd_kde_gauss_set_dim (NcmStatsDistNd *dnd, const guint dim)
   ncm_matrix_clear (&self->cov_decomp);
   ncm_matrix_clear (&self->log_cov);
   ncm_matrix_clear (&self->sample_matrix);
+  ncm_vector_clear (&self->sample_norm2);
+  ncm_vector_clear (&self->sample_center);
   ncm_vector_clear (&self->v);
 
   self->sample     = ncm_stats_vec_new (dim, NCM_STATS_VEC_COV, TRUE);
@@ -313,32 +404,217 @@ _ncm_stats_dist_nd_kde_gauss_set_dim (NcmStatsDistNd *dnd, const guint dim)
   self->v          = ncm_vector_new (dim);
 }
 
+/* 
+ * k-d tree over the whitened sample (rows of sample_matrix), used to
+ * skip the kernels farther than cut_off * href from the evaluation point.
+ */
+
+static void
+_ncm_stats_dist_nd_kde_gauss_kd_select (NcmStatsDistNdKDEGaussPrivate * const self, guint lo, guint hi, const guint kth, const guint dim)
+{
+  guint *perm = &g_array_index (self->kd_perm, guint, 0);
+
+  /* Quickselect on perm[lo, hi) such that perm[kth] holds the kth element along dim. */
+  while (hi - lo > 1)
+  {
+    const gdouble pivot = ncm_matrix_get (self->sample_matrix, perm[(lo + hi) / 2], dim);
+    guint i = lo;
+    guint j = hi - 1;
+
+    while (i <= j)
+    {
+      while (ncm_matrix_get (self->sample_matrix, perm[i], dim) < pivot)
+        i++;
+      while (ncm_matrix_get (self->sample_matrix, perm[j], dim) > pivot)
+        j--;
+      if (i <= j)
+      {
+        const guint tmp = perm[i];
+        perm[i] = perm[j];
+        perm[j] = tmp;
+        i++;
+        if (j == 0)
+          break;
+        j--;
+      }
+    }
+
+    if (kth <= j)
+      hi = j + 1;
+    else if (kth >= i)
+      lo = i;
+    else
+      break;
+  }
+}
+
+static guint
+_ncm_stats_dist_nd_kde_gauss_kd_build (NcmStatsDistNdKDEGaussPrivate * const self, const guint lo, const guint hi)
+{
+  NcmStatsDistNdKDEGaussKDNode node = {lo, hi, 0, 0};
+  const guint node_id = self->kd_nodes->len;
+  gdouble *bbox;
+  guint i, k;
+
+  g_array_append_val (self->kd_nodes, node);
+  g_array_set_size (self->kd_bbox, self->kd_bbox->len + 2 * self->d);
+  bbox = &g_array_index (self->kd_bbox, gdouble, 2 * self->d * node_id);
+
+  for (k = 0; k < self->d; k++)
+  {
+    bbox[k]           = GSL_POSINF;
+    bbox[self->d + k] = GSL_NEGINF;
+  }
+
+  for (i = lo; i < hi; i++)
+  {
+    const gdouble *row_i = ncm_matrix_ptr (self->sample_matrix, g_array_index (self->kd_perm, guint, i), 0);
+    for (k = 0; k < self->d; k++)
+    {
+      bbox[k]           = MIN (bbox[k], row_i[k]);
+      bbox[self->d + k] = MAX (bbox[self->d + k], row_i[k]);
+    }
+  }
+
+  if (hi - lo > NCM_STATS_DIST_ND_KDE_GAUSS_KD_LEAF_SIZE)
+  {
+    const guint mid = (lo + hi) / 2;
+    gdouble max_spread = -1.0;
+    guint split_dim    = 0;
+    guint left, right;
+
+    for (k = 0; k < self->d; k++)
+    {
+      const gdouble spread = bbox[self->d + k] - bbox[k];
+      if (spread > max_spread)
+      {
+        max_spread = spread;
+        split_dim  = k;
+      }
+    }
+
+    _ncm_stats_dist_nd_kde_gauss_kd_select (self, lo, hi, mid, split_dim);
+
+    left  = _ncm_stats_dist_nd_kde_gauss_kd_build (self, lo, mid);
+    right = _ncm_stats_dist_nd_kde_gauss_kd_build (self, mid, hi);
+
+    /* kd_nodes may have been reallocated, access it again. */
+    g_array_index (self->kd_nodes, NcmStatsDistNdKDEGaussKDNode, node_id).left  = left;
+    g_array_index (self->kd_nodes, NcmStatsDistNdKDEGaussKDNode, node_id).right = right;
+  }
+
+  return node_id;
+}
+
+static void
+_ncm_stats_dist_nd_kde_gauss_kd_prepare (NcmStatsDistNdKDEGaussPrivate * const self)
+{
+  guint i;
+
+  g_array_set_size (self->kd_nodes, 0);
+  g_array_set_size (self->kd_bbox, 0);
+
+  if (self->cut_off <= 0.0)
+    return;
+
+  g_array_set_size (self->kd_perm, self->n);
+  for (i = 0; i < self->n; i++)
+    g_array_index (self->kd_perm, guint, i) = i;
+
+  _ncm_stats_dist_nd_kde_gauss_kd_build (self, 0, self->n);
+}
+
+static gboolean
+_ncm_stats_dist_nd_kde_gauss_kd_enabled (NcmStatsDistNdKDEGaussPrivate * const self)
+{
+  return (self->cut_off > 0.0) && (self->kd_nodes->len > 0);
+}
+
+/*
+ * Fills scratch->nb_index and scratch->nb_dist2 with the indexes and squared
+ * distances of all sample points within a distance sqrt (R2) from v.
+ */
+static void
+_ncm_stats_dist_nd_kde_gauss_kd_query (NcmStatsDistNdKDEGaussPrivate * const self, NcmStatsDistNdKDEGaussKDScratch *scratch, const gdouble *v, const gdouble R2)
+{
+  guint sp = 0;
+
+  g_array_set_size (scratch->nb_index, 0);
+  g_array_set_size (scratch->nb_dist2, 0);
+  g_array_set_size (scratch->stack, MAX (scratch->stack->len, 64));
+  g_array_index (scratch->stack, guint, sp++) = 0;
+
+  while (sp > 0)
+  {
+    const guint node_id                       = g_array_index (scratch->stack, guint, --sp);
+    const NcmStatsDistNdKDEGaussKDNode *node  = &g_array_index (self->kd_nodes, NcmStatsDistNdKDEGaussKDNode, node_id);
+    const gdouble *bbox                       = &g_array_index (self->kd_bbox, gdouble, 2 * self->d * node_id);
+    gdouble bdist2                            = 0.0;
+    guint k;
+
+    for (k = 0; k < self->d; k++)
+    {
+      if (v[k] < bbox[k])
+        bdist2 += gsl_pow_2 (bbox[k] - v[k]);
+      else if (v[k] > bbox[self->d + k])
+        bdist2 += gsl_pow_2 (v[k] - bbox[self->d + k]);
+    }
+
+    if (bdist2 > R2)
+      continue;
+
+    if (node->left == 0)
+    {
+      guint i;
+      for (i = node->lo; i < node->hi; i++)
+      {
+        const guint p        = g_array_index (self->kd_perm, guint, i);
+        const gdouble *row_p = ncm_matrix_ptr (self->sample_matrix, p, 0);
+        gdouble dist2        = 0.0;
+
+        for (k = 0; k < self->d; k++)
+          dist2 += gsl_pow_2 (row_p[k] - v[k]);
+
+        if (dist2 <= R2)
+        {
+          g_array_append_val (scratch->nb_index, p);
+          g_array_append_val (scratch->nb_dist2, dist2);
+        }
+      }
+    }
+    else
+    {
+      if (sp + 2 > scratch->stack->len)
+        g_array_set_size (scratch->stack, 2 * scratch->stack->len);
+      g_array_index (scratch->stack, guint, sp++) = node->right;
+      g_array_index (scratch->stack, guint, sp++) = node->left;
+    }
+  }
+}
+
 static void 
 _ncm_stats_dist_nd_kde_gauss_prepare_cov (NcmStatsDistNdKDEGaussPrivate * const self)
 {
   gint i, ret;
 
+  /* 
+   * The whitened sample is kept in a single contiguous row-major block 
+   * (tda == d), the kernel loops below access it through raw row pointers.
+   */
   if (self->sample_matrix == NULL)
   {
     self->sample_matrix = ncm_matrix_new (self->n, self->d);
-    g_ptr_array_set_size (self->smatrix_rows, 0);    
-    for (i = 0; i < self->n; i++)
-    {
-      NcmVector *row_i = ncm_matrix_get_row (self->sample_matrix, i);
-      g_ptr_array_add (self->smatrix_rows, row_i);
-    }
+    self->sample_norm2  = ncm_vector_new (self->n);
+    self->sample_center = ncm_vector_new (self->d);
   }
   else if ((self->n != ncm_matrix_nrows (self->sample_matrix)) || (self->d != ncm_matrix_ncols (self->sample_matrix)))
   {
     ncm_matrix_clear (&self->sample_matrix);
+    ncm_vector_clear (&self->sample_norm2);
+    ncm_vector_clear (&self->sample_center);
     self->sample_matrix = ncm_matrix_new (self->n, self->d);
-
-    g_ptr_array_set_size (self->smatrix_rows, 0);    
-    for (i = 0; i < self->n; i++)
-    {
-      NcmVector *row_i = ncm_matrix_get_row (self->sample_matrix, i);
-      g_ptr_array_add (self->smatrix_rows, row_i);
-    }
+    self->sample_norm2  = ncm_vector_new (self->n);
+    self->sample_center = ncm_vector_new (self->d);
   }
 
   for (i = 0; i < self->n; i++)
@@ -346,6 +622,40 @@ _ncm_stats_dist_nd_kde_gauss_prepare_cov (NcmStatsDistNdKDEGaussPrivate * const
 
   ret = gsl_blas_dtrsm (CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit, 1.0, ncm_matrix_gsl (self->cov_decomp), ncm_matrix_gsl (self->sample_matrix));
   NCM_TEST_GSL_RESULT ("_ncm_stats_dist_nd_kde_gauss_prepare", ret);  
+
+  /*
+   * The whitened sample is centered on its mean and every whitened query
+   * point is shifted by the same vector. The kernels depend only on
+   * differences, but the norm expansion used in the batch evaluation
+   * cancels catastrophically for points far from the origin.
+   */
+  ncm_vector_set_zero (self->sample_center);
+  for (i = 0; i < self->n; i++)
+  {
+    const gdouble *row_i = ncm_matrix_ptr (self->sample_matrix, i, 0);
+    gint k;
+
+    for (k = 0; k < self->d; k++)
+      ncm_vector_addto (self->sample_center, k, row_i[k]);
+  }
+  ncm_vector_scale (self->sample_center, 1.0 / self->n);
+
+  for (i = 0; i < self->n; i++)
+  {
+    gdouble *row_i  = ncm_matrix_ptr (self->sample_matrix, i, 0);
+    gdouble norm2_i = 0.0;
+    gint k;
+
+    for (k = 0; k < self->d; k++)
+    {
+      row_i[k] -= ncm_vector_get (self->sample_center, k);
+      norm2_i  += row_i[k] * row_i[k];
+    }
+
+    ncm_vector_set (self->sample_norm2, i, norm2_i);
+  }
+
+  _ncm_stats_dist_nd_kde_gauss_kd_prepare (self);
 }
 
 static void 
@@ -409,23 +719,49 @@ _ncm_stats_dist_nd_kde_gauss_prepare_IM (NcmStatsDistNdKDEGaussPrivate * const s
 {
   gint i;
 
+  if (_ncm_stats_dist_nd_kde_gauss_kd_enabled (self))
+  {
+    const gdouble R2                          = gsl_pow_2 (self->cut_off * self->href);
+    NcmStatsDistNdKDEGaussKDScratch **scratch = ncm_memory_pool_get (self->kd_scratch);
+
+    ncm_matrix_set_zero (self->IM);
+    for (i = 0; i < self->n; i++)
+    {
+      guint l;
+
+      _ncm_stats_dist_nd_kde_gauss_kd_query (self, *scratch, ncm_matrix_ptr (self->sample_matrix, i, 0), R2);
+
+      for (l = 0; l < (*scratch)->nb_index->len; l++)
+      {
+        const guint j = g_array_index ((*scratch)->nb_index, guint, l);
+        ncm_matrix_set (self->IM, i, j, exp (- 0.5 * g_array_index ((*scratch)->nb_dist2, gdouble, l) / self->href2));
+      }
+
+      ncm_matrix_set (self->IM, i, i, 1.0);
+    }
+
+    ncm_memory_pool_return (scratch);
+    return;
+  }
+
   for (i = 0; i < self->n; i++)
   {
-    NcmVector *row_i = g_ptr_array_index (self->smatrix_rows, i);
+    const gdouble *row_i = ncm_matrix_ptr (self->sample_matrix, i, 0);
     gint j;
 
     ncm_matrix_set (self->IM, i, i, 1.0);
 
     for (j = i + 1; j < self->n; j++)
     {
-      NcmVector *row_j = g_ptr_array_index (self->smatrix_rows, j);
+      const gdouble *row_j = ncm_matrix_ptr (self->sample_matrix, j, 0);
       gdouble m2lnp_ij = 0.0;
       gdouble p_ij;
       gint k;
 
       for (k = 0; k < self->d; k++)
       {
-        m2lnp_ij += gsl_pow_2 (ncm_vector_fast_get (row_i, k) - ncm_vector_fast_get (row_j, k));
+        const gdouble diff_k = row_i[k] - row_j[k];
+        m2lnp_ij += diff_k * diff_k;
       }
 
       p_ij = exp (- 0.5 * m2lnp_ij / self->href2);
@@ -952,36 +1288,83 @@ _ncm_stats_dist_nd_kde_gauss_prepare_interp (NcmStatsDistNd *dnd, NcmVector *m2l
   ncm_vector_scale (self->weights, 1.0 / ncm_vector_sum_cpts (self->weights));
 }
 
-static gdouble 
-_ncm_stats_dist_nd_kde_gauss_eval (NcmStatsDistNd *dnd, NcmVector *y)
+static gdouble
+_ncm_stats_dist_nd_kde_gauss_kernel_sum (NcmStatsDistNdKDEGaussPrivate * const self, NcmVector *y)
 {
-  NcmStatsDistNdKDEGauss *dndg = NCM_STATS_DIST_ND_KDE_GAUSS (dnd);
-  NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
+  NcmStatsDistNdKDEGaussKDScratch **scratch = ncm_memory_pool_get (self->kd_scratch);
   gdouble s = 0.0;
   gdouble c = 0.0;
+  gdouble *v;
   gint i, ret;
 
-  ncm_vector_memcpy (self->v, y);
-  ret = gsl_blas_dtrsv (CblasUpper, CblasTrans, CblasNonUnit,
-                        ncm_matrix_gsl (self->cov_decomp), ncm_vector_gsl (self->v));
-  NCM_TEST_GSL_RESULT ("_ncm_stats_dist_nd_kde_gauss_eval", ret);
-  
-  for (i = 0; i < self->n; i++)
+  g_array_set_size ((*scratch)->v, self->d);
+  v = (gdouble *) (*scratch)->v->data;
+
+  for (i = 0; i < self->d; i++)
+    v[i] = ncm_vector_get (y, i);
+
   {
-    NcmVector *row_i = g_ptr_array_index (self->smatrix_rows, i);
-    gdouble e_i, t, m2lnp_i = 0.0;
-    gint k;
+    gsl_vector_view v_view = gsl_vector_view_array (v, self->d);
+    ret = gsl_blas_dtrsv (CblasUpper, CblasTrans, CblasNonUnit,
+                          ncm_matrix_gsl (self->cov_decomp), &v_view.vector);
+    NCM_TEST_GSL_RESULT ("_ncm_stats_dist_nd_kde_gauss_kernel_sum", ret);
+  }
 
-    for (k = 0; k < self->d; k++)
+  for (i = 0; i < self->d; i++)
+    v[i] -= ncm_vector_get (self->sample_center, i);
+
+  if (_ncm_stats_dist_nd_kde_gauss_kd_enabled (self))
+  {
+    guint l;
+
+    _ncm_stats_dist_nd_kde_gauss_kd_query (self, *scratch, v, gsl_pow_2 (self->cut_off * self->href));
+
+    for (l = 0; l < (*scratch)->nb_index->len; l++)
     {
-      m2lnp_i += gsl_pow_2 (ncm_vector_fast_get (row_i, k) - ncm_vector_fast_get (self->v, k));
+      const guint j   = g_array_index ((*scratch)->nb_index, guint, l);
+      const gdouble e = ncm_vector_get (self->weights, j) * exp (- 0.5 * g_array_index ((*scratch)->nb_dist2, gdouble, l) / self->href2);
+      const gdouble t = s + e;
+      c += (s >= e) ? ((s - t) + e) : ((e - t) + s);
+      s  = t;
     }
 
-    e_i  = ncm_vector_get (self->weights, i) * exp (- 0.5 * m2lnp_i / self->href2);
-    t    = s + e_i;
-    c   += (s >= e_i) ? ((s - t) + e_i) : ((e_i - t) + s);
-    s    = t;
+    ncm_memory_pool_return (scratch);
+    return s;
   }
+  
+  {
+    const gdouble *w = ncm_vector_data (self->weights);
+
+    for (i = 0; i < self->n; i++)
+    {
+      const gdouble *row_i = ncm_matrix_ptr (self->sample_matrix, i, 0);
+      gdouble e_i, t, m2lnp_i = 0.0;
+      gint k;
+
+      for (k = 0; k < self->d; k++)
+      {
+        const gdouble diff_k = row_i[k] - v[k];
+        m2lnp_i += diff_k * diff_k;
+      }
+
+      e_i  = w[i] * exp (- 0.5 * m2lnp_i / self->href2);
+      t    = s + e_i;
+      c   += (s >= e_i) ? ((s - t) + e_i) : ((e_i - t) + s);
+      s    = t;
+    }
+  }
+
+  ncm_memory_pool_return (scratch);
+
+  return s;
+}
+
+static gdouble 
+_ncm_stats_dist_nd_kde_gauss_eval (NcmStatsDistNd *dnd, NcmVector *y)
+{
+  NcmStatsDistNdKDEGauss *dndg = NCM_STATS_DIST_ND_KDE_GAUSS (dnd);
+  NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
+  const gdouble s = _ncm_stats_dist_nd_kde_gauss_kernel_sum (self, y);
 
   return s * exp (- self->lnnorm);
 }
@@ -991,34 +1374,93 @@ _ncm_stats_dist_nd_kde_gauss_eval_m2lnp (NcmStatsDistNd *dnd, NcmVector *y)
 {
   NcmStatsDistNdKDEGauss *dndg = NCM_STATS_DIST_ND_KDE_GAUSS (dnd);
   NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
-  gdouble s = 0.0;
-  gdouble c = 0.0;
-  gint i, ret;
+  const gdouble s = _ncm_stats_dist_nd_kde_gauss_kernel_sum (self, y);
 
-  ncm_vector_memcpy (self->v, y);
-  ret = gsl_blas_dtrsv (CblasUpper, CblasTrans, CblasNonUnit,
-                        ncm_matrix_gsl (self->cov_decomp), ncm_vector_gsl (self->v));
-  NCM_TEST_GSL_RESULT ("_ncm_stats_dist_nd_kde_gauss_eval_m2lnp", ret);
+  return -2.0 * (log (s) - self->lnnorm);
+}
 
-  for (i = 0; i < self->n; i++)
+static void 
+_ncm_stats_dist_nd_kde_gauss_eval_batch (NcmStatsDistNd *dnd, NcmMatrix *x, NcmVector *res)
+{
+  NcmStatsDistNdKDEGauss *dndg = NCM_STATS_DIST_ND_KDE_GAUSS (dnd);
+  NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
+  const guint m       = ncm_matrix_nrows (x);
+  const gdouble norm  = exp (- self->lnnorm);
+  const gdouble *w    = ncm_vector_data (self->weights);
+  const gdouble *sn2  = ncm_vector_data (self->sample_norm2);
+  NcmMatrix *V, *G;
+  guint b;
+  gint ret;
+
+  if (_ncm_stats_dist_nd_kde_gauss_kd_enabled (self) || (m == 0))
   {
-    NcmVector *row_i = g_ptr_array_index (self->smatrix_rows, i);
-    gdouble e_i, t, m2lnp_i = 0.0;
+    guint i;
+    for (i = 0; i < m; i++)
+    {
+      NcmVector *x_i = ncm_matrix_get_row (x, i);
+      ncm_vector_set (res, i, _ncm_stats_dist_nd_kde_gauss_kernel_sum (self, x_i) * norm);
+      ncm_vector_free (x_i);
+    }
+    return;
+  }
+
+  /*
+   * Whiten all query points at once, V = X U^{-1}, and compute the 
+   * squared distances in blocks of queries using the expansion
+   * |v_i - s_j|^2 = |v_i|^2 + |s_j|^2 - 2 v_i.s_j, where the cross 
+   * terms G = V_b S^T are obtained through a single dgemm per block.
+   * Both V and S are centered on the whitened sample mean.
+   */
+  V = ncm_matrix_dup (x);
+  ret = gsl_blas_dtrsm (CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit, 1.0, ncm_matrix_gsl (self->cov_decomp), ncm_matrix_gsl (V));
+  NCM_TEST_GSL_RESULT ("_ncm_stats_dist_nd_kde_gauss_eval_batch", ret);
+
+  for (b = 0; b < m; b++)
+  {
+    gdouble *v_b = ncm_matrix_ptr (V, b, 0);
     gint k;
 
     for (k = 0; k < self->d; k++)
+      v_b[k] -= ncm_vector_get (self->sample_center, k);
+  }
+
+  G = ncm_matrix_new (MIN (NCM_STATS_DIST_ND_KDE_GAUSS_BATCH_BLOCK, m), self->n);
+
+  for (b = 0; b < m; b += NCM_STATS_DIST_ND_KDE_GAUSS_BATCH_BLOCK)
+  {
+    const guint mb  = MIN (NCM_STATS_DIST_ND_KDE_GAUSS_BATCH_BLOCK, m - b);
+    NcmMatrix *V_b  = ncm_matrix_get_submatrix (V, b, 0, mb, self->d);
+    NcmMatrix *G_b  = ncm_matrix_get_submatrix (G, 0, 0, mb, self->n);
+    guint i;
+
+    ncm_matrix_dgemm (G_b, 'N', 'T', 1.0, V_b, self->sample_matrix, 0.0);
+
+    for (i = 0; i < mb; i++)
     {
-      m2lnp_i += gsl_pow_2 (ncm_vector_fast_get (row_i, k) - ncm_vector_fast_get (self->v, k));
+      const gdouble *v_i = ncm_matrix_ptr (V, b + i, 0);
+      const gdouble *g_i = ncm_matrix_ptr (G, i, 0);
+      gdouble vn2_i      = 0.0;
+      gdouble s          = 0.0;
+      gint j, k;
+
+      for (k = 0; k < self->d; k++)
+        vn2_i += v_i[k] * v_i[k];
+
+      for (j = 0; j < self->n; j++)
+      {
+        const gdouble dist2_ij = MAX (vn2_i + sn2[j] - 2.0 * g_i[j], 0.0);
+        s += w[j] * exp (- 0.5 * dist2_ij / self->href2);
+      }
+
+      ncm_vector_set (res, b + i, s * norm);
     }
 
-    e_i  = ncm_vector_get (self->weights, i) * exp (- 0.5 * m2lnp_i / self->href2);
-    t    = s + e_i;
-    c   += (s >= e_i) ? ((s - t) + e_i) : ((e_i - t) + s);
-    s    = t;
-    /*printf ("% 22.15g % 22.15g % 22.15g\n", e_i, s, self->lnnorm);*/
+    ncm_matrix_free (V_b);
+    ncm_matrix_free (G_b);
   }
 
-  return -2.0 * (log (s) - self->lnnorm);
+  ncm_matrix_free (V);
+  ncm_matrix_free (G);
 }
 
 static void 
@@ -1241,3 +1683,45 @@ ncm_stats_dist_nd_kde_gauss_add_obs (NcmStatsDistNdKDEGauss *dndg, NcmVector *y)
   ncm_stats_dist_nd_kde_gauss_add_obs_weight (dndg, y, 1.0);
 }
 
+/**
+ * ncm_stats_dist_nd_kde_gauss_set_cut_off:
+ * @dndg: a #NcmStatsDistNdKDEGauss
+ * @cut_off: the kernel truncation radius in units of the bandwidth
+ *
+ * Sets the kernel truncation radius to @cut_off times the bandwidth $h$.
+ * When @cut_off is positive, the whitened sample is indexed by a k-d tree
+ * during the preparation and the evaluations (including the interpolation
+ * matrix) only consider the kernels centered within a distance 
+ * $r_c = \mathrm{cut\_off}\,h$ of the evaluation point. Each skipped kernel 
+ * contributes less than $w_i e^{-\mathrm{cut\_off}^2/2}$ to the unnormalized 
+ * sum, therefore the absolute error in the density is bounded by
+ * $e^{-\mathrm{cut\_off}^2/2}\sum_iw_i/\mathcal{N}$, where $\mathcal{N}$ is
+ * the kernel normalization. For example, @cut_off $= 8.5$ gives a bound 
+ * below $10^{-15}$ relative to the density peak. Points farther than $r_c$
+ * from all sample points have zero density.
+ *
+ * A value of zero (default) disables the truncation. The new value is
+ * used after the next call to ncm_stats_dist_nd_prepare() or
+ * ncm_stats_dist_nd_prepare_interp().
+ * 
+ */
+void 
+ncm_stats_dist_nd_kde_gauss_set_cut_off (NcmStatsDistNdKDEGauss *dndg, const gdouble cut_off)
+{
+  NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
+  g_assert_cmpfloat (cut_off, >=, 0.0);
+  self->cut_off = cut_off;
+}
+
+/**
+ * ncm_stats_dist_nd_kde_gauss_get_cut_off:
+ * @dndg: a #NcmStatsDistNdKDEGauss
+ *
+ * Returns: the kernel truncation radius in units of the bandwidth.
+ */
+gdouble 
+ncm_stats_dist_nd_kde_gauss_get_cut_off (NcmStatsDistNdKDEGauss *dndg)
+{
+  NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
+  return self->cut_off;
+}
@@ -73,6 +73,9 @@ gdouble ncm_stats_dist_nd_kde_gauss_get_over_smooth (NcmStatsDistNdKDEGauss *dnd
 void ncm_stats_dist_nd_kde_gauss_set_LOOCV_bandwidth_adj (NcmStatsDistNdKDEGauss *dndg, gboolean LOOCV);
 gboolean ncm_stats_dist_nd_kde_gauss_get_LOOCV_bandwidth_adj (NcmStatsDistNdKDEGauss *dndg);
 
+void ncm_stats_dist_nd_kde_gauss_set_cut_off (NcmStatsDistNdKDEGauss *dndg, const gdouble cut_off);
+gdouble ncm_stats_dist_nd_kde_gauss_get_cut_off (NcmStatsDistNdKDEGauss *dndg);
+
 void ncm_stats_dist_nd_kde_gauss_add_obs_weight (NcmStatsDistNdKDEGauss *dndg, NcmVector *y, const gdouble w);
 void ncm_stats_dist_nd_kde_gauss_add_obs (NcmStatsDistNdKDEGauss *dndg, NcmVector *y);
 
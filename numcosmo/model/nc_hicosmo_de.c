@@ -200,6 +200,8 @@ _nc_hicosmo_de_finalize (GObject *object)
 
 static gdouble _nc_hicosmo_de_E2 (NcHICosmo *cosmo, gdouble z);
 static gdouble _nc_hicosmo_de_dE2_dz (NcHICosmo *cosmo, gdouble z);
+static void _nc_hicosmo_de_E2_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *E2, const guint len);
+static void _nc_hicosmo_de_dE2_dz_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *dE2_dz, const guint len);
 static gdouble _nc_hicosmo_de_d2E2_dz2 (NcHICosmo *cosmo, gdouble z);
 static gdouble _nc_hicosmo_de_H0 (NcHICosmo *cosmo);
 static gdouble _nc_hicosmo_de_Omega_t0 (NcHICosmo *cosmo);
@@ -234,6 +236,8 @@ static gdouble _nc_hicosmo_de_E2Omega_de (NcHICosmoDE *cosmo_de, gdouble z);
 static gdouble _nc_hicosmo_de_dE2Omega_de_dz (NcHICosmoDE *cosmo_de, gdouble z);
 static gdouble _nc_hicosmo_de_d2E2Omega_de_dz2 (NcHICosmoDE *cosmo_de, gdouble z);
 static gdouble _nc_hicosmo_de_w_de (NcHICosmoDE *cosmo_de, gdouble z);
+static void _nc_hicosmo_de_E2Omega_de_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len);
+static void _nc_hicosmo_de_dE2Omega_de_dz_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len);
 
 static void
 nc_hicosmo_de_class_init (NcHICosmoDEClass *klass)
@@ -321,6 +325,7 @@ nc_hicosmo_de_class_init (NcHICosmoDEClass *klass)
 
   nc_hicosmo_set_H0_impl         (parent_class, &_nc_hicosmo_de_H0);
   nc_hicosmo_set_E2_impl         (parent_class, &_nc_hicosmo_de_E2);
+  nc_hicosmo_set_E2_vec_impl     (parent_class, &_nc_hicosmo_de_E2_vec);
   nc_hicosmo_set_Omega_c0_impl   (parent_class, &_nc_hicosmo_de_Omega_c0);
   nc_hicosmo_set_Omega_b0_impl   (parent_class, &_nc_hicosmo_de_Omega_b0);
   nc_hicosmo_set_Omega_g0_impl   (parent_class, &_nc_hicosmo_de_Omega_g0);
@@ -331,6 +336,7 @@ nc_hicosmo_de_class_init (NcHICosmoDEClass *klass)
   nc_hicosmo_set_T_gamma0_impl   (parent_class, &_nc_hicosmo_de_T_gamma0);
   nc_hicosmo_set_Yp_4He_impl     (parent_class, &_nc_hicosmo_de_Yp_4He);
   nc_hicosmo_set_dE2_dz_impl     (parent_class, &_nc_hicosmo_de_dE2_dz);
+  nc_hicosmo_set_dE2_dz_vec_impl (parent_class, &_nc_hicosmo_de_dE2_dz_vec);
   nc_hicosmo_set_d2E2_dz2_impl   (parent_class, &_nc_hicosmo_de_d2E2_dz2);
   nc_hicosmo_set_bgp_cs2_impl    (parent_class, &_nc_hicosmo_de_bgp_cs2);
 
@@ -357,6 +363,9 @@ nc_hicosmo_de_class_init (NcHICosmoDEClass *klass)
   klass->dE2Omega_de_dz   = &_nc_hicosmo_de_dE2Omega_de_dz;
   klass->d2E2Omega_de_dz2 = &_nc_hicosmo_de_d2E2Omega_de_dz2;
   klass->w_de             = &_nc_hicosmo_de_w_de;
+
+  klass->E2Omega_de_vec     = &_nc_hicosmo_de_E2Omega_de_vec;
+  klass->dE2Omega_de_dz_vec = &_nc_hicosmo_de_dE2Omega_de_dz_vec;
 }
 
 static gdouble _nc_hicosmo_de_Omega_mnu0_n (NcHICosmo *cosmo, const guint n);
@@ -498,6 +507,69 @@ _nc_hicosmo_de_dE2_dz (NcHICosmo *cosmo, gdouble z)
     + dE2Omega_mnu_dz;
 }
 
+/****************************************************************************
+ * Array versions: the DE component is filled by the subclass array method,
+ * the polynomial part is added in a single tight loop and the massive
+ * neutrinos, when present, through their splines.
+ ****************************************************************************/
+
+static void
+_nc_hicosmo_de_E2_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *E2, const guint len)
+{
+  NcHICosmoDE *cosmo_de = NC_HICOSMO_DE (cosmo);
+  const guint nmassnu   = ncm_model_vparam_len (NCM_MODEL (cosmo), NC_HICOSMO_DE_MASSNU_M);
+  const gdouble Omega_k = OMEGA_K;
+  const gdouble Omega_r = OMEGA_R;
+  const gdouble Omega_m = OMEGA_M;
+  guint i;
+
+  NC_HICOSMO_DE_GET_CLASS (cosmo_de)->E2Omega_de_vec (cosmo_de, z, E2, len);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x  = 1.0 + z[i];
+    const gdouble x2 = x * x;
+    const gdouble x3 = x2 * x;
+    const gdouble x4 = x3 * x;
+
+    E2[i] += Omega_r * x4 + Omega_m * x3 + Omega_k * x2;
+  }
+
+  if (nmassnu > 0)
+  {
+    for (i = 0; i < len; i++)
+      E2[i] += _nc_hicosmo_de_E2Omega_mnu (cosmo, z[i]);
+  }
+}
+
+static void
+_nc_hicosmo_de_dE2_dz_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *dE2_dz, const guint len)
+{
+  NcHICosmoDE *cosmo_de = NC_HICOSMO_DE (cosmo);
+  const guint nmassnu   = ncm_model_vparam_len (NCM_MODEL (cosmo), NC_HICOSMO_DE_MASSNU_M);
+  const gdouble Omega_k = OMEGA_K;
+  const gdouble Omega_r = OMEGA_R;
+  const gdouble Omega_m = OMEGA_M;
+  guint i;
+
+  NC_HICOSMO_DE_GET_CLASS (cosmo_de)->dE2Omega_de_dz_vec (cosmo_de, z, dE2_dz, len);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x  = 1.0 + z[i];
+    const gdouble x2 = x * x;
+    const gdouble x3 = x2 * x;
+
+    dE2_dz[i] += 4.0 * Omega_r * x3 + 3.0 * Omega_m * x2 + 2.0 * Omega_k * x;
+  }
+
+  if (nmassnu > 0)
+  {
+    for (i = 0; i < len; i++)
+      dE2_dz[i] += 3.0 * (_nc_hicosmo_de_E2Omega_mnu (cosmo, z[i]) + _nc_hicosmo_de_E2Press_mnu (cosmo, z[i])) / (1.0 + z[i]);
+  }
+}
+
 /****************************************************************************
  * d2E2_dz2
  ****************************************************************************/
@@ -934,6 +1006,26 @@ _nc_hicosmo_de_w_de (NcHICosmoDE *cosmo_de, gdouble z)
   return 0.0;
 }
 
+static void
+_nc_hicosmo_de_E2Omega_de_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len)
+{
+  NcHICosmoDEFunc1 E2Omega_de = NC_HICOSMO_DE_GET_CLASS (cosmo_de)->E2Omega_de;
+  guint i;
+
+  for (i = 0; i < len; i++)
+    f[i] = E2Omega_de (cosmo_de, z[i]);
+}
+
+static void
+_nc_hicosmo_de_dE2Omega_de_dz_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len)
+{
+  NcHICosmoDEFunc1 dE2Omega_de_dz = NC_HICOSMO_DE_GET_CLASS (cosmo_de)->dE2Omega_de_dz;
+  guint i;
+
+  for (i = 0; i < len; i++)
+    f[i] = dE2Omega_de_dz (cosmo_de, z[i]);
+}
+
 #define NC_HICOSMO_DE_SET_IMPL_FUNC(name)                                                                    \
 	void                                                                                                       \
 	nc_hicosmo_de_set_##name##_impl (NcHICosmoDEClass *cosmo_de_class, NcmFuncF f, NcmFuncPF pf, NcmFuncDF df) \
@@ -951,19 +1043,35 @@ _nc_hicosmo_de_w_de (NcHICosmoDE *cosmo_de, gdouble z)
  * @cosmo_de_class: FIXME
  * @f: FIXME
  *
- * FIXME
+ * FIXME. This also resets the array version to the default loop over @f,
+ * see nc_hicosmo_de_set_E2Omega_de_vec_impl().
  *
  */
-NCM_MODEL_SET_IMPL_FUNC (NC_HICOSMO_DE, NcHICosmoDE, nc_hicosmo_de, NcHICosmoDEFunc1, E2Omega_de)
+void
+nc_hicosmo_de_set_E2Omega_de_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1 f)
+{
+  ncm_model_class_add_impl_opts (NCM_MODEL_CLASS (cosmo_de_class), NC_HICOSMO_DE_IMPL_E2Omega_de, -1);
+  cosmo_de_class->E2Omega_de     = f;
+  cosmo_de_class->E2Omega_de_vec = &_nc_hicosmo_de_E2Omega_de_vec;
+}
+
 /**
  * nc_hicosmo_de_set_dE2Omega_de_dz_impl: (skip)
  * @cosmo_de_class: FIXME
  * @f: FIXME
  *
- * FIXME
+ * FIXME. This also resets the array version to the default loop over @f,
+ * see nc_hicosmo_de_set_dE2Omega_de_dz_vec_impl().
  *
  */
-NCM_MODEL_SET_IMPL_FUNC (NC_HICOSMO_DE, NcHICosmoDE, nc_hicosmo_de, NcHICosmoDEFunc1, dE2Omega_de_dz)
+void
+nc_hicosmo_de_set_dE2Omega_de_dz_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1 f)
+{
+  ncm_model_class_add_impl_opts (NCM_MODEL_CLASS (cosmo_de_class), NC_HICOSMO_DE_IMPL_dE2Omega_de_dz, -1);
+  cosmo_de_class->dE2Omega_de_dz     = f;
+  cosmo_de_class->dE2Omega_de_dz_vec = &_nc_hicosmo_de_dE2Omega_de_dz_vec;
+}
+
 /**
  * nc_hicosmo_de_set_d2E2Omega_de_dz2_impl: (skip)
  * @cosmo_de_class: FIXME
@@ -982,6 +1090,38 @@ NCM_MODEL_SET_IMPL_FUNC (NC_HICOSMO_DE, NcHICosmoDE, nc_hicosmo_de, NcHICosmoDEF
  *
  */
 NCM_MODEL_SET_IMPL_FUNC (NC_HICOSMO_DE, NcHICosmoDE, nc_hicosmo_de, NcHICosmoDEFunc1, w_de)
+
+/**
+ * nc_hicosmo_de_set_E2Omega_de_vec_impl: (skip)
+ * @cosmo_de_class: a #NcHICosmoDEClass
+ * @f: a #NcHICosmoDEFunc1Vec
+ *
+ * Sets the array version of the DE component $E^2\Omega_\mathrm{de}(z)$,
+ * it must be called after nc_hicosmo_de_set_E2Omega_de_impl().
+ *
+ */
+void
+nc_hicosmo_de_set_E2Omega_de_vec_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1Vec f)
+{
+  g_assert (f != NULL);
+  cosmo_de_class->E2Omega_de_vec = f;
+}
+
+/**
+ * nc_hicosmo_de_set_dE2Omega_de_dz_vec_impl: (skip)
+ * @cosmo_de_class: a #NcHICosmoDEClass
+ * @f: a #NcHICosmoDEFunc1Vec
+ *
+ * Sets the array version of the redshift derivative of the DE component,
+ * it must be called after nc_hicosmo_de_set_dE2Omega_de_dz_impl().
+ *
+ */
+void
+nc_hicosmo_de_set_dE2Omega_de_dz_vec_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1Vec f)
+{
+  g_assert (f != NULL);
+  cosmo_de_class->dE2Omega_de_dz_vec = f;
+}
 /**
  * nc_hicosmo_E2Omega_de:
  * @cosmo_de: a #NcHICosmoDE
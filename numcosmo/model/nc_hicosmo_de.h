@@ -67,6 +67,7 @@ typedef enum _NcHICosmoDEImpl
 } NcHICosmoDEImpl;
 
 typedef gdouble (*NcHICosmoDEFunc1) (NcHICosmoDE *cosmo_de, gdouble z);
+typedef void (*NcHICosmoDEFunc1Vec) (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len);
 
 /**
  * NcHICosmoDEParams:
@@ -134,6 +135,8 @@ struct _NcHICosmoDEClass
   NcHICosmoDEFunc1 dE2Omega_de_dz;
   NcHICosmoDEFunc1 d2E2Omega_de_dz2;
   NcHICosmoDEFunc1 w_de;
+  NcHICosmoDEFunc1Vec E2Omega_de_vec;
+  NcHICosmoDEFunc1Vec dE2Omega_de_dz_vec;
 };
 
 struct _NcHICosmoDE
@@ -154,6 +157,8 @@ void nc_hicosmo_de_set_E2Omega_de_impl (NcHICosmoDEClass *cosmo_de_class, NcHICo
 void nc_hicosmo_de_set_dE2Omega_de_dz_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1 f);
 void nc_hicosmo_de_set_d2E2Omega_de_dz2_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1 f);
 void nc_hicosmo_de_set_w_de_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1 f);
+void nc_hicosmo_de_set_E2Omega_de_vec_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1Vec f);
+void nc_hicosmo_de_set_dE2Omega_de_dz_vec_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1Vec f);
 
 G_INLINE_FUNC gdouble nc_hicosmo_de_E2Omega_de (NcHICosmoDE *cosmo_de, gdouble z);
 G_INLINE_FUNC gdouble nc_hicosmo_de_dE2Omega_de_dz (NcHICosmoDE *cosmo_de, gdouble z);
@@ -98,6 +98,42 @@ _nc_hicosmo_de_cpl_w_de (NcHICosmoDE *cosmo_de, gdouble z)
   return w0 + w1 * z / (1.0 + z);
 }
 
+static void
+_nc_hicosmo_de_cpl_E2Omega_de_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len)
+{
+  const gdouble Omega_x = OMEGA_X;
+  const gdouble c1      = -3.0 * OMEGA_1;
+  const gdouble c2      = 3.0 * (1.0 + OMEGA_0 + OMEGA_1);
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x = 1.0 + z[i];
+
+    f[i] = Omega_x * exp (c1 * z[i] / x + c2 * log1p (z[i]));
+  }
+}
+
+static void
+_nc_hicosmo_de_cpl_dE2Omega_de_dz_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len)
+{
+  const gdouble Omega_x = OMEGA_X;
+  const gdouble w0      = OMEGA_0;
+  const gdouble w1      = OMEGA_1;
+  const gdouble c1      = -3.0 * w1;
+  const gdouble c2      = 3.0 * (1.0 + w0 + w1);
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x          = 1.0 + z[i];
+    const gdouble x2         = x * x;
+    const gdouble E2Omega_de = Omega_x * exp (c1 * z[i] / x + c2 * log1p (z[i]));
+
+    f[i] = 3.0 * ((x * (w0 + 1.0) + z[i] * w1) / x2) * E2Omega_de;
+  }
+}
+
 /**
  * nc_hicosmo_de_cpl_new:
  *
@@ -159,6 +195,9 @@ nc_hicosmo_de_cpl_class_init (NcHICosmoDECplClass *klass)
   nc_hicosmo_de_set_dE2Omega_de_dz_impl (parent_class,   &_nc_hicosmo_de_cpl_dE2Omega_de_dz);
   nc_hicosmo_de_set_d2E2Omega_de_dz2_impl (parent_class, &_nc_hicosmo_de_cpl_d2E2Omega_de_dz2);
   nc_hicosmo_de_set_w_de_impl (parent_class,             &_nc_hicosmo_de_cpl_w_de);
+
+  nc_hicosmo_de_set_E2Omega_de_vec_impl (parent_class,     &_nc_hicosmo_de_cpl_E2Omega_de_vec);
+  nc_hicosmo_de_set_dE2Omega_de_dz_vec_impl (parent_class, &_nc_hicosmo_de_cpl_dE2Omega_de_dz_vec);
 }
 
 #ifdef HAVE_CCL
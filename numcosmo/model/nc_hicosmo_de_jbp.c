@@ -72,6 +72,42 @@ _nc_hicosmo_de_jbp_w_de (NcHICosmoDE *cosmo_de, gdouble z)
   return w0 + w1 * z / gsl_pow_2 (1.0 + z);
 }
 
+static void
+_nc_hicosmo_de_jbp_E2Omega_de_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len)
+{
+  const gdouble Omega_x = OMEGA_X;
+  const gdouble c1      = 3.0 / 2.0 * OMEGA_1;
+  const gdouble c2      = 3.0 * (1.0 + OMEGA_0);
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble z_x = z[i] / (1.0 + z[i]);
+
+    f[i] = Omega_x * exp (c1 * z_x * z_x + c2 * log1p (z[i]));
+  }
+}
+
+static void
+_nc_hicosmo_de_jbp_dE2Omega_de_dz_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len)
+{
+  const gdouble Omega_x = OMEGA_X;
+  const gdouble w0      = OMEGA_0;
+  const gdouble w1      = OMEGA_1;
+  const gdouble c1      = 3.0 / 2.0 * w1;
+  const gdouble c2      = 3.0 * (1.0 + w0);
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x          = 1.0 + z[i];
+    const gdouble z_x        = z[i] / x;
+    const gdouble E2Omega_de = Omega_x * exp (c1 * z_x * z_x + c2 * log1p (z[i]));
+
+    f[i] = 3.0 * ((1.0 + w0) / x + z_x * w1 / (x * x)) * E2Omega_de;
+  }
+}
+
 /**
  * nc_hicosmo_de_jbp_new:
  *
@@ -117,6 +153,9 @@ nc_hicosmo_de_jbp_class_init (NcHICosmoDEJbpClass *klass)
   nc_hicosmo_de_set_E2Omega_de_impl (parent_class, &_nc_hicosmo_de_jbp_E2Omega_de);
   nc_hicosmo_de_set_dE2Omega_de_dz_impl (parent_class, &_nc_hicosmo_de_jbp_dE2Omega_de_dz);
   nc_hicosmo_de_set_w_de_impl (parent_class, &_nc_hicosmo_de_jbp_w_de);
+
+  nc_hicosmo_de_set_E2Omega_de_vec_impl (parent_class, &_nc_hicosmo_de_jbp_E2Omega_de_vec);
+  nc_hicosmo_de_set_dE2Omega_de_dz_vec_impl (parent_class, &_nc_hicosmo_de_jbp_dE2Omega_de_dz_vec);
   
   ncm_model_class_set_name_nick (model_class, "JBP parametrization", "JBP");
   ncm_model_class_add_params (model_class, 2, 0, PROP_SIZE);
@@ -70,6 +70,26 @@ _nc_hicosmo_lcdm_E2 (NcHICosmo *cosmo, gdouble z)
   return (OMEGA_R * x4 + OMEGA_M * x3 + omega_k * x2 + OMEGA_X);
 }
 
+static void
+_nc_hicosmo_lcdm_E2_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *E2, const guint len)
+{
+  const gdouble omega_r = OMEGA_R;
+  const gdouble omega_m = OMEGA_M;
+  const gdouble omega_x = OMEGA_X;
+  const gdouble omega_k = OMEGA_K;
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x  = 1.0 + z[i];
+    const gdouble x2 = x * x;
+    const gdouble x3 = x2 * x;
+    const gdouble x4 = x3 * x;
+
+    E2[i] = omega_r * x4 + omega_m * x3 + omega_k * x2 + omega_x;
+  }
+}
+
 /****************************************************************************
  * Normalized Hubble function redshift derivative
  ****************************************************************************/
@@ -87,6 +107,24 @@ _nc_hicosmo_lcdm_dE2_dz (NcHICosmo *cosmo, gdouble z)
   return poly;
 }
 
+static void
+_nc_hicosmo_lcdm_dE2_dz_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *dE2_dz, const guint len)
+{
+  const gdouble omega_r = OMEGA_R;
+  const gdouble omega_m = OMEGA_M;
+  const gdouble omega_k = OMEGA_K;
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x  = 1.0 + z[i];
+    const gdouble x2 = x * x;
+    const gdouble x3 = x2 * x;
+
+    dE2_dz[i] = 4.0 * omega_r * x3 + 3.0 * omega_m * x2 + 2.0 * omega_k * x;
+  }
+}
+
 static gdouble
 _nc_hicosmo_lcdm_d2E2_dz2 (NcHICosmo *cosmo, gdouble z)
 {
@@ -222,6 +260,7 @@ nc_hicosmo_lcdm_class_init (NcHICosmoLCDMClass *klass)
 
   nc_hicosmo_set_H0_impl        (parent_class, &_nc_hicosmo_lcdm_H0);
   nc_hicosmo_set_E2_impl        (parent_class, &_nc_hicosmo_lcdm_E2);
+  nc_hicosmo_set_E2_vec_impl    (parent_class, &_nc_hicosmo_lcdm_E2_vec);
   nc_hicosmo_set_Omega_c0_impl   (parent_class, &_nc_hicosmo_lcdm_Omega_c0);
   nc_hicosmo_set_Omega_r0_impl   (parent_class, &_nc_hicosmo_lcdm_Omega_r0);
   nc_hicosmo_set_Omega_b0_impl   (parent_class, &_nc_hicosmo_lcdm_Omega_b0);
@@ -232,6 +271,7 @@ nc_hicosmo_lcdm_class_init (NcHICosmoLCDMClass *klass)
   nc_hicosmo_set_Yp_4He_impl    (parent_class, &_nc_hicosmo_lcdm_Yp_4He);
 
   nc_hicosmo_set_dE2_dz_impl    (parent_class, &_nc_hicosmo_lcdm_dE2_dz);
+  nc_hicosmo_set_dE2_dz_vec_impl (parent_class, &_nc_hicosmo_lcdm_dE2_dz_vec);
   nc_hicosmo_set_d2E2_dz2_impl  (parent_class, &_nc_hicosmo_lcdm_d2E2_dz2);
 
   nc_hicosmo_set_bgp_cs2_impl   (parent_class, &_nc_hicosmo_lcdm_bgp_cs2);
@@ -78,7 +78,8 @@ enum
 	PROP_MATTER_PK_MAXZ,
 	PROP_MATTER_PK_MAXK,
   PROP_USE_PPF,
-  PROP_VERBOSE
+  PROP_VERBOSE,
+  PROP_COSMO_PARAM_DEPS
 };
 
 struct _NcCBEPrivate
@@ -476,6 +477,10 @@ _nc_cbe_set_property (GObject* object, guint prop_id, const GValue* value, GPara
 		cbe->lensing_verbose  = verbosity;
 		break;
   }
+  case PROP_COSMO_PARAM_DEPS:
+    if (g_value_get_variant (value) != NULL)
+      ncm_model_ctrl_set_param_deps (cbe->ctrl_cosmo, g_value_get_variant (value));
+    break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -529,6 +534,9 @@ _nc_cbe_get_property (GObject* object, guint prop_id, GValue* value, GParamSpec*
 	case PROP_VERBOSE:
 		g_value_set_uint (value, cbe->bg_verbose);
 		break;
+  case PROP_COSMO_PARAM_DEPS:
+    g_value_take_variant (value, ncm_model_ctrl_get_param_deps (cbe->ctrl_cosmo));
+    break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -674,6 +682,13 @@ nc_cbe_class_init (NcCBEClass* klass)
                                                       "Verbosity",
                                                       0, G_MAXUINT32, 0,
                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_COSMO_PARAM_DEPS,
+                                   g_param_spec_variant ("cosmo-param-deps",
+                                                         NULL,
+                                                         "Cosmological parameters dependencies",
+                                                         G_VARIANT_TYPE ("au"), NULL,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 /**
@@ -850,6 +865,35 @@ nc_cbe_set_thermodyn (NcCBE* cbe, gboolean use_thermodyn)
 	ncm_model_ctrl_force_update (cbe->ctrl_cosmo);
 }
 
+/**
+ * nc_cbe_add_cosmo_param_dep:
+ * @cbe: a #NcCBE
+ * @i: original parameter index
+ *
+ * Adds the @i-th original #NcHICosmo parameter to the dependencies of @cbe,
+ * see ncm_model_ctrl_add_param_dep(). The primordial submodel is always
+ * tracked as a whole.
+ *
+ */
+void
+nc_cbe_add_cosmo_param_dep (NcCBE *cbe, const guint i)
+{
+	ncm_model_ctrl_add_param_dep (cbe->ctrl_cosmo, i);
+}
+
+/**
+ * nc_cbe_clear_cosmo_param_deps:
+ * @cbe: a #NcCBE
+ *
+ * Removes all dependencies of @cbe, see ncm_model_ctrl_clear_param_deps().
+ *
+ */
+void
+nc_cbe_clear_cosmo_param_deps (NcCBE *cbe)
+{
+	ncm_model_ctrl_clear_param_deps (cbe->ctrl_cosmo);
+}
+
 /**
  * nc_cbe_set_scalar_lmax:
  * @cbe: a #NcCBE
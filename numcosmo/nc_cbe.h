@@ -107,6 +107,8 @@ void nc_cbe_set_calc_transfer (NcCBE *cbe, gboolean calc_transfer);
 void nc_cbe_set_lensed_Cls (NcCBE *cbe, gboolean use_lensed_Cls);
 void nc_cbe_set_tensor (NcCBE *cbe, gboolean use_tensor);
 void nc_cbe_set_thermodyn (NcCBE *cbe, gboolean use_thermodyn);
+void nc_cbe_add_cosmo_param_dep (NcCBE *cbe, const guint i);
+void nc_cbe_clear_cosmo_param_deps (NcCBE *cbe);
 void nc_cbe_set_scalar_lmax (NcCBE *cbe, guint scalar_lmax);
 void nc_cbe_set_vector_lmax (NcCBE *cbe, guint vector_lmax);
 void nc_cbe_set_tensor_lmax (NcCBE *cbe, guint tensor_lmax);
@@ -93,6 +93,11 @@
  * $$\mu(z) = \delta\mu(z) + 5\log_{10}[\RH_0/(1\,\text{Mpc})],$$ 
  * where $\text{Mpc}$ is megaparsec [ncm_c_Mpc()].
  *
+ * When no #NcRecomb is set and the cosmology is a #NcHICosmoDE, the
+ * object is prepared again only when a parameter other than the helium
+ * primordial abundance $Y_p$ changes, since $Y_p$ does not enter in $E(z)$.
+ * Calling nc_distance_add_cosmo_param_dep() or nc_distance_clear_cosmo_param_deps()
+ * replaces this default by the caller's choice.
  *
  */
 
@@ -102,6 +107,7 @@
 #include "build_cfg.h"
 
 #include "nc_distance.h"
+#include "model/nc_hicosmo_de.h"
 #include "math/integral.h"
 #include "math/ncm_c.h"
 #include "math/ncm_cfg.h"
@@ -118,6 +124,8 @@ enum
   PROP_0,
   PROP_ZF,
   PROP_RECOMB,
+  PROP_COSMO_PARAM_DEPS,
+  PROP_COSMO_PARAM_DEPS_AUTO,
   PROP_SIZE,
 };
 
@@ -141,7 +149,8 @@ nc_distance_init (NcDistance *dist)
 
   dist->recomb                   = NULL;
   
-  dist->ctrl = ncm_model_ctrl_new (NULL);
+  dist->ctrl            = ncm_model_ctrl_new (NULL);
+  dist->cosmo_deps_auto = TRUE;
 }
 
 static void
@@ -159,6 +168,21 @@ _nc_distance_set_property (GObject *object, guint prop_id, const GValue *value,
     case PROP_RECOMB:
       nc_distance_set_recomb (dist, g_value_get_object (value));
       break;
+    case PROP_COSMO_PARAM_DEPS:
+    {
+      GVariant *deps = g_value_get_variant (value);
+      
+      if (deps != NULL)
+      {
+        ncm_model_ctrl_set_param_deps (dist->ctrl, deps);
+        if (g_variant_n_children (deps) > 0)
+          dist->cosmo_deps_auto = FALSE;
+      }
+      break;
+    }
+    case PROP_COSMO_PARAM_DEPS_AUTO:
+      dist->cosmo_deps_auto = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -179,6 +203,15 @@ _nc_distance_get_property (GObject *object, guint prop_id, GValue *value, GParam
     case PROP_RECOMB:
       g_value_set_object (value, dist->recomb);
       break;
+    case PROP_COSMO_PARAM_DEPS:
+      if (dist->cosmo_deps_auto)
+        g_value_take_variant (value, g_variant_ref_sink (g_variant_new ("au", NULL)));
+      else
+        g_value_take_variant (value, ncm_model_ctrl_get_param_deps (dist->ctrl));
+      break;
+    case PROP_COSMO_PARAM_DEPS_AUTO:
+      g_value_set_boolean (value, dist->cosmo_deps_auto);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -250,6 +283,36 @@ nc_distance_class_init (NcDistanceClass *klass)
                                                         "Recombination object",
                                                         NC_TYPE_RECOMB,
                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  /**
+   * NcDistance:cosmo-param-deps:
+   *
+   * The #NcHICosmo parameters the distances depend on, see nc_distance_add_cosmo_param_dep().
+   * It is empty while #NcDistance:cosmo-param-deps-auto is TRUE, since the automatic
+   * dependencies are computed again in the next preparation.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_COSMO_PARAM_DEPS,
+                                   g_param_spec_variant ("cosmo-param-deps",
+                                                         NULL,
+                                                         "Cosmological parameters dependencies",
+                                                         G_VARIANT_TYPE ("au"), NULL,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  /**
+   * NcDistance:cosmo-param-deps-auto:
+   *
+   * Whether the #NcHICosmo parameters dependencies are chosen automatically
+   * in each preparation. It is set to FALSE by nc_distance_add_cosmo_param_dep(),
+   * nc_distance_clear_cosmo_param_deps() and by a non-empty #NcDistance:cosmo-param-deps.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_COSMO_PARAM_DEPS_AUTO,
+                                   g_param_spec_boolean ("cosmo-param-deps-auto",
+                                                         NULL,
+                                                         "Whether to choose the cosmological parameters dependencies automatically",
+                                                         TRUE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 /**
@@ -327,6 +390,71 @@ nc_distance_require_zf (NcDistance *dist, const gdouble zf)
   }
 }
 
+/**
+ * nc_distance_add_cosmo_param_dep:
+ * @dist: a #NcDistance
+ * @i: original parameter index
+ *
+ * Adds the @i-th original #NcHICosmo parameter to the dependencies of @dist,
+ * see ncm_model_ctrl_add_param_dep().
+ *
+ */
+void
+nc_distance_add_cosmo_param_dep (NcDistance *dist, const guint i)
+{
+  if (dist->cosmo_deps_auto)
+  {
+    ncm_model_ctrl_clear_param_deps (dist->ctrl);
+    dist->cosmo_deps_auto = FALSE;
+  }
+  ncm_model_ctrl_add_param_dep (dist->ctrl, i);
+}
+
+/**
+ * nc_distance_clear_cosmo_param_deps:
+ * @dist: a #NcDistance
+ *
+ * Removes all dependencies of @dist, it is then prepared again whenever
+ * any parameter changes.
+ *
+ */
+void
+nc_distance_clear_cosmo_param_deps (NcDistance *dist)
+{
+  ncm_model_ctrl_clear_param_deps (dist->ctrl);
+  dist->cosmo_deps_auto = FALSE;
+}
+
+/*
+ * Without recombination the prepared state depends only on $E(z)$, for
+ * #NcHICosmoDE this means every parameter except $Y_p$.
+ *
+ */
+static void
+_nc_distance_auto_cosmo_param_deps (NcDistance *dist, NcHICosmo *cosmo)
+{
+  if ((dist->recomb == NULL) && NC_IS_HICOSMO_DE (cosmo))
+  {
+    const guint len = ncm_model_len (NCM_MODEL (cosmo));
+
+    if (ncm_model_ctrl_param_deps_len (dist->ctrl) != len - 1)
+    {
+      guint i;
+
+      ncm_model_ctrl_clear_param_deps (dist->ctrl);
+      for (i = 0; i < len; i++)
+      {
+        if (i != NC_HICOSMO_DE_HE_YP)
+          ncm_model_ctrl_add_param_dep (dist->ctrl, i);
+      }
+    }
+  }
+  else if (ncm_model_ctrl_param_deps_len (dist->ctrl) > 0)
+  {
+    ncm_model_ctrl_clear_param_deps (dist->ctrl);
+  }
+}
+
 void 
 nc_distance_set_recomb (NcDistance *dist, NcRecomb *recomb)
 {
@@ -378,6 +506,9 @@ nc_distance_prepare (NcDistance *dist, NcHICosmo *cosmo)
 
   if (dist->recomb != NULL)
     nc_recomb_prepare_if_needed (dist->recomb, cosmo);
+
+  if (dist->cosmo_deps_auto)
+    _nc_distance_auto_cosmo_param_deps (dist, cosmo);
   
   ncm_model_ctrl_update (dist->ctrl, NCM_MODEL (cosmo));
 
@@ -1084,6 +1215,238 @@ nc_distance_DA_r (NcDistance *dist, NcHICosmo *cosmo, gdouble z)
   return DA / r_zd;
 }
 
+/* Vector versions */
+
+/**
+ * nc_distance_comoving_vector:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: a #NcmVector of redshifts $z$
+ * @Dc: a #NcmVector to store $D_c(z)$
+ *
+ * Computes the comoving distance [nc_distance_comoving()] for every element
+ * of @z and stores the results in @Dc. When all redshifts are within the 
+ * range of the comoving distance spline, the spline is evaluated in a single 
+ * sweep, see ncm_spline_eval_vec(). This sweep is more efficient if @z is 
+ * sorted in increasing order.
+ *
+ */
+void
+nc_distance_comoving_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dc)
+{
+  const guint len = ncm_vector_len (z);
+  guint i;
+
+  g_assert_cmpuint (len, ==, ncm_vector_len (Dc));
+
+  nc_distance_prepare_if_needed (dist, cosmo);
+
+  if (ncm_model_check_impl_opt (NCM_MODEL (cosmo), NC_HICOSMO_IMPL_Dc))
+  {
+    for (i = 0; i < len; i++)
+      ncm_vector_set (Dc, i, nc_hicosmo_Dc (cosmo, ncm_vector_get (z, i)));
+  }
+  else if (ncm_vector_get_max (z) <= dist->zf)
+  {
+    ncm_spline_eval_vec (ncm_ode_spline_peek_spline (dist->comoving_distance_spline), z, Dc);
+  }
+  else
+  {
+    for (i = 0; i < len; i++)
+      ncm_vector_set (Dc, i, nc_distance_comoving (dist, cosmo, ncm_vector_get (z, i)));
+  }
+}
+
+/**
+ * nc_distance_transverse_vector:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: a #NcmVector of redshifts $z$
+ * @Dt: a #NcmVector to store $D_t(z)$
+ *
+ * Computes the transverse comoving distance [nc_distance_transverse()] for
+ * every element of @z and stores the results in @Dt.
+ *
+ */
+void
+nc_distance_transverse_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dt)
+{
+  const gdouble Omega_k0 = nc_hicosmo_Omega_k0 (cosmo);
+  const guint len        = ncm_vector_len (z);
+  guint i;
+
+  nc_distance_comoving_vector (dist, cosmo, z, Dt);
+
+  if (fabs (Omega_k0) < NCM_ZERO_LIMIT)
+    return;
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble comoving_dist = ncm_vector_get (Dt, i);
+    if (!gsl_isinf (comoving_dist))
+      ncm_vector_set (Dt, i, _nc_distance_sinn (comoving_dist, Omega_k0));
+  }
+}
+
+/**
+ * nc_distance_luminosity_vector:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: a #NcmVector of redshifts $z$
+ * @Dl: a #NcmVector to store $D_l(z)$
+ *
+ * Computes the luminosity distance [nc_distance_luminosity()] for
+ * every element of @z and stores the results in @Dl.
+ *
+ */
+void
+nc_distance_luminosity_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dl)
+{
+  const guint len = ncm_vector_len (z);
+  guint i;
+
+  nc_distance_transverse_vector (dist, cosmo, z, Dl);
+
+  for (i = 0; i < len; i++)
+    ncm_vector_set (Dl, i, (1.0 + ncm_vector_get (z, i)) * ncm_vector_get (Dl, i));
+}
+
+/**
+ * nc_distance_angular_diameter_vector:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: a #NcmVector of redshifts $z$
+ * @DA: a #NcmVector to store $D_A(z)$
+ *
+ * Computes the angular diameter distance [nc_distance_angular_diameter()] 
+ * for every element of @z and stores the results in @DA.
+ *
+ */
+void
+nc_distance_angular_diameter_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *DA)
+{
+  const guint len = ncm_vector_len (z);
+  guint i;
+
+  nc_distance_transverse_vector (dist, cosmo, z, DA);
+
+  for (i = 0; i < len; i++)
+    ncm_vector_set (DA, i, ncm_vector_get (DA, i) / (1.0 + ncm_vector_get (z, i)));
+}
+
+/**
+ * nc_distance_dmodulus_vector:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: a #NcmVector of redshifts $z$
+ * @dmu: a #NcmVector to store $\delta\mu(z)$
+ *
+ * Computes the distance modulus [nc_distance_dmodulus()] for
+ * every element of @z and stores the results in @dmu.
+ *
+ */
+void
+nc_distance_dmodulus_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *dmu)
+{
+  const guint len = ncm_vector_len (z);
+  guint i;
+
+  nc_distance_luminosity_vector (dist, cosmo, z, dmu);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble Dl = ncm_vector_get (dmu, i);
+    if (gsl_finite (Dl))
+      ncm_vector_set (dmu, i, 5.0 * log10 (Dl) + 25.0);
+  }
+}
+
+/**
+ * nc_distance_dmodulus_hef_vector:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z_he: a #NcmVector of redshifts $z_{he}$ in our local frame
+ * @z_cmb: a #NcmVector of redshifts $z_{CMB}$ in the CMB frame
+ * @dmu: a #NcmVector to store $\delta\mu(z_{hef},z_{CMB})$
+ *
+ * Computes the frame corrected distance modulus [nc_distance_dmodulus_hef()]
+ * for every pair of elements of @z_he and @z_cmb and stores the results in @dmu.
+ *
+ */
+void
+nc_distance_dmodulus_hef_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z_he, NcmVector *z_cmb, NcmVector *dmu)
+{
+  const guint len = ncm_vector_len (z_cmb);
+  guint i;
+
+  g_assert_cmpuint (len, ==, ncm_vector_len (z_he));
+
+  nc_distance_transverse_vector (dist, cosmo, z_cmb, dmu);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble Dl = (1.0 + ncm_vector_get (z_he, i)) * ncm_vector_get (dmu, i);
+    ncm_vector_set (dmu, i, gsl_finite (Dl) ? (5.0 * log10 (Dl) + 25.0) : Dl);
+  }
+}
+
+/**
+ * nc_distance_dilation_scale_vector:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: a #NcmVector of redshifts $z$
+ * @Dv: a #NcmVector to store $D_V^\star(z)$
+ *
+ * Computes the dimensionless dilation scale [nc_distance_dilation_scale()]
+ * for every element of @z and stores the results in @Dv.
+ *
+ */
+void
+nc_distance_dilation_scale_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dv)
+{
+  const guint len = ncm_vector_len (z);
+  NcmVector *E2   = ncm_vector_new (len);
+  guint i;
+
+  nc_distance_transverse_vector (dist, cosmo, z, Dv);
+  nc_hicosmo_E2_vec (cosmo, z, E2);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble z_i  = ncm_vector_get (z, i);
+    const gdouble Dt_i = ncm_vector_get (Dv, i);
+    const gdouble E_i  = sqrt (ncm_vector_get (E2, i));
+
+    ncm_vector_set (Dv, i, cbrt (Dt_i * Dt_i * z_i / E_i));
+  }
+
+  ncm_vector_free (E2);
+}
+
+/**
+ * nc_distance_bao_r_Dv_vector:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: a #NcmVector of redshifts $z$
+ * @r_Dv: a #NcmVector to store $r(z_d) / D_V(z)$
+ *
+ * Computes $r(z_d) / D_V(z)$ [nc_distance_bao_r_Dv()] for every element
+ * of @z and stores the results in @r_Dv.
+ *
+ */
+void
+nc_distance_bao_r_Dv_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *r_Dv)
+{
+  const gdouble r_zd = nc_distance_r_zd (dist, cosmo);
+  const guint len    = ncm_vector_len (z);
+  guint i;
+
+  nc_distance_dilation_scale_vector (dist, cosmo, z, r_Dv);
+
+  for (i = 0; i < len; i++)
+    ncm_vector_set (r_Dv, i, r_zd / ncm_vector_get (r_Dv, i));
+}
+
 /* Distances from z to infinity */
 
 static gdouble
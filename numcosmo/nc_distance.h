@@ -68,6 +68,7 @@ struct _NcDistance
   NcmModelCtrl *ctrl;
   gdouble zf;
   gboolean use_cache;
+  gboolean cosmo_deps_auto;
   NcRecomb *recomb;
 };
 
@@ -94,6 +95,8 @@ NcDistance *nc_distance_ref (NcDistance *dist);
 
 void nc_distance_require_zf (NcDistance *dist, const gdouble zf);
 void nc_distance_set_recomb (NcDistance *dist, NcRecomb *recomb);
+void nc_distance_add_cosmo_param_dep (NcDistance *dist, const guint i);
+void nc_distance_clear_cosmo_param_deps (NcDistance *dist);
 
 void nc_distance_prepare (NcDistance *dist, NcHICosmo *cosmo);
 G_INLINE_FUNC void nc_distance_prepare_if_needed (NcDistance *dist, NcHICosmo *cosmo);
@@ -140,6 +143,19 @@ gdouble nc_distance_DA_r (NcDistance *dist, NcHICosmo *cosmo, gdouble z);
 gdouble nc_distance_comoving_z_to_infinity (NcDistance *dist, NcHICosmo *cosmo, gdouble z);
 gdouble nc_distance_transverse_z_to_infinity (NcDistance *dist, NcHICosmo *cosmo, gdouble z);
 
+/***************************************************************************
+ * Redshift dependent 'distances' evaluated on vectors of redshifts
+ ****************************************************************************/
+
+void nc_distance_comoving_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dc);
+void nc_distance_transverse_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dt);
+void nc_distance_luminosity_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dl);
+void nc_distance_angular_diameter_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *DA);
+void nc_distance_dmodulus_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *dmu);
+void nc_distance_dmodulus_hef_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z_he, NcmVector *z_cmb, NcmVector *dmu);
+void nc_distance_dilation_scale_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dv);
+void nc_distance_bao_r_Dv_vector (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *r_Dv);
+
 /***************************************************************************
  *            cosmic_time.h
  *
@@ -135,6 +135,9 @@ static gdouble _nc_hicosmo_E2Omega_m (NcHICosmo *cosmo, const gdouble z);
 static gdouble _nc_hicosmo_E2Omega_r (NcHICosmo *cosmo, const gdouble z);
 static gdouble _nc_hicosmo_E2Omega_t (NcHICosmo *cosmo, const gdouble z);
 
+static void _nc_hicosmo_E2_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *E2, const guint len);
+static void _nc_hicosmo_dE2_dz_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *dE2_dz, const guint len);
+
 /* End methods */
 
 static void
@@ -188,6 +191,8 @@ nc_hicosmo_class_init (NcHICosmoClass *klass)
   klass->d2E2_dz2     = &_nc_hicosmo_d2E2_dz2;
   klass->bgp_cs2      = &_nc_hicosmo_bgp_cs2;
   klass->Dc           = &_nc_hicosmo_Dc;
+  klass->E2_vec       = &_nc_hicosmo_E2_vec;
+  klass->dE2_dz_vec   = &_nc_hicosmo_dE2_dz_vec;
   klass->NMassNu      = &_nc_hicosmo_NMassNu;
   klass->MassNuInfo   = &_nc_hicosmo_MassNuInfo;
 
@@ -231,6 +236,31 @@ static gdouble _nc_hicosmo_Dc (NcHICosmo *cosmo, const gdouble z)          { g_e
 static gdouble _nc_hicosmo_E2Omega_mnu_n (NcHICosmo *cosmo, const guint n, const gdouble z) { g_error ("nc_hicosmo_E2Omega_mnu_n: model `%s' does not implement this function.", G_OBJECT_TYPE_NAME (cosmo)); return 0.0;  }
 static gdouble _nc_hicosmo_E2Press_mnu_n (NcHICosmo *cosmo, const guint n, const gdouble z) { g_error ("nc_hicosmo_E2Press_mnu_n: model `%s' does not implement this function.", G_OBJECT_TYPE_NAME (cosmo)); return 0.0;  }
 
+/*
+ * Array versions default to a loop over the scalar implementation, the class
+ * lookup is done only once per call.
+ */
+
+static void
+_nc_hicosmo_E2_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *E2, const guint len)
+{
+  NcHICosmoFunc1Z E2_f = NC_HICOSMO_GET_CLASS (cosmo)->E2;
+  guint i;
+
+  for (i = 0; i < len; i++)
+    E2[i] = E2_f (cosmo, z[i]);
+}
+
+static void
+_nc_hicosmo_dE2_dz_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *dE2_dz, const guint len)
+{
+  NcHICosmoFunc1Z dE2_dz_f = NC_HICOSMO_GET_CLASS (cosmo)->dE2_dz;
+  guint i;
+
+  for (i = 0; i < len; i++)
+    dE2_dz[i] = dE2_dz_f (cosmo, z[i]);
+}
+
 static guint _nc_hicosmo_NMassNu (NcHICosmo *cosmo) { return 0; }
 static void _nc_hicosmo_MassNuInfo (NcHICosmo *cosmo, const guint nu_i, gdouble *mass_eV, gdouble *T_0, gdouble *xi, gdouble *g) { g_error ("nc_hicosmo_NuMass: model `%s' does not implement massive neutrinos.", G_OBJECT_TYPE_NAME (cosmo)); }
 
@@ -625,10 +655,18 @@ NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFunc1Z,E2Omega_
  * @model_class: a #NcmModelClass
  * @f: FIXME
  *
- * Normalized Hubble function squared, $E^2(z)$.
+ * Normalized Hubble function squared, $E^2(z)$. This also resets
+ * the array version to the default loop over @f, a subclass providing
+ * its own [nc_hicosmo_set_E2_vec_impl()] must call it afterwards.
  *
  */
-NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFunc1Z,E2)
+void
+nc_hicosmo_set_E2_impl (NcHICosmoClass *model_class, NcHICosmoFunc1Z f)
+{
+  ncm_model_class_add_impl_opts (NCM_MODEL_CLASS (model_class), NC_HICOSMO_IMPL_E2, -1);
+  model_class->E2     = f;
+  model_class->E2_vec = &_nc_hicosmo_E2_vec;
+}
 
 /**
  * nc_hicosmo_set_dE2_dz_impl: (skip)
@@ -636,9 +674,16 @@ NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFunc1Z,E2)
  * @f: FIXME
  *
  * First derivative with respect to the redshift of the normalized Hubble function squared, $\frac{dE^2(z)}{dz}$. 
+ * This also resets the array version to the default loop over @f.
  *
  */
-NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFunc1Z,dE2_dz)
+void
+nc_hicosmo_set_dE2_dz_impl (NcHICosmoClass *model_class, NcHICosmoFunc1Z f)
+{
+  ncm_model_class_add_impl_opts (NCM_MODEL_CLASS (model_class), NC_HICOSMO_IMPL_dE2_dz, -1);
+  model_class->dE2_dz     = f;
+  model_class->dE2_dz_vec = &_nc_hicosmo_dE2_dz_vec;
+}
 
 /**
  * nc_hicosmo_set_d2E2_dz2_impl: (skip)
@@ -670,6 +715,38 @@ NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFunc1Z,bgp_cs2)
  */
 NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFunc1Z,Dc)
 
+/**
+ * nc_hicosmo_set_E2_vec_impl: (skip)
+ * @model_class: a #NcmModelClass
+ * @f: a #NcHICosmoFunc1ZVec
+ *
+ * Array version of the normalized Hubble function squared, it must
+ * agree with the scalar $E^2(z)$ implementation.
+ *
+ */
+void
+nc_hicosmo_set_E2_vec_impl (NcHICosmoClass *model_class, NcHICosmoFunc1ZVec f)
+{
+  g_assert (f != NULL);
+  model_class->E2_vec = f;
+}
+
+/**
+ * nc_hicosmo_set_dE2_dz_vec_impl: (skip)
+ * @model_class: a #NcmModelClass
+ * @f: a #NcHICosmoFunc1ZVec
+ *
+ * Array version of $\frac{dE^2(z)}{dz}$, it must agree with the scalar
+ * implementation.
+ *
+ */
+void
+nc_hicosmo_set_dE2_dz_vec_impl (NcHICosmoClass *model_class, NcHICosmoFunc1ZVec f)
+{
+  g_assert (f != NULL);
+  model_class->dE2_dz_vec = f;
+}
+
 /**
  * nc_hicosmo_set_NMassNu_impl: (skip)
  * @model_class: a #NcmModelClass
@@ -1164,6 +1241,76 @@ nc_hicosmo_q_min (NcHICosmo *cosmo, const gdouble z_max, gdouble *zm, gdouble *q
   }
 }
 
+/**
+ * nc_hicosmo_E2_vec:
+ * @cosmo: a #NcHICosmo
+ * @z: a #NcmVector of redshifts $z$
+ * @E2: a #NcmVector to store $E^2(z)$
+ *
+ * Computes the normalized Hubble function squared [nc_hicosmo_E2()] for
+ * every element of @z and stores the results in @E2. Models providing an
+ * array implementation evaluate the whole batch in a single call,
+ * otherwise the scalar implementation is looped over. The vectors
+ * @z and @E2 must not share storage.
+ *
+ */
+void
+nc_hicosmo_E2_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *E2)
+{
+  const guint len = ncm_vector_len (z);
+
+  g_assert_cmpuint (len, ==, ncm_vector_len (E2));
+  g_assert (ncm_vector_data (z) != ncm_vector_data (E2));
+
+  if (len == 0)
+    return;
+
+  if ((ncm_vector_stride (z) == 1) && (ncm_vector_stride (E2) == 1))
+  {
+    NC_HICOSMO_GET_CLASS (cosmo)->E2_vec (cosmo, ncm_vector_data (z), ncm_vector_data (E2), len);
+  }
+  else
+  {
+    guint i;
+    for (i = 0; i < len; i++)
+      ncm_vector_set (E2, i, nc_hicosmo_E2 (cosmo, ncm_vector_get (z, i)));
+  }
+}
+
+/**
+ * nc_hicosmo_dE2_dz_vec:
+ * @cosmo: a #NcHICosmo
+ * @z: a #NcmVector of redshifts $z$
+ * @dE2_dz: a #NcmVector to store $dE^2(z)/dz$
+ *
+ * Computes the redshift derivative of the normalized Hubble function
+ * squared [nc_hicosmo_dE2_dz()] for every element of @z and stores the
+ * results in @dE2_dz. The vectors @z and @dE2_dz must not share storage.
+ *
+ */
+void
+nc_hicosmo_dE2_dz_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *dE2_dz)
+{
+  const guint len = ncm_vector_len (z);
+
+  g_assert_cmpuint (len, ==, ncm_vector_len (dE2_dz));
+  g_assert (ncm_vector_data (z) != ncm_vector_data (dE2_dz));
+
+  if (len == 0)
+    return;
+
+  if ((ncm_vector_stride (z) == 1) && (ncm_vector_stride (dE2_dz) == 1))
+  {
+    NC_HICOSMO_GET_CLASS (cosmo)->dE2_dz_vec (cosmo, ncm_vector_data (z), ncm_vector_data (dE2_dz), len);
+  }
+  else
+  {
+    guint i;
+    for (i = 0; i < len; i++)
+      ncm_vector_set (dE2_dz, i, nc_hicosmo_dE2_dz (cosmo, ncm_vector_get (z, i)));
+  }
+}
+
 /*
  * Inlined functions
  */
@@ -166,6 +166,8 @@ typedef gdouble (*NcHICosmoVFunc0) (NcHICosmo *cosmo, const guint n);
 typedef gdouble (*NcHICosmoVFunc1Z) (NcHICosmo *cosmo, const guint n, const gdouble z);
 typedef gdouble (*NcHICosmoVFunc1K) (NcHICosmo *cosmo, const guint n, const gdouble k);
 
+typedef void (*NcHICosmoFunc1ZVec) (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len);
+
 typedef guint (*NcHICosmoFuncNMassNu) (NcHICosmo *cosmo);
 typedef void (*NcHICosmoFuncMassNuInfo) (NcHICosmo *cosmo, const guint nu_i, gdouble *mass_eV, gdouble *T_0, gdouble *xi, gdouble *g);
 
@@ -225,6 +227,8 @@ struct _NcHICosmoClass
   NcHICosmoFunc1Z  d2E2_dz2;
   NcHICosmoFunc1Z  bgp_cs2;
   NcHICosmoFunc1Z  Dc;
+  NcHICosmoFunc1ZVec E2_vec;
+  NcHICosmoFunc1ZVec dE2_dz_vec;
   NcHICosmoVFunc1Z E2Omega_mnu_n;
   NcHICosmoVFunc1Z E2Press_mnu_n;
   NcHICosmoFuncNMassNu NMassNu;
@@ -289,6 +293,8 @@ void nc_hicosmo_set_dE2_dz_impl (NcHICosmoClass *model_class, NcHICosmoFunc1Z f)
 void nc_hicosmo_set_d2E2_dz2_impl (NcHICosmoClass *model_class, NcHICosmoFunc1Z f);
 void nc_hicosmo_set_bgp_cs2_impl (NcHICosmoClass *model_class, NcHICosmoFunc1Z f);
 void nc_hicosmo_set_Dc_impl (NcHICosmoClass *model_class, NcHICosmoFunc1Z f);
+void nc_hicosmo_set_E2_vec_impl (NcHICosmoClass *model_class, NcHICosmoFunc1ZVec f);
+void nc_hicosmo_set_dE2_dz_vec_impl (NcHICosmoClass *model_class, NcHICosmoFunc1ZVec f);
 void nc_hicosmo_set_NMassNu_impl (NcHICosmoClass *model_class, NcHICosmoFuncNMassNu f);
 void nc_hicosmo_set_MassNuInfo_impl (NcHICosmoClass *model_class, NcHICosmoFuncMassNuInfo f);
 
@@ -304,6 +310,9 @@ void nc_hicosmo_mqE2_max (NcHICosmo *cosmo, const gdouble z_max, gdouble *zm, gd
 void nc_hicosmo_dec_min (NcHICosmo *cosmo, const gdouble z_max, gdouble *zm, gdouble *decm);
 void nc_hicosmo_q_min (NcHICosmo *cosmo, const gdouble z_max, gdouble *zm, gdouble *qm);
 
+void nc_hicosmo_E2_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *E2);
+void nc_hicosmo_dE2_dz_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *dE2_dz);
+
 /*
  * Cosmological model constant functions
  */
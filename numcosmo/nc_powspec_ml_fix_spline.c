@@ -128,6 +128,7 @@ _nc_powspec_ml_fix_spline_finalize (GObject *object)
 static void _nc_powspec_ml_fix_spline_prepare (NcmPowspec *powspec, NcmModel *model);
 static gdouble _nc_powspec_ml_fix_spline_eval (NcmPowspec *powspec, NcmModel *model, const gdouble z, const gdouble k);
 static void _nc_powspec_ml_fix_spline_eval_vec (NcmPowspec* powspec, NcmModel* model, const gdouble z, NcmVector* k, NcmVector* Pk);
+static gdouble _nc_powspec_ml_fix_spline_eval_growth2 (NcmPowspec *powspec, NcmModel *model, const gdouble z);
 static void _nc_powspec_ml_fix_spline_get_nknots (NcmPowspec *powspec, guint *Nz, guint *Nk);
 
 
@@ -158,6 +159,8 @@ nc_powspec_ml_fix_spline_class_init (NcPowspecMLFixSplineClass *klass)
   powspec_class->eval       = &_nc_powspec_ml_fix_spline_eval;
 	powspec_class->eval_vec   = &_nc_powspec_ml_fix_spline_eval_vec;
   powspec_class->get_nknots = &_nc_powspec_ml_fix_spline_get_nknots;
+
+  powspec_class->eval_growth2 = &_nc_powspec_ml_fix_spline_eval_growth2;
 }
 
 static void 
@@ -187,6 +190,14 @@ _nc_powspec_ml_fix_spline_eval (NcmPowspec *powspec, NcmModel *model, const gdou
   return ncm_spline_eval (ps_fs->Pk, k) * gf2;
 }
 
+static gdouble 
+_nc_powspec_ml_fix_spline_eval_growth2 (NcmPowspec *powspec, NcmModel *model, const gdouble z)
+{
+  NcPowspecMLFixSpline *ps_fs = NC_POWSPEC_ML_FIX_SPLINE (powspec);
+
+  return gsl_pow_2 (nc_growth_func_eval (ps_fs->gf, NC_HICOSMO (model), z));
+}
+
 static void
 _nc_powspec_ml_fix_spline_eval_vec (NcmPowspec* powspec, NcmModel* model, const gdouble z, NcmVector* k, NcmVector* Pk)
 {
@@ -167,6 +167,7 @@ enum
   PROP_ZI,
   PROP_INIT_FRAC,
   PROP_PREC,
+  PROP_COSMO_PARAM_DEPS,
   PROP_SIZE,
 };
 
@@ -253,6 +254,10 @@ nc_recomb_set_property (GObject *object, guint prop_id, const GValue *value, GPa
       recomb->prec    = g_value_get_double (value);
       ncm_model_ctrl_force_update (recomb->ctrl_cosmo);
       break;
+    case PROP_COSMO_PARAM_DEPS:
+      if (g_value_get_variant (value) != NULL)
+        ncm_model_ctrl_set_param_deps (recomb->ctrl_cosmo, g_value_get_variant (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -276,6 +281,9 @@ nc_recomb_get_property (GObject *object, guint prop_id, GValue *value, GParamSpe
     case PROP_PREC:
       g_value_set_double (value, recomb->prec);
       break;
+    case PROP_COSMO_PARAM_DEPS:
+      g_value_take_variant (value, ncm_model_ctrl_get_param_deps (recomb->ctrl_cosmo));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -335,6 +343,19 @@ nc_recomb_class_init (NcRecombClass *klass)
                                                         "Precision for recombination calculations",
                                                         0.0, 1.0, 1e-7,
                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  /**
+   * NcRecomb:cosmo-param-deps:
+   *
+   * The #NcHICosmo parameters the recombination depends on, see nc_recomb_add_cosmo_param_dep().
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_COSMO_PARAM_DEPS,
+                                   g_param_spec_variant ("cosmo-param-deps",
+                                                         NULL,
+                                                         "Cosmological parameters dependencies",
+                                                         G_VARIANT_TYPE ("au"), NULL,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 
   klass->prepare = NULL;
   klass->Xe      = &_nc_recomb_Xe;
@@ -439,6 +460,34 @@ nc_recomb_prepare (NcRecomb *recomb, NcHICosmo *cosmo)
   ncm_model_ctrl_update (recomb->ctrl_cosmo, NCM_MODEL (cosmo));
 }
 
+/**
+ * nc_recomb_add_cosmo_param_dep:
+ * @recomb: a #NcRecomb
+ * @i: original parameter index
+ *
+ * Adds the @i-th original #NcHICosmo parameter to the dependencies of @recomb,
+ * see ncm_model_ctrl_add_param_dep().
+ *
+ */
+void
+nc_recomb_add_cosmo_param_dep (NcRecomb *recomb, const guint i)
+{
+  ncm_model_ctrl_add_param_dep (recomb->ctrl_cosmo, i);
+}
+
+/**
+ * nc_recomb_clear_cosmo_param_deps:
+ * @recomb: a #NcRecomb
+ *
+ * Removes all dependencies of @recomb, see ncm_model_ctrl_clear_param_deps().
+ *
+ */
+void
+nc_recomb_clear_cosmo_param_deps (NcRecomb *recomb)
+{
+  ncm_model_ctrl_clear_param_deps (recomb->ctrl_cosmo);
+}
+
 /**
  * nc_recomb_prepare_if_needed:
  * @recomb: a #NcRecomb
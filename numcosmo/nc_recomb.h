@@ -91,6 +91,8 @@ NcRecomb *nc_recomb_ref (NcRecomb *recomb);
 void nc_recomb_free (NcRecomb *recomb);
 void nc_recomb_clear (NcRecomb **recomb);
 void nc_recomb_prepare (NcRecomb *recomb, NcHICosmo *cosmo);
+void nc_recomb_add_cosmo_param_dep (NcRecomb *recomb, const guint i);
+void nc_recomb_clear_cosmo_param_deps (NcRecomb *recomb);
 
 G_INLINE_FUNC void nc_recomb_prepare_if_needed (NcRecomb *recomb, NcHICosmo *cosmo);
 
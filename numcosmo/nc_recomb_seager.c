@@ -92,6 +92,10 @@
  * where the numerical integration will start. The integration is performed considering all
  * components without any switching or approximation.
  *
+ * When running over many cosmologies that share the same early-time physics (e.g., when
+ * sampling late-time parameters), the history up to $z = 200$ can be cached, see
+ * nc_recomb_seager_set_cache_size() and nc_recomb_seager_set_cache_reltol().
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -148,14 +152,47 @@ struct _NcRecombSeagerPrivate
   NcmSpline *Xe_recomb_s;
   NcmSpline *XHII_s;
   NcmSpline *XHeII_s;
+  guint cache_size;
+  gdouble cache_reltol;
+  GPtrArray *cache;
+  gulong cache_hits;
+  gulong cache_misses;
 };
 
+/*
+ * The recombination history is split at $z_\mathrm{cut}$, everything before it
+ * depends only on $n_\Hy$, $X_\He$, $T_{\gamma0}$ and on $H(z)$ at $z > z_\mathrm{cut}$.
+ * The cache stores this part (and the integrator state at $z_\mathrm{cut}$)
+ * keyed by these quantities, $H(z)$ being sampled at
+ * NC_RECOMB_SEAGER_CACHE_NH log-spaced redshifts in
+ * $[z_\mathrm{cut}, z_\mathrm{max}]$.
+ */
+#define NC_RECOMB_SEAGER_CACHE_ZCUT (200.0)
+#define NC_RECOMB_SEAGER_CACHE_ZMAX (1.0e5)
+#define NC_RECOMB_SEAGER_CACHE_NH (16)
+#define NC_RECOMB_SEAGER_CACHE_KEY_LEN (4 + NC_RECOMB_SEAGER_CACHE_NH)
+
+typedef struct _NcRecombSeagerCacheEntry
+{
+  gdouble key[NC_RECOMB_SEAGER_CACHE_KEY_LEN];
+  gdouble lambdai;
+  gdouble prec;
+  gdouble init_frac;
+  gdouble y_cut[3];
+  GArray *lambda_a;
+  GArray *Xe_a;
+  GArray *XHII_a;
+  GArray *XHeII_a;
+} NcRecombSeagerCacheEntry;
+
 G_DEFINE_TYPE_WITH_PRIVATE (NcRecombSeager, nc_recomb_seager, NC_TYPE_RECOMB);
 
 enum
 {
   PROP_0,
   PROP_OPTS,
+  PROP_CACHE_SIZE,
+  PROP_CACHE_RELTOL,
   PROP_SIZE,
 };
 
@@ -180,6 +217,17 @@ static gdouble _nc_recomb_seager_KX_HeI_2p_3Pmean_sobolev_cont (NcRecombSeager *
 static void _nc_recomb_seager_KX_HeI_2p_3Pmean_sobolev_grad (NcRecombSeager *recomb_seager, NcHICosmo *cosmo, const gdouble x, const gdouble XHI, const gdouble Tm, const gdouble XHeI, const gdouble H, const gdouble n_H, gdouble grad[3]);
 static void _nc_recomb_seager_KX_HeI_2p_3Pmean_sobolev_cont_grad (NcRecombSeager *recomb_seager, NcHICosmo *cosmo, const gdouble x, const gdouble XHI, const gdouble Tm, const gdouble XHeI, const gdouble H, const gdouble n_H, gdouble grad[3]);
 
+static void
+_nc_recomb_seager_cache_entry_free (NcRecombSeagerCacheEntry *entry)
+{
+  g_array_unref (entry->lambda_a);
+  g_array_unref (entry->Xe_a);
+  g_array_unref (entry->XHII_a);
+  g_array_unref (entry->XHeII_a);
+
+  g_free (entry);
+}
+
 static void
 nc_recomb_seager_init (NcRecombSeager *recomb_seager)
 {
@@ -232,6 +280,12 @@ nc_recomb_seager_init (NcRecombSeager *recomb_seager)
   self->Xe_recomb_s           = ncm_spline_cubic_notaknot_new ();
   self->XHII_s                = ncm_spline_cubic_notaknot_new ();
   self->XHeII_s               = ncm_spline_cubic_notaknot_new ();
+
+  self->cache_size            = 0;
+  self->cache_reltol          = 0.0;
+  self->cache                 = g_ptr_array_new_with_free_func ((GDestroyNotify) &_nc_recomb_seager_cache_entry_free);
+  self->cache_hits            = 0;
+  self->cache_misses          = 0;
 }
 
 static void
@@ -245,6 +299,12 @@ _nc_recomb_seager_set_property (GObject* object, guint prop_id, const GValue* va
     case PROP_OPTS:
       nc_recomb_seager_set_options (recomb_seager, g_value_get_flags (value));
       break;
+    case PROP_CACHE_SIZE:
+      nc_recomb_seager_set_cache_size (recomb_seager, g_value_get_uint (value));
+      break;
+    case PROP_CACHE_RELTOL:
+      nc_recomb_seager_set_cache_reltol (recomb_seager, g_value_get_double (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -262,6 +322,12 @@ _nc_recomb_seager_get_property (GObject* object, guint prop_id, GValue* value, G
     case PROP_OPTS:
       g_value_set_flags (value, nc_recomb_seager_get_options (recomb_seager));
       break;
+    case PROP_CACHE_SIZE:
+      g_value_set_uint (value, nc_recomb_seager_get_cache_size (recomb_seager));
+      break;
+    case PROP_CACHE_RELTOL:
+      g_value_set_double (value, nc_recomb_seager_get_cache_reltol (recomb_seager));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -289,6 +355,8 @@ _nc_recomb_seager_dispose (GObject* object)
   ncm_spline_clear (&self->XHII_s);
   ncm_spline_clear (&self->XHeII_s);
 
+  g_clear_pointer (&self->cache, g_ptr_array_unref);
+
   /* Chain up : end */
   G_OBJECT_CLASS (nc_recomb_seager_parent_class)->dispose (object);
 }
@@ -352,6 +420,35 @@ nc_recomb_seager_class_init (NcRecombSeagerClass *klass)
                                                        NC_TYPE_RECOMB_SEAGER_OPT, NC_RECOM_SEAGER_OPT_ALL,
                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 
+  /**
+   * NcRecombSeager:cache-size:
+   *
+   * Maximum number of recombination histories kept in the cache,
+   * zero disables the cache.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_CACHE_SIZE,
+                                   g_param_spec_uint ("cache-size",
+                                                      NULL,
+                                                      "Recombination history cache size",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+  /**
+   * NcRecombSeager:cache-reltol:
+   *
+   * Relative tolerance used to compare the cache keys.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_CACHE_RELTOL,
+                                   g_param_spec_double ("cache-reltol",
+                                                        NULL,
+                                                        "Recombination history cache relative tolerance",
+                                                        0.0, 1.0, 0.0,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
   recomb_class->prepare = &_nc_recomb_seager_prepare;
   recomb_class->Xe      = &_nc_recomb_seager_Xe;
   recomb_class->XHII    = &_nc_recomb_seager_XHII;
@@ -664,6 +761,154 @@ _nc_recomb_Xe_reion (gdouble lambda, gpointer p)
   return Xe_reion;
 }
 
+static GArray *
+_nc_recomb_seager_reuse_array (NcmSpline *s, gboolean xv)
+{
+  if (ncm_spline_is_empty (s))
+  {
+    return g_array_new (FALSE, FALSE, sizeof (gdouble));
+  }
+  else
+  {
+    NcmVector *v = xv ? ncm_spline_get_xv (s) : ncm_spline_get_yv (s);
+    GArray *a    = ncm_vector_get_array (v);
+
+    g_array_set_size (a, 0);
+    ncm_vector_free (v);
+
+    return a;
+  }
+}
+
+static GArray *
+_nc_recomb_seager_array_dup (GArray *a)
+{
+  GArray *b = g_array_sized_new (FALSE, FALSE, sizeof (gdouble), a->len);
+
+  g_array_append_vals (b, a->data, a->len);
+
+  return b;
+}
+
+static void
+_nc_recomb_seager_cache_key (NcHICosmo *cosmo, const gdouble x_HeIII, gdouble *key)
+{
+  const gdouble ln_zcut = log (NC_RECOMB_SEAGER_CACHE_ZCUT);
+  const gdouble ln_zmax = log (NC_RECOMB_SEAGER_CACHE_ZMAX);
+  guint i;
+
+  key[0] = nc_hicosmo_H_number_density (cosmo);
+  key[1] = nc_hicosmo_XHe (cosmo);
+  key[2] = nc_hicosmo_T_gamma0 (cosmo);
+  key[3] = x_HeIII;
+
+  for (i = 0; i < NC_RECOMB_SEAGER_CACHE_NH; i++)
+  {
+    const gdouble z = exp (ln_zcut + (ln_zmax - ln_zcut) * i / (NC_RECOMB_SEAGER_CACHE_NH - 1.0));
+
+    key[4 + i] = nc_hicosmo_H (cosmo, z);
+  }
+}
+
+static NcRecombSeagerCacheEntry *
+_nc_recomb_seager_cache_lookup (NcRecombSeager *recomb_seager, const gdouble *key)
+{
+  NcRecombSeagerPrivate * const self = recomb_seager->priv;
+  NcRecomb *recomb = NC_RECOMB (recomb_seager);
+  guint i;
+
+  for (i = 0; i < self->cache->len; i++)
+  {
+    NcRecombSeagerCacheEntry *entry = g_ptr_array_index (self->cache, i);
+    gboolean match = (entry->lambdai == recomb->lambdai) && (entry->prec == recomb->prec) && (entry->init_frac == recomb->init_frac);
+    guint j;
+
+    for (j = 0; match && (j < NC_RECOMB_SEAGER_CACHE_KEY_LEN); j++)
+      match = (fabs (entry->key[j] - key[j]) <= self->cache_reltol * fabs (key[j]));
+
+    if (match)
+    {
+      /* Most recently used entries are kept at the front. */
+      for (j = i; j > 0; j--)
+        self->cache->pdata[j] = self->cache->pdata[j - 1];
+      self->cache->pdata[0] = entry;
+
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+static void
+_nc_recomb_seager_cache_add (NcRecombSeager *recomb_seager, const gdouble *key, N_Vector y_cut, GArray *lambda_a, GArray *Xe_a, GArray *XHII_a, GArray *XHeII_a)
+{
+  NcRecombSeagerPrivate * const self = recomb_seager->priv;
+  NcRecomb *recomb = NC_RECOMB (recomb_seager);
+  NcRecombSeagerCacheEntry *entry = g_new (NcRecombSeagerCacheEntry, 1);
+  guint j;
+
+  for (j = 0; j < NC_RECOMB_SEAGER_CACHE_KEY_LEN; j++)
+    entry->key[j] = key[j];
+
+  entry->lambdai   = recomb->lambdai;
+  entry->prec      = recomb->prec;
+  entry->init_frac = recomb->init_frac;
+  entry->y_cut[0]  = NV_Ith_S (y_cut, 0);
+  entry->y_cut[1]  = NV_Ith_S (y_cut, 1);
+  entry->y_cut[2]  = NV_Ith_S (y_cut, 2);
+  entry->lambda_a  = _nc_recomb_seager_array_dup (lambda_a);
+  entry->Xe_a      = _nc_recomb_seager_array_dup (Xe_a);
+  entry->XHII_a    = _nc_recomb_seager_array_dup (XHII_a);
+  entry->XHeII_a   = _nc_recomb_seager_array_dup (XHeII_a);
+
+  while (self->cache->len >= self->cache_size)
+    g_ptr_array_remove_index (self->cache, self->cache->len - 1);
+
+  g_ptr_array_add (self->cache, entry);
+  for (j = self->cache->len - 1; j > 0; j--)
+    self->cache->pdata[j] = self->cache->pdata[j - 1];
+  self->cache->pdata[0] = entry;
+}
+
+static void
+_nc_recomb_seager_evolve (NcRecombSeager *recomb_seager, const gdouble lambda_stop, GArray *lambda_a, GArray *Xe_a, GArray *XHII_a, GArray *XHeII_a, gdouble *lambda_last)
+{
+  NcRecombSeagerPrivate * const self = recomb_seager->priv;
+  gint flag;
+
+  flag = CVodeSetStopTime (self->cvode, lambda_stop);
+  NCM_CVODE_CHECK (&flag, "CVodeSetStopTime", 1, );
+
+  while (TRUE)
+  {
+    gdouble lambda_i;
+
+    flag = CVode (self->cvode, lambda_stop, self->y, &lambda_i, CV_ONE_STEP);
+    NCM_CVODE_CHECK (&flag, "CVode111", 1, );
+
+    {
+      const gdouble XHII  = NV_Ith_S (self->y, 0);
+      const gdouble XHeII = NV_Ith_S (self->y, 2);
+      const gdouble Xe    = XHII + XHeII;
+
+      if (fabs ((lambda_last[0] - lambda_i) / lambda_last[0]) > 1.0e-7)
+      {
+        g_array_append_val (lambda_a, lambda_i);
+        g_array_append_val (Xe_a, Xe);
+
+        g_array_append_val (XHII_a, XHII);
+        g_array_append_val (XHeII_a, XHeII);
+
+        lambda_last[0] = lambda_i;
+      }
+
+      if (lambda_i == lambda_stop)
+        break;
+    }
+  }
+}
+
 static void
 _nc_recomb_seager_prepare (NcRecomb *recomb, NcHICosmo *cosmo)
 {
@@ -675,43 +920,74 @@ _nc_recomb_seager_prepare (NcRecomb *recomb, NcHICosmo *cosmo)
   const gdouble lambdai      = recomb->lambdai;
   const gdouble lambda_HeIII = -log (x_HeIII);
   const gdouble lambdaf      = -log (1.0);
+  const gdouble lambda_cut   = -log1p (NC_RECOMB_SEAGER_CACHE_ZCUT);
+  const gboolean use_cache   = (self->cache_size > 0) && (lambda_cut > lambda_HeIII);
   NcHIReion *reion           = NC_HIREION (ncm_model_peek_submodel_by_mid (NCM_MODEL (cosmo), nc_hireion_id ()));
   NcRecombSeagerParams pparams = { recomb_seager, cosmo };
+  NcRecombSeagerCacheEntry *entry = NULL;
+  gdouble key[NC_RECOMB_SEAGER_CACHE_KEY_LEN];
+  gdouble lambda_start       = lambda_HeIII;
   gsl_function F;
 
-  F.function = &_nc_recomb_He_fully_ionized_Xe;
-  F.params   = cosmo;
+  if (use_cache)
+  {
+    _nc_recomb_seager_cache_key (cosmo, x_HeIII, key);
+    entry = _nc_recomb_seager_cache_lookup (recomb_seager, key);
 
-  ncm_spline_set_func (self->Xe_recomb_s, NCM_SPLINE_FUNCTION_SPLINE,
-                       &F, lambdai, lambda_HeIII, 0, recomb->prec);
+    if (entry != NULL)
+      self->cache_hits++;
+    else
+      self->cache_misses++;
+  }
 
-  /*****************************************************************************
-   * Assuming hydrogen is completly ionized and no more double ionized helium
-   * i.e., $X_\HeIII = 0$.
-   ****************************************************************************/
+  if (entry != NULL)
+  {
+    /*****************************************************************************
+     * Cache hit: the history up to $z_\mathrm{cut}$ is reused and the
+     * integration restarts from the stored state.
+     ****************************************************************************/
+    lambda_start = lambda_cut;
+
+    NV_Ith_S (self->y0, 0) = entry->y_cut[0];
+    NV_Ith_S (self->y0, 1) = entry->y_cut[1];
+    NV_Ith_S (self->y0, 2) = entry->y_cut[2];
+  }
+  else
   {
-    const gdouble T0   = nc_hicosmo_T_gamma0 (cosmo);
-    const gdouble XHII = 1.0;
-    gdouble XHeII, Tm, XeXHeII_XHeI;
+    F.function = &_nc_recomb_He_fully_ionized_Xe;
+    F.params   = cosmo;
+
+    ncm_spline_set_func (self->Xe_recomb_s, NCM_SPLINE_FUNCTION_SPLINE,
+                         &F, lambdai, lambda_HeIII, 0, recomb->prec);
+
+    /*****************************************************************************
+     * Assuming hydrogen is completly ionized and no more double ionized helium
+     * i.e., $X_\HeIII = 0$.
+     ****************************************************************************/
+    {
+      const gdouble T0   = nc_hicosmo_T_gamma0 (cosmo);
+      const gdouble XHII = 1.0;
+      gdouble XHeII, Tm, XeXHeII_XHeI;
 
-    Tm           = T0 * x_HeIII;
-    XeXHeII_XHeI = nc_recomb_HeI_ion_saha (cosmo, x_HeIII);
-    XHeII        = (XeXHeII_XHeI + 1.0) * ncm_util_sqrt1px_m1 (4.0 * XHe * XeXHeII_XHeI / gsl_pow_2 (XeXHeII_XHeI + 1.0)) / 2.0;
+      Tm           = T0 * x_HeIII;
+      XeXHeII_XHeI = nc_recomb_HeI_ion_saha (cosmo, x_HeIII);
+      XHeII        = (XeXHeII_XHeI + 1.0) * ncm_util_sqrt1px_m1 (4.0 * XHe * XeXHeII_XHeI / gsl_pow_2 (XeXHeII_XHeI + 1.0)) / 2.0;
 
-    NV_Ith_S (self->y0, 0) = XHII;
-    NV_Ith_S (self->y0, 1) = Tm;
-    NV_Ith_S (self->y0, 2) = XHeII;
+      NV_Ith_S (self->y0, 0) = XHII;
+      NV_Ith_S (self->y0, 1) = Tm;
+      NV_Ith_S (self->y0, 2) = XHeII;
+    }
   }
 
   if (!self->init)
   {
-    gint flag = CVodeInit (self->cvode, &H_ion_full_f, lambda_HeIII, self->y0);
+    gint flag = CVodeInit (self->cvode, &H_ion_full_f, lambda_start, self->y0);
     NCM_CVODE_CHECK (&flag, "CVodeInit", 1, );
     self->init = TRUE;
   }
   else
   {
-    gint flag = CVodeReInit (self->cvode, lambda_HeIII, self->y0);
+    gint flag = CVodeReInit (self->cvode, lambda_start, self->y0);
     NCM_CVODE_CHECK (&flag, "CVodeReInit", 1, );
   }
 
@@ -738,56 +1014,37 @@ _nc_recomb_seager_prepare (NcRecomb *recomb, NcHICosmo *cosmo)
     flag = CVodeSetJacFn (self->cvode, &H_ion_full_J);
     NCM_CVODE_CHECK (&flag, "CVodeSetJacFn", 1, );
 
-    flag = CVodeSetStopTime (self->cvode, lambdaf);
-    NCM_CVODE_CHECK (&flag, "CVodeSetStopTime", 1, );
-
     flag = CVodeSetMaxErrTestFails (self->cvode, 14);
     NCM_CVODE_CHECK (&flag, "CVodeSetMaxErrTestFails", 1, );
   }
 
   {
-    NcmVector *lambda_v = ncm_spline_get_xv (self->Xe_recomb_s);
-    NcmVector *Xe_v     = ncm_spline_get_yv (self->Xe_recomb_s);
-    GArray *lambda_a    = ncm_vector_get_array (lambda_v);
-    GArray *Xe_a        = ncm_vector_get_array (Xe_v);
-    gdouble lambda_last = lambda_HeIII;
-    GArray *XHII_a, *XHeII_a;
-
-    ncm_vector_free (lambda_v);
-    ncm_vector_free (Xe_v);
-    
-    if (ncm_spline_is_empty (self->XHII_s))
-    {
-      XHII_a = g_array_new (FALSE, FALSE, sizeof (gdouble));
-    }
-    else
-    {
-      NcmVector *XHII_v = ncm_spline_get_yv (self->XHII_s);
+    gdouble lambda_last = lambda_start;
+    GArray *lambda_a, *Xe_a, *XHII_a, *XHeII_a;
 
-      XHII_a = ncm_vector_get_array (XHII_v);
-      g_array_set_size (XHII_a, 0);
-      
-      ncm_vector_free (XHII_v);
-    }
+    XHII_a  = _nc_recomb_seager_reuse_array (self->XHII_s, FALSE);
+    XHeII_a = _nc_recomb_seager_reuse_array (self->XHeII_s, FALSE);
 
-    if (ncm_spline_is_empty (self->XHeII_s))
+    if (entry != NULL)
     {
-      XHeII_a = g_array_new (FALSE, FALSE, sizeof (gdouble));
-    }
-    else
-    {
-      NcmVector *XHeII_v = ncm_spline_get_yv (self->XHeII_s);
-      
-      XHeII_a = ncm_vector_get_array (XHeII_v);
-      g_array_set_size (XHeII_a, 0);
+      lambda_a = _nc_recomb_seager_reuse_array (self->Xe_recomb_s, TRUE);
+      Xe_a     = _nc_recomb_seager_reuse_array (self->Xe_recomb_s, FALSE);
 
-      ncm_vector_free (XHeII_v);
+      g_array_append_vals (lambda_a, entry->lambda_a->data, entry->lambda_a->len);
+      g_array_append_vals (Xe_a,     entry->Xe_a->data,     entry->Xe_a->len);
+      g_array_append_vals (XHII_a,   entry->XHII_a->data,   entry->XHII_a->len);
+      g_array_append_vals (XHeII_a,  entry->XHeII_a->data,  entry->XHeII_a->len);
     }
-    
+    else
     {
-      const guint lenXe = ncm_spline_get_len (self->Xe_recomb_s);
+      NcmVector *lambda_v = ncm_spline_get_xv (self->Xe_recomb_s);
+      NcmVector *Xe_v     = ncm_spline_get_yv (self->Xe_recomb_s);
+      const guint lenXe   = ncm_spline_get_len (self->Xe_recomb_s);
       guint i;
 
+      lambda_a = ncm_vector_get_array (lambda_v);
+      Xe_a     = ncm_vector_get_array (Xe_v);
+
       for (i = 0; i < lenXe; i++)
       {
         const gdouble lambda_i = ncm_vector_get (lambda_v, i);
@@ -799,35 +1056,30 @@ _nc_recomb_seager_prepare (NcRecomb *recomb, NcHICosmo *cosmo)
         g_array_append_val (XHII_a, XHII);
         g_array_append_val (XHeII_a, XHeII);
       }
-    }
 
-    while (TRUE)
-    {
-      gdouble lambda_i;
-      gint flag = CVode (self->cvode, lambdaf, self->y, &lambda_i, CV_ONE_STEP);
-      NCM_CVODE_CHECK (&flag, "CVode111", 1, );
-      
-      {
-        const gdouble XHII  = NV_Ith_S (self->y, 0);
-        const gdouble XHeII = NV_Ith_S (self->y, 2);
-        const gdouble Xe    = XHII + XHeII;
-
-        if (fabs ((lambda_last - lambda_i) / lambda_last) > 1.0e-7)
-        {
-          g_array_append_val (lambda_a, lambda_i);
-          g_array_append_val (Xe_a, Xe);
+      ncm_vector_free (lambda_v);
+      ncm_vector_free (Xe_v);
 
-          g_array_append_val (XHII_a, XHII);
-          g_array_append_val (XHeII_a, XHeII);
-
-          lambda_last = lambda_i;
-        }
-
-        if (lambda_i == lambdaf)
-          break;
+      if (use_cache)
+      {
+        /*****************************************************************************
+         * Integrates up to $z_\mathrm{cut}$, stores this part of the history and
+         * restarts the integrator from there, so that a cache hit reproduces
+         * exactly the same steps.
+         ****************************************************************************/
+        gint flag;
+
+        _nc_recomb_seager_evolve (recomb_seager, lambda_cut, lambda_a, Xe_a, XHII_a, XHeII_a, &lambda_last);
+        _nc_recomb_seager_cache_add (recomb_seager, key, self->y, lambda_a, Xe_a, XHII_a, XHeII_a);
+
+        N_VScale (1.0, self->y, self->y0);
+        flag = CVodeReInit (self->cvode, lambda_cut, self->y0);
+        NCM_CVODE_CHECK (&flag, "CVodeReInit", 1, );
       }
     }
 
+    _nc_recomb_seager_evolve (recomb_seager, lambdaf, lambda_a, Xe_a, XHII_a, XHeII_a, &lambda_last);
+
     ncm_spline_set_array (self->Xe_recomb_s, lambda_a, Xe_a, TRUE);
     ncm_spline_set_array (self->XHII_s,      lambda_a, XHII_a, TRUE);
     ncm_spline_set_array (self->XHeII_s,     lambda_a, XHeII_a, TRUE);
@@ -1273,6 +1525,7 @@ void nc_recomb_seager_set_options (NcRecombSeager *recomb_seager, NcRecombSeager
     }
 
     ncm_model_ctrl_force_update (recomb->ctrl_cosmo);
+    nc_recomb_seager_cache_clear (recomb_seager);
     self->opts = opts;
   }
 }
@@ -1356,6 +1609,136 @@ nc_recomb_seager_get_options (NcRecombSeager *recomb_seager)
   return self->opts;
 }
 
+/**
+ * nc_recomb_seager_set_cache_size:
+ * @recomb_seager: a #NcRecombSeager
+ * @cache_size: maximum number of cached histories
+ *
+ * Sets the maximum number of recombination histories kept in the cache.
+ * When @cache_size is larger than zero, the history up to $z = 200$ is stored
+ * keyed by $n_\Hy$, $X_\He$, $T_{\gamma0}$ and $H(z)$ sampled at
+ * $z \geq 200$. A subsequent preparation with matching keys (see
+ * nc_recomb_seager_set_cache_reltol()) skips this part of the integration
+ * and only evolves the system from $z = 200$ onwards, followed by the
+ * reionization and optical depth computation. Setting @cache_size to zero
+ * disables the cache.
+ *
+ */
+void
+nc_recomb_seager_set_cache_size (NcRecombSeager *recomb_seager, guint cache_size)
+{
+  NcRecombSeagerPrivate * const self = recomb_seager->priv;
+
+  if (self->cache_size != cache_size)
+  {
+    if (self->cache->len > cache_size)
+      g_ptr_array_set_size (self->cache, cache_size);
+
+    /* Enabling or disabling the cache changes the integration path. */
+    if ((self->cache_size == 0) || (cache_size == 0))
+      ncm_model_ctrl_force_update (NC_RECOMB (recomb_seager)->ctrl_cosmo);
+
+    self->cache_size = cache_size;
+  }
+}
+
+/**
+ * nc_recomb_seager_get_cache_size:
+ * @recomb_seager: a #NcRecombSeager
+ *
+ * Returns: the maximum number of cached recombination histories.
+ */
+guint
+nc_recomb_seager_get_cache_size (NcRecombSeager *recomb_seager)
+{
+  NcRecombSeagerPrivate * const self = recomb_seager->priv;
+  return self->cache_size;
+}
+
+/**
+ * nc_recomb_seager_set_cache_reltol:
+ * @recomb_seager: a #NcRecombSeager
+ * @reltol: relative tolerance
+ *
+ * Sets the relative tolerance used when comparing the cache keys. The default
+ * value zero reuses a history only when all keys are identical. A small
+ * positive value, e.g. $10^{-6}$, also reuses histories when only late-time
+ * parameters changed, since they affect $H(z \geq 200)$ only marginally.
+ *
+ */
+void
+nc_recomb_seager_set_cache_reltol (NcRecombSeager *recomb_seager, const gdouble reltol)
+{
+  NcRecombSeagerPrivate * const self = recomb_seager->priv;
+
+  g_assert_cmpfloat (reltol, >=, 0.0);
+
+  self->cache_reltol = reltol;
+}
+
+/**
+ * nc_recomb_seager_get_cache_reltol:
+ * @recomb_seager: a #NcRecombSeager
+ *
+ * Returns: the relative tolerance used when comparing the cache keys.
+ */
+gdouble
+nc_recomb_seager_get_cache_reltol (NcRecombSeager *recomb_seager)
+{
+  NcRecombSeagerPrivate * const self = recomb_seager->priv;
+  return self->cache_reltol;
+}
+
+/**
+ * nc_recomb_seager_cache_clear:
+ * @recomb_seager: a #NcRecombSeager
+ *
+ * Removes all recombination histories from the cache.
+ *
+ */
+void
+nc_recomb_seager_cache_clear (NcRecombSeager *recomb_seager)
+{
+  NcRecombSeagerPrivate * const self = recomb_seager->priv;
+  g_ptr_array_set_size (self->cache, 0);
+}
+
+/**
+ * nc_recomb_seager_cache_get_stats:
+ * @recomb_seager: a #NcRecombSeager
+ * @hits: (out): number of cache hits
+ * @misses: (out): number of cache misses
+ *
+ * Gets the number of preparations that reused a cached history (@hits) and
+ * the number of preparations that had to integrate the full history (@misses)
+ * since the last call to nc_recomb_seager_cache_reset_stats().
+ *
+ */
+void
+nc_recomb_seager_cache_get_stats (NcRecombSeager *recomb_seager, gulong *hits, gulong *misses)
+{
+  NcRecombSeagerPrivate * const self = recomb_seager->priv;
+
+  hits[0]   = self->cache_hits;
+  misses[0] = self->cache_misses;
+}
+
+/**
+ * nc_recomb_seager_cache_reset_stats:
+ * @recomb_seager: a #NcRecombSeager
+ *
+ * Resets the cache hit/miss counters.
+ *
+ */
+void
+nc_recomb_seager_cache_reset_stats (NcRecombSeager *recomb_seager)
+{
+  NcRecombSeagerPrivate * const self = recomb_seager->priv;
+
+  self->cache_hits   = 0;
+  self->cache_misses = 0;
+}
+
 
 /**
  * nc_recomb_seager_pequignot_HI_case_B:
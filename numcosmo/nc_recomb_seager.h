@@ -100,6 +100,14 @@ void nc_recomb_seager_set_options (NcRecombSeager *recomb_seager, NcRecombSeager
 void nc_recomb_seager_set_switch (NcRecombSeager *recomb_seager, guint H_switch, guint He_switch);
 NcRecombSeagerOpt nc_recomb_seager_get_options (NcRecombSeager *recomb_seager);
 
+void nc_recomb_seager_set_cache_size (NcRecombSeager *recomb_seager, guint cache_size);
+guint nc_recomb_seager_get_cache_size (NcRecombSeager *recomb_seager);
+void nc_recomb_seager_set_cache_reltol (NcRecombSeager *recomb_seager, const gdouble reltol);
+gdouble nc_recomb_seager_get_cache_reltol (NcRecombSeager *recomb_seager);
+void nc_recomb_seager_cache_clear (NcRecombSeager *recomb_seager);
+void nc_recomb_seager_cache_get_stats (NcRecombSeager *recomb_seager, gulong *hits, gulong *misses);
+void nc_recomb_seager_cache_reset_stats (NcRecombSeager *recomb_seager);
+
 gdouble nc_recomb_seager_pequignot_HI_case_B (NcRecombSeager *recomb_seager, NcHICosmo *cosmo, const gdouble Tm);
 gdouble nc_recomb_seager_pequignot_HI_case_B_dTm (NcRecombSeager *recomb_seager, NcHICosmo *cosmo, const gdouble Tm);
 gdouble nc_recomb_seager_hummer_HeI_case_B (NcRecombSeager *recomb_seager, NcHICosmo *cosmo, const gdouble Tm);
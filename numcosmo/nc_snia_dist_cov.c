@@ -460,6 +460,39 @@ nc_snia_dist_cov_calc (NcSNIADistCov *dcov, NcDataSNIACov *snia_cov, NcmMatrix *
   }
 }
 
+/**
+ * nc_snia_dist_cov_get_cov_params:
+ * @dcov: a #NcSNIADistCov
+ * @cov_params: (element-type gdouble): a #GArray
+ *
+ * Copies to @cov_params every value the covariance computed by
+ * nc_snia_dist_cov_calc() depends on, i.e., $\alpha$, $\beta$,
+ * $\ln(\sigma_\mathrm{pecz})$, $\ln(\sigma_\mathrm{lens})$, the
+ * empty factor switch and the $\ln(\sigma_\mathrm{int})$ vector.
+ * For the same data, equal @cov_params imply equal covariances,
+ * changes in the absolute magnitudes or in the cosmology do not
+ * affect @cov_params.
+ *
+ */
+void
+nc_snia_dist_cov_get_cov_params (NcSNIADistCov *dcov, GArray *cov_params)
+{
+  NcmModel *model           = NCM_MODEL (dcov);
+  const guint sigma_int_len = ncm_model_vparam_len (model, NC_SNIA_DIST_COV_LNSIGMA_INT);
+  guint i;
+
+  g_array_set_size (cov_params, 5 + sigma_int_len);
+
+  g_array_index (cov_params, gdouble, 0) = ALPHA;
+  g_array_index (cov_params, gdouble, 1) = BETA;
+  g_array_index (cov_params, gdouble, 2) = LNSIGMA_PECZ;
+  g_array_index (cov_params, gdouble, 3) = LNSIGMA_LENS;
+  g_array_index (cov_params, gdouble, 4) = dcov->empty_fac ? 1.0 : 0.0;
+
+  for (i = 0; i < sigma_int_len; i++)
+    g_array_index (cov_params, gdouble, 5 + i) = ncm_model_orig_vparam_get (model, NC_SNIA_DIST_COV_LNSIGMA_INT, i);
+}
+
 /**
  * nc_snia_dist_cov_mean:
  * @dcov: a #NcSNIADistCov
@@ -510,14 +543,14 @@ nc_snia_dist_cov_mean (NcSNIADistCov *dcov, NcHICosmo *cosmo, NcDataSNIACov *sni
 
     g_assert (NCM_DATA (snia_cov)->init);
 
+    nc_distance_dmodulus_hef_vector (dcov->dist, cosmo, snia_cov->z_he, snia_cov->z_cmb, y);
+
     for (i = 0; i < snia_cov->mu_len; i++)
     {
-      const gdouble z_cmb    = ncm_vector_get (snia_cov->z_cmb, i);
-      const gdouble z_he     = ncm_vector_get (snia_cov->z_he, i);
       const gdouble width    = ncm_vector_get (snia_cov->width, i);
       const gdouble colour   = ncm_vector_get (snia_cov->colour, i);
       const gdouble thirdpar = ncm_vector_get (snia_cov->thirdpar, i);
-      const gdouble dmu      = nc_distance_dmodulus_hef (dcov->dist, cosmo, z_he, z_cmb);
+      const gdouble dmu      = ncm_vector_get (y, i);
       const gdouble mag_th   = dmu - alpha * (width - 1.0) + beta * colour + ((thirdpar < 10.0) ? Mcal1 : Mcal2);
       const gdouble y_i      = mag_th;
 
@@ -594,14 +627,18 @@ nc_snia_dist_cov_mag_to_width_colour (NcSNIADistCov *dcov, NcHICosmo *cosmo, NcD
 
   ncm_matrix_set_zero (X);
 
+  {
+    NcmVector *dmu_v = ncm_vector_get_subvector (obs, 0, mu_len);
+    nc_distance_dmodulus_hef_vector (dcov->dist, cosmo, snia_cov->z_he, snia_cov->z_cmb, dmu_v);
+    ncm_vector_free (dmu_v);
+  }
+
   if (colmajor)
   {
     for (i = 0; i < mu_len; i++)
     {
-      const gdouble z_cmb    = ncm_vector_get (snia_cov->z_cmb, i);
-      const gdouble z_he     = ncm_vector_get (snia_cov->z_he, i);
       const gdouble thirdpar = ncm_vector_get (snia_cov->thirdpar, i);
-      const gdouble dmu      = nc_distance_dmodulus_hef (dcov->dist, cosmo, z_he, z_cmb);
+      const gdouble dmu      = ncm_vector_get (obs, i);
       const gdouble M        = ((thirdpar < 10.0) ? Mcal1 : Mcal2);
       const gdouble m_obs_i  = ncm_vector_get (snia_cov->mag, i);
       const gdouble w_obs_i  = ncm_vector_get (snia_cov->width, i);
@@ -621,10 +658,8 @@ nc_snia_dist_cov_mag_to_width_colour (NcSNIADistCov *dcov, NcHICosmo *cosmo, NcD
   {
     for (i = 0; i < mu_len; i++)
     {
-      const gdouble z_cmb    = ncm_vector_get (snia_cov->z_cmb, i);
-      const gdouble z_he     = ncm_vector_get (snia_cov->z_he, i);
       const gdouble thirdpar = ncm_vector_get (snia_cov->thirdpar, i);
-      const gdouble dmu      = nc_distance_dmodulus_hef (dcov->dist, cosmo, z_he, z_cmb);
+      const gdouble dmu      = ncm_vector_get (obs, i);
       const gdouble M        = ((thirdpar < 10.0) ? Mcal1 : Mcal2);
       const gdouble m_obs_i  = ncm_vector_get (snia_cov->mag, i);
       const gdouble w_obs_i  = ncm_vector_get (snia_cov->width, i);
@@ -30,6 +30,10 @@
  *
  * FIXME
  *
+ * Independent wavenumbers can be evolved concurrently using
+ * nc_hipert_boltzmann_std_evol_modes(). Each thread uses its own copy of
+ * the object, i.e., its own CVODE context, taken from an internal pool.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -38,6 +42,7 @@
 #include "build_cfg.h"
 
 #include "nc_hipert_boltzmann_std.h"
+#include "math/ncm_func_eval.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <cvode/cvode.h>
@@ -64,12 +69,19 @@ G_DEFINE_TYPE (NcHIPertBoltzmannStd, nc_hipert_boltzmann_std, NC_TYPE_HIPERT_BOL
 static void
 nc_hipert_boltzmann_std_init (NcHIPertBoltzmannStd *pbs)
 {
-
+  pbs->mode_pool = NULL;
 }
 
 static void
 nc_hipert_boltzmann_std_finalize (GObject *object)
 {
+  NcHIPertBoltzmannStd *pbs = NC_HIPERT_BOLTZMANN_STD (object);
+
+  if (pbs->mode_pool != NULL)
+  {
+    ncm_memory_pool_free (pbs->mode_pool, TRUE);
+    pbs->mode_pool = NULL;
+  }
 
   /* Chain up : end */
   G_OBJECT_CLASS (nc_hipert_boltzmann_std_parent_class)->finalize (object);
@@ -439,6 +451,120 @@ nc_hipert_boltzmann_std_new (NcRecomb *recomb, guint lmax)
   return pbs;
 }
 
+static gpointer
+_nc_hipert_boltzmann_std_mode_dup (gpointer userdata)
+{
+  NcHIPertBoltzmann *pb = NC_HIPERT_BOLTZMANN (userdata);
+  NcHIPertBoltzmannStd *pbs_mode = g_object_new (NC_TYPE_HIPERT_BOLTZMANN_STD,
+                                                 "recomb", pb->recomb,
+                                                 NULL);
+
+  return pbs_mode;
+}
+
+static void
+_nc_hipert_boltzmann_std_mode_sync (NcHIPertBoltzmann *pb, NcHIPertBoltzmann *pb_mode)
+{
+  NcHIPert *pert      = NC_HIPERT (pb);
+  NcHIPert *pert_mode = NC_HIPERT (pb_mode);
+
+  nc_hipert_boltzmann_set_recomb (pb_mode, pb->recomb);
+  nc_hipert_set_stiff_solver (pert_mode, pert->priv->cvode_stiff);
+
+  if (pb_mode->TT_lmax != pb->TT_lmax)
+    nc_hipert_boltzmann_set_TT_lmax (pb_mode, pb->TT_lmax);
+
+  nc_hipert_set_reltol (pert_mode, nc_hipert_get_reltol (pert));
+  nc_hipert_set_abstol (pert_mode, nc_hipert_get_abstol (pert));
+
+  pb_mode->lambdai        = pb->lambdai;
+  pb_mode->lambdaf        = pb->lambdaf;
+  pb_mode->tight_coupling = pb->tight_coupling;
+}
+
+typedef struct _NcHIPertBoltzmannStdModes
+{
+  NcHIPertBoltzmannStd *pbs;
+  NcHICosmo *cosmo;
+  NcmVector *k;
+  NcmMatrix *modes;
+} NcHIPertBoltzmannStdModes;
+
+static void
+_nc_hipert_boltzmann_std_evol_modes_mt (glong i, glong f, gpointer data)
+{
+  NcHIPertBoltzmannStdModes *arg    = (NcHIPertBoltzmannStdModes *) data;
+  NcHIPertBoltzmannStd **pbs_ptr    = ncm_memory_pool_get (arg->pbs->mode_pool);
+  NcHIPertBoltzmann *pb_mode        = NC_HIPERT_BOLTZMANN (*pbs_ptr);
+  NcHIPert *pert_mode               = NC_HIPERT (pb_mode);
+  NcHIPertBoltzmannClass *pb_class  = NC_HIPERT_BOLTZMANN_GET_CLASS (pb_mode);
+  const guint sys_size              = ncm_matrix_ncols (arg->modes);
+  glong n;
+
+  _nc_hipert_boltzmann_std_mode_sync (NC_HIPERT_BOLTZMANN (arg->pbs), pb_mode);
+
+  for (n = i; n < f; n++)
+  {
+    guint j;
+
+    nc_hipert_set_mode_k (pert_mode, ncm_vector_get (arg->k, n));
+
+    /*
+     * Same steps as nc_hipert_boltzmann_prepare() except for the
+     * recombination, which was already prepared by the calling thread.
+     */
+    pb_class->init (pb_mode, arg->cosmo);
+    pb_class->reset (pb_mode);
+    pb_class->set_opts (pb_mode);
+    pb_class->evol (pb_mode, pb_mode->lambdaf);
+
+    for (j = 0; j < sys_size; j++)
+      ncm_matrix_set (arg->modes, n, j, NV_Ith_S (pert_mode->priv->y, j));
+  }
+
+  ncm_memory_pool_return (pbs_ptr);
+}
+
+/**
+ * nc_hipert_boltzmann_std_evol_modes:
+ * @pbs: a #NcHIPertBoltzmannStd
+ * @cosmo: a #NcHICosmo
+ * @k: a #NcmVector containing the wavenumbers
+ * @modes: a #NcmMatrix
+ *
+ * Evolves the Boltzmann hierarchy for each wavenumber in @k from
+ * the initial to the final time of @pbs. The final state of the
+ * $i$-th mode is stored in the $i$-th row of @modes, which must have
+ * one row per element of @k and one column per component of the
+ * system.
+ *
+ * The modes are distributed among the threads of the #NcmFuncEval pool,
+ * each thread integrating with its own CVODE context. Since every mode
+ * is evolved independently from its initial conditions and written to
+ * its own row, the result does not depend on the number of threads or
+ * on the scheduling.
+ *
+ */
+void
+nc_hipert_boltzmann_std_evol_modes (NcHIPertBoltzmannStd *pbs, NcHICosmo *cosmo, NcmVector *k, NcmMatrix *modes)
+{
+  NcHIPertBoltzmann *pb = NC_HIPERT_BOLTZMANN (pbs);
+  NcHIPertBoltzmannStdModes arg = {pbs, cosmo, k, modes};
+  const guint len = ncm_vector_len (k);
+
+  g_assert_cmpuint (len, >, 0);
+  g_assert_cmpuint (ncm_matrix_nrows (modes), ==, len);
+  g_assert_cmpuint (ncm_matrix_ncols (modes), ==, NC_HIPERT (pb)->priv->sys_size);
+
+  nc_recomb_prepare_if_needed (pb->recomb, cosmo);
+
+  if (pbs->mode_pool == NULL)
+    pbs->mode_pool = ncm_memory_pool_new (&_nc_hipert_boltzmann_std_mode_dup, pbs,
+                                          (GDestroyNotify) &nc_hipert_boltzmann_free);
+
+  ncm_func_eval_threaded_loop_ws (&_nc_hipert_boltzmann_std_evol_modes_mt, 0, len, &arg, 1);
+}
+
 static gint
 _nc_hipert_boltzmann_std_step (realtype lambda, N_Vector y, N_Vector ydot, gpointer user_data)
 {
@@ -24,6 +24,7 @@
 #include <glib-object.h>
 #include <numcosmo/build_cfg.h>
 #include <numcosmo/nc_hicosmo.h>
+#include <numcosmo/math/ncm_memory_pool.h>
 #include <numcosmo/perturbations/nc_hipert_boltzmann.h>
 
 G_BEGIN_DECLS
@@ -48,12 +49,15 @@ struct _NcHIPertBoltzmannStd
 {
   /*< private >*/
   NcHIPertBoltzmann parent_instance;
+  NcmMemoryPool *mode_pool;
 };
 
 GType nc_hipert_boltzmann_std_get_type (void) G_GNUC_CONST;
 
 NcHIPertBoltzmannStd *nc_hipert_boltzmann_std_new (NcRecomb *recomb, guint lmax);
 
+void nc_hipert_boltzmann_std_evol_modes (NcHIPertBoltzmannStd *pbs, NcHICosmo *cosmo, NcmVector *k, NcmMatrix *modes);
+
 G_END_DECLS
 
 #endif /* _NC_HIPERT_BOLTZMANN_STD_H_ */
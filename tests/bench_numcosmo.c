@@ -0,0 +1,702 @@
+/***************************************************************************
+ *            bench_numcosmo.c
+ *
+ *  Sat October 17 14:20:11 2026
+ *  Copyright  2026  agent
+ *  <agent@local>
+ ****************************************************************************/
+/*
+ * bench_numcosmo.c
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Throughput benchmarks for the library hot paths. Each benchmark
+ * prints one tab separated line per configuration:
+ *
+ *   name  param  nthreads  nops  time[s]  ns/op
+ *
+ * so that the output of different commits can be compared directly.
+ * Run with `make bench' in the tests directory, or run bench_numcosmo
+ * with --help for the options.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif /* HAVE_CONFIG_H */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <numcosmo/numcosmo.h>
+
+typedef void (*BenchFunc) (gpointer userdata, gulong nops);
+
+typedef struct _BenchOpts
+{
+  gdouble min_time;
+  gint max_threads;
+  gint esmcmc_steps;
+  gint esmcmc_dim;
+  gchar **benchs;
+} BenchOpts;
+
+static BenchOpts opts = {0.5, 4, 50, 10, NULL};
+
+static gboolean
+_bench_enabled (const gchar *name)
+{
+  if (opts.benchs == NULL)
+    return TRUE;
+  else
+  {
+    guint i;
+    for (i = 0; opts.benchs[i] != NULL; i++)
+    {
+      if (g_str_has_prefix (name, opts.benchs[i]))
+        return TRUE;
+    }
+    return FALSE;
+  }
+}
+
+static void
+_bench_report (const gchar *name, const gchar *param, guint nthreads, gulong nops, gdouble elapsed)
+{
+  printf ("%s\t%s\t%u\t%lu\t%.6e\t%.6e\n", name, param, nthreads, nops, elapsed, elapsed * 1.0e9 / nops);
+  fflush (stdout);
+}
+
+/*
+ * Calls f with an increasing number of operations until the total
+ * time exceeds opts.min_time, then reports the last measurement.
+ */
+static void
+_bench_run (const gchar *name, const gchar *param, guint nthreads, BenchFunc f, gpointer userdata)
+{
+  NcmTimer *timer = ncm_timer_new ();
+  gulong nops     = 1;
+  gdouble elapsed;
+
+  while (TRUE)
+  {
+    ncm_timer_start (timer);
+    f (userdata, nops);
+    elapsed = ncm_timer_elapsed (timer);
+
+    if ((elapsed >= opts.min_time) || (nops > (G_MAXULONG / 4)))
+      break;
+
+    nops = (elapsed > 0.0) ? GSL_MAX (2 * nops, (gulong) (1.2 * nops * opts.min_time / elapsed)) : 10 * nops;
+  }
+
+  _bench_report (name, param, nthreads, nops, elapsed);
+  ncm_timer_free (timer);
+}
+
+static NcHICosmo *
+_bench_cosmo_new (void)
+{
+  NcHICosmo *cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  NcHIReion *reion = NC_HIREION (nc_hireion_camb_new ());
+  NcHIPrim *prim   = NC_HIPRIM (nc_hiprim_power_law_new ());
+
+  ncm_model_add_submodel (NCM_MODEL (cosmo), NCM_MODEL (reion));
+  ncm_model_add_submodel (NCM_MODEL (cosmo), NCM_MODEL (prim));
+
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_H0,       70.0);
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_OMEGA_C,   0.25);
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_OMEGA_X,   0.70);
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_T_GAMMA0,  2.72);
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_OMEGA_B,   0.05);
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_XCDM_W,   -1.0);
+
+  nc_hireion_free (reion);
+  nc_hiprim_free (prim);
+
+  return cosmo;
+}
+
+/* Alternates w so that every evaluation requires a full model update. */
+static void
+_bench_cosmo_touch (NcHICosmo *cosmo, gulong i)
+{
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_XCDM_W, -1.0 + 1.0e-3 * (i % 2));
+}
+
+/****************************************************************************
+ * NcDistance
+ ****************************************************************************/
+
+typedef struct _BenchDist
+{
+  NcDistance *dist;
+  NcHICosmo *cosmo;
+} BenchDist;
+
+static void
+_bench_dist_comoving (gpointer userdata, gulong nops)
+{
+  BenchDist *bd = userdata;
+  gdouble acc   = 0.0;
+  gulong i;
+
+  for (i = 0; i < nops; i++)
+  {
+    const gdouble z = 2.0 * (i % 1024) / 1023.0;
+    acc += nc_distance_comoving (bd->dist, bd->cosmo, z);
+  }
+
+  g_assert (gsl_finite (acc));
+}
+
+static void
+_bench_dist_prepare (gpointer userdata, gulong nops)
+{
+  BenchDist *bd = userdata;
+  gulong i;
+
+  for (i = 0; i < nops; i++)
+  {
+    _bench_cosmo_touch (bd->cosmo, i);
+    nc_distance_prepare (bd->dist, bd->cosmo);
+  }
+}
+
+static void
+_bench_distance (void)
+{
+  BenchDist bd;
+
+  bd.cosmo = _bench_cosmo_new ();
+  bd.dist  = nc_distance_new (2.0);
+
+  nc_distance_prepare (bd.dist, bd.cosmo);
+
+  if (_bench_enabled ("nc_distance_comoving"))
+    _bench_run ("nc_distance_comoving", "z=[0,2]", 1, &_bench_dist_comoving, &bd);
+  if (_bench_enabled ("nc_distance_prepare"))
+    _bench_run ("nc_distance_prepare", "zf=2", 1, &_bench_dist_prepare, &bd);
+
+  nc_distance_free (bd.dist);
+  nc_hicosmo_free (bd.cosmo);
+}
+
+/****************************************************************************
+ * NcmSpline
+ ****************************************************************************/
+
+static void
+_bench_spline_eval (gpointer userdata, gulong nops)
+{
+  NcmSpline *s = userdata;
+  gdouble acc  = 0.0;
+  gulong i;
+
+  for (i = 0; i < nops; i++)
+  {
+    const gdouble x = 10.0 * (i % 4099) / 4098.0;
+    acc += ncm_spline_eval (s, x);
+  }
+
+  g_assert (gsl_finite (acc));
+}
+
+static void
+_bench_spline (void)
+{
+  const guint sizes[] = {100, 10000, 1000000};
+  guint j;
+
+  if (!_bench_enabled ("ncm_spline_eval"))
+    return;
+
+  for (j = 0; j < G_N_ELEMENTS (sizes); j++)
+  {
+    NcmVector *xv = ncm_vector_new (sizes[j]);
+    NcmVector *yv = ncm_vector_new (sizes[j]);
+    NcmSpline *s;
+    gchar *param;
+    guint i;
+
+    for (i = 0; i < sizes[j]; i++)
+    {
+      const gdouble x = 10.0 * i / (sizes[j] - 1.0);
+      ncm_vector_set (xv, i, x);
+      ncm_vector_set (yv, i, sin (x) * exp (-0.1 * x));
+    }
+
+    s     = ncm_spline_cubic_notaknot_new_full (xv, yv, TRUE);
+    param = g_strdup_printf ("knots=%u", sizes[j]);
+
+    _bench_run ("ncm_spline_eval", param, 1, &_bench_spline_eval, s);
+
+    g_free (param);
+    ncm_spline_free (s);
+    ncm_vector_free (xv);
+    ncm_vector_free (yv);
+  }
+}
+
+/****************************************************************************
+ * NcmStatsDistNdKDEGauss
+ ****************************************************************************/
+
+typedef struct _BenchKDE
+{
+  NcmStatsDistNd *dnd;
+  NcmMatrix *x;
+} BenchKDE;
+
+static void
+_bench_kde_eval (gpointer userdata, gulong nops)
+{
+  BenchKDE *bk = userdata;
+  const guint n = ncm_matrix_nrows (bk->x);
+  gdouble acc   = 0.0;
+  gulong i;
+
+  for (i = 0; i < nops; i++)
+  {
+    NcmVector *x_i = ncm_matrix_get_row (bk->x, i % n);
+    acc += ncm_stats_dist_nd_eval (bk->dnd, x_i);
+    ncm_vector_free (x_i);
+  }
+
+  g_assert (gsl_finite (acc));
+}
+
+static void
+_bench_kde (void)
+{
+  const guint dim = 4;
+  const guint nobs[] = {1000, 10000};
+  guint j;
+
+  if (!_bench_enabled ("ncm_stats_dist_nd_eval"))
+    return;
+
+  for (j = 0; j < G_N_ELEMENTS (nobs); j++)
+  {
+    NcmRNG *rng = ncm_rng_seeded_new (NULL, 1234);
+    BenchKDE bk;
+    gchar *param;
+    guint i, k;
+
+    bk.dnd = NCM_STATS_DIST_ND (ncm_stats_dist_nd_kde_gauss_new (dim, FALSE));
+    bk.x   = ncm_matrix_new (128, dim);
+
+    for (i = 0; i < nobs[j]; i++)
+    {
+      NcmVector *y = ncm_vector_new (dim);
+      for (k = 0; k < dim; k++)
+        ncm_vector_set (y, k, ncm_rng_gaussian_gen (rng, 0.0, 1.0));
+      ncm_stats_dist_nd_kde_gauss_add_obs (NCM_STATS_DIST_ND_KDE_GAUSS (bk.dnd), y);
+      ncm_vector_free (y);
+    }
+
+    for (i = 0; i < ncm_matrix_nrows (bk.x); i++)
+    {
+      for (k = 0; k < dim; k++)
+        ncm_matrix_set (bk.x, i, k, ncm_rng_gaussian_gen (rng, 0.0, 1.0));
+    }
+
+    ncm_stats_dist_nd_prepare (bk.dnd);
+
+    param = g_strdup_printf ("dim=%u,nobs=%u", dim, nobs[j]);
+    _bench_run ("ncm_stats_dist_nd_eval", param, 1, &_bench_kde_eval, &bk);
+
+    g_free (param);
+    ncm_matrix_free (bk.x);
+    ncm_stats_dist_nd_free (bk.dnd);
+    ncm_rng_free (rng);
+  }
+}
+
+/****************************************************************************
+ * NcmFftlog
+ ****************************************************************************/
+
+static gdouble
+_bench_fftlog_plaw (const gdouble k, gpointer userdata)
+{
+  return pow (k, 0.96) / (1.0 + gsl_pow_4 (k / 0.02));
+}
+
+static void
+_bench_fftlog_eval (gpointer userdata, gulong nops)
+{
+  NcmFftlog *fftlog = userdata;
+  gulong i;
+
+  for (i = 0; i < nops; i++)
+    ncm_fftlog_eval_by_function (fftlog, &_bench_fftlog_plaw, NULL);
+}
+
+static void
+_bench_fftlog (void)
+{
+  const guint sizes[] = {500, 1000, 2000, 4000, 8000};
+  guint j;
+
+  if (!_bench_enabled ("ncm_fftlog_eval"))
+    return;
+
+  for (j = 0; j < G_N_ELEMENTS (sizes); j++)
+  {
+    NcmFftlog *fftlog = NCM_FFTLOG (ncm_fftlog_tophatwin2_new (0.0, 0.0, 20.0, sizes[j]));
+    gchar *param      = g_strdup_printf ("tophatwin2,N=%u", sizes[j]);
+
+    ncm_fftlog_set_lnk0 (fftlog, log (1.0e-1));
+    ncm_fftlog_set_lnr0 (fftlog, -log (1.0e-1));
+    ncm_fftlog_set_length (fftlog, log (1.0e8));
+
+    _bench_run ("ncm_fftlog_eval", param, 1, &_bench_fftlog_eval, fftlog);
+
+    g_free (param);
+    ncm_fftlog_free (fftlog);
+  }
+}
+
+/****************************************************************************
+ * NcHaloMassFunction and NcDataClusterNCount
+ ****************************************************************************/
+
+typedef struct _BenchHMF
+{
+  NcHICosmo *cosmo;
+  NcDistance *dist;
+  NcTransferFunc *tf;
+  NcPowspecML *psml;
+  NcmPowspecFilter *psf;
+  NcMultiplicityFunc *mulf;
+  NcHaloMassFunction *mf;
+} BenchHMF;
+
+static void
+_bench_hmf_dn_dz (gpointer userdata, gulong nops)
+{
+  BenchHMF *bh = userdata;
+  gdouble acc  = 0.0;
+  gulong i;
+
+  for (i = 0; i < nops; i++)
+  {
+    const gdouble z = 0.05 + 0.65 * (i % 64) / 63.0;
+    acc += nc_halo_mass_function_dn_dz (bh->mf, bh->cosmo, log (1.0e14), log (1.0e16), z, FALSE);
+  }
+
+  g_assert (gsl_finite (acc));
+}
+
+static void
+_bench_hmf_prepare (gpointer userdata, gulong nops)
+{
+  BenchHMF *bh = userdata;
+  gulong i;
+
+  for (i = 0; i < nops; i++)
+  {
+    _bench_cosmo_touch (bh->cosmo, i);
+    ncm_powspec_prepare_if_needed (NCM_POWSPEC (bh->psml), NCM_MODEL (bh->cosmo));
+    ncm_powspec_filter_prepare_if_needed (bh->psf, NCM_MODEL (bh->cosmo));
+    nc_halo_mass_function_prepare (bh->mf, bh->cosmo);
+  }
+}
+
+typedef struct _BenchNCount
+{
+  NcmData *ncdata;
+  NcmMSet *mset;
+  NcHICosmo *cosmo;
+} BenchNCount;
+
+static void
+_bench_ncount_m2lnL (gpointer userdata, gulong nops)
+{
+  BenchNCount *bn = userdata;
+  gdouble acc     = 0.0;
+  gulong i;
+
+  for (i = 0; i < nops; i++)
+  {
+    gdouble m2lnL;
+    _bench_cosmo_touch (bn->cosmo, i);
+    ncm_data_m2lnL_val (bn->ncdata, bn->mset, &m2lnL);
+    acc += m2lnL;
+  }
+
+  g_assert (gsl_finite (acc));
+}
+
+static void
+_bench_hmf (void)
+{
+  BenchHMF bh;
+
+  if (!_bench_enabled ("nc_halo_mass_function") && !_bench_enabled ("nc_data_cluster_ncount"))
+    return;
+
+  bh.cosmo = _bench_cosmo_new ();
+  bh.dist  = nc_distance_new (2.0);
+  bh.tf    = nc_transfer_func_new_from_name ("NcTransferFuncEH");
+  bh.psml  = NC_POWSPEC_ML (nc_powspec_ml_transfer_new (bh.tf));
+  ncm_powspec_require_kmin (NCM_POWSPEC (bh.psml), 1.0e-3);
+  ncm_powspec_require_kmax (NCM_POWSPEC (bh.psml), 1.0e3);
+
+  bh.psf   = ncm_powspec_filter_new (NCM_POWSPEC (bh.psml), NCM_POWSPEC_FILTER_TYPE_TOPHAT);
+  ncm_powspec_filter_set_best_lnr0 (bh.psf);
+
+  bh.mulf  = nc_multiplicity_func_new_from_name ("NcMultiplicityFuncTinkerMean");
+  bh.mf    = nc_halo_mass_function_new (bh.dist, bh.psf, bh.mulf);
+
+  nc_halo_mass_function_set_area_sd (bh.mf, 200.0);
+  nc_halo_mass_function_set_eval_limits (bh.mf, bh.cosmo, log (1.0e14), log (1.0e16), 0.0, 0.7);
+
+  ncm_powspec_prepare (NCM_POWSPEC (bh.psml), NCM_MODEL (bh.cosmo));
+  ncm_powspec_filter_prepare (bh.psf, NCM_MODEL (bh.cosmo));
+  nc_halo_mass_function_prepare (bh.mf, bh.cosmo);
+
+  if (_bench_enabled ("nc_halo_mass_function_dn_dz"))
+    _bench_run ("nc_halo_mass_function_dn_dz", "lnM=[14,16]ln10", 1, &_bench_hmf_dn_dz, &bh);
+  if (_bench_enabled ("nc_halo_mass_function_prepare"))
+    _bench_run ("nc_halo_mass_function_prepare", "z=[0,0.7]", 1, &_bench_hmf_prepare, &bh);
+
+  if (_bench_enabled ("nc_data_cluster_ncount_m2lnL"))
+  {
+    NcClusterMass *cluster_m         = nc_cluster_mass_new_from_name ("NcClusterMassLnnormal{'lnMobs-min':<32.2362>, 'lnMobs-max':<36.8414>}");
+    NcClusterRedshift *cluster_z     = nc_cluster_redshift_new_from_name ("NcClusterPhotozGaussGlobal{'pz-min':<0.0>, 'pz-max':<0.7>, 'z-bias':<0.0>, 'sigma0':<0.03>}");
+    NcClusterAbundance *cad          = nc_cluster_abundance_new (bh.mf, NULL);
+    NcDataClusterNCount *ncount      = nc_data_cluster_ncount_new (cad);
+    NcmRNG *rng                      = ncm_rng_seeded_new (NULL, 1234);
+    BenchNCount bn;
+
+    bn.cosmo  = bh.cosmo;
+    bn.ncdata = NCM_DATA (ncount);
+    bn.mset   = ncm_mset_new (bh.cosmo, cluster_z, cluster_m, NULL);
+
+    nc_data_cluster_ncount_init_from_sampling (ncount, bn.mset, 270.0 * gsl_pow_2 (M_PI / 180.0), rng);
+
+    _bench_run ("nc_data_cluster_ncount_m2lnL", "unbinned,270deg2", 1, &_bench_ncount_m2lnL, &bn);
+
+    ncm_mset_free (bn.mset);
+    ncm_data_free (bn.ncdata);
+    nc_cluster_abundance_free (cad);
+    nc_cluster_mass_free (cluster_m);
+    nc_cluster_redshift_free (cluster_z);
+    ncm_rng_free (rng);
+  }
+
+  nc_halo_mass_function_free (bh.mf);
+  nc_multiplicity_func_free (bh.mulf);
+  ncm_powspec_filter_free (bh.psf);
+  nc_powspec_ml_free (bh.psml);
+  nc_transfer_func_free (bh.tf);
+  nc_distance_free (bh.dist);
+  nc_hicosmo_free (bh.cosmo);
+}
+
+/****************************************************************************
+ * NcDataSNIACov
+ ****************************************************************************/
+
+typedef struct _BenchSNIa
+{
+  NcmLikelihood *lh;
+  NcmMSet *mset;
+  NcHICosmo *cosmo;
+} BenchSNIa;
+
+static void
+_bench_snia_m2lnL (gpointer userdata, gulong nops)
+{
+  BenchSNIa *bs = userdata;
+  gdouble acc   = 0.0;
+  gulong i;
+
+  for (i = 0; i < nops; i++)
+  {
+    gdouble m2lnL;
+    _bench_cosmo_touch (bs->cosmo, i);
+    ncm_likelihood_m2lnL_val (bs->lh, bs->mset, &m2lnL);
+    acc += m2lnL;
+  }
+
+  g_assert (gsl_finite (acc));
+}
+
+static void
+_bench_snia (void)
+{
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  if (!_bench_enabled ("nc_data_snia_cov_m2lnL"))
+    return;
+  else
+  {
+    NcmData *data      = nc_data_snia_cov_new (FALSE);
+    NcDistance *dist   = nc_distance_new (2.0);
+    NcmDataset *dset   = ncm_dataset_new ();
+    BenchSNIa bs;
+    NcSNIADistCov *dcov;
+
+    nc_data_snia_load_cat (NC_DATA_SNIA_COV (data), NC_DATA_SNIA_COV_JLA_SNLS3_SDSS_SYS_STAT_CMPL);
+    dcov = nc_snia_dist_cov_new (dist, nc_data_snia_cov_sigma_int_len (NC_DATA_SNIA_COV (data)));
+
+    ncm_dataset_append_data (dset, data);
+
+    bs.cosmo = _bench_cosmo_new ();
+    bs.mset  = ncm_mset_new (bs.cosmo, dcov, NULL);
+    bs.lh    = ncm_likelihood_new (dset);
+
+    _bench_run ("nc_data_snia_cov_m2lnL", "JLA,cmpl", 1, &_bench_snia_m2lnL, &bs);
+
+    ncm_likelihood_free (bs.lh);
+    ncm_mset_free (bs.mset);
+    nc_hicosmo_free (bs.cosmo);
+    nc_snia_dist_cov_free (dcov);
+    ncm_dataset_free (dset);
+    nc_distance_free (dist);
+    ncm_data_free (data);
+  }
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+}
+
+/****************************************************************************
+ * NcmFitESMCMC
+ ****************************************************************************/
+
+static void
+_bench_esmcmc (void)
+{
+  const guint dim      = opts.esmcmc_dim;
+  const guint nwalkers = 10 * dim;
+  gint nthreads;
+
+  if (!_bench_enabled ("ncm_fit_esmcmc_step"))
+    return;
+
+  for (nthreads = 1; nthreads <= opts.max_threads; nthreads *= 2)
+  {
+    NcmRNG *rng                         = ncm_rng_seeded_new (NULL, 1234);
+    NcmDataGaussCovMVND *data_mvnd      = ncm_data_gauss_cov_mvnd_new_full (dim, 1.0e-2, 5.0e-1, 1.0, 1.0, 2.0, rng);
+    NcmModelMVND *model_mvnd            = ncm_model_mvnd_new (dim);
+    NcmDataset *dset                    = ncm_dataset_new_list (data_mvnd, NULL);
+    NcmLikelihood *lh                   = ncm_likelihood_new (dset);
+    NcmMSet *mset                       = ncm_mset_new (NCM_MODEL (model_mvnd), NULL);
+    NcmMSetTransKernGauss *init_sampler = ncm_mset_trans_kern_gauss_new (0);
+    NcmTimer *timer                     = ncm_timer_new ();
+    NcmFitESMCMCWalkerAPS *aps;
+    NcmFitESMCMC *esmcmc;
+    NcmFit *fit;
+    gchar *param;
+
+    ncm_mset_param_set_all_ftype (mset, NCM_PARAM_TYPE_FREE);
+
+    fit = ncm_fit_new (NCM_FIT_TYPE_GSL_MMS, "nmsimplex", lh, mset, NCM_FIT_GRAD_NUMDIFF_CENTRAL);
+    aps = ncm_fit_esmcmc_walker_aps_new (nwalkers, ncm_mset_fparams_len (mset));
+
+    esmcmc = ncm_fit_esmcmc_new (fit, nwalkers, NCM_MSET_TRANS_KERN (init_sampler), NCM_FIT_ESMCMC_WALKER (aps), NCM_FIT_RUN_MSGS_NONE);
+
+    ncm_fit_esmcmc_set_rng (esmcmc, rng);
+    ncm_fit_esmcmc_set_nthreads (esmcmc, nthreads);
+
+    ncm_mset_trans_kern_set_mset (NCM_MSET_TRANS_KERN (init_sampler), mset);
+    ncm_mset_trans_kern_set_prior_from_mset (NCM_MSET_TRANS_KERN (init_sampler));
+    ncm_mset_trans_kern_gauss_set_cov_from_rescale (init_sampler, 0.1);
+
+    ncm_fit_esmcmc_start_run (esmcmc);
+    /* 
+     * ncm_fit_esmcmc_run() takes the total number of ensemble steps. The
+     * first one draws the initial points and is kept out of the timing.
+     */
+    ncm_fit_esmcmc_run (esmcmc, 1);
+
+    ncm_timer_start (timer);
+    ncm_fit_esmcmc_run (esmcmc, 1 + opts.esmcmc_steps);
+
+    param = g_strdup_printf ("aps,dim=%u,nwalkers=%u", dim, nwalkers);
+    _bench_report ("ncm_fit_esmcmc_step", param, nthreads, opts.esmcmc_steps, ncm_timer_elapsed (timer));
+
+    ncm_fit_esmcmc_end_run (esmcmc);
+
+    g_free (param);
+    ncm_timer_free (timer);
+    ncm_fit_esmcmc_free (esmcmc);
+    ncm_fit_esmcmc_walker_free (NCM_FIT_ESMCMC_WALKER (aps));
+    ncm_fit_free (fit);
+    ncm_mset_trans_kern_free (NCM_MSET_TRANS_KERN (init_sampler));
+    ncm_mset_free (mset);
+    ncm_likelihood_free (lh);
+    ncm_dataset_free (dset);
+    ncm_model_mvnd_free (model_mvnd);
+    ncm_data_gauss_cov_mvnd_free (data_mvnd);
+    ncm_rng_free (rng);
+  }
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+  GError *error = NULL;
+  GOptionContext *context;
+  GOptionEntry entries[] =
+  {
+    { "bench",        'b', 0, G_OPTION_ARG_STRING_ARRAY, &opts.benchs,       "Run only the benchmarks whose name starts with this prefix, repeat for several.", NULL },
+    { "min-time",     't', 0, G_OPTION_ARG_DOUBLE,       &opts.min_time,     "Minimum time (seconds) spent on each measurement.", NULL },
+    { "max-threads",  'n', 0, G_OPTION_ARG_INT,          &opts.max_threads,  "Largest number of threads in the scaling curves (powers of two).", NULL },
+    { "esmcmc-steps", 's', 0, G_OPTION_ARG_INT,          &opts.esmcmc_steps, "Number of ensemble steps timed in the ESMCMC benchmark.", NULL },
+    { "esmcmc-dim",   'd', 0, G_OPTION_ARG_INT,          &opts.esmcmc_dim,   "Dimension of the Gaussian target in the ESMCMC benchmark.", NULL },
+    { NULL }
+  };
+
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  context = g_option_context_new ("- benchmark NumCosmo hot paths.");
+  g_option_context_set_summary (context, "NumCosmo benchmarks");
+  g_option_context_set_description (context, "Prints one tab separated line per benchmark: name, parameters, threads, operations, total time [s] and ns/op.");
+  g_option_context_add_main_entries (context, entries, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+  {
+    g_print ("option parsing failed: %s\n", error->message);
+    exit (1);
+  }
+
+  if ((opts.min_time <= 0.0) || (opts.max_threads < 1) || (opts.esmcmc_steps < 1) || (opts.esmcmc_dim < 1))
+  {
+    g_print ("Invalid options, see --help.\n");
+    exit (1);
+  }
+
+  ncm_func_eval_set_max_threads (opts.max_threads);
+
+  printf ("# name\tparam\tnthreads\tnops\ttime[s]\tns/op\n");
+
+  _bench_distance ();
+  _bench_spline ();
+  _bench_kde ();
+  _bench_fftlog ();
+  _bench_hmf ();
+  _bench_snia ();
+  _bench_esmcmc ();
+
+  g_option_context_free (context);
+  g_strfreev (opts.benchs);
+
+  return 0;
+}
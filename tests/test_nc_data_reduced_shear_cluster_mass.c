@@ -0,0 +1,350 @@
+/***************************************************************************
+ *            test_nc_data_reduced_shear_cluster_mass.c
+ *
+ *  Sun October 18 11:02:17 2026
+ *  Copyright  2026  agent
+ *  <agent@local>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) agent 2026 <agent@local>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <gsl/gsl_integration.h>
+
+typedef struct _TestNcDataReducedShearClusterMass
+{
+  NcHICosmo *cosmo;
+  NcDistance *dist;
+  NcDensityProfile *dp;
+  NcWLSurfaceMassDensity *smd;
+  NcReducedShearClusterMass *rs;
+  NcmMSet *mset;
+  NcDataReducedShearClusterMass *drs;
+  NcmRNG *rng;
+  gdouble z_cluster;
+  guint ngal;
+} TestNcDataReducedShearClusterMass;
+
+/*
+ * Lower limit of the photo-z distributions: either all behind the
+ * cluster or extending in front of it.
+ */
+static const gdouble test_nc_drs_pz_behind = 0.35;
+static const gdouble test_nc_drs_pz_front  = 0.05;
+
+#define TEST_NC_DRS_Z_GRID_LEN 2000
+#define TEST_NC_DRS_TOL 1.0e-4
+
+void test_nc_data_reduced_shear_cluster_mass_new (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+void test_nc_data_reduced_shear_cluster_mass_free (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+
+void test_nc_data_reduced_shear_cluster_mass_grid_qag (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+void test_nc_data_reduced_shear_cluster_mass_threaded (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+void test_nc_data_reduced_shear_cluster_mass_empty (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+#ifdef HAVE_GSL_2_2
+  g_test_add ("/nc/data_reduced_shear_cluster_mass/grid_qag/behind", TestNcDataReducedShearClusterMass, &test_nc_drs_pz_behind,
+              &test_nc_data_reduced_shear_cluster_mass_new,
+              &test_nc_data_reduced_shear_cluster_mass_grid_qag,
+              &test_nc_data_reduced_shear_cluster_mass_free);
+  g_test_add ("/nc/data_reduced_shear_cluster_mass/grid_qag/front", TestNcDataReducedShearClusterMass, &test_nc_drs_pz_front,
+              &test_nc_data_reduced_shear_cluster_mass_new,
+              &test_nc_data_reduced_shear_cluster_mass_grid_qag,
+              &test_nc_data_reduced_shear_cluster_mass_free);
+  g_test_add ("/nc/data_reduced_shear_cluster_mass/threaded", TestNcDataReducedShearClusterMass, &test_nc_drs_pz_front,
+              &test_nc_data_reduced_shear_cluster_mass_new,
+              &test_nc_data_reduced_shear_cluster_mass_threaded,
+              &test_nc_data_reduced_shear_cluster_mass_free);
+  g_test_add ("/nc/data_reduced_shear_cluster_mass/empty", TestNcDataReducedShearClusterMass, NULL,
+              &test_nc_data_reduced_shear_cluster_mass_new,
+              &test_nc_data_reduced_shear_cluster_mass_empty,
+              &test_nc_data_reduced_shear_cluster_mass_free);
+#endif /* HAVE_GSL_2_2 */
+
+  g_test_run ();
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_new (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  NcDistance *smd_dist = nc_distance_new (3.0);
+  NcmObjArray *photoz  = ncm_obj_array_new ();
+  NcmMatrix *gal_obs   = NULL;
+  gdouble dA;
+  guint i;
+
+  test->cosmo     = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  test->dist      = nc_distance_new (3.0);
+  test->dp        = NC_DENSITY_PROFILE (nc_density_profile_new_from_name ("NcDensityProfileNFW{'Delta':<200.0>}"));
+  test->smd       = nc_wl_surface_mass_density_new (smd_dist);
+  test->rs        = nc_reduced_shear_cluster_mass_new ();
+  test->rng       = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  test->z_cluster = 0.3;
+  test->ngal      = (pdata != NULL) ? g_test_rand_int_range (20, 40) : 0;
+
+  ncm_model_orig_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_H0,       70.0);
+  ncm_model_orig_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_OMEGA_C,   0.255);
+  ncm_model_orig_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_OMEGA_X,   0.7);
+  ncm_model_orig_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_T_GAMMA0,  2.7245);
+  ncm_model_orig_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_OMEGA_B,   0.045);
+  ncm_model_orig_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_XCDM_W,   -1.0);
+  nc_hicosmo_de_omega_x2omega_k (NC_HICOSMO_DE (test->cosmo));
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "Omegak", 0.0);
+
+  ncm_model_param_set_by_name (NCM_MODEL (test->dp), "MDelta", 1.0e15);
+  ncm_model_param_set_by_name (NCM_MODEL (test->dp), "cDelta", 4.0);
+
+  test->mset = ncm_mset_new (test->cosmo, test->smd, test->dp, test->rs, NULL);
+
+  /* The data and the surface mass density use different distance objects. */
+  nc_distance_prepare (test->dist, test->cosmo);
+  dA = nc_distance_angular_diameter (test->dist, test->cosmo, test->z_cluster) * nc_hicosmo_RH_Mpc (test->cosmo);
+
+  if (test->ngal > 0)
+    gal_obs = ncm_matrix_new (test->ngal, 2);
+
+  /*
+   * Synthetic catalog: Gaussian photo-z distributions tabulated from
+   * z_min = *pdata up to 1.3, all galaxies pass the radius and best
+   * redshift cuts.
+   */
+  for (i = 0; i < test->ngal; i++)
+  {
+    NcGalaxyRedshiftSpline *gzs = nc_galaxy_redshift_spline_new ();
+    const gdouble z_min         = *((const gdouble *) pdata);
+    const gdouble z_max         = 1.3;
+    const gdouble z_mean        = ncm_rng_uniform_gen (test->rng, 0.55, 0.8);
+    const gdouble sigma_z       = ncm_rng_uniform_gen (test->rng, 0.1, 0.25);
+    const gdouble R_Mpc         = ncm_rng_uniform_gen (test->rng, 1.0, 2.5);
+    const guint nknots          = 80;
+    NcmVector *zv               = ncm_vector_new (nknots);
+    NcmVector *Pzv              = ncm_vector_new (nknots);
+    guint n;
+
+    for (n = 0; n < nknots; n++)
+    {
+      const gdouble z_n = z_min + (z_max - z_min) * n / (nknots - 1.0);
+
+      ncm_vector_set (zv, n, z_n);
+      ncm_vector_set (Pzv, n, ((n == 0) || (n == nknots - 1)) ? 0.0 : exp (-0.5 * gsl_pow_2 ((z_n - z_mean) / sigma_z)));
+    }
+
+    nc_galaxy_redshift_spline_init_from_vectors (gzs, zv, Pzv);
+    ncm_obj_array_add (photoz, G_OBJECT (gzs));
+
+    ncm_matrix_set (gal_obs, i, 0, R_Mpc / dA * (180.0 / M_PI) * 60.0);
+    ncm_matrix_set (gal_obs, i, 1, ncm_rng_gaussian_gen (test->rng, 0.05, 0.03));
+
+    ncm_vector_free (zv);
+    ncm_vector_free (Pzv);
+    nc_galaxy_redshift_spline_free (gzs);
+  }
+
+  test->drs = nc_data_reduced_shear_cluster_mass_new (test->dist);
+  g_object_set (test->drs,
+                "z-cluster", test->z_cluster,
+                "photoz-array", photoz,
+                NULL);
+
+  if (gal_obs != NULL)
+  {
+    g_object_set (test->drs, "gal-obs", gal_obs, NULL);
+    ncm_matrix_free (gal_obs);
+  }
+
+  ncm_data_set_init (NCM_DATA (test->drs), TRUE);
+
+  ncm_obj_array_unref (photoz);
+  nc_distance_free (smd_dist);
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_free (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (nc_data_reduced_shear_cluster_mass_free, test->drs);
+  NCM_TEST_FREE (ncm_mset_free, test->mset);
+  NCM_TEST_FREE (nc_reduced_shear_cluster_mass_free, test->rs);
+  NCM_TEST_FREE (nc_wl_surface_mass_density_free, test->smd);
+  NCM_TEST_FREE (nc_density_profile_free, test->dp);
+  NCM_TEST_FREE (nc_distance_free, test->dist);
+  NCM_TEST_FREE (nc_hicosmo_free, test->cosmo);
+  NCM_TEST_FREE (ncm_rng_free, test->rng);
+}
+
+typedef struct _TestNcDRSInteg
+{
+  TestNcDataReducedShearClusterMass *test;
+  NcGalaxyRedshift *gz;
+  guint di;
+  gdouble R_Mpc;
+  gdouble g_obs;
+  gboolean zero_front;
+} TestNcDRSInteg;
+
+static gdouble
+_test_nc_data_reduced_shear_cluster_mass_integrand (gdouble z, gpointer userdata)
+{
+  TestNcDRSInteg *integ                   = (TestNcDRSInteg *) userdata;
+  TestNcDataReducedShearClusterMass *test = integ->test;
+  const gdouble g_th                      = (integ->zero_front && (z <= test->z_cluster)) ? 0.0 :
+    nc_wl_surface_mass_density_reduced_shear_infinity (test->smd, test->dp, test->cosmo, integ->R_Mpc, z, test->z_cluster, test->z_cluster);
+
+  return nc_reduced_shear_cluster_mass_P_z_gth_gobs (test->rs, test->cosmo, z, g_th, integ->g_obs) * nc_galaxy_redshift_pdf (integ->gz, integ->di, z);
+}
+
+/*
+ * Reference -2 ln L computed directly from the definition, sources in
+ * front of the cluster have either zero shear (zero_front) or the shear
+ * obtained by extrapolating beta_s to negative values.
+ */
+static gdouble
+_test_nc_data_reduced_shear_cluster_mass_m2lnL_ref (TestNcDataReducedShearClusterMass *test, const gboolean zero_front)
+{
+  NcmObjArray *photoz           = NULL;
+  NcmMatrix *gal_obs            = NULL;
+  gsl_integration_workspace *w  = gsl_integration_workspace_alloc (1000);
+  const gdouble dA              = nc_distance_angular_diameter (test->dist, test->cosmo, test->z_cluster) * nc_hicosmo_RH_Mpc (test->cosmo);
+  gdouble m2lnL                 = 0.0;
+  TestNcDRSInteg integ;
+  gsl_function F;
+  guint i;
+
+  g_object_get (test->drs, "photoz-array", &photoz, "gal-obs", &gal_obs, NULL);
+
+  nc_distance_prepare_if_needed (test->smd->dist, test->cosmo);
+
+  integ.test       = test;
+  integ.zero_front = zero_front;
+  F.function       = &_test_nc_data_reduced_shear_cluster_mass_integrand;
+  F.params         = &integ;
+
+  for (i = 0; i < test->ngal; i++)
+  {
+    NcGalaxyRedshift *gz = NC_GALAXY_REDSHIFT (ncm_obj_array_peek (photoz, i));
+    guint j;
+
+    integ.gz    = gz;
+    integ.R_Mpc = (ncm_matrix_get (gal_obs, i, 0) / 60.0) * (M_PI / 180.0) * dA;
+    integ.g_obs = ncm_matrix_get (gal_obs, i, 1);
+
+    for (j = 0; j < nc_galaxy_redshift_nintervals (gz); j++)
+    {
+      gdouble z_lower, z_upper, P_ij, abserr;
+
+      nc_galaxy_redshift_pdf_limits (gz, j, &z_lower, &z_upper);
+      integ.di = j;
+
+      /* The zero shear in front of the cluster makes the integrand discontinuous at z_cluster. */
+      if (zero_front && (z_lower < test->z_cluster) && (z_upper > test->z_cluster))
+      {
+        gdouble P_front, P_behind;
+
+        gsl_integration_qag (&F, z_lower, test->z_cluster, 0.0, 1.0e-10, 1000, 6, w, &P_front, &abserr);
+        gsl_integration_qag (&F, test->z_cluster, z_upper, 0.0, 1.0e-10, 1000, 6, w, &P_behind, &abserr);
+        P_ij = P_front + P_behind;
+      }
+      else
+        gsl_integration_qag (&F, z_lower, z_upper, 0.0, 1.0e-10, 1000, 6, w, &P_ij, &abserr);
+
+      m2lnL += -2.0 * log (P_ij);
+    }
+  }
+
+  gsl_integration_workspace_free (w);
+  ncm_obj_array_unref (photoz);
+  ncm_matrix_free (gal_obs);
+
+  return m2lnL;
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_grid_qag (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  const gdouble tol = TEST_NC_DRS_TOL * test->ngal;
+  gdouble m2lnL_qag, m2lnL_grid;
+
+  ncm_data_m2lnL_val (NCM_DATA (test->drs), test->mset, &m2lnL_qag);
+
+  nc_data_reduced_shear_cluster_mass_set_z_grid_len (test->drs, TEST_NC_DRS_Z_GRID_LEN);
+  g_assert_cmpuint (nc_data_reduced_shear_cluster_mass_get_z_grid_len (test->drs), ==, TEST_NC_DRS_Z_GRID_LEN);
+  ncm_data_m2lnL_val (NCM_DATA (test->drs), test->mset, &m2lnL_grid);
+
+  /*
+   * The adaptive integration uses the negative beta_s obtained for sources
+   * in front of the cluster, while the grid sets it to zero. Each mode is
+   * compared with the corresponding reference, they coincide when all
+   * distributions lie behind the cluster.
+   */
+  ncm_assert_cmpdouble_e (m2lnL_qag,  ==, _test_nc_data_reduced_shear_cluster_mass_m2lnL_ref (test, FALSE), 0.0, tol);
+  ncm_assert_cmpdouble_e (m2lnL_grid, ==, _test_nc_data_reduced_shear_cluster_mass_m2lnL_ref (test, TRUE),  0.0, tol);
+
+  if (*((const gdouble *) pdata) > test->z_cluster)
+    ncm_assert_cmpdouble_e (m2lnL_grid, ==, m2lnL_qag, 0.0, 2.0 * tol);
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_threaded (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  guint z_grid_len[2] = {0, TEST_NC_DRS_Z_GRID_LEN};
+  guint l;
+
+  for (l = 0; l < 2; l++)
+  {
+    gdouble m2lnL_serial, m2lnL_threaded;
+
+    nc_data_reduced_shear_cluster_mass_set_z_grid_len (test->drs, z_grid_len[l]);
+
+    ncm_func_eval_set_max_threads (1);
+    ncm_data_m2lnL_val (NCM_DATA (test->drs), test->mset, &m2lnL_serial);
+
+    ncm_func_eval_set_max_threads (4);
+    ncm_data_m2lnL_val (NCM_DATA (test->drs), test->mset, &m2lnL_threaded);
+
+    /* Every galaxy term is computed independently and summed in a fixed order. */
+    g_assert_cmpfloat (m2lnL_threaded, ==, m2lnL_serial);
+  }
+
+  ncm_func_eval_set_max_threads (NCM_THREAD_POOL_MAX);
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_empty (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  gdouble m2lnL = 1.0;
+
+  ncm_data_m2lnL_val (NCM_DATA (test->drs), test->mset, &m2lnL);
+  g_assert_cmpfloat (m2lnL, ==, 0.0);
+
+  nc_data_reduced_shear_cluster_mass_set_z_grid_len (test->drs, TEST_NC_DRS_Z_GRID_LEN);
+  ncm_data_m2lnL_val (NCM_DATA (test->drs), test->mset, &m2lnL);
+  g_assert_cmpfloat (m2lnL, ==, 0.0);
+}
@@ -0,0 +1,335 @@
+/***************************************************************************
+ *            test_nc_data_snia_cov.c
+ *
+ *  Sun October 18 14:20:51 2026
+ *  Copyright  2026  agent
+ *  <agent@local>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) agent 2026 <agent@local>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcDataSNIACov
+{
+  NcHICosmo *cosmo;
+  NcDistance *dist;
+  NcSNIADistCov *dcov;
+  NcmMSet *mset;
+  NcDataSNIACov *snia_cov;
+  NcmRNG *rng;
+  guint mu_len;
+} TestNcDataSNIACov;
+
+#define TEST_NC_DATA_SNIA_COV_NDSET 4
+#define TEST_NC_DATA_SNIA_COV_NSYS  5
+#define TEST_NC_DATA_SNIA_COV_RELTOL 1.0e-10
+
+void test_nc_data_snia_cov_new (TestNcDataSNIACov *test, gconstpointer pdata);
+void test_nc_data_snia_cov_free (TestNcDataSNIACov *test, gconstpointer pdata);
+
+void test_nc_data_snia_cov_reuse (TestNcDataSNIACov *test, gconstpointer pdata);
+void test_nc_data_snia_cov_pcg (TestNcDataSNIACov *test, gconstpointer pdata);
+void test_nc_data_snia_cov_pcg_use_norma (TestNcDataSNIACov *test, gconstpointer pdata);
+
+/* Relative size of the step in alpha, beta and sigma_int. */
+static const gdouble test_nc_data_snia_cov_small_step = 1.0e-2;
+static const gdouble test_nc_data_snia_cov_large_step = 1.0;
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/nc/data_snia_cov/reuse", TestNcDataSNIACov, NULL,
+              &test_nc_data_snia_cov_new,
+              &test_nc_data_snia_cov_reuse,
+              &test_nc_data_snia_cov_free);
+  g_test_add ("/nc/data_snia_cov/pcg/small_step", TestNcDataSNIACov, &test_nc_data_snia_cov_small_step,
+              &test_nc_data_snia_cov_new,
+              &test_nc_data_snia_cov_pcg,
+              &test_nc_data_snia_cov_free);
+  g_test_add ("/nc/data_snia_cov/pcg/large_step", TestNcDataSNIACov, &test_nc_data_snia_cov_large_step,
+              &test_nc_data_snia_cov_new,
+              &test_nc_data_snia_cov_pcg,
+              &test_nc_data_snia_cov_free);
+  g_test_add ("/nc/data_snia_cov/pcg/use_norma", TestNcDataSNIACov, &test_nc_data_snia_cov_small_step,
+              &test_nc_data_snia_cov_new,
+              &test_nc_data_snia_cov_pcg_use_norma,
+              &test_nc_data_snia_cov_free);
+
+  g_test_run ();
+}
+
+void
+test_nc_data_snia_cov_new (TestNcDataSNIACov *test, gconstpointer pdata)
+{
+  NcmDataGaussCov *gauss;
+  NcmVector *z_cmb, *z_he, *sigma_z, *mag, *width, *colour, *thirdpar;
+  NcmMatrix *cov_full, *sys;
+  GArray *abs_mag_set;
+  guint tmu_len, i, j, k;
+
+  test->cosmo    = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  test->dist     = nc_distance_new (3.0);
+  test->dcov     = nc_snia_dist_cov_new (test->dist, TEST_NC_DATA_SNIA_COV_NDSET);
+  test->mset     = ncm_mset_new (test->cosmo, test->dcov, NULL);
+  test->rng      = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  test->mu_len   = g_test_rand_int_range (60, 120);
+  test->snia_cov = NC_DATA_SNIA_COV (nc_data_snia_cov_new (FALSE));
+
+  tmu_len = 3 * test->mu_len;
+  gauss   = NCM_DATA_GAUSS_COV (test->snia_cov);
+
+  ncm_data_gauss_cov_set_size (gauss, test->mu_len);
+
+  z_cmb       = ncm_vector_new (test->mu_len);
+  z_he        = ncm_vector_new (test->mu_len);
+  sigma_z     = ncm_vector_new (test->mu_len);
+  mag         = ncm_vector_new (test->mu_len);
+  width       = ncm_vector_new (test->mu_len);
+  colour      = ncm_vector_new (test->mu_len);
+  thirdpar    = ncm_vector_new (test->mu_len);
+  cov_full    = ncm_matrix_new (tmu_len, tmu_len);
+  sys         = ncm_matrix_new (TEST_NC_DATA_SNIA_COV_NSYS, tmu_len);
+  abs_mag_set = g_array_sized_new (FALSE, FALSE, sizeof (guint32), test->mu_len);
+
+  for (i = 0; i < test->mu_len; i++)
+  {
+    const gdouble z   = ncm_rng_uniform_gen (test->rng, 0.01, 1.2);
+    const guint32 set = i % TEST_NC_DATA_SNIA_COV_NDSET;
+
+    ncm_vector_set (z_cmb, i, z);
+    ncm_vector_set (z_he, i, z + ncm_rng_gaussian_gen (test->rng, 0.0, 1.0e-3));
+    ncm_vector_set (sigma_z, i, 1.0e-3);
+    ncm_vector_set (mag, i, 5.0 * log10 (z) + 24.0 + ncm_rng_gaussian_gen (test->rng, 0.0, 0.15));
+    ncm_vector_set (width, i, ncm_rng_gaussian_gen (test->rng, 1.0, 0.1));
+    ncm_vector_set (colour, i, ncm_rng_gaussian_gen (test->rng, 0.0, 0.1));
+    ncm_vector_set (thirdpar, i, ncm_rng_uniform_gen (test->rng, 8.0, 12.0));
+
+    g_array_append_val (abs_mag_set, set);
+  }
+
+  /* Statistical errors in mag, width and colour plus a few fully correlated systematics. */
+  for (k = 0; k < TEST_NC_DATA_SNIA_COV_NSYS; k++)
+  {
+    for (i = 0; i < tmu_len; i++)
+      ncm_matrix_set (sys, k, i, ncm_rng_gaussian_gen (test->rng, 0.0, 0.02));
+  }
+
+  for (i = 0; i < tmu_len; i++)
+  {
+    for (j = i; j < tmu_len; j++)
+    {
+      gdouble cov_ij = 0.0;
+
+      for (k = 0; k < TEST_NC_DATA_SNIA_COV_NSYS; k++)
+        cov_ij += ncm_matrix_get (sys, k, i) * ncm_matrix_get (sys, k, j);
+
+      if (i == j)
+      {
+        const gdouble sigma_i = (i < test->mu_len) ? 0.1 : ((i < 2 * test->mu_len) ? 0.05 : 0.02);
+        cov_ij += sigma_i * sigma_i;
+      }
+
+      ncm_matrix_set (cov_full, i, j, cov_ij);
+      ncm_matrix_set (cov_full, j, i, cov_ij);
+    }
+  }
+
+  nc_data_snia_cov_set_z_cmb (test->snia_cov, z_cmb);
+  nc_data_snia_cov_set_z_he (test->snia_cov, z_he);
+  nc_data_snia_cov_set_sigma_z (test->snia_cov, sigma_z);
+  nc_data_snia_cov_set_mag (test->snia_cov, mag);
+  nc_data_snia_cov_set_width (test->snia_cov, width);
+  nc_data_snia_cov_set_colour (test->snia_cov, colour);
+  nc_data_snia_cov_set_thirdpar (test->snia_cov, thirdpar);
+  nc_data_snia_cov_set_abs_mag_set (test->snia_cov, abs_mag_set);
+  nc_data_snia_cov_set_cov_full (test->snia_cov, cov_full);
+
+  g_assert (NCM_DATA (test->snia_cov)->init);
+
+  ncm_vector_free (z_cmb);
+  ncm_vector_free (z_he);
+  ncm_vector_free (sigma_z);
+  ncm_vector_free (mag);
+  ncm_vector_free (width);
+  ncm_vector_free (colour);
+  ncm_vector_free (thirdpar);
+  ncm_matrix_free (cov_full);
+  ncm_matrix_free (sys);
+  g_array_unref (abs_mag_set);
+}
+
+void
+test_nc_data_snia_cov_free (TestNcDataSNIACov *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (ncm_data_free, NCM_DATA (test->snia_cov));
+  NCM_TEST_FREE (ncm_mset_free, test->mset);
+  NCM_TEST_FREE (nc_snia_dist_cov_free, test->dcov);
+  NCM_TEST_FREE (nc_distance_free, test->dist);
+  NCM_TEST_FREE (nc_hicosmo_free, test->cosmo);
+  NCM_TEST_FREE (ncm_rng_free, test->rng);
+}
+
+static void
+_test_nc_data_snia_cov_step (TestNcDataSNIACov *test, const gdouble step)
+{
+  NcmModel *model = NCM_MODEL (test->dcov);
+  guint i;
+
+  ncm_model_orig_param_set (model, NC_SNIA_DIST_COV_ALPHA, ncm_model_orig_param_get (model, NC_SNIA_DIST_COV_ALPHA) * (1.0 + step));
+  ncm_model_orig_param_set (model, NC_SNIA_DIST_COV_BETA,  ncm_model_orig_param_get (model, NC_SNIA_DIST_COV_BETA)  * (1.0 - step));
+
+  for (i = 0; i < TEST_NC_DATA_SNIA_COV_NDSET; i++)
+  {
+    const gdouble lnsigma_int = ncm_model_orig_vparam_get (model, NC_SNIA_DIST_COV_LNSIGMA_INT, i);
+    ncm_model_orig_vparam_set (model, NC_SNIA_DIST_COV_LNSIGMA_INT, i, lnsigma_int + step);
+  }
+}
+
+static void
+_test_nc_data_snia_cov_assert_cov_params (TestNcDataSNIACov *test)
+{
+  GArray *cov_params = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  guint i;
+
+  nc_snia_dist_cov_get_cov_params (test->dcov, cov_params);
+
+  g_assert_cmpuint (cov_params->len, ==, test->snia_cov->cov_params->len);
+  for (i = 0; i < cov_params->len; i++)
+    g_assert_cmpfloat (g_array_index (cov_params, gdouble, i), ==, g_array_index (test->snia_cov->cov_params, gdouble, i));
+
+  g_array_unref (cov_params);
+}
+
+void
+test_nc_data_snia_cov_reuse (TestNcDataSNIACov *test, gconstpointer pdata)
+{
+  NcmData *data = NCM_DATA (test->snia_cov);
+  gdouble m2lnL_0, m2lnL_1, m2lnL_2;
+
+  ncm_data_m2lnL_val (data, test->mset, &m2lnL_0);
+  _test_nc_data_snia_cov_assert_cov_params (test);
+
+  /* Absolute magnitudes do not enter the covariance, the decomposition is reused. */
+  ncm_model_orig_param_set (NCM_MODEL (test->dcov), NC_SNIA_DIST_COV_M1, NC_SNIA_DIST_COV_DEFAULT_M1 + 0.1);
+  ncm_data_m2lnL_val (data, test->mset, &m2lnL_1);
+  _test_nc_data_snia_cov_assert_cov_params (test);
+
+  g_assert_cmpfloat (m2lnL_1, !=, m2lnL_0);
+
+  /* The reused decomposition must give the same result of a fresh one. */
+  g_array_set_size (test->snia_cov->cov_params, 0);
+  ncm_data_m2lnL_val (data, test->mset, &m2lnL_2);
+  _test_nc_data_snia_cov_assert_cov_params (test);
+
+  ncm_assert_cmpdouble_e (m2lnL_1, ==, m2lnL_2, TEST_NC_DATA_SNIA_COV_RELTOL, 0.0);
+}
+
+void
+test_nc_data_snia_cov_pcg (TestNcDataSNIACov *test, gconstpointer pdata)
+{
+  NcmData *data      = NCM_DATA (test->snia_cov);
+  const gdouble step = *((const gdouble *) pdata);
+  GArray *cov_params_0 = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  gdouble m2lnL_0, m2lnL_pcg, m2lnL_chol, m2lnL_back;
+  gboolean refreshed;
+  guint i;
+
+  nc_data_snia_cov_set_cov_pcg (test->snia_cov, TRUE);
+  g_assert (nc_data_snia_cov_get_cov_pcg (test->snia_cov));
+
+  /* No previous decomposition, the first evaluation is always through Cholesky. */
+  ncm_data_m2lnL_val (data, test->mset, &m2lnL_0);
+  _test_nc_data_snia_cov_assert_cov_params (test);
+  g_array_append_vals (cov_params_0, test->snia_cov->cov_params->data, test->snia_cov->cov_params->len);
+
+  _test_nc_data_snia_cov_step (test, step);
+  ncm_data_m2lnL_val (data, test->mset, &m2lnL_pcg);
+
+  /*
+   * Either PCG converged and cov_params still describes the preconditioner,
+   * or it fell back to Cholesky and cov_params describes the current
+   * covariance.
+   */
+  refreshed = (g_array_index (test->snia_cov->cov_params, gdouble, 0) != g_array_index (cov_params_0, gdouble, 0));
+  if (refreshed)
+    _test_nc_data_snia_cov_assert_cov_params (test);
+  else
+  {
+    for (i = 0; i < cov_params_0->len; i++)
+      g_assert_cmpfloat (g_array_index (test->snia_cov->cov_params, gdouble, i), ==, g_array_index (cov_params_0, gdouble, i));
+  }
+
+  if (step < test_nc_data_snia_cov_large_step)
+    g_assert (!refreshed);
+
+  nc_data_snia_cov_set_cov_pcg (test->snia_cov, FALSE);
+  ncm_data_m2lnL_val (data, test->mset, &m2lnL_chol);
+  _test_nc_data_snia_cov_assert_cov_params (test);
+
+  ncm_assert_cmpdouble_e (m2lnL_pcg, ==, m2lnL_chol, TEST_NC_DATA_SNIA_COV_RELTOL, 0.0);
+
+  /* Going back must not be affected by the PCG evaluation. */
+  ncm_model_orig_param_set (NCM_MODEL (test->dcov), NC_SNIA_DIST_COV_ALPHA, g_array_index (cov_params_0, gdouble, 0));
+  ncm_model_orig_param_set (NCM_MODEL (test->dcov), NC_SNIA_DIST_COV_BETA,  g_array_index (cov_params_0, gdouble, 1));
+  for (i = 0; i < TEST_NC_DATA_SNIA_COV_NDSET; i++)
+    ncm_model_orig_vparam_set (NCM_MODEL (test->dcov), NC_SNIA_DIST_COV_LNSIGMA_INT, i, g_array_index (cov_params_0, gdouble, 5 + i));
+
+  nc_data_snia_cov_set_cov_pcg (test->snia_cov, TRUE);
+  ncm_data_m2lnL_val (data, test->mset, &m2lnL_back);
+
+  ncm_assert_cmpdouble_e (m2lnL_back, ==, m2lnL_0, TEST_NC_DATA_SNIA_COV_RELTOL, 0.0);
+
+  g_array_unref (cov_params_0);
+}
+
+void
+test_nc_data_snia_cov_pcg_use_norma (TestNcDataSNIACov *test, gconstpointer pdata)
+{
+  NcmData *data      = NCM_DATA (test->snia_cov);
+  const gdouble step = *((const gdouble *) pdata);
+  gdouble m2lnL_pcg, m2lnL_chol;
+
+  ncm_data_gauss_cov_use_norma (NCM_DATA_GAUSS_COV (test->snia_cov), TRUE);
+  nc_data_snia_cov_set_cov_pcg (test->snia_cov, TRUE);
+
+  ncm_data_m2lnL_val (data, test->mset, &m2lnL_pcg);
+  _test_nc_data_snia_cov_assert_cov_params (test);
+
+  /* The normalization needs the current decomposition, even for small steps. */
+  _test_nc_data_snia_cov_step (test, step);
+  ncm_data_m2lnL_val (data, test->mset, &m2lnL_pcg);
+  _test_nc_data_snia_cov_assert_cov_params (test);
+
+  nc_data_snia_cov_set_cov_pcg (test->snia_cov, FALSE);
+  g_array_set_size (test->snia_cov->cov_params, 0);
+  ncm_data_m2lnL_val (data, test->mset, &m2lnL_chol);
+
+  ncm_assert_cmpdouble_e (m2lnL_pcg, ==, m2lnL_chol, TEST_NC_DATA_SNIA_COV_RELTOL, 0.0);
+}
@@ -45,6 +45,8 @@ void test_nc_distance_transverse (TestNcDistance *test, gconstpointer pdata);
 void test_nc_distance_angular_diameter (TestNcDistance *test, gconstpointer pdata);
 void test_nc_distance_comoving_z_to_infinity (TestNcDistance *test, gconstpointer pdata);
 void test_nc_distance_transverse_z_to_infinity (TestNcDistance *test, gconstpointer pdata);
+void test_nc_distance_vector (TestNcDistance *test, gconstpointer pdata);
+void test_nc_distance_param_deps (TestNcDistance *test, gconstpointer pdata);
 void test_nc_distance_free (TestNcDistance *test, gconstpointer pdata);
 
 gint
@@ -75,6 +77,14 @@ main (gint argc, gchar *argv[])
               &test_nc_distance_new,
               &test_nc_distance_transverse_z_to_infinity,
               &test_nc_distance_free); 
+  g_test_add ("/nc/distance/vector", TestNcDistance, NULL,
+              &test_nc_distance_new,
+              &test_nc_distance_vector,
+              &test_nc_distance_free); 
+  g_test_add ("/nc/distance/param_deps", TestNcDistance, NULL,
+              &test_nc_distance_new,
+              &test_nc_distance_param_deps,
+              &test_nc_distance_free);
 #endif /* HAVE_GSL_2_2 */
 
   g_test_run ();
@@ -188,3 +198,108 @@ test_nc_distance_transverse_z_to_infinity (TestNcDistance *test, gconstpointer p
   ncm_assert_cmpdouble_e (d3, ==, 1.42928606871, 1.0e-5, 0.0);
 }
 
+void
+test_nc_distance_vector (TestNcDistance *test, gconstpointer pdata)
+{
+  NcHICosmo *cosmo = test->cosmo;
+  NcDistance *dist = test->dist;
+  const guint np   = 200;
+  NcmVector *z     = ncm_vector_new (np);
+  NcmVector *z_he  = ncm_vector_new (np);
+  NcmVector *res   = ncm_vector_new (np);
+  guint i;
+
+  /* Sorted first half and unsorted second half */
+  for (i = 0; i < np; i++)
+  {
+    const gdouble z_i = (i < np / 2) ? 0.01 + 5.0 * i / np : 0.01 + fmod (i * 0.7351, 5.0);
+    ncm_vector_set (z, i, z_i);
+    ncm_vector_set (z_he, i, z_i * 1.001);
+  }
+
+  nc_distance_comoving_vector (dist, cosmo, z, res);
+  for (i = 0; i < np; i++)
+    ncm_assert_cmpdouble_e (ncm_vector_get (res, i), ==, nc_distance_comoving (dist, cosmo, ncm_vector_get (z, i)), 1.0e-15, 0.0);
+
+  nc_distance_dmodulus_vector (dist, cosmo, z, res);
+  for (i = 0; i < np; i++)
+    ncm_assert_cmpdouble_e (ncm_vector_get (res, i), ==, nc_distance_dmodulus (dist, cosmo, ncm_vector_get (z, i)), 1.0e-15, 0.0);
+
+  nc_distance_dmodulus_hef_vector (dist, cosmo, z_he, z, res);
+  for (i = 0; i < np; i++)
+    ncm_assert_cmpdouble_e (ncm_vector_get (res, i), ==, nc_distance_dmodulus_hef (dist, cosmo, ncm_vector_get (z_he, i), ncm_vector_get (z, i)), 1.0e-15, 0.0);
+
+  nc_distance_dilation_scale_vector (dist, cosmo, z, res);
+  for (i = 0; i < np; i++)
+    ncm_assert_cmpdouble_e (ncm_vector_get (res, i), ==, nc_distance_dilation_scale (dist, cosmo, ncm_vector_get (z, i)), 1.0e-15, 0.0);
+
+  ncm_vector_free (z);
+  ncm_vector_free (z_he);
+  ncm_vector_free (res);
+}
+
+void
+test_nc_distance_param_deps (TestNcDistance *test, gconstpointer pdata)
+{
+  NcHICosmo *cosmo  = test->cosmo;
+  NcDistance *dist  = test->dist;
+  NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+  NcDistance *dist_dup;
+  NcDistance *dist_fresh;
+  GVariant *deps;
+
+  /* Without recombination the helium abundance does not enter in the distances. */
+  nc_distance_prepare_if_needed (dist, cosmo);
+  g_assert_cmpuint (ncm_model_ctrl_param_deps_len (dist->ctrl), ==, ncm_model_len (NCM_MODEL (cosmo)) - 1);
+
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_HE_YP, 0.2);
+  g_assert (!ncm_model_ctrl_update (dist->ctrl, NCM_MODEL (cosmo)));
+
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_OMEGA_C, 0.25);
+  g_assert (ncm_model_ctrl_update (dist->ctrl, NCM_MODEL (cosmo)));
+  nc_distance_prepare (dist, cosmo);
+
+  dist_fresh = nc_distance_new (6.0);
+  ncm_assert_cmpdouble_e (nc_distance_comoving (dist, cosmo, test->z2), ==, nc_distance_comoving (dist_fresh, cosmo, test->z2), 1.0e-15, 0.0);
+  nc_distance_free (dist_fresh);
+
+  /* The automatic dependencies are recomputed by each copy. */
+  g_object_get (dist, "cosmo-param-deps", &deps, NULL);
+  g_assert_cmpuint (g_variant_n_children (deps), ==, 0);
+  g_variant_unref (deps);
+
+  dist_dup = NC_DISTANCE (ncm_serialize_dup_obj (ser, G_OBJECT (dist)));
+  g_assert (dist_dup->cosmo_deps_auto);
+  nc_distance_prepare_if_needed (dist_dup, cosmo);
+  g_assert_cmpuint (ncm_model_ctrl_param_deps_len (dist_dup->ctrl), ==, ncm_model_len (NCM_MODEL (cosmo)) - 1);
+  nc_distance_free (dist_dup);
+
+  /* Explicitly cleared dependencies must not turn back into automatic ones. */
+  nc_distance_clear_cosmo_param_deps (dist);
+  dist_dup = NC_DISTANCE (ncm_serialize_dup_obj (ser, G_OBJECT (dist)));
+  g_assert (!dist_dup->cosmo_deps_auto);
+  nc_distance_prepare_if_needed (dist_dup, cosmo);
+  g_assert_cmpuint (ncm_model_ctrl_param_deps_len (dist_dup->ctrl), ==, 0);
+  nc_distance_free (dist_dup);
+
+  /* The declared ones are copied. */
+  nc_distance_add_cosmo_param_dep (dist, NC_HICOSMO_DE_H0);
+  nc_distance_add_cosmo_param_dep (dist, NC_HICOSMO_DE_OMEGA_C);
+  g_assert_cmpuint (ncm_model_ctrl_param_deps_len (dist->ctrl), ==, 2);
+
+  dist_dup = NC_DISTANCE (ncm_serialize_dup_obj (ser, G_OBJECT (dist)));
+  g_assert (!dist_dup->cosmo_deps_auto);
+  g_assert_cmpuint (ncm_model_ctrl_param_deps_len (dist_dup->ctrl), ==, 2);
+
+  nc_distance_prepare_if_needed (dist_dup, cosmo);
+  g_assert_cmpuint (ncm_model_ctrl_param_deps_len (dist_dup->ctrl), ==, 2);
+
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_OMEGA_X, 0.69);
+  g_assert (!ncm_model_ctrl_update (dist_dup->ctrl, NCM_MODEL (cosmo)));
+
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_H0, 71.0);
+  g_assert (ncm_model_ctrl_update (dist_dup->ctrl, NCM_MODEL (cosmo)));
+
+  nc_distance_free (dist_dup);
+  ncm_serialize_free (ser);
+}
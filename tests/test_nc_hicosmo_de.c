@@ -34,9 +34,14 @@ typedef struct _TestNcHICosmoDE
 } TestNcHICosmoDE;
 
 void test_nc_hicosmo_de_xcdm_new (TestNcHICosmoDE *test, gconstpointer pdata);
+void test_nc_hicosmo_de_cpl_new (TestNcHICosmoDE *test, gconstpointer pdata);
+void test_nc_hicosmo_de_jbp_new (TestNcHICosmoDE *test, gconstpointer pdata);
+void test_nc_hicosmo_de_xcdm_massnu_new (TestNcHICosmoDE *test, gconstpointer pdata);
+void test_nc_hicosmo_de_lcdm_new (TestNcHICosmoDE *test, gconstpointer pdata);
 void test_nc_hicosmo_de_free (TestNcHICosmoDE *test, gconstpointer pdata);
 
 void test_nc_hicosmo_de_omega_x2omega_k (TestNcHICosmoDE *test, gconstpointer pdata);
+void test_nc_hicosmo_de_E2_vec (TestNcHICosmoDE *test, gconstpointer pdata);
 
 gint
 main (gint argc, gchar *argv[])
@@ -50,6 +55,31 @@ main (gint argc, gchar *argv[])
               &test_nc_hicosmo_de_omega_x2omega_k,
               &test_nc_hicosmo_de_free);
 
+  g_test_add ("/nc/hicosmo_de/xcdm/E2_vec", TestNcHICosmoDE, NULL,
+              &test_nc_hicosmo_de_xcdm_new,
+              &test_nc_hicosmo_de_E2_vec,
+              &test_nc_hicosmo_de_free);
+
+  g_test_add ("/nc/hicosmo_de/cpl/E2_vec", TestNcHICosmoDE, NULL,
+              &test_nc_hicosmo_de_cpl_new,
+              &test_nc_hicosmo_de_E2_vec,
+              &test_nc_hicosmo_de_free);
+
+  g_test_add ("/nc/hicosmo_de/jbp/E2_vec", TestNcHICosmoDE, NULL,
+              &test_nc_hicosmo_de_jbp_new,
+              &test_nc_hicosmo_de_E2_vec,
+              &test_nc_hicosmo_de_free);
+
+  g_test_add ("/nc/hicosmo_de/xcdm_massnu/E2_vec", TestNcHICosmoDE, NULL,
+              &test_nc_hicosmo_de_xcdm_massnu_new,
+              &test_nc_hicosmo_de_E2_vec,
+              &test_nc_hicosmo_de_free);
+
+  g_test_add ("/nc/hicosmo_de/lcdm/E2_vec", TestNcHICosmoDE, NULL,
+              &test_nc_hicosmo_de_lcdm_new,
+              &test_nc_hicosmo_de_E2_vec,
+              &test_nc_hicosmo_de_free);
+
   g_test_run ();
 }
 
@@ -63,6 +93,53 @@ test_nc_hicosmo_de_xcdm_new (TestNcHICosmoDE *test, gconstpointer pdata)
   g_assert (NC_IS_HICOSMO_DE_XCDM (test->cosmo));
 }
 
+void
+test_nc_hicosmo_de_cpl_new (TestNcHICosmoDE *test, gconstpointer pdata)
+{
+  test->cosmo = NC_HICOSMO (nc_hicosmo_de_cpl_new ());
+
+  g_assert (test->cosmo != NULL);
+  g_assert (NC_IS_HICOSMO_DE (test->cosmo));
+  g_assert (NC_IS_HICOSMO_DE_CPL (test->cosmo));
+
+  ncm_model_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_CPL_W1, 0.3);
+}
+
+void
+test_nc_hicosmo_de_jbp_new (TestNcHICosmoDE *test, gconstpointer pdata)
+{
+  test->cosmo = NC_HICOSMO (nc_hicosmo_de_jbp_new ());
+
+  g_assert (test->cosmo != NULL);
+  g_assert (NC_IS_HICOSMO_DE (test->cosmo));
+  g_assert (NC_IS_HICOSMO_DE_JBP (test->cosmo));
+
+  ncm_model_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_JBP_W1, 0.3);
+}
+
+void
+test_nc_hicosmo_de_xcdm_massnu_new (TestNcHICosmoDE *test, gconstpointer pdata)
+{
+  test->cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO_DE, "NcHICosmoDEXcdm{'w' : <-1.1>, 'massnu-length' : <2>, 'massnu' : <[0.06, 0.6]>}");
+
+  g_assert (test->cosmo != NULL);
+  g_assert (NC_IS_HICOSMO_DE_XCDM (test->cosmo));
+  g_assert_cmpuint (ncm_model_vparam_len (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_MASSNU_M), ==, 2);
+}
+
+/* Not a #NcHICosmoDE, but its array methods follow the same contract. */
+void
+test_nc_hicosmo_de_lcdm_new (TestNcHICosmoDE *test, gconstpointer pdata)
+{
+  test->cosmo = NC_HICOSMO (nc_hicosmo_lcdm_new ());
+
+  g_assert (test->cosmo != NULL);
+  g_assert (NC_IS_HICOSMO_LCDM (test->cosmo));
+
+  /* Non-flat, so that the curvature term is exercised. */
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "Omegax", 0.69);
+}
+
 void
 test_nc_hicosmo_de_free (TestNcHICosmoDE *test, gconstpointer pdata)
 {
@@ -99,3 +176,31 @@ test_nc_hicosmo_de_omega_x2omega_k (TestNcHICosmoDE *test, gconstpointer pdata)
     ncm_assert_cmpdouble_e (Omega_k0, ==, 0.0, 1.0e-7, 0.0);
   }
 }
+
+void
+test_nc_hicosmo_de_E2_vec (TestNcHICosmoDE *test, gconstpointer pdata)
+{
+  const guint len = 200;
+  NcmVector *z      = ncm_vector_new (len);
+  NcmVector *E2     = ncm_vector_new (len);
+  NcmVector *dE2_dz = ncm_vector_new (len);
+  guint i;
+
+  for (i = 0; i < len; i++)
+    ncm_vector_set (z, i, g_test_rand_double_range (0.0, 1.0e3));
+
+  nc_hicosmo_E2_vec (test->cosmo, z, E2);
+  nc_hicosmo_dE2_dz_vec (test->cosmo, z, dE2_dz);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble z_i = ncm_vector_get (z, i);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (E2, i), ==, nc_hicosmo_E2 (test->cosmo, z_i), 1.0e-12, 0.0);
+    ncm_assert_cmpdouble_e (ncm_vector_get (dE2_dz, i), ==, nc_hicosmo_dE2_dz (test->cosmo, z_i), 1.0e-12, 0.0);
+  }
+
+  ncm_vector_free (z);
+  ncm_vector_free (E2);
+  ncm_vector_free (dE2_dz);
+}
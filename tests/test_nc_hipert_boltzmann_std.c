@@ -0,0 +1,121 @@
+/***************************************************************************
+ *            test_nc_hipert_boltzmann_std.c
+ *
+ *  Sun October 18 18:02:11 2026
+ *  Copyright  2026  agent
+ *  <agent@local>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) agent 2026 <agent@local>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcHIPertBoltzmannStd
+{
+  NcHIPertBoltzmannStd *pbs;
+  NcHICosmo *cosmo;
+  NcmVector *k;
+  guint sys_size;
+} TestNcHIPertBoltzmannStd;
+
+void test_nc_hipert_boltzmann_std_new (TestNcHIPertBoltzmannStd *test, gconstpointer pdata);
+void test_nc_hipert_boltzmann_std_free (TestNcHIPertBoltzmannStd *test, gconstpointer pdata);
+
+void test_nc_hipert_boltzmann_std_evol_modes_threads (TestNcHIPertBoltzmannStd *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/nc/hipert/boltzmann_std/evol_modes/threads", TestNcHIPertBoltzmannStd, NULL,
+              &test_nc_hipert_boltzmann_std_new,
+              &test_nc_hipert_boltzmann_std_evol_modes_threads,
+              &test_nc_hipert_boltzmann_std_free);
+
+  g_test_run ();
+}
+
+void
+test_nc_hipert_boltzmann_std_new (TestNcHIPertBoltzmannStd *test, gconstpointer pdata)
+{
+  NcRecomb *recomb = NC_RECOMB (nc_recomb_seager_new ());
+  const guint nk   = g_test_rand_int_range (5, 10);
+  guint i;
+
+  test->cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  test->pbs   = nc_hipert_boltzmann_std_new (recomb, 16);
+  test->k     = ncm_vector_new (nk);
+
+  /* Stops before the end of recombination to keep the test short. */
+  NC_HIPERT_BOLTZMANN (test->pbs)->lambdaf = NC_HIPERT_BOLTZMANN_X2LAMBDA (1.0e3);
+
+  for (i = 0; i < nk; i++)
+    ncm_vector_set (test->k, i, exp (log (1.0) + log (100.0) * i / (nk - 1.0)));
+
+  g_object_get (test->pbs, "sys-size", &test->sys_size, NULL);
+  g_assert_cmpuint (test->sys_size, >, 0);
+
+  nc_recomb_free (recomb);
+}
+
+void
+test_nc_hipert_boltzmann_std_free (TestNcHIPertBoltzmannStd *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (nc_hipert_boltzmann_free, NC_HIPERT_BOLTZMANN (test->pbs));
+  NCM_TEST_FREE (nc_hicosmo_free, test->cosmo);
+  ncm_vector_free (test->k);
+}
+
+void
+test_nc_hipert_boltzmann_std_evol_modes_threads (TestNcHIPertBoltzmannStd *test, gconstpointer pdata)
+{
+  const guint nk             = ncm_vector_len (test->k);
+  NcmMatrix *modes_serial    = ncm_matrix_new (nk, test->sys_size);
+  NcmMatrix *modes_threaded  = ncm_matrix_new (nk, test->sys_size);
+  guint i, j;
+
+  ncm_func_eval_set_max_threads (1);
+  nc_hipert_boltzmann_std_evol_modes (test->pbs, test->cosmo, test->k, modes_serial);
+
+  ncm_func_eval_set_max_threads (4);
+  nc_hipert_boltzmann_std_evol_modes (test->pbs, test->cosmo, test->k, modes_threaded);
+
+  ncm_func_eval_set_max_threads (NCM_THREAD_POOL_MAX);
+
+  /* Each mode is integrated from its own initial conditions, the results must agree bit for bit. */
+  for (i = 0; i < nk; i++)
+  {
+    g_assert (gsl_finite (ncm_matrix_get (modes_serial, i, 0)));
+
+    for (j = 0; j < test->sys_size; j++)
+      g_assert_cmpfloat (ncm_matrix_get (modes_serial, i, j), ==, ncm_matrix_get (modes_threaded, i, j));
+  }
+
+  ncm_matrix_free (modes_serial);
+  ncm_matrix_free (modes_threaded);
+}
@@ -31,6 +31,7 @@
 void test_nc_recomb_seager_new (void);
 void test_nc_recomb_seager_wmap_zstar (void);
 void test_nc_recomb_seager_Xe_ini (void);
+void test_nc_recomb_seager_cache (void);
 
 gint
 main (gint argc, gchar *argv[])
@@ -42,6 +43,7 @@ main (gint argc, gchar *argv[])
   g_test_add_func ("/nc/recomb/seager/new", &test_nc_recomb_seager_new);
   g_test_add_func ("/nc/recomb/seager/wmap/zstar", &test_nc_recomb_seager_wmap_zstar);
   g_test_add_func ("/nc/recomb/seager/wmap/Xe_ini", &test_nc_recomb_seager_Xe_ini);
+  g_test_add_func ("/nc/recomb/seager/wmap/cache", &test_nc_recomb_seager_cache);
 
   g_test_run ();
 }
@@ -125,3 +127,65 @@ test_nc_recomb_seager_Xe_ini (void)
   nc_hicosmo_free (cosmo);
   nc_recomb_free (recomb);
 }
+
+void 
+test_nc_recomb_seager_cache (void)
+{
+  NcRecombSeager *recomb_seager = nc_recomb_seager_new ();
+  NcRecomb *recomb              = NC_RECOMB (recomb_seager);
+  NcRecomb *recomb_nc           = NC_RECOMB (nc_recomb_seager_new ());
+  NcHICosmo *cosmo              = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  gulong hits, misses;
+  gdouble zstar0, T_gamma0;
+
+  nc_hicosmo_de_set_wmap5_params (NC_HICOSMO_DE (cosmo));
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_XCDM_W,  -1.0);
+  T_gamma0 = ncm_model_orig_param_get (NCM_MODEL (cosmo), NC_HICOSMO_DE_T_GAMMA0);
+
+  nc_recomb_seager_set_cache_size (recomb_seager, 4);
+  nc_recomb_seager_set_cache_reltol (recomb_seager, 1.0e-5);
+
+  nc_recomb_prepare_if_needed (recomb, cosmo);
+  nc_recomb_seager_cache_get_stats (recomb_seager, &hits, &misses);
+  g_assert_cmpuint (hits, ==, 0);
+  g_assert_cmpuint (misses, ==, 1);
+
+  zstar0 = nc_recomb_get_tau_z (recomb, cosmo);
+  ncm_assert_cmpdouble_e (zstar0, ==, 1088.76, 1e-4, 0.0);
+
+  /* Late-time parameter: H(z >= 200) changes below the tolerance. */
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_XCDM_W,  -0.9);
+  nc_recomb_prepare_if_needed (recomb, cosmo);
+  nc_recomb_prepare_if_needed (recomb_nc, cosmo);
+  nc_recomb_seager_cache_get_stats (recomb_seager, &hits, &misses);
+  g_assert_cmpuint (hits, ==, 1);
+  g_assert_cmpuint (misses, ==, 1);
+
+  ncm_assert_cmpdouble_e (nc_recomb_get_tau_z (recomb, cosmo), ==, nc_recomb_get_tau_z (recomb_nc, cosmo), 1e-6, 0.0);
+  ncm_assert_cmpdouble_e (nc_recomb_Xe (recomb, cosmo, -log (1.0 + 500.0)), ==, nc_recomb_Xe (recomb_nc, cosmo, -log (1.0 + 500.0)), 1e-6, 0.0);
+
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_T_GAMMA0,  2.2250);
+  nc_recomb_prepare_if_needed (recomb, cosmo);
+  nc_recomb_seager_cache_get_stats (recomb_seager, &hits, &misses);
+  g_assert_cmpuint (hits, ==, 1);
+  g_assert_cmpuint (misses, ==, 2);
+  ncm_assert_cmpdouble_e (nc_recomb_get_tau_z (recomb, cosmo), ==, 1325.06, 1e-4, 0.0);
+
+  /* Back to the first point, the cached history must reproduce it exactly. */
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_T_GAMMA0,  T_gamma0);
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_XCDM_W,  -1.0);
+  nc_recomb_prepare_if_needed (recomb, cosmo);
+  nc_recomb_seager_cache_get_stats (recomb_seager, &hits, &misses);
+  g_assert_cmpuint (hits, ==, 2);
+  g_assert_cmpuint (misses, ==, 2);
+  ncm_assert_cmpdouble (nc_recomb_get_tau_z (recomb, cosmo), ==, zstar0);
+
+  nc_recomb_seager_cache_reset_stats (recomb_seager);
+  nc_recomb_seager_cache_get_stats (recomb_seager, &hits, &misses);
+  g_assert_cmpuint (hits, ==, 0);
+  g_assert_cmpuint (misses, ==, 0);
+
+  nc_hicosmo_free (cosmo);
+  nc_recomb_free (recomb_nc);
+  nc_recomb_free (recomb);
+}
@@ -42,6 +42,8 @@ void test_ncm_data_gauss_cov_test_new (TestNcmDataGaussCovTest *test, gconstpoin
 void test_ncm_data_gauss_cov_test_free (TestNcmDataGaussCovTest *test, gconstpointer pdata);
 void test_ncm_data_gauss_cov_test_sanity (TestNcmDataGaussCovTest *test, gconstpointer pdata);
 void test_ncm_data_gauss_cov_test_resample (TestNcmDataGaussCovTest *test, gconstpointer pdata);
+void test_ncm_data_gauss_cov_test_resample_batch (TestNcmDataGaussCovTest *test, gconstpointer pdata);
+void test_ncm_data_gauss_cov_test_profile (TestNcmDataGaussCovTest *test, gconstpointer pdata);
 
 gint
 main (gint argc, gchar *argv[])
@@ -60,6 +62,16 @@ main (gint argc, gchar *argv[])
               &test_ncm_data_gauss_cov_test_resample,
               &test_ncm_data_gauss_cov_test_free);
 
+  g_test_add ("/ncm/data_gauss_cov_test/resample/batch", TestNcmDataGaussCovTest, NULL,
+              &test_ncm_data_gauss_cov_test_new,
+              &test_ncm_data_gauss_cov_test_resample_batch,
+              &test_ncm_data_gauss_cov_test_free);
+
+  g_test_add ("/ncm/data_gauss_cov_test/profile", TestNcmDataGaussCovTest, NULL,
+              &test_ncm_data_gauss_cov_test_new,
+              &test_ncm_data_gauss_cov_test_profile,
+              &test_ncm_data_gauss_cov_test_free);
+
   g_test_run ();
 }
 
@@ -160,3 +172,91 @@ test_ncm_data_gauss_cov_test_resample (TestNcmDataGaussCovTest *test, gconstpoin
   ncm_stats_vec_clear (&stat);
   ncm_vector_clear (&mean);
 }
+
+void
+test_ncm_data_gauss_cov_test_resample_batch (TestNcmDataGaussCovTest *test, gconstpointer pdata)
+{
+  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (test->data);
+  const gulong seed      = g_test_rand_int ();
+  const guint nreal      = 100;
+  NcmRNG *rng            = ncm_rng_seeded_new (NULL, seed);
+  NcmRNG *rng_batch      = ncm_rng_seeded_new (NULL, seed);
+  NcmMatrix *y_batch     = ncm_matrix_new (nreal, gauss->np);
+  NcmVector *y_k         = ncm_vector_new (gauss->np);
+  guint i, k;
+
+  g_assert (ncm_data_gauss_cov_has_resample_batch (gauss));
+
+  ncm_data_gauss_cov_resample_batch (gauss, NULL, rng_batch, y_batch);
+
+  for (k = 0; k < nreal; k++)
+  {
+    ncm_data_resample (test->data, NULL, rng);
+    ncm_vector_memcpy (y_k, gauss->y);
+
+    ncm_data_gauss_cov_set_realization (gauss, y_batch, k);
+    g_assert (test->data->init);
+
+    for (i = 0; i < gauss->np; i++)
+    {
+      ncm_assert_cmpdouble_e (ncm_vector_get (gauss->y, i), ==, ncm_vector_get (y_k, i), 1.0e-12, 1.0e-14);
+    }
+  }
+
+  ncm_vector_free (y_k);
+  ncm_matrix_free (y_batch);
+  ncm_rng_free (rng);
+  ncm_rng_free (rng_batch);
+}
+
+void
+test_ncm_data_gauss_cov_test_profile (TestNcmDataGaussCovTest *test, gconstpointer pdata)
+{
+  NcmDataset *dset  = ncm_dataset_new ();
+  NcmRNG *rng       = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  const guint ncall = 10;
+  gulong prepare_ncalls, m2lnL_ncalls;
+  gdouble prepare_time, m2lnL_time;
+  guint i;
+
+  ncm_data_resample (test->data, NULL, rng);
+
+  ncm_dataset_append_data (dset, test->data);
+
+  for (i = 0; i < ncall; i++)
+  {
+    gdouble m2lnL;
+    ncm_dataset_m2lnL_val (dset, NULL, &m2lnL);
+  }
+
+  ncm_data_profile_get (test->data, &prepare_ncalls, &prepare_time, &m2lnL_ncalls, &m2lnL_time);
+  g_assert_cmpuint (m2lnL_ncalls, ==, 0);
+  ncm_assert_cmpdouble (m2lnL_time, ==, 0.0);
+
+  ncm_dataset_set_profile (dset, TRUE);
+  g_assert (ncm_data_get_profile (test->data));
+
+  for (i = 0; i < ncall; i++)
+  {
+    gdouble m2lnL;
+    ncm_dataset_m2lnL_val (dset, NULL, &m2lnL);
+  }
+
+  ncm_data_profile_get (test->data, &prepare_ncalls, &prepare_time, &m2lnL_ncalls, &m2lnL_time);
+  g_assert_cmpuint (m2lnL_ncalls, ==, ncall);
+  g_assert_cmpuint (prepare_ncalls, <=, ncall);
+  ncm_assert_cmpdouble (m2lnL_time, >=, 0.0);
+  ncm_assert_cmpdouble (prepare_time, >=, 0.0);
+  ncm_assert_cmpdouble (ncm_dataset_profile_total (dset), ==, prepare_time + m2lnL_time);
+
+  ncm_dataset_profile_reset (dset);
+  ncm_data_profile_get (test->data, &prepare_ncalls, &prepare_time, &m2lnL_ncalls, &m2lnL_time);
+  g_assert_cmpuint (m2lnL_ncalls, ==, 0);
+  g_assert_cmpuint (prepare_ncalls, ==, 0);
+
+  ncm_dataset_set_profile (dset, FALSE);
+  g_assert (!ncm_data_get_profile (test->data));
+
+  ncm_rng_free (rng);
+  ncm_dataset_free (dset);
+}
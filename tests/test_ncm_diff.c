@@ -84,6 +84,9 @@ void test_ncm_diff_rf_d1_N_to_M_all (TestNcmDiff *test, gconstpointer pdata);
 void test_ncm_diff_rc_d1_N_to_M_all (TestNcmDiff *test, gconstpointer pdata);
 void test_ncm_diff_rc_d2_N_to_M_all (TestNcmDiff *test, gconstpointer pdata);
 
+void test_ncm_diff_N_to_M_batch (TestNcmDiff *test, gconstpointer pdata);
+void test_ncm_diff_Hessian_N_to_1_batch (TestNcmDiff *test, gconstpointer pdata);
+
 void test_ncm_diff_traps (TestNcmDiff *test, gconstpointer pdata);
 void test_ncm_diff_invalid_st (TestNcmDiff *test, gconstpointer pdata);
 
@@ -251,6 +254,16 @@ main (gint argc, gchar *argv[])
               &test_ncm_diff_rc_d2_N_to_M_all,
               &test_ncm_diff_free);
 
+  g_test_add ("/ncm/diff/N_to_M/batch", TestNcmDiff, NULL,
+              &test_ncm_diff_new,
+              &test_ncm_diff_N_to_M_batch,
+              &test_ncm_diff_free);
+
+  g_test_add ("/ncm/diff/rf/Hessian/N_to_1/batch", TestNcmDiff, NULL,
+              &test_ncm_diff_new,
+              &test_ncm_diff_Hessian_N_to_1_batch,
+              &test_ncm_diff_free);
+
   g_test_add ("/ncm/diff/traps", TestNcmDiff, NULL,
               &test_ncm_diff_new,
               &test_ncm_diff_traps,
@@ -664,6 +677,28 @@ _test_ncm_diff_N_to_M_all (NcmVector *x, NcmVector *y, gpointer userdata)
   }
 }
 
+static void
+_test_ncm_diff_N_to_M_all_batch (NcmMatrix *x, NcmMatrix *y, gpointer userdata)
+{
+  guint i;
+
+  g_assert_cmpuint (ncm_matrix_nrows (x), ==, ncm_matrix_nrows (y));
+
+  for (i = 0; i < ncm_matrix_nrows (x); i++)
+  {
+    NcmVector *x_i = ncm_matrix_get_row (x, i);
+    NcmVector *y_i = ncm_matrix_get_row (y, i);
+
+    if (ncm_vector_len (y_i) == 1)
+      ncm_vector_set (y_i, 0, _test_ncm_diff_N_to_1_all (x_i, userdata));
+    else
+      _test_ncm_diff_N_to_M_all (x_i, y_i, userdata);
+
+    ncm_vector_free (x_i);
+    ncm_vector_free (y_i);
+  }
+}
+
 static GArray *
 _test_ncm_diff_N_to_M_dall (GArray *x_a, gpointer userdata)
 {
@@ -1718,6 +1753,136 @@ test_ncm_diff_rc_d2_N_to_M_all (TestNcmDiff *test, gconstpointer pdata)
   g_array_unref (x_a);
 }
 
+static void
+_test_ncm_diff_cmp_array (GArray *a1, GArray *a2)
+{
+  guint j;
+
+  g_assert_cmpuint (a1->len, ==, a2->len);
+  for (j = 0; j < a1->len; j++)
+    g_assert_cmpfloat (g_array_index (a1, gdouble, j), ==, g_array_index (a2, gdouble, j));
+}
+
+void
+test_ncm_diff_N_to_M_batch (TestNcmDiff *test, gconstpointer pdata)
+{
+  NcmDiff *diff = test->diff;
+  GArray *x_a   = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  const guint dim = 3;
+  guint ntests  = 100;
+  guint i;
+
+  g_array_set_size (x_a, 3);
+  
+  for (i = 0; i < ntests; i++)
+  {
+    gdouble w[3] = 
+    {
+      g_test_rand_double_range (-100.0,       100.0),
+      g_test_rand_double_range ( -0.99,         0.99),
+      g_test_rand_double_range ( -0.5 * M_PI,   0.5 * M_PI)
+    };
+
+    g_array_index (x_a, gdouble, 0) = g_test_rand_double_range (-10.0, 10.0);
+    g_array_index (x_a, gdouble, 1) = g_test_rand_double_range (-10.0, 10.0);
+    g_array_index (x_a, gdouble, 2) = g_test_rand_double_range (-10.0, 10.0);
+
+    {
+      GArray *err_a = NULL, *err_b_a = NULL, *err_t_a = NULL;
+      GArray *df_a, *df_b_a, *df_t_a;
+
+      ncm_diff_set_nthreads (diff, 0);
+      df_a   = ncm_diff_rf_d1_N_to_M (diff, x_a, dim, &_test_ncm_diff_N_to_M_all, w, &err_a);
+      df_b_a = ncm_diff_rf_d1_N_to_M_batch (diff, x_a, dim, &_test_ncm_diff_N_to_M_all_batch, w, &err_b_a);
+      ncm_diff_set_nthreads (diff, 4);
+      df_t_a = ncm_diff_rf_d1_N_to_M (diff, x_a, dim, &_test_ncm_diff_N_to_M_all, w, &err_t_a);
+
+      _test_ncm_diff_cmp_array (df_a, df_b_a);
+      _test_ncm_diff_cmp_array (df_a, df_t_a);
+      _test_ncm_diff_cmp_array (err_a, err_b_a);
+      _test_ncm_diff_cmp_array (err_a, err_t_a);
+
+      g_array_unref (df_a);
+      g_array_unref (df_b_a);
+      g_array_unref (df_t_a);
+      g_array_unref (err_a);
+      g_array_unref (err_b_a);
+      g_array_unref (err_t_a);
+    }
+
+    {
+      GArray *df_a, *df_b_a;
+
+      ncm_diff_set_nthreads (diff, 0);
+      df_a   = ncm_diff_rc_d1_N_to_M (diff, x_a, dim, &_test_ncm_diff_N_to_M_all, w, NULL);
+      df_b_a = ncm_diff_rc_d1_N_to_M_batch (diff, x_a, dim, &_test_ncm_diff_N_to_M_all_batch, w, NULL);
+
+      _test_ncm_diff_cmp_array (df_a, df_b_a);
+
+      g_array_unref (df_a);
+      g_array_unref (df_b_a);
+
+      df_a   = ncm_diff_rc_d2_N_to_M (diff, x_a, dim, &_test_ncm_diff_N_to_M_all, w, NULL);
+      df_b_a = ncm_diff_rc_d2_N_to_M_batch (diff, x_a, dim, &_test_ncm_diff_N_to_M_all_batch, w, NULL);
+
+      _test_ncm_diff_cmp_array (df_a, df_b_a);
+
+      g_array_unref (df_a);
+      g_array_unref (df_b_a);
+    }
+  }
+  g_array_unref (x_a);
+}
+
+void
+test_ncm_diff_Hessian_N_to_1_batch (TestNcmDiff *test, gconstpointer pdata)
+{
+  NcmDiff *diff = test->diff;
+  GArray *x_a   = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  guint ntests  = 100;
+  guint i;
+
+  g_array_set_size (x_a, 3);
+  
+  for (i = 0; i < ntests; i++)
+  {
+    gdouble w[3] = 
+    {
+      g_test_rand_double_range (-100.0,       100.0),
+      g_test_rand_double_range ( -0.99,         0.99),
+      g_test_rand_double_range ( -0.5 * M_PI,   0.5 * M_PI)
+    };
+
+    g_array_index (x_a, gdouble, 0) = g_test_rand_double_range (-10.0, 10.0);
+    g_array_index (x_a, gdouble, 1) = g_test_rand_double_range (-10.0, 10.0);
+    g_array_index (x_a, gdouble, 2) = g_test_rand_double_range (-10.0, 10.0);
+
+    {
+      GArray *err_a = NULL, *err_b_a = NULL, *err_t_a = NULL;
+      GArray *df_a, *df_b_a, *df_t_a;
+
+      ncm_diff_set_nthreads (diff, 0);
+      df_a   = ncm_diff_rf_Hessian_N_to_1 (diff, x_a, &_test_ncm_diff_N_to_1_all, w, &err_a);
+      df_b_a = ncm_diff_rf_Hessian_N_to_1_batch (diff, x_a, &_test_ncm_diff_N_to_M_all_batch, w, &err_b_a);
+      ncm_diff_set_nthreads (diff, 4);
+      df_t_a = ncm_diff_rf_Hessian_N_to_1 (diff, x_a, &_test_ncm_diff_N_to_1_all, w, &err_t_a);
+
+      _test_ncm_diff_cmp_array (df_a, df_b_a);
+      _test_ncm_diff_cmp_array (df_a, df_t_a);
+      _test_ncm_diff_cmp_array (err_a, err_b_a);
+      _test_ncm_diff_cmp_array (err_a, err_t_a);
+
+      g_array_unref (df_a);
+      g_array_unref (df_b_a);
+      g_array_unref (df_t_a);
+      g_array_unref (err_a);
+      g_array_unref (err_b_a);
+      g_array_unref (err_t_a);
+    }
+  }
+  g_array_unref (x_a);
+}
+
 void
 test_ncm_diff_traps (TestNcmDiff *test, gconstpointer pdata)
 {
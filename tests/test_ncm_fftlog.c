@@ -58,6 +58,7 @@ void test_ncm_fftlog_sbessel_j_new (TestNcmFftlog *test, gconstpointer pdata);
 void test_ncm_fftlog_free (TestNcmFftlog *test, gconstpointer pdata);
 
 void test_ncm_fftlog_eval (TestNcmFftlog *test, gconstpointer pdata);
+void test_ncm_fftlog_eval_matrix (TestNcmFftlog *test, gconstpointer pdata);
 
 void test_ncm_fftlog_tophatwin2_traps (TestNcmFftlog *test, gconstpointer pdata);
 void test_ncm_fftlog_gausswin2_traps (TestNcmFftlog *test, gconstpointer pdata);
@@ -78,6 +79,11 @@ main (gint argc, gchar *argv[])
               &test_ncm_fftlog_eval,
               &test_ncm_fftlog_free);
 
+  g_test_add ("/ncm/fftlog/tophatwin2/eval/matrix", TestNcmFftlog, NULL,
+              &test_ncm_fftlog_tophatwin2_new,
+              &test_ncm_fftlog_eval_matrix,
+              &test_ncm_fftlog_free);
+
   g_test_add ("/ncm/fftlog/tophatwin2/traps", TestNcmFftlog, NULL,
               &test_ncm_fftlog_tophatwin2_new,
               &test_ncm_fftlog_tophatwin2_traps,
@@ -88,6 +94,11 @@ main (gint argc, gchar *argv[])
               &test_ncm_fftlog_eval,
               &test_ncm_fftlog_free);
 
+  g_test_add ("/ncm/fftlog/gausswin2/eval/matrix", TestNcmFftlog, NULL,
+              &test_ncm_fftlog_gausswin2_new,
+              &test_ncm_fftlog_eval_matrix,
+              &test_ncm_fftlog_free);
+
   g_test_add ("/ncm/fftlog/gausswin2/traps", TestNcmFftlog, NULL,
               &test_ncm_fftlog_gausswin2_new,
               &test_ncm_fftlog_gausswin2_traps,
@@ -316,6 +327,52 @@ test_ncm_fftlog_eval (TestNcmFftlog *test, gconstpointer pdata)
   }
 }
 
+void
+test_ncm_fftlog_eval_matrix (TestNcmFftlog *test, gconstpointer pdata)
+{
+  NcmFftlog *fftlog   = test->fftlog;
+  const guint nbatch  = g_test_rand_int_range (2, 10);
+  const guint N       = ncm_fftlog_get_size (fftlog);
+  NcmVector *lnk      = ncm_vector_new (N);
+  NcmMatrix *Fk       = ncm_matrix_new (nbatch, N);
+  NcmMatrix *Gr_0     = ncm_matrix_new (nbatch, N);
+  GPtrArray *Gr       = g_ptr_array_new ();
+  const guint nt[2]   = {1, 4};
+  NcmVector *Gr_s;
+  guint b, i, j;
+
+  ncm_fftlog_eval_by_gsl_function (fftlog, &test->Fk);
+  Gr_s = ncm_fftlog_get_vector_Gr (fftlog, 0);
+
+  ncm_fftlog_get_lnk_vector (fftlog, lnk);
+  for (b = 0; b < nbatch; b++)
+  {
+    for (i = 0; i < N; i++)
+      ncm_matrix_set (Fk, b, i, (b + 1.0) * GSL_FN_EVAL (&test->Fk, exp (ncm_vector_get (lnk, i))));
+  }
+
+  g_ptr_array_add (Gr, Gr_0);
+
+  for (j = 0; j < 2; j++)
+  {
+    ncm_fftlog_set_nthreads (fftlog, nt[j]);
+    ncm_matrix_set_zero (Gr_0);
+    ncm_fftlog_eval_by_matrix (fftlog, Fk, Gr);
+
+    for (b = 0; b < nbatch; b++)
+    {
+      for (i = N / 3; i < 2 * (N / 3); i++)
+        ncm_assert_cmpdouble_e (ncm_matrix_get (Gr_0, b, i), ==, (b + 1.0) * ncm_vector_get (Gr_s, i), 1.0e-8, 0.0);
+    }
+  }
+
+  g_ptr_array_unref (Gr);
+  ncm_vector_free (Gr_s);
+  ncm_vector_free (lnk);
+  ncm_matrix_free (Fk);
+  ncm_matrix_free (Gr_0);
+}
+
 void
 test_ncm_fftlog_tophatwin2_traps (TestNcmFftlog *test, gconstpointer pdata)
 {
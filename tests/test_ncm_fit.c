@@ -124,6 +124,8 @@ TESTS_NCM_DECL (gsl, nmsimplex2rand)
 
 void test_ncm_fit_free (TestNcmFit *test, gconstpointer pdata);
 void test_ncm_fit_run (TestNcmFit *test, gconstpointer pdata);
+void test_ncm_fit_numdiff_threads (TestNcmFit *test, gconstpointer pdata);
+void test_ncm_fit_fisher_threads (TestNcmFit *test, gconstpointer pdata);
 void test_ncm_fit_invalid_run (TestNcmFit *test, gconstpointer pdata);
 
 gint
@@ -140,6 +142,16 @@ main (gint argc, gchar *argv[])
 
   TESTS_NCM_ADD (gsl, ls)
 
+  g_test_add ("/ncm/fit/gsl/ls/numdiff/threads", TestNcmFit, NULL,
+              &test_ncm_fit_gsl_ls_new,
+              &test_ncm_fit_numdiff_threads,
+              &test_ncm_fit_free);
+
+  g_test_add ("/ncm/fit/gsl/ls/fisher/threads", TestNcmFit, NULL,
+              &test_ncm_fit_gsl_ls_new,
+              &test_ncm_fit_fisher_threads,
+              &test_ncm_fit_free);
+
   TESTS_NCM_ADD (gsl, mm_conjugate_fr)
   TESTS_NCM_ADD (gsl, mm_conjugate_pr)
   TESTS_NCM_ADD (gsl, mm_vector_bfgs)
@@ -217,6 +229,94 @@ test_ncm_fit_run (TestNcmFit *test, gconstpointer pdata)
   }
 }
 
+void
+test_ncm_fit_numdiff_threads (TestNcmFit *test, gconstpointer pdata)
+{
+  NcmFit *fit            = test->fit;
+  const guint fparam_len = ncm_mset_fparam_len (fit->mset);
+  const guint data_len   = ncm_fit_state_get_data_len (fit->fstate);
+  NcmVector *grad_fo[2], *grad_ce[2];
+  NcmMatrix *J_fo[2], *J_ce[2];
+  gdouble m2lnL;
+  guint k;
+
+  for (k = 0; k < 2; k++)
+  {
+    grad_fo[k] = ncm_vector_new (fparam_len);
+    grad_ce[k] = ncm_vector_new (fparam_len);
+    J_fo[k]    = ncm_matrix_new (data_len, fparam_len);
+    J_ce[k]    = ncm_matrix_new (data_len, fparam_len);
+
+    ncm_fit_set_nthreads (fit, (k == 0) ? 0 : 4);
+    g_assert_cmpuint (ncm_fit_get_nthreads (fit), ==, (k == 0) ? 0 : 4);
+
+    ncm_fit_m2lnL_val_grad_nd_fo (fit, &m2lnL, grad_fo[k]);
+    ncm_fit_m2lnL_grad_nd_ce (fit, grad_ce[k]);
+    ncm_fit_ls_J_nd_fo (fit, J_fo[k]);
+    ncm_fit_ls_J_nd_ce (fit, J_ce[k]);
+  }
+
+  for (k = 0; k < fparam_len; k++)
+  {
+    guint l;
+
+    g_assert_cmpfloat (ncm_vector_get (grad_fo[0], k), ==, ncm_vector_get (grad_fo[1], k));
+    g_assert_cmpfloat (ncm_vector_get (grad_ce[0], k), ==, ncm_vector_get (grad_ce[1], k));
+
+    for (l = 0; l < data_len; l++)
+    {
+      g_assert_cmpfloat (ncm_matrix_get (J_fo[0], l, k), ==, ncm_matrix_get (J_fo[1], l, k));
+      g_assert_cmpfloat (ncm_matrix_get (J_ce[0], l, k), ==, ncm_matrix_get (J_ce[1], l, k));
+    }
+  }
+
+  for (k = 0; k < 2; k++)
+  {
+    ncm_vector_free (grad_fo[k]);
+    ncm_vector_free (grad_ce[k]);
+    ncm_matrix_free (J_fo[k]);
+    ncm_matrix_free (J_ce[k]);
+  }
+}
+
+void
+test_ncm_fit_fisher_threads (TestNcmFit *test, gconstpointer pdata)
+{
+  NcmFit *fit            = test->fit;
+  const guint fparam_len = ncm_mset_fparam_len (fit->mset);
+  const guint ndata      = g_test_rand_int_range (2, 6);
+  NcmMatrix *covar[2];
+  guint k;
+
+  /* The Fisher matrix is split by NcmData, the dataset needs more than one. */
+  for (k = 1; k < ndata; k++)
+  {
+    NcmDataGaussCovMVND *data_mvnd = ncm_data_gauss_cov_mvnd_new_full (fparam_len, 1.0e-2, 1.0e0, 50.0, -1.0, 1.0, test->rng);
+
+    ncm_dataset_append_data (fit->lh->dset, NCM_DATA (data_mvnd));
+    ncm_data_gauss_cov_mvnd_clear (&data_mvnd);
+  }
+
+  for (k = 0; k < 2; k++)
+  {
+    ncm_fit_set_nthreads (fit, (k == 0) ? 0 : 4);
+
+    ncm_fit_fisher (fit);
+    covar[k] = ncm_matrix_dup (fit->fstate->covar);
+  }
+
+  for (k = 0; k < fparam_len; k++)
+  {
+    guint l;
+
+    for (l = 0; l < fparam_len; l++)
+      g_assert_cmpfloat (ncm_matrix_get (covar[0], k, l), ==, ncm_matrix_get (covar[1], k, l));
+  }
+
+  ncm_matrix_free (covar[0]);
+  ncm_matrix_free (covar[1]);
+}
+
 #ifdef NUMCOSMO_HAVE_NLOPT
 TESTS_NCM_TRAPS (nlopt, neldermead)
 TESTS_NCM_TRAPS (nlopt, slsqp)
@@ -28,6 +28,58 @@
 #endif /* HAVE_CONFIG_H */
 #include <numcosmo/numcosmo.h>
 
+/*
+ * A NcmDataGaussCovMVND whose first free parameter is slow: every
+ * evaluation where it changed is counted in test_ncm_data_slow_ncalls and
+ * optionally takes test_ncm_data_slow_usleep microseconds. The counter is
+ * global so that the copies used by the walkers are also accounted for.
+ */
+typedef struct _TestNcmDataSlowClass
+{
+  NcmDataGaussCovMVNDClass parent_class;
+} TestNcmDataSlowClass;
+
+typedef struct _TestNcmDataSlow
+{
+  NcmDataGaussCovMVND parent_instance;
+  gdouble last_x0;
+} TestNcmDataSlow;
+
+GType test_ncm_data_slow_get_type (void) G_GNUC_CONST;
+G_DEFINE_TYPE (TestNcmDataSlow, test_ncm_data_slow, NCM_TYPE_DATA_GAUSS_COV_MVND);
+
+static gint test_ncm_data_slow_ncalls   = 0;
+static gulong test_ncm_data_slow_usleep = 0;
+
+static void
+test_ncm_data_slow_init (TestNcmDataSlow *ds)
+{
+  ds->last_x0 = GSL_NAN;
+}
+
+static void
+_test_ncm_data_slow_prepare (NcmData *data, NcmMSet *mset)
+{
+  TestNcmDataSlow *ds = (TestNcmDataSlow *) data;
+  const gdouble x0    = ncm_mset_fparam_get (mset, 0);
+
+  if (x0 != ds->last_x0)
+  {
+    ds->last_x0 = x0;
+    g_atomic_int_inc (&test_ncm_data_slow_ncalls);
+    if (test_ncm_data_slow_usleep > 0)
+      g_usleep (test_ncm_data_slow_usleep);
+  }
+}
+
+static void
+test_ncm_data_slow_class_init (TestNcmDataSlowClass *klass)
+{
+  NcmDataClass *data_class = NCM_DATA_CLASS (klass);
+
+  data_class->prepare = &_test_ncm_data_slow_prepare;
+}
+
 typedef struct _TestNcmFitESMCMC
 {
   gint dim;
@@ -45,6 +97,9 @@ void test_ncm_fit_esmcmc_traps (TestNcmFitESMCMC *test, gconstpointer pdata);
 
 void test_ncm_fit_esmcmc_free (TestNcmFitESMCMC *test, gconstpointer pdata);
 void test_ncm_fit_esmcmc_run (TestNcmFitESMCMC *test, gconstpointer pdata);
+void test_ncm_fit_esmcmc_run_fast (TestNcmFitESMCMC *test, gconstpointer pdata);
+void test_ncm_fit_esmcmc_run_fast_count (TestNcmFitESMCMC *test, gconstpointer pdata);
+void test_ncm_fit_esmcmc_detect_fast (TestNcmFitESMCMC *test, gconstpointer pdata);
 void test_ncm_fit_esmcmc_run_lre (TestNcmFitESMCMC *test, gconstpointer pdata);
 void test_ncm_fit_esmcmc_run_burnin (TestNcmFitESMCMC *test, gconstpointer pdata);
 void test_ncm_fit_esmcmc_run_restart_from_cat (TestNcmFitESMCMC *test, gconstpointer pdata);
@@ -94,6 +149,21 @@ main (gint argc, gchar *argv[])
               &test_ncm_fit_esmcmc_run,
               &test_ncm_fit_esmcmc_free);
 
+  g_test_add ("/ncm/fit/esmcmc/stretch/run/fast", TestNcmFitESMCMC, NULL,
+              &test_ncm_fit_esmcmc_new_stretch,
+              &test_ncm_fit_esmcmc_run_fast,
+              &test_ncm_fit_esmcmc_free);
+
+  g_test_add ("/ncm/fit/esmcmc/stretch/run/fast/count", TestNcmFitESMCMC, GINT_TO_POINTER (TRUE),
+              &test_ncm_fit_esmcmc_new_stretch,
+              &test_ncm_fit_esmcmc_run_fast_count,
+              &test_ncm_fit_esmcmc_free);
+
+  g_test_add ("/ncm/fit/esmcmc/stretch/detect/fast", TestNcmFitESMCMC, GINT_TO_POINTER (TRUE),
+              &test_ncm_fit_esmcmc_new_stretch,
+              &test_ncm_fit_esmcmc_detect_fast,
+              &test_ncm_fit_esmcmc_free);
+
   g_test_add ("/ncm/fit/esmcmc/stretch/run_lre", TestNcmFitESMCMC, NULL,
               &test_ncm_fit_esmcmc_new_stretch,
               &test_ncm_fit_esmcmc_run_lre,
@@ -186,7 +256,7 @@ test_ncm_fit_esmcmc_new_stretch (TestNcmFitESMCMC *test, gconstpointer pdata)
   const gint dim                      = test->dim = g_test_rand_int_range (2, 10);
   const gint nwalkers                 = 10 * g_test_rand_int_range (2, 5);
   NcmRNG *rng                         = ncm_rng_seeded_new (NULL, g_test_rand_int ());
-  NcmDataGaussCovMVND *data_mvnd      = ncm_data_gauss_cov_mvnd_new_full (dim, 1.0e-2, 5.0e-1, 1.0, 1.0, 2.0, rng);
+  NcmDataGaussCovMVND *data_mvnd      = (pdata == NULL) ? ncm_data_gauss_cov_mvnd_new (dim) : g_object_new (test_ncm_data_slow_get_type (), "n-points", dim, "use-norma", TRUE, NULL);
   NcmModelMVND *model_mvnd            = ncm_model_mvnd_new (dim);
   NcmDataset *dset                    = ncm_dataset_new_list (data_mvnd, NULL);
   NcmLikelihood *lh                   = ncm_likelihood_new (dset);
@@ -199,6 +269,7 @@ test_ncm_fit_esmcmc_new_stretch (TestNcmFitESMCMC *test, gconstpointer pdata)
 
   test->nrun_div = 1;
 
+  ncm_data_gauss_cov_mvnd_gen_cov_mean (data_mvnd, 1.0e-2, 5.0e-1, 1.0, 1.0, 2.0, rng);
   ncm_mset_param_set_all_ftype (mset, NCM_PARAM_TYPE_FREE);
 
   fit = ncm_fit_new (NCM_FIT_TYPE_GSL_MMS, "nmsimplex", lh, mset, NCM_FIT_GRAD_NUMDIFF_CENTRAL);
@@ -288,6 +359,108 @@ test_ncm_fit_esmcmc_run (TestNcmFitESMCMC *test, gconstpointer pdata)
   }
 }
 
+void
+test_ncm_fit_esmcmc_run_fast (TestNcmFitESMCMC *test, gconstpointer pdata)
+{
+  gint i;
+
+  for (i = 1; i < test->dim; i += 2)
+    ncm_fit_esmcmc_add_fast_fparam (test->esmcmc, i);
+
+  /* Adding twice must not duplicate the entry. */
+  ncm_fit_esmcmc_add_fast_fparam (test->esmcmc, 1);
+  g_assert_cmpuint (ncm_fit_esmcmc_fast_fparams_len (test->esmcmc), ==, test->dim / 2);
+
+  ncm_fit_esmcmc_set_fast_steps (test->esmcmc, 3);
+  g_assert_cmpuint (ncm_fit_esmcmc_get_fast_steps (test->esmcmc), ==, 3);
+
+  test_ncm_fit_esmcmc_run (test, pdata);
+}
+
+void
+test_ncm_fit_esmcmc_run_fast_count (TestNcmFitESMCMC *test, gconstpointer pdata)
+{
+  NcmMSetCatalog *mcat    = ncm_fit_esmcmc_peek_catalog (test->esmcmc);
+  const guint nwalkers    = ncm_mset_catalog_nchains (mcat);
+  const guint nsteps      = g_test_rand_int_range (10, 20);
+  const guint fast_steps  = 3;
+  const gulong ntotal     = nsteps * nwalkers;
+  gint nslow_blocked, nslow_unblocked;
+  gulong naccepted;
+  gint i;
+
+  for (i = 1; i < test->dim; i++)
+    ncm_fit_esmcmc_add_fast_fparam (test->esmcmc, i);
+
+  ncm_fit_esmcmc_set_fast_steps (test->esmcmc, fast_steps);
+  ncm_fit_esmcmc_set_auto_trim (test->esmcmc, FALSE);
+
+  /* The counters are reset after the initial points are computed. */
+  ncm_fit_esmcmc_start_run (test->esmcmc);
+  g_atomic_int_set (&test_ncm_data_slow_ncalls, 0);
+
+  ncm_fit_esmcmc_run (test->esmcmc, 1 + nsteps);
+  ncm_fit_esmcmc_end_run (test->esmcmc);
+
+  g_assert_cmpuint (ncm_mset_catalog_len (mcat), ==, ntotal + nwalkers);
+  naccepted     = lround (ncm_fit_esmcmc_get_accept_ratio (test->esmcmc) * ntotal);
+  nslow_blocked = g_atomic_int_get (&test_ncm_data_slow_ncalls);
+
+  /*
+   * Each walker step evaluates the slow part only for the ensemble proposal,
+   * a rejected proposal does not require a new evaluation at the previous
+   * point. The only extra evaluations are made when a walker whose proposals
+   * were all rejected creates its own copy of the likelihood.
+   */
+  g_assert_cmpint (nslow_blocked, >=, naccepted);
+  g_assert_cmpint (nslow_blocked, <=, ntotal + nwalkers);
+
+  /* 
+   * Same number of Metropolis updates per walker, 1 + fast_steps per 
+   * step, now moving all parameters together in the ensemble steps.
+   */
+  ncm_fit_esmcmc_reset (test->esmcmc);
+  ncm_fit_esmcmc_clear_fast_fparams (test->esmcmc);
+  ncm_fit_esmcmc_set_fast_steps (test->esmcmc, 0);
+
+  ncm_fit_esmcmc_start_run (test->esmcmc);
+  g_atomic_int_set (&test_ncm_data_slow_ncalls, 0);
+
+  ncm_fit_esmcmc_run (test->esmcmc, 1 + (1 + fast_steps) * nsteps);
+  ncm_fit_esmcmc_end_run (test->esmcmc);
+
+  nslow_unblocked = g_atomic_int_get (&test_ncm_data_slow_ncalls);
+
+  g_assert_cmpint (nslow_blocked, <, nslow_unblocked);
+}
+
+void
+test_ncm_fit_esmcmc_detect_fast (TestNcmFitESMCMC *test, gconstpointer pdata)
+{
+  NcmMSet *mset     = ncm_fit_peek_mset (test->fit);
+  NcmVector *theta0 = ncm_vector_new (ncm_mset_fparams_len (mset));
+  NcmVector *theta1 = ncm_vector_new (ncm_mset_fparams_len (mset));
+  gint i;
+
+  ncm_mset_fparams_get_vector (mset, theta0);
+
+  test_ncm_data_slow_usleep = 2000;
+  g_assert_cmpuint (ncm_fit_esmcmc_detect_fast_fparams (test->esmcmc, 0.5), ==, test->dim - 1);
+  test_ncm_data_slow_usleep = 0;
+
+  /* The first parameter is the slow one, marking it must add a new entry. */
+  ncm_fit_esmcmc_add_fast_fparam (test->esmcmc, 0);
+  g_assert_cmpuint (ncm_fit_esmcmc_fast_fparams_len (test->esmcmc), ==, test->dim);
+
+  /* The parameters must be restored. */
+  ncm_mset_fparams_get_vector (mset, theta1);
+  for (i = 0; i < test->dim; i++)
+    g_assert_cmpfloat (ncm_vector_get (theta1, i), ==, ncm_vector_get (theta0, i));
+
+  ncm_vector_free (theta0);
+  ncm_vector_free (theta1);
+}
+
 void
 test_ncm_fit_esmcmc_run_lre (TestNcmFitESMCMC *test, gconstpointer pdata)
 {
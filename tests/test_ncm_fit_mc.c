@@ -0,0 +1,203 @@
+/***************************************************************************
+ *            test_ncm_fit_mc.c
+ *
+ *  Sun October 18 16:21:37 2026
+ *  Copyright  2026  agent
+ *  <agent@local>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) agent 2026 <agent@local>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcmFitMC
+{
+  NcmFit *fit;
+  NcmVector *fiduc;
+  gulong seed;
+  guint nrealizations;
+} TestNcmFitMC;
+
+void test_ncm_fit_mc_new (TestNcmFitMC *test, gconstpointer pdata);
+void test_ncm_fit_mc_free (TestNcmFitMC *test, gconstpointer pdata);
+
+void test_ncm_fit_mc_substreams_threads (TestNcmFitMC *test, gconstpointer pdata);
+void test_ncm_fit_mc_profile_threads (TestNcmFitMC *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/fit/mc/substreams/threads", TestNcmFitMC, NULL,
+              &test_ncm_fit_mc_new,
+              &test_ncm_fit_mc_substreams_threads,
+              &test_ncm_fit_mc_free);
+
+  g_test_add ("/ncm/fit/mc/profile/threads", TestNcmFitMC, NULL,
+              &test_ncm_fit_mc_new,
+              &test_ncm_fit_mc_profile_threads,
+              &test_ncm_fit_mc_free);
+
+  g_test_run ();
+}
+
+void
+test_ncm_fit_mc_new (TestNcmFitMC *test, gconstpointer pdata)
+{
+  const gint dim                 = g_test_rand_int_range (2, 5);
+  NcmRNG *rng                    = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmDataGaussCovMVND *data_mvnd = ncm_data_gauss_cov_mvnd_new_full (dim, 1.0e-2, 5.0e-1, 1.0, 1.0, 2.0, rng);
+  NcmModelMVND *model_mvnd       = ncm_model_mvnd_new (dim);
+  NcmDataset *dset               = ncm_dataset_new_list (data_mvnd, NULL);
+  NcmLikelihood *lh              = ncm_likelihood_new (dset);
+  NcmMSet *mset                  = ncm_mset_new (NCM_MODEL (model_mvnd), NULL);
+
+  ncm_mset_param_set_all_ftype (mset, NCM_PARAM_TYPE_FREE);
+
+  test->fit           = ncm_fit_new (NCM_FIT_TYPE_GSL_MMS, "nmsimplex", lh, mset, NCM_FIT_GRAD_NUMDIFF_CENTRAL);
+  test->fiduc         = ncm_vector_new (ncm_mset_total_len (mset));
+  test->seed          = g_test_rand_int ();
+  test->nrealizations = g_test_rand_int_range (20, 50);
+
+  ncm_mset_param_get_vector (mset, test->fiduc);
+
+  ncm_rng_free (rng);
+  ncm_data_gauss_cov_mvnd_clear (&data_mvnd);
+  ncm_model_mvnd_clear (&model_mvnd);
+  ncm_dataset_clear (&dset);
+  ncm_likelihood_clear (&lh);
+  ncm_mset_clear (&mset);
+}
+
+void
+test_ncm_fit_mc_free (TestNcmFitMC *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (ncm_fit_free, test->fit);
+  ncm_vector_free (test->fiduc);
+}
+
+static NcmMSetCatalog *
+_test_ncm_fit_mc_run (TestNcmFitMC *test, guint nthreads)
+{
+  NcmRNG *rng;
+  NcmFitMC *mc;
+  NcmMSetCatalog *mcat;
+
+  /* The run starts from the current parameters, which the previous run changed. */
+  ncm_mset_param_set_vector (test->fit->mset, test->fiduc);
+
+  mc  = ncm_fit_mc_new (test->fit, NCM_FIT_MC_RESAMPLE_FROM_MODEL, NCM_FIT_RUN_MSGS_NONE);
+  rng = ncm_rng_new (NULL);
+
+  /* Same seed in both runs, registering it twice is harmless. */
+  ncm_rng_set_seed (rng, test->seed);
+
+  ncm_fit_mc_set_nthreads (mc, nthreads);
+  ncm_fit_mc_keep_order (mc, TRUE);
+  ncm_fit_mc_set_rng_substreams (mc, TRUE);
+  ncm_fit_mc_set_rng (mc, rng);
+
+  ncm_fit_mc_start_run (mc);
+  ncm_fit_mc_run (mc, test->nrealizations);
+  ncm_fit_mc_end_run (mc);
+
+  mcat = ncm_fit_mc_get_catalog (mc);
+
+  ncm_rng_free (rng);
+  ncm_fit_mc_free (mc);
+
+  return mcat;
+}
+
+void
+test_ncm_fit_mc_substreams_threads (TestNcmFitMC *test, gconstpointer pdata)
+{
+  NcmMSetCatalog *mcat_serial   = _test_ncm_fit_mc_run (test, 1);
+  NcmMSetCatalog *mcat_threaded = _test_ncm_fit_mc_run (test, 3);
+  guint i, j;
+
+  g_assert (ncm_mset_catalog_get_rng_substreams (mcat_serial));
+  g_assert (ncm_mset_catalog_get_rng_substreams (mcat_threaded));
+
+  g_assert_cmpuint (ncm_mset_catalog_len (mcat_serial), ==, test->nrealizations);
+  g_assert_cmpuint (ncm_mset_catalog_len (mcat_threaded), ==, test->nrealizations);
+  g_assert_cmpuint (ncm_mset_catalog_ncols (mcat_serial), ==, ncm_mset_catalog_ncols (mcat_threaded));
+
+  /* Each realization depends only on its index, not on which thread ran it. */
+  for (i = 0; i < test->nrealizations; i++)
+  {
+    NcmVector *row_s = ncm_mset_catalog_peek_row (mcat_serial, i);
+    NcmVector *row_t = ncm_mset_catalog_peek_row (mcat_threaded, i);
+
+    for (j = 0; j < ncm_mset_catalog_ncols (mcat_serial); j++)
+      g_assert_cmpfloat (ncm_vector_get (row_s, j), ==, ncm_vector_get (row_t, j));
+  }
+
+  /* And different indexes give different realizations. */
+  g_assert_cmpfloat (ncm_vector_get (ncm_mset_catalog_peek_row (mcat_serial, 0), 0), !=,
+                     ncm_vector_get (ncm_mset_catalog_peek_row (mcat_serial, 1), 0));
+
+  ncm_mset_catalog_free (mcat_serial);
+  ncm_mset_catalog_free (mcat_threaded);
+}
+
+void
+test_ncm_fit_mc_profile_threads (TestNcmFitMC *test, gconstpointer pdata)
+{
+  NcmLikelihood *lh = test->fit->lh;
+  NcmData *data     = ncm_dataset_peek_data (lh->dset, 0);
+  NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+  gulong prepare_ncalls, m2lnL_ncalls;
+  gdouble prepare_time, m2lnL_time;
+  NcmMSetCatalog *mcat;
+
+  ncm_likelihood_set_profile (lh, TRUE);
+
+  /* The setting must survive the duplication used to create the workers. */
+  {
+    NcmLikelihood *lh_dup = ncm_likelihood_dup (lh, ser);
+
+    g_assert (ncm_likelihood_get_profile (lh_dup));
+    g_assert (ncm_dataset_get_profile (lh_dup->dset));
+    g_assert (ncm_data_get_profile (ncm_dataset_peek_data (lh_dup->dset, 0)));
+
+    ncm_likelihood_free (lh_dup);
+  }
+
+  mcat = _test_ncm_fit_mc_run (test, 3);
+
+  /* Every realization is fitted by a worker copy, at least one evaluation each. */
+  ncm_data_profile_get (data, &prepare_ncalls, &prepare_time, &m2lnL_ncalls, &m2lnL_time);
+
+  g_assert_cmpuint (lh->m2lnL_ncalls, >=, test->nrealizations);
+  g_assert_cmpuint (m2lnL_ncalls, ==, lh->m2lnL_ncalls);
+  g_assert_cmpfloat (m2lnL_time, >, 0.0);
+
+  ncm_mset_catalog_free (mcat);
+  ncm_serialize_free (ser);
+}
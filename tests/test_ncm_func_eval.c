@@ -41,6 +41,7 @@ void test_ncm_func_eval_new (TestNcmSparam *test, gconstpointer pdata);
 void test_ncm_func_eval_free (TestNcmSparam *test, gconstpointer pdata);
 
 void test_ncm_func_eval_run (TestNcmSparam *test, gconstpointer pdata);
+void test_ncm_func_eval_run_ws (TestNcmSparam *test, gconstpointer pdata);
 
 gint
 main (gint argc, gchar *argv[])
@@ -54,6 +55,11 @@ main (gint argc, gchar *argv[])
               &test_ncm_func_eval_run, 
               &test_ncm_func_eval_free);
 
+  g_test_add ("/ncm/func_eval/run/ws", TestNcmSparam, NULL, 
+              &test_ncm_func_eval_new, 
+              &test_ncm_func_eval_run_ws, 
+              &test_ncm_func_eval_free);
+
   g_test_run ();
 }
 
@@ -95,3 +101,42 @@ test_ncm_func_eval_run (TestNcmSparam *test, gconstpointer pdata)
   gdouble res = 0.0;
   ncm_func_eval_threaded_loop_full (test_ncm_func_eval_run_func, 0, test->ntests, &res);
 }
+
+static void 
+test_ncm_func_eval_run_ws_func (glong i, glong f, gpointer data)
+{
+  gint *count = (gint *)data;
+  glong k;
+
+  for (k = i; k < f; k++)
+  {
+    glong j;
+    gdouble part = 0.0;
+
+    /* Uneven cost per index */
+    for (j = 0; j < (k % 17) * 100; j++)
+      part += sin (j * 1.0e-3);
+
+    if (part > -1.0e100)
+      g_atomic_int_inc (&count[k]);
+  }
+}
+
+void
+test_ncm_func_eval_run_ws (TestNcmSparam *test, gconstpointer pdata)
+{
+  gint *count = g_new0 (gint, test->ntests);
+  glong grain;
+
+  for (grain = 0; grain < 4; grain++)
+  {
+    guint k;
+
+    ncm_func_eval_threaded_loop_ws (test_ncm_func_eval_run_ws_func, 0, test->ntests, count, grain);
+
+    for (k = 0; k < test->ntests; k++)
+      g_assert_cmpint (count[k], ==, grain + 1);
+  }
+
+  g_free (count);
+}
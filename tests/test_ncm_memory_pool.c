@@ -0,0 +1,256 @@
+/***************************************************************************
+ *            test_ncm_memory_pool.c
+ *
+ *  Sat October 17 10:12:40 2026
+ *  Copyright  2026  agent
+ *  <agent@local>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) agent 2026 <agent@local>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcmMemoryPool
+{
+  NcmMemoryPool *mp;
+  guint nthreads;
+  guint niter;
+  gint nalloc;
+  GMutex lock;
+  GCond cond;
+  gint ncached;
+  gboolean release;
+} TestNcmMemoryPool;
+
+void test_ncm_memory_pool_new (TestNcmMemoryPool *test, gconstpointer pdata);
+void test_ncm_memory_pool_free (TestNcmMemoryPool *test, gconstpointer pdata);
+
+void test_ncm_memory_pool_get_return (TestNcmMemoryPool *test, gconstpointer pdata);
+void test_ncm_memory_pool_thread_cache_stats (TestNcmMemoryPool *test, gconstpointer pdata);
+void test_ncm_memory_pool_thread_cache_free_first (TestNcmMemoryPool *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/memory_pool/get_return", TestNcmMemoryPool, NULL,
+              &test_ncm_memory_pool_new,
+              &test_ncm_memory_pool_get_return,
+              &test_ncm_memory_pool_free);
+
+  g_test_add ("/ncm/memory_pool/thread_cache/stats", TestNcmMemoryPool, NULL,
+              &test_ncm_memory_pool_new,
+              &test_ncm_memory_pool_thread_cache_stats,
+              &test_ncm_memory_pool_free);
+
+  g_test_add ("/ncm/memory_pool/thread_cache/free_first", TestNcmMemoryPool, NULL,
+              &test_ncm_memory_pool_new,
+              &test_ncm_memory_pool_thread_cache_free_first,
+              &test_ncm_memory_pool_free);
+
+  g_test_run ();
+}
+
+static gpointer
+_test_ncm_memory_pool_alloc (gpointer userdata)
+{
+  TestNcmMemoryPool *test = (TestNcmMemoryPool *) userdata;
+
+  g_atomic_int_inc (&test->nalloc);
+  return g_new0 (gint, 1);
+}
+
+static void
+_test_ncm_memory_pool_slice_free (gpointer p)
+{
+  g_free (p);
+}
+
+void
+test_ncm_memory_pool_new (TestNcmMemoryPool *test, gconstpointer pdata)
+{
+  test->nthreads = g_test_rand_int_range (2, 9);
+  test->niter    = g_test_rand_int_range (10, 100);
+  test->nalloc   = 0;
+  test->ncached  = 0;
+  test->release  = FALSE;
+  test->mp       = ncm_memory_pool_new (&_test_ncm_memory_pool_alloc, test, &_test_ncm_memory_pool_slice_free);
+
+  g_mutex_init (&test->lock);
+  g_cond_init (&test->cond);
+}
+
+void
+test_ncm_memory_pool_free (TestNcmMemoryPool *test, gconstpointer pdata)
+{
+  if (test->mp != NULL)
+    ncm_memory_pool_free (test->mp, TRUE);
+
+  g_mutex_clear (&test->lock);
+  g_cond_clear (&test->cond);
+}
+
+void
+test_ncm_memory_pool_get_return (TestNcmMemoryPool *test, gconstpointer pdata)
+{
+  gpointer *s0 = ncm_memory_pool_get (test->mp);
+  gpointer *s1 = ncm_memory_pool_get (test->mp);
+  gulong n_fast, n_locked, n_contended;
+
+  g_assert (s0 != s1);
+  g_assert_cmpint (test->nalloc, ==, 2);
+
+  ncm_memory_pool_return (s0);
+  ncm_memory_pool_return (s1);
+
+  s0 = ncm_memory_pool_get (test->mp);
+  g_assert_cmpint (test->nalloc, ==, 2);
+  ncm_memory_pool_return (s0);
+
+  ncm_memory_pool_get_stats (test->mp, &n_fast, &n_locked, &n_contended);
+
+  g_assert_cmpuint (n_fast, ==, 0);
+  g_assert_cmpuint (n_locked, ==, 3);
+}
+
+static gpointer
+_test_ncm_memory_pool_thread_cache_worker (gpointer userdata)
+{
+  TestNcmMemoryPool *test = (TestNcmMemoryPool *) userdata;
+  guint i;
+
+  for (i = 0; i < test->niter; i++)
+  {
+    gint **s0 = ncm_memory_pool_get (test->mp);
+    gint **s1 = ncm_memory_pool_get (test->mp);
+
+    /* The nested request must not return the reserved slice. */
+    g_assert (s0 != s1);
+    s0[0][0]++;
+    s1[0][0]++;
+
+    ncm_memory_pool_return (s1);
+    ncm_memory_pool_return (s0);
+  }
+
+  return NULL;
+}
+
+void
+test_ncm_memory_pool_thread_cache_stats (TestNcmMemoryPool *test, gconstpointer pdata)
+{
+  GPtrArray *threads = g_ptr_array_new ();
+  gulong n_fast, n_locked, n_contended;
+  guint i;
+
+  ncm_memory_pool_set_thread_cache (test->mp, TRUE);
+
+  for (i = 0; i < test->nthreads; i++)
+    g_ptr_array_add (threads, g_thread_new ("mp-stats", &_test_ncm_memory_pool_thread_cache_worker, test));
+
+  for (i = 0; i < test->nthreads; i++)
+    g_thread_join (g_ptr_array_index (threads, i));
+
+  g_ptr_array_unref (threads);
+
+  ncm_memory_pool_get_stats (test->mp, &n_fast, &n_locked, &n_contended);
+
+  /*
+   * Each thread reserves its slice in the first request and reuses it
+   * in the remaining (niter - 1) iterations, the nested requests always
+   * lock the pool.
+   */
+  g_assert_cmpuint (n_fast, ==, test->nthreads * (test->niter - 1));
+  g_assert_cmpuint (n_locked, ==, test->nthreads * (test->niter + 1));
+  g_assert_cmpuint (n_contended, <=, n_locked);
+}
+
+static gpointer
+_test_ncm_memory_pool_cache_and_wait (gpointer userdata)
+{
+  TestNcmMemoryPool *test = (TestNcmMemoryPool *) userdata;
+  gint **s0 = ncm_memory_pool_get (test->mp);
+
+  s0[0][0]++;
+  ncm_memory_pool_return (s0);
+
+  g_mutex_lock (&test->lock);
+  test->ncached++;
+  g_cond_broadcast (&test->cond);
+  while (!test->release)
+    g_cond_wait (&test->cond, &test->lock);
+  g_mutex_unlock (&test->lock);
+
+  /* The thread exits holding a reserved slice of an already freed pool. */
+  return NULL;
+}
+
+void
+test_ncm_memory_pool_thread_cache_free_first (TestNcmMemoryPool *test, gconstpointer pdata)
+{
+  GPtrArray *threads = g_ptr_array_new ();
+  guint i;
+
+  ncm_memory_pool_set_thread_cache (test->mp, TRUE);
+
+  /* The calling thread also caches a slice. */
+  ncm_memory_pool_return (ncm_memory_pool_get (test->mp));
+
+  for (i = 0; i < test->nthreads; i++)
+    g_ptr_array_add (threads, g_thread_new ("mp-free", &_test_ncm_memory_pool_cache_and_wait, test));
+
+  g_mutex_lock (&test->lock);
+  while (test->ncached < test->nthreads)
+    g_cond_wait (&test->cond, &test->lock);
+  g_mutex_unlock (&test->lock);
+
+  g_assert_cmpint (test->nalloc, ==, test->nthreads + 1);
+
+  ncm_memory_pool_free (test->mp, TRUE);
+  test->mp = NULL;
+
+  g_mutex_lock (&test->lock);
+  test->release = TRUE;
+  g_cond_broadcast (&test->cond);
+  g_mutex_unlock (&test->lock);
+
+  for (i = 0; i < test->nthreads; i++)
+    g_thread_join (g_ptr_array_index (threads, i));
+
+  g_ptr_array_unref (threads);
+
+  /* A new pool must not pick up the orphaned slices of the old one. */
+  test->mp = ncm_memory_pool_new (&_test_ncm_memory_pool_alloc, test, &_test_ncm_memory_pool_slice_free);
+  ncm_memory_pool_set_thread_cache (test->mp, TRUE);
+  {
+    gint **s0 = ncm_memory_pool_get (test->mp);
+    g_assert_cmpint (s0[0][0], ==, 0);
+    ncm_memory_pool_return (s0);
+  }
+  g_assert_cmpint (test->nalloc, ==, test->nthreads + 2);
+}
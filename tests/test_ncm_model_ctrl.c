@@ -46,6 +46,7 @@ void test_ncm_model_ctrl_free (TestNcmModelCtrl *test, gconstpointer pdata);
 void test_ncm_model_ctrl_model_update (TestNcmModelCtrl *test, gconstpointer pdata);
 void test_ncm_model_ctrl_update (TestNcmModelCtrl *test, gconstpointer pdata);
 void test_ncm_model_ctrl_submodel_update (TestNcmModelCtrl *test, gconstpointer pdata);
+void test_ncm_model_ctrl_param_deps (TestNcmModelCtrl *test, gconstpointer pdata);
 
 void test_ncm_model_ctrl_traps (TestNcmModelCtrl *test, gconstpointer pdata);
 void test_ncm_model_ctrl_invalid_submodel_last_update (TestNcmModelCtrl *test, gconstpointer pdata);
@@ -72,6 +73,11 @@ main (gint argc, gchar *argv[])
               &test_ncm_model_ctrl_submodel_update, 
               &test_ncm_model_ctrl_free);
 
+  g_test_add ("/ncm/model_ctrl/param_deps", TestNcmModelCtrl, NULL, 
+              &test_ncm_model_ctrl_new, 
+              &test_ncm_model_ctrl_param_deps, 
+              &test_ncm_model_ctrl_free);
+
   g_test_add ("/ncm/model_ctrl/traps", TestNcmModelCtrl, NULL,
               &test_ncm_model_ctrl_new,
               &test_ncm_model_ctrl_traps,
@@ -284,6 +290,58 @@ test_ncm_model_ctrl_submodel_update (TestNcmModelCtrl *test, gconstpointer pdata
   }
 }
 
+void
+test_ncm_model_ctrl_param_deps (TestNcmModelCtrl *test, gconstpointer pdata)
+{
+  g_assert_cmpuint (ncm_model_ctrl_param_deps_len (test->ctrl), ==, 0);
+
+  ncm_model_ctrl_add_param_dep (test->ctrl, 0);
+  ncm_model_ctrl_add_param_dep (test->ctrl, 0);
+  g_assert_cmpuint (ncm_model_ctrl_param_deps_len (test->ctrl), ==, 1);
+
+  g_assert (ncm_model_ctrl_update (test->ctrl, test->model));
+  g_assert (!ncm_model_ctrl_update (test->ctrl, test->model));
+
+  /* Changing a parameter outside the dependencies */
+  ncm_model_orig_param_set (test->model, 1, 
+                            ncm_model_orig_param_get (test->model, 1) * 0.999);
+  g_assert (!ncm_model_ctrl_update (test->ctrl, test->model));
+  g_assert (!ncm_model_ctrl_model_last_update (test->ctrl));
+
+  /* Setting the same value again */
+  ncm_model_orig_param_set (test->model, 0, 
+                            ncm_model_orig_param_get (test->model, 0));
+  g_assert (!ncm_model_ctrl_update (test->ctrl, test->model));
+
+  ncm_model_orig_param_set (test->model, 0, 
+                            ncm_model_orig_param_get (test->model, 0) * 0.999);
+  g_assert (ncm_model_ctrl_update (test->ctrl, test->model));
+  g_assert (ncm_model_ctrl_model_last_update (test->ctrl));
+  g_assert (!ncm_model_ctrl_update (test->ctrl, test->model));
+
+  ncm_model_state_mark_outdated (test->model);
+  g_assert (ncm_model_ctrl_update (test->ctrl, test->model));
+  g_assert (!ncm_model_ctrl_update (test->ctrl, test->model));
+
+  /* Submodels are always tracked as a whole */
+  ncm_model_add_submodel (test->model, test->submodel1);
+  g_assert (ncm_model_ctrl_update (test->ctrl, test->model));
+  ncm_model_orig_param_set (test->submodel1, 0, 
+                            ncm_model_orig_param_get (test->submodel1, 0) * 0.999);
+  g_assert (ncm_model_ctrl_update (test->ctrl, test->model));
+  g_assert (!ncm_model_ctrl_model_last_update (test->ctrl));
+  g_assert (ncm_model_ctrl_submodel_last_update (test->ctrl, nc_hiprim_id ()));
+
+  ncm_model_ctrl_clear_param_deps (test->ctrl);
+  g_assert_cmpuint (ncm_model_ctrl_param_deps_len (test->ctrl), ==, 0);
+  g_assert (ncm_model_ctrl_update (test->ctrl, test->model));
+  g_assert (!ncm_model_ctrl_update (test->ctrl, test->model));
+
+  ncm_model_orig_param_set (test->model, 1, 
+                            ncm_model_orig_param_get (test->model, 1) * 0.999);
+  g_assert (ncm_model_ctrl_update (test->ctrl, test->model));
+}
+
 void
 test_ncm_model_ctrl_traps (TestNcmModelCtrl *test, gconstpointer pdata)
 {
@@ -0,0 +1,154 @@
+/***************************************************************************
+ *            test_ncm_mpi_job.c
+ *
+ *  Sun October 18 21:10:37 2026
+ *  Copyright  2026  agent
+ *  <agent@local>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) agent 2026 <agent@local>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+#include <numcosmo/math/ncm_mpi_job_test.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcmMPIJob
+{
+  NcmMPIJobTest *mjt;
+  NcmVector *vec;
+  GPtrArray *input_array;
+  GPtrArray *ret_array;
+  guint *ncalls;
+} TestNcmMPIJob;
+
+void test_ncm_mpi_job_new (TestNcmMPIJob *test, gconstpointer pdata);
+void test_ncm_mpi_job_free (TestNcmMPIJob *test, gconstpointer pdata);
+
+void test_ncm_mpi_job_run_array_async (TestNcmMPIJob *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+#ifdef HAVE_MPI
+  g_test_add ("/ncm/mpi_job/run_array_async", TestNcmMPIJob, NULL,
+              &test_ncm_mpi_job_new,
+              &test_ncm_mpi_job_run_array_async,
+              &test_ncm_mpi_job_free);
+#endif /* HAVE_MPI */
+
+  g_test_run ();
+}
+
+void
+test_ncm_mpi_job_new (TestNcmMPIJob *test, gconstpointer pdata)
+{
+  NcmMPIJob *mpi_job       = NULL;
+  NcmSerialize *ser        = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+  NcmRNG *rng              = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  const guint nslaves      = ncm_cfg_mpi_nslaves ();
+  const guint max_inflight = 2;
+  guint njobs, i;
+
+  test->mjt = ncm_mpi_job_test_new ();
+  mpi_job   = NCM_MPI_JOB (test->mjt);
+
+  ncm_mpi_job_set_max_inflight (mpi_job, max_inflight);
+
+  /* More jobs than slots, every slave must receive new jobs after its first returns. */
+  njobs     = 2 * nslaves * max_inflight + 3;
+  test->vec = ncm_vector_new (njobs);
+
+  for (i = 0; i < njobs; i++)
+    ncm_vector_set (test->vec, i, ncm_rng_gaussian_gen (rng, 0.0, 1.0));
+
+  g_object_set (test->mjt, "vector", test->vec, NULL);
+
+  test->input_array = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_vector_free);
+  test->ret_array   = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_vector_free);
+  test->ncalls      = g_new0 (guint, njobs);
+
+  for (i = 0; i < njobs; i++)
+  {
+    NcmVector *input = ncm_mpi_job_create_input (mpi_job);
+    NcmVector *ret   = ncm_mpi_job_create_return (mpi_job);
+
+    ncm_vector_set (input, 0, i);
+    ncm_vector_set (ret, 0, GSL_NAN);
+
+    g_ptr_array_add (test->input_array, input);
+    g_ptr_array_add (test->ret_array, ret);
+  }
+
+  if (nslaves > 0)
+    ncm_mpi_job_init_all_slaves (mpi_job, ser);
+
+  ncm_serialize_free (ser);
+  ncm_rng_free (rng);
+}
+
+void
+test_ncm_mpi_job_free (TestNcmMPIJob *test, gconstpointer pdata)
+{
+  ncm_mpi_job_free_all_slaves (NCM_MPI_JOB (test->mjt));
+
+  NCM_TEST_FREE (ncm_mpi_job_test_free, test->mjt);
+  ncm_vector_free (test->vec);
+  g_ptr_array_unref (test->input_array);
+  g_ptr_array_unref (test->ret_array);
+  g_free (test->ncalls);
+}
+
+static void
+_test_ncm_mpi_job_count (NcmMPIJob *mpi_job, gpointer input, gpointer ret, const guint index, gpointer user_data)
+{
+  TestNcmMPIJob *test = user_data;
+
+  g_assert_cmpuint (index, <, test->input_array->len);
+  g_assert (g_ptr_array_index (test->input_array, index) == input);
+  g_assert (g_ptr_array_index (test->ret_array, index) == ret);
+
+  test->ncalls[index]++;
+}
+
+void
+test_ncm_mpi_job_run_array_async (TestNcmMPIJob *test, gconstpointer pdata)
+{
+  guint i;
+
+  ncm_mpi_job_run_array_async (NCM_MPI_JOB (test->mjt), test->input_array, test->ret_array, &_test_ncm_mpi_job_count, test);
+
+  /* Every result slot must be filled, once, with the answer of its own job. */
+  for (i = 0; i < test->ret_array->len; i++)
+  {
+    NcmVector *ret = g_ptr_array_index (test->ret_array, i);
+
+    g_assert_cmpuint (test->ncalls[i], ==, 1);
+    g_assert (gsl_finite (ncm_vector_get (ret, 0)));
+    g_assert_cmpfloat (ncm_vector_get (ret, 0), ==, ncm_vector_get (test->vec, i));
+  }
+}
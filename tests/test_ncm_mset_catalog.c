@@ -27,6 +27,7 @@
 #undef GSL_RANGE_CHECK_OFF
 #endif /* HAVE_CONFIG_H */
 #include <numcosmo/numcosmo.h>
+#include <glib/gstdio.h>
 
 typedef struct _TestNcmMSetCatalog
 {
@@ -47,6 +48,10 @@ void test_ncm_mset_catalog_norma (TestNcmMSetCatalog *test, gconstpointer pdata)
 void test_ncm_mset_catalog_norma_bound (TestNcmMSetCatalog *test, gconstpointer pdata);
 void test_ncm_mset_catalog_norma_unif (TestNcmMSetCatalog *test, gconstpointer pdata);
 void test_ncm_mset_catalog_vol (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_tau_bm (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_bin (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_bin_reopen (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_bin_prepend (TestNcmMSetCatalog *test, gconstpointer pdata);
 void test_ncm_mset_catalog_invalid_run (TestNcmMSetCatalog *test, gconstpointer pdata);
 
 gint
@@ -86,6 +91,26 @@ main (gint argc, gchar *argv[])
               &test_ncm_mset_catalog_vol,
               &test_ncm_mset_catalog_free);
   
+  g_test_add ("/ncm/mset/catalog/tau/batch_means", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_tau_bm,
+              &test_ncm_mset_catalog_free);
+  
+  g_test_add ("/ncm/mset/catalog/bin", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_bin,
+              &test_ncm_mset_catalog_free);
+
+  g_test_add ("/ncm/mset/catalog/bin/reopen", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_bin_reopen,
+              &test_ncm_mset_catalog_free);
+
+  g_test_add ("/ncm/mset/catalog/bin/prepend", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_bin_prepend,
+              &test_ncm_mset_catalog_free);
+  
   g_test_add ("/ncm/mset/catalog/traps", TestNcmMSetCatalog, NULL,
               &test_ncm_mset_catalog_new,
               &test_ncm_mset_catalog_traps,
@@ -391,6 +416,294 @@ test_ncm_mset_catalog_vol (TestNcmMSetCatalog *test, gconstpointer pdata)
 }
  
 
+void
+test_ncm_mset_catalog_tau_bm (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  const guint nt    = g_test_rand_int_range (100000, 200000);
+  const gdouble phi = 0.5;
+  const gdouble sd  = sqrt (1.0 - phi * phi);
+  const gdouble tau = (1.0 + phi) / (1.0 - phi);
+  NcmVector *x      = ncm_vector_new (test->dim);
+  NcmVector *mcat_tau;
+  gdouble mean_tau  = 0.0;
+  gint i;
+
+  ncm_mset_catalog_set_tau_method (test->mcat, NCM_MSET_CATALOG_TAU_METHOD_AR_MODEL);
+
+  for (i = 0; i < test->dim; i++)
+    ncm_vector_set (x, i, ncm_rng_gaussian_gen (test->rng, 0.0, 1.0));
+
+  for (i = 0; i < nt; i++)
+  {
+    gdouble m2lnL = 0.0;
+    gint j;
+
+    /* The rows added before the switch must enter the batch means. */
+    if (i == nt / 2)
+    {
+      ncm_mset_catalog_set_tau_method (test->mcat, NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS);
+      g_assert_cmpint (ncm_mset_catalog_get_tau_method (test->mcat), ==, NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS);
+    }
+
+    for (j = 0; j < test->dim; j++)
+      ncm_vector_set (x, j, phi * ncm_vector_get (x, j) + ncm_rng_gaussian_gen (test->rng, 0.0, sd));
+
+    ncm_mset_catalog_add_from_vector_array (test->mcat, x, &m2lnL);
+  }
+
+  ncm_mset_catalog_estimate_autocorrelation_tau (test->mcat, FALSE);
+  mcat_tau = ncm_mset_catalog_peek_autocorrelation_tau (test->mcat);
+
+  /* Constant column */
+  ncm_assert_cmpdouble (ncm_vector_get (mcat_tau, 0), ==, 1.0);
+
+  for (i = 0; i < test->dim; i++)
+    mean_tau += ncm_vector_get (mcat_tau, i + 1) / test->dim;
+
+  g_assert_cmpfloat (mean_tau, >, 0.5 * tau);
+  g_assert_cmpfloat (mean_tau, <, 2.0 * tau);
+
+  /* Switching away and back rebuilds the same batches. */
+  {
+    NcmVector *tau0 = ncm_vector_dup (mcat_tau);
+
+    ncm_mset_catalog_set_tau_method (test->mcat, NCM_MSET_CATALOG_TAU_METHOD_ACOR);
+    ncm_mset_catalog_set_tau_method (test->mcat, NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS);
+    ncm_mset_catalog_estimate_autocorrelation_tau (test->mcat, FALSE);
+    mcat_tau = ncm_mset_catalog_peek_autocorrelation_tau (test->mcat);
+
+    for (i = 0; i < test->dim + 1; i++)
+      ncm_assert_cmpdouble_e (ncm_vector_get (mcat_tau, i), ==, ncm_vector_get (tau0, i), 1.0e-12, 0.0);
+
+    ncm_vector_free (tau0);
+  }
+
+  ncm_vector_free (x);
+}
+
+void
+test_ncm_mset_catalog_bin (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  NcmData *data        = NCM_DATA (test->data_mvnd);
+  NcmDataGaussCov *cov = NCM_DATA_GAUSS_COV (test->data_mvnd);
+  NcmMSet *mset        = ncm_mset_catalog_peek_mset (test->mcat);
+  const guint nt       = g_test_rand_int_range (100, 1000);
+  gchar *tmp_dir       = g_dir_make_tmp ("test_ncm_mset_catalog_bin_XXXXXX", NULL);
+  gchar *filename      = g_build_filename (tmp_dir, "mcat" NCM_MSET_CATALOG_BIN_EXT, NULL);
+  gchar *mset_filename = g_build_filename (tmp_dir, "mcat.mset", NULL);
+  gint i;
+
+  g_assert (tmp_dir != NULL);
+
+  ncm_mset_catalog_set_file (test->mcat, filename);
+
+  for (i = 0; i < nt; i++)
+  {
+    gdouble m2lnL = 0.0;
+    ncm_data_m2lnL_val (data, mset, &m2lnL);
+
+    ncm_data_resample (data, mset, test->rng);
+    ncm_mset_catalog_add_from_vector_array (test->mcat, cov->y, &m2lnL);
+
+    /* Forces the data to be split in several blocks */
+    if (i % 97 == 0)
+      ncm_mset_catalog_sync (test->mcat, TRUE);
+  }
+  ncm_mset_catalog_sync (test->mcat, TRUE);
+
+  {
+    NcmMSetCatalog *mcat_ro = ncm_mset_catalog_new_from_file_ro (filename, 0);
+    const guint len         = ncm_mset_catalog_len (test->mcat);
+
+    g_assert_cmpuint (ncm_mset_catalog_len (mcat_ro), ==, len);
+    g_assert_cmpuint (ncm_mset_catalog_ncols (mcat_ro), ==, ncm_mset_catalog_ncols (test->mcat));
+
+    for (i = 0; i < len; i++)
+    {
+      NcmVector *row    = ncm_mset_catalog_peek_row (test->mcat, i);
+      NcmVector *row_ro = ncm_mset_catalog_peek_row (mcat_ro, i);
+      guint j;
+
+      for (j = 0; j < ncm_vector_len (row); j++)
+        g_assert_cmpfloat (ncm_vector_get (row_ro, j), ==, ncm_vector_get (row, j));
+    }
+
+    ncm_mset_catalog_free (mcat_ro);
+  }
+
+  ncm_mset_catalog_set_file (test->mcat, NULL);
+
+  g_unlink (filename);
+  g_unlink (mset_filename);
+  g_rmdir (tmp_dir);
+
+  g_free (filename);
+  g_free (mset_filename);
+  g_free (tmp_dir);
+}
+
+static NcmMSetCatalog *
+_test_ncm_mset_catalog_bin_new_mcat (TestNcmMSetCatalog *test)
+{
+  NcmMSetCatalog *mcat = ncm_mset_catalog_new (ncm_mset_catalog_peek_mset (test->mcat), 1, 1, FALSE,
+                                               "m2lnL", "-2\\ln(L)",
+                                               NULL);
+
+  ncm_mset_catalog_set_m2lnp_var (mcat, 0);
+
+  return mcat;
+}
+
+static void
+_test_ncm_mset_catalog_bin_add (TestNcmMSetCatalog *test, NcmMSetCatalog *mcat, NcmMSetCatalog *mcat_dup)
+{
+  NcmData *data        = NCM_DATA (test->data_mvnd);
+  NcmDataGaussCov *cov = NCM_DATA_GAUSS_COV (test->data_mvnd);
+  NcmMSet *mset        = ncm_mset_catalog_peek_mset (test->mcat);
+  gdouble m2lnL        = 0.0;
+
+  ncm_data_resample (data, mset, test->rng);
+  ncm_data_m2lnL_val (data, mset, &m2lnL);
+
+  ncm_mset_catalog_add_from_vector_array (mcat, cov->y, &m2lnL);
+  if (mcat_dup != NULL)
+    ncm_mset_catalog_add_from_vector_array (mcat_dup, cov->y, &m2lnL);
+}
+
+static void
+_test_ncm_mset_catalog_bin_cmp (NcmMSetCatalog *mcat_ro, guint offset, NcmMSetCatalog *mcat, guint first, guint len)
+{
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    NcmVector *row    = ncm_mset_catalog_peek_row (mcat, first + i);
+    NcmVector *row_ro = ncm_mset_catalog_peek_row (mcat_ro, offset + i);
+    guint j;
+
+    for (j = 0; j < ncm_vector_len (row); j++)
+      g_assert_cmpfloat (ncm_vector_get (row_ro, j), ==, ncm_vector_get (row, j));
+  }
+}
+
+void
+test_ncm_mset_catalog_bin_reopen (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  const guint n1         = g_test_rand_int_range (10, 100);
+  const guint n2         = g_test_rand_int_range (10, 100);
+  gchar *tmp_dir         = g_dir_make_tmp ("test_ncm_mset_catalog_bin_XXXXXX", NULL);
+  gchar *filename        = g_build_filename (tmp_dir, "mcat" NCM_MSET_CATALOG_BIN_EXT, NULL);
+  gchar *mset_filename   = g_build_filename (tmp_dir, "mcat.mset", NULL);
+  NcmMSetCatalog *mcat_r = _test_ncm_mset_catalog_bin_new_mcat (test);
+  guint i;
+
+  g_assert (tmp_dir != NULL);
+
+  ncm_mset_catalog_set_file (test->mcat, filename);
+
+  for (i = 0; i < n1; i++)
+    _test_ncm_mset_catalog_bin_add (test, test->mcat, NULL);
+
+  ncm_mset_catalog_sync (test->mcat, TRUE);
+
+  /* Closes the file and reopens it in a new catalog, the old rows must be loaded back. */
+  ncm_mset_catalog_set_file (test->mcat, NULL);
+  ncm_mset_catalog_set_file (mcat_r, filename);
+
+  g_assert_cmpuint (ncm_mset_catalog_len (mcat_r), ==, n1);
+  _test_ncm_mset_catalog_bin_cmp (mcat_r, 0, test->mcat, 0, n1);
+
+  /* Appends to the reopened file. */
+  for (i = 0; i < n2; i++)
+    _test_ncm_mset_catalog_bin_add (test, mcat_r, NULL);
+
+  ncm_mset_catalog_sync (mcat_r, TRUE);
+
+  {
+    NcmMSetCatalog *mcat_ro = ncm_mset_catalog_new_from_file_ro (filename, 0);
+
+    g_assert_cmpuint (ncm_mset_catalog_len (mcat_ro), ==, n1 + n2);
+    _test_ncm_mset_catalog_bin_cmp (mcat_ro, 0, test->mcat, 0, n1);
+    _test_ncm_mset_catalog_bin_cmp (mcat_ro, 0, mcat_r, 0, n1 + n2);
+
+    ncm_mset_catalog_free (mcat_ro);
+  }
+
+  ncm_mset_catalog_set_file (mcat_r, NULL);
+  ncm_mset_catalog_free (mcat_r);
+
+  g_unlink (filename);
+  g_unlink (mset_filename);
+  g_rmdir (tmp_dir);
+
+  g_free (filename);
+  g_free (mset_filename);
+  g_free (tmp_dir);
+}
+
+void
+test_ncm_mset_catalog_bin_prepend (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  const guint nskip      = g_test_rand_int_range (1, 50);
+  const guint nt         = nskip + g_test_rand_int_range (10, 100);
+  gchar *tmp_dir         = g_dir_make_tmp ("test_ncm_mset_catalog_bin_XXXXXX", NULL);
+  gchar *filename        = g_build_filename (tmp_dir, "mcat" NCM_MSET_CATALOG_BIN_EXT, NULL);
+  gchar *mset_filename   = g_build_filename (tmp_dir, "mcat.mset", NULL);
+  NcmMSetCatalog *mcat_t = _test_ncm_mset_catalog_bin_new_mcat (test);
+  guint i;
+
+  g_assert (tmp_dir != NULL);
+
+  /* The file catalog starts at nskip, the memory one at zero. */
+  ncm_mset_catalog_set_first_id (mcat_t, nskip);
+  ncm_mset_catalog_set_file (mcat_t, filename);
+
+  for (i = 0; i < nt; i++)
+    _test_ncm_mset_catalog_bin_add (test, test->mcat, (i >= nskip) ? mcat_t : NULL);
+
+  ncm_mset_catalog_sync (mcat_t, TRUE);
+  ncm_mset_catalog_set_file (mcat_t, NULL);
+
+  /* Attaching the file to the full catalog prepends the missing nskip rows. */
+  ncm_mset_catalog_set_file (test->mcat, filename);
+  g_assert_cmpint (ncm_mset_catalog_get_first_id (test->mcat), ==, 0);
+
+  {
+    NcmMSetCatalog *mcat_ro = ncm_mset_catalog_new_from_file_ro (filename, 0);
+
+    g_assert_cmpint (ncm_mset_catalog_get_first_id (mcat_ro), ==, 0);
+    g_assert_cmpuint (ncm_mset_catalog_len (mcat_ro), ==, nt);
+    _test_ncm_mset_catalog_bin_cmp (mcat_ro, 0, test->mcat, 0, nt);
+    _test_ncm_mset_catalog_bin_cmp (mcat_ro, nskip, mcat_t, 0, nt - nskip);
+
+    ncm_mset_catalog_free (mcat_ro);
+  }
+
+  /* Appending after the rewrite must keep the prepended rows. */
+  _test_ncm_mset_catalog_bin_add (test, test->mcat, NULL);
+  ncm_mset_catalog_sync (test->mcat, TRUE);
+
+  {
+    NcmMSetCatalog *mcat_ro = ncm_mset_catalog_new_from_file_ro (filename, 0);
+
+    g_assert_cmpuint (ncm_mset_catalog_len (mcat_ro), ==, nt + 1);
+    _test_ncm_mset_catalog_bin_cmp (mcat_ro, 0, test->mcat, 0, nt + 1);
+
+    ncm_mset_catalog_free (mcat_ro);
+  }
+
+  ncm_mset_catalog_set_file (test->mcat, NULL);
+  ncm_mset_catalog_free (mcat_t);
+
+  g_unlink (filename);
+  g_unlink (mset_filename);
+  g_rmdir (tmp_dir);
+
+  g_free (filename);
+  g_free (mset_filename);
+  g_free (tmp_dir);
+}
+
 #if GLIB_CHECK_VERSION(2,38,0)
 void
 test_ncm_mset_catalog_traps (TestNcmMSetCatalog *test, gconstpointer pdata)
@@ -0,0 +1,302 @@
+/***************************************************************************
+ *            test_ncm_powspec_filter.c
+ *
+ *  Sun October 18 17:02:11 2026
+ *  Copyright  2026  agent
+ *  <agent@local>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) agent 2026 <agent@local>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+
+/*
+ * Copies of NcPowspecMLTransfer and NcPowspecMLFixSpline without the
+ * eval_growth2 method, they compute exactly the same P(k, z) but force
+ * NcmPowspecFilter through the two dimensional (one transform per z) path.
+ */
+typedef struct _TestNcPowspecMLTransfer2dClass
+{
+  NcPowspecMLTransferClass parent_class;
+} TestNcPowspecMLTransfer2dClass;
+
+typedef struct _TestNcPowspecMLTransfer2d
+{
+  NcPowspecMLTransfer parent_instance;
+} TestNcPowspecMLTransfer2d;
+
+typedef struct _TestNcPowspecMLFixSpline2dClass
+{
+  NcPowspecMLFixSplineClass parent_class;
+} TestNcPowspecMLFixSpline2dClass;
+
+typedef struct _TestNcPowspecMLFixSpline2d
+{
+  NcPowspecMLFixSpline parent_instance;
+} TestNcPowspecMLFixSpline2d;
+
+GType test_nc_powspec_ml_transfer_2d_get_type (void) G_GNUC_CONST;
+GType test_nc_powspec_ml_fix_spline_2d_get_type (void) G_GNUC_CONST;
+
+G_DEFINE_TYPE (TestNcPowspecMLTransfer2d, test_nc_powspec_ml_transfer_2d, NC_TYPE_POWSPEC_ML_TRANSFER);
+G_DEFINE_TYPE (TestNcPowspecMLFixSpline2d, test_nc_powspec_ml_fix_spline_2d, NC_TYPE_POWSPEC_ML_FIX_SPLINE);
+
+static void
+test_nc_powspec_ml_transfer_2d_init (TestNcPowspecMLTransfer2d *ps)
+{
+}
+
+static void
+test_nc_powspec_ml_transfer_2d_class_init (TestNcPowspecMLTransfer2dClass *klass)
+{
+  NCM_POWSPEC_CLASS (klass)->eval_growth2 = NULL;
+}
+
+static void
+test_nc_powspec_ml_fix_spline_2d_init (TestNcPowspecMLFixSpline2d *ps)
+{
+}
+
+static void
+test_nc_powspec_ml_fix_spline_2d_class_init (TestNcPowspecMLFixSpline2dClass *klass)
+{
+  NCM_POWSPEC_CLASS (klass)->eval_growth2 = NULL;
+}
+
+typedef struct _TestNcmPowspecFilter
+{
+  NcHICosmo *cosmo;
+  NcmPowspec *ps_sep;
+  NcmPowspec *ps_2d;
+  NcmPowspecFilter *psf_sep;
+  NcmPowspecFilter *psf_2d;
+  gchar *tmp_dir;
+  gchar *filename;
+} TestNcmPowspecFilter;
+
+void test_ncm_powspec_filter_new_transfer (TestNcmPowspecFilter *test, gconstpointer pdata);
+void test_ncm_powspec_filter_new_fix_spline (TestNcmPowspecFilter *test, gconstpointer pdata);
+void test_ncm_powspec_filter_free (TestNcmPowspecFilter *test, gconstpointer pdata);
+
+void test_ncm_powspec_filter_growth_vs_2d (TestNcmPowspecFilter *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/powspec_filter/ml_transfer/tophat/growth_vs_2d", TestNcmPowspecFilter, GINT_TO_POINTER (NCM_POWSPEC_FILTER_TYPE_TOPHAT),
+              &test_ncm_powspec_filter_new_transfer,
+              &test_ncm_powspec_filter_growth_vs_2d,
+              &test_ncm_powspec_filter_free);
+  g_test_add ("/ncm/powspec_filter/ml_transfer/gauss/growth_vs_2d", TestNcmPowspecFilter, GINT_TO_POINTER (NCM_POWSPEC_FILTER_TYPE_GAUSS),
+              &test_ncm_powspec_filter_new_transfer,
+              &test_ncm_powspec_filter_growth_vs_2d,
+              &test_ncm_powspec_filter_free);
+  g_test_add ("/ncm/powspec_filter/ml_fix_spline/tophat/growth_vs_2d", TestNcmPowspecFilter, GINT_TO_POINTER (NCM_POWSPEC_FILTER_TYPE_TOPHAT),
+              &test_ncm_powspec_filter_new_fix_spline,
+              &test_ncm_powspec_filter_growth_vs_2d,
+              &test_ncm_powspec_filter_free);
+
+  g_test_run ();
+}
+
+static NcHICosmo *
+_test_ncm_powspec_filter_cosmo (void)
+{
+  NcHICosmo *cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  NcHIReion *reion = NC_HIREION (nc_hireion_camb_new ());
+  NcHIPrim *prim   = NC_HIPRIM (nc_hiprim_power_law_new ());
+
+  ncm_model_add_submodel (NCM_MODEL (cosmo), NCM_MODEL (reion));
+  ncm_model_add_submodel (NCM_MODEL (cosmo), NCM_MODEL (prim));
+
+  nc_hireion_free (reion);
+  nc_hiprim_free (prim);
+
+  return cosmo;
+}
+
+static void
+_test_ncm_powspec_filter_set_filters (TestNcmPowspecFilter *test, NcmPowspecFilterType type)
+{
+  const gdouble zf = 2.0;
+
+  g_assert (ncm_powspec_is_growth_separable (test->ps_sep));
+  g_assert (!ncm_powspec_is_growth_separable (test->ps_2d));
+
+  test->psf_sep = ncm_powspec_filter_new (test->ps_sep, type);
+  test->psf_2d  = ncm_powspec_filter_new (test->ps_2d, type);
+
+  ncm_powspec_filter_set_zf (test->psf_sep, zf);
+  ncm_powspec_filter_set_zf (test->psf_2d, zf);
+}
+
+void
+test_ncm_powspec_filter_new_transfer (TestNcmPowspecFilter *test, gconstpointer pdata)
+{
+  NcTransferFunc *tf = nc_transfer_func_new_from_name ("NcTransferFuncEH");
+
+  test->cosmo    = _test_ncm_powspec_filter_cosmo ();
+  test->ps_sep   = NCM_POWSPEC (nc_powspec_ml_transfer_new (tf));
+  test->ps_2d    = g_object_new (test_nc_powspec_ml_transfer_2d_get_type (), "transfer", tf, NULL);
+  test->tmp_dir  = NULL;
+  test->filename = NULL;
+
+  _test_ncm_powspec_filter_set_filters (test, GPOINTER_TO_INT (pdata));
+
+  nc_transfer_func_free (tf);
+}
+
+void
+test_ncm_powspec_filter_new_fix_spline (TestNcmPowspecFilter *test, gconstpointer pdata)
+{
+  NcTransferFunc *tf   = nc_transfer_func_new_from_name ("NcTransferFuncEH");
+  NcmPowspec *ps_mlt   = NCM_POWSPEC (nc_powspec_ml_transfer_new (tf));
+  const gdouble lnkmin = log (ncm_powspec_get_kmin (ps_mlt));
+  const gdouble lnkmax = log (ncm_powspec_get_kmax (ps_mlt));
+  const guint nknots   = 2000;
+  NcmVector *k_vec     = ncm_vector_new (nknots);
+  NcmVector *Pk_vec    = ncm_vector_new (nknots);
+  NcmSpline *Pk        = ncm_spline_cubic_notaknot_new ();
+  guint i;
+
+  test->cosmo = _test_ncm_powspec_filter_cosmo ();
+
+  /* P(k, 0) tabulated from the transfer function power spectrum. */
+  ncm_powspec_prepare (ps_mlt, NCM_MODEL (test->cosmo));
+  for (i = 0; i < nknots; i++)
+  {
+    const gdouble k = exp (lnkmin + (lnkmax - lnkmin) * i / (nknots - 1.0));
+
+    ncm_vector_set (k_vec, i, k);
+    ncm_vector_set (Pk_vec, i, ncm_powspec_eval (ps_mlt, NCM_MODEL (test->cosmo), 0.0, k));
+  }
+  ncm_spline_set (Pk, k_vec, Pk_vec, TRUE);
+
+  test->tmp_dir  = g_dir_make_tmp ("test_ncm_powspec_filter_XXXXXX", NULL);
+  test->filename = g_build_filename (test->tmp_dir, "Pk.obj", NULL);
+  g_assert (test->tmp_dir != NULL);
+
+  ncm_serialize_global_to_file (G_OBJECT (Pk), test->filename);
+
+  test->ps_sep = NCM_POWSPEC (nc_powspec_ml_fix_spline_new (test->filename));
+  test->ps_2d  = g_object_new (test_nc_powspec_ml_fix_spline_2d_get_type (), "filename", test->filename, NULL);
+
+  ncm_powspec_set_kmin (test->ps_sep, exp (lnkmin));
+  ncm_powspec_set_kmax (test->ps_sep, exp (lnkmax));
+  ncm_powspec_set_kmin (test->ps_2d, exp (lnkmin));
+  ncm_powspec_set_kmax (test->ps_2d, exp (lnkmax));
+
+  _test_ncm_powspec_filter_set_filters (test, GPOINTER_TO_INT (pdata));
+
+  ncm_spline_free (Pk);
+  ncm_vector_free (k_vec);
+  ncm_vector_free (Pk_vec);
+  ncm_powspec_free (ps_mlt);
+  nc_transfer_func_free (tf);
+}
+
+void
+test_ncm_powspec_filter_free (TestNcmPowspecFilter *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (ncm_powspec_filter_free, test->psf_sep);
+  NCM_TEST_FREE (ncm_powspec_filter_free, test->psf_2d);
+  NCM_TEST_FREE (ncm_powspec_free, test->ps_sep);
+  NCM_TEST_FREE (ncm_powspec_free, test->ps_2d);
+  NCM_TEST_FREE (nc_hicosmo_free, test->cosmo);
+
+  if (test->tmp_dir != NULL)
+  {
+    g_unlink (test->filename);
+    g_rmdir (test->tmp_dir);
+    g_free (test->filename);
+    g_free (test->tmp_dir);
+  }
+}
+
+/*
+ * Both paths share the FFTLog grid, they differ only in the z knots
+ * (chosen from D^2(z) or from sigma^2(r_0, z)) and in the round-off of
+ * the rescaled transforms. The z interpolation is calibrated to
+ * reltol-z = 1e-6, hence the 1e-5 tolerance below.
+ */
+#define TEST_NCM_POWSPEC_FILTER_RELTOL (1.0e-5)
+
+static void
+_test_ncm_powspec_filter_compare (TestNcmPowspecFilter *test)
+{
+  const gdouble z_a[]   = {0.0, 0.2, 0.5, 1.0, 1.7, 2.0};
+  const gdouble lnr_min = log (GSL_MAX (ncm_powspec_filter_get_r_min (test->psf_sep), 1.0));
+  const gdouble lnr_max = log (GSL_MIN (ncm_powspec_filter_get_r_max (test->psf_sep), 50.0));
+  const guint nr        = 20;
+  guint i, j;
+
+  g_assert_cmpfloat (lnr_min, <, lnr_max);
+
+  for (i = 0; i < G_N_ELEMENTS (z_a); i++)
+  {
+    const gdouble z = z_a[i];
+
+    for (j = 0; j < nr; j++)
+    {
+      const gdouble lnr = lnr_min + (lnr_max - lnr_min) * j / (nr - 1.0);
+
+      ncm_assert_cmpdouble_e (ncm_powspec_filter_eval_var_lnr (test->psf_sep, z, lnr), ==,
+                              ncm_powspec_filter_eval_var_lnr (test->psf_2d, z, lnr),
+                              TEST_NCM_POWSPEC_FILTER_RELTOL, 0.0);
+      ncm_assert_cmpdouble_e (ncm_powspec_filter_eval_dvar_dlnr (test->psf_sep, z, lnr), ==,
+                              ncm_powspec_filter_eval_dvar_dlnr (test->psf_2d, z, lnr),
+                              TEST_NCM_POWSPEC_FILTER_RELTOL, 0.0);
+      ncm_assert_cmpdouble_e (ncm_powspec_filter_eval_dlnvar_dlnr (test->psf_sep, z, lnr), ==,
+                              ncm_powspec_filter_eval_dlnvar_dlnr (test->psf_2d, z, lnr),
+                              TEST_NCM_POWSPEC_FILTER_RELTOL, 0.0);
+    }
+  }
+}
+
+void
+test_ncm_powspec_filter_growth_vs_2d (TestNcmPowspecFilter *test, gconstpointer pdata)
+{
+  NcmModel *model = NCM_MODEL (test->cosmo);
+
+  /* First preparation, calibrates the FFTLog size and the z knots. */
+  ncm_powspec_filter_prepare (test->psf_sep, model);
+  ncm_powspec_filter_prepare (test->psf_2d, model);
+
+  _test_ncm_powspec_filter_compare (test);
+
+  /* Second preparation, refills the knots of the calibrated splines. */
+  ncm_model_orig_param_set (model, NC_HICOSMO_DE_OMEGA_C, ncm_model_orig_param_get (model, NC_HICOSMO_DE_OMEGA_C) * 1.1);
+  ncm_model_orig_param_set (model, NC_HICOSMO_DE_H0, ncm_model_orig_param_get (model, NC_HICOSMO_DE_H0) * 0.95);
+
+  ncm_powspec_filter_prepare (test->psf_sep, model);
+  ncm_powspec_filter_prepare (test->psf_2d, model);
+
+  _test_ncm_powspec_filter_compare (test);
+}
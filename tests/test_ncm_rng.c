@@ -0,0 +1,239 @@
+/***************************************************************************
+ *            test_ncm_rng.c
+ *
+ *  Sun October 18 15:48:03 2026
+ *  Copyright  2026  agent
+ *  <agent@local>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) agent 2026 <agent@local>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcmRNG
+{
+  NcmRNG *rng;
+  guint nstreams;
+  guint ndraws;
+} TestNcmRNG;
+
+void test_ncm_rng_new (TestNcmRNG *test, gconstpointer pdata);
+void test_ncm_rng_free (TestNcmRNG *test, gconstpointer pdata);
+
+void test_ncm_rng_substream_reproducible (TestNcmRNG *test, gconstpointer pdata);
+void test_ncm_rng_substream_independent (TestNcmRNG *test, gconstpointer pdata);
+void test_ncm_rng_substream_untracked (TestNcmRNG *test, gconstpointer pdata);
+void test_ncm_rng_substream_threads (TestNcmRNG *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/rng/substream/reproducible", TestNcmRNG, NULL,
+              &test_ncm_rng_new,
+              &test_ncm_rng_substream_reproducible,
+              &test_ncm_rng_free);
+  g_test_add ("/ncm/rng/substream/independent", TestNcmRNG, NULL,
+              &test_ncm_rng_new,
+              &test_ncm_rng_substream_independent,
+              &test_ncm_rng_free);
+  g_test_add ("/ncm/rng/substream/untracked", TestNcmRNG, NULL,
+              &test_ncm_rng_new,
+              &test_ncm_rng_substream_untracked,
+              &test_ncm_rng_free);
+  g_test_add ("/ncm/rng/substream/threads", TestNcmRNG, NULL,
+              &test_ncm_rng_new,
+              &test_ncm_rng_substream_threads,
+              &test_ncm_rng_free);
+
+  g_test_run ();
+}
+
+void
+test_ncm_rng_new (TestNcmRNG *test, gconstpointer pdata)
+{
+  test->rng      = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  test->nstreams = g_test_rand_int_range (10, 50);
+  test->ndraws   = 10000;
+}
+
+void
+test_ncm_rng_free (TestNcmRNG *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (ncm_rng_free, test->rng);
+}
+
+void
+test_ncm_rng_substream_reproducible (TestNcmRNG *test, gconstpointer pdata)
+{
+  NcmRNG *master = ncm_rng_seeded_new (ncm_rng_get_algo (test->rng), ncm_rng_get_seed (test->rng));
+  guint k;
+
+  /* The substreams must not depend on the state of the master RNG. */
+  for (k = 0; k < test->ndraws; k++)
+    ncm_rng_uniform_gen (master, 0.0, 1.0);
+
+  for (k = 0; k < test->nstreams; k++)
+  {
+    NcmRNG *s0 = ncm_rng_substream_new (test->rng, k);
+    NcmRNG *s1 = ncm_rng_substream_new (master, k);
+    guint i;
+
+    g_assert_cmpstr (ncm_rng_get_algo (s0), ==, ncm_rng_get_algo (test->rng));
+    g_assert_cmpuint (ncm_rng_get_seed (s0), ==, ncm_rng_substream_seed (test->rng, k));
+    g_assert_cmpuint (ncm_rng_get_seed (s0), ==, ncm_rng_get_seed (s1));
+
+    for (i = 0; i < test->ndraws; i++)
+      g_assert_cmpfloat (ncm_rng_uniform_gen (s0, 0.0, 1.0), ==, ncm_rng_uniform_gen (s1, 0.0, 1.0));
+
+    ncm_rng_free (s0);
+    ncm_rng_free (s1);
+  }
+
+  ncm_rng_free (master);
+}
+
+void
+test_ncm_rng_substream_independent (TestNcmRNG *test, gconstpointer pdata)
+{
+  const gdouble n   = test->ndraws;
+  NcmMatrix *draws  = ncm_matrix_new (test->nstreams, test->ndraws);
+  GHashTable *seeds = g_hash_table_new (g_direct_hash, g_direct_equal);
+  guint k, l, i;
+
+  for (k = 0; k < test->nstreams; k++)
+  {
+    NcmRNG *s   = ncm_rng_substream_new (test->rng, k);
+    gulong seed = ncm_rng_get_seed (s);
+    NcmVector *row;
+    gdouble mean;
+
+    g_assert (!g_hash_table_contains (seeds, GSIZE_TO_POINTER (seed)));
+    g_hash_table_add (seeds, GSIZE_TO_POINTER (seed));
+
+    for (i = 0; i < test->ndraws; i++)
+      ncm_matrix_set (draws, k, i, ncm_rng_uniform_gen (s, -1.0, 1.0));
+
+    /* Each stream is uniform in [-1, 1], variance 1/3. */
+    row  = ncm_matrix_get_row (draws, k);
+    mean = ncm_vector_sum_cpts (row) / n;
+    ncm_vector_free (row);
+    g_assert_cmpfloat (fabs (mean), <, 6.0 * sqrt (1.0 / (3.0 * n)));
+
+    ncm_rng_free (s);
+  }
+
+  /* Different streams must be uncorrelated, including consecutive indexes. */
+  for (k = 0; k < test->nstreams; k++)
+  {
+    for (l = k + 1; l < test->nstreams; l++)
+    {
+      gdouble corr = 0.0;
+
+      for (i = 0; i < test->ndraws; i++)
+        corr += ncm_matrix_get (draws, k, i) * ncm_matrix_get (draws, l, i);
+
+      corr = 3.0 * corr / n;
+      g_assert_cmpfloat (fabs (corr), <, 6.0 / sqrt (n));
+    }
+  }
+
+  g_hash_table_unref (seeds);
+  ncm_matrix_free (draws);
+}
+
+void
+test_ncm_rng_substream_untracked (TestNcmRNG *test, gconstpointer pdata)
+{
+  guint k;
+
+  for (k = 0; k < test->nstreams; k++)
+  {
+    const gulong seed = ncm_rng_substream_seed (test->rng, k);
+    NcmRNG *s;
+
+    /* Skips the (unlikely) seeds already used by another RNG. */
+    if (!ncm_rng_check_seed (test->rng, seed))
+      continue;
+
+    s = ncm_rng_substream_new (test->rng, k);
+    g_assert (ncm_rng_check_seed (test->rng, seed));
+    ncm_rng_free (s);
+  }
+
+  g_assert (!ncm_rng_check_seed (test->rng, ncm_rng_get_seed (test->rng)));
+}
+
+typedef struct _TestNcmRNGThreads
+{
+  NcmRNG *rng;
+  NcmMatrix *draws;
+} TestNcmRNGThreads;
+
+static void
+_test_ncm_rng_substream_draw (glong i, glong f, gpointer userdata)
+{
+  TestNcmRNGThreads *td = (TestNcmRNGThreads *) userdata;
+  glong k;
+
+  for (k = i; k < f; k++)
+  {
+    NcmRNG *s = ncm_rng_substream_new (td->rng, k);
+    guint j;
+
+    for (j = 0; j < ncm_matrix_ncols (td->draws); j++)
+      ncm_matrix_set (td->draws, k, j, ncm_rng_gaussian_gen (s, 0.0, 1.0));
+
+    ncm_rng_free (s);
+  }
+}
+
+void
+test_ncm_rng_substream_threads (TestNcmRNG *test, gconstpointer pdata)
+{
+  TestNcmRNGThreads td_serial   = {test->rng, ncm_matrix_new (test->nstreams, 100)};
+  TestNcmRNGThreads td_threaded = {test->rng, ncm_matrix_new (test->nstreams, 100)};
+  guint k, j;
+
+  ncm_func_eval_set_max_threads (1);
+  ncm_func_eval_threaded_loop_ws (&_test_ncm_rng_substream_draw, 0, test->nstreams, &td_serial, 0);
+
+  ncm_func_eval_set_max_threads (4);
+  ncm_func_eval_threaded_loop_ws (&_test_ncm_rng_substream_draw, 0, test->nstreams, &td_threaded, 1);
+
+  ncm_func_eval_set_max_threads (NCM_THREAD_POOL_MAX);
+
+  for (k = 0; k < test->nstreams; k++)
+  {
+    for (j = 0; j < 100; j++)
+      g_assert_cmpfloat (ncm_matrix_get (td_serial.draws, k, j), ==, ncm_matrix_get (td_threaded.draws, k, j));
+  }
+
+  ncm_matrix_free (td_serial.draws);
+  ncm_matrix_free (td_threaded.draws);
+}
@@ -52,6 +52,12 @@ static void test_ncm_serialize_to_binfile_from_binfile (TestNcmSerialize *test,
 
 static void test_ncm_serialize_reset_autosave_only (TestNcmSerialize *test, gconstpointer pdata);
 
+static void test_ncm_serialize_dup_obj (TestNcmSerialize *test, gconstpointer pdata);
+static void test_ncm_serialize_dup_obj_vector (TestNcmSerialize *test, gconstpointer pdata);
+static void test_ncm_serialize_dup_obj_matrix (TestNcmSerialize *test, gconstpointer pdata);
+static void test_ncm_serialize_dup_obj_data (TestNcmSerialize *test, gconstpointer pdata);
+static void test_ncm_serialize_dup_obj_shared (TestNcmSerialize *test, gconstpointer pdata);
+
 static void test_ncm_serialize_traps (TestNcmSerialize *test, gconstpointer pdata);
 static void test_ncm_serialize_global_invalid_from_string_syntax (TestNcmSerialize *test, gconstpointer pdata);
 static void test_ncm_serialize_global_invalid_from_string_nonexist (TestNcmSerialize *test, gconstpointer pdata);
@@ -107,6 +113,30 @@ main (gint argc, gchar *argv[])
               &test_ncm_serialize_new_noclean_dup,
               &test_ncm_serialize_to_binfile_from_binfile,
               &test_ncm_serialize_free);
+  g_test_add ("/ncm/serialize/dup_obj", TestNcmSerialize, NULL,
+              &test_ncm_serialize_new,
+              &test_ncm_serialize_dup_obj,
+              &test_ncm_serialize_free);
+  g_test_add ("/ncm/serialize/dup_obj/vector", TestNcmSerialize, NULL,
+              &test_ncm_serialize_new,
+              &test_ncm_serialize_dup_obj_vector,
+              &test_ncm_serialize_free);
+  g_test_add ("/ncm/serialize/dup_obj/matrix", TestNcmSerialize, NULL,
+              &test_ncm_serialize_new,
+              &test_ncm_serialize_dup_obj_matrix,
+              &test_ncm_serialize_free);
+  g_test_add ("/ncm/serialize/dup_obj/data", TestNcmSerialize, NULL,
+              &test_ncm_serialize_new,
+              &test_ncm_serialize_dup_obj_data,
+              &test_ncm_serialize_free);
+  g_test_add ("/ncm/serialize/dup_obj/shared/clean_dup", TestNcmSerialize, NULL,
+              &test_ncm_serialize_new,
+              &test_ncm_serialize_dup_obj_shared,
+              &test_ncm_serialize_free);
+  g_test_add ("/ncm/serialize/dup_obj/shared/noclean_dup", TestNcmSerialize, NULL,
+              &test_ncm_serialize_new_noclean_dup,
+              &test_ncm_serialize_dup_obj_shared,
+              &test_ncm_serialize_free);
 
   g_test_add ("/ncm/serialize/traps", TestNcmSerialize, NULL,
               &test_ncm_serialize_new,
@@ -467,6 +497,242 @@ test_ncm_serialize_to_binfile_from_binfile (TestNcmSerialize *test, gconstpointe
   }
 }
 
+static void
+test_ncm_serialize_dup_obj (TestNcmSerialize *test, gconstpointer pdata)
+{
+  const gchar *objs[] = {
+    "NcHICosmoDEXcdm{'w':<-2.0>}",
+    "NcPowspecMLTransfer{'transfer':<{'NcTransferFuncEH',@a{sv} {}}>}",
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (objs); i++)
+  {
+    GObject *obj         = ncm_serialize_global_from_string (objs[i]);
+    GObject *obj_dup     = ncm_serialize_dup_obj (test->ser, obj);
+    GObject *obj_var_dup = ncm_serialize_dup_obj_variant (test->ser, obj);
+    gchar *obj_ser, *obj_dup_ser, *obj_var_dup_ser;
+
+    ncm_serialize_reset (test->ser, TRUE);
+
+    obj_ser         = ncm_serialize_global_to_string (obj, FALSE);
+    obj_dup_ser     = ncm_serialize_global_to_string (obj_dup, FALSE);
+    obj_var_dup_ser = ncm_serialize_global_to_string (obj_var_dup, FALSE);
+
+    g_assert (obj != obj_dup);
+    g_assert (G_OBJECT_TYPE (obj) == G_OBJECT_TYPE (obj_dup));
+    g_assert_cmpstr (obj_ser, ==, obj_dup_ser);
+    g_assert_cmpstr (obj_var_dup_ser, ==, obj_dup_ser);
+
+    g_free (obj_ser);
+    g_free (obj_dup_ser);
+    g_free (obj_var_dup_ser);
+
+    g_object_unref (obj_var_dup);
+    g_object_unref (obj_dup);
+    g_object_unref (obj);
+  }
+
+  {
+    GObject *obj = ncm_serialize_global_from_string ("NcHICosmoLCDM");
+    GObject *obj_dup;
+
+    ncm_serialize_set (test->ser, obj, "shared", FALSE);
+    obj_dup = ncm_serialize_dup_obj (test->ser, obj);
+
+    g_assert (obj == obj_dup);
+
+    g_object_unref (obj_dup);
+    ncm_serialize_clear_instances (test->ser, FALSE);
+    g_object_unref (obj);
+  }
+}
+
+void
+test_ncm_serialize_dup_obj_vector (TestNcmSerialize *test, gconstpointer pdata)
+{
+  const guint len = g_test_rand_int_range (1, 100);
+  NcmVector *v    = ncm_vector_new (len);
+  NcmVector *v_dup;
+  guint i;
+
+  for (i = 0; i < len; i++)
+    ncm_vector_set (v, i, g_test_rand_double ());
+
+  v_dup = NCM_VECTOR (ncm_serialize_dup_obj (test->ser, G_OBJECT (v)));
+  ncm_serialize_reset (test->ser, TRUE);
+
+  g_assert (v_dup != v);
+  g_assert (ncm_vector_data (v_dup) != ncm_vector_data (v));
+  g_assert_cmpuint (ncm_vector_len (v_dup), ==, len);
+
+  for (i = 0; i < len; i++)
+    g_assert_cmpfloat (ncm_vector_get (v_dup, i), ==, ncm_vector_get (v, i));
+
+  /* The duplicate must not follow changes in the original and vice versa. */
+  for (i = 0; i < len; i++)
+  {
+    const gdouble v_i = ncm_vector_get (v, i);
+
+    ncm_vector_set (v, i, v_i + 1.0);
+    g_assert_cmpfloat (ncm_vector_get (v_dup, i), ==, v_i);
+
+    ncm_vector_set (v_dup, i, v_i - 1.0);
+    g_assert_cmpfloat (ncm_vector_get (v, i), ==, v_i + 1.0);
+  }
+
+  ncm_vector_free (v_dup);
+  ncm_vector_free (v);
+}
+
+void
+test_ncm_serialize_dup_obj_matrix (TestNcmSerialize *test, gconstpointer pdata)
+{
+  const guint nrows = g_test_rand_int_range (1, 30);
+  const guint ncols = g_test_rand_int_range (1, 30);
+  NcmMatrix *m      = ncm_matrix_new (nrows, ncols);
+  NcmMatrix *m_dup;
+  guint i, j;
+
+  for (i = 0; i < nrows; i++)
+    for (j = 0; j < ncols; j++)
+      ncm_matrix_set (m, i, j, g_test_rand_double ());
+
+  m_dup = NCM_MATRIX (ncm_serialize_dup_obj (test->ser, G_OBJECT (m)));
+  ncm_serialize_reset (test->ser, TRUE);
+
+  g_assert (m_dup != m);
+  g_assert (ncm_matrix_data (m_dup) != ncm_matrix_data (m));
+  g_assert_cmpuint (ncm_matrix_nrows (m_dup), ==, nrows);
+  g_assert_cmpuint (ncm_matrix_ncols (m_dup), ==, ncols);
+
+  for (i = 0; i < nrows; i++)
+  {
+    for (j = 0; j < ncols; j++)
+    {
+      const gdouble m_ij = ncm_matrix_get (m, i, j);
+
+      g_assert_cmpfloat (ncm_matrix_get (m_dup, i, j), ==, m_ij);
+
+      ncm_matrix_set (m, i, j, m_ij + 1.0);
+      g_assert_cmpfloat (ncm_matrix_get (m_dup, i, j), ==, m_ij);
+
+      ncm_matrix_set (m_dup, i, j, m_ij - 1.0);
+      g_assert_cmpfloat (ncm_matrix_get (m, i, j), ==, m_ij + 1.0);
+    }
+  }
+
+  ncm_matrix_free (m_dup);
+  ncm_matrix_free (m);
+}
+
+void
+test_ncm_serialize_dup_obj_data (TestNcmSerialize *test, gconstpointer pdata)
+{
+  const guint dim                = g_test_rand_int_range (2, 10);
+  NcmRNG *rng                    = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmDataGaussCovMVND *data_mvnd = ncm_data_gauss_cov_mvnd_new_full (dim, 1.0e-2, 5.0e-1, 1.0, 1.0, 2.0, rng);
+  NcmDataGaussCov *gauss         = NCM_DATA_GAUSS_COV (data_mvnd);
+  NcmDataGaussCov *gauss_dup;
+  NcmData *data_dup;
+  gchar *data_ser, *data_dup_ser;
+  guint i, j;
+
+  data_dup  = NCM_DATA (ncm_serialize_dup_obj (test->ser, G_OBJECT (data_mvnd)));
+  gauss_dup = NCM_DATA_GAUSS_COV (data_dup);
+  ncm_serialize_reset (test->ser, TRUE);
+
+  data_ser     = ncm_serialize_global_to_string (G_OBJECT (data_mvnd), FALSE);
+  data_dup_ser = ncm_serialize_global_to_string (G_OBJECT (data_dup), FALSE);
+
+  g_assert (NCM_IS_DATA_GAUSS_COV_MVND (data_dup));
+  g_assert_cmpstr (data_ser, ==, data_dup_ser);
+
+  g_assert (gauss_dup->y != gauss->y);
+  g_assert (gauss_dup->cov != gauss->cov);
+
+  /* Modifying the original data must leave the duplicate untouched. */
+  for (i = 0; i < dim; i++)
+  {
+    const gdouble y_i = ncm_vector_get (gauss->y, i);
+
+    ncm_vector_set (gauss->y, i, y_i + 1.0);
+    g_assert_cmpfloat (ncm_vector_get (gauss_dup->y, i), ==, y_i);
+
+    for (j = 0; j < dim; j++)
+    {
+      const gdouble cov_ij = ncm_matrix_get (gauss->cov, i, j);
+
+      ncm_matrix_set (gauss->cov, i, j, 2.0 * cov_ij);
+      g_assert_cmpfloat (ncm_matrix_get (gauss_dup->cov, i, j), ==, cov_ij);
+    }
+  }
+
+  g_free (data_ser);
+  g_free (data_dup_ser);
+
+  NCM_TEST_FREE (ncm_data_free, data_dup);
+  NCM_TEST_FREE (ncm_data_gauss_cov_mvnd_free, data_mvnd);
+  ncm_rng_free (rng);
+}
+
+void
+test_ncm_serialize_dup_obj_shared (TestNcmSerialize *test, gconstpointer pdata)
+{
+  const gboolean clean_dup = ((test->ser->opts & NCM_SERIALIZE_OPT_CLEAN_DUP) == NCM_SERIALIZE_OPT_CLEAN_DUP);
+  NcmRNG *rng                    = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmDataGaussCovMVND *data_mvnd = ncm_data_gauss_cov_mvnd_new_full (3, 1.0e-2, 5.0e-1, 1.0, 1.0, 2.0, rng);
+  NcmDataset *dset               = ncm_dataset_new ();
+  NcmDataset *dset_dup, *dset_dup2;
+  NcmData *data_dup0, *data_dup1;
+  gdouble y_0;
+
+  /* The same data appears twice in the dataset. */
+  ncm_dataset_append_data (dset, NCM_DATA (data_mvnd));
+  ncm_dataset_append_data (dset, NCM_DATA (data_mvnd));
+
+  dset_dup  = NCM_DATASET (ncm_serialize_dup_obj (test->ser, G_OBJECT (dset)));
+  data_dup0 = ncm_dataset_peek_data (dset_dup, 0);
+  data_dup1 = ncm_dataset_peek_data (dset_dup, 1);
+
+  g_assert_cmpuint (ncm_dataset_get_length (dset_dup), ==, 2);
+  g_assert (data_dup0 != NCM_DATA (data_mvnd));
+  g_assert (data_dup1 != NCM_DATA (data_mvnd));
+
+  if (clean_dup)
+    g_assert (data_dup0 == data_dup1);
+  else
+    g_assert (data_dup0 != data_dup1);
+
+  /* The cached duplicate is reused until the serializer is reset. */
+  dset_dup2 = NCM_DATASET (ncm_serialize_dup_obj (test->ser, G_OBJECT (dset)));
+  if (clean_dup)
+    g_assert (dset_dup2 == dset_dup);
+  else
+    g_assert (dset_dup2 != dset_dup);
+  ncm_dataset_free (dset_dup2);
+
+  ncm_serialize_reset (test->ser, TRUE);
+
+  dset_dup2 = NCM_DATASET (ncm_serialize_dup_obj (test->ser, G_OBJECT (dset)));
+  g_assert (dset_dup2 != dset_dup);
+  g_assert (ncm_dataset_peek_data (dset_dup2, 0) != data_dup0);
+  ncm_dataset_free (dset_dup2);
+  ncm_serialize_reset (test->ser, TRUE);
+
+  /* The shared duplicate is still independent of the original. */
+  y_0 = ncm_vector_get (NCM_DATA_GAUSS_COV (data_mvnd)->y, 0);
+  ncm_vector_set (NCM_DATA_GAUSS_COV (data_mvnd)->y, 0, y_0 + 1.0);
+
+  g_assert_cmpfloat (ncm_vector_get (NCM_DATA_GAUSS_COV (data_dup0)->y, 0), ==, y_0);
+  g_assert_cmpfloat (ncm_vector_get (NCM_DATA_GAUSS_COV (data_dup1)->y, 0), ==, y_0);
+
+  NCM_TEST_FREE (ncm_dataset_free, dset_dup);
+  NCM_TEST_FREE (ncm_dataset_free, dset);
+  NCM_TEST_FREE (ncm_data_gauss_cov_mvnd_free, data_mvnd);
+  ncm_rng_free (rng);
+}
+
 void
 test_ncm_serialize_traps (TestNcmSerialize *test, gconstpointer pdata)
 {
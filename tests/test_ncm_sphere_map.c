@@ -46,6 +46,7 @@ void test_ncm_sphere_map_angles (TestNcmSphereMap *test, gconstpointer pdata);
 void test_ncm_sphere_map_ring (TestNcmSphereMap *test, gconstpointer pdata);
 void test_ncm_sphere_map_pix2alm (TestNcmSphereMap *test, gconstpointer pdata);
 void test_ncm_sphere_map_pix2alm2pix (TestNcmSphereMap *test, gconstpointer pdata);
+void test_ncm_sphere_map_pix2alm_threaded (TestNcmSphereMap *test, gconstpointer pdata);
 
 void test_ncm_sphere_map_traps (TestNcmSphereMap *test, gconstpointer pdata);
 void test_ncm_sphere_map_invalid_nside (TestNcmSphereMap *test, gconstpointer pdata);
@@ -82,6 +83,11 @@ main (gint argc, gchar *argv[])
               &test_ncm_sphere_map_new,
               &test_ncm_sphere_map_pix2alm2pix,
               &test_ncm_sphere_map_free);
+
+  g_test_add ("/ncm/sphere_map/pix2alm/threaded", TestNcmSphereMap, NULL,
+              &test_ncm_sphere_map_new,
+              &test_ncm_sphere_map_pix2alm_threaded,
+              &test_ncm_sphere_map_free);
 #endif /* HAVE_GSL_2_2 */
   
   g_test_add ("/ncm/sphere_map/traps", TestNcmSphereMap, NULL,
@@ -289,6 +295,61 @@ test_ncm_sphere_map_pix2alm2pix (TestNcmSphereMap *test, gconstpointer pdata)
   ncm_rng_free (rng);
 }
 
+void
+test_ncm_sphere_map_pix2alm_threaded (TestNcmSphereMap *test, gconstpointer pdata)
+{
+  NcmRNG *rng        = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  const guint lmax   = 256;
+  const gint64 npix  = ncm_sphere_map_get_npix (test->pix);
+  GArray *Cl_serial  = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  GArray *pix_serial = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  guint l;
+  gint64 i;
+  
+  g_assert (test->pix != NULL);
+
+  ncm_sphere_map_add_noise (test->pix, 1.0, rng);
+  ncm_sphere_map_set_lmax (test->pix, lmax);
+
+  ncm_sphere_map_set_nthreads (test->pix, 1);
+  ncm_sphere_map_prepare_alm (test->pix);
+
+  for (l = 0; l <= lmax; l++)
+  {
+    const gdouble C_l = ncm_sphere_map_get_Cl (test->pix, l);
+    g_array_append_val (Cl_serial, C_l);
+  }
+
+  ncm_sphere_map_set_nthreads (test->pix, 4);
+  g_assert_cmpuint (ncm_sphere_map_get_nthreads (test->pix), ==, 4);
+  ncm_sphere_map_prepare_alm (test->pix);
+
+  for (l = 0; l <= lmax; l++)
+  {
+    ncm_assert_cmpdouble_e (ncm_sphere_map_get_Cl (test->pix, l), ==, g_array_index (Cl_serial, gdouble, l), 1.0e-10, 0.0);
+  }
+
+  ncm_sphere_map_set_nthreads (test->pix, 1);
+  ncm_sphere_map_alm2map (test->pix);
+
+  for (i = 0; i < npix; i++)
+  {
+    const gdouble p_i = ncm_sphere_map_get_pix (test->pix, i);
+    g_array_append_val (pix_serial, p_i);
+  }
+
+  ncm_sphere_map_set_nthreads (test->pix, 4);
+  ncm_sphere_map_alm2map (test->pix);
+
+  for (i = 0; i < npix; i++)
+  {
+    g_assert_cmpfloat (ncm_sphere_map_get_pix (test->pix, i), ==, g_array_index (pix_serial, gdouble, i));
+  }
+
+  g_array_unref (Cl_serial);
+  g_array_unref (pix_serial);
+  ncm_rng_free (rng);
+}
 
 void
 test_ncm_sphere_map_traps (TestNcmSphereMap *test, gconstpointer pdata)
@@ -39,13 +39,22 @@
 typedef struct _TestNcmStatsDistNd
 {
   NcmStatsDistNd *dnd;
+  NcmRNG *rng;
+  NcmDataGaussCovMVND *data_mvnd;
+  NcmModelMVND *model_mvnd;
   NcmMSet *mset;
   guint dim;
+  guint np;
   guint nfail;
 } TestNcmStatsDistNd;
 
+static const gdouble test_ncm_stats_dist_nd_far_offset = 1.0e4;
+
 static void test_ncm_stats_dist_nd_new_kde_gauss (TestNcmStatsDistNd *test, gconstpointer pdata);
+static void test_ncm_stats_dist_nd_new_kde_gauss_sample (TestNcmStatsDistNd *test, gconstpointer pdata);
 static void test_ncm_stats_dist_nd_gauss_dens_est (TestNcmStatsDistNd *test, gconstpointer pdata);
+static void test_ncm_stats_dist_nd_gauss_dens_cut_off (TestNcmStatsDistNd *test, gconstpointer pdata);
+static void test_ncm_stats_dist_nd_gauss_dens_batch (TestNcmStatsDistNd *test, gconstpointer pdata);
 static void test_ncm_stats_dist_nd_gauss_dens_interp (TestNcmStatsDistNd *test, gconstpointer pdata);
 static void test_ncm_stats_dist_nd_gauss_dens_interp_unormalized (TestNcmStatsDistNd *test, gconstpointer pdata);
 static void test_ncm_stats_dist_nd_gauss_sampling (TestNcmStatsDistNd *test, gconstpointer pdata);
@@ -69,6 +78,21 @@ main (gint argc, gchar *argv[])
               &test_ncm_stats_dist_nd_gauss_dens_est, 
               &test_ncm_stats_dist_nd_free);
   
+  g_test_add ("/ncm/stats/dist/nd/kde/gauss/gauss/dens/cut_off", TestNcmStatsDistNd, NULL, 
+              &test_ncm_stats_dist_nd_new_kde_gauss_sample, 
+              &test_ncm_stats_dist_nd_gauss_dens_cut_off, 
+              &test_ncm_stats_dist_nd_free);
+  
+  g_test_add ("/ncm/stats/dist/nd/kde/gauss/gauss/dens/batch", TestNcmStatsDistNd, NULL, 
+              &test_ncm_stats_dist_nd_new_kde_gauss_sample, 
+              &test_ncm_stats_dist_nd_gauss_dens_batch, 
+              &test_ncm_stats_dist_nd_free);
+
+  g_test_add ("/ncm/stats/dist/nd/kde/gauss/gauss/dens/batch/offset", TestNcmStatsDistNd, &test_ncm_stats_dist_nd_far_offset, 
+              &test_ncm_stats_dist_nd_new_kde_gauss_sample, 
+              &test_ncm_stats_dist_nd_gauss_dens_batch, 
+              &test_ncm_stats_dist_nd_free);
+  
   g_test_add ("/ncm/stats/dist/nd/kde/gauss/gauss/dens/interp", TestNcmStatsDistNd, NULL, 
               &test_ncm_stats_dist_nd_new_kde_gauss, 
               &test_ncm_stats_dist_nd_gauss_dens_interp, 
@@ -104,12 +128,57 @@ test_ncm_stats_dist_nd_new_kde_gauss (TestNcmStatsDistNd *test, gconstpointer pd
   test->dim   = g_test_rand_int_range (2, 8);
   test->dnd   = NCM_STATS_DIST_ND (ncm_stats_dist_nd_kde_gauss_new (test->dim, TRUE));
   test->nfail = 0;
+
+  test->rng        = NULL;
+  test->data_mvnd  = NULL;
+  test->model_mvnd = NULL;
+  test->mset       = NULL;
+  test->np         = 0;
+}
+
+/*
+ * Same as above, but the KDE is also filled with a sample drawn from a
+ * random multivariate normal, optionally centered around the offset
+ * passed in @pdata, and prepared.
+ */
+static void
+test_ncm_stats_dist_nd_new_kde_gauss_sample (TestNcmStatsDistNd *test, gconstpointer pdata)
+{
+  const gdouble offset = (pdata != NULL) ? *((const gdouble *) pdata) : 0.0;
+  gulong N = 0;
+  guint i;
+
+  test_ncm_stats_dist_nd_new_kde_gauss (test, pdata);
+
+  test->rng        = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  test->data_mvnd  = ncm_data_gauss_cov_mvnd_new_full (test->dim, 1.0e-2, 5.0e-1, 1.0, offset - 2.0, offset + 2.0, test->rng);
+  test->model_mvnd = ncm_model_mvnd_new (test->dim);
+  test->mset       = ncm_mset_new (NCM_MODEL (test->model_mvnd), NULL);
+  test->np         = 1000 * test->dim * g_test_rand_int_range (1, 5);
+
+  ncm_mset_param_set_vector (test->mset, ncm_data_gauss_cov_mvnd_peek_mean (test->data_mvnd));
+
+  for (i = 0; i < test->np; i++)
+  {
+    NcmVector *y = ncm_data_gauss_cov_mvnd_gen (test->data_mvnd, test->mset, NULL, NULL, test->rng, &N);
+    ncm_stats_dist_nd_kde_gauss_add_obs (NCM_STATS_DIST_ND_KDE_GAUSS (test->dnd), y);
+  }
+
+  ncm_stats_dist_nd_prepare (test->dnd);
 }
 
 static void
 test_ncm_stats_dist_nd_free (TestNcmStatsDistNd *test, gconstpointer pdata)
 {
   NCM_TEST_FREE (ncm_stats_dist_nd_free, test->dnd);
+
+  if (test->mset != NULL)
+  {
+    ncm_mset_free (test->mset);
+    ncm_model_mvnd_free (test->model_mvnd);
+    ncm_data_gauss_cov_mvnd_free (test->data_mvnd);
+    ncm_rng_free (test->rng);
+  }
 }
 
 static void
@@ -162,6 +231,122 @@ test_ncm_stats_dist_nd_gauss_dens_est (TestNcmStatsDistNd *test, gconstpointer p
   ncm_mset_free (mset);
 }
 
+typedef struct _TestNcmStatsDistNdThreads
+{
+  NcmStatsDistNd *dnd;
+  NcmMatrix *y;
+  NcmVector *res;
+} TestNcmStatsDistNdThreads;
+
+static void
+_test_ncm_stats_dist_nd_eval_rows (glong i, glong f, gpointer userdata)
+{
+  TestNcmStatsDistNdThreads *td = (TestNcmStatsDistNdThreads *) userdata;
+  glong k;
+
+  for (k = i; k < f; k++)
+  {
+    NcmVector *y = ncm_matrix_get_row (td->y, k);
+
+    ncm_vector_set (td->res, k, ncm_stats_dist_nd_eval (td->dnd, y));
+    ncm_vector_free (y);
+  }
+}
+
+static void
+test_ncm_stats_dist_nd_gauss_dens_cut_off (TestNcmStatsDistNd *test, gconstpointer pdata)
+{
+  NcmStatsDistNdKDEGauss *dndg = NCM_STATS_DIST_ND_KDE_GAUSS (test->dnd);
+  const guint ntests           = 100 * g_test_rand_int_range (1, 5);
+  const gdouble cut_off        = 8.0;
+  NcmMatrix *y_test            = ncm_matrix_new (ntests, test->dim);
+  NcmVector *p_exact           = ncm_vector_new (ntests);
+  TestNcmStatsDistNdThreads td = {test->dnd, y_test, ncm_vector_new (ntests)};
+  gulong N = 0;
+  guint i;
+
+  for (i = 0; i < ntests; i++)
+  {
+    NcmVector *y = ncm_data_gauss_cov_mvnd_gen (test->data_mvnd, test->mset, NULL, NULL, test->rng, &N);
+    const gdouble p_s = ncm_stats_dist_nd_eval (test->dnd, y);
+
+    ncm_matrix_set_row (y_test, i, y);
+    ncm_vector_set (p_exact, i, p_s);
+  }
+
+  ncm_stats_dist_nd_kde_gauss_set_cut_off (dndg, cut_off);
+  g_assert_cmpfloat (ncm_stats_dist_nd_kde_gauss_get_cut_off (dndg), ==, cut_off);
+  ncm_stats_dist_nd_prepare (test->dnd);
+
+  for (i = 0; i < ntests; i++)
+  {
+    NcmVector *y      = ncm_matrix_get_row (y_test, i);
+    const gdouble p_s = ncm_stats_dist_nd_eval (test->dnd, y);
+    const gdouble p_e = ncm_vector_get (p_exact, i);
+
+    /*
+     * The truncation only removes contributions, in total at most 
+     * exp (-cut_off^2 / 2) ~ 1e-14 of the kernel peak. A neighbour 
+     * missed by the tree search gives a much larger error.
+     */
+    g_assert_cmpfloat (p_s, <=, p_e * (1.0 + 1.0e-12));
+    ncm_assert_cmpdouble_e (p_s, ==, p_e, 1.0e-6, 0.0);
+
+    ncm_vector_free (y);
+  }
+
+  /* The tree queries use per-call work space, concurrent evaluations must agree with the serial ones. */
+  ncm_func_eval_threaded_loop_full (&_test_ncm_stats_dist_nd_eval_rows, 0, ntests, &td);
+
+  for (i = 0; i < ntests; i++)
+  {
+    NcmVector *y = ncm_matrix_get_row (y_test, i);
+
+    g_assert_cmpfloat (ncm_vector_get (td.res, i), ==, ncm_stats_dist_nd_eval (test->dnd, y));
+    ncm_vector_free (y);
+  }
+
+  ncm_matrix_free (y_test);
+  ncm_vector_free (p_exact);
+  ncm_vector_free (td.res);
+}
+
+static void
+test_ncm_stats_dist_nd_gauss_dens_batch (TestNcmStatsDistNd *test, gconstpointer pdata)
+{
+  const guint ntests = 100 * g_test_rand_int_range (1, 5) + g_test_rand_int_range (0, 64);
+  NcmMatrix *y_test  = ncm_matrix_new (ntests, test->dim);
+  NcmVector *p_batch = ncm_vector_new (ntests);
+  gulong N = 0;
+  guint i;
+
+  /*
+   * When the fixture was built with a large offset, the whitened points
+   * are far from the origin and the batch evaluation only agrees with the
+   * direct sum if both are centered before the norm expansion.
+   */
+  for (i = 0; i < ntests; i++)
+  {
+    NcmVector *y = ncm_data_gauss_cov_mvnd_gen (test->data_mvnd, test->mset, NULL, NULL, test->rng, &N);
+    ncm_matrix_set_row (y_test, i, y);
+  }
+
+  ncm_stats_dist_nd_eval_batch (test->dnd, y_test, p_batch);
+
+  for (i = 0; i < ntests; i++)
+  {
+    NcmVector *y      = ncm_matrix_get_row (y_test, i);
+    const gdouble p_s = ncm_stats_dist_nd_eval (test->dnd, y);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (p_batch, i), ==, p_s, 1.0e-8, 0.0);
+
+    ncm_vector_free (y);
+  }
+
+  ncm_matrix_free (y_test);
+  ncm_vector_free (p_batch);
+}
+
 static void
 test_ncm_stats_dist_nd_gauss_dens_interp (TestNcmStatsDistNd *test, gconstpointer pdata)
 {
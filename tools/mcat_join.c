@@ -30,6 +30,7 @@
 #include <numcosmo/numcosmo.h>
 
 #include <gsl/gsl_cdf.h>
+#include <string.h>
 
 gint
 main (gint argc, gchar *argv[])
@@ -44,7 +45,7 @@ main (gint argc, gchar *argv[])
   {
     { "catalog",        'c', 0, G_OPTION_ARG_STRING_ARRAY, &cat_filename,   "Input catalog filename.", NULL },
     { "burnin",         'b', 0, G_OPTION_ARG_STRING_ARRAY, &burnins,        "Burnin for the input catalogs.", NULL },
-    { "out",            'o', 0, G_OPTION_ARG_STRING,       &out,            "Output catalog.", NULL },
+    { "out",            'o', 0, G_OPTION_ARG_STRING,       &out,            "Output catalog (fits, or binary when ending with "NCM_MSET_CATALOG_BIN_EXT").", NULL },
     { NULL }
   };
 
@@ -52,7 +53,7 @@ main (gint argc, gchar *argv[])
   
   context = g_option_context_new ("- join different compatible catalogs in a single one.");
   g_option_context_set_summary (context, "catalog join");
-  g_option_context_set_description (context, "CJ Description <FIXME>");
+  g_option_context_set_description (context, "The output format (fits or binary) is chosen by the output file extension, so a single catalog can be converted between formats using a single --catalog and --out.");
 
   g_option_context_add_main_entries (context, entries, NULL);
 
@@ -75,9 +76,9 @@ main (gint argc, gchar *argv[])
     if (nburnins > nmcats)
       g_warning ("mcat_join: more burnins than catalogs nburnins %u > nmcats %u!", nburnins, nmcats);
     
-    if (nmcats == 1)
+    if ((nmcats == 1) && (out == NULL))
     {
-      g_print ("A single input catalog was passed, nothing to do!.\n");
+      g_print ("A single input catalog was passed without an output, nothing to do!.\n");
     }
     else
     {
@@ -134,13 +135,14 @@ main (gint argc, gchar *argv[])
 
       if (out == NULL)
       {
-        gchar *out_default = g_strdup_printf ("joined_mcat.fits");
+        const gchar *ext   = g_str_has_suffix (cat_filename[0], NCM_MSET_CATALOG_BIN_EXT) ? NCM_MSET_CATALOG_BIN_EXT : ".fits";
+        gchar *out_default = g_strdup_printf ("joined_mcat%s", ext);
         guint i = 0;
         
         while (g_file_test (out_default, G_FILE_TEST_EXISTS))
         {
           g_free (out_default);
-          out_default = g_strdup_printf ("joined_mcat_%d.fits", i++);
+          out_default = g_strdup_printf ("joined_mcat_%d%s", i++, ext);
         }
         
         ncm_mset_catalog_set_file (mcat_out, out_default);
@@ -150,15 +152,18 @@ main (gint argc, gchar *argv[])
       {
         if (g_file_test (out, G_FILE_TEST_EXISTS))
         {
-          g_warning ("out file already exists, renaming.");
-          gchar *out_base = ncm_util_basename_fits (out);
-          gchar *out_ren  = g_strdup_printf ("%s_ren.fits", out_base);
+          const gboolean out_bin = g_str_has_suffix (out, NCM_MSET_CATALOG_BIN_EXT);
+          const gchar *ext       = out_bin ? NCM_MSET_CATALOG_BIN_EXT : ".fits";
+          gchar *out_base        = out_bin ? g_strndup (out, strlen (out) - strlen (NCM_MSET_CATALOG_BIN_EXT)) : ncm_util_basename_fits (out);
+          gchar *out_ren         = g_strdup_printf ("%s_ren%s", out_base, ext);
           guint i = 0;
+
+          g_warning ("out file already exists, renaming.");
           
           while (g_file_test (out_ren, G_FILE_TEST_EXISTS))
           {
             g_free (out_ren);
-            out_ren = g_strdup_printf ("%s_ren%d.fits", out_base, i++);
+            out_ren = g_strdup_printf ("%s_ren%d%s", out_base, i++, ext);
           }
 
           ncm_mset_catalog_set_file (mcat_out, out_ren);
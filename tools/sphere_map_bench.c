@@ -0,0 +1,130 @@
+/***************************************************************************
+ *            sphere_map_bench.c
+ *
+ *  Sat October 17 10:12:45 2026
+ *  Copyright  2026  agent
+ *  <agent@local>
+ ****************************************************************************/
+/*
+ * sphere_map_bench.c
+ *
+ * Copyright (C) 2026 - agent
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+gint
+main (gint argc, gchar *argv[])
+{
+  gint nside_min   = 32;
+  gint nside_max   = 512;
+  gdouble lmax_fac = 2.0;
+  gint nthreads    = 4;
+  gint nrep        = 3;
+
+  GError *error = NULL;
+  GOptionContext *context;
+  GOptionEntry entries[] =
+  {
+    { "nside-min", 'n', 0, G_OPTION_ARG_INT,    &nside_min, "Smallest nside (power of two).", NULL },
+    { "nside-max", 'N', 0, G_OPTION_ARG_INT,    &nside_max, "Largest nside (power of two).", NULL },
+    { "lmax-fac",  'l', 0, G_OPTION_ARG_DOUBLE, &lmax_fac,  "Use lmax = lmax-fac * nside.", NULL },
+    { "nthreads",  't', 0, G_OPTION_ARG_INT,    &nthreads,  "Number of threads compared against the serial run.", NULL },
+    { "nrep",      'r', 0, G_OPTION_ARG_INT,    &nrep,      "Repetitions per point, the best time is reported.", NULL },
+    { NULL }
+  };
+
+  ncm_cfg_init_full_ptr (&argc, &argv);
+
+  context = g_option_context_new ("- benchmark NcmSphereMap transforms.");
+  g_option_context_set_summary (context, "NcmSphereMap benchmark");
+  g_option_context_set_description (context, "Times ncm_sphere_map_prepare_alm and ncm_sphere_map_alm2map as a function of nside/lmax, serial and threaded");
+
+  g_option_context_add_main_entries (context, entries, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+  {
+    g_print ("option parsing failed: %s\n", error->message);
+    exit (1);
+  }
+
+  if ((nside_min < 1) || (nside_max < nside_min) || (nthreads < 1) || (nrep < 1) || (lmax_fac <= 0.0))
+  {
+    g_print ("Invalid options, see --help.\n");
+    exit (1);
+  }
+
+  {
+    NcmRNG *rng     = ncm_rng_seeded_new (NULL, 123);
+    NcmTimer *timer = ncm_timer_new ();
+    gint64 nside;
+
+    printf ("# %8s %8s %12s %8s %22s %22s\n", "nside", "lmax", "npix", "threads", "map2alm[s]", "alm2map[s]");
+
+    for (nside = nside_min; nside <= nside_max; nside *= 2)
+    {
+      NcmSphereMap *smap = ncm_sphere_map_new (nside);
+      const guint lmax   = lmax_fac * nside;
+      const guint nt[2]  = {1, nthreads};
+      guint j;
+
+      ncm_sphere_map_add_noise (smap, 1.0, rng);
+      ncm_sphere_map_set_lmax (smap, lmax);
+
+      /* First call builds the FFT plans, keep it out of the timings. */
+      ncm_sphere_map_prepare_alm (smap);
+
+      for (j = 0; j < ((nthreads > 1) ? 2 : 1); j++)
+      {
+        gdouble t_map2alm = GSL_POSINF;
+        gdouble t_alm2map = GSL_POSINF;
+        gint k;
+
+        ncm_sphere_map_set_nthreads (smap, nt[j]);
+
+        for (k = 0; k < nrep; k++)
+        {
+          ncm_timer_start (timer);
+          ncm_sphere_map_prepare_alm (smap);
+          t_map2alm = GSL_MIN (t_map2alm, ncm_timer_elapsed (timer));
+
+          ncm_timer_start (timer);
+          ncm_sphere_map_alm2map (smap);
+          t_alm2map = GSL_MIN (t_alm2map, ncm_timer_elapsed (timer));
+        }
+
+        printf ("  %8"G_GINT64_FORMAT" %8u %12"G_GINT64_FORMAT" %8u % 22.15g % 22.15g\n",
+                nside, lmax, ncm_sphere_map_get_npix (smap), nt[j], t_map2alm, t_alm2map);
+        fflush (stdout);
+      }
+
+      ncm_sphere_map_free (smap);
+    }
+
+    ncm_timer_free (timer);
+    ncm_rng_free (rng);
+  }
+
+  g_option_context_free (context);
+
+  return 0;
+}